@@ -0,0 +1,128 @@
+# 协议核心的LTO与PGO构建配置
+#
+# LTO: YJ_ENABLE_LTO=ON 时对协议库、主机侧库、Python扩展和工具开启过程间优化,
+#      使字节解析、校验计算与回调分发可以跨编译单元内联。
+#
+# PGO: 三步流程, 必须在同一个构建目录中完成(GCC按目标文件路径匹配profile):
+#   1. cmake -S . -B build -DYJ_PGO=GENERATE -DYJ_PGO_TRAINING_DATA=/path/to/captures
+#      cmake --build build
+#   2. cmake --build build --target yj_pgo_train   # 用yj_replay回放录制文件采集profile
+#   3. cmake -S . -B build -DYJ_PGO=USE && cmake --build build
+#
+# 支持GCC(-fprofile-generate/-fprofile-use)与Clang(-fprofile-instr-*, 需要llvm-profdata)。
+
+include(CheckIPOSupported)
+include(CheckCCompilerFlag)
+
+option(YJ_ENABLE_LTO "对协议核心和主机扩展启用链接时优化" OFF)
+set(YJ_PGO "OFF" CACHE STRING "PGO阶段: OFF / GENERATE(插桩采集) / USE(使用profile)")
+set_property(CACHE YJ_PGO PROPERTY STRINGS OFF GENERATE USE)
+set(YJ_PGO_PROFILE_DIR "${PROJECT_BINARY_DIR}/pgo-profile" CACHE PATH "PGO profile目录")
+set(YJ_PGO_TRAINING_DATA "" CACHE STRING "训练用的.yjcap文件或目录列表(分号分隔)")
+set(YJ_PGO_TRAINING_MODE "${YJ_CHECKSUM_MODE}" CACHE STRING "回放训练数据时的校验模式: ORIGINAL / CRC16")
+set_property(CACHE YJ_PGO_TRAINING_MODE PROPERTY STRINGS ORIGINAL CRC16)
+set(YJ_PGO_TRAINING_LOOPS 20 CACHE STRING "每个录制文件回放的遍数")
+
+if(NOT YJ_PGO MATCHES "^(OFF|GENERATE|USE)$")
+    message(FATAL_ERROR "YJ_PGO 必须为 OFF、GENERATE 或 USE, 当前为 '${YJ_PGO}'")
+endif()
+
+set(YJ_LTO_ENABLED FALSE)
+if(YJ_ENABLE_LTO)
+    check_ipo_supported(RESULT _yj_ipo_ok OUTPUT _yj_ipo_msg LANGUAGES C)
+    if(_yj_ipo_ok)
+        set(YJ_LTO_ENABLED TRUE)
+    else()
+        message(WARNING "编译器不支持LTO, 忽略 YJ_ENABLE_LTO: ${_yj_ipo_msg}")
+    endif()
+endif()
+
+set(YJ_PGO_COMPILE_OPTIONS "")
+set(YJ_PGO_LINK_OPTIONS "")
+set(YJ_PGO_TOOLCHAIN "")
+if(NOT YJ_PGO STREQUAL "OFF")
+    if(CMAKE_C_COMPILER_ID STREQUAL "GNU")
+        set(YJ_PGO_TOOLCHAIN GCC)
+        if(YJ_PGO STREQUAL "GENERATE")
+            set(YJ_PGO_COMPILE_OPTIONS -fprofile-generate=${YJ_PGO_PROFILE_DIR} -fprofile-update=single)
+            set(YJ_PGO_LINK_OPTIONS -fprofile-generate=${YJ_PGO_PROFILE_DIR})
+        else()
+            set(YJ_PGO_COMPILE_OPTIONS -fprofile-use=${YJ_PGO_PROFILE_DIR} -fprofile-correction)
+            # 未被训练覆盖的函数(如Python模块初始化)按普通-O2优化, 而不是当作冷代码
+            check_c_compiler_flag(-fprofile-partial-training YJ_HAVE_PROFILE_PARTIAL_TRAINING)
+            if(YJ_HAVE_PROFILE_PARTIAL_TRAINING)
+                list(APPEND YJ_PGO_COMPILE_OPTIONS -fprofile-partial-training)
+            endif()
+            check_c_compiler_flag(-Wno-missing-profile YJ_HAVE_WNO_MISSING_PROFILE)
+            if(YJ_HAVE_WNO_MISSING_PROFILE)
+                list(APPEND YJ_PGO_COMPILE_OPTIONS -Wno-missing-profile)
+            endif()
+            file(GLOB _yj_gcda "${YJ_PGO_PROFILE_DIR}/*.gcda")
+            if(NOT _yj_gcda)
+                message(WARNING "YJ_PGO=USE 但 ${YJ_PGO_PROFILE_DIR} 中没有profile, 请先运行 yj_pgo_train")
+            endif()
+        endif()
+    elseif(CMAKE_C_COMPILER_ID MATCHES "Clang")
+        set(YJ_PGO_TOOLCHAIN CLANG)
+        get_filename_component(_yj_cc_dir ${CMAKE_C_COMPILER} DIRECTORY)
+        find_program(YJ_LLVM_PROFDATA NAMES llvm-profdata HINTS ${_yj_cc_dir})
+        if(NOT YJ_LLVM_PROFDATA)
+            message(FATAL_ERROR "Clang PGO需要 llvm-profdata")
+        endif()
+        set(YJ_PGO_PROFDATA "${YJ_PGO_PROFILE_DIR}/yj.profdata")
+        if(YJ_PGO STREQUAL "GENERATE")
+            set(YJ_PGO_COMPILE_OPTIONS -fprofile-instr-generate)
+            set(YJ_PGO_LINK_OPTIONS -fprofile-instr-generate)
+        else()
+            if(NOT EXISTS ${YJ_PGO_PROFDATA})
+                message(FATAL_ERROR "YJ_PGO=USE 但找不到 ${YJ_PGO_PROFDATA}, 请先运行 yj_pgo_train")
+            endif()
+            set(YJ_PGO_COMPILE_OPTIONS -fprofile-instr-use=${YJ_PGO_PROFDATA} -Wno-profile-instr-unprofiled)
+        endif()
+    else()
+        message(FATAL_ERROR "PGO仅支持GCC与Clang, 当前编译器: ${CMAKE_C_COMPILER_ID}")
+    endif()
+    if(NOT CMAKE_BUILD_TYPE MATCHES "^(Release|RelWithDebInfo)$")
+        message(WARNING "PGO通常应与Release/RelWithDebInfo配合使用, 当前为 '${CMAKE_BUILD_TYPE}'")
+    endif()
+endif()
+
+# 对目标启用LTO与PGO; 协议核心的所有消费者(库、扩展、工具、基准)都应调用
+function(yj_enable_optimization target)
+    if(YJ_LTO_ENABLED)
+        set_property(TARGET ${target} PROPERTY INTERPROCEDURAL_OPTIMIZATION ON)
+    endif()
+    if(YJ_PGO_COMPILE_OPTIONS)
+        target_compile_options(${target} PRIVATE ${YJ_PGO_COMPILE_OPTIONS})
+    endif()
+    get_target_property(_type ${target} TYPE)
+    if(YJ_PGO_LINK_OPTIONS AND NOT _type STREQUAL "OBJECT_LIBRARY" AND NOT _type STREQUAL "STATIC_LIBRARY")
+        target_link_options(${target} PRIVATE ${YJ_PGO_LINK_OPTIONS})
+    endif()
+endfunction()
+
+# 添加 yj_pgo_train 目标: 用 replay_target 回放训练数据采集profile
+function(yj_add_pgo_training replay_target)
+    if(NOT YJ_PGO STREQUAL "GENERATE")
+        return()
+    endif()
+    if(NOT YJ_PGO_TRAINING_DATA)
+        message(WARNING "YJ_PGO=GENERATE 但未设置 YJ_PGO_TRAINING_DATA, yj_pgo_train 将会失败")
+    endif()
+    # 列表经命令行传递时会被拆开, 先换成'|'分隔
+    string(REPLACE ";" "|" _data "${YJ_PGO_TRAINING_DATA}")
+    add_custom_target(yj_pgo_train
+        COMMAND ${CMAKE_COMMAND}
+                -DYJ_REPLAY=$<TARGET_FILE:${replay_target}>
+                -DYJ_PGO_TOOLCHAIN=${YJ_PGO_TOOLCHAIN}
+                -DYJ_PGO_PROFILE_DIR=${YJ_PGO_PROFILE_DIR}
+                -DYJ_PGO_PROFDATA=${YJ_PGO_PROFDATA}
+                -DYJ_LLVM_PROFDATA=${YJ_LLVM_PROFDATA}
+                -DYJ_PGO_TRAINING_DATA=${_data}
+                -DYJ_PGO_TRAINING_MODE=${YJ_PGO_TRAINING_MODE}
+                -DYJ_PGO_TRAINING_LOOPS=${YJ_PGO_TRAINING_LOOPS}
+                -P ${PROJECT_SOURCE_DIR}/cmake/YJPgoTrain.cmake
+        DEPENDS ${replay_target}
+        COMMENT "回放录制文件采集PGO profile"
+        VERBATIM)
+endfunction()
@@ -0,0 +1,60 @@
+# yj_pgo_train 的执行脚本(cmake -P), 由 YJOptimization.cmake 传入参数
+#
+# 清空旧profile后, 用插桩版 yj_replay 把每个训练录制文件回放若干遍;
+# Clang下最后把 .profraw 合并为 yj.profdata。
+
+string(REPLACE "|" ";" _inputs "${YJ_PGO_TRAINING_DATA}")
+set(_captures "")
+foreach(_input IN LISTS _inputs)
+    if(IS_DIRECTORY "${_input}")
+        file(GLOB_RECURSE _found "${_input}/*.yjcap")
+        list(SORT _found)
+        list(APPEND _captures ${_found})
+    elseif(EXISTS "${_input}")
+        list(APPEND _captures "${_input}")
+    else()
+        message(FATAL_ERROR "训练数据不存在: ${_input}")
+    endif()
+endforeach()
+if(NOT _captures)
+    message(FATAL_ERROR "没有可用的训练录制文件, 请通过 YJ_PGO_TRAINING_DATA 指定 .yjcap 文件或目录")
+endif()
+
+file(MAKE_DIRECTORY "${YJ_PGO_PROFILE_DIR}")
+file(GLOB _old "${YJ_PGO_PROFILE_DIR}/*.gcda" "${YJ_PGO_PROFILE_DIR}/*.profraw")
+if(_old)
+    file(REMOVE ${_old})
+endif()
+if(YJ_PGO_TOOLCHAIN STREQUAL "CLANG")
+    set(ENV{LLVM_PROFILE_FILE} "${YJ_PGO_PROFILE_DIR}/yj-%p.profraw")
+endif()
+
+set(_mode_args "")
+if(YJ_PGO_TRAINING_MODE STREQUAL "CRC16")
+    set(_mode_args --crc)
+endif()
+
+foreach(_capture IN LISTS _captures)
+    message(STATUS "训练: ${_capture}")
+    execute_process(
+        COMMAND "${YJ_REPLAY}" ${_mode_args} --loops ${YJ_PGO_TRAINING_LOOPS} "${_capture}"
+        RESULT_VARIABLE _rc
+        OUTPUT_VARIABLE _out
+        ERROR_VARIABLE _err)
+    if(NOT _rc EQUAL 0)
+        message(FATAL_ERROR "yj_replay 回放 ${_capture} 失败(${_rc}):\n${_out}${_err}")
+    endif()
+endforeach()
+
+if(YJ_PGO_TOOLCHAIN STREQUAL "CLANG")
+    file(GLOB _raw "${YJ_PGO_PROFILE_DIR}/*.profraw")
+    execute_process(
+        COMMAND "${YJ_LLVM_PROFDATA}" merge -o "${YJ_PGO_PROFDATA}" ${_raw}
+        RESULT_VARIABLE _rc)
+    if(NOT _rc EQUAL 0)
+        message(FATAL_ERROR "llvm-profdata merge 失败")
+    endif()
+endif()
+
+list(LENGTH _captures _n)
+message(STATUS "PGO训练完成: ${_n} 个录制文件, profile位于 ${YJ_PGO_PROFILE_DIR}")
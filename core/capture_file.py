@@ -0,0 +1,420 @@
+"""二进制录制文件(.yjcap)读写
+
+文件格式见 protocol/host/yj_capture.h：64字节文件头 + 追加写入的定长记录头(时间戳、方向、
+长度、状态、功能ID) + 周期性索引块。写入优先使用原生扩展中的 C 写入器
+(_yj_native.CaptureWriter，批量写盘，可选 O_DIRECT)，不可用时回退到格式一致的纯Python实现；
+读取通过 mmap 完成，不把整个文件读入内存。
+
+录制文件旁可生成二级索引文件(.yjidx，格式见 protocol/host/yj_capture_index.h)：稀疏时间索引 +
+按功能ID的倒排列表，"某功能ID在[t0, t1)内的所有帧"只需两次二分查找，无需顺序扫描整个录制文件。
+"""
+
+import bisect
+
+import mmap
+import os
+import struct
+import time
+from typing import Iterator, NamedTuple, Optional
+
+from core import native_protocol
+
+CAPTURE_MAGIC = b"YJCAP01\0"
+CAPTURE_VERSION = 1
+FILE_HEADER_SIZE = 64
+RECORD_HEADER_SIZE = 16
+INDEX_BLOCK_SIZE = 32
+RECORD_ALIGN = 8
+DEFAULT_INDEX_INTERVAL = 4096
+DEFAULT_BUFFER_SIZE = 1 << 20
+
+DIR_RX = 0x00
+DIR_TX = 0x01
+DIR_INDEX = 0xFF
+
+STATUS_RAW = 0x00
+STATUS_OK = 0x01
+STATUS_CHECKSUM_ERROR = 0x02
+STATUS_PARSE_ERROR = 0x03
+
+_FILE_HEADER = struct.Struct("<8sHHIQII")       # magic .. index_interval, reserved
+_FILE_TAIL = struct.Struct("<QQQ")              # record_count, last_index_offset, data_end (偏移32)
+_RECORD_HEADER = struct.Struct("<QHBBB3x")
+_INDEX_BLOCK = struct.Struct("<QQQI4x")
+
+INDEX_FILE_SUFFIX = ".yjidx"
+CAPTURE_INDEX_MAGIC = b"YJIDX01\0"
+CAPTURE_INDEX_VERSION = 1
+INDEX_HEADER_SIZE = 64
+DEFAULT_TIME_STRIDE = 256
+FUNC_COUNT = 256
+
+_INDEX_HEADER = struct.Struct("<8sHHIQQQQQ8x")  # magic .. posting_count, reserved
+_INDEX_ENTRY = struct.Struct("<QQ")              # 时间索引项 {ts_ns, offset} / 功能ID表项 {first, count}
+
+
+class CaptureRecord(NamedTuple):
+    """录制记录"""
+    offset: int
+    ts_ns: int
+    direction: int
+    status: int
+    func_id: int
+    data: memoryview
+
+
+class IndexBlock(NamedTuple):
+    """索引块（对应C结构体 yj_capture_index_block_t）"""
+    offset: int
+    last_ts_ns: int
+    prev_index_offset: int
+    first_record_offset: int
+    first_ts_ns: int
+    record_count: int
+
+
+def _record_size(length: int) -> int:
+    return (RECORD_HEADER_SIZE + length + RECORD_ALIGN - 1) & ~(RECORD_ALIGN - 1)
+
+
+class PyCaptureWriter:
+    """与 yj_capture_writer_* 行为一致的纯Python写入器（不支持 O_DIRECT）"""
+
+    def __init__(self, path: str, buffer_size: int = 0, index_interval: int = 0, direct: bool = False):
+        self._file = open(path, "wb")
+        self._buffer = bytearray()
+        self._buffer_size = buffer_size or DEFAULT_BUFFER_SIZE
+        self._index_interval = index_interval or DEFAULT_INDEX_INTERVAL
+        self._file_offset = 0
+        self.record_count = 0
+        self._last_index_offset = 0
+        self._block_first_offset = 0
+        self._block_first_ts = 0
+        self._block_records = 0
+        self._last_ts = 0
+        self._buffer += _FILE_HEADER.pack(CAPTURE_MAGIC, CAPTURE_VERSION, FILE_HEADER_SIZE, 0,
+                                          time.time_ns(), self._index_interval, 0)
+        self._buffer += bytes(FILE_HEADER_SIZE - len(self._buffer))
+
+    @property
+    def bytes_written(self) -> int:
+        return self._file_offset + len(self._buffer)
+
+    @property
+    def closed(self) -> bool:
+        return self._file is None
+
+    def _append_record(self, ts_ns: int, direction: int, status: int, func_id: int, data) -> None:
+        size = _record_size(len(data))
+        if len(self._buffer) + size > self._buffer_size:
+            self.flush()
+        self._buffer += _RECORD_HEADER.pack(ts_ns, len(data), direction, status, func_id)
+        self._buffer += data
+        self._buffer += bytes(size - RECORD_HEADER_SIZE - len(data))
+
+    def _append_index_block(self) -> None:
+        offset = self.bytes_written
+        self._append_record(self._last_ts, DIR_INDEX, 0, 0, _INDEX_BLOCK.pack(
+            self._last_index_offset, self._block_first_offset, self._block_first_ts, self._block_records))
+        self._last_index_offset = offset
+        self._block_records = 0
+
+    def append(self, ts_ns: int, direction: int, status: int, func_id: int, data) -> None:
+        if self._file is None:
+            raise ValueError("I/O operation on closed capture")
+        if len(data) > 0xFFFF or direction == DIR_INDEX:
+            raise ValueError("record longer than 65535 bytes" if len(data) > 0xFFFF else "invalid direction")
+        if self._block_records == 0:
+            self._block_first_offset = self.bytes_written
+            self._block_first_ts = ts_ns
+        self._append_record(ts_ns, direction, status, func_id, bytes(data))
+        self._last_ts = ts_ns
+        self.record_count += 1
+        self._block_records += 1
+        if self._block_records >= self._index_interval:
+            self._append_index_block()
+
+    def flush(self) -> None:
+        if self._file is None:
+            raise ValueError("I/O operation on closed capture")
+        self._file.write(self._buffer)
+        self._file.flush()
+        self._file_offset += len(self._buffer)
+        self._buffer.clear()
+
+    def close(self) -> None:
+        if self._file is None:
+            return
+        if self._block_records > 0:
+            self._append_index_block()
+        data_end = self.bytes_written
+        self.flush()
+        self._file.seek(32)
+        self._file.write(_FILE_TAIL.pack(self.record_count, self._last_index_offset, data_end))
+        self._file.close()
+        self._file = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+
+def open_capture_writer(path: str, buffer_size: int = 0, index_interval: int = 0, direct: bool = False):
+    """创建录制文件写入器：原生 CaptureWriter 可用时使用之，否则使用 PyCaptureWriter"""
+    native = native_protocol.native_module()
+    if native is not None and hasattr(native, "CaptureWriter"):
+        return native.CaptureWriter(path, buffer_size, index_interval, direct)
+    return PyCaptureWriter(path, buffer_size, index_interval, direct)
+
+
+class CaptureReader:
+    """通过 mmap 读取录制文件
+
+    记录的 data 为指向映射区的 memoryview，在 close() 之前有效。
+    文件未正常关闭（写入过程中崩溃）时，从头顺序扫描到最后一条完整记录为止。
+    """
+
+    def __init__(self, path: str):
+        self.path = path
+        self._file = open(path, "rb")
+        size = os.fstat(self._file.fileno()).st_size
+        if size < FILE_HEADER_SIZE:
+            self._file.close()
+            raise ValueError("不是有效的YJ录制文件")
+        self._mmap = mmap.mmap(self._file.fileno(), 0, access=mmap.ACCESS_READ)
+        self._view = memoryview(self._mmap)
+        magic, version, header_size, _flags, self.created_ns, self.index_interval, _ = \
+            _FILE_HEADER.unpack_from(self._mmap, 0)
+        if magic != CAPTURE_MAGIC or version != CAPTURE_VERSION or header_size != FILE_HEADER_SIZE:
+            self.close()
+            raise ValueError("不是有效的YJ录制文件")
+        self.record_count, self.last_index_offset, self.data_end = _FILE_TAIL.unpack_from(self._mmap, 32)
+        self.finalized = 0 < self.data_end <= size
+        if not self.finalized:
+            self.record_count = 0
+            self.last_index_offset = 0
+            self.data_end = size
+
+    def close(self) -> None:
+        if self._file is None:
+            return
+        self._view.release()
+        self._mmap.close()
+        self._file.close()
+        self._file = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def read_at(self, offset: int):
+        """读取offset处的记录（包括索引块），返回 (记录, 下一条记录偏移)，到达末尾返回 (None, offset)"""
+        if offset + RECORD_HEADER_SIZE > self.data_end:
+            return None, offset
+        ts_ns, length, direction, status, func_id = _RECORD_HEADER.unpack_from(self._mmap, offset)
+        start = offset + RECORD_HEADER_SIZE
+        if start + length > self.data_end:
+            return None, offset
+        record = CaptureRecord(offset, ts_ns, direction, status, func_id, self._view[start:start + length])
+        return record, offset + _record_size(length)
+
+    def records(self, start_offset: int = FILE_HEADER_SIZE) -> Iterator[CaptureRecord]:
+        """按顺序遍历数据记录（跳过索引块）"""
+        offset = start_offset
+        while True:
+            record, offset = self.read_at(offset)
+            if record is None:
+                return
+            if record.direction != DIR_INDEX:
+                yield record
+
+    def __iter__(self) -> Iterator[CaptureRecord]:
+        return self.records()
+
+    def index_block(self, offset: int) -> Optional[IndexBlock]:
+        """解析offset处的索引块"""
+        record, _ = self.read_at(offset)
+        if record is None or record.direction != DIR_INDEX or len(record.data) != INDEX_BLOCK_SIZE:
+            return None
+        return IndexBlock(offset, record.ts_ns, *_INDEX_BLOCK.unpack(record.data))
+
+    def seek_time(self, ts_ns: int) -> int:
+        """返回一个不晚于第一条 ts_ns >= 给定时间的记录的偏移（与 yj_capture_reader_seek_time 一致）"""
+        cursor = self.last_index_offset
+        while cursor:
+            block = self.index_block(cursor)
+            if block is None:
+                break
+            if block.first_ts_ns < ts_ns:  # 相等时前一区间末尾可能还有同一时间戳的记录
+                return block.first_record_offset
+            if block.prev_index_offset >= cursor:
+                break
+            cursor = block.prev_index_offset
+        return FILE_HEADER_SIZE
+
+    def records_between(self, t0_ns: int, t1_ns: int) -> Iterator[CaptureRecord]:
+        """遍历 t0_ns <= ts_ns < t1_ns 的记录"""
+        for record in self.records(self.seek_time(t0_ns)):
+            if record.ts_ns >= t1_ns:
+                return
+            if record.ts_ns >= t0_ns:
+                yield record
+
+
+def index_path_for(capture_path: str) -> str:
+    """录制文件对应的索引文件路径"""
+    return capture_path + INDEX_FILE_SUFFIX
+
+
+def _build_index_python(capture_path: str, index_path: str, time_stride: int) -> None:
+    """与 yj_capture_index_build 生成相同文件的纯Python实现"""
+    time_entries = []
+    postings = [[] for _ in range(FUNC_COUNT)]
+    with CaptureReader(capture_path) as reader:
+        record_count = 0
+        for record in reader:
+            if record_count % time_stride == 0:
+                time_entries.append((record.ts_ns, record.offset))
+            if record.status != STATUS_RAW:
+                postings[record.func_id].append(record.offset)
+            record_count += 1
+        record = None  # 释放指向映射区的 memoryview
+        created_ns, data_end = reader.created_ns, reader.data_end
+    posting_count = sum(len(p) for p in postings)
+
+    with open(index_path, "wb") as f:
+        f.write(_INDEX_HEADER.pack(CAPTURE_INDEX_MAGIC, CAPTURE_INDEX_VERSION, INDEX_HEADER_SIZE, time_stride,
+                                   created_ns, data_end, record_count, len(time_entries), posting_count))
+        for entry in time_entries:
+            f.write(_INDEX_ENTRY.pack(*entry))
+        first = 0
+        for func_postings in postings:
+            f.write(_INDEX_ENTRY.pack(first, len(func_postings)))
+            first += len(func_postings)
+        for func_postings in postings:
+            f.write(struct.pack("<%dQ" % len(func_postings), *func_postings))
+
+
+def build_index(capture_path: str, index_path: Optional[str] = None, time_stride: int = 0) -> str:
+    """扫描录制文件生成索引文件，返回索引文件路径
+
+    原生扩展可用时由 yj_capture_index_build 完成（两遍扫描直接写入映射文件，释放GIL），
+    否则使用格式一致的纯Python实现。
+    """
+    index_path = index_path or index_path_for(capture_path)
+    time_stride = time_stride or DEFAULT_TIME_STRIDE
+    native = native_protocol.native_module()
+    if native is not None and hasattr(native, "build_capture_index"):
+        native.build_capture_index(capture_path, index_path, time_stride)
+    else:
+        _build_index_python(capture_path, index_path, time_stride)
+    return index_path
+
+
+class StaleIndexError(ValueError):
+    """索引文件与录制文件不匹配（录制文件被改写或仍在写入），需要重新生成"""
+
+
+class CaptureIndex:
+    """只读映射索引文件，在 CaptureReader 上提供按时间和功能ID的查询
+
+    with CaptureReader(path) as reader, CaptureIndex(reader) as index:
+        for record in index.query(0x31, t0_ns, t1_ns):
+            ...
+    """
+
+    def __init__(self, reader: CaptureReader, index_path: Optional[str] = None, rebuild: bool = False):
+        self.reader = reader
+        path = index_path or index_path_for(reader.path)
+        if rebuild or not os.path.exists(path):
+            build_index(reader.path, path)
+        self._file = open(path, "rb")
+        size = os.fstat(self._file.fileno()).st_size
+        if size < INDEX_HEADER_SIZE + FUNC_COUNT * _INDEX_ENTRY.size:
+            self._file.close()
+            raise ValueError("不是有效的YJ索引文件")
+        self._mmap = mmap.mmap(self._file.fileno(), 0, access=mmap.ACCESS_READ)
+        (magic, version, header_size, self.time_stride, created_ns, data_end, self.record_count,
+         time_entry_count, posting_count) = _INDEX_HEADER.unpack_from(self._mmap, 0)
+        expected_size = (INDEX_HEADER_SIZE + (time_entry_count + FUNC_COUNT) * _INDEX_ENTRY.size
+                         + posting_count * 8)
+        if (magic != CAPTURE_INDEX_MAGIC or version != CAPTURE_INDEX_VERSION or
+                header_size != INDEX_HEADER_SIZE or self.time_stride == 0 or expected_size != size):
+            self.close()
+            raise ValueError("不是有效的YJ索引文件")
+        if created_ns != reader.created_ns or data_end != reader.data_end:
+            self.close()
+            raise StaleIndexError("索引文件与录制文件不匹配")
+        view = memoryview(self._mmap)
+        time_end = INDEX_HEADER_SIZE + time_entry_count * _INDEX_ENTRY.size
+        func_end = time_end + FUNC_COUNT * _INDEX_ENTRY.size
+        self._time_entries = view[INDEX_HEADER_SIZE:time_end].cast("Q")
+        self._func_table = view[time_end:func_end].cast("Q")
+        self._postings = view[func_end:].cast("Q")
+        view.release()
+
+    def close(self) -> None:
+        if self._file is None:
+            return
+        for name in ("_time_entries", "_func_table", "_postings"):
+            view = self.__dict__.pop(name, None)
+            if view is not None:
+                view.release()
+        self._mmap.close()
+        self._file.close()
+        self._file = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def seek_time(self, ts_ns: int) -> int:
+        """返回一个不晚于第一条 ts_ns >= 给定时间的记录的偏移（与 yj_capture_index_seek_time 一致）"""
+        timestamps = self._time_entries[0::2]
+        pos = bisect.bisect_left(timestamps, ts_ns)
+        return self._time_entries[2 * pos - 1] if pos > 0 else FILE_HEADER_SIZE
+
+    def records_between(self, t0_ns: int, t1_ns: int) -> Iterator[CaptureRecord]:
+        """遍历 t0_ns <= ts_ns < t1_ns 的记录"""
+        for record in self.reader.records(self.seek_time(t0_ns)):
+            if record.ts_ns >= t1_ns:
+                return
+            if record.ts_ns >= t0_ns:
+                yield record
+
+    def postings(self, func_id: int) -> memoryview:
+        """某功能ID所有帧的记录偏移（按时间顺序）"""
+        first, count = self._func_table[2 * func_id], self._func_table[2 * func_id + 1]
+        return self._postings[first:first + count]
+
+    def _lower_bound(self, offsets, ts_ns: int) -> int:
+        lo, hi = 0, len(offsets)
+        while lo < hi:
+            mid = (lo + hi) // 2
+            if _RECORD_HEADER.unpack_from(self.reader._mmap, offsets[mid])[0] < ts_ns:
+                lo = mid + 1
+            else:
+                hi = mid
+        return lo
+
+    def query_offsets(self, func_id: int, t0_ns: int, t1_ns: int) -> memoryview:
+        """某功能ID在 [t0_ns, t1_ns) 内的帧的记录偏移（与 yj_capture_index_query 一致）"""
+        offsets = self.postings(func_id)
+        if t1_ns <= t0_ns:
+            return offsets[0:0]
+        begin = self._lower_bound(offsets, t0_ns)
+        end = begin + self._lower_bound(offsets[begin:], t1_ns)
+        return offsets[begin:end]
+
+    def query(self, func_id: int, t0_ns: int, t1_ns: int) -> Iterator[CaptureRecord]:
+        """遍历某功能ID在 [t0_ns, t1_ns) 内的帧"""
+        for offset in self.query_offsets(func_id, t0_ns, t1_ns):
+            record, _ = self.reader.read_at(offset)
+            if record is not None:
+                yield record
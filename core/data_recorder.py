@@ -1,9 +1,11 @@
 import csv
 import json
+import time
 from datetime import datetime
 from typing import Optional, Dict, List, Tuple, Any
-from utils.constants import Constants
+from utils.constants import Constants, ChecksumMode
 from utils.logger import ErrorLogger # Assuming ErrorLogger is in utils.logger
+from core import capture_file, native_protocol
 
 class DataRecorder:
     def __init__(self, error_logger: Optional[ErrorLogger] = None):
@@ -11,6 +13,13 @@ class DataRecorder:
         self.recording_raw: bool = False
         self.recorded_raw_data: List[Dict[str, Any]] = [] # {'timestamp': dt, 'data': hex_str, 'direction': str}
         self.error_logger = error_logger
+        # 流式录制(.yjcap)：数据直接追加写入文件，不在内存中累积
+        self._capture_writer = None
+        self._capture_path: Optional[str] = None
+        self._capture_checksum_mode = ChecksumMode.ORIGINAL_SUM_ADD
+        self._capture_head = native_protocol.FRAME_HEAD_BYTE
+        self._capture_max_payload = 1024
+        self._capture_pending: Dict[int, bytearray] = {}  # 各方向尚未组成完整帧的字节
 
     def add_parsed_frame_data(self, timestamp: datetime, parsed_data: Dict[str, str]) -> None:
         timestamp_str = timestamp.strftime("%Y-%m-%d %H:%M:%S.%f")[:-3]
@@ -63,6 +72,9 @@ class DataRecorder:
 
 
     def record_raw_frame(self, timestamp: datetime, data_bytes: bytes, direction: str) -> None: # Changed data to data_bytes
+        # 流式录制与原始数据录制互不影响, 同时开启时两边都记录
+        if self._capture_writer is not None:
+            self._capture_data(timestamp, data_bytes, direction)
         if self.recording_raw:
             self.recorded_raw_data.append({
                 'timestamp': timestamp, # Store as datetime object
@@ -83,4 +95,94 @@ class DataRecorder:
                 self.error_logger.log_info(f"原始数据已记录到: {filename}")
         except Exception as e:
             if self.error_logger:
-                self.error_logger.log_error(f"保存原始数据失败: {e}", "RECORDER")
\ No newline at end of file
+                self.error_logger.log_error(f"保存原始数据失败: {e}", "RECORDER")
+
+    @property
+    def is_capturing(self) -> bool:
+        return self._capture_writer is not None
+
+    def start_capture(self, filename: str, checksum_mode: ChecksumMode = ChecksumMode.ORIGINAL_SUM_ADD,
+                      head_byte: int = native_protocol.FRAME_HEAD_BYTE, max_payload: int = 1024,
+                      direct_io: bool = False) -> bool:
+        """开始流式录制到二进制录制文件(.yjcap)
+
+        收发数据按帧切分后逐帧追加写入（记录功能ID和校验状态），帧之间的其他字节作为原始记录写入。
+        录制期间内存占用只有写缓冲区，停止时无需导出。
+        """
+        if self._capture_writer is not None:
+            self.stop_capture()
+        try:
+            self._capture_writer = capture_file.open_capture_writer(filename, direct=direct_io)
+        except (OSError, ValueError) as e:
+            self._capture_writer = None
+            if self.error_logger:
+                self.error_logger.log_error(f"创建录制文件失败: {e}", "RECORDER")
+            return False
+        self._capture_path = filename
+        self._capture_checksum_mode = checksum_mode
+        self._capture_head = head_byte
+        self._capture_max_payload = max_payload
+        self._capture_pending.clear()
+        if self.error_logger:
+            self.error_logger.log_info(f"开始流式录制到: {filename}")
+        return True
+
+    def stop_capture(self) -> Optional[Dict[str, Any]]:
+        """停止流式录制并生成索引文件(.yjidx)，返回 {'path', 'records', 'bytes', 'index'}，未在录制时返回None
+
+        索引生成失败不影响录制文件本身，此时 'index' 为None（之后可用 capture_file.build_index 重建）。
+        """
+        writer = self._capture_writer
+        if writer is None:
+            return None
+        try:
+            now_ns = time.time_ns()
+            for direction_code, pending in self._capture_pending.items():
+                if pending:
+                    writer.append(now_ns, direction_code, capture_file.STATUS_RAW, 0, bytes(pending))
+            writer.close()
+        except (OSError, ValueError) as e:
+            if self.error_logger:
+                self.error_logger.log_error(f"关闭录制文件失败: {e}", "RECORDER")
+        self._capture_writer = None
+        self._capture_pending.clear()
+        summary = {'path': self._capture_path, 'records': writer.record_count, 'bytes': writer.bytes_written,
+                   'index': None}
+        try:
+            summary['index'] = capture_file.build_index(self._capture_path)
+        except (OSError, ValueError) as e:
+            if self.error_logger:
+                self.error_logger.log_error(f"生成录制索引失败: {e}", "RECORDER")
+        if self.error_logger:
+            self.error_logger.log_info(f"流式录制已停止: {summary['records']} 条记录, {summary['bytes']} 字节")
+        return summary
+
+    def _capture_data(self, timestamp: datetime, data_bytes: bytes, direction: str) -> None:
+        direction_code = capture_file.DIR_TX if direction.upper().startswith("TX") else capture_file.DIR_RX
+        ts_ns = int(timestamp.timestamp() * 1e9)
+        pending = self._capture_pending.setdefault(direction_code, bytearray())
+        pending += data_bytes
+        try:
+            frames, consumed = native_protocol.scan_frames(
+                pending, self._capture_checksum_mode, self._capture_head, self._capture_max_payload
+            ) if len(pending) >= Constants.MIN_HEADER_LEN_FOR_DATA_LEN else ([], 0)
+            cursor = 0
+            for frame in frames:
+                if frame.offset > cursor:
+                    self._capture_writer.append(ts_ns, direction_code, capture_file.STATUS_RAW, 0,
+                                                bytes(pending[cursor:frame.offset]))
+                status = capture_file.STATUS_OK if frame.checksum_ok else capture_file.STATUS_CHECKSUM_ERROR
+                self._capture_writer.append(ts_ns, direction_code, status, frame.func_id,
+                                            bytes(pending[frame.offset:frame.offset + frame.length]))
+                cursor = frame.offset + frame.length
+            if consumed > cursor:
+                self._capture_writer.append(ts_ns, direction_code, capture_file.STATUS_RAW, 0,
+                                            bytes(pending[cursor:consumed]))
+            del pending[:consumed]
+            if len(pending) > 0xFFFF:
+                # 迟迟凑不成完整帧的数据按原始记录写出，避免无限累积
+                self._capture_writer.append(ts_ns, direction_code, capture_file.STATUS_RAW, 0, bytes(pending[:0xFFFF]))
+                del pending[:0xFFFF]
+        except (OSError, ValueError) as e:
+            if self.error_logger:
+                self.error_logger.log_error(f"写入录制文件失败: {e}", "RECORDER")
@@ -0,0 +1,123 @@
+"""多串口网关(yj_gateway)客户端
+
+yj_gateway 在一个进程内用 epoll 服务多个串口，把解出的帧经 AF_UNIX/SOCK_SEQPACKET 套接字转发出来，
+消息格式见 protocol/host/yj_gateway.h：每个消息由若干条 16 字节记录头 + 数据的记录拼接而成。
+本模块负责解析/编码这些记录，并提供一个阻塞式客户端，供脚本或上位机替代逐板卡的串口连接。
+"""
+
+import socket
+import struct
+from typing import Dict, Iterator, List, NamedTuple, Optional
+
+DEFAULT_SOCKET_PATH = "/tmp/yj_gateway.sock"
+RECORD_HEADER_SIZE = 16
+MAX_MESSAGE_SIZE = 65536
+
+REC_FRAME = 0x01
+REC_PORT_OPEN = 0x02
+REC_PORT_CLOSED = 0x03
+REC_TX = 0x04
+REC_DROPPED = 0x05
+
+FLAG_CRC16 = 0x01
+
+_RECORD_HEADER = struct.Struct("<HBBQBBBB")  # record_len, type, port, ts_ns, s_addr, d_addr, func_id, flags
+_U64 = struct.Struct("<Q")
+
+
+class GatewayRecord(NamedTuple):
+    """网关记录"""
+    type: int
+    port: int
+    ts_ns: int
+    s_addr: int
+    d_addr: int
+    func_id: int
+    flags: int
+    data: bytes
+
+
+def iter_records(message: bytes) -> Iterator[GatewayRecord]:
+    """解析一个套接字消息中的所有记录；遇到格式错误的记录时停止"""
+    view = memoryview(message)
+    pos = 0
+    while pos + RECORD_HEADER_SIZE <= len(view):
+        size, rec_type, port, ts_ns, s_addr, d_addr, func_id, flags = _RECORD_HEADER.unpack_from(view, pos)
+        if size < RECORD_HEADER_SIZE or pos + size > len(view):
+            break
+        yield GatewayRecord(rec_type, port, ts_ns, s_addr, d_addr, func_id, flags,
+                            bytes(view[pos + RECORD_HEADER_SIZE:pos + size]))
+        pos += size
+
+
+def encode_record(rec_type: int, port: int, data: bytes = b"", ts_ns: int = 0,
+                  s_addr: int = 0, d_addr: int = 0, func_id: int = 0, flags: int = 0) -> bytes:
+    """编码一条记录"""
+    size = RECORD_HEADER_SIZE + len(data)
+    if size > 0xFFFF:
+        raise ValueError(f"记录过长: {size} 字节")
+    return _RECORD_HEADER.pack(size, rec_type, port, ts_ns, s_addr, d_addr, func_id, flags) + bytes(data)
+
+
+def encode_tx(port: int, d_addr: int, func_id: int, data: bytes) -> bytes:
+    """编码一条TX记录：请求网关经port发送一帧"""
+    return encode_record(REC_TX, port, data, d_addr=d_addr, func_id=func_id)
+
+
+def dropped_count(record: GatewayRecord) -> int:
+    """DROPPED记录中的丢弃记录数"""
+    return _U64.unpack_from(record.data)[0] if len(record.data) >= _U64.size else 0
+
+
+class GatewayClient:
+    """网关客户端：连接后首先收到各端口当前状态，之后持续收到FRAME/端口状态记录"""
+
+    def __init__(self, path: str = DEFAULT_SOCKET_PATH, timeout: Optional[float] = None):
+        self._sock = socket.socket(socket.AF_UNIX, socket.SOCK_SEQPACKET)
+        self._sock.settimeout(timeout)
+        try:
+            self._sock.connect(path)
+        except OSError:
+            self._sock.close()
+            raise
+        self.ports: Dict[int, Optional[str]] = {}  # 端口号 -> 设备路径(None表示已关闭)
+        self.dropped = 0
+
+    def close(self) -> None:
+        self._sock.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def fileno(self) -> int:
+        return self._sock.fileno()
+
+    def recv(self) -> List[GatewayRecord]:
+        """接收一个消息并返回其中的记录；连接关闭时返回空列表。端口状态和丢弃计数同时更新到属性中"""
+        message = self._sock.recv(MAX_MESSAGE_SIZE)
+        records = list(iter_records(message))
+        for record in records:
+            if record.type == REC_PORT_OPEN:
+                self.ports[record.port] = record.data.decode("utf-8", "replace")
+            elif record.type == REC_PORT_CLOSED:
+                self.ports[record.port] = None
+            elif record.type == REC_DROPPED:
+                self.dropped += dropped_count(record)
+        return records
+
+    def frames(self) -> Iterator[GatewayRecord]:
+        """持续产出FRAME记录，直到连接关闭"""
+        while True:
+            records = self.recv()
+            if not records:
+                return
+            for record in records:
+                if record.type == REC_FRAME:
+                    yield record
+
+    def send_frame(self, port: int, d_addr: int, func_id: int, data: bytes) -> None:
+        """请求网关经指定端口发送一帧"""
+        self._sock.sendall(encode_tx(port, d_addr, func_id, data))
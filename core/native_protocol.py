@@ -0,0 +1,228 @@
+"""YJ协议原生加速模块封装
+
+优先加载由 protocol/host/yj_native_module.c 编译得到的 _yj_native 扩展，
+一次调用即可扫描整块接收数据或将其批量解码为按通道连续存放的数组；
+扩展不可用时回退到行为一致的纯Python实现。
+"""
+
+import struct
+from array import array
+from typing import Dict, List, NamedTuple, Optional, Sequence, Tuple, Union
+
+from utils.constants import ChecksumMode
+
+try:
+    from core import _yj_native as _native
+except ImportError:
+    try:
+        import _yj_native as _native
+    except ImportError:
+        _native = None
+
+BytesLike = Union[bytes, bytearray, memoryview]
+
+FRAME_HEAD_BYTE = 0xAB
+FRAME_HEADER_SIZE = 6
+FRAME_MIN_OVERHEAD = 8
+DEFAULT_MAX_PAYLOAD = 256
+
+# 字段类型编码（对应C枚举 yj_field_type_t），键与 Constants.DATA_TYPE_SIZES 一致
+FIELD_TYPES: Dict[str, int] = {
+    "uint8_t": 0,
+    "int8_t": 1,
+    "uint16_t": 2,
+    "int16_t": 3,
+    "uint32_t": 4,
+    "int32_t": 5,
+    "float (4B)": 6,
+    "double (8B)": 7,
+}
+_FIELD_STRUCT_FORMATS = ("<B", "<b", "<H", "<h", "<I", "<i", "<f", "<d")
+
+
+class FrameSpan(NamedTuple):
+    """扫描得到的帧位置信息（对应C结构体 yj_frame_span_t）"""
+    offset: int
+    length: int
+    func_id: int
+    s_addr: int
+    d_addr: int
+    checksum_ok: bool
+
+
+def is_available() -> bool:
+    """原生扩展是否已加载"""
+    return _native is not None
+
+
+def native_module():
+    """返回已加载的 _yj_native 扩展模块，不可用时返回None"""
+    return _native
+
+
+def create_byte_ring(capacity: int):
+    """创建原生SPSC字节环形缓冲区（_yj_native.ByteRing），扩展不可用时返回None"""
+    if _native is None:
+        return None
+    return _native.ByteRing(capacity)
+
+
+def scan_frames(data: BytesLike, checksum_mode: ChecksumMode = ChecksumMode.ORIGINAL_SUM_ADD,
+                head: int = FRAME_HEAD_BYTE, max_payload: int = DEFAULT_MAX_PAYLOAD,
+                max_frames: int = 0) -> Tuple[List[FrameSpan], int]:
+    """扫描整块数据中的所有完整帧
+
+    Args:
+        data: 接收数据
+        checksum_mode: 校验模式
+        head: 帧头字节
+        max_payload: 允许的最大数据长度，超过时视为伪帧头并重新同步
+        max_frames: 最多返回的帧数，0 表示不限制
+
+    Returns:
+        (帧位置列表, 可丢弃的字节数)
+    """
+    if _native is not None:
+        frames, consumed = _native.scan_frames(data, checksum_mode.value, head, max_payload, max_frames)
+        return [FrameSpan._make(f) for f in frames], consumed
+    return _scan_frames_python(data, checksum_mode, head, max_payload, max_frames)
+
+
+def _verify_checksum(frame: BytesLike, checked_len: int, checksum_mode: ChecksumMode) -> bool:
+    if checksum_mode == ChecksumMode.CRC16_CCITT_FALSE:
+        crc = 0xFFFF
+        for byte in frame[:checked_len]:
+            crc ^= byte << 8
+            for _ in range(8):
+                crc = ((crc << 1) ^ 0x1021) & 0xFFFF if crc & 0x8000 else (crc << 1) & 0xFFFF
+        return crc == ((frame[checked_len] << 8) | frame[checked_len + 1])
+    sc = ac = 0
+    for byte in frame[:checked_len]:
+        sc = (sc + byte) & 0xFF
+        ac = (ac + sc) & 0xFF
+    return sc == frame[checked_len] and ac == frame[checked_len + 1]
+
+
+def _scan_frames_python(data: BytesLike, checksum_mode: ChecksumMode, head: int,
+                        max_payload: int, max_frames: int) -> Tuple[List[FrameSpan], int]:
+    """与 yj_protocol_scan_buffer 行为一致的纯Python实现"""
+    data = bytes(data)
+    length = len(data)
+    frames: List[FrameSpan] = []
+    pos = 0
+    # 帧长度字段为16位，整帧不能超过0xFFFF字节
+    max_payload = min(max_payload, 0xFFFF - FRAME_MIN_OVERHEAD)
+    while pos < length and (max_frames <= 0 or len(frames) < max_frames):
+        pos = data.find(bytes([head]), pos)
+        if pos < 0:
+            pos = length
+            break
+        if length - pos < FRAME_HEADER_SIZE:
+            break
+        data_len = data[pos + 4] | (data[pos + 5] << 8)
+        if data_len > max_payload:
+            pos += 1
+            continue
+        frame_len = FRAME_MIN_OVERHEAD + data_len
+        if length - pos < frame_len:
+            break
+        frame = data[pos:pos + frame_len]
+        frames.append(FrameSpan(pos, frame_len, frame[3], frame[1], frame[2],
+                                _verify_checksum(frame, FRAME_HEADER_SIZE + data_len, checksum_mode)))
+        pos += frame_len
+    return frames, pos
+
+
+class ColumnDecodeResult(NamedTuple):
+    """批量解码结果"""
+    rows: int
+    consumed: int
+    checksum_errors: int
+    skipped_frames: int
+
+
+def make_layout(fields: Sequence[Tuple[int, Union[str, int]]]) -> List[Tuple[int, int]]:
+    """将 (偏移, 类型名或类型编码) 序列转换为 decode_columns 使用的布局
+
+    类型名与 Constants.DATA_TYPE_SIZES 的键一致，例如 "int16_t"、"float (4B)"。
+    """
+    layout = []
+    for offset, field_type in fields:
+        code = FIELD_TYPES[field_type] if isinstance(field_type, str) else int(field_type)
+        if not 0 <= code < len(_FIELD_STRUCT_FORMATS):
+            raise ValueError(f"未知字段类型: {field_type}")
+        layout.append((int(offset), code))
+    return layout
+
+
+def allocate_columns(field_count: int, rows: int):
+    """分配列数组：numpy可用时返回float64数组，否则返回array('d')"""
+    try:
+        import numpy as np
+        return [np.zeros(rows, dtype=np.float64) for _ in range(field_count)]
+    except ImportError:
+        return [array('d', bytes(8 * rows)) for _ in range(field_count)]
+
+
+def decode_columns(data: BytesLike, layout: Sequence[Tuple[int, int]], columns: Sequence,
+                   func_id: Optional[int] = None,
+                   checksum_mode: ChecksumMode = ChecksumMode.ORIGINAL_SUM_ADD,
+                   head: int = FRAME_HEAD_BYTE,
+                   max_payload: int = DEFAULT_MAX_PAYLOAD) -> ColumnDecodeResult:
+    """将整块数据中的帧按字段布局批量解码到预分配的列数组
+
+    只解码校验通过且功能ID匹配的帧，第i个字段写入 columns[i] 的第 rows 行之前，
+    不为每帧创建Python对象。原生扩展可用时解码期间释放GIL。
+
+    Args:
+        data: 接收数据或拼接后的多帧
+        layout: make_layout 生成的布局
+        columns: 与 layout 等长的可写float64缓冲区（numpy数组或array('d')），
+                 行数上限取各列长度的最小值
+        func_id: 只解码该功能ID的帧，None 表示不过滤
+        checksum_mode: 校验模式
+        head: 帧头字节
+        max_payload: 允许的最大数据长度
+
+    Returns:
+        ColumnDecodeResult；consumed 为可丢弃的字节数，列数组写满时指向下一帧起点
+    """
+    target = -1 if func_id is None else func_id
+    if _native is not None:
+        return ColumnDecodeResult(*_native.decode_columns(
+            data, layout, columns, target, checksum_mode.value, head, max_payload))
+    return _decode_columns_python(data, layout, columns, target, checksum_mode, head, max_payload)
+
+
+def _decode_columns_python(data: BytesLike, layout: Sequence[Tuple[int, int]], columns: Sequence,
+                           func_id: int, checksum_mode: ChecksumMode, head: int,
+                           max_payload: int) -> ColumnDecodeResult:
+    """与 yj_batch_decode_columns 行为一致的纯Python实现"""
+    if len(layout) != len(columns):
+        raise ValueError("layout 与 columns 长度不一致")
+    data = bytes(data)
+    fields = [(offset, struct.Struct(_FIELD_STRUCT_FORMATS[code])) for offset, code in layout]
+    min_payload = max((offset + fmt.size for offset, fmt in fields), default=0)
+    if columns:
+        capacity = min(len(column) for column in columns)
+    else:
+        capacity = len(data) // FRAME_MIN_OVERHEAD + 1
+
+    frames, consumed = _scan_frames_python(data, checksum_mode, head, max_payload, 0)
+    rows = checksum_errors = skipped = 0
+    for frame in frames:
+        if rows >= capacity:
+            consumed = frame.offset
+            break
+        if not frame.checksum_ok:
+            checksum_errors += 1
+            continue
+        if (func_id >= 0 and frame.func_id != func_id) or \
+                frame.length - FRAME_MIN_OVERHEAD < min_payload:
+            skipped += 1
+            continue
+        payload_start = frame.offset + FRAME_HEADER_SIZE
+        for column, (offset, fmt) in zip(columns, fields):
+            column[rows] = float(fmt.unpack_from(data, payload_start + offset)[0])
+        rows += 1
+    return ColumnDecodeResult(rows, consumed, checksum_errors, skipped)
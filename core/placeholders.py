@@ -460,6 +460,142 @@ class CircularBuffer:
                    f"Data: {self._internal_buffer.hex(' ')}")
         finally:
             self.mutex.unlock()
+
+
+class NativeRingBuffer:
+    """基于原生 _yj_native.ByteRing 的无锁接收缓冲区，接口与 CircularBuffer 一致
+
+    读线程（生产者）通过 write / write_from_fd 写入，解析线程（消费者）通过
+    peek / peek_view / discard 读取，双方无需加锁。与 CircularBuffer 的区别：
+    容量向上取整为2的幂；空间不足时丢弃新数据而不是覆盖未解析的旧数据。
+    """
+
+    def __init__(self, size: int):
+        if size <= 0:
+            raise ValueError("Buffer size must be positive")
+        from core import native_protocol
+        self._ring = native_protocol.create_byte_ring(size)
+        if self._ring is None:
+            raise RuntimeError("_yj_native extension is not available")
+        self.max_size = self._ring.capacity
+        self.capacity = self.max_size
+        self._total_writes = 0
+        self._total_reads = 0
+        self._bytes_read = 0
+        self._overflow_base = 0
+
+    @property
+    def ring(self):
+        """底层 ByteRing 对象，供读线程直接调用 write_from_fd"""
+        return self._ring
+
+    def write(self, data: QByteArray) -> int:
+        """写入数据（生产者），返回实际写入字节数"""
+        if data.size() == 0:
+            return 0
+        self._total_writes += 1
+        return self._ring.write(data.data())
+
+    def write_from_fd(self, fd: int, max_bytes: int = 0) -> int:
+        """从文件描述符直接读入缓冲区（生产者），读取期间释放GIL"""
+        written = self._ring.write_from_fd(fd, max_bytes)
+        if written:
+            self._total_writes += 1
+        return written
+
+    def read(self, length: int) -> QByteArray:
+        """读取并移除数据"""
+        self._total_reads += 1
+        data = self._ring.read(length)
+        self._bytes_read += len(data)
+        return QByteArray(data)
+
+    def peek(self, length: int) -> QByteArray:
+        """查看但不移除数据"""
+        if length <= 0:
+            return QByteArray()
+        return QByteArray(bytes(self._ring.peek(length)))
+
+    def peek_view(self, length: int = -1) -> memoryview:
+        """零拷贝查看数据，返回只读memoryview，在discard之前有效"""
+        return self._ring.peek(length)
+
+    def mid(self, pos: int, length: int = -1) -> QByteArray:
+        """从指定位置提取数据（不移动指针）"""
+        view = self._ring.peek()
+        if pos < 0 or pos >= len(view):
+            return QByteArray()
+        end = len(view) if length < 0 else min(len(view), pos + length)
+        return QByteArray(bytes(view[pos:end]))
+
+    def left(self, length: int) -> QByteArray:
+        """获取缓冲区开头的数据"""
+        return self.mid(0, length)
+
+    def right(self, length: int) -> QByteArray:
+        """获取缓冲区末尾的数据"""
+        return self.mid(max(0, len(self._ring) - length))
+
+    def discard(self, length: int) -> int:
+        """丢弃指定长度的数据，返回实际丢弃字节数"""
+        if length <= 0:
+            return 0
+        discarded = self._ring.discard(length)
+        self._bytes_read += discarded
+        return discarded
+
+    def clear(self):
+        """清空缓冲区"""
+        self._ring.clear()
+
+    def get_count(self) -> int:
+        """获取当前数据量"""
+        return len(self._ring)
+
+    def get_free_space(self) -> int:
+        """获取剩余空间"""
+        return self._ring.space
+
+    def is_empty(self) -> bool:
+        """检查是否为空"""
+        return len(self._ring) == 0
+
+    def is_full(self) -> bool:
+        """检查是否已满"""
+        return self._ring.space == 0
+
+    def get_stats(self) -> dict:
+        """获取性能统计信息"""
+        count = len(self._ring)
+        return {
+            'total_writes': self._total_writes,
+            'total_reads': self._total_reads,
+            'bytes_written': self._ring.bytes_written,
+            'bytes_read': self._bytes_read,
+            'buffer_overflows': self._ring.overflow_bytes - self._overflow_base,
+            'current_usage': count,
+            'usage_percentage': (count / self.max_size) * 100,
+            'buffer_size': self.max_size,
+            'free_space': self.max_size - count
+        }
+
+    def reset_stats(self):
+        """重置性能统计信息"""
+        self._total_writes = 0
+        self._total_reads = 0
+        self._bytes_read = 0
+        self._overflow_base = self._ring.overflow_bytes
+
+    def debug_dump(self) -> str:
+        """调试用：打印缓冲区状态和性能统计"""
+        stats = self.get_stats()
+        return (f"NativeRingBuffer(size={self.max_size}, used={stats['current_usage']})\n"
+                f"Usage: {stats['usage_percentage']:.1f}%\n"
+                f"Stats: Writes={stats['total_writes']}, Reads={stats['total_reads']}, "
+                f"Overflow bytes={stats['buffer_overflows']}\n"
+                f"Data: {bytes(self._ring.peek()).hex(' ')}")
+
+
 class DataProcessor(QThread):
     """数据处理线程类"""
     processed_data_signal = Signal(str, QByteArray)
@@ -13,6 +13,7 @@ from utils.constants import ChecksumMode
 from utils.data_models import FrameConfig
 from utils.logger import ErrorLogger
 # 导入协议错误枚举和异常类
+from core import native_protocol
 from core.protocol_errors import ProtocolError, ProtocolException, ChecksumMismatchError, FrameParseError
 
 # 导入CRC计算函数
@@ -135,6 +136,84 @@ class ProtocolDecoder(QObject):
             self.decode_error.emit(error_msg, frame_data)
             return None
     
+    def decode_span(self, chunk, span: native_protocol.FrameSpan,
+                    target_func_id_hex: str = "") -> Optional[ParsedFrame]:
+        """解码由 native_protocol.scan_frames 定位并校验过的单帧
+
+        与decode_frame发射相同的信号、更新相同的统计，供FrameParser的原生解析路径使用。
+
+        Args:
+            chunk: 传给scan_frames的数据块
+            span: scan_frames返回的帧位置信息
+            target_func_id_hex: 目标功能ID（可选过滤，大写十六进制）
+
+        Returns:
+            解析成功返回ParsedFrame对象，失败返回None
+        """
+        decode_start_time = time.time()
+        self._decode_stats['total_frames'] += 1
+
+        raw = bytes(chunk[span.offset:span.offset + span.length])
+        if not span.checksum_ok:
+            frame_data = QByteArray(raw)
+            error_msg = f"Checksum verification failed (FID {span.func_id:02X})"
+            self.checksum_error.emit(error_msg, frame_data)
+            self._handle_decode_error(FrameValidationResult(
+                False, ProtocolError.CHECKSUM_MISMATCH, error_msg, frame_data))
+            decode_time_ms = (time.time() - decode_start_time) * 1000
+            self._decode_stats['avg_decode_time_ms'] = (self._decode_stats['avg_decode_time_ms'] * (self._decode_stats['total_frames'] - 1) + decode_time_ms) / self._decode_stats['total_frames']
+            return None
+
+        func_id_hex = f"{span.func_id:02X}"
+        if target_func_id_hex and func_id_hex != target_func_id_hex:
+            self._update_decode_stats((time.time() - decode_start_time) * 1000, False)
+            return None
+
+        checksum_length = native_protocol.FRAME_MIN_OVERHEAD - native_protocol.FRAME_HEADER_SIZE
+        parsed_frame = ParsedFrame(
+            func_id_hex=func_id_hex,
+            data_payload=QByteArray(raw[native_protocol.FRAME_HEADER_SIZE:len(raw) - checksum_length]),
+            source_addr=span.s_addr,
+            dest_addr=span.d_addr
+        )
+        self._update_decode_stats((time.time() - decode_start_time) * 1000, True)
+
+        self.frame_decoded.emit(parsed_frame)
+        return parsed_frame
+
+    def decode_batch(self, chunk, layout, columns, checksum_mode: ChecksumMode,
+                     target_func_id_hex: str = "", head_byte: int = native_protocol.FRAME_HEAD_BYTE,
+                     max_payload: int = native_protocol.DEFAULT_MAX_PAYLOAD) -> native_protocol.ColumnDecodeResult:
+        """批量解码多帧或原始接收数据块到按通道连续存放的列数组
+
+        与decode_frame不同，不为每帧创建ParsedFrame对象、不发射逐帧信号，
+        适合每秒数千帧的波形数据流。
+
+        Args:
+            chunk: 原始数据块（bytes/bytearray/memoryview/QByteArray）
+            layout: native_protocol.make_layout 生成的字段布局
+            columns: 预分配的float64列数组（见native_protocol.allocate_columns）
+            checksum_mode: 校验模式
+            target_func_id_hex: 目标功能ID（可选过滤）
+            head_byte: 帧头字节
+            max_payload: 允许的最大数据长度
+
+        Returns:
+            ColumnDecodeResult(rows, consumed, checksum_errors, skipped_frames)
+        """
+        if isinstance(chunk, QByteArray):
+            chunk = chunk.data()
+        func_id = int(target_func_id_hex, 16) if target_func_id_hex else None
+        result = native_protocol.decode_columns(chunk, layout, columns, func_id,
+                                                checksum_mode, head_byte, max_payload)
+
+        decoded = result.rows + result.checksum_errors + result.skipped_frames
+        self._decode_stats['total_frames'] += decoded
+        self._decode_stats['successful_frames'] += result.rows
+        self._decode_stats['failed_frames'] += result.checksum_errors + result.skipped_frames
+        self._decode_stats['checksum_errors'] += result.checksum_errors
+        return result
+
     def _validate_frame(self, frame_data: QByteArray, frame_config: FrameConfig, 
                        checksum_mode: ChecksumMode) -> FrameValidationResult:
         """验证帧的完整性和校验和"""
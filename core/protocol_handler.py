@@ -5,13 +5,14 @@ from PySide6.QtCore import QObject, Signal, QByteArray, QTimer
 from dataclasses import dataclass
 from enum import Enum
 
-from core.placeholders import CircularBuffer
+from core.placeholders import CircularBuffer, NativeRingBuffer
 from utils.constants import Constants,ChecksumMode
 from utils.data_models import FrameConfig
 from utils.logger import ErrorLogger
 from utils.protocol_config_manager import get_global_config_manager, ProtocolConfigManager
 from core.protocol_errors import ProtocolError, ProtocolException, ChecksumMismatchError, FrameParseError, BufferOverflowError
 from core.protocol_decoder import ProtocolDecoder
+from core import native_protocol
 from utils.config_accessor import ConfigManager
 import crcmod
 
@@ -207,7 +208,11 @@ class FrameParser(QObject):
         
         # 根据配置初始化缓冲区
         actual_buffer_size = self.config.performance.buffer_size
-        self.buffer = CircularBuffer(actual_buffer_size)  # Using CircularBuffer
+        if native_protocol.is_available() and self.config.performance.use_native_ring_buffer:
+            # 读线程与解析线程之间的无锁SPSC缓冲区，支持从串口fd直接读入
+            self.buffer = NativeRingBuffer(actual_buffer_size)
+        else:
+            self.buffer = CircularBuffer(actual_buffer_size)  # Using CircularBuffer
         
         # 重传和ACK机制
         self._pending_frames: Dict[int, PendingFrame] = {}
@@ -422,6 +427,7 @@ class FrameParser(QObject):
     
     def _on_frame_decoded(self, parsed_frame):
         """处理解码成功的帧"""
+        self._parsed_frame_count += 1
         # 发射原有的信号以保持兼容性
         self.frame_successfully_parsed.emit(parsed_frame.func_id_hex, parsed_frame.data_payload)
         
@@ -476,6 +482,12 @@ class FrameParser(QObject):
 
         head_byte_value = frame_head_byte[0]
         
+        # 原生扩展可用时一次扫描整个缓冲区，不受max_frames_per_parse限制
+        if native_protocol.is_available() and self.config.performance.use_native_parser:
+            self._try_parse_frames_native(head_byte_value, parse_target_func_id_hex,
+                                          active_checksum_mode, parse_start_time)
+            return
+        
         # 使用新的解析逻辑
         for _ in range(max_frames_per_parse):
             # 检查是否有足够数据
@@ -517,6 +529,40 @@ class FrameParser(QObject):
         if total_parse_time > parse_warning_threshold:
             self._analyzer.performance_warning.emit(f"帧解析总耗时过长: {total_parse_time:.2f}ms, 解析帧数: {frames_parsed_this_call}")
     
+    def _try_parse_frames_native(self, head_byte_value: int, parse_target_func_id_hex: str,
+                                 active_checksum_mode: ChecksumMode, parse_start_time: float):
+        """使用C扫描器一次性解析缓冲区中的所有完整帧"""
+        buffer_count = self.buffer.get_count()
+        if buffer_count < Constants.MIN_HEADER_LEN_FOR_DATA_LEN:
+            return
+        
+        # 原生环形缓冲区可零拷贝查看数据；视图在discard之前有效，因此解析完成后再discard
+        zero_copy = hasattr(self.buffer, 'peek_view')
+        chunk = self.buffer.peek_view(buffer_count) if zero_copy else self.buffer.peek(buffer_count).data()
+        spans, consumed = native_protocol.scan_frames(
+            chunk, active_checksum_mode, head_byte_value,
+            self.config.frame_format.max_data_payload_size
+        )
+        if not zero_copy:
+            self.buffer.discard(consumed)
+        
+        target_func_id = parse_target_func_id_hex.strip().upper() if parse_target_func_id_hex else ""
+        frames_parsed_this_call = 0
+        for span in spans:
+            # 经ProtocolDecoder发射frame_decoded/错误信号并更新解码统计，与Python解析路径一致
+            if self._decoder.decode_span(chunk, span, target_func_id):
+                frames_parsed_this_call += 1
+                frame_parse_time = (time.time() - parse_start_time) * 1000
+                self._analyzer.analyze_frame(chunk[span.offset:span.offset + span.length], "rx", False, frame_parse_time)
+        
+        if zero_copy:
+            self.buffer.discard(consumed)
+        
+        total_parse_time = (time.time() - parse_start_time) * 1000
+        parse_warning_threshold = self.config.performance.parse_timeout_warning_ms
+        if total_parse_time > parse_warning_threshold:
+            self._analyzer.performance_warning.emit(f"帧解析总耗时过长: {total_parse_time:.2f}ms, 解析帧数: {frames_parsed_this_call}")
+    
     def _extract_complete_frame(self, frame_config: FrameConfig) -> Optional[QByteArray]:
         """从缓冲区提取完整的帧数据"""
         try:
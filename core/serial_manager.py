@@ -9,6 +9,7 @@ from utils.logger import ErrorLogger
 class SerialManager(QObject):
     connection_status_changed = Signal(bool, str)  # is_connected, message
     data_received = Signal(QByteArray)
+    ring_data_received = Signal(int)  # 读线程已直接写入接收环形缓冲区的字节数
     error_occurred_signal = Signal(str)  # For non-critical errors to display
 
     def __init__(self, error_logger: Optional[ErrorLogger] = None, parent: Optional[QObject] = None, use_pyserial: bool = False):
@@ -16,6 +17,7 @@ class SerialManager(QObject):
         self.error_logger = error_logger
         self.is_connected = False
         self.use_pyserial = use_pyserial
+        self._receive_ring = None  # 直接接收模式下的目标缓冲区(NativeRingBuffer)
         if self.use_pyserial:
             self.serial_port = None
             self.read_thread = None
@@ -25,6 +27,22 @@ class SerialManager(QObject):
             self.serial_port.readyRead.connect(self._read_data)
             self.serial_port.errorOccurred.connect(self._handle_serial_error)
 
+    def set_receive_ring(self, ring_buffer) -> bool:
+        """设置直接接收模式的目标缓冲区
+
+        仅pyserial模式下生效：读线程从串口fd直接读入 ring_buffer（需提供write_from_fd，
+        即NativeRingBuffer），只发射ring_data_received(int)，不再为每次读取创建bytes/QByteArray。
+        传入None恢复普通模式。下次打开串口时生效。
+
+        Returns:
+            是否支持直接接收模式
+        """
+        if ring_buffer is not None and (not self.use_pyserial or not hasattr(ring_buffer, 'write_from_fd')):
+            self._receive_ring = None
+            return False
+        self._receive_ring = ring_buffer
+        return True
+
     def get_available_ports(self) -> List[Dict[str, str]]:
         ports_info = []
         if self.use_pyserial:
@@ -102,8 +120,9 @@ class SerialManager(QObject):
                 if self.error_logger:
                     self.error_logger.log_info(f"已连接 {config.port_name} @ {config.baud_rate} (pyserial)")
                 # 启动读取线程
-                self.read_thread = SerialReadThread(self.serial_port, self)
+                self.read_thread = SerialReadThread(self.serial_port, self, self._receive_ring)
                 self.read_thread.data_received.connect(self.data_received)
+                self.read_thread.ring_data_received.connect(self.ring_data_received)
                 self.read_thread.start()
                 return True
             except Exception as e:
@@ -278,20 +297,39 @@ class SerialManager(QObject):
 
 class SerialReadThread(QThread):
     data_received = Signal(QByteArray)
+    ring_data_received = Signal(int)
 
-    def __init__(self, serial_port: serial.Serial, parent: Optional[QObject] = None):
+    def __init__(self, serial_port: serial.Serial, parent: Optional[QObject] = None, receive_ring=None):
         super().__init__(parent)
         self.serial_port = serial_port
         self._running = True
+        self._receive_ring = receive_ring
 
     def run(self):
         parent = self.parent()
         if parent and hasattr(parent, 'error_logger') and parent.error_logger:
             parent.error_logger.log_info("SerialReadThread started")
         
+        # 直接接收模式：从fd读入环形缓冲区，不经过Python bytes对象
+        fd = None
+        if self._receive_ring is not None:
+            try:
+                fd = self.serial_port.fileno()
+            except (AttributeError, OSError, ValueError):
+                fd = None  # 平台不支持fileno时退回普通模式
+        
         while self._running:
             try:
                 if self.serial_port.in_waiting > 0:
+                    if fd is not None:
+                        received = self._receive_ring.write_from_fd(fd, self.serial_port.in_waiting)
+                        if received > 0:
+                            self.ring_data_received.emit(received)
+                        else:
+                            # 缓冲区已满，等待解析线程消费
+                            self.msleep(1)
+                        continue
+                    
                     data = self.serial_port.read(self.serial_port.in_waiting)
                     # 修正：确保数据正确转换为 QByteArray
                     if isinstance(data, bytes):
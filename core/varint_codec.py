@@ -0,0 +1,140 @@
+"""变长整数编解码模块
+
+与 protocol/yj_protocol.c 中的 yj_pack_varint_* / yj_unpack_varint_* 保持一致的
+LEB128 varint 与 ZigZag 编码实现，供上位机批量解码下位机发送的紧凑计数值和差分序列。
+"""
+
+from typing import Iterable, List, Tuple, Union
+
+BytesLike = Union[bytes, bytearray, memoryview]
+
+VARINT32_MAX_BYTES = 5
+_U32_MASK = 0xFFFFFFFF
+
+
+class VarintDecodeError(ValueError):
+    """varint 数据不完整或编码超长"""
+
+
+def zigzag_encode(value: int) -> int:
+    """ZigZag 编码：32 位有符号数映射为无符号数"""
+    return ((value << 1) ^ (value >> 31)) & _U32_MASK
+
+
+def zigzag_decode(value: int) -> int:
+    """ZigZag 解码：无符号数还原为 32 位有符号数"""
+    return (value >> 1) ^ -(value & 1)
+
+
+def _to_i32(value: int) -> int:
+    value &= _U32_MASK
+    return value - 0x100000000 if value & 0x80000000 else value
+
+
+def encode_varint(value: int) -> bytes:
+    """编码单个 32 位无符号 varint"""
+    if not 0 <= value <= _U32_MASK:
+        raise ValueError(f"varint 超出 u32 范围: {value}")
+    out = bytearray()
+    while value >= 0x80:
+        out.append((value & 0x7F) | 0x80)
+        value >>= 7
+    out.append(value)
+    return bytes(out)
+
+
+def encode_zigzag(value: int) -> bytes:
+    """编码单个 32 位有符号 varint（ZigZag）"""
+    return encode_varint(zigzag_encode(value))
+
+
+def decode_varint(data: BytesLike, offset: int = 0) -> Tuple[int, int]:
+    """解码单个 32 位无符号 varint
+
+    Returns:
+        (解码值, 消耗的字节数)
+
+    Raises:
+        VarintDecodeError: 数据不完整或编码超过 5 字节
+    """
+    result = 0
+    end = min(len(data), offset + VARINT32_MAX_BYTES)
+    for i in range(offset, end):
+        byte = data[i]
+        shift = 7 * (i - offset)
+        result |= (byte & 0x7F) << shift
+        if not byte & 0x80:
+            # 第 5 字节只允许携带高 4 位，与 C 实现一致
+            if i - offset == VARINT32_MAX_BYTES - 1 and byte > 0x0F:
+                break
+            return result, i - offset + 1
+    raise VarintDecodeError(f"偏移 {offset} 处的 varint 不完整或超长")
+
+
+def decode_varint_array(data: BytesLike, count: int = -1, offset: int = 0) -> Tuple[List[int], int]:
+    """批量解码无符号 varint 数组
+
+    Args:
+        data: 输入数据（通常为帧数据负载）
+        count: 期望元素个数，-1 表示解码到数据末尾
+        offset: 起始偏移
+
+    Returns:
+        (值列表, 消耗的总字节数)
+    """
+    values: List[int] = []
+    pos = offset
+    end = len(data)
+    # 单字节值占绝大多数，内联快速路径避免逐个调用 decode_varint
+    while pos < end and (count < 0 or len(values) < count):
+        byte = data[pos]
+        if byte < 0x80:
+            values.append(byte)
+            pos += 1
+        else:
+            value, n = decode_varint(data, pos)
+            values.append(value)
+            pos += n
+    if 0 <= count != len(values):
+        raise VarintDecodeError(f"期望 {count} 个元素，实际只解码出 {len(values)} 个")
+    return values, pos - offset
+
+
+def decode_zigzag_array(data: BytesLike, count: int = -1, offset: int = 0) -> Tuple[List[int], int]:
+    """批量解码有符号 varint 数组（每个元素独立 ZigZag 编码）"""
+    raw, consumed = decode_varint_array(data, count, offset)
+    return [(v >> 1) ^ -(v & 1) for v in raw], consumed
+
+
+def decode_delta_array(data: BytesLike, count: int = -1, offset: int = 0) -> Tuple[List[int], int]:
+    """批量解码差分序列（对应 yj_pack_varint_delta_array）
+
+    首元素为 ZigZag 值，其后为与前一元素之差，按 32 位回绕累加。
+    """
+    deltas, consumed = decode_zigzag_array(data, count, offset)
+    values: List[int] = []
+    acc = 0
+    for delta in deltas:
+        acc = (acc + delta) & _U32_MASK
+        values.append(_to_i32(acc))
+    return values, consumed
+
+
+def encode_varint_array(values: Iterable[int]) -> bytes:
+    """批量编码无符号 varint 数组"""
+    return b"".join(encode_varint(v) for v in values)
+
+
+def encode_zigzag_array(values: Iterable[int]) -> bytes:
+    """批量编码有符号 varint 数组"""
+    return b"".join(encode_zigzag(v) for v in values)
+
+
+def encode_delta_array(values: Iterable[int]) -> bytes:
+    """批量编码差分序列（对应 yj_pack_varint_delta_array）"""
+    out = bytearray()
+    prev = 0
+    for value in values:
+        out += encode_zigzag(_to_i32(value - prev))
+        prev = value & _U32_MASK
+    return bytes(out)
@@ -136,6 +136,11 @@ class SerialDebugger(QMainWindow):
 
         self.serial_manager.connection_status_changed.connect(self.on_serial_connection_status_changed)
         self.serial_manager.data_received.connect(self.on_serial_data_received)
+        self.serial_manager.ring_data_received.connect(self.on_serial_ring_data_received)
+        if self.frame_parser.config.performance.direct_fd_receive:
+            # 高吞吐模式：读线程直接写入解析器的原生环形缓冲区
+            if self.serial_manager.set_receive_ring(self.frame_parser.buffer):
+                self.error_logger.log_info("已启用串口直接接收模式（原始数据不再显示/记录）。")
         self.serial_manager.error_occurred_signal.connect(self.on_serial_manager_error)
         self.frame_parser.frame_successfully_parsed.connect(self.on_frame_successfully_parsed)
         self.frame_parser.checksum_error.connect(self.on_frame_checksum_error)
@@ -269,6 +274,10 @@ class SerialDebugger(QMainWindow):
         self.start_raw_record_action.setCheckable(True)
         self.start_raw_record_action.triggered.connect(self.toggle_raw_data_recording_action)
         tools_menu.addAction(self.start_raw_record_action)
+        self.start_capture_action = QAction("开始流式录制 (YJCAP)...", self)
+        self.start_capture_action.setCheckable(True)
+        self.start_capture_action.triggered.connect(self.toggle_capture_recording_action)
+        tools_menu.addAction(self.start_capture_action)
         tools_menu.addSeparator()
         show_stats_action = QAction("显示统计信息...", self)
         show_stats_action.triggered.connect(self.show_statistics_action)
@@ -794,6 +803,21 @@ class SerialDebugger(QMainWindow):
                     not self.serial_config_panel_widget.port_combo.count() or self.serial_config_panel_widget.port_combo.currentText() == "无可用端口"): self.status_bar_label.setText(
                 "无可用串口")
 
+    @Slot(int)
+    def on_serial_ring_data_received(self, byte_count: int):
+        """直接接收模式：数据已由读线程写入帧解析器缓冲区，只需触发解析"""
+        self._flash_button("rx")
+        self.update_current_serial_frame_configs_from_ui()
+        try:
+            self.frame_parser.try_parse_frames(
+                current_frame_config=self.current_frame_config,
+                parse_target_func_id_hex=self.current_frame_config.func_id,
+                active_checksum_mode=self.active_checksum_mode
+            )
+        except Exception as e:
+            if self.error_logger:
+                self.error_logger.log_error(f"帧解析过程中发生错误: {e}", "FRAME_PARSE")
+
     @Slot(QByteArray)
     def on_serial_data_received(self, data: QByteArray):
         """串口数据接收处理函数 - 修复版本"""
@@ -1164,6 +1188,26 @@ class SerialDebugger(QMainWindow):
                                         QMessageBox.StandardButton.Yes) == QMessageBox.StandardButton.Yes:
                     self.save_raw_recorded_data_action()
 
+    @Slot(bool)
+    def toggle_capture_recording_action(self, checked: bool):
+        if checked:
+            path, _ = QFileDialog.getSaveFileName(self, "流式录制到文件", "",
+                                                  "YJ录制文件 (*.yjcap);;所有文件 (*)")
+            head_byte = bytes.fromhex(self.current_frame_config.head)[0] if self.current_frame_config.head else 0xAB
+            if not path or not self.data_recorder.start_capture(
+                    path, self.active_checksum_mode, head_byte,
+                    self.frame_parser.config.frame_format.max_data_payload_size):
+                self.start_capture_action.setChecked(False)
+                return
+            self.start_capture_action.setText("停止流式录制")
+            self.status_bar_label.setText(f"流式录制中: {path}")
+        else:
+            summary = self.data_recorder.stop_capture()
+            self.start_capture_action.setText("开始流式录制 (YJCAP)...")
+            if summary:
+                self.status_bar_label.setText(
+                    f"流式录制停止: {summary['records']} 条记录, {summary['bytes']} 字节")
+
     @Slot()
     def show_statistics_action(self):
         stats = self.protocol_analyzer.get_statistics()
@@ -1316,6 +1360,7 @@ class SerialDebugger(QMainWindow):
             "DataProcessor 线程未优雅停止，正在终止。"); self.data_processor.terminate(); self.data_processor.wait()
         if self.serial_manager.is_connected: self.serial_manager.disconnect_port()
         if hasattr(self, 'data_recorder') and self.data_recorder.recording_raw: self.data_recorder.stop_raw_recording()
+        if hasattr(self, 'data_recorder') and self.data_recorder.is_capturing: self.data_recorder.stop_capture()
         config_to_save = self._gather_current_configuration()
         self.config_manager.save_config(config_to_save)
         settings = QSettings("MyCompany", "SerialDebuggerProV2")
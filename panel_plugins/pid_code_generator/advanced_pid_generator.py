@@ -17,23 +17,26 @@ Date: 2024
 
 import copy
 import re
-from datetime import datetime
+import tempfile
 from pathlib import Path
 from typing import Dict, Any, List, Optional, TYPE_CHECKING
 
 if TYPE_CHECKING:
     from main import SerialDebugger
 
-from PySide6.QtCore import Qt, Signal, Slot, QTimer
+from PySide6.QtCore import Qt, Signal, Slot, QTimer, QThread
 from PySide6.QtGui import QFont, QSyntaxHighlighter, QTextCharFormat, QColor
 from PySide6.QtWidgets import (
     QWidget, QVBoxLayout, QHBoxLayout, QGridLayout, QGroupBox,
     QLabel, QLineEdit, QPushButton, QListWidget, QListWidgetItem,
-    QTabWidget, QTextEdit, QComboBox, QDoubleSpinBox, QCheckBox,
-    QSizePolicy, QInputDialog, QMessageBox, QFileDialog, QSplitter
+    QTabWidget, QTextEdit, QComboBox, QDoubleSpinBox, QSpinBox, QCheckBox,
+    QSizePolicy, QInputDialog, QMessageBox, QFileDialog, QSplitter,
+    QTableWidget, QTableWidgetItem, QAbstractItemView
 )
 
 from core.panel_interface import PanelInterface
+from .pid_codegen import PIDDataModel, PIDCodeGenerator
+from . import pid_sweep
 from utils.logger import ErrorLogger
 
 
@@ -90,365 +93,6 @@ class CSyntaxHighlighter(QSyntaxHighlighter):
                 self.setFormat(start, end - start, format_obj)
 
 
-class PIDDataModel:
-    """PID数据模型类，负责管理PID实例和配置数据"""
-    
-    # PID参数键常量
-    P_PID_TYPE = "pid_type"
-    P_WORK_MODE = "work_mode"
-    P_KP = "kp"
-    P_KI = "ki"
-    P_KD = "kd"
-    P_KFF = "kff"
-    P_FF_WEIGHT = "ff_weight"
-    P_SAMPLE_TIME = "sample_time"
-    P_MAX_OUT = "max_output"
-    P_MIN_OUT = "min_output"
-    P_INT_LIM = "integral_limit"
-    P_OUT_RAMP = "output_ramp"
-    P_DEADBAND = "deadband"
-    P_INT_SEP_THRESH = "integral_separation_threshold"
-    P_D_FILTER = "d_filter_coef"
-    P_IN_FILTER = "input_filter_coef"
-    P_SP_FILTER = "setpoint_filter_coef"
-    
-    # 高级功能参数（占位符）
-    P_ADAPTIVE_KP_MIN = "adaptive_kp_min"
-    P_ADAPTIVE_KP_MAX = "adaptive_kp_max"
-    P_ADAPTIVE_KI_MIN = "adaptive_ki_min"
-    P_ADAPTIVE_KI_MAX = "adaptive_ki_max"
-    P_ADAPTIVE_KD_MIN = "adaptive_kd_min"
-    P_ADAPTIVE_KD_MAX = "adaptive_kd_max"
-    P_FUZZY_ERR_RANGE = "fuzzy_error_range"
-    P_FUZZY_DERR_RANGE = "fuzzy_derror_range"
-    
-    # 代码配置键常量
-    C_STRUCT_NAME = "struct_name"
-    C_FUNC_PREFIX = "function_prefix"
-    C_HEADER_NAME = "header_name"
-    C_USE_FLOAT = "use_float"
-    C_INC_COMMENTS = "include_comments"
-    C_DATA_TYPE = "data_type"
-    C_FLOAT_SUFFIX = "float_suffix"
-    
-    def __init__(self):
-        self.pid_instances: List[Dict[str, Any]] = []
-        self.active_instance_index = -1
-        self.code_config = self._get_default_code_config()
-    
-    def _get_default_pid_params(self) -> Dict[str, Any]:
-        """获取默认PID参数"""
-        return {
-            self.P_PID_TYPE: "standard",
-            self.P_WORK_MODE: "position",
-            self.P_KP: 1.0,
-            self.P_KI: 0.1,
-            self.P_KD: 0.01,
-            self.P_KFF: 0.0,
-            self.P_FF_WEIGHT: 1.0,
-            self.P_SAMPLE_TIME: 0.01,
-            self.P_MAX_OUT: 100.0,
-            self.P_MIN_OUT: -100.0,
-            self.P_INT_LIM: 50.0,
-            self.P_OUT_RAMP: 0.0,
-            self.P_DEADBAND: 0.0,
-            self.P_INT_SEP_THRESH: 1000.0,
-            self.P_D_FILTER: 0.0,
-            self.P_IN_FILTER: 0.0,
-            self.P_SP_FILTER: 0.0,
-            # 高级功能占位符
-            self.P_ADAPTIVE_KP_MIN: 0.1,
-            self.P_ADAPTIVE_KP_MAX: 10.0,
-            self.P_ADAPTIVE_KI_MIN: 0.01,
-            self.P_ADAPTIVE_KI_MAX: 1.0,
-            self.P_ADAPTIVE_KD_MIN: 0.001,
-            self.P_ADAPTIVE_KD_MAX: 0.1,
-            self.P_FUZZY_ERR_RANGE: 10.0,
-            self.P_FUZZY_DERR_RANGE: 1.0,
-        }
-    
-    def _get_default_code_config(self) -> Dict[str, Any]:
-        """获取默认代码配置"""
-        return {
-            self.C_STRUCT_NAME: "PID_HandleTypeDef",
-            self.C_FUNC_PREFIX: "PID",
-            self.C_HEADER_NAME: "pid.h",
-            self.C_USE_FLOAT: True,
-            self.C_INC_COMMENTS: True,
-            self.C_DATA_TYPE: "float",
-            self.C_FLOAT_SUFFIX: "f",
-        }
-    
-    def add_instance(self, name: str) -> bool:
-        """添加PID实例"""
-        if any(inst['name'] == name for inst in self.pid_instances):
-            return False
-        
-        new_instance = {
-            'name': name,
-            'params': self._get_default_pid_params()
-        }
-        self.pid_instances.append(new_instance)
-        return True
-    
-    def remove_instance(self, index: int) -> bool:
-        """移除PID实例"""
-        if 0 <= index < len(self.pid_instances):
-            del self.pid_instances[index]
-            if self.active_instance_index >= len(self.pid_instances):
-                self.active_instance_index = len(self.pid_instances) - 1
-            return True
-        return False
-    
-    def rename_instance(self, index: int, new_name: str) -> bool:
-        """重命名PID实例"""
-        if not (0 <= index < len(self.pid_instances)):
-            return False
-        
-        # 检查名称冲突
-        if any(inst['name'] == new_name for i, inst in enumerate(self.pid_instances) if i != index):
-            return False
-        
-        self.pid_instances[index]['name'] = new_name
-        return True
-    
-    def get_active_instance(self) -> Optional[Dict[str, Any]]:
-        """获取当前活动实例"""
-        if 0 <= self.active_instance_index < len(self.pid_instances):
-            return self.pid_instances[self.active_instance_index]
-        return None
-    
-    def update_active_instance_params(self, params: Dict[str, Any]):
-        """更新当前活动实例的参数"""
-        active_instance = self.get_active_instance()
-        if active_instance:
-            active_instance['params'].update(params)
-    
-    def update_code_config(self, config: Dict[str, Any]):
-        """更新代码配置"""
-        self.code_config.update(config)
-        # 更新派生字段
-        self.code_config[self.C_DATA_TYPE] = "float" if self.code_config[self.C_USE_FLOAT] else "double"
-        self.code_config[self.C_FLOAT_SUFFIX] = "f" if self.code_config[self.C_USE_FLOAT] else ""
-
-
-class PIDCodeGenerator:
-    """PID代码生成器类，负责从模板生成代码"""
-    
-    def __init__(self, data_model: PIDDataModel):
-        self.data_model = data_model
-        self.template_dir = Path(__file__).parent / "templates"
-    
-    def generate_header_code(self) -> str:
-        """生成头文件代码"""
-        template_path = self.template_dir / "advanced_pid_template.h"
-        if not template_path.exists():
-            return "// Error: Header template not found."
-        return self._generate_from_template(template_path)
-    
-    def generate_source_code(self) -> str:
-        """生成源文件代码"""
-        template_path = self.template_dir / "advanced_pid_template.c"
-        if not template_path.exists():
-            return "// Error: Source template not found."
-        return self._generate_from_template(template_path)
-    
-    def generate_main_code(self) -> str:
-        """生成主函数示例代码"""
-        template_path = self.template_dir / "user_main_template.c"
-        if not template_path.exists():
-            return "// Error: Main template not found."
-        return self._generate_main_from_template(template_path)
-    
-    def _generate_from_template(self, template_path: Path) -> str:
-        """从模板生成代码（库文件）"""
-        try:
-            template_content = template_path.read_text(encoding='utf-8')
-            
-            # 使用默认参数填充模板
-            default_params = self.data_model._get_default_pid_params()
-            replacements = self._get_template_replacements(default_params)
-            
-            for key, value in replacements.items():
-                template_content = template_content.replace(key, str(value))
-            
-            # 处理注释
-            if not self.data_model.code_config[self.data_model.C_INC_COMMENTS]:
-                template_content = self._remove_comments(template_content)
-            
-            return template_content
-        except Exception as e:
-            return f"// Error generating from template {template_path.name}: {e}"
-    
-    def _generate_main_from_template(self, template_path: Path) -> str:
-        """从模板生成主函数代码"""
-        try:
-            template_content = template_path.read_text(encoding='utf-8')
-            
-            # 全局替换
-            global_replacements = {
-                '{{HEADER_NAME}}': self.data_model.code_config[self.data_model.C_HEADER_NAME],
-                '{{STRUCT_NAME}}': self.data_model.code_config[self.data_model.C_STRUCT_NAME],
-                '{{FUNCTION_PREFIX}}': self.data_model.code_config[self.data_model.C_FUNC_PREFIX],
-                '{{DATA_TYPE}}': self.data_model.code_config[self.data_model.C_DATA_TYPE],
-                '{{TIMESTAMP}}': datetime.now().strftime("%Y-%m-%d %H:%M:%S"),
-                '{{SFX}}': self.data_model.code_config[self.data_model.C_FLOAT_SUFFIX]
-            }
-            
-            for key, value in global_replacements.items():
-                template_content = template_content.replace(key, str(value))
-            
-            # 生成实例相关代码
-            declarations = self._generate_instance_declarations()
-            initializations = self._generate_instance_initializations()
-            computations = self._generate_instance_computations()
-            
-            template_content = template_content.replace('{{PID_INSTANCE_DECLARATIONS}}', declarations)
-            template_content = template_content.replace('{{PID_INSTANCE_INITIALIZATIONS}}', initializations)
-            template_content = template_content.replace('{{PID_EXAMPLE_COMPUTATIONS}}', computations)
-            
-            return template_content
-        except Exception as e:
-            return f"// Error generating main code: {e}"
-    
-    def _get_template_replacements(self, params: Dict[str, Any]) -> Dict[str, str]:
-        """获取模板替换字典"""
-        config = self.data_model.code_config
-        sfx = config[self.data_model.C_FLOAT_SUFFIX]
-        
-        return {
-            '{{STRUCT_NAME}}': config[self.data_model.C_STRUCT_NAME],
-            '{{FUNCTION_PREFIX}}': config[self.data_model.C_FUNC_PREFIX],
-            '{{DATA_TYPE}}': config[self.data_model.C_DATA_TYPE],
-            '{{HEADER_NAME}}': config[self.data_model.C_HEADER_NAME],
-            '{{TIMESTAMP}}': datetime.now().strftime("%Y-%m-%d %H:%M:%S"),
-            '{{SFX}}': sfx,
-            '{{KFF_DEFAULT}}': f"{params[self.data_model.P_KFF]}{sfx}",
-            '{{FF_WEIGHT_DEFAULT}}': f"{params[self.data_model.P_FF_WEIGHT]}{sfx}",
-            '{{OUTPUT_LIMIT_DEFAULT}}': f"{params[self.data_model.P_MAX_OUT]}{sfx}",
-            '{{INTEGRAL_LIMIT_DEFAULT}}': f"{params[self.data_model.P_INT_LIM]}{sfx}",
-            '{{OUTPUT_RAMP_DEFAULT}}': f"{params[self.data_model.P_OUT_RAMP]}{sfx}",
-            '{{DEADBAND_DEFAULT}}': f"{params[self.data_model.P_DEADBAND]}{sfx}",
-            '{{INTEGRAL_SEPARATION_THRESHOLD_DEFAULT}}': f"{params[self.data_model.P_INT_SEP_THRESH]}{sfx}",
-            '{{D_FILTER_COEF_DEFAULT}}': f"{params[self.data_model.P_D_FILTER]}{sfx}",
-            '{{INPUT_FILTER_COEF_DEFAULT}}': f"{params[self.data_model.P_IN_FILTER]}{sfx}",
-            '{{SETPOINT_FILTER_COEF_DEFAULT}}': f"{params[self.data_model.P_SP_FILTER]}{sfx}",
-            '{{ADAPTIVE_ENABLE}}': 'false',
-            '{{FUZZY_ENABLE}}': 'false',
-            '{{ADAPTIVE_KP_MIN_DEFAULT}}': f"{params[self.data_model.P_ADAPTIVE_KP_MIN]}{sfx}",
-            '{{ADAPTIVE_KP_MAX_DEFAULT}}': f"{params[self.data_model.P_ADAPTIVE_KP_MAX]}{sfx}",
-            '{{ADAPTIVE_KI_MIN_DEFAULT}}': f"{params[self.data_model.P_ADAPTIVE_KI_MIN]}{sfx}",
-            '{{ADAPTIVE_KI_MAX_DEFAULT}}': f"{params[self.data_model.P_ADAPTIVE_KI_MAX]}{sfx}",
-            '{{ADAPTIVE_KD_MIN_DEFAULT}}': f"{params[self.data_model.P_ADAPTIVE_KD_MIN]}{sfx}",
-            '{{ADAPTIVE_KD_MAX_DEFAULT}}': f"{params[self.data_model.P_ADAPTIVE_KD_MAX]}{sfx}",
-            '{{FUZZY_ERROR_RANGE_DEFAULT}}': f"{params[self.data_model.P_FUZZY_ERR_RANGE]}{sfx}",
-            '{{FUZZY_DERROR_RANGE_DEFAULT}}': f"{params[self.data_model.P_FUZZY_DERR_RANGE]}{sfx}",
-        }
-    
-    def _generate_instance_declarations(self) -> str:
-        """生成实例声明代码"""
-        if not self.data_model.pid_instances:
-            return "    // 未配置任何PID实例"
-        
-        struct_name = self.data_model.code_config[self.data_model.C_STRUCT_NAME]
-        declarations = []
-        for instance in self.data_model.pid_instances:
-            declarations.append(f"    {struct_name} {instance['name']};")
-        return "\n".join(declarations)
-    
-    def _generate_instance_initializations(self) -> str:
-        """生成实例初始化代码"""
-        if not self.data_model.pid_instances:
-            return "    // 未配置任何PID实例，无初始化代码生成。"
-        
-        init_lines = []
-        for instance in self.data_model.pid_instances:
-            init_lines.extend(self._get_instance_init_code(instance))
-        return "\n".join(init_lines)
-    
-    def _generate_instance_computations(self) -> str:
-        """生成实例计算示例代码"""
-        if not self.data_model.pid_instances:
-            return "    // 未配置任何PID实例，无示例代码生成。"
-        
-        comp_lines = []
-        for instance in self.data_model.pid_instances:
-            comp_lines.extend(self._get_instance_sim_code(instance))
-        return "\n".join(comp_lines)
-    
-    def _get_instance_init_code(self, instance: Dict[str, Any]) -> List[str]:
-        """为单个实例生成初始化代码"""
-        name = instance['name']
-        params = instance['params']
-        config = self.data_model.code_config
-        sfx = config[self.data_model.C_FLOAT_SUFFIX]
-        prefix = config[self.data_model.C_FUNC_PREFIX]
-        sample_time = max(params[self.data_model.P_SAMPLE_TIME], 1e-6)
-        
-        lines = [f"    // 初始化PID实例: {name}"]
-        lines.append(f"    {prefix}_Init(&{name}, {params[self.data_model.P_KP]}{sfx}, {params[self.data_model.P_KI]}{sfx}, {params[self.data_model.P_KD]}{sfx}, {sample_time}{sfx});")
-        lines.append(f"    {prefix}_SetOutputLimits(&{name}, {params[self.data_model.P_MAX_OUT]}{sfx});")
-        lines.append(f"    {prefix}_SetIntegralLimits(&{name}, {params[self.data_model.P_INT_LIM]}{sfx});")
-        
-        # 可选参数设置
-        if params[self.data_model.P_OUT_RAMP] > 0:
-            lines.append(f"    {prefix}_SetOutputRamp(&{name}, {params[self.data_model.P_OUT_RAMP]}{sfx});")
-        if params[self.data_model.P_DEADBAND] > 0:
-            lines.append(f"    {prefix}_SetDeadband(&{name}, {params[self.data_model.P_DEADBAND]}{sfx});")
-        if params[self.data_model.P_INT_SEP_THRESH] < 1000.0:
-            lines.append(f"    {prefix}_SetIntegralSeparationThreshold(&{name}, {params[self.data_model.P_INT_SEP_THRESH]}{sfx});")
-        if params[self.data_model.P_D_FILTER] > 0:
-            lines.append(f"    {prefix}_SetDFilter(&{name}, {params[self.data_model.P_D_FILTER]}{sfx});")
-        if params[self.data_model.P_IN_FILTER] > 0:
-            lines.append(f"    {prefix}_SetInputFilter(&{name}, {params[self.data_model.P_IN_FILTER]}{sfx});")
-        if params[self.data_model.P_SP_FILTER] > 0:
-            lines.append(f"    {prefix}_SetSetpointFilter(&{name}, {params[self.data_model.P_SP_FILTER]}{sfx});")
-        if params[self.data_model.P_KFF] != 0 or params[self.data_model.P_FF_WEIGHT] != 1.0:
-            lines.append(f"    {prefix}_SetFeedForwardParams(&{name}, {params[self.data_model.P_KFF]}{sfx}, {params[self.data_model.P_FF_WEIGHT]}{sfx});")
-        
-        # PID类型和工作模式
-        pid_type_map = {"standard": "PID_TYPE_STANDARD", "pi_d": "PID_TYPE_PI_D", "i_pd": "PID_TYPE_I_PD"}
-        work_mode_map = {"position": "PID_MODE_POSITION", "velocity": "PID_MODE_VELOCITY"}
-        lines.append(f"    {prefix}_SetType(&{name}, {pid_type_map[params[self.data_model.P_PID_TYPE]]});")
-        lines.append(f"    {prefix}_SetWorkMode(&{name}, {work_mode_map[params[self.data_model.P_WORK_MODE]]});")
-        
-        lines.append(f"    printf(\"Initialized PID: {name} (Kp=%.4f, Ki_cont=%.4f, Kd_cont=%.4f, Ts=%.4f)\\n\", (double){params[self.data_model.P_KP]}{sfx}, (double){params[self.data_model.P_KI]}{sfx}, (double){params[self.data_model.P_KD]}{sfx}, (double){sample_time}{sfx});")
-        lines.append("")
-        return lines
-    
-    def _get_instance_sim_code(self, instance: Dict[str, Any]) -> List[str]:
-        """为单个实例生成仿真代码"""
-        name = instance['name']
-        params = instance['params']
-        config = self.data_model.code_config
-        sfx = config[self.data_model.C_FLOAT_SUFFIX]
-        prefix = config[self.data_model.C_FUNC_PREFIX]
-        data_type = config[self.data_model.C_DATA_TYPE]
-        sample_time = max(params[self.data_model.P_SAMPLE_TIME], 1e-6)
-        
-        return [
-            f"    // 示例计算 for {name}",
-            f"    {data_type} {name}_setpoint = 50.0{sfx};",
-            f"    {data_type} {name}_measurement = 0.0{sfx};",
-            f"    printf(\"\\n--- Running simulation for {name} ---\\n\");",
-            "    for (int j = 0; j < 5; ++j) {",
-            f"        {data_type} {name}_output = {prefix}_Compute(&{name}, {name}_setpoint, {name}_measurement);",
-            f"        {name}_measurement = simulate_system_response({name}_measurement, {name}_output, {sample_time}{sfx});",
-            f"        printf(\"  {name}: Step %d, SP=%.2f, PV=%.2f, Out=%.2f\\n\", j+1, (double){name}_setpoint, (double){name}_measurement, (double){name}_output);",
-            "    }", ""
-        ]
-    
-    def _remove_comments(self, content: str) -> str:
-        """移除代码中的注释"""
-        # 移除多行注释
-        content = re.sub(r'/\*.*?\*/', '', content, flags=re.DOTALL)
-        # 移除单行注释
-        content = re.sub(r'//[^\n]*', '', content)
-        # 清理多余的空行
-        content = re.sub(r'\n\s*\n', '\n\n', content)
-        return content
-
-
 class PIDParameterWidget(QWidget):
     """PID参数配置组件"""
     
@@ -476,6 +120,10 @@ class PIDParameterWidget(QWidget):
         advanced_group = self._create_advanced_control_group()
         layout.addWidget(advanced_group)
         
+        # 增益调度组
+        schedule_group = self._create_schedule_group()
+        layout.addWidget(schedule_group)
+        
         layout.addStretch()
     
     def _create_basic_params_group(self) -> QGroupBox:
@@ -613,8 +261,76 @@ class PIDParameterWidget(QWidget):
         self.setpoint_filter_spinbox.setValue(0.0)
         layout.addWidget(self.setpoint_filter_spinbox, 3, 1)
         
+        # 串级: 本实例输出作为内环实例的设定值
+        layout.addWidget(QLabel("串级内环实例:"), 3, 2)
+        self.cascade_inner_edit = QLineEdit()
+        self.cascade_inner_edit.setPlaceholderText("无")
+        self.cascade_inner_edit.setToolTip("填写内环实例名; 内环采样时间须为本实例的整数分之一, 生成串级控制器文件")
+        layout.addWidget(self.cascade_inner_edit, 3, 3)
+        
+        return group
+    
+    def _create_schedule_group(self) -> QGroupBox:
+        """创建增益调度组"""
+        group = QGroupBox("增益调度 (连续域增益, 按调度变量线性插值)")
+        layout = QVBoxLayout(group)
+        
+        self.schedule_table = QTableWidget(0, 4)
+        self.schedule_table.setHorizontalHeaderLabels(["调度变量 x", "Kp", "Ki", "Kd"])
+        self.schedule_table.setSelectionBehavior(QAbstractItemView.SelectRows)
+        self.schedule_table.setToolTip("至少2个断点, 调度变量不能重复; 留空表示不使用增益调度")
+        self.schedule_table.setMaximumHeight(160)
+        layout.addWidget(self.schedule_table)
+        
+        button_layout = QHBoxLayout()
+        self.schedule_add_button = QPushButton("添加断点")
+        self.schedule_remove_button = QPushButton("删除断点")
+        button_layout.addWidget(self.schedule_add_button)
+        button_layout.addWidget(self.schedule_remove_button)
+        button_layout.addStretch()
+        layout.addLayout(button_layout)
+        
         return group
     
+    def _set_schedule_rows(self, rows: List[List[float]]):
+        """填充增益调度表"""
+        self.schedule_table.blockSignals(True)
+        self.schedule_table.setRowCount(0)
+        for row in rows:
+            index = self.schedule_table.rowCount()
+            self.schedule_table.insertRow(index)
+            for column, value in enumerate(row[:4]):
+                self.schedule_table.setItem(index, column, QTableWidgetItem(f"{float(value):g}"))
+        self.schedule_table.blockSignals(False)
+    
+    def _collect_schedule_rows(self) -> List[List[float]]:
+        """读取增益调度表, 跳过未填完或无法解析的行"""
+        rows = []
+        for index in range(self.schedule_table.rowCount()):
+            try:
+                rows.append([float(self.schedule_table.item(index, column).text()) for column in range(4)])
+            except (AttributeError, ValueError):
+                continue
+        return rows
+    
+    @Slot()
+    def _on_add_schedule_row(self):
+        """添加断点, 默认沿用当前增益"""
+        rows = self._collect_schedule_rows()
+        x = rows[-1][0] + 1.0 if rows else 0.0
+        rows.append([x, self.kp_spinbox.value(), self.ki_spinbox.value(), self.kd_spinbox.value()])
+        self._set_schedule_rows(rows)
+        self._on_params_changed()
+    
+    @Slot()
+    def _on_remove_schedule_row(self):
+        """删除选中的断点"""
+        selected = sorted({index.row() for index in self.schedule_table.selectedIndexes()}, reverse=True)
+        for row in selected:
+            self.schedule_table.removeRow(row)
+        if selected:
+            self._on_params_changed()
+    
     def _connect_signals(self):
         """连接信号"""
         # 连接所有控件的信号到参数变化处理函数
@@ -632,6 +348,10 @@ class PIDParameterWidget(QWidget):
                 control.currentTextChanged.connect(self._on_params_changed)
             elif isinstance(control, QDoubleSpinBox):
                 control.valueChanged.connect(self._on_params_changed)
+        self.cascade_inner_edit.textChanged.connect(self._on_params_changed)
+        self.schedule_table.itemChanged.connect(self._on_params_changed)
+        self.schedule_add_button.clicked.connect(self._on_add_schedule_row)
+        self.schedule_remove_button.clicked.connect(self._on_remove_schedule_row)
     
     @Slot()
     def _on_params_changed(self):
@@ -670,6 +390,8 @@ class PIDParameterWidget(QWidget):
             self.data_model.P_D_FILTER: self.d_filter_spinbox.value(),
             self.data_model.P_IN_FILTER: self.input_filter_spinbox.value(),
             self.data_model.P_SP_FILTER: self.setpoint_filter_spinbox.value(),
+            self.data_model.P_CASCADE_INNER: self.cascade_inner_edit.text().strip(),
+            self.data_model.P_SCHEDULE: self._collect_schedule_rows(),
         }
     
     def load_params(self, params: Dict[str, Any]):
@@ -708,6 +430,8 @@ class PIDParameterWidget(QWidget):
         self.d_filter_spinbox.setValue(params.get(self.data_model.P_D_FILTER, 0.0))
         self.input_filter_spinbox.setValue(params.get(self.data_model.P_IN_FILTER, 0.0))
         self.setpoint_filter_spinbox.setValue(params.get(self.data_model.P_SP_FILTER, 0.0))
+        self.cascade_inner_edit.setText(params.get(self.data_model.P_CASCADE_INNER, ""))
+        self._set_schedule_rows(params.get(self.data_model.P_SCHEDULE, []))
         
         self.blockSignals(False)
 
@@ -754,6 +478,50 @@ class CodeConfigWidget(QWidget):
         self.include_comments_checkbox.setChecked(True)
         grid_layout.addWidget(self.include_comments_checkbox, 1, 3)
         
+        # 控制器组(数组结构体批量计算)
+        self.gen_bank_checkbox = QCheckBox("生成控制器组 (批量向量化计算)")
+        grid_layout.addWidget(self.gen_bank_checkbox, 2, 0, 1, 2)
+        grid_layout.addWidget(QLabel("最大通道数:"), 2, 2)
+        self.bank_capacity_spin = QSpinBox()
+        self.bank_capacity_spin.setRange(1, 256)
+        self.bank_capacity_spin.setValue(24)
+        grid_layout.addWidget(self.bank_capacity_spin, 2, 3)
+        
+        # 定点版本(无FPU内核)
+        grid_layout.addWidget(QLabel("定点版本:"), 3, 0)
+        self.fixed_format_combo = QComboBox()
+        self.fixed_format_combo.addItem("不生成", "")
+        self.fixed_format_combo.addItem("Q15 (int16_t)", "q15")
+        self.fixed_format_combo.addItem("Q31 (int32_t)", "q31")
+        grid_layout.addWidget(self.fixed_format_combo, 3, 1)
+        grid_layout.addWidget(QLabel("满量程:"), 3, 2)
+        self.fixed_full_scale_spin = QDoubleSpinBox()
+        self.fixed_full_scale_spin.setRange(0.001, 1e6)
+        self.fixed_full_scale_spin.setDecimals(3)
+        self.fixed_full_scale_spin.setValue(200.0)
+        self.fixed_full_scale_spin.setToolTip("Q格式数值1.0对应的物理量, 设定值/测量值/输出均按此换算")
+        grid_layout.addWidget(self.fixed_full_scale_spin, 3, 3)
+        
+        # 按实例配置特化的计算函数
+        self.gen_specialized_checkbox = QCheckBox("生成实例专用计算函数 (未启用的功能不生成)")
+        self.gen_specialized_checkbox.setToolTip("为每个实例生成 <前缀>_Compute_<实例名>, PID类型和工作方式固定, 省去逐次的功能判断")
+        grid_layout.addWidget(self.gen_specialized_checkbox, 4, 0, 1, 4)
+        
+        # 冷热分离布局
+        self.gen_split_checkbox = QCheckBox("生成冷热分离布局 (只读配置放Flash, 运行状态单缓存行)")
+        self.gen_split_checkbox.setToolTip("配置与运行状态分开存放, 调试分量由 <前缀>_SPLIT_DEBUG_TERMS 编译选项控制")
+        grid_layout.addWidget(self.gen_split_checkbox, 5, 0, 1, 4)
+        
+        # 继电器自整定
+        self.gen_autotune_checkbox = QCheckBox("生成继电器自整定模块 (设备上估计Ku/Pu, 进度经YJ协议发送)")
+        self.gen_autotune_checkbox.setToolTip(f"进度帧功能码 0x{PIDCodeGenerator.AUTOTUNE_FUNC_ID:02X}, 需与 protocol/yj_protocol.c 一起编译")
+        grid_layout.addWidget(self.gen_autotune_checkbox, 6, 0, 1, 4)
+        
+        # 高速遥测
+        self.gen_telemetry_checkbox = QCheckBox("生成高速遥测模块 (中断采样入环形缓冲, 批量经YJ协议发送)")
+        self.gen_telemetry_checkbox.setToolTip(f"遥测帧功能码 0x{PIDCodeGenerator.TELEMETRY_FUNC_ID:02X}, 解析面板用\"重复记录\"模式、帧头12字节即可绘图")
+        grid_layout.addWidget(self.gen_telemetry_checkbox, 7, 0, 1, 4)
+        
         layout.addWidget(group)
         layout.addStretch()
     
@@ -764,6 +532,14 @@ class CodeConfigWidget(QWidget):
         self.header_name_edit.textChanged.connect(self._on_config_changed)
         self.use_float_checkbox.toggled.connect(self._on_config_changed)
         self.include_comments_checkbox.toggled.connect(self._on_config_changed)
+        self.gen_bank_checkbox.toggled.connect(self._on_config_changed)
+        self.bank_capacity_spin.valueChanged.connect(self._on_config_changed)
+        self.fixed_format_combo.currentIndexChanged.connect(self._on_config_changed)
+        self.fixed_full_scale_spin.valueChanged.connect(self._on_config_changed)
+        self.gen_specialized_checkbox.toggled.connect(self._on_config_changed)
+        self.gen_split_checkbox.toggled.connect(self._on_config_changed)
+        self.gen_autotune_checkbox.toggled.connect(self._on_config_changed)
+        self.gen_telemetry_checkbox.toggled.connect(self._on_config_changed)
     
     @Slot()
     def _on_config_changed(self):
@@ -779,6 +555,14 @@ class CodeConfigWidget(QWidget):
             self.data_model.C_HEADER_NAME: self.header_name_edit.text().strip() or "pid.h",
             self.data_model.C_USE_FLOAT: self.use_float_checkbox.isChecked(),
             self.data_model.C_INC_COMMENTS: self.include_comments_checkbox.isChecked(),
+            self.data_model.C_GEN_BANK: self.gen_bank_checkbox.isChecked(),
+            self.data_model.C_BANK_CAPACITY: self.bank_capacity_spin.value(),
+            self.data_model.C_FIXED_FORMAT: self.fixed_format_combo.currentData() or "",
+            self.data_model.C_FIXED_FULL_SCALE: self.fixed_full_scale_spin.value(),
+            self.data_model.C_GEN_SPECIALIZED: self.gen_specialized_checkbox.isChecked(),
+            self.data_model.C_GEN_SPLIT: self.gen_split_checkbox.isChecked(),
+            self.data_model.C_GEN_AUTOTUNE: self.gen_autotune_checkbox.isChecked(),
+            self.data_model.C_GEN_TELEMETRY: self.gen_telemetry_checkbox.isChecked(),
         }
     
     def load_config(self, config: Dict[str, Any]):
@@ -790,6 +574,15 @@ class CodeConfigWidget(QWidget):
         self.header_name_edit.setText(config.get(self.data_model.C_HEADER_NAME, "pid.h"))
         self.use_float_checkbox.setChecked(config.get(self.data_model.C_USE_FLOAT, True))
         self.include_comments_checkbox.setChecked(config.get(self.data_model.C_INC_COMMENTS, True))
+        self.gen_bank_checkbox.setChecked(config.get(self.data_model.C_GEN_BANK, False))
+        self.bank_capacity_spin.setValue(config.get(self.data_model.C_BANK_CAPACITY, 24))
+        fixed_index = self.fixed_format_combo.findData(config.get(self.data_model.C_FIXED_FORMAT, ""))
+        self.fixed_format_combo.setCurrentIndex(max(fixed_index, 0))
+        self.fixed_full_scale_spin.setValue(config.get(self.data_model.C_FIXED_FULL_SCALE, 200.0))
+        self.gen_specialized_checkbox.setChecked(config.get(self.data_model.C_GEN_SPECIALIZED, False))
+        self.gen_split_checkbox.setChecked(config.get(self.data_model.C_GEN_SPLIT, False))
+        self.gen_autotune_checkbox.setChecked(config.get(self.data_model.C_GEN_AUTOTUNE, False))
+        self.gen_telemetry_checkbox.setChecked(config.get(self.data_model.C_GEN_TELEMETRY, False))
         
         self.blockSignals(False)
 
@@ -832,12 +625,13 @@ class CodePreviewWidget(QWidget):
         
         layout.addWidget(self.code_preview)
         
-        # 存储生成的代码
+        # 存储生成的代码, 3及以后为启用的附加模块文件
         self.generated_codes = {
             0: "",  # C源文件
             1: "",  # 头文件
             2: ""   # 主函数
         }
+        self.labels = ["C 源文件 (库)", "头文件 (库)", "示例 Main (.c)"]
     
     @Slot()
     def _on_file_selected(self):
@@ -847,22 +641,234 @@ class CodePreviewWidget(QWidget):
     def update_preview(self):
         """更新预览内容"""
         selected_index = self.file_selector.currentIndex()
+        if selected_index < 0:
+            return
         content = self.generated_codes.get(selected_index, "")
         
-        labels = ["C 源文件 (库)", "头文件 (库)", "示例 Main (.c)"]
-        label_text = f"当前预览: {labels[selected_index]}"
+        label_text = f"当前预览: {self.labels[selected_index]}"
         
         self.code_preview.setPlainText(content)
         self.preview_label.setText(label_text)
     
-    def set_generated_codes(self, source_code: str, header_code: str, main_code: str):
-        """设置生成的代码"""
-        self.generated_codes[0] = source_code
-        self.generated_codes[1] = header_code
-        self.generated_codes[2] = main_code
+    def set_generated_codes(self, source_code: str, header_code: str, main_code: str,
+                            extra_codes: Optional[Dict[str, str]] = None):
+        """设置生成的代码, extra_codes为附加模块的 文件名 -> 代码"""
+        extra_codes = extra_codes or {}
+        self.generated_codes = {0: source_code, 1: header_code, 2: main_code}
+        labels = ["C 源文件 (库)", "头文件 (库)", "示例 Main (.c)"] + list(extra_codes.keys())
+        for index, code in enumerate(extra_codes.values(), start=3):
+            self.generated_codes[index] = code
+        
+        if labels != self.labels:
+            current = self.file_selector.currentIndex()
+            self.labels = labels
+            self.file_selector.blockSignals(True)
+            self.file_selector.clear()
+            self.file_selector.addItems(labels)
+            self.file_selector.setCurrentIndex(current if 0 <= current < len(labels) else 0)
+            self.file_selector.blockSignals(False)
         self.update_preview()
 
 
+class SweepWorker(QThread):
+    """增益扫描工作线程: 生成并编译仿真程序后运行"""
+    finished = Signal(bool, str, dict)  # success, message, result
+
+    def __init__(self, data_model: PIDDataModel, instance_name: str, spec: 'pid_sweep.SweepSpec',
+                 build_dir: Path):
+        super().__init__()
+        # 复制一份数据模型, 扫描期间面板中的修改不影响本次仿真
+        self.data_model = PIDDataModel()
+        self.data_model.pid_instances = copy.deepcopy(data_model.pid_instances)
+        self.data_model.code_config = dict(data_model.code_config)
+        self.instance_name = instance_name
+        self.spec = spec
+        self.build_dir = build_dir
+
+    def run(self):
+        try:
+            exe = pid_sweep.build_sweep_tool(self.data_model, self.build_dir, self.instance_name)
+            result = pid_sweep.run_sweep(exe, self.spec)
+            self.finished.emit(True, f"完成: {result['candidates']} 组候选, {result['threads']} 线程, "
+                                     f"耗时 {result['elapsed_s']:.3f} s", result)
+        except (RuntimeError, ValueError, OSError) as e:
+            self.finished.emit(False, str(e), {})
+
+
+class GainSweepWidget(QWidget):
+    """增益扫描组件: 对当前实例的Kp/Ki/Kd网格做闭环仿真, 结果可写回实例参数"""
+
+    apply_requested = Signal(dict)
+
+    COLUMNS = ["Kp", "Ki", "Kd", "IAE", "ITAE", "超调%", "终值误差"]
+
+    def __init__(self, data_model: PIDDataModel, parent=None):
+        super().__init__(parent)
+        self.data_model = data_model
+        self.worker: Optional[SweepWorker] = None
+        self.results: List[Dict[str, Any]] = []
+        self._build_dir = tempfile.TemporaryDirectory(prefix="yj_pid_sweep_")
+        self._setup_ui()
+
+    def _double_spin(self, value: float, maximum: float, decimals: int = 4) -> QDoubleSpinBox:
+        spin = QDoubleSpinBox()
+        spin.setRange(0.0, maximum)
+        spin.setDecimals(decimals)
+        spin.setValue(value)
+        return spin
+
+    def _setup_ui(self):
+        """设置UI"""
+        layout = QVBoxLayout(self)
+
+        # 被控对象
+        plant_group = QGroupBox("被控对象")
+        plant_layout = QGridLayout(plant_group)
+        plant_layout.addWidget(QLabel("模型:"), 0, 0)
+        self.plant_combo = QComboBox()
+        self.plant_combo.addItem("一阶惯性+滞后 (FOPDT)", "fopdt")
+        self.plant_combo.addItem("二阶", "second-order")
+        plant_layout.addWidget(self.plant_combo, 0, 1)
+        plant_layout.addWidget(QLabel("增益K:"), 0, 2)
+        self.gain_spin = self._double_spin(1.0, 1e6)
+        plant_layout.addWidget(self.gain_spin, 0, 3)
+        plant_layout.addWidget(QLabel("时间常数(s):"), 1, 0)
+        self.tau_spin = self._double_spin(0.5, 1e4)
+        plant_layout.addWidget(self.tau_spin, 1, 1)
+        plant_layout.addWidget(QLabel("纯滞后(s):"), 1, 2)
+        self.dead_time_spin = self._double_spin(0.0, 100.0)
+        plant_layout.addWidget(self.dead_time_spin, 1, 3)
+        plant_layout.addWidget(QLabel("自然频率(rad/s):"), 2, 0)
+        self.wn_spin = self._double_spin(10.0, 1e5)
+        plant_layout.addWidget(self.wn_spin, 2, 1)
+        plant_layout.addWidget(QLabel("阻尼比:"), 2, 2)
+        self.zeta_spin = self._double_spin(0.7, 100.0)
+        plant_layout.addWidget(self.zeta_spin, 2, 3)
+        plant_layout.addWidget(QLabel("执行器饱和:"), 3, 0)
+        self.u_limit_spin = self._double_spin(0.0, 1e6)
+        self.u_limit_spin.setToolTip("对象输入的绝对值上限, 0表示不限制")
+        plant_layout.addWidget(self.u_limit_spin, 3, 1)
+        layout.addWidget(plant_group)
+
+        # 增益网格(连续域)
+        grid_group = QGroupBox("增益网格 (连续域: 最小 / 最大 / 点数)")
+        grid_layout = QGridLayout(grid_group)
+        self.axis_spins = {}
+        for row, (name, hi, n) in enumerate((("Kp", 5.0, 20), ("Ki", 5.0, 20), ("Kd", 0.1, 5))):
+            grid_layout.addWidget(QLabel(f"{name}:"), row, 0)
+            lo_spin, hi_spin = self._double_spin(0.0, 1e6), self._double_spin(hi, 1e6)
+            n_spin = QSpinBox()
+            n_spin.setRange(1, 1000)
+            n_spin.setValue(n)
+            grid_layout.addWidget(lo_spin, row, 1)
+            grid_layout.addWidget(hi_spin, row, 2)
+            grid_layout.addWidget(n_spin, row, 3)
+            self.axis_spins[name] = (lo_spin, hi_spin, n_spin)
+        layout.addWidget(grid_group)
+
+        # 仿真与排序
+        sim_group = QGroupBox("阶跃仿真与排序")
+        sim_layout = QGridLayout(sim_group)
+        sim_layout.addWidget(QLabel("设定值:"), 0, 0)
+        self.setpoint_spin = self._double_spin(1.0, 1e6)
+        sim_layout.addWidget(self.setpoint_spin, 0, 1)
+        sim_layout.addWidget(QLabel("时长(s):"), 0, 2)
+        self.duration_spin = self._double_spin(5.0, 1e4)
+        sim_layout.addWidget(self.duration_spin, 0, 3)
+        sim_layout.addWidget(QLabel("排序指标:"), 1, 0)
+        self.objective_combo = QComboBox()
+        self.objective_combo.addItem("ITAE", "itae")
+        self.objective_combo.addItem("IAE", "iae")
+        self.objective_combo.addItem("超调量", "overshoot")
+        sim_layout.addWidget(self.objective_combo, 1, 1)
+        sim_layout.addWidget(QLabel("超调上限(%):"), 1, 2)
+        self.max_overshoot_spin = self._double_spin(0.0, 1000.0, 2)
+        self.max_overshoot_spin.setToolTip("超过上限的候选排在后面, 0表示不限制")
+        sim_layout.addWidget(self.max_overshoot_spin, 1, 3)
+        layout.addWidget(sim_group)
+
+        # 运行与结果
+        run_layout = QHBoxLayout()
+        self.run_button = QPushButton("开始扫描")
+        self.apply_button = QPushButton("应用到当前实例")
+        self.apply_button.setEnabled(False)
+        self.sweep_status_label = QLabel("使用当前实例的配置(采样时间、限幅、滤波等), 只替换增益。")
+        run_layout.addWidget(self.run_button)
+        run_layout.addWidget(self.apply_button)
+        run_layout.addWidget(self.sweep_status_label, 1)
+        layout.addLayout(run_layout)
+
+        self.result_table = QTableWidget(0, len(self.COLUMNS))
+        self.result_table.setHorizontalHeaderLabels(self.COLUMNS)
+        self.result_table.setSelectionBehavior(QAbstractItemView.SelectRows)
+        self.result_table.setSelectionMode(QAbstractItemView.SingleSelection)
+        self.result_table.setEditTriggers(QAbstractItemView.NoEditTriggers)
+        layout.addWidget(self.result_table)
+
+        self.run_button.clicked.connect(self._on_run)
+        self.apply_button.clicked.connect(self._on_apply)
+        self.result_table.itemDoubleClicked.connect(lambda _item: self._on_apply())
+
+    def _collect_spec(self) -> 'pid_sweep.SweepSpec':
+        """收集扫描设置"""
+        axes = {name: (lo.value(), hi.value(), n.value()) for name, (lo, hi, n) in self.axis_spins.items()}
+        max_overshoot = self.max_overshoot_spin.value()
+        return pid_sweep.SweepSpec(
+            kp=axes["Kp"], ki=axes["Ki"], kd=axes["Kd"],
+            plant=self.plant_combo.currentData(), gain=self.gain_spin.value(), tau=self.tau_spin.value(),
+            wn=self.wn_spin.value(), zeta=self.zeta_spin.value(), dead_time=self.dead_time_spin.value(),
+            u_limit=self.u_limit_spin.value(), setpoint=self.setpoint_spin.value(),
+            duration=self.duration_spin.value(), objective=self.objective_combo.currentData(),
+            max_overshoot=max_overshoot if max_overshoot > 0 else None, top=50)
+
+    @Slot()
+    def _on_run(self):
+        """开始扫描"""
+        instance = self.data_model.get_active_instance()
+        if not instance:
+            QMessageBox.information(self, "增益扫描", "请先选择一个PID实例。")
+            return
+        spec = self._collect_spec()
+        try:
+            spec.validate()
+        except ValueError as e:
+            QMessageBox.warning(self, "增益扫描", str(e))
+            return
+        self.run_button.setEnabled(False)
+        self.sweep_status_label.setText(f"正在编译并仿真 {spec.candidates} 组候选 ({instance['name']})...")
+        self.worker = SweepWorker(self.data_model, instance['name'], spec, Path(self._build_dir.name))
+        self.worker.finished.connect(self._on_sweep_finished)
+        self.worker.start()
+
+    @Slot(bool, str, dict)
+    def _on_sweep_finished(self, success: bool, message: str, result: Dict[str, Any]):
+        """扫描完成"""
+        self.run_button.setEnabled(True)
+        self.sweep_status_label.setText(message)
+        if not success:
+            QMessageBox.warning(self, "增益扫描失败", message)
+            return
+        self.results = result.get("results", [])
+        self.result_table.setRowCount(len(self.results))
+        keys = ["kp", "ki", "kd", "iae", "itae", "overshoot", "final_error"]
+        for row, item in enumerate(self.results):
+            for col, key in enumerate(keys):
+                cell = QTableWidgetItem(f"{item[key]:.6g}")
+                if not item.get("feasible", True):
+                    cell.setForeground(QColor("#999999"))
+                self.result_table.setItem(row, col, cell)
+        if self.results:
+            self.result_table.selectRow(0)
+        self.apply_button.setEnabled(bool(self.results))
+
+    @Slot()
+    def _on_apply(self):
+        """把选中的一组增益写回当前实例"""
+        row = self.result_table.currentRow()
+        if 0 <= row < len(self.results):
+            self.apply_requested.emit(self.results[row])
+
+
 class AdvancedPIDGeneratorWidget(PanelInterface):
     """高级PID代码生成器主组件 - 重构版本"""
     
@@ -978,6 +984,10 @@ class AdvancedPIDGeneratorWidget(PanelInterface):
         self.preview_widget = CodePreviewWidget()
         self.tab_widget.addTab(self.preview_widget, "代码预览")
         
+        # 增益扫描选项卡
+        self.sweep_widget = GainSweepWidget(self.data_model)
+        self.tab_widget.addTab(self.sweep_widget, "增益扫描")
+        
         layout.addWidget(self.tab_widget)
         
         # 操作按钮
@@ -1008,6 +1018,7 @@ class AdvancedPIDGeneratorWidget(PanelInterface):
         # 参数和配置变化信号
         self.param_widget.params_changed.connect(self._on_params_changed)
         self.config_widget.config_changed.connect(self._on_config_changed)
+        self.sweep_widget.apply_requested.connect(self._on_sweep_apply)
         
         # 选项卡变化信号
         self.tab_widget.currentChanged.connect(self._on_tab_changed)
@@ -1116,6 +1127,17 @@ class AdvancedPIDGeneratorWidget(PanelInterface):
         self.data_model.update_code_config(config)
         self._trigger_code_generation()
     
+    @Slot(dict)
+    def _on_sweep_apply(self, result: Dict[str, Any]):
+        """把增益扫描结果写入当前实例"""
+        instance = self.data_model.get_active_instance()
+        if not instance or not pid_sweep.apply_result(self.data_model, instance['name'], result):
+            return
+        self.param_widget.load_params(instance['params'])
+        self._trigger_code_generation()
+        self._show_status(f"已应用扫描结果到 {instance['name']}: Kp={result['kp']:.6g}, "
+                          f"Ki={result['ki']:.6g}, Kd={result['kd']:.6g}", 3000)
+    
     @Slot(int)
     def _on_tab_changed(self, index: int):
         """选项卡切换处理"""
@@ -1171,6 +1193,8 @@ class AdvancedPIDGeneratorWidget(PanelInterface):
                 (save_dir / source_name, source_code),
                 (save_dir / main_name, main_code)
             ]
+            files_to_write.extend((save_dir / name, code)
+                                  for name, code in self.code_generator.generate_extra_files().items())
             
             for file_path, content in files_to_write:
                 if content and not content.startswith("// Error"):
@@ -1199,9 +1223,10 @@ class AdvancedPIDGeneratorWidget(PanelInterface):
             header_code = self.code_generator.generate_header_code()
             source_code = self.code_generator.generate_source_code()
             main_code = self.code_generator.generate_main_code()
+            extra_codes = self.code_generator.generate_extra_files()
             
             # 更新预览
-            self.preview_widget.set_generated_codes(source_code, header_code, main_code)
+            self.preview_widget.set_generated_codes(source_code, header_code, main_code, extra_codes)
             
             self._show_status("代码生成完成。", 2000)
             
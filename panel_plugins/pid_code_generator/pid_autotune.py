@@ -0,0 +1,80 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+继电器自整定进度帧解析(不依赖Qt)
+
+生成的 <头文件名>_autotune.c 在设备上运行继电器实验, 用功能码 AUTOTUNE_FUNC_ID 发送固定32字节的进度帧:
+- 字节0~3 (uint8): 实例编号、状态、已平均的周期数、目标周期数
+- 字节4~31 (7个float32, 小端): Ku、Pu(秒)、最近周期振幅、Kp、Ki、Kd(连续域)、已运行时间(秒)
+
+解析面板按上述顺序添加 uint8_t×4 与 float (4B)×7 的接收容器即可逐字段显示;
+decode_progress/apply_progress 供脚本和面板把结果写回数据模型。
+"""
+
+import struct
+from typing import Dict, Any
+
+try:
+    from .pid_codegen import PIDDataModel, PIDCodeGenerator
+except ImportError:  # 以脚本方式运行
+    from pid_codegen import PIDDataModel, PIDCodeGenerator
+
+AUTOTUNE_FUNC_ID = PIDCodeGenerator.AUTOTUNE_FUNC_ID
+PROGRESS_FORMAT = "<4B7f"
+PROGRESS_SIZE = struct.calcsize(PROGRESS_FORMAT)
+
+# 与模板中 PID_AutotuneState 一致
+STATE_NAMES = {
+    0: "未启动",
+    1: "实验中",
+    2: "完成",
+    3: "超时",
+    4: "未起振",
+    5: "偏差超限",
+    6: "已取消",
+}
+STATE_DONE = 2
+
+# 与模板中 PID_AutotuneRule 一致
+RULE_NAMES = ("Ziegler-Nichols PID", "Ziegler-Nichols PI", "Tyreus-Luyben PID",
+              "Tyreus-Luyben PI", "少量超调", "无超调")
+
+
+def decode_progress(payload: bytes) -> Dict[str, Any]:
+    """
+    解析一帧进度数据负载
+
+    Raises:
+        ValueError: 长度不足
+    """
+    if len(payload) < PROGRESS_SIZE:
+        raise ValueError(f"自整定进度帧需要 {PROGRESS_SIZE} 字节, 实际 {len(payload)} 字节")
+    (instance_id, state, cycles, target, ku, pu, amplitude,
+     kp, ki, kd, elapsed) = struct.unpack_from(PROGRESS_FORMAT, payload)
+    return {
+        "id": instance_id,
+        "state": state,
+        "state_name": STATE_NAMES.get(state, f"未知({state})"),
+        "cycles": cycles,
+        "target_cycles": target,
+        "ku": ku,
+        "pu": pu,
+        "amplitude": amplitude,
+        "kp": kp,
+        "ki": ki,
+        "kd": kd,
+        "elapsed": elapsed,
+    }
+
+
+def apply_progress(data_model: PIDDataModel, instance_name: str, progress: Dict[str, Any]) -> bool:
+    """整定完成时把设备算出的增益写入指定实例, 使重新生成的代码与设备一致"""
+    if progress.get("state") != STATE_DONE:
+        return False
+    for instance in data_model.pid_instances:
+        if instance['name'] == instance_name:
+            instance['params'][PIDDataModel.P_KP] = float(progress["kp"])
+            instance['params'][PIDDataModel.P_KI] = float(progress["ki"])
+            instance['params'][PIDDataModel.P_KD] = float(progress["kd"])
+            return True
+    return False
@@ -0,0 +1,1267 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+PID代码生成核心(不依赖Qt)
+
+PIDDataModel/PIDCodeGenerator 由GUI面板和构建系统共用:
+- advanced_pid_generator.py 在面板中预览和导出代码
+- CMake 以脚本方式调用本模块, 把模板实例化为可链接的C库
+
+命令行用法:
+    python pid_codegen.py --out-dir build/pid [--header pid.h] [--struct PID_HandleTypeDef]
+                          [--prefix PID] [--double] [--no-comments] [--main]
+                          [--bank] [--bank-capacity 24]
+                          [--fixed q15|q31] [--full-scale 200.0] [--specialize] [--cascade]
+                          [--split] [--sweep] [--autotune] [--schedule]
+                          [--telemetry]
+"""
+
+import argparse
+import re
+import sys
+from datetime import datetime
+from pathlib import Path
+from typing import Dict, Any, List, Optional, Tuple
+
+try:
+    from . import pid_fixed
+except ImportError:  # 以脚本方式运行
+    import pid_fixed
+
+
+class PIDDataModel:
+    """PID数据模型类，负责管理PID实例和配置数据"""
+    
+    # PID参数键常量
+    P_PID_TYPE = "pid_type"
+    P_WORK_MODE = "work_mode"
+    P_KP = "kp"
+    P_KI = "ki"
+    P_KD = "kd"
+    P_KFF = "kff"
+    P_FF_WEIGHT = "ff_weight"
+    P_SAMPLE_TIME = "sample_time"
+    P_MAX_OUT = "max_output"
+    P_MIN_OUT = "min_output"
+    P_INT_LIM = "integral_limit"
+    P_OUT_RAMP = "output_ramp"
+    P_DEADBAND = "deadband"
+    P_INT_SEP_THRESH = "integral_separation_threshold"
+    P_D_FILTER = "d_filter_coef"
+    P_IN_FILTER = "input_filter_coef"
+    P_SP_FILTER = "setpoint_filter_coef"
+    P_CASCADE_INNER = "cascade_inner"
+    P_SCHEDULE = "gain_schedule"
+    
+    # 高级功能参数（占位符）
+    P_ADAPTIVE_KP_MIN = "adaptive_kp_min"
+    P_ADAPTIVE_KP_MAX = "adaptive_kp_max"
+    P_ADAPTIVE_KI_MIN = "adaptive_ki_min"
+    P_ADAPTIVE_KI_MAX = "adaptive_ki_max"
+    P_ADAPTIVE_KD_MIN = "adaptive_kd_min"
+    P_ADAPTIVE_KD_MAX = "adaptive_kd_max"
+    P_FUZZY_ERR_RANGE = "fuzzy_error_range"
+    P_FUZZY_DERR_RANGE = "fuzzy_derror_range"
+    
+    # 代码配置键常量
+    C_STRUCT_NAME = "struct_name"
+    C_FUNC_PREFIX = "function_prefix"
+    C_HEADER_NAME = "header_name"
+    C_USE_FLOAT = "use_float"
+    C_INC_COMMENTS = "include_comments"
+    C_DATA_TYPE = "data_type"
+    C_FLOAT_SUFFIX = "float_suffix"
+    C_GEN_BANK = "generate_bank"
+    C_BANK_CAPACITY = "bank_capacity"
+    C_FIXED_FORMAT = "fixed_format"
+    C_FIXED_FULL_SCALE = "fixed_full_scale"
+    C_GEN_SPECIALIZED = "generate_specialized"
+    C_GEN_CASCADE = "generate_cascade"
+    C_GEN_SPLIT = "generate_split"
+    C_GEN_AUTOTUNE = "generate_autotune"
+    C_GEN_SCHEDULE = "generate_schedule"
+    C_GEN_TELEMETRY = "generate_telemetry"
+    
+    def __init__(self):
+        self.pid_instances: List[Dict[str, Any]] = []
+        self.active_instance_index = -1
+        self.code_config = self._get_default_code_config()
+    
+    def _get_default_pid_params(self) -> Dict[str, Any]:
+        """获取默认PID参数"""
+        return {
+            self.P_PID_TYPE: "standard",
+            self.P_WORK_MODE: "position",
+            self.P_KP: 1.0,
+            self.P_KI: 0.1,
+            self.P_KD: 0.01,
+            self.P_KFF: 0.0,
+            self.P_FF_WEIGHT: 1.0,
+            self.P_SAMPLE_TIME: 0.01,
+            self.P_MAX_OUT: 100.0,
+            self.P_MIN_OUT: -100.0,
+            self.P_INT_LIM: 50.0,
+            self.P_OUT_RAMP: 0.0,
+            self.P_DEADBAND: 0.0,
+            self.P_INT_SEP_THRESH: 1000.0,
+            self.P_D_FILTER: 0.0,
+            self.P_IN_FILTER: 0.0,
+            self.P_SP_FILTER: 0.0,
+            self.P_CASCADE_INNER: "",     # 串级内环实例名, 本实例输出作为其设定值
+            self.P_SCHEDULE: [],          # 增益调度断点 [调度变量, Kp, Ki, Kd], 增益为连续域
+            # 高级功能占位符
+            self.P_ADAPTIVE_KP_MIN: 0.1,
+            self.P_ADAPTIVE_KP_MAX: 10.0,
+            self.P_ADAPTIVE_KI_MIN: 0.01,
+            self.P_ADAPTIVE_KI_MAX: 1.0,
+            self.P_ADAPTIVE_KD_MIN: 0.001,
+            self.P_ADAPTIVE_KD_MAX: 0.1,
+            self.P_FUZZY_ERR_RANGE: 10.0,
+            self.P_FUZZY_DERR_RANGE: 1.0,
+        }
+    
+    def _get_default_code_config(self) -> Dict[str, Any]:
+        """获取默认代码配置"""
+        return {
+            self.C_STRUCT_NAME: "PID_HandleTypeDef",
+            self.C_FUNC_PREFIX: "PID",
+            self.C_HEADER_NAME: "pid.h",
+            self.C_USE_FLOAT: True,
+            self.C_INC_COMMENTS: True,
+            self.C_DATA_TYPE: "float",
+            self.C_FLOAT_SUFFIX: "f",
+            self.C_GEN_BANK: False,
+            self.C_BANK_CAPACITY: 24,
+            self.C_FIXED_FORMAT: "",
+            self.C_FIXED_FULL_SCALE: 200.0,
+            self.C_GEN_SPECIALIZED: False,
+            self.C_GEN_CASCADE: False,
+            self.C_GEN_SPLIT: False,
+            self.C_GEN_AUTOTUNE: False,
+            self.C_GEN_SCHEDULE: False,
+            self.C_GEN_TELEMETRY: False,
+        }
+    
+    def add_instance(self, name: str) -> bool:
+        """添加PID实例"""
+        if any(inst['name'] == name for inst in self.pid_instances):
+            return False
+        
+        new_instance = {
+            'name': name,
+            'params': self._get_default_pid_params()
+        }
+        self.pid_instances.append(new_instance)
+        return True
+    
+    def remove_instance(self, index: int) -> bool:
+        """移除PID实例"""
+        if 0 <= index < len(self.pid_instances):
+            removed_name = self.pid_instances[index]['name']
+            del self.pid_instances[index]
+            for inst in self.pid_instances:
+                if inst['params'].get(self.P_CASCADE_INNER) == removed_name:
+                    inst['params'][self.P_CASCADE_INNER] = ""
+            if self.active_instance_index >= len(self.pid_instances):
+                self.active_instance_index = len(self.pid_instances) - 1
+            return True
+        return False
+    
+    def rename_instance(self, index: int, new_name: str) -> bool:
+        """重命名PID实例"""
+        if not (0 <= index < len(self.pid_instances)):
+            return False
+        
+        # 检查名称冲突
+        if any(inst['name'] == new_name for i, inst in enumerate(self.pid_instances) if i != index):
+            return False
+        
+        old_name = self.pid_instances[index]['name']
+        self.pid_instances[index]['name'] = new_name
+        for inst in self.pid_instances:
+            if inst['params'].get(self.P_CASCADE_INNER) == old_name:
+                inst['params'][self.P_CASCADE_INNER] = new_name
+        return True
+    
+    def get_active_instance(self) -> Optional[Dict[str, Any]]:
+        """获取当前活动实例"""
+        if 0 <= self.active_instance_index < len(self.pid_instances):
+            return self.pid_instances[self.active_instance_index]
+        return None
+    
+    def update_active_instance_params(self, params: Dict[str, Any]):
+        """更新当前活动实例的参数"""
+        active_instance = self.get_active_instance()
+        if active_instance:
+            active_instance['params'].update(params)
+    
+    def update_code_config(self, config: Dict[str, Any]):
+        """更新代码配置"""
+        self.code_config.update(config)
+        # 更新派生字段
+        self.code_config[self.C_DATA_TYPE] = "float" if self.code_config[self.C_USE_FLOAT] else "double"
+        self.code_config[self.C_FLOAT_SUFFIX] = "f" if self.code_config[self.C_USE_FLOAT] else ""
+
+
+class PIDCodeGenerator:
+    """PID代码生成器类，负责从模板生成代码"""
+
+    AUTOTUNE_FUNC_ID = 0xD1     # 自整定进度帧的YJ协议功能码
+    TELEMETRY_FUNC_ID = 0xD2    # 遥测批量帧的YJ协议功能码
+    
+    def __init__(self, data_model: PIDDataModel):
+        self.data_model = data_model
+        self.template_dir = Path(__file__).parent / "templates"
+    
+    def generate_header_code(self) -> str:
+        """生成头文件代码"""
+        template_path = self.template_dir / "advanced_pid_template.h"
+        if not template_path.exists():
+            return "// Error: Header template not found."
+        return self._generate_from_template(template_path)
+    
+    def generate_source_code(self) -> str:
+        """生成源文件代码"""
+        template_path = self.template_dir / "advanced_pid_template.c"
+        if not template_path.exists():
+            return "// Error: Source template not found."
+        return self._generate_from_template(template_path)
+    
+    def generate_bank_header_code(self) -> str:
+        """生成控制器组(数组结构体批量计算)头文件代码"""
+        template_path = self.template_dir / "pid_bank_template.h"
+        if not template_path.exists():
+            return "// Error: Bank header template not found."
+        return self._generate_from_template(template_path)
+
+    def generate_bank_source_code(self) -> str:
+        """生成控制器组源文件代码"""
+        template_path = self.template_dir / "pid_bank_template.c"
+        if not template_path.exists():
+            return "// Error: Bank source template not found."
+        return self._generate_from_template(template_path)
+
+    @staticmethod
+    def bank_file_names(header_name: str) -> List[str]:
+        """控制器组头文件/源文件名, 由单实例头文件名派生"""
+        stem = Path(header_name).stem
+        return [f"{stem}_bank.h", f"{stem}_bank.c"]
+
+    @staticmethod
+    def fixed_file_names(header_name: str, format_name: str) -> List[str]:
+        """定点版本头文件/源文件名, 如 pid_q15.h/pid_q15.c"""
+        stem = Path(header_name).stem
+        return [f"{stem}_{format_name}.h", f"{stem}_{format_name}.c"]
+
+    def _get_fixed_replacements(self) -> Dict[str, str]:
+        """定点模板的附加替换: 类型、各实例配置和误差报告"""
+        config = self.data_model.code_config
+        format_name = config[self.data_model.C_FIXED_FORMAT]
+        full_scale = float(config[self.data_model.C_FIXED_FULL_SCALE])
+        fmt = pid_fixed.FixedFormat(format_name)
+        prefix = f"{config[self.data_model.C_FUNC_PREFIX]}_{format_name.upper()}"
+        config_name = f"{prefix}_ConfigTypeDef"
+        fixed_header, fixed_source = self.fixed_file_names(config[self.data_model.C_HEADER_NAME], format_name)
+
+        declarations, definitions = [], []
+        for instance in self.data_model.pid_instances:
+            var_name = f"{instance['name']}_{format_name}_config"
+            try:
+                initializer = pid_fixed.config_initializer(
+                    fmt, pid_fixed.make_config(fmt, instance['params'], full_scale))
+            except ValueError as e:
+                declarations.append(f"/* {instance['name']}: {e} */")
+                continue
+            declarations.append(f"extern const {config_name} {var_name};")
+            definitions.append(f"const {config_name} {var_name} = {initializer};")
+
+        report = pid_fixed.error_report(self.data_model.pid_instances, format_name, full_scale)
+        wide_bits = 32 if fmt.wide_type == "int32_t" else 64
+        return {
+            '{{FIXED_FORMAT}}': format_name.upper(),
+            '{{FIXED_PREFIX}}': prefix,
+            '{{FIXED_NAME}}': f"{prefix}_HandleTypeDef",
+            '{{FIXED_CONFIG_NAME}}': config_name,
+            '{{FIXED_HEADER_NAME}}': fixed_header,
+            '{{FIXED_SOURCE_NAME}}': fixed_source,
+            '{{FIXED_FULL_SCALE}}': f"{full_scale!r}{config[self.data_model.C_FLOAT_SUFFIX]}",
+            '{{FIXED_ERROR_REPORT}}': "\n".join(f" *   {line}" for line in report.splitlines()),
+            '{{FIXED_INSTANCE_DECLARATIONS}}': "\n".join(declarations) or "/* 未配置任何PID实例 */",
+            '{{FIXED_INSTANCE_CONFIGS}}': "\n\n".join(definitions) or "/* 未配置任何PID实例 */",
+            '{{Q_TYPE}}': fmt.narrow_type,
+            '{{QW_TYPE}}': fmt.wide_type,
+            '{{Q_BITS}}': str(fmt.bits),
+            '{{Q_MAX}}': f"INT{fmt.bits + 1}_MAX",
+            '{{Q_MIN}}': f"INT{fmt.bits + 1}_MIN",
+            '{{QW_MAX}}': f"INT{wide_bits}_MAX",
+            '{{QW_MIN}}': f"INT{wide_bits}_MIN",
+        }
+
+    def generate_fixed_header_code(self) -> str:
+        """生成定点(Q15/Q31)版本头文件代码"""
+        template_path = self.template_dir / "pid_fixed_template.h"
+        if not template_path.exists():
+            return "// Error: Fixed-point header template not found."
+        return self._generate_from_template(template_path, self._get_fixed_replacements())
+
+    def generate_fixed_source_code(self) -> str:
+        """生成定点版本源文件代码"""
+        template_path = self.template_dir / "pid_fixed_template.c"
+        if not template_path.exists():
+            return "// Error: Fixed-point source template not found."
+        return self._generate_from_template(template_path, self._get_fixed_replacements())
+
+    @staticmethod
+    def spec_file_names(header_name: str) -> List[str]:
+        """专用计算函数头文件/源文件名, 如 pid_spec.h/pid_spec.c"""
+        stem = Path(header_name).stem
+        return [f"{stem}_spec.h", f"{stem}_spec.c"]
+
+    @staticmethod
+    def specialized_features(params: Dict[str, Any]) -> Dict[str, bool]:
+        """
+        按实例参数判断专用计算函数中需要保留的功能
+
+        启用条件与 _get_instance_init_code 中是否调用对应Set函数一致。
+        积分分离不在其中: Init 总会设置分离阈值(默认1000), 保留积分时总是按句柄中的阈值判断。
+        """
+        m = PIDDataModel
+        return {
+            "input_filter": params[m.P_IN_FILTER] > 0,
+            "setpoint_filter": params[m.P_SP_FILTER] > 0,
+            "deadband": params[m.P_DEADBAND] > 0,
+            "integral": params[m.P_KI] != 0,
+            "derivative": params[m.P_KD] != 0,
+            "d_filter": params[m.P_KD] != 0 and params[m.P_D_FILTER] > 0,
+            "feedforward": params[m.P_KFF] != 0 and params[m.P_FF_WEIGHT] != 0,
+            "output_ramp": params[m.P_OUT_RAMP] > 0,
+        }
+
+    def _get_specialized_compute_code(self, instance: Dict[str, Any]) -> List[str]:
+        """为单个实例生成专用计算函数: 类型/工作方式固定, 未启用的功能不生成"""
+        config = self.data_model.code_config
+        m = PIDDataModel
+        sfx = config[m.C_FLOAT_SUFFIX]
+        dt = config[m.C_DATA_TYPE]
+        params = instance['params']
+        pid_type = params[m.P_PID_TYPE]
+        velocity = params[m.P_WORK_MODE] == "velocity"
+        features = self.specialized_features(params)
+        feature_names = {
+            "input_filter": "测量值滤波", "setpoint_filter": "设定值滤波", "deadband": "死区",
+            "integral": "积分项(含积分分离)", "derivative": "微分项",
+            "d_filter": "微分滤波", "feedforward": "前馈", "output_ramp": "斜率限制",
+        }
+        enabled = [feature_names[k] for k, v in features.items() if v]
+        removed = [feature_names[k] for k, v in features.items() if not v]
+        type_names = {"standard": "标准PID", "pi_d": "PI-D", "i_pd": "I-PD"}
+
+        lines = [
+            f"/* {instance['name']}: {type_names[pid_type]}, {'速度式' if velocity else '位置式'}; "
+            f"保留: {', '.join(enabled) or '无'}; 未生成: {', '.join(removed) or '无'} */",
+            f"{dt} {self.specialized_function_name(instance['name'])}"
+            f"({config[m.C_STRUCT_NAME]} *pid, {dt} setpoint, {dt} measure) {{",
+            "    if (pid->mode == PID_MODE_MANUAL) return pid->output;",
+            "",
+        ]
+        if features["input_filter"]:
+            lines.append(f"    measure = pid->filtered_measure * (1.0{sfx} - pid->input_filter_coef) + measure * pid->input_filter_coef;")
+            lines.append("    pid->filtered_measure = measure;")
+        if features["setpoint_filter"]:
+            lines.append(f"    setpoint = pid->filtered_setpoint * (1.0{sfx} - pid->setpoint_filter_coef) + setpoint * pid->setpoint_filter_coef;")
+            lines.append("    pid->filtered_setpoint = setpoint;")
+        if features["input_filter"] or features["setpoint_filter"]:
+            lines.append("")
+        lines.append(f"    {dt} error = setpoint - measure;")
+        if features["deadband"]:
+            lines.append(f"    if (fabs{sfx}(error) < pid->deadband) error = 0.0{sfx};")
+        lines.append("    pid->last_p_term = -pid->Kp * measure;" if pid_type == "i_pd"
+                     else "    pid->last_p_term = pid->Kp * error;")
+        terms = ["pid->last_p_term", "pid->last_i_term"]
+
+        if features["integral"]:
+            trapezoidal = f"const {dt} i_inc = (pid->integration == PID_INTEGRATION_TRAPEZOIDAL) ? "
+            update = [
+                f"{trapezoidal}pid->Ki * 0.5{sfx} * (error + pid->prev_error)",
+                f"{' ' * (len(trapezoidal) - 2)}: pid->Ki * error;",
+                "/* 下游饱和时不再朝饱和方向累积 */",
+                "if (i_inc * pid->integral_hold <= 0.0%s) {" % sfx,
+                "    pid->integral = pid_spec_clamp(pid->integral + i_inc, -pid->integral_limit, pid->integral_limit);",
+                "}",
+            ]
+            lines.append("    if (fabs%s(error) < pid->integral_separation_threshold) {" % sfx)
+            lines.extend(f"        {line}" for line in update)
+            lines.append("    }")
+        # 不生成积分更新时仍输出积分器的值, 保持手动->自动切换的无扰特性
+        lines.append("    pid->last_i_term = pid->integral;")
+
+        if features["derivative"]:
+            lines.append(f"    {dt} d_input = (error - pid->prev_error) * pid->inv_sample_time;" if pid_type == "standard"
+                         else f"    {dt} d_input = -(measure - pid->prev_measure) * pid->inv_sample_time;")
+            if features["d_filter"]:
+                lines.append(f"    d_input = pid->filtered_d * (1.0{sfx} - pid->d_filter_coef) + d_input * pid->d_filter_coef;")
+            lines.append("    pid->filtered_d = d_input;")
+            lines.append("    pid->last_d_term = pid->Kd_continuous * d_input;")
+            terms.append("pid->last_d_term")
+        else:
+            lines.append(f"    pid->last_d_term = 0.0{sfx};")
+
+        if features["feedforward"]:
+            lines.append("    pid->last_ff_term = pid->Kff * setpoint * pid->ff_weight;")
+            terms.append("pid->last_ff_term")
+        else:
+            lines.append(f"    pid->last_ff_term = 0.0{sfx};")
+
+        lines.append("")
+        lines.append(f"    {dt} computed_output = {' + '.join(terms)};")
+        if features["output_ramp"]:
+            lines.append(f"    const {dt} max_change = pid->output_ramp * pid->sample_time;")
+            lines.append("    computed_output = pid->prev_output + pid_spec_clamp(computed_output - pid->prev_output, -max_change, max_change);")
+        lines.append("    computed_output = pid_spec_clamp(computed_output, -pid->output_limit, pid->output_limit);")
+        lines.append("")
+        # 梯形积分和标准型微分都要用上次误差
+        if features["integral"] or (features["derivative"] and pid_type == "standard"):
+            lines.append("    pid->prev_error = error;")
+        if features["derivative"] and pid_type != "standard":
+            lines.append("    pid->prev_measure = measure;")
+        lines.append("    pid->output = computed_output - pid->prev_output;" if velocity
+                     else "    pid->output = computed_output;")
+        lines.append("    pid->prev_output = computed_output;")
+        lines.append("    return pid->output;")
+        lines.append("}")
+        return lines
+
+    def specialized_function_name(self, instance_name: str) -> str:
+        """实例专用计算函数名, 如 PID_Compute_motor_speed_pid"""
+        return f"{self.data_model.code_config[PIDDataModel.C_FUNC_PREFIX]}_Compute_{instance_name}"
+
+    def _get_spec_replacements(self) -> Dict[str, str]:
+        """专用计算函数模板的附加替换"""
+        config = self.data_model.code_config
+        spec_header, spec_source = self.spec_file_names(config[self.data_model.C_HEADER_NAME])
+        dt = config[self.data_model.C_DATA_TYPE]
+        declarations, functions = [], []
+        for instance in self.data_model.pid_instances:
+            declarations.append(f"{dt} {self.specialized_function_name(instance['name'])}"
+                                f"({config[self.data_model.C_STRUCT_NAME]} *pid, {dt} setpoint, {dt} measure);")
+            functions.append("\n".join(self._get_specialized_compute_code(instance)))
+        return {
+            '{{SPEC_HEADER_NAME}}': spec_header,
+            '{{SPEC_SOURCE_NAME}}': spec_source,
+            '{{SPEC_DECLARATIONS}}': "\n".join(declarations) or "/* 未配置任何PID实例 */",
+            '{{SPEC_FUNCTIONS}}': "\n\n".join(functions) or "/* 未配置任何PID实例 */",
+        }
+
+    def generate_spec_header_code(self) -> str:
+        """生成实例专用计算函数头文件代码"""
+        template_path = self.template_dir / "pid_spec_template.h"
+        if not template_path.exists():
+            return "// Error: Specialized header template not found."
+        return self._generate_from_template(template_path, self._get_spec_replacements())
+
+    def generate_spec_source_code(self) -> str:
+        """生成实例专用计算函数源文件代码"""
+        template_path = self.template_dir / "pid_spec_template.c"
+        if not template_path.exists():
+            return "// Error: Specialized source template not found."
+        return self._generate_from_template(template_path, self._get_spec_replacements())
+
+    @staticmethod
+    def cascade_file_names(header_name: str) -> List[str]:
+        """串级控制器头文件/源文件名, 如 pid_cascade.h/pid_cascade.c"""
+        stem = Path(header_name).stem
+        return [f"{stem}_cascade.h", f"{stem}_cascade.c"]
+
+    CASCADE_MAX_STAGES = 4
+
+    def cascade_chains(self) -> Tuple[List[Tuple[List[Dict[str, Any]], List[int]]], List[str]]:
+        """
+        按各实例的"串级内环"设置整理串级链
+
+        Returns:
+            (链列表, 错误列表); 每条链为 (实例列表(外环在前), 各级分频系数),
+            分频系数 = 本级采样时间 / 最内环采样时间, 相邻两级之比必须为整数
+        """
+        m = PIDDataModel
+        by_name = {inst['name']: inst for inst in self.data_model.pid_instances}
+        outer_of: Dict[str, str] = {}
+        errors = []
+        for inst in self.data_model.pid_instances:
+            inner = inst['params'].get(m.P_CASCADE_INNER, "")
+            if not inner:
+                continue
+            if inner not in by_name or inner == inst['name']:
+                errors.append(f"{inst['name']}: 串级内环实例 {inner} 不存在")
+            elif inner in outer_of:
+                errors.append(f"{inner}: 同时被 {outer_of[inner]} 和 {inst['name']} 指定为串级内环")
+            else:
+                outer_of[inner] = inst['name']
+        inner_of = {outer: inner for inner, outer in outer_of.items()}
+
+        chains, visited = [], set()
+        for inst in self.data_model.pid_instances:
+            name = inst['name']
+            if name in outer_of or name not in inner_of:
+                continue
+            names = [name]
+            while names[-1] in inner_of:
+                names.append(inner_of[names[-1]])
+            visited.update(names)
+            if len(names) > self.CASCADE_MAX_STAGES:
+                errors.append(f"{name}: 串级超过{self.CASCADE_MAX_STAGES}级")
+                continue
+            times = [max(by_name[n]['params'][m.P_SAMPLE_TIME], 1e-6) for n in names]
+            ratios = [times[i] / times[i + 1] for i in range(len(times) - 1)]
+            bad = [i for i, r in enumerate(ratios) if round(r) < 1 or abs(r - round(r)) > 1e-6 * r]
+            if bad:
+                i = bad[0]
+                errors.append(f"{names[i]}: 采样时间 {times[i]} 不是内环 {names[i + 1]} ({times[i + 1]}) 的整数倍")
+                continue
+            dividers = [int(round(t / times[-1])) for t in times]
+            if dividers[0] > 0xFFFF:
+                errors.append(f"{name}: 分频系数 {dividers[0]} 超出uint16_t范围")
+                continue
+            chains.append(([by_name[n] for n in names], dividers))
+        for inner in outer_of:
+            if inner not in visited:
+                errors.append(f"{inner}: 串级链首尾相连, 无法确定最外环")
+                break
+        return chains, errors
+
+    def _get_cascade_init_code(self, chain: List[Dict[str, Any]], dividers: List[int]) -> List[str]:
+        """为一条串级链生成初始化函数: 设定级数/分频系数, 再按各实例参数配置每一级"""
+        config = self.data_model.code_config
+        prefix = config[self.data_model.C_FUNC_PREFIX]
+        head = chain[0]['name']
+        lines = [
+            f"/* {' -> '.join(inst['name'] for inst in chain)}, 分频系数 {{{', '.join(map(str, dividers))}}} */",
+            f"bool {prefix}_CascadeInit_{head}({prefix}_CascadeTypeDef *cascade) {{",
+            f"    static const uint16_t dividers[{len(chain)}] = {{{', '.join(map(str, dividers))}}};",
+            f"    if (!{prefix}_CascadeInit(cascade, {len(chain)}, dividers)) return false;",
+        ]
+        for i, inst in enumerate(chain):
+            for line in self._get_instance_init_code(inst):
+                if "printf" in line or not line:
+                    continue
+                lines.append(line.replace(f"&{inst['name']},", f"&cascade->stage[{i}],"))
+        lines.append("    return true;")
+        lines.append("}")
+        return lines
+
+    def _get_cascade_replacements(self) -> Dict[str, str]:
+        """串级模板的附加替换"""
+        config = self.data_model.code_config
+        prefix = config[self.data_model.C_FUNC_PREFIX]
+        cascade_header, cascade_source = self.cascade_file_names(config[self.data_model.C_HEADER_NAME])
+        chains, errors = self.cascade_chains()
+        declarations = [f"/* 串级设置错误, 未生成: {e} */" for e in errors]
+        definitions = []
+        for chain, dividers in chains:
+            declarations.append(f"bool {prefix}_CascadeInit_{chain[0]['name']}({prefix}_CascadeTypeDef *cascade);")
+            definitions.append("\n".join(self._get_cascade_init_code(chain, dividers)))
+        return {
+            '{{CASCADE_NAME}}': f"{prefix}_CascadeTypeDef",
+            '{{CASCADE_HEADER_NAME}}': cascade_header,
+            '{{CASCADE_SOURCE_NAME}}': cascade_source,
+            '{{CASCADE_DECLARATIONS}}': "\n".join(declarations) or "/* 未配置串级实例 */",
+            '{{CASCADE_INITS}}': "\n\n".join(definitions) or "/* 未配置串级实例 */",
+        }
+
+    def generate_cascade_header_code(self) -> str:
+        """生成串级控制器头文件代码"""
+        template_path = self.template_dir / "pid_cascade_template.h"
+        if not template_path.exists():
+            return "// Error: Cascade header template not found."
+        return self._generate_from_template(template_path, self._get_cascade_replacements())
+
+    def generate_cascade_source_code(self) -> str:
+        """生成串级控制器源文件代码"""
+        template_path = self.template_dir / "pid_cascade_template.c"
+        if not template_path.exists():
+            return "// Error: Cascade source template not found."
+        return self._generate_from_template(template_path, self._get_cascade_replacements())
+
+    @staticmethod
+    def split_file_names(header_name: str) -> List[str]:
+        """冷热分离布局头文件/源文件名, 如 pid_split.h/pid_split.c"""
+        stem = Path(header_name).stem
+        return [f"{stem}_split.h", f"{stem}_split.c"]
+
+    def _get_split_config_initializer(self, instance: Dict[str, Any]) -> List[str]:
+        """
+        单个实例的只读配置初始化器
+
+        取值与 _get_instance_init_code 生成的Init/Set调用结果一致(未调用Set函数的项取库的默认值);
+        与采样时间相关的项写成常量表达式, 由编译器按生成的数据类型折叠, 与运行时换算逐位相同。
+        """
+        config = self.data_model.code_config
+        m = PIDDataModel
+        sfx = config[m.C_FLOAT_SUFFIX]
+        prefix = config[m.C_FUNC_PREFIX]
+        params = instance['params']
+        defaults = self.data_model._get_default_pid_params()
+
+        def lit(value) -> str:
+            return f"{value}{sfx}"
+
+        def unit(value) -> float:
+            return min(max(value, 0.0), 1.0)
+
+        sample_time = max(params[m.P_SAMPLE_TIME], 1e-6)
+        ts = lit(sample_time if sample_time > 1e-6 else 0.01)
+        kp, ki, kd = params[m.P_KP], params[m.P_KI], params[m.P_KD]
+        if min(kp, ki, kd) < 0:  # SetTunings拒绝负增益, 增益保持为0
+            kp = ki = kd = 0.0
+        if params[m.P_KFF] != 0 or params[m.P_FF_WEIGHT] != 1.0:
+            kff, ff_weight = params[m.P_KFF], unit(params[m.P_FF_WEIGHT])
+        else:
+            kff, ff_weight = defaults[m.P_KFF], defaults[m.P_FF_WEIGHT]
+        ramp = abs(params[m.P_OUT_RAMP]) if params[m.P_OUT_RAMP] > 0 else defaults[m.P_OUT_RAMP]
+        deadband = abs(params[m.P_DEADBAND]) if params[m.P_DEADBAND] > 0 else defaults[m.P_DEADBAND]
+        separation = (abs(params[m.P_INT_SEP_THRESH]) if params[m.P_INT_SEP_THRESH] < 1000.0
+                      else defaults[m.P_INT_SEP_THRESH])
+
+        def coef(key: str) -> float:
+            return unit(params[key]) if params[key] > 0 else defaults[key]
+
+        pid_type_map = {"standard": "PID_TYPE_STANDARD", "pi_d": "PID_TYPE_PI_D", "i_pd": "PID_TYPE_I_PD"}
+        work_mode_map = {"position": "PID_MODE_POSITION", "velocity": "PID_MODE_VELOCITY"}
+        return [
+            f"const {prefix}_SplitConfigTypeDef {instance['name']}_split_config = {{",
+            f"    .Kp = {lit(kp)},",
+            f"    .Ki = {lit(ki)} * {ts},",
+            f"    .Kd_continuous = {lit(kd)},",
+            f"    .inv_sample_time = 1.0{sfx} / {ts},",
+            f"    .Kff = {lit(kff)},",
+            f"    .ff_weight = {lit(ff_weight)},",
+            f"    .output_limit = {lit(abs(params[m.P_MAX_OUT]))},",
+            f"    .integral_limit = {lit(abs(params[m.P_INT_LIM]))},",
+            f"    .max_change = {lit(ramp)} * {ts},",
+            f"    .deadband = {lit(deadband)},",
+            f"    .integral_separation_threshold = {lit(separation)},",
+            f"    .d_filter_coef = {lit(coef(m.P_D_FILTER))},",
+            f"    .input_filter_coef = {lit(coef(m.P_IN_FILTER))},",
+            f"    .setpoint_filter_coef = {lit(coef(m.P_SP_FILTER))},",
+            f"    .type = {pid_type_map[params[m.P_PID_TYPE]]},",
+            f"    .work_mode = {work_mode_map[params[m.P_WORK_MODE]]},",
+            "    .integration = PID_INTEGRATION_RECTANGULAR,",
+            "};",
+        ]
+
+    def _get_split_replacements(self) -> Dict[str, str]:
+        """冷热分离模板的附加替换"""
+        config = self.data_model.code_config
+        prefix = config[self.data_model.C_FUNC_PREFIX]
+        split_header, split_source = self.split_file_names(config[self.data_model.C_HEADER_NAME])
+        config_name = f"{prefix}_SplitConfigTypeDef"
+        declarations, definitions = [], []
+        for instance in self.data_model.pid_instances:
+            declarations.append(f"extern const {config_name} {instance['name']}_split_config;")
+            definitions.append("\n".join(self._get_split_config_initializer(instance)))
+        return {
+            '{{SPLIT_CONFIG_NAME}}': config_name,
+            '{{SPLIT_STATE_NAME}}': f"{prefix}_SplitStateTypeDef",
+            '{{SPLIT_HEADER_NAME}}': split_header,
+            '{{SPLIT_SOURCE_NAME}}': split_source,
+            '{{SPLIT_INSTANCE_DECLARATIONS}}': "\n".join(declarations) or "/* 未配置任何PID实例 */",
+            '{{SPLIT_INSTANCE_CONFIGS}}': "\n\n".join(definitions) or "/* 未配置任何PID实例 */",
+        }
+
+    def generate_split_header_code(self) -> str:
+        """生成冷热分离布局头文件代码"""
+        template_path = self.template_dir / "pid_split_template.h"
+        if not template_path.exists():
+            return "// Error: Split header template not found."
+        return self._generate_from_template(template_path, self._get_split_replacements())
+
+    def generate_split_source_code(self) -> str:
+        """生成冷热分离布局源文件代码"""
+        template_path = self.template_dir / "pid_split_template.c"
+        if not template_path.exists():
+            return "// Error: Split source template not found."
+        return self._generate_from_template(template_path, self._get_split_replacements())
+
+    @staticmethod
+    def sweep_file_name(header_name: str) -> str:
+        """增益扫描仿真程序源文件名, 如 pid_sweep.c"""
+        return f"{Path(header_name).stem}_sweep.c"
+
+    def _sweep_base_instance(self, instance_name: Optional[str] = None) -> Dict[str, Any]:
+        """增益扫描使用的实例: 指定名称、当前选中或第一个实例, 都没有时用默认参数"""
+        for instance in self.data_model.pid_instances:
+            if instance['name'] == instance_name:
+                return instance
+        active = self.data_model.get_active_instance()
+        if instance_name is None and active:
+            return active
+        if instance_name is None and self.data_model.pid_instances:
+            return self.data_model.pid_instances[0]
+        if instance_name is not None:
+            raise ValueError(f"实例 '{instance_name}' 不存在")
+        return {'name': "pid_default", 'params': self.data_model._get_default_pid_params()}
+
+    def _get_sweep_replacements(self, instance: Dict[str, Any]) -> Dict[str, str]:
+        """增益扫描模板的附加替换: 实例配置(增益由参数给出)、采样时间和工作方式"""
+        config = self.data_model.code_config
+        name = instance['name']
+        params = instance['params']
+        prefix = config[self.data_model.C_FUNC_PREFIX]
+        sfx = config[self.data_model.C_FLOAT_SUFFIX]
+        sample_time = max(params[self.data_model.P_SAMPLE_TIME], 1e-6)
+        body = [f"    {prefix}_Init(pid, kp, ki, kd, {sample_time}{sfx});"]
+        # 沿用生成的初始化代码中Init之后的Set调用
+        for line in self._get_instance_init_code(instance)[2:]:
+            if line.strip() and "printf" not in line:
+                body.append(line.replace(f"(&{name},", "(pid,"))
+        return {
+            '{{SWEEP_SOURCE_NAME}}': self.sweep_file_name(config[self.data_model.C_HEADER_NAME]),
+            '{{SWEEP_BASE_NAME}}': name,
+            '{{SWEEP_BASE_INIT}}': "\n".join(body),
+            '{{SWEEP_SAMPLE_TIME}}': f"{sample_time}{sfx}",
+            '{{SWEEP_VELOCITY}}': "1" if params[self.data_model.P_WORK_MODE] == "velocity" else "0",
+        }
+
+    def generate_sweep_source_code(self, instance_name: Optional[str] = None) -> str:
+        """
+        生成主机端增益扫描仿真程序(含main, 需与库源文件和控制器组源文件一起编译)
+
+        Args:
+            instance_name: 作为控制器配置的实例, 默认当前选中的实例
+        """
+        template_path = self.template_dir / "pid_sweep_template.c"
+        if not template_path.exists():
+            return "// Error: Sweep template not found."
+        try:
+            instance = self._sweep_base_instance(instance_name)
+        except ValueError as e:
+            return f"// Error: {e}"
+        return self._generate_from_template(template_path, self._get_sweep_replacements(instance))
+
+    @staticmethod
+    def autotune_file_names(header_name: str) -> List[str]:
+        """继电器自整定模块头文件/源文件名, 如 pid_autotune.h/pid_autotune.c"""
+        stem = Path(header_name).stem
+        return [f"{stem}_autotune.h", f"{stem}_autotune.c"]
+
+    def _get_autotune_replacements(self) -> Dict[str, str]:
+        """自整定模板的附加替换"""
+        config = self.data_model.code_config
+        autotune_header, autotune_source = self.autotune_file_names(config[self.data_model.C_HEADER_NAME])
+        return {
+            '{{AUTOTUNE_NAME}}': f"{config[self.data_model.C_FUNC_PREFIX]}_AutotuneTypeDef",
+            '{{AUTOTUNE_HEADER_NAME}}': autotune_header,
+            '{{AUTOTUNE_SOURCE_NAME}}': autotune_source,
+            '{{AUTOTUNE_FUNC_ID}}': f"0x{self.AUTOTUNE_FUNC_ID:02X}",
+        }
+
+    def generate_autotune_header_code(self) -> str:
+        """生成继电器自整定模块头文件代码"""
+        template_path = self.template_dir / "pid_autotune_template.h"
+        if not template_path.exists():
+            return "// Error: Autotune header template not found."
+        return self._generate_from_template(template_path, self._get_autotune_replacements())
+
+    def generate_autotune_source_code(self) -> str:
+        """生成继电器自整定模块源文件代码"""
+        template_path = self.template_dir / "pid_autotune_template.c"
+        if not template_path.exists():
+            return "// Error: Autotune source template not found."
+        return self._generate_from_template(template_path, self._get_autotune_replacements())
+
+    @staticmethod
+    def telemetry_file_names(header_name: str) -> List[str]:
+        """遥测模块头文件/源文件名, 如 pid_telemetry.h/pid_telemetry.c"""
+        stem = Path(header_name).stem
+        return [f"{stem}_telemetry.h", f"{stem}_telemetry.c"]
+
+    def _get_telemetry_replacements(self) -> Dict[str, str]:
+        """遥测模板的附加替换"""
+        config = self.data_model.code_config
+        telemetry_header, telemetry_source = self.telemetry_file_names(config[self.data_model.C_HEADER_NAME])
+        return {
+            '{{TELEMETRY_NAME}}': f"{config[self.data_model.C_FUNC_PREFIX]}_TelemetryTypeDef",
+            '{{TELEMETRY_HEADER_NAME}}': telemetry_header,
+            '{{TELEMETRY_SOURCE_NAME}}': telemetry_source,
+            '{{TELEMETRY_FUNC_ID}}': f"0x{self.TELEMETRY_FUNC_ID:02X}",
+        }
+
+    def generate_telemetry_header_code(self) -> str:
+        """生成遥测头文件代码"""
+        template_path = self.template_dir / "pid_telemetry_template.h"
+        if not template_path.exists():
+            return "// Error: Telemetry header template not found."
+        return self._generate_from_template(template_path, self._get_telemetry_replacements())
+
+    def generate_telemetry_source_code(self) -> str:
+        """生成遥测源文件代码"""
+        template_path = self.template_dir / "pid_telemetry_template.c"
+        if not template_path.exists():
+            return "// Error: Telemetry source template not found."
+        return self._generate_from_template(template_path, self._get_telemetry_replacements())
+
+    @staticmethod
+    def schedule_file_names(header_name: str) -> List[str]:
+        """增益调度头文件/源文件名, 如 pid_schedule.h/pid_schedule.c"""
+        stem = Path(header_name).stem
+        return [f"{stem}_schedule.h", f"{stem}_schedule.c"]
+
+    def schedule_table(self, instance: Dict[str, Any]) -> Tuple[List[List[float]], bool, Optional[str]]:
+        """
+        整理实例的增益调度断点表
+
+        Returns:
+            (按调度变量排序的断点 [x, Kp, Ki, Kd], 是否等间距, 错误说明);
+            未配置时断点为空, 配置有误时断点为空并给出原因
+        """
+        rows = instance['params'].get(self.data_model.P_SCHEDULE) or []
+        if not rows:
+            return [], False, None
+        if len(rows) < 2:
+            return [], False, "至少需要2个断点"
+        if len(rows) > 65535:
+            return [], False, "断点数超过65535"
+        table = sorted([float(v) for v in row[:4]] for row in rows)
+        xs = [row[0] for row in table]
+        if any(b <= a for a, b in zip(xs, xs[1:])):
+            return [], False, "调度变量有重复的断点"
+        if any(min(row[1:]) < 0 for row in table):
+            return [], False, "增益不能为负"
+        step = (xs[-1] - xs[0]) / (len(xs) - 1)
+        uniform = all(abs(x - (xs[0] + i * step)) <= 1e-9 * (xs[-1] - xs[0]) for i, x in enumerate(xs))
+        return table, uniform, None
+
+    def _get_schedule_table_code(self, instance: Dict[str, Any], table: List[List[float]], uniform: bool) -> List[str]:
+        """
+        单个实例的断点表定义
+
+        离散增益和各段的 1/dx 写成常量表达式, 由编译器按生成的数据类型折叠,
+        断点处的值与 SetTunings 在运行时的换算逐位相同。
+        """
+        config = self.data_model.code_config
+        sfx = config[self.data_model.C_FLOAT_SUFFIX]
+        data_type = config[self.data_model.C_DATA_TYPE]
+        prefix = config[self.data_model.C_FUNC_PREFIX]
+        name = instance['name']
+        n = len(table)
+
+        def lit(value: float) -> str:
+            return f"{value}{sfx}"
+
+        ts = lit(max(instance['params'][self.data_model.P_SAMPLE_TIME], 1e-6))
+        xs = [lit(row[0]) for row in table]
+        lines = [f"static const {data_type} {name}_schedule_x[{n}] = {{ {', '.join(xs)} }};",
+                 f"static const {data_type} {name}_schedule_inv_dx[{n - 1}] = {{"]
+        lines += [f"    1.0{sfx} / ({b} - {a})," for a, b in zip(xs, xs[1:])]
+        lines += ["};", f"static const {prefix}_ScheduleGainsTypeDef {name}_schedule_gains[{n}] = {{",
+                  "    /* Kp, Ki(离散), Kd(离散), Ki_continuous, Kd_continuous */"]
+        for _, kp, ki, kd in table:
+            lines.append(f"    {{ {lit(kp)}, {lit(ki)} * {ts}, {lit(kd)} / {ts}, {lit(ki)}, {lit(kd)} }},")
+        inv_step = f"{float(n - 1)}{sfx} / ({xs[-1]} - {xs[0]})" if uniform else f"0.0{sfx}"
+        lines += ["};",
+                  f"const {prefix}_ScheduleTypeDef {name}_schedule = {{",
+                  f"    .x = {name}_schedule_x,",
+                  f"    .inv_dx = {name}_schedule_inv_dx,",
+                  f"    .gains = {name}_schedule_gains,",
+                  f"    .inv_step = {inv_step},",
+                  f"    .count = {n},",
+                  f"    .uniform = {1 if uniform else 0},",
+                  "};"]
+        return lines
+
+    def _get_schedule_replacements(self) -> Dict[str, str]:
+        """增益调度模板的附加替换"""
+        config = self.data_model.code_config
+        prefix = config[self.data_model.C_FUNC_PREFIX]
+        schedule_header, schedule_source = self.schedule_file_names(config[self.data_model.C_HEADER_NAME])
+        declarations, definitions = [], []
+        for instance in self.data_model.pid_instances:
+            table, uniform, error = self.schedule_table(instance)
+            if error:
+                declarations.append(f"/* 增益调度设置错误, 未生成: {instance['name']}: {error} */")
+            elif table:
+                lookup = "等间距直接索引" if uniform else "二分查找"
+                declarations.append(f"extern const {prefix}_ScheduleTypeDef {instance['name']}_schedule;"
+                                    f"    /* {len(table)}个断点, {lookup} */")
+                definitions.append("\n".join(self._get_schedule_table_code(instance, table, uniform)))
+        return {
+            '{{SCHEDULE_NAME}}': f"{prefix}_ScheduleTypeDef",
+            '{{SCHEDULE_GAINS_NAME}}': f"{prefix}_ScheduleGainsTypeDef",
+            '{{SCHEDULE_HEADER_NAME}}': schedule_header,
+            '{{SCHEDULE_SOURCE_NAME}}': schedule_source,
+            '{{SCHEDULE_DECLARATIONS}}': "\n".join(declarations) or "/* 未配置增益调度实例 */",
+            '{{SCHEDULE_TABLES}}': "\n\n".join(definitions) or "/* 未配置增益调度实例 */",
+        }
+
+    def generate_schedule_header_code(self) -> str:
+        """生成增益调度头文件代码"""
+        template_path = self.template_dir / "pid_schedule_template.h"
+        if not template_path.exists():
+            return "// Error: Schedule header template not found."
+        return self._generate_from_template(template_path, self._get_schedule_replacements())
+
+    def generate_schedule_source_code(self) -> str:
+        """生成增益调度源文件代码"""
+        template_path = self.template_dir / "pid_schedule_template.c"
+        if not template_path.exists():
+            return "// Error: Schedule source template not found."
+        return self._generate_from_template(template_path, self._get_schedule_replacements())
+
+    def generate_extra_files(self) -> Dict[str, str]:
+        """
+        按代码配置中启用的可选模块生成附加文件
+
+        Returns:
+            Dict[str, str]: 文件名 -> 代码, 面板预览/导出和write_library共用
+        """
+        config = self.data_model.code_config
+        extra = {}
+        if config.get(self.data_model.C_GEN_BANK):
+            bank_header, bank_source = self.bank_file_names(config[self.data_model.C_HEADER_NAME])
+            extra[bank_header] = self.generate_bank_header_code()
+            extra[bank_source] = self.generate_bank_source_code()
+        format_name = config.get(self.data_model.C_FIXED_FORMAT)
+        if format_name:
+            fixed_header, fixed_source = self.fixed_file_names(config[self.data_model.C_HEADER_NAME], format_name)
+            extra[fixed_header] = self.generate_fixed_header_code()
+            extra[fixed_source] = self.generate_fixed_source_code()
+        if config.get(self.data_model.C_GEN_SPECIALIZED):
+            spec_header, spec_source = self.spec_file_names(config[self.data_model.C_HEADER_NAME])
+            extra[spec_header] = self.generate_spec_header_code()
+            extra[spec_source] = self.generate_spec_source_code()
+        has_cascade = any(inst['params'].get(self.data_model.P_CASCADE_INNER)
+                          for inst in self.data_model.pid_instances)
+        if config.get(self.data_model.C_GEN_CASCADE) or has_cascade:
+            cascade_header, cascade_source = self.cascade_file_names(config[self.data_model.C_HEADER_NAME])
+            extra[cascade_header] = self.generate_cascade_header_code()
+            extra[cascade_source] = self.generate_cascade_source_code()
+        if config.get(self.data_model.C_GEN_SPLIT):
+            split_header, split_source = self.split_file_names(config[self.data_model.C_HEADER_NAME])
+            extra[split_header] = self.generate_split_header_code()
+            extra[split_source] = self.generate_split_source_code()
+        if config.get(self.data_model.C_GEN_AUTOTUNE):
+            autotune_header, autotune_source = self.autotune_file_names(config[self.data_model.C_HEADER_NAME])
+            extra[autotune_header] = self.generate_autotune_header_code()
+            extra[autotune_source] = self.generate_autotune_source_code()
+        has_schedule = any(inst['params'].get(self.data_model.P_SCHEDULE)
+                           for inst in self.data_model.pid_instances)
+        if config.get(self.data_model.C_GEN_SCHEDULE) or has_schedule:
+            schedule_header, schedule_source = self.schedule_file_names(config[self.data_model.C_HEADER_NAME])
+            extra[schedule_header] = self.generate_schedule_header_code()
+            extra[schedule_source] = self.generate_schedule_source_code()
+        if config.get(self.data_model.C_GEN_TELEMETRY):
+            telemetry_header, telemetry_source = self.telemetry_file_names(config[self.data_model.C_HEADER_NAME])
+            extra[telemetry_header] = self.generate_telemetry_header_code()
+            extra[telemetry_source] = self.generate_telemetry_source_code()
+        return extra
+
+    def generate_main_code(self) -> str:
+        """生成主函数示例代码"""
+        template_path = self.template_dir / "user_main_template.c"
+        if not template_path.exists():
+            return "// Error: Main template not found."
+        return self._generate_main_from_template(template_path)
+    
+    def _generate_from_template(self, template_path: Path,
+                                extra_replacements: Optional[Dict[str, str]] = None) -> str:
+        """从模板生成代码（库文件）"""
+        try:
+            template_content = template_path.read_text(encoding='utf-8')
+            
+            # 使用默认参数填充模板
+            default_params = self.data_model._get_default_pid_params()
+            replacements = self._get_template_replacements(default_params)
+            replacements.update(extra_replacements or {})
+            
+            for key, value in replacements.items():
+                template_content = template_content.replace(key, str(value))
+            
+            # 处理注释
+            if not self.data_model.code_config[self.data_model.C_INC_COMMENTS]:
+                template_content = self._remove_comments(template_content)
+            
+            return template_content
+        except Exception as e:
+            return f"// Error generating from template {template_path.name}: {e}"
+    
+    def _generate_main_from_template(self, template_path: Path) -> str:
+        """从模板生成主函数代码"""
+        try:
+            template_content = template_path.read_text(encoding='utf-8')
+            
+            # 全局替换
+            global_replacements = {
+                '{{HEADER_NAME}}': self.data_model.code_config[self.data_model.C_HEADER_NAME],
+                '{{STRUCT_NAME}}': self.data_model.code_config[self.data_model.C_STRUCT_NAME],
+                '{{FUNCTION_PREFIX}}': self.data_model.code_config[self.data_model.C_FUNC_PREFIX],
+                '{{DATA_TYPE}}': self.data_model.code_config[self.data_model.C_DATA_TYPE],
+                '{{TIMESTAMP}}': datetime.now().strftime("%Y-%m-%d %H:%M:%S"),
+                '{{SFX}}': self.data_model.code_config[self.data_model.C_FLOAT_SUFFIX]
+            }
+            
+            for key, value in global_replacements.items():
+                template_content = template_content.replace(key, str(value))
+            
+            # 生成实例相关代码
+            declarations = self._generate_instance_declarations()
+            initializations = self._generate_instance_initializations()
+            computations = self._generate_instance_computations()
+            
+            template_content = template_content.replace('{{PID_INSTANCE_DECLARATIONS}}', declarations)
+            template_content = template_content.replace('{{PID_INSTANCE_INITIALIZATIONS}}', initializations)
+            template_content = template_content.replace('{{PID_EXAMPLE_COMPUTATIONS}}', computations)
+            
+            return template_content
+        except Exception as e:
+            return f"// Error generating main code: {e}"
+    
+    def _get_template_replacements(self, params: Dict[str, Any]) -> Dict[str, str]:
+        """获取模板替换字典"""
+        config = self.data_model.code_config
+        sfx = config[self.data_model.C_FLOAT_SUFFIX]
+        bank_header, bank_source = self.bank_file_names(config[self.data_model.C_HEADER_NAME])
+        
+        return {
+            '{{STRUCT_NAME}}': config[self.data_model.C_STRUCT_NAME],
+            '{{BANK_NAME}}': f"{config[self.data_model.C_FUNC_PREFIX]}_BankTypeDef",
+            '{{BANK_HEADER_NAME}}': bank_header,
+            '{{BANK_SOURCE_NAME}}': bank_source,
+            '{{BANK_CAPACITY}}': str(int(config[self.data_model.C_BANK_CAPACITY])),
+            '{{FUNCTION_PREFIX}}': config[self.data_model.C_FUNC_PREFIX],
+            '{{DATA_TYPE}}': config[self.data_model.C_DATA_TYPE],
+            '{{HEADER_NAME}}': config[self.data_model.C_HEADER_NAME],
+            '{{TIMESTAMP}}': datetime.now().strftime("%Y-%m-%d %H:%M:%S"),
+            '{{SFX}}': sfx,
+            '{{KFF_DEFAULT}}': f"{params[self.data_model.P_KFF]}{sfx}",
+            '{{FF_WEIGHT_DEFAULT}}': f"{params[self.data_model.P_FF_WEIGHT]}{sfx}",
+            '{{OUTPUT_LIMIT_DEFAULT}}': f"{params[self.data_model.P_MAX_OUT]}{sfx}",
+            '{{INTEGRAL_LIMIT_DEFAULT}}': f"{params[self.data_model.P_INT_LIM]}{sfx}",
+            '{{OUTPUT_RAMP_DEFAULT}}': f"{params[self.data_model.P_OUT_RAMP]}{sfx}",
+            '{{DEADBAND_DEFAULT}}': f"{params[self.data_model.P_DEADBAND]}{sfx}",
+            '{{INTEGRAL_SEPARATION_THRESHOLD_DEFAULT}}': f"{params[self.data_model.P_INT_SEP_THRESH]}{sfx}",
+            '{{D_FILTER_COEF_DEFAULT}}': f"{params[self.data_model.P_D_FILTER]}{sfx}",
+            '{{INPUT_FILTER_COEF_DEFAULT}}': f"{params[self.data_model.P_IN_FILTER]}{sfx}",
+            '{{SETPOINT_FILTER_COEF_DEFAULT}}': f"{params[self.data_model.P_SP_FILTER]}{sfx}",
+            '{{ADAPTIVE_ENABLE}}': 'false',
+            '{{FUZZY_ENABLE}}': 'false',
+            '{{ADAPTIVE_KP_MIN_DEFAULT}}': f"{params[self.data_model.P_ADAPTIVE_KP_MIN]}{sfx}",
+            '{{ADAPTIVE_KP_MAX_DEFAULT}}': f"{params[self.data_model.P_ADAPTIVE_KP_MAX]}{sfx}",
+            '{{ADAPTIVE_KI_MIN_DEFAULT}}': f"{params[self.data_model.P_ADAPTIVE_KI_MIN]}{sfx}",
+            '{{ADAPTIVE_KI_MAX_DEFAULT}}': f"{params[self.data_model.P_ADAPTIVE_KI_MAX]}{sfx}",
+            '{{ADAPTIVE_KD_MIN_DEFAULT}}': f"{params[self.data_model.P_ADAPTIVE_KD_MIN]}{sfx}",
+            '{{ADAPTIVE_KD_MAX_DEFAULT}}': f"{params[self.data_model.P_ADAPTIVE_KD_MAX]}{sfx}",
+            '{{FUZZY_ERROR_RANGE_DEFAULT}}': f"{params[self.data_model.P_FUZZY_ERR_RANGE]}{sfx}",
+            '{{FUZZY_DERROR_RANGE_DEFAULT}}': f"{params[self.data_model.P_FUZZY_DERR_RANGE]}{sfx}",
+        }
+    
+    def _generate_instance_declarations(self) -> str:
+        """生成实例声明代码"""
+        if not self.data_model.pid_instances:
+            return "    // 未配置任何PID实例"
+        
+        struct_name = self.data_model.code_config[self.data_model.C_STRUCT_NAME]
+        declarations = []
+        for instance in self.data_model.pid_instances:
+            declarations.append(f"    {struct_name} {instance['name']};")
+        return "\n".join(declarations)
+    
+    def _generate_instance_initializations(self) -> str:
+        """生成实例初始化代码"""
+        if not self.data_model.pid_instances:
+            return "    // 未配置任何PID实例，无初始化代码生成。"
+        
+        init_lines = []
+        for instance in self.data_model.pid_instances:
+            init_lines.extend(self._get_instance_init_code(instance))
+        return "\n".join(init_lines)
+    
+    def _generate_instance_computations(self) -> str:
+        """生成实例计算示例代码"""
+        if not self.data_model.pid_instances:
+            return "    // 未配置任何PID实例，无示例代码生成。"
+        
+        comp_lines = []
+        for instance in self.data_model.pid_instances:
+            comp_lines.extend(self._get_instance_sim_code(instance))
+        return "\n".join(comp_lines)
+    
+    def _get_instance_init_code(self, instance: Dict[str, Any]) -> List[str]:
+        """为单个实例生成初始化代码"""
+        name = instance['name']
+        params = instance['params']
+        config = self.data_model.code_config
+        sfx = config[self.data_model.C_FLOAT_SUFFIX]
+        prefix = config[self.data_model.C_FUNC_PREFIX]
+        sample_time = max(params[self.data_model.P_SAMPLE_TIME], 1e-6)
+        
+        lines = [f"    // 初始化PID实例: {name}"]
+        lines.append(f"    {prefix}_Init(&{name}, {params[self.data_model.P_KP]}{sfx}, {params[self.data_model.P_KI]}{sfx}, {params[self.data_model.P_KD]}{sfx}, {sample_time}{sfx});")
+        lines.append(f"    {prefix}_SetOutputLimits(&{name}, {params[self.data_model.P_MAX_OUT]}{sfx});")
+        lines.append(f"    {prefix}_SetIntegralLimits(&{name}, {params[self.data_model.P_INT_LIM]}{sfx});")
+        
+        # 可选参数设置
+        if params[self.data_model.P_OUT_RAMP] > 0:
+            lines.append(f"    {prefix}_SetOutputRamp(&{name}, {params[self.data_model.P_OUT_RAMP]}{sfx});")
+        if params[self.data_model.P_DEADBAND] > 0:
+            lines.append(f"    {prefix}_SetDeadband(&{name}, {params[self.data_model.P_DEADBAND]}{sfx});")
+        if params[self.data_model.P_INT_SEP_THRESH] < 1000.0:
+            lines.append(f"    {prefix}_SetIntegralSeparationThreshold(&{name}, {params[self.data_model.P_INT_SEP_THRESH]}{sfx});")
+        if params[self.data_model.P_D_FILTER] > 0:
+            lines.append(f"    {prefix}_SetDFilter(&{name}, {params[self.data_model.P_D_FILTER]}{sfx});")
+        if params[self.data_model.P_IN_FILTER] > 0:
+            lines.append(f"    {prefix}_SetInputFilter(&{name}, {params[self.data_model.P_IN_FILTER]}{sfx});")
+        if params[self.data_model.P_SP_FILTER] > 0:
+            lines.append(f"    {prefix}_SetSetpointFilter(&{name}, {params[self.data_model.P_SP_FILTER]}{sfx});")
+        if params[self.data_model.P_KFF] != 0 or params[self.data_model.P_FF_WEIGHT] != 1.0:
+            lines.append(f"    {prefix}_SetFeedForwardParams(&{name}, {params[self.data_model.P_KFF]}{sfx}, {params[self.data_model.P_FF_WEIGHT]}{sfx});")
+        
+        # PID类型和工作模式
+        pid_type_map = {"standard": "PID_TYPE_STANDARD", "pi_d": "PID_TYPE_PI_D", "i_pd": "PID_TYPE_I_PD"}
+        work_mode_map = {"position": "PID_MODE_POSITION", "velocity": "PID_MODE_VELOCITY"}
+        lines.append(f"    {prefix}_SetType(&{name}, {pid_type_map[params[self.data_model.P_PID_TYPE]]});")
+        lines.append(f"    {prefix}_SetWorkMode(&{name}, {work_mode_map[params[self.data_model.P_WORK_MODE]]});")
+        
+        lines.append(f"    printf(\"Initialized PID: {name} (Kp=%.4f, Ki_cont=%.4f, Kd_cont=%.4f, Ts=%.4f)\\n\", (double){params[self.data_model.P_KP]}{sfx}, (double){params[self.data_model.P_KI]}{sfx}, (double){params[self.data_model.P_KD]}{sfx}, (double){sample_time}{sfx});")
+        lines.append("")
+        return lines
+    
+    def _get_instance_sim_code(self, instance: Dict[str, Any]) -> List[str]:
+        """为单个实例生成仿真代码"""
+        name = instance['name']
+        params = instance['params']
+        config = self.data_model.code_config
+        sfx = config[self.data_model.C_FLOAT_SUFFIX]
+        prefix = config[self.data_model.C_FUNC_PREFIX]
+        data_type = config[self.data_model.C_DATA_TYPE]
+        sample_time = max(params[self.data_model.P_SAMPLE_TIME], 1e-6)
+        
+        return [
+            f"    // 示例计算 for {name}",
+            f"    {data_type} {name}_setpoint = 50.0{sfx};",
+            f"    {data_type} {name}_measurement = 0.0{sfx};",
+            f"    printf(\"\\n--- Running simulation for {name} ---\\n\");",
+            "    for (int j = 0; j < 5; ++j) {",
+            f"        {data_type} {name}_output = {prefix}_Compute(&{name}, {name}_setpoint, {name}_measurement);",
+            f"        {name}_measurement = simulate_system_response({name}_measurement, {name}_output, {sample_time}{sfx});",
+            f"        printf(\"  {name}: Step %d, SP=%.2f, PV=%.2f, Out=%.2f\\n\", j+1, (double){name}_setpoint, (double){name}_measurement, (double){name}_output);",
+            "    }", ""
+        ]
+    
+    def _remove_comments(self, content: str) -> str:
+        """移除代码中的注释"""
+        # 移除多行注释
+        content = re.sub(r'/\*.*?\*/', '', content, flags=re.DOTALL)
+        # 移除单行注释
+        content = re.sub(r'//[^\n]*', '', content)
+        # 清理多余的空行
+        content = re.sub(r'\n\s*\n', '\n\n', content)
+        return content
+
+
+def write_library(out_dir: Path, data_model: Optional[PIDDataModel] = None,
+                  with_main: bool = False) -> List[Path]:
+    """
+    按当前代码配置把头文件/源文件(可选示例main)及启用的附加模块写入out_dir
+
+    Returns:
+        List[Path]: 生成的文件路径
+    """
+    data_model = data_model or PIDDataModel()
+    generator = PIDCodeGenerator(data_model)
+    header_name = data_model.code_config[PIDDataModel.C_HEADER_NAME]
+    outputs = {
+        header_name: generator.generate_header_code(),
+        f"{Path(header_name).stem}.c": generator.generate_source_code(),
+    }
+    if with_main:
+        outputs[f"{Path(header_name).stem}_main.c"] = generator.generate_main_code()
+    outputs.update(generator.generate_extra_files())
+
+    for name, content in outputs.items():
+        if content.startswith("// Error"):
+            raise RuntimeError(f"生成 {name} 失败: {content}")
+
+    out_dir.mkdir(parents=True, exist_ok=True)
+    written = []
+    for name, content in outputs.items():
+        path = out_dir / name
+        path.write_text(content, encoding='utf-8')
+        written.append(path)
+    return written
+
+
+def main(argv: Optional[List[str]] = None) -> int:
+    parser = argparse.ArgumentParser(description="从模板生成PID控制器C代码")
+    parser.add_argument("--out-dir", required=True, help="输出目录")
+    parser.add_argument("--header", default="pid.h", help="头文件名(源文件名随之确定)")
+    parser.add_argument("--struct", default="PID_HandleTypeDef", help="结构体类型名")
+    parser.add_argument("--prefix", default="PID", help="函数名前缀")
+    parser.add_argument("--double", action="store_true", help="使用double而非float")
+    parser.add_argument("--no-comments", action="store_true", help="去除生成代码中的注释")
+    parser.add_argument("--main", action="store_true", help="同时生成示例main文件")
+    parser.add_argument("--bank", action="store_true",
+                        help="同时生成控制器组(数组结构体、批量向量化计算)文件")
+    parser.add_argument("--bank-capacity", type=int, default=24, help="控制器组最大通道数")
+    parser.add_argument("--fixed", choices=sorted(pid_fixed.FIXED_FORMATS), default="",
+                        help="同时生成定点(Q15/Q31)版本, 供无FPU的内核使用")
+    parser.add_argument("--full-scale", type=float, default=200.0,
+                        help="定点版本中Q格式1.0对应的物理量")
+    parser.add_argument("--specialize", action="store_true",
+                        help="同时生成按实例配置特化的计算函数(未启用的功能不生成)")
+    parser.add_argument("--cascade", action="store_true",
+                        help="同时生成串级控制器文件(面板中设置了串级内环时自动生成)")
+    parser.add_argument("--split", action="store_true",
+                        help="同时生成冷热分离布局(只读配置+紧凑运行状态)文件")
+    parser.add_argument("--sweep", action="store_true",
+                        help="同时生成主机端增益扫描仿真程序(隐含--bank)")
+    parser.add_argument("--autotune", action="store_true",
+                        help="同时生成继电器自整定模块(进度经YJ协议发送)")
+    parser.add_argument("--schedule", action="store_true",
+                        help="同时生成增益调度文件(面板中设置了调度表时自动生成)")
+    parser.add_argument("--telemetry", action="store_true",
+                        help="同时生成高速遥测模块(批量经YJ协议发送)")
+    args = parser.parse_args(argv)
+    if args.bank_capacity <= 0:
+        parser.error("--bank-capacity 必须为正数")
+    if args.full_scale <= 0:
+        parser.error("--full-scale 必须为正数")
+
+    data_model = PIDDataModel()
+    data_model.update_code_config({
+        PIDDataModel.C_HEADER_NAME: args.header,
+        PIDDataModel.C_STRUCT_NAME: args.struct,
+        PIDDataModel.C_FUNC_PREFIX: args.prefix,
+        PIDDataModel.C_USE_FLOAT: not args.double,
+        PIDDataModel.C_INC_COMMENTS: not args.no_comments,
+        PIDDataModel.C_GEN_BANK: args.bank or args.sweep,
+        PIDDataModel.C_BANK_CAPACITY: args.bank_capacity,
+        PIDDataModel.C_FIXED_FORMAT: args.fixed,
+        PIDDataModel.C_FIXED_FULL_SCALE: args.full_scale,
+        PIDDataModel.C_GEN_SPECIALIZED: args.specialize,
+        PIDDataModel.C_GEN_CASCADE: args.cascade,
+        PIDDataModel.C_GEN_SPLIT: args.split,
+        PIDDataModel.C_GEN_AUTOTUNE: args.autotune,
+        PIDDataModel.C_GEN_SCHEDULE: args.schedule,
+        PIDDataModel.C_GEN_TELEMETRY: args.telemetry,
+    })
+    if args.main or args.fixed or args.specialize or args.split or args.sweep:
+        data_model.add_instance("pid_example")
+
+    try:
+        paths = write_library(Path(args.out_dir), data_model, with_main=args.main)
+        if args.sweep:
+            sweep_code = PIDCodeGenerator(data_model).generate_sweep_source_code()
+            if sweep_code.startswith("// Error"):
+                raise RuntimeError(f"生成增益扫描程序失败: {sweep_code}")
+            sweep_path = Path(args.out_dir) / PIDCodeGenerator.sweep_file_name(args.header)
+            sweep_path.write_text(sweep_code, encoding='utf-8')
+            paths.append(sweep_path)
+    except (RuntimeError, OSError) as e:
+        print(f"错误: {e}", file=sys.stderr)
+        return 1
+    for path in paths:
+        print(path)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
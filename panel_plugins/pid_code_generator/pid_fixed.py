@@ -0,0 +1,330 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+PID定点化(Q15/Q31)辅助模块(不依赖Qt)
+
+- 把连续域参数按采样时间换算为离散增益(Ki·Ts, Kd/Ts)并量化为"尾数+指数"形式
+- 与 templates/pid_fixed_template.c 逐位一致的整数模型, 用于生成误差报告和测试
+- 双精度浮点参考实现(同一控制律), 闭环阶跃仿真对比两者输出
+
+定点格式(b为小数位数, Q15时b=15, Q31时b=31):
+- 信号(设定值/测量值/输出)为窄类型整数, 数值 = q / 2^b * 满量程
+- 增益 = mant * 2^(exp-b), mant为窄类型, 指数exp在[-b, b-1]
+- 积分累加器为宽类型 Q(2b), 比输出多b位小数, 小的Ki·Ts也不会丢失增量
+"""
+
+import math
+from dataclasses import dataclass
+from typing import Dict, Any, List, Optional, Tuple
+
+FIXED_FORMATS = {
+    # 格式: (小数位数b, 窄类型, 宽类型)
+    "q15": (15, "int16_t", "int32_t"),
+    "q31": (31, "int32_t", "int64_t"),
+}
+
+PID_TYPES = {"standard": 0, "pi_d": 1, "i_pd": 2}
+
+
+@dataclass
+class FixedGain:
+    """量化后的增益: 数值 = mant * 2^(exp - bits)"""
+    mant: int
+    exp: int
+    bits: int
+
+    @property
+    def value(self) -> float:
+        return self.mant * 2.0 ** (self.exp - self.bits)
+
+
+class FixedFormat:
+    """一种Q格式下的量化与饱和运算, 与生成的C代码逐位一致"""
+
+    def __init__(self, name: str):
+        if name not in FIXED_FORMATS:
+            raise ValueError(f"不支持的定点格式: {name}")
+        self.name = name
+        self.bits, self.narrow_type, self.wide_type = FIXED_FORMATS[name]
+        self.q_max = (1 << self.bits) - 1
+        self.q_min = -(1 << self.bits)
+        wide_bits = 2 * self.bits + 2
+        self.w_max = (1 << (wide_bits - 1)) - 1
+        self.w_min = -(1 << (wide_bits - 1))
+
+    # --- 量化 ---
+
+    def quantize(self, value: float, full_scale: float) -> int:
+        """物理量 -> 窄类型整数(饱和)"""
+        return self.sat(round(value / full_scale * (1 << self.bits)))
+
+    def to_float(self, q: int, full_scale: float) -> float:
+        return q * full_scale / (1 << self.bits)
+
+    def quantize_gain(self, value: float) -> FixedGain:
+        """选取使尾数落在窄类型范围内的最小指数, 尾数保留最多有效位"""
+        b = self.bits
+        if value == 0.0:
+            return FixedGain(0, -b, b)
+        exp = max(-b, math.frexp(abs(value))[1])
+        while True:
+            if exp > b - 1:
+                raise ValueError(f"增益 {value} 超出{self.name}格式可表示的范围")
+            mant = round(value * 2.0 ** (b - exp))
+            if abs(mant) <= self.q_max:
+                return FixedGain(mant, exp, b)
+            exp += 1
+
+    def quantize_fraction(self, value: float) -> int:
+        """[0, 1) 范围的系数(滤波系数) -> Q(b)"""
+        return min(self.q_max, max(0, round(value * (1 << self.bits))))
+
+    # --- 整数运算 ---
+
+    def sat(self, v: int) -> int:
+        return self.q_max if v > self.q_max else self.q_min if v < self.q_min else v
+
+    @staticmethod
+    def rshift(v: int, s: int) -> int:
+        """带四舍五入的算术右移(s >= 1)"""
+        return (v + (1 << (s - 1))) >> s
+
+    def lshift_sat(self, v: int, s: int) -> int:
+        if s == 0:
+            return v
+        if v > (self.w_max >> s):
+            return self.w_max
+        if v < (self.w_min >> s):
+            return self.w_min
+        return v << s
+
+    def mul_gain(self, g: FixedGain, x: int) -> int:
+        """增益乘信号, 结果为宽类型的Q(b)值(未饱和)"""
+        return self.rshift(g.mant * x, self.bits - g.exp)
+
+
+@dataclass
+class FixedConfig:
+    """单个实例的定点参数, 字段与生成的 ConfigTypeDef 对应"""
+    kp: FixedGain
+    ki: FixedGain
+    kd: FixedGain
+    output_limit: int
+    integral_limit: int
+    deadband: int
+    integral_separation: int
+    d_filter_alpha: int
+    pid_type: int
+    velocity: bool
+
+
+def discrete_gains(params: Dict[str, Any]) -> Tuple[float, float, float]:
+    """连续域参数 -> 离散增益 (Kp, Ki·Ts, Kd/Ts)"""
+    ts = max(params["sample_time"], 1e-6)
+    return params["kp"], params["ki"] * ts, params["kd"] / ts
+
+
+def make_config(fmt: FixedFormat, params: Dict[str, Any], full_scale: float) -> FixedConfig:
+    """按PIDDataModel的实例参数生成定点参数"""
+    kp, ki, kd = discrete_gains(params)
+    output_limit = min(abs(params["max_output"]), abs(params["min_output"]))
+    separation = abs(params["integral_separation_threshold"])
+    # 阈值达到满量程时积分分离永不生效, 用比任何误差都大的值表示
+    separation_q = (fmt.q_max + 2) if separation >= full_scale else fmt.quantize(separation, full_scale)
+    return FixedConfig(
+        kp=fmt.quantize_gain(kp),
+        ki=fmt.quantize_gain(ki),
+        kd=fmt.quantize_gain(kd),
+        output_limit=fmt.quantize(output_limit, full_scale),
+        integral_limit=fmt.quantize(abs(params["integral_limit"]), full_scale),
+        deadband=fmt.quantize(abs(params["deadband"]), full_scale),
+        integral_separation=separation_q,
+        d_filter_alpha=fmt.quantize_fraction(params["d_filter_coef"]),
+        pid_type=PID_TYPES[params["pid_type"]],
+        velocity=params["work_mode"] == "velocity",
+    )
+
+
+def unsupported_features(params: Dict[str, Any]) -> List[str]:
+    """定点版本未实现、但实例中启用了的功能"""
+    features = []
+    if params["kff"] != 0.0:
+        features.append("前馈")
+    if params["output_ramp"] > 0.0:
+        features.append("输出斜率限制")
+    if params["input_filter_coef"] > 0.0:
+        features.append("测量值滤波")
+    if params["setpoint_filter_coef"] > 0.0:
+        features.append("设定值滤波")
+    return features
+
+
+class FixedPID:
+    """与生成的 _Compute 逐位一致的定点控制器模型"""
+
+    def __init__(self, fmt: FixedFormat, config: FixedConfig):
+        self.fmt = fmt
+        self.cfg = config
+        self.integral = 0
+        self.prev_error = 0
+        self.prev_measure = 0
+        self.filtered_d = 0
+        self.prev_output = 0
+        self.output = 0
+
+    def compute(self, setpoint: int, measure: int) -> int:
+        fmt, cfg, b = self.fmt, self.cfg, self.fmt.bits
+
+        error = fmt.sat(setpoint - measure)
+        if abs(error) < cfg.deadband:
+            error = 0
+
+        p_term = fmt.mul_gain(cfg.kp, -measure if cfg.pid_type == 2 else error)
+
+        if abs(error) < cfg.integral_separation:
+            prod = cfg.ki.mant * error
+            inc = fmt.lshift_sat(prod, cfg.ki.exp) if cfg.ki.exp >= 0 else fmt.rshift(prod, -cfg.ki.exp)
+            bound = 1 << (2 * b)
+            inc = max(-bound, min(bound, inc))
+            limit = cfg.integral_limit << b
+            self.integral = max(-limit, min(limit, self.integral + inc))
+        i_term = fmt.rshift(self.integral, b)
+
+        diff = (error - self.prev_error) if cfg.pid_type == 0 else -(measure - self.prev_measure)
+        diff = fmt.sat(diff)
+        if cfg.d_filter_alpha:
+            self.filtered_d = fmt.sat(self.filtered_d + fmt.rshift(cfg.d_filter_alpha * (diff - self.filtered_d), b))
+        else:
+            self.filtered_d = diff
+        d_term = fmt.mul_gain(cfg.kd, self.filtered_d)
+
+        total = p_term + i_term + d_term
+        computed = max(-cfg.output_limit, min(cfg.output_limit, total))
+
+        self.prev_error = error
+        self.prev_measure = measure
+        self.output = fmt.sat(computed - self.prev_output) if cfg.velocity else computed
+        self.prev_output = computed
+        return self.output
+
+
+class FloatPID:
+    """同一控制律的双精度参考实现"""
+
+    def __init__(self, params: Dict[str, Any]):
+        self.kp, self.ki, self.kd = discrete_gains(params)
+        self.output_limit = min(abs(params["max_output"]), abs(params["min_output"]))
+        self.integral_limit = abs(params["integral_limit"])
+        self.deadband = abs(params["deadband"])
+        self.separation = abs(params["integral_separation_threshold"])
+        self.alpha = params["d_filter_coef"]
+        self.pid_type = PID_TYPES[params["pid_type"]]
+        self.velocity = params["work_mode"] == "velocity"
+        self.integral = self.prev_error = self.prev_measure = self.filtered_d = self.prev_output = 0.0
+
+    def compute(self, setpoint: float, measure: float) -> float:
+        error = setpoint - measure
+        if abs(error) < self.deadband:
+            error = 0.0
+        p_term = self.kp * (-measure if self.pid_type == 2 else error)
+        if abs(error) < self.separation:
+            self.integral = max(-self.integral_limit, min(self.integral_limit, self.integral + self.ki * error))
+        diff = (error - self.prev_error) if self.pid_type == 0 else -(measure - self.prev_measure)
+        self.filtered_d = self.filtered_d + self.alpha * (diff - self.filtered_d) if self.alpha > 0 else diff
+        computed = max(-self.output_limit, min(self.output_limit, p_term + self.integral + self.kd * self.filtered_d))
+        self.prev_error = error
+        self.prev_measure = measure
+        output = computed - self.prev_output if self.velocity else computed
+        self.prev_output = computed
+        return output
+
+
+def simulate_step_response(params: Dict[str, Any], fmt: FixedFormat, config: FixedConfig, full_scale: float,
+              steps: int) -> Dict[str, float]:
+    """
+    对浮点参考和定点模型分别做闭环阶跃仿真(一阶惯性对象, 时间常数为20个采样周期),
+    对象本身按浮点计算, 定点控制器看到的是量化后的测量值
+    """
+    ts = max(params["sample_time"], 1e-6)
+    alpha = ts / (20.0 * ts + ts)
+    output_limit = min(abs(params["max_output"]), abs(params["min_output"]))
+    setpoint = 0.5 * min(output_limit, full_scale)
+    velocity = params["work_mode"] == "velocity"
+
+    ref, fixed = FloatPID(params), FixedPID(fmt, config)
+    y_ref = y_fix = 0.0
+    u_ref_abs = u_fix_abs = 0.0
+    max_err = sq_err = 0.0
+    for _ in range(steps):
+        u_ref = ref.compute(setpoint, y_ref)
+        u_fix = fmt.to_float(fixed.compute(fmt.quantize(setpoint, full_scale), fmt.quantize(y_fix, full_scale)),
+                             full_scale)
+        # 速度式输出是增量, 对象输入取累加值
+        u_ref_abs = u_ref_abs + u_ref if velocity else u_ref
+        u_fix_abs = u_fix_abs + u_fix if velocity else u_fix
+        err = abs(u_ref - u_fix)
+        max_err = max(max_err, err)
+        sq_err += err * err
+        y_ref += alpha * (u_ref_abs - y_ref)
+        y_fix += alpha * (u_fix_abs - y_fix)
+    return {
+        "max_error": max_err,
+        "rms_error": math.sqrt(sq_err / steps),
+        "final_ref": setpoint - y_ref,
+        "final_fixed": setpoint - y_fix,
+    }
+
+
+def error_report(instances: List[Dict[str, Any]], format_name: str, full_scale: float,
+                 steps: int = 1000) -> str:
+    """生成各实例的量化误差报告(纯文本, 每行不带注释前缀)"""
+    fmt = FixedFormat(format_name)
+    lsb = full_scale / (1 << fmt.bits)
+    lines = [f"{format_name.upper()} 定点误差报告 (满量程 ±{full_scale:g}, 1 LSB = {lsb:.3g})"]
+    if not instances:
+        lines.append("未配置任何PID实例。")
+        return "\n".join(lines)
+
+    for instance in instances:
+        params = instance["params"]
+        try:
+            config = make_config(fmt, params, full_scale)
+        except ValueError as e:
+            lines.append(f"实例 {instance['name']}: {e}")
+            continue
+        lines.append(f"实例 {instance['name']}:")
+        for label, exact, gain in zip(("Kp   ", "Ki·Ts", "Kd/Ts"), discrete_gains(params),
+                                      (config.kp, config.ki, config.kd)):
+            rel = abs(gain.value - exact) / abs(exact) if exact else 0.0
+            lines.append(f"  {label} = {exact:.6g} -> {gain.value:.6g} (相对误差 {rel:.2e})")
+        sim = simulate_step_response(params, fmt, config, full_scale, steps)
+        lines.append(f"  闭环阶跃 {steps} 步: 输出最大误差 {sim['max_error']:.4g} ({sim['max_error'] / lsb:.1f} LSB), "
+                     f"RMS {sim['rms_error']:.4g}")
+        lines.append(f"  末步跟踪误差: 浮点 {sim['final_ref']:.4g}, 定点 {sim['final_fixed']:.4g}")
+        missing = unsupported_features(params)
+        if missing:
+            lines.append(f"  注意: 定点版本不包含 {', '.join(missing)}, 以上仿真已忽略这些功能")
+    return "\n".join(lines)
+
+
+def config_initializer(fmt: FixedFormat, config: FixedConfig, type_names: Optional[List[str]] = None) -> str:
+    """生成C语言的配置结构体初始化列表"""
+    type_names = type_names or ["PID_TYPE_STANDARD", "PID_TYPE_PI_D", "PID_TYPE_I_PD"]
+
+    def gain(g: FixedGain) -> str:
+        return f"{{ {g.mant}, {g.exp} }}"
+
+    return "\n".join([
+        "{",
+        f"    .Kp = {gain(config.kp)},",
+        f"    .Ki = {gain(config.ki)},",
+        f"    .Kd = {gain(config.kd)},",
+        f"    .output_limit = {config.output_limit},",
+        f"    .integral_limit = {config.integral_limit},",
+        f"    .deadband = {config.deadband},",
+        f"    .integral_separation = {config.integral_separation},",
+        f"    .d_filter_alpha = {config.d_filter_alpha},",
+        f"    .type = {type_names[config.pid_type]},",
+        f"    .work_mode = {'PID_MODE_VELOCITY' if config.velocity else 'PID_MODE_POSITION'},",
+        "}",
+    ])
@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+PID闭环增益扫描辅助模块(不依赖Qt)
+
+按实例的面板配置生成 templates/pid_sweep_template.c 并编译为主机端仿真程序,
+对 Kp/Ki/Kd 网格做闭环阶跃仿真, 按IAE/ITAE/超调量排序后把结果写回数据模型:
+- build_sweep_tool: 生成库文件、控制器组和仿真程序源文件并用C编译器编译
+- run_sweep: 运行仿真程序并解析JSON结果
+- apply_result: 把选中的一组增益写入实例参数
+
+编译器取环境变量 CC, 否则在PATH中查找 cc/gcc/clang; 仿真程序依赖pthread, 仅支持POSIX平台。
+"""
+
+import json
+import os
+import shutil
+import subprocess
+from dataclasses import dataclass
+from pathlib import Path
+from typing import Dict, Any, List, Optional, Tuple
+
+try:
+    from .pid_codegen import PIDDataModel, PIDCodeGenerator, write_library
+except ImportError:  # 以脚本方式运行
+    from pid_codegen import PIDDataModel, PIDCodeGenerator, write_library
+
+PLANT_KINDS = ("fopdt", "second-order")
+OBJECTIVES = ("itae", "iae", "overshoot")
+
+
+@dataclass
+class SweepSpec:
+    """一次扫描的网格、被控对象和排序方式, 字段与仿真程序的命令行参数一一对应"""
+    kp: Tuple[float, float, int] = (0.0, 5.0, 20)     # (最小, 最大, 点数), 连续域
+    ki: Tuple[float, float, int] = (0.0, 5.0, 20)
+    kd: Tuple[float, float, int] = (0.0, 0.1, 5)
+    plant: str = "fopdt"
+    gain: float = 1.0
+    tau: float = 0.5
+    wn: float = 10.0
+    zeta: float = 0.7
+    dead_time: float = 0.0
+    u_limit: float = 0.0             # 0表示不限制
+    setpoint: float = 1.0
+    duration: float = 5.0
+    objective: str = "itae"
+    max_overshoot: Optional[float] = None
+    threads: int = 0                 # 0表示在线CPU数
+    top: int = 10
+
+    @property
+    def candidates(self) -> int:
+        return self.kp[2] * self.ki[2] * self.kd[2]
+
+    def validate(self):
+        """检查参数, 不合法时抛出ValueError"""
+        for name, (lo, hi, n) in (("Kp", self.kp), ("Ki", self.ki), ("Kd", self.kd)):
+            if lo < 0 or hi < lo or int(n) < 1:
+                raise ValueError(f"{name} 范围无效: 需要 0 <= 最小 <= 最大 且点数 >= 1")
+        if self.plant not in PLANT_KINDS:
+            raise ValueError(f"不支持的被控对象: {self.plant}")
+        if self.objective not in OBJECTIVES:
+            raise ValueError(f"不支持的排序指标: {self.objective}")
+        if self.setpoint == 0 or self.duration <= 0:
+            raise ValueError("设定值不能为0, 仿真时长须为正")
+
+    def to_args(self) -> List[str]:
+        args = []
+        for flag, (lo, hi, n) in (("--kp", self.kp), ("--ki", self.ki), ("--kd", self.kd)):
+            args += [flag, f"{lo!r}:{hi!r}:{int(n)}"]
+        args += ["--plant", self.plant, "--gain", repr(self.gain), "--tau", repr(self.tau),
+                 "--wn", repr(self.wn), "--zeta", repr(self.zeta), "--dead-time", repr(self.dead_time),
+                 "--u-limit", repr(self.u_limit), "--setpoint", repr(self.setpoint),
+                 "--duration", repr(self.duration), "--objective", self.objective,
+                 "--threads", str(int(self.threads)), "--top", str(int(self.top)), "--json"]
+        if self.max_overshoot is not None:
+            args += ["--max-overshoot", repr(self.max_overshoot)]
+        return args
+
+
+def find_compiler() -> Optional[str]:
+    """查找C编译器"""
+    if os.environ.get("CC"):
+        return os.environ["CC"]
+    for name in ("cc", "gcc", "clang"):
+        path = shutil.which(name)
+        if path:
+            return path
+    return None
+
+
+def build_sweep_tool(data_model: PIDDataModel, out_dir: Path,
+                     instance_name: Optional[str] = None) -> Path:
+    """
+    按数据模型的代码配置和指定实例生成并编译增益扫描程序
+
+    只使用主库和控制器组, 与代码配置中是否勾选控制器组无关; 数据模型本身不被修改。
+
+    Returns:
+        Path: 可执行文件路径
+    Raises:
+        RuntimeError: 生成失败、找不到编译器或编译失败
+    """
+    compiler = find_compiler()
+    if not compiler:
+        raise RuntimeError("未找到C编译器(可通过环境变量CC指定)")
+
+    model = PIDDataModel()
+    model.pid_instances = data_model.pid_instances
+    model.active_instance_index = data_model.active_instance_index
+    model.code_config = dict(data_model.code_config)
+    model.code_config.update({
+        PIDDataModel.C_INC_COMMENTS: True,
+        PIDDataModel.C_GEN_BANK: True,
+        PIDDataModel.C_FIXED_FORMAT: "",
+        PIDDataModel.C_GEN_SPECIALIZED: False,
+        PIDDataModel.C_GEN_CASCADE: False,
+        PIDDataModel.C_GEN_SPLIT: False,
+    })
+    generator = PIDCodeGenerator(model)
+    sweep_code = generator.generate_sweep_source_code(instance_name)
+    if sweep_code.startswith("// Error"):
+        raise RuntimeError(f"生成增益扫描程序失败: {sweep_code}")
+
+    out_dir = Path(out_dir)
+    paths = write_library(out_dir, model)
+    header_name = model.code_config[PIDDataModel.C_HEADER_NAME]
+    sweep_path = out_dir / PIDCodeGenerator.sweep_file_name(header_name)
+    sweep_path.write_text(sweep_code, encoding='utf-8')
+    sources = [str(sweep_path)] + [str(p) for p in paths if p.suffix == ".c"]
+
+    exe = out_dir / "pid_sweep"
+    base = [compiler, "-O3", "-pthread", *sources, "-lm", "-o", str(exe)]
+    # 优先按本机指令集编译, 编译器不支持 -march=native 时退回默认目标
+    for cmd in (base[:2] + ["-march=native"] + base[2:], base):
+        result = subprocess.run(cmd, capture_output=True, text=True)
+        if result.returncode == 0:
+            return exe
+    raise RuntimeError(f"编译增益扫描程序失败:\n{result.stderr}")
+
+
+def run_sweep(exe: Path, spec: SweepSpec, timeout: Optional[float] = None) -> Dict[str, Any]:
+    """
+    运行增益扫描程序
+
+    Returns:
+        Dict[str, Any]: 仿真程序输出的JSON, results 按排序指标从优到劣排列,
+                        每项含 kp/ki/kd/iae/itae/overshoot/final_error/feasible
+    """
+    spec.validate()
+    result = subprocess.run([str(exe), *spec.to_args()], capture_output=True, text=True, timeout=timeout)
+    if result.returncode != 0:
+        raise RuntimeError(f"增益扫描失败: {result.stderr.strip()}")
+    return json.loads(result.stdout)
+
+
+def apply_result(data_model: PIDDataModel, instance_name: str, result: Dict[str, Any]) -> bool:
+    """把扫描结果中的一组增益写入指定实例的参数"""
+    for instance in data_model.pid_instances:
+        if instance['name'] == instance_name:
+            instance['params'][PIDDataModel.P_KP] = float(result["kp"])
+            instance['params'][PIDDataModel.P_KI] = float(result["ki"])
+            instance['params'][PIDDataModel.P_KD] = float(result["kd"])
+            return True
+    return False
@@ -0,0 +1,84 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+PID遥测批量帧解析(不依赖Qt)
+
+生成的 <头文件名>_telemetry.c 在控制中断里采样、主循环中用功能码 TELEMETRY_FUNC_ID 成批发送, 数据负载为:
+- 12字节帧头(小端): uint8 遥测编号、flags、控制器数、字段掩码, uint32 首条记录的控制周期计数,
+  uint16 抽取系数, uint16 自上一帧以来丢弃的记录数
+- 其后若干条记录, 每条依次为各控制器被选中字段的float32(字段顺序见 FIELD_NAMES)
+
+解析面板选择"重复记录"分配模式、帧头字节数填12, 按一条记录的顺序添加 float (4B) 接收容器即可逐条绘图;
+decode_batch/iter_samples 供脚本把批量帧还原为带时间的采样点。
+"""
+
+import struct
+from typing import Dict, Any, Iterator, List, Tuple
+
+try:
+    from .pid_codegen import PIDCodeGenerator
+except ImportError:  # 以脚本方式运行
+    from pid_codegen import PIDCodeGenerator
+
+TELEMETRY_FUNC_ID = PIDCodeGenerator.TELEMETRY_FUNC_ID
+HEADER_FORMAT = "<4BIHH"
+HEADER_SIZE = struct.calcsize(HEADER_FORMAT)
+
+# 与模板中 PID_TelemetryField 的位号一致
+FIELD_NAMES = ("setpoint", "measure", "output", "p_term", "i_term", "d_term", "ff_term")
+FIELDS_ALL = 0x7F
+FIELDS_BASIC = 0x07
+
+FLAG_CAPTURE = 0x01     # 本帧属于一次触发采集
+FLAG_LAST = 0x02        # 触发采集的最后一帧
+
+
+def field_names(field_mask: int) -> List[str]:
+    """字段掩码选中的字段名, 按记录中的顺序"""
+    return [name for bit, name in enumerate(FIELD_NAMES) if field_mask & (1 << bit)]
+
+
+def decode_batch(payload: bytes) -> Dict[str, Any]:
+    """
+    解析一帧遥测数据负载
+
+    Returns:
+        帧头各字段, 以及 records: 每条记录为按控制器排列的 {字段名: 值} 列表
+
+    Raises:
+        ValueError: 长度不足或记录不完整
+    """
+    if len(payload) < HEADER_SIZE:
+        raise ValueError(f"遥测帧至少需要 {HEADER_SIZE} 字节, 实际 {len(payload)} 字节")
+    stream_id, flags, channels, field_mask, first_tick, decimation, dropped = struct.unpack_from(HEADER_FORMAT, payload)
+    names = field_names(field_mask)
+    record_bytes = 4 * channels * len(names)
+    body = payload[HEADER_SIZE:]
+    if (len(body) % record_bytes) if record_bytes else body:
+        raise ValueError(f"遥测帧记录不完整: {len(body)} 字节, 每条记录 {record_bytes} 字节")
+    record_floats = record_bytes // 4
+    records = []
+    for offset in range(0, len(body), record_bytes or 1):
+        values = struct.unpack_from(f"<{record_floats}f", body, offset)
+        records.append([dict(zip(names, values[ch * len(names):(ch + 1) * len(names)])) for ch in range(channels)])
+    return {
+        "id": stream_id,
+        "flags": flags,
+        "capture": bool(flags & FLAG_CAPTURE),
+        "last": bool(flags & FLAG_LAST),
+        "channels": channels,
+        "field_mask": field_mask,
+        "fields": names,
+        "first_tick": first_tick,
+        "decimation": decimation,
+        "dropped": dropped,
+        "records": records,
+    }
+
+
+def iter_samples(batch: Dict[str, Any], sample_time: float) -> Iterator[Tuple[float, int, Dict[str, float]]]:
+    """按 (时间秒, 控制器下标, {字段名: 值}) 逐个给出一帧中的采样点"""
+    for index, record in enumerate(batch["records"]):
+        t = (batch["first_tick"] + index * batch["decimation"]) * sample_time
+        for channel, values in enumerate(record):
+            yield t, channel, values
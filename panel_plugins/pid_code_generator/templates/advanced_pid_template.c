@@ -29,8 +29,14 @@ static inline {{DATA_TYPE}} constrain_pid_output({{DATA_TYPE}} value, {{DATA_TYP
 void {{FUNCTION_PREFIX}}_Init({{STRUCT_NAME}} *pid, {{DATA_TYPE}} Kp_continuous, {{DATA_TYPE}} Ki_continuous, {{DATA_TYPE}} Kd_continuous, {{DATA_TYPE}} sample_time_val) {
     if (pid == NULL) return;
     {{FUNCTION_PREFIX}}_Reset(pid);
-    {{FUNCTION_PREFIX}}_SetTunings(pid, Kp_continuous, Ki_continuous, Kd_continuous);
+    /* 先确定采样时间, SetTunings才能换算出离散的Ki/Kd */
     pid->sample_time = (sample_time_val > 0.000001{{SFX}}) ? sample_time_val : 0.01{{SFX}};
+    pid->inv_sample_time = 1.0{{SFX}} / pid->sample_time;
+    {{FUNCTION_PREFIX}}_SetTunings(pid, Kp_continuous, Ki_continuous, Kd_continuous);
+    pid->dt_min = 0.25{{SFX}} * pid->sample_time;
+    pid->dt_max = 4.0{{SFX}} * pid->sample_time;
+    pid->dt_limits_fixed = 0;
+    pid->integration = PID_INTEGRATION_RECTANGULAR;
     pid->Kff = {{KFF_DEFAULT}};
     pid->ff_weight = {{FF_WEIGHT_DEFAULT}};
     pid->output_limit = {{OUTPUT_LIMIT_DEFAULT}};
@@ -51,6 +57,8 @@ void {{FUNCTION_PREFIX}}_Init({{STRUCT_NAME}} *pid, {{DATA_TYPE}} Kp_continuous,
 void {{FUNCTION_PREFIX}}_SetTunings({{STRUCT_NAME}} *pid, {{DATA_TYPE}} Kp_continuous, {{DATA_TYPE}} Ki_continuous, {{DATA_TYPE}} Kd_continuous) {
     if (pid == NULL || Kp_continuous < 0.0f || Ki_continuous < 0.0f || Kd_continuous < 0.0f) return;
     pid->Kp = Kp_continuous;
+    pid->Ki_continuous = Ki_continuous;
+    pid->Kd_continuous = Kd_continuous;
     if (pid->sample_time > 0.000001{{SFX}}) {
         pid->Ki = Ki_continuous * pid->sample_time;
         pid->Kd = Kd_continuous / pid->sample_time;
@@ -65,12 +73,17 @@ void {{FUNCTION_PREFIX}}_SetFeedForwardParams({{STRUCT_NAME}} *pid, {{DATA_TYPE}
 
 void {{FUNCTION_PREFIX}}_SetSampleTime({{STRUCT_NAME}} *pid, {{DATA_TYPE}} sample_time_new) {
     if (pid == NULL || sample_time_new <= 0.000001f) return;
-    if (pid->sample_time > 0.000001f) {
-        {{DATA_TYPE}} ratio = sample_time_new / pid->sample_time;
-        pid->Ki *= ratio;
-        pid->Kd /= ratio;
-    }
+    /* 由连续域增益重新换算, 多次修改采样时间不会累积舍入误差 */
     pid->sample_time = sample_time_new;
+    pid->inv_sample_time = 1.0{{SFX}} / sample_time_new;
+    pid->Ki = pid->Ki_continuous * sample_time_new;
+    pid->Kd = pid->Kd_continuous * pid->inv_sample_time;
+    /* 未经SetTimeLimits指定时, 实测周期范围随采样时间一起缩放 */
+    if (!pid->dt_limits_fixed) {
+        pid->dt_min = 0.25{{SFX}} * sample_time_new;
+        pid->dt_max = 4.0{{SFX}} * sample_time_new;
+    }
+    pid->cached_dt_ms = 0; /* 下次调用按新范围重新换算 */
 }
 
 void {{FUNCTION_PREFIX}}_SetOutputLimits({{STRUCT_NAME}} *pid, {{DATA_TYPE}} limit) {
@@ -129,10 +142,30 @@ void {{FUNCTION_PREFIX}}_SetWorkMode({{STRUCT_NAME}} *pid, PID_WorkMode work_mod
     if (pid != NULL) pid->work_mode = work_mode;
 }
 
-{{DATA_TYPE}} {{FUNCTION_PREFIX}}_Compute({{STRUCT_NAME}} *pid, {{DATA_TYPE}} setpoint, {{DATA_TYPE}} measure) {
-    if (pid == NULL || pid->sample_time <= 0.000001{{SFX}}) {
-        return (pid != NULL) ? pid->output : 0.0{{SFX}};
-    }
+void {{FUNCTION_PREFIX}}_SetIntegralHold({{STRUCT_NAME}} *pid, int8_t direction) {
+    if (pid != NULL) pid->integral_hold = (direction > 0) ? 1 : ((direction < 0) ? -1 : 0);
+}
+
+void {{FUNCTION_PREFIX}}_SetIntegrationMethod({{STRUCT_NAME}} *pid, PID_IntegrationMethod method) {
+    if (pid != NULL) pid->integration = method;
+}
+
+void {{FUNCTION_PREFIX}}_SetTimeLimits({{STRUCT_NAME}} *pid, {{DATA_TYPE}} dt_min, {{DATA_TYPE}} dt_max) {
+    if (pid == NULL || dt_min <= 0.000001{{SFX}} || dt_max < dt_min) return;
+    pid->dt_min = dt_min;
+    pid->dt_max = dt_max;
+    pid->dt_limits_fixed = 1;
+    pid->cached_dt_ms = 0; /* 下次调用按新范围重新换算 */
+}
+
+/*
+ * 一个控制周期的计算, 固定周期和变周期两条路径共用:
+ *  ki_dt  - 本周期的积分增益 (Ki_continuous * dt)
+ *  inv_dt - 1 / dt, 把微分输入的变化量换算为变化率
+ *  dt     - 本周期时长 (秒), 用于斜率限制
+ */
+static {{DATA_TYPE}} pid_compute_step({{STRUCT_NAME}} *pid, {{DATA_TYPE}} setpoint, {{DATA_TYPE}} measure,
+                                      {{DATA_TYPE}} ki_dt, {{DATA_TYPE}} inv_dt, {{DATA_TYPE}} dt) {
     if (pid->mode == PID_MODE_MANUAL) return pid->output;
 
     if (pid->input_filter_coef > 0.0f) {
@@ -151,25 +184,29 @@ void {{FUNCTION_PREFIX}}_SetWorkMode({{STRUCT_NAME}} *pid, PID_WorkMode work_mod
     pid->last_p_term = (pid->type == PID_TYPE_I_PD) ? -pid->Kp * measure : pid->Kp * error;
     
     if (fabsf(error) < pid->integral_separation_threshold) {
-        pid->integral += pid->Ki * error;
-        pid->integral = constrain_pid_output(pid->integral, -pid->integral_limit, pid->integral_limit);
+        const {{DATA_TYPE}} i_inc = (pid->integration == PID_INTEGRATION_TRAPEZOIDAL) ? ki_dt * 0.5{{SFX}} * (error + pid->prev_error)
+                                                                                 : ki_dt * error;
+        /* 下游饱和时不再朝饱和方向累积 */
+        if (i_inc * pid->integral_hold <= 0.0{{SFX}}) {
+            pid->integral = constrain_pid_output(pid->integral + i_inc, -pid->integral_limit, pid->integral_limit);
+        }
     }
     pid->last_i_term = pid->integral;
 
     {{DATA_TYPE}} d_input = (pid->type == PID_TYPE_STANDARD) ? (error - pid->prev_error) : -(measure - pid->prev_measure);
-    d_input /= pid->sample_time;
+    d_input *= inv_dt;
     if (pid->d_filter_coef > 0.0f) {
         d_input = pid->filtered_d * (1.0f - pid->d_filter_coef) + d_input * pid->d_filter_coef;
     }
     pid->filtered_d = d_input;
-    pid->last_d_term = pid->Kd * pid->filtered_d;
+    pid->last_d_term = pid->Kd_continuous * pid->filtered_d;
     
     pid->last_ff_term = pid->Kff * setpoint * pid->ff_weight;
     
     {{DATA_TYPE}} computed_output = pid->last_p_term + pid->last_i_term + pid->last_d_term + pid->last_ff_term;
 
     if (pid->output_ramp > 0.0f) {
-        {{DATA_TYPE}} max_change = pid->output_ramp * pid->sample_time;
+        {{DATA_TYPE}} max_change = pid->output_ramp * dt;
         computed_output = pid->prev_output + constrain_pid_output(computed_output - pid->prev_output, -max_change, max_change);
     }
     
@@ -184,28 +221,36 @@ void {{FUNCTION_PREFIX}}_SetWorkMode({{STRUCT_NAME}} *pid, PID_WorkMode work_mod
     return pid->output;
 }
 
+{{DATA_TYPE}} {{FUNCTION_PREFIX}}_Compute({{STRUCT_NAME}} *pid, {{DATA_TYPE}} setpoint, {{DATA_TYPE}} measure) {
+    if (pid == NULL || pid->sample_time <= 0.000001{{SFX}}) {
+        return (pid != NULL) ? pid->output : 0.0{{SFX}};
+    }
+    return pid_compute_step(pid, setpoint, measure, pid->Ki, pid->inv_sample_time, pid->sample_time);
+}
+
 {{DATA_TYPE}} {{FUNCTION_PREFIX}}_ComputeWithTime({{STRUCT_NAME}} *pid, {{DATA_TYPE}} setpoint, {{DATA_TYPE}} measure, uint32_t current_time_ms) {
     if (pid == NULL) return 0.0f;
+    if (pid->sample_time <= 0.000001{{SFX}}) return pid->output;
     if (pid->last_time == 0) pid->last_time = current_time_ms;
     
     uint32_t dt_ms = current_time_ms - pid->last_time;
     if (dt_ms == 0) return pid->output;
-    
-    {{DATA_TYPE}} dt_s = ({{DATA_TYPE}})dt_ms / 1000.0f;
-    {{DATA_TYPE}} original_sample_time = pid->sample_time;
-    {{FUNCTION_PREFIX}}_SetSampleTime(pid, dt_s);
-    
-    {{DATA_TYPE}} result = {{FUNCTION_PREFIX}}_Compute(pid, setpoint, measure);
-    
-    {{FUNCTION_PREFIX}}_SetSampleTime(pid, original_sample_time);
     pid->last_time = current_time_ms;
     
-    return result;
+    /* 周期不变时复用上次的换算结果, 只有间隔变化时才做一次除法 */
+    if (dt_ms != pid->cached_dt_ms) {
+        pid->cached_dt_ms = dt_ms;
+        pid->cached_dt = constrain_pid_output(({{DATA_TYPE}})dt_ms / 1000.0{{SFX}}, pid->dt_min, pid->dt_max);
+        pid->cached_inv_dt = 1.0{{SFX}} / pid->cached_dt;
+    }
+    
+    return pid_compute_step(pid, setpoint, measure, pid->Ki_continuous * pid->cached_dt, pid->cached_inv_dt, pid->cached_dt);
 }
 
 void {{FUNCTION_PREFIX}}_Reset({{STRUCT_NAME}} *pid) {
     if (pid == NULL) return;
-    *pid = ({{STRUCT_NAME}}){ .Kp = pid->Kp, .Ki = pid->Ki, .Kd = pid->Kd }; // Keep gains, reset rest
+    *pid = ({{STRUCT_NAME}}){ .Kp = pid->Kp, .Ki = pid->Ki, .Kd = pid->Kd,
+                              .Ki_continuous = pid->Ki_continuous, .Kd_continuous = pid->Kd_continuous }; // Keep gains, reset rest
 }
 
 void {{FUNCTION_PREFIX}}_SetOutput({{STRUCT_NAME}} *pid, {{DATA_TYPE}} output_val) {
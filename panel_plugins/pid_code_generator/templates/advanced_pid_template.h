@@ -44,6 +44,11 @@ typedef enum {
     PID_MODE_VELOCITY = 1
 } PID_WorkMode;
 
+typedef enum {
+    PID_INTEGRATION_RECTANGULAR = 0,
+    PID_INTEGRATION_TRAPEZOIDAL = 1
+} PID_IntegrationMethod;
+
 /**
  * @brief PID控制器句柄结构体
  * @details 该结构体包含了单个PID控制器实例所需的所有参数、状态变量和配置信息。
@@ -53,6 +58,8 @@ typedef struct {
     {{DATA_TYPE}} Kp;               /**< 比例增益 (Proportional Gain) */
     {{DATA_TYPE}} Ki;               /**< 积分增益 (Integral Gain, 离散形式: Ki_continuous * SampleTime) */
     {{DATA_TYPE}} Kd;               /**< 微分增益 (Derivative Gain, 离散形式: Kd_continuous / SampleTime) */
+    {{DATA_TYPE}} Ki_continuous;    /**< 连续域积分增益, 变周期计算按实测周期直接使用 */
+    {{DATA_TYPE}} Kd_continuous;    /**< 连续域微分增益, 与微分输入的变化率相乘 */
     {{DATA_TYPE}} Kff;              /**< 前馈增益 (Feedforward Gain) */
     {{DATA_TYPE}} ff_weight;        /**< 前馈项权重 (0.0 到 1.0) */
 
@@ -62,6 +69,7 @@ typedef struct {
     {{DATA_TYPE}} output_ramp;      /**< 输出变化率限制 (单位/秒), 0表示无限制 */
     {{DATA_TYPE}} deadband;         /**< 误差死区范围 (当 |error| < deadband/2 时, 误差被视为0) */
     {{DATA_TYPE}} integral_separation_threshold; /**< 积分分离阈值 (当 |error| < 此值时, 积分项才生效) */
+    int8_t        integral_hold;    /**< 外部饱和反馈: +1/-1 时积分不再向正/负方向累积, 0 表示不限制 */
 
     /* 滤波器系数 */
     {{DATA_TYPE}} d_filter_coef;    /**< 微分项的低通滤波器系数 (0.0 到 1.0, 0表示无滤波) */
@@ -73,15 +81,25 @@ typedef struct {
     {{DATA_TYPE}} prev_error;       /**< 上一个计算周期的误差 */
     {{DATA_TYPE}} prev_measure;     /**< 上一个计算周期的测量值 */
     {{DATA_TYPE}} prev_output;      /**< 上一个计算周期的控制器输出值 */
-    {{DATA_TYPE}} filtered_d;       /**< 经过滤波后的微分项值 */
+    {{DATA_TYPE}} filtered_d;       /**< 经过滤波后的微分输入变化率 (单位/秒) */
     {{DATA_TYPE}} filtered_measure; /**< 经过滤波后的测量值 */
     {{DATA_TYPE}} filtered_setpoint;/**< 经过滤波后的设定值 */
     {{DATA_TYPE}} output;           /**< 当前控制器计算出的输出值 */
 
     /* 时间变量 */
     {{DATA_TYPE}} sample_time;      /**< 控制器采样时间 (单位: 秒) */
+    {{DATA_TYPE}} inv_sample_time;  /**< 1 / sample_time, 随采样时间更新 */
     uint32_t      last_time;        /**< 上次计算时的时间戳 (单位: 毫秒, 用于动态采样时间) */
 
+    /* 变周期计算 (ComputeWithTime) */
+    {{DATA_TYPE}} dt_min;           /**< 实测周期下限 (秒), Init/SetSampleTime时设为 0.25*sample_time */
+    {{DATA_TYPE}} dt_max;           /**< 实测周期上限 (秒), Init/SetSampleTime时设为 4*sample_time; 任务卡顿后的长间隔按此值计算 */
+    uint8_t       dt_limits_fixed;  /**< 已由SetTimeLimits显式指定, SetSampleTime不再按采样时间缩放 */
+    uint32_t      cached_dt_ms;     /**< 上次换算的实测周期 (毫秒) */
+    {{DATA_TYPE}} cached_dt;        /**< cached_dt_ms 对应的周期 (秒, 已限幅) */
+    {{DATA_TYPE}} cached_inv_dt;    /**< 1 / cached_dt, 周期不变时不再做除法 */
+    PID_IntegrationMethod integration; /**< 积分方式 (矩形/梯形), 详见 @ref PID_IntegrationMethod */
+
     /* 控制器配置 */
     PID_ModeType mode;              /**< 当前运行模式 (手动/自动), 详见 @ref PID_ModeType */
     PID_Type     type;              /**< PID计算类型 (标准, PI-D, I-PD), 详见 @ref PID_Type */
@@ -117,6 +135,23 @@ void {{FUNCTION_PREFIX}}_SetMode({{STRUCT_NAME}} *pid, PID_ModeType mode);
 void {{FUNCTION_PREFIX}}_SetType({{STRUCT_NAME}} *pid, PID_Type type);
 void {{FUNCTION_PREFIX}}_SetWorkMode({{STRUCT_NAME}} *pid, PID_WorkMode work_mode);
 
+/**
+ * @brief Blocks integration towards a saturated downstream stage (conditional-integration anti-windup).
+ * @param[in] direction +1: 下游(内环/执行机构)已在正向饱和, 积分不再增大; -1: 负向; 0: 解除
+ */
+void {{FUNCTION_PREFIX}}_SetIntegralHold({{STRUCT_NAME}} *pid, int8_t direction);
+
+/**
+ * @brief Selects rectangular (default) or trapezoidal integration for both compute paths.
+ */
+void {{FUNCTION_PREFIX}}_SetIntegrationMethod({{STRUCT_NAME}} *pid, PID_IntegrationMethod method);
+
+/**
+ * @brief Sets the range the measured interval of ComputeWithTime is clamped to (seconds).
+ * @note 超出范围的间隔(首次调用后长时间未调用、任务卡顿、时间戳异常)按边界值计算, 防止积分跳变和微分尖峰。
+ */
+void {{FUNCTION_PREFIX}}_SetTimeLimits({{STRUCT_NAME}} *pid, {{DATA_TYPE}} dt_min, {{DATA_TYPE}} dt_max);
+
 /**
  * @brief Computes the PID output based on the current setpoint and measurement.
  * @note Call this function at regular intervals matching `sample_time`.
@@ -126,8 +161,9 @@ void {{FUNCTION_PREFIX}}_SetWorkMode({{STRUCT_NAME}} *pid, PID_WorkMode work_mod
 /**
  * @brief Computes the PID output with a dynamically provided current time.
  * @param[in]     current_time_ms Current system time in milliseconds.
- * @note This function calculates the delta_time since the last call and adjusts gains.
- * Useful if call interval varies.
+ * @note 按两次调用的实测间隔dt计算: 积分增量为 Ki_continuous*dt*误差, 微分为 Kd_continuous*(变化量/dt),
+ * 斜率限制按dt换算; 不改写离散增益, 也不会因反复换算而漂移。dt先限幅到 [dt_min, dt_max],
+ * 间隔不变时复用缓存的 1/dt, 只有间隔变化时才做一次除法。适用于有抖动的RTOS任务。
  * @return The calculated PID controller output.
  */
 {{DATA_TYPE}} {{FUNCTION_PREFIX}}_ComputeWithTime({{STRUCT_NAME}} *pid, {{DATA_TYPE}} setpoint, {{DATA_TYPE}} measure, uint32_t current_time_ms);
@@ -0,0 +1,221 @@
+/**
+ * @file    {{AUTOTUNE_SOURCE_NAME}}
+ * @author  YJ Studio Team (Generated by Advanced PID Code Generator)
+ * @version 2.3.0
+ * @date    {{TIMESTAMP}}
+ * @brief   Relay-Feedback (Astrom-Hagglund) PID Auto-Tuner Implementation File.
+ */
+
+#include "{{AUTOTUNE_HEADER_NAME}}"
+#include <math.h>
+#include <stddef.h>
+
+/* 各整定规则的 Kp/Ku, Ti/Pu, Td/Pu, 顺序与 PID_AutotuneRule 一致 */
+static const {{DATA_TYPE}} autotune_rules[PID_AUTOTUNE_RULE_COUNT][3] = {
+    { 0.6{{SFX}},       0.5{{SFX}},       0.125{{SFX}} },
+    { 0.45{{SFX}},      0.8333333{{SFX}}, 0.0{{SFX}} },
+    { 0.4545455{{SFX}}, 2.2{{SFX}},       0.1587302{{SFX}} },
+    { 0.3125{{SFX}},    2.2{{SFX}},       0.0{{SFX}} },
+    { 0.3333333{{SFX}}, 0.5{{SFX}},       0.3333333{{SFX}} },
+    { 0.2{{SFX}},       0.5{{SFX}},       0.3333333{{SFX}} },
+};
+
+static inline {{DATA_TYPE}} autotune_clamp({{DATA_TYPE}} value, {{DATA_TYPE}} limit) {
+    if (value > limit) return limit;
+    if (value < -limit) return -limit;
+    return value;
+}
+
+/* 继电器当前方向的输出, 受控制器输出限幅 */
+static inline {{DATA_TYPE}} autotune_relay_output(const {{AUTOTUNE_NAME}} *at, int8_t sign) {
+    return autotune_clamp(at->bias + (sign > 0 ? at->relay_amplitude : -at->relay_amplitude), at->pid->output_limit);
+}
+
+/*
+ * 由已平均的周期估计Ku/Pu并按规则算出增益, 数据不足时返回false
+ * 等效继电器幅值取限幅后上下输出之差的一半
+ */
+static bool autotune_estimate(const {{AUTOTUNE_NAME}} *at, {{DATA_TYPE}} *ku, {{DATA_TYPE}} *pu,
+                              {{DATA_TYPE}} *kp, {{DATA_TYPE}} *ki, {{DATA_TYPE}} *kd) {
+    if (at->cycle_count <= {{FUNCTION_PREFIX}}_AUTOTUNE_SETTLE_CYCLES) return false;
+    const {{DATA_TYPE}} n = ({{DATA_TYPE}})(at->cycle_count - {{FUNCTION_PREFIX}}_AUTOTUNE_SETTLE_CYCLES);
+    const {{DATA_TYPE}} a = at->amplitude_sum / n;
+    if (a <= at->hysteresis) return false;
+    const {{DATA_TYPE}} d = 0.5{{SFX}} * (autotune_relay_output(at, 1) - autotune_relay_output(at, -1));
+    const {{DATA_TYPE}} r = sqrt{{SFX}}(a * a - at->hysteresis * at->hysteresis);
+    const {{DATA_TYPE}} *rule = autotune_rules[at->rule < PID_AUTOTUNE_RULE_COUNT ? at->rule : 0];
+
+    *ku = 4.0{{SFX}} * d / (3.14159265{{SFX}} * r);
+    *pu = ({{DATA_TYPE}})at->period_sum / n * at->pid->sample_time;
+    *kp = rule[0] * *ku;
+    *ki = *kp / (rule[1] * *pu);
+    *kd = *kp * rule[2] * *pu;
+    return true;
+}
+
+/* 结束实验: 控制器以继电器中心输出为积分初值无扰接管 */
+static void autotune_stop({{AUTOTUNE_NAME}} *at, PID_AutotuneState state, {{DATA_TYPE}} measure) {
+    {{STRUCT_NAME}} *pid = at->pid;
+    pid->mode = PID_MODE_MANUAL;
+    {{FUNCTION_PREFIX}}_SetOutput(pid, at->bias);
+    pid->prev_error = at->setpoint - measure;
+    pid->prev_measure = measure;
+    pid->filtered_measure = measure;
+    pid->filtered_setpoint = at->setpoint;
+    pid->filtered_d = 0.0{{SFX}};
+    {{FUNCTION_PREFIX}}_SetMode(pid, PID_MODE_AUTOMATIC);
+    at->state = (uint8_t)state;
+    at->report_pending = 1;
+}
+
+/* 继电器由负转正: 一个振荡周期结束 */
+static void autotune_cycle({{AUTOTUNE_NAME}} *at, {{DATA_TYPE}} measure) {
+    if (at->last_rise != 0) {
+        at->last_amplitude = 0.5{{SFX}} * (at->peak_max - at->peak_min);
+        if (at->cycle_count < UINT8_MAX) at->cycle_count++;
+        if (at->cycle_count > {{FUNCTION_PREFIX}}_AUTOTUNE_SETTLE_CYCLES) {
+            at->amplitude_sum += at->last_amplitude;
+            at->period_sum += at->steps - at->last_rise;
+        }
+        at->report_pending = 1;
+        if (at->cycle_count >= {{FUNCTION_PREFIX}}_AUTOTUNE_SETTLE_CYCLES + at->cycles) {
+            if (autotune_estimate(at, &at->Ku, &at->Pu, &at->Kp, &at->Ki, &at->Kd)) {
+                {{FUNCTION_PREFIX}}_SetTunings(at->pid, at->Kp, at->Ki, at->Kd);
+                autotune_stop(at, PID_AUTOTUNE_DONE, measure);
+            } else {
+                autotune_stop(at, PID_AUTOTUNE_NO_OSCILLATION, measure);
+            }
+            return;
+        }
+    }
+    at->last_rise = at->steps;
+    at->peak_max = measure;
+    at->peak_min = measure;
+}
+
+void {{FUNCTION_PREFIX}}_AutotuneInit({{AUTOTUNE_NAME}} *at, {{STRUCT_NAME}} *pid, {{DATA_TYPE}} relay_amplitude, {{DATA_TYPE}} hysteresis) {
+    if (at == NULL) return;
+    *at = ({{AUTOTUNE_NAME}}){ 0 };
+    at->pid = pid;
+    at->relay_amplitude = fabs{{SFX}}(relay_amplitude);
+    at->hysteresis = fabs{{SFX}}(hysteresis);
+    at->max_time = 60.0{{SFX}};
+    at->cycles = 4;
+    at->rule = PID_AUTOTUNE_RULE_ZN_PID;
+}
+
+void {{FUNCTION_PREFIX}}_AutotuneSetRule({{AUTOTUNE_NAME}} *at, PID_AutotuneRule rule) {
+    if (at != NULL && rule < PID_AUTOTUNE_RULE_COUNT) at->rule = (uint8_t)rule;
+}
+
+bool {{FUNCTION_PREFIX}}_AutotuneStart({{AUTOTUNE_NAME}} *at, {{DATA_TYPE}} setpoint, {{DATA_TYPE}} bias) {
+    if (at == NULL || at->pid == NULL || at->relay_amplitude <= 0.0{{SFX}} || at->cycles == 0 ||
+        at->pid->sample_time <= 0.000001{{SFX}} || at->max_time <= 0.0{{SFX}}) {
+        return false;
+    }
+    const {{DATA_TYPE}} max_steps = at->max_time * at->pid->inv_sample_time;
+    at->setpoint = setpoint;
+    at->bias = bias;
+    at->relay_sign = 1;
+    at->cycle_count = 0;
+    at->last_measure = setpoint;
+    at->peak_max = setpoint;
+    at->peak_min = setpoint;
+    at->amplitude_sum = 0.0{{SFX}};
+    at->last_amplitude = 0.0{{SFX}};
+    at->steps = 0;
+    at->max_steps = (max_steps >= 4294967295.0{{SFX}}) ? UINT32_MAX : ((max_steps >= 1.0{{SFX}}) ? (uint32_t)max_steps : 1u);
+    at->last_rise = 0;
+    at->period_sum = 0;
+    at->Ku = at->Pu = at->Kp = at->Ki = at->Kd = 0.0{{SFX}};
+    at->cancel_request = 0;
+    at->report_pending = 1;
+    at->state = PID_AUTOTUNE_RUNNING;
+    return true;
+}
+
+{{DATA_TYPE}} {{FUNCTION_PREFIX}}_AutotuneCompute({{AUTOTUNE_NAME}} *at, {{DATA_TYPE}} measure) {
+    if (at == NULL || at->pid == NULL) return 0.0{{SFX}};
+    if (at->state == PID_AUTOTUNE_RUNNING) {
+        const {{DATA_TYPE}} error = at->setpoint - measure;
+        at->last_measure = measure;
+        at->steps++;
+        if (measure > at->peak_max) at->peak_max = measure;
+        if (measure < at->peak_min) at->peak_min = measure;
+
+        if (at->cancel_request) {
+            autotune_stop(at, PID_AUTOTUNE_CANCELLED, measure);
+        } else if (at->error_limit > 0.0{{SFX}} && fabs{{SFX}}(error) > at->error_limit) {
+            autotune_stop(at, PID_AUTOTUNE_LIMIT, measure);
+        } else {
+            /* 带滞环的继电器: 越过 setpoint ± h 才换向 */
+            if (at->relay_sign > 0 && error < -at->hysteresis) {
+                at->relay_sign = -1;
+            } else if (at->relay_sign < 0 && error > at->hysteresis) {
+                at->relay_sign = 1;
+                autotune_cycle(at, measure);
+            }
+            if (at->state == PID_AUTOTUNE_RUNNING && at->steps >= at->max_steps) {
+                autotune_stop(at, PID_AUTOTUNE_TIMEOUT, measure);
+            }
+        }
+        if (at->state == PID_AUTOTUNE_RUNNING) return autotune_relay_output(at, at->relay_sign);
+    }
+    return {{FUNCTION_PREFIX}}_Compute(at->pid, at->setpoint, measure);
+}
+
+void {{FUNCTION_PREFIX}}_AutotuneCancel({{AUTOTUNE_NAME}} *at) {
+    if (at != NULL && at->state == PID_AUTOTUNE_RUNNING) at->cancel_request = 1;
+}
+
+bool {{FUNCTION_PREFIX}}_AutotuneIsRunning(const {{AUTOTUNE_NAME}} *at) {
+    return at != NULL && at->state == PID_AUTOTUNE_RUNNING;
+}
+
+/* float32按小端写入, 与主机字节序无关 */
+static uint8_t *autotune_pack_f32(uint8_t *p, {{DATA_TYPE}} value) {
+    union { float f; uint32_t u; } v;
+    v.f = (float)value;
+    p[0] = (uint8_t)v.u;
+    p[1] = (uint8_t)(v.u >> 8);
+    p[2] = (uint8_t)(v.u >> 16);
+    p[3] = (uint8_t)(v.u >> 24);
+    return p + 4;
+}
+
+uint16_t {{FUNCTION_PREFIX}}_AutotunePackProgress(const {{AUTOTUNE_NAME}} *at, uint8_t *buffer) {
+    if (at == NULL || buffer == NULL || at->pid == NULL) return 0;
+    {{DATA_TYPE}} ku = at->Ku, pu = at->Pu, kp = at->Kp, ki = at->Ki, kd = at->Kd;
+    if (at->state == PID_AUTOTUNE_RUNNING && !autotune_estimate(at, &ku, &pu, &kp, &ki, &kd)) {
+        ku = pu = kp = ki = kd = 0.0{{SFX}};
+    }
+    const uint8_t averaged = (at->cycle_count > {{FUNCTION_PREFIX}}_AUTOTUNE_SETTLE_CYCLES)
+                             ? (uint8_t)(at->cycle_count - {{FUNCTION_PREFIX}}_AUTOTUNE_SETTLE_CYCLES) : 0;
+    buffer[0] = at->id;
+    buffer[1] = at->state;
+    buffer[2] = averaged;
+    buffer[3] = at->cycles;
+    uint8_t *p = buffer + 4;
+    p = autotune_pack_f32(p, ku);
+    p = autotune_pack_f32(p, pu);
+    p = autotune_pack_f32(p, at->last_amplitude);
+    p = autotune_pack_f32(p, kp);
+    p = autotune_pack_f32(p, ki);
+    p = autotune_pack_f32(p, kd);
+    autotune_pack_f32(p, ({{DATA_TYPE}})at->steps * at->pid->sample_time);
+    return {{FUNCTION_PREFIX}}_AUTOTUNE_PROGRESS_SIZE;
+}
+
+#if {{FUNCTION_PREFIX}}_AUTOTUNE_USE_YJ_PROTOCOL
+int32_t {{FUNCTION_PREFIX}}_AutotuneSendProgress({{AUTOTUNE_NAME}} *at, yj_protocol_handler_t *handler, uint8_t dest_addr) {
+    if (at == NULL || handler == NULL) return -1;
+    if (!at->report_pending) return 1;
+    /* 先清标志再打包: 打包期间中断产生的新进度会在下一次发送 */
+    at->report_pending = 0;
+    uint8_t payload[{{FUNCTION_PREFIX}}_AUTOTUNE_PROGRESS_SIZE];
+    const uint16_t len = {{FUNCTION_PREFIX}}_AutotunePackProgress(at, payload);
+    const int32_t ret = yj_protocol_send_frame(handler, dest_addr, {{FUNCTION_PREFIX}}_AUTOTUNE_FUNC_ID, payload, len);
+    if (ret != 0) at->report_pending = 1;
+    return ret;
+}
+#endif
@@ -0,0 +1,173 @@
+/**
+ * @file    {{AUTOTUNE_HEADER_NAME}}
+ * @author  YJ Studio Team (Generated by Advanced PID Code Generator)
+ * @version 2.3.0
+ * @date    {{TIMESTAMP}}
+ * @brief   Relay-Feedback (Astrom-Hagglund) PID Auto-Tuner Header File.
+ *
+ * @details 在设备上用继电器实验整定一个 {{STRUCT_NAME}}:
+ * - 实验期间 {{FUNCTION_PREFIX}}_AutotuneCompute 输出 bias ± d 的继电器信号(带滞环), 被控量进入等幅振荡;
+ * - 每个振荡周期只做比较和累加, 结束时由平均振幅a和周期Pu估计临界增益
+ *   Ku = 4d / (π·sqrt(a² - h²)), 再按所选规则算出连续域Kp/Ki/Kd, 通过 {{FUNCTION_PREFIX}}_SetTunings 写入控制器并无扰切换;
+ * - 实验结束后继续调用 {{FUNCTION_PREFIX}}_AutotuneCompute 等同于 {{FUNCTION_PREFIX}}_Compute, 中断里不必切换调用;
+ * - 进度由 {{FUNCTION_PREFIX}}_AutotuneSendProgress 在主循环中经YJ协议发送(功能码 {{FUNCTION_PREFIX}}_AUTOTUNE_FUNC_ID),
+ *   数据负载为固定32字节小端布局, 上位机解析面板可直接按字段显示。
+ *
+ * 状态只有几个计数和累加量, 不保存采样历史。
+ */
+
+#ifndef __PID_AUTOTUNE_H_TEMPLATE__
+#define __PID_AUTOTUNE_H_TEMPLATE__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "{{HEADER_NAME}}"
+
+#ifndef {{FUNCTION_PREFIX}}_AUTOTUNE_USE_YJ_PROTOCOL
+    #define {{FUNCTION_PREFIX}}_AUTOTUNE_USE_YJ_PROTOCOL 1    /**< 为0时不依赖yj_protocol, 只提供 {{FUNCTION_PREFIX}}_AutotunePackProgress */
+#endif
+
+#if {{FUNCTION_PREFIX}}_AUTOTUNE_USE_YJ_PROTOCOL
+#include "yj_protocol.h"
+#endif
+
+#ifndef {{FUNCTION_PREFIX}}_AUTOTUNE_FUNC_ID
+    #define {{FUNCTION_PREFIX}}_AUTOTUNE_FUNC_ID {{AUTOTUNE_FUNC_ID}}          /**< 进度帧功能码 */
+#endif
+
+#ifndef {{FUNCTION_PREFIX}}_AUTOTUNE_SETTLE_CYCLES
+    #define {{FUNCTION_PREFIX}}_AUTOTUNE_SETTLE_CYCLES 1   /**< 丢弃的起振周期数, 不计入平均 */
+#endif
+
+#define {{FUNCTION_PREFIX}}_AUTOTUNE_PROGRESS_SIZE 32      /**< 进度帧数据负载字节数 */
+
+/**
+ * @brief 自整定状态(进度帧第1字节)
+ */
+typedef enum {
+    PID_AUTOTUNE_IDLE           = 0,    /**< 未启动 */
+    PID_AUTOTUNE_RUNNING        = 1,    /**< 继电器实验进行中 */
+    PID_AUTOTUNE_DONE           = 2,    /**< 完成, 新增益已写入控制器 */
+    PID_AUTOTUNE_TIMEOUT        = 3,    /**< 超过max_time仍未完成规定周期数 */
+    PID_AUTOTUNE_NO_OSCILLATION = 4,    /**< 振幅不大于滞环宽度, 无法估计Ku */
+    PID_AUTOTUNE_LIMIT          = 5,    /**< 偏差超过error_limit, 实验中止 */
+    PID_AUTOTUNE_CANCELLED      = 6     /**< 被 {{FUNCTION_PREFIX}}_AutotuneCancel 中止 */
+} PID_AutotuneState;
+
+/**
+ * @brief 由Ku/Pu计算增益的整定规则
+ */
+typedef enum {
+    PID_AUTOTUNE_RULE_ZN_PID        = 0,    /**< Ziegler-Nichols PID: Kp=0.6Ku, Ti=Pu/2, Td=Pu/8 */
+    PID_AUTOTUNE_RULE_ZN_PI         = 1,    /**< Ziegler-Nichols PI: Kp=0.45Ku, Ti=Pu/1.2 */
+    PID_AUTOTUNE_RULE_TL_PID        = 2,    /**< Tyreus-Luyben PID: Kp=Ku/2.2, Ti=2.2Pu, Td=Pu/6.3 (超调小) */
+    PID_AUTOTUNE_RULE_TL_PI         = 3,    /**< Tyreus-Luyben PI: Kp=Ku/3.2, Ti=2.2Pu */
+    PID_AUTOTUNE_RULE_SOME_OVERSHOOT = 4,   /**< Kp=Ku/3, Ti=Pu/2, Td=Pu/3 */
+    PID_AUTOTUNE_RULE_NO_OVERSHOOT  = 5,    /**< Kp=0.2Ku, Ti=Pu/2, Td=Pu/3 */
+    PID_AUTOTUNE_RULE_COUNT
+} PID_AutotuneRule;
+
+/**
+ * @brief 继电器自整定器
+ * @note 中断中只调用 {{FUNCTION_PREFIX}}_AutotuneCompute; 主循环读取结果字段或发送进度。
+ */
+typedef struct {
+    {{STRUCT_NAME}} *pid;           /**< 被整定的控制器, 其采样时间和输出限幅在实验中生效 */
+
+    /* 实验配置 - Start前可直接修改 */
+    {{DATA_TYPE}} relay_amplitude;  /**< 继电器幅值d, 输出在 bias ± d 间切换(受output_limit限幅) */
+    {{DATA_TYPE}} hysteresis;       /**< 滞环半宽h, 应大于测量噪声峰值 */
+    {{DATA_TYPE}} error_limit;      /**< 偏差绝对值超过此值时中止实验, 0表示不检查 */
+    {{DATA_TYPE}} max_time;         /**< 实验最长时间 (秒) */
+    uint8_t cycles;                 /**< 参与平均的振荡周期数 */
+    uint8_t rule;                   /**< 整定规则, 详见 @ref PID_AutotuneRule */
+    uint8_t id;                     /**< 进度帧中的实例编号, 用于区分多个轴 */
+
+    /* 运行状态 */
+    volatile uint8_t state;         /**< 当前状态, 详见 @ref PID_AutotuneState */
+    volatile uint8_t report_pending;/**< 有新的进度待发送 */
+    volatile uint8_t cancel_request;/**< 由 {{FUNCTION_PREFIX}}_AutotuneCancel 置位, 下一次计算时生效 */
+    int8_t relay_sign;              /**< 继电器方向 +1/-1 */
+    uint8_t cycle_count;            /**< 已完成的振荡周期数(含起振周期) */
+    {{DATA_TYPE}} setpoint;         /**< 实验设定值, 完成后仍作为设定值 */
+    {{DATA_TYPE}} bias;             /**< 继电器中心输出 */
+    {{DATA_TYPE}} last_measure;     /**< 最近一次测量值 */
+    {{DATA_TYPE}} peak_max;         /**< 本周期测量最大值 */
+    {{DATA_TYPE}} peak_min;         /**< 本周期测量最小值 */
+    {{DATA_TYPE}} amplitude_sum;    /**< 参与平均的周期振幅之和 */
+    {{DATA_TYPE}} last_amplitude;   /**< 最近一个周期的振幅 (峰峰值的一半) */
+    uint32_t steps;                 /**< 已运行的采样周期数 */
+    uint32_t max_steps;             /**< max_time 对应的采样周期数 */
+    uint32_t last_rise;             /**< 上次继电器由负转正时的 steps */
+    uint32_t period_sum;            /**< 参与平均的周期长度之和 (采样周期数) */
+
+    /* 结果 - 状态为DONE后有效 */
+    {{DATA_TYPE}} Ku;               /**< 临界增益 */
+    {{DATA_TYPE}} Pu;               /**< 临界周期 (秒) */
+    {{DATA_TYPE}} Kp;               /**< 整定得到的比例增益 */
+    {{DATA_TYPE}} Ki;               /**< 整定得到的连续域积分增益 */
+    {{DATA_TYPE}} Kd;               /**< 整定得到的连续域微分增益 */
+} {{AUTOTUNE_NAME}};
+
+/* --- Public Function Declarations --- */
+
+/**
+ * @brief Binds the tuner to a configured controller and sets the relay parameters.
+ * @param[in] pid             已用 {{FUNCTION_PREFIX}}_Init 配置采样时间和输出限幅的控制器
+ * @param[in] relay_amplitude 继电器幅值d (>0), 通常取输出范围的5%~20%
+ * @param[in] hysteresis      滞环半宽h (>=0)
+ * @note 默认: 4个周期、Ziegler-Nichols PID规则、最长60秒、不检查偏差上限。
+ */
+void {{FUNCTION_PREFIX}}_AutotuneInit({{AUTOTUNE_NAME}} *at, {{STRUCT_NAME}} *pid, {{DATA_TYPE}} relay_amplitude, {{DATA_TYPE}} hysteresis);
+
+/**
+ * @brief Selects the rule used to turn Ku/Pu into gains.
+ */
+void {{FUNCTION_PREFIX}}_AutotuneSetRule({{AUTOTUNE_NAME}} *at, PID_AutotuneRule rule);
+
+/**
+ * @brief Starts the relay experiment.
+ * @param[in] setpoint 实验工作点, 完成后作为控制器设定值
+ * @param[in] bias     继电器中心输出(使被控量停在工作点附近所需的大致输出)
+ * @return true on success, false if the tuner is not configured.
+ */
+bool {{FUNCTION_PREFIX}}_AutotuneStart({{AUTOTUNE_NAME}} *at, {{DATA_TYPE}} setpoint, {{DATA_TYPE}} bias);
+
+/**
+ * @brief Runs one sample period; call at the controller's sample rate in place of {{FUNCTION_PREFIX}}_Compute.
+ * @return 实验中为继电器输出(位置量, 速度式控制器同样直接作用于执行机构); 其余状态下等同于
+ *         {{FUNCTION_PREFIX}}_Compute(pid, setpoint, measure)。
+ */
+{{DATA_TYPE}} {{FUNCTION_PREFIX}}_AutotuneCompute({{AUTOTUNE_NAME}} *at, {{DATA_TYPE}} measure);
+
+/**
+ * @brief Aborts a running experiment and hands control back to the controller with its previous gains.
+ * @note 只置位请求, 下一次 {{FUNCTION_PREFIX}}_AutotuneCompute 时生效, 可在主循环中调用。
+ */
+void {{FUNCTION_PREFIX}}_AutotuneCancel({{AUTOTUNE_NAME}} *at);
+
+/**
+ * @brief Returns true while the relay experiment is running.
+ */
+bool {{FUNCTION_PREFIX}}_AutotuneIsRunning(const {{AUTOTUNE_NAME}} *at);
+
+/**
+ * @brief Packs the progress payload (little-endian, {{FUNCTION_PREFIX}}_AUTOTUNE_PROGRESS_SIZE bytes).
+ * @details 字节0: id, 1: state, 2: 已平均的周期数, 3: 目标周期数(均为uint8);
+ *          4起7个float32: Ku, Pu(秒), 最近周期振幅, Kp, Ki, Kd, 已运行时间(秒)。
+ *          实验中的Ku/Pu/增益为当前已完成周期的估计值。
+ * @param[out] buffer 至少 {{FUNCTION_PREFIX}}_AUTOTUNE_PROGRESS_SIZE 字节
+ * @return 写入的字节数
+ */
+uint16_t {{FUNCTION_PREFIX}}_AutotunePackProgress(const {{AUTOTUNE_NAME}} *at, uint8_t *buffer);
+
+#if {{FUNCTION_PREFIX}}_AUTOTUNE_USE_YJ_PROTOCOL
+/**
+ * @brief Sends a progress frame if the state changed or a cycle completed since the last call.
+ * @note 在主循环中调用, 不要在控制中断里发送。
+ * @return 0 sent, 1 nothing pending, negative on send failure (the report stays pending).
+ */
+int32_t {{FUNCTION_PREFIX}}_AutotuneSendProgress({{AUTOTUNE_NAME}} *at, yj_protocol_handler_t *handler, uint8_t dest_addr);
+#endif
+
+#endif /* __PID_AUTOTUNE_H_TEMPLATE__ */
@@ -0,0 +1,200 @@
+/**
+ * @file    {{BANK_SOURCE_NAME}}
+ * @author  YJ Studio Team (Generated by Advanced PID Code Generator)
+ * @version 2.3.0
+ * @date    {{TIMESTAMP}}
+ * @brief   Structure-of-Arrays PID Controller Bank Implementation File.
+ */
+
+#include "{{BANK_HEADER_NAME}}"
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+
+#ifndef INFINITY
+    #define INFINITY (1.0f/0.0f)
+#endif
+
+#if defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER)
+    #define PID_BANK_RESTRICT __restrict
+#else
+    #define PID_BANK_RESTRICT
+#endif
+
+/* 比较+选择形式的限幅, 向量化后为min/max指令 */
+static inline {{DATA_TYPE}} pid_bank_clamp({{DATA_TYPE}} value, {{DATA_TYPE}} min_val, {{DATA_TYPE}} max_val) {
+    value = (value < min_val) ? min_val : value;
+    return (value > max_val) ? max_val : value;
+}
+
+/* 按0/1掩码在两个有限值之间选择, 乘加形式没有比较和分支 */
+static inline {{DATA_TYPE}} pid_bank_blend({{DATA_TYPE}} mask, {{DATA_TYPE}} on_value, {{DATA_TYPE}} off_value) {
+    return mask * on_value + (1.0{{SFX}} - mask) * off_value;
+}
+
+void {{FUNCTION_PREFIX}}_BankInit({{BANK_NAME}} *bank) {
+    if (bank == NULL) return;
+    memset(bank, 0, sizeof(*bank));
+}
+
+bool {{FUNCTION_PREFIX}}_BankLoad({{BANK_NAME}} *bank, uint32_t channel, const {{STRUCT_NAME}} *pid) {
+    if (bank == NULL || pid == NULL || channel >= {{FUNCTION_PREFIX}}_BANK_CAPACITY) return false;
+    if (pid->sample_time <= 0.000001{{SFX}}) return false;
+    const uint32_t i = channel;
+
+    bank->Kp[i] = pid->Kp;
+    bank->Ki[i] = pid->Ki;
+    bank->Kd[i] = pid->Kd_continuous;
+    bank->Kff_w[i] = pid->Kff * pid->ff_weight;
+
+    bank->output_limit[i] = pid->output_limit;
+    bank->integral_limit[i] = pid->integral_limit;
+    bank->max_change[i] = (pid->output_ramp > 0.0{{SFX}}) ? pid->output_ramp * pid->sample_time : INFINITY;
+    bank->deadband[i] = pid->deadband;
+    bank->i_sep[i] = pid->integral_separation_threshold;
+    bank->inv_ts[i] = 1.0{{SFX}} / pid->sample_time;
+
+    bank->d_alpha[i] = (pid->d_filter_coef > 0.0{{SFX}}) ? pid->d_filter_coef : 1.0{{SFX}};
+    bank->in_alpha[i] = (pid->input_filter_coef > 0.0{{SFX}}) ? pid->input_filter_coef : 1.0{{SFX}};
+    bank->sp_alpha[i] = (pid->setpoint_filter_coef > 0.0{{SFX}}) ? pid->setpoint_filter_coef : 1.0{{SFX}};
+
+    bank->auto_mask[i] = (pid->mode == PID_MODE_AUTOMATIC) ? 1.0{{SFX}} : 0.0{{SFX}};
+    bank->p_err_mask[i] = (pid->type == PID_TYPE_I_PD) ? 0.0{{SFX}} : 1.0{{SFX}};
+    bank->d_err_mask[i] = (pid->type == PID_TYPE_STANDARD) ? 1.0{{SFX}} : 0.0{{SFX}};
+    bank->vel_mask[i] = (pid->work_mode == PID_MODE_VELOCITY) ? 1.0{{SFX}} : 0.0{{SFX}};
+    bank->trap_mask[i] = (pid->integration == PID_INTEGRATION_TRAPEZOIDAL) ? 1.0{{SFX}} : 0.0{{SFX}};
+    bank->hold[i] = ({{DATA_TYPE}})pid->integral_hold;
+
+    bank->integral[i] = pid->integral;
+    bank->prev_error[i] = pid->prev_error;
+    bank->prev_measure[i] = pid->prev_measure;
+    bank->prev_output[i] = pid->prev_output;
+    bank->filtered_d[i] = pid->filtered_d;
+    bank->filtered_measure[i] = pid->filtered_measure;
+    bank->filtered_setpoint[i] = pid->filtered_setpoint;
+    bank->output[i] = pid->output;
+
+    if (channel >= bank->count) bank->count = channel + 1;
+    return true;
+}
+
+void {{FUNCTION_PREFIX}}_BankStore(const {{BANK_NAME}} *bank, uint32_t channel, {{STRUCT_NAME}} *pid) {
+    if (bank == NULL || pid == NULL || channel >= bank->count) return;
+    const uint32_t i = channel;
+    pid->integral = bank->integral[i];
+    pid->last_i_term = bank->integral[i];
+    pid->prev_error = bank->prev_error[i];
+    pid->prev_measure = bank->prev_measure[i];
+    pid->prev_output = bank->prev_output[i];
+    pid->filtered_d = bank->filtered_d[i];
+    pid->filtered_measure = bank->filtered_measure[i];
+    pid->filtered_setpoint = bank->filtered_setpoint[i];
+    pid->output = bank->output[i];
+}
+
+void {{FUNCTION_PREFIX}}_BankReset({{BANK_NAME}} *bank, uint32_t channel) {
+    if (bank == NULL || channel >= bank->count) return;
+    const uint32_t i = channel;
+    bank->integral[i] = 0.0{{SFX}};
+    bank->prev_error[i] = 0.0{{SFX}};
+    bank->prev_measure[i] = 0.0{{SFX}};
+    bank->prev_output[i] = 0.0{{SFX}};
+    bank->filtered_d[i] = 0.0{{SFX}};
+    bank->filtered_measure[i] = 0.0{{SFX}};
+    bank->filtered_setpoint[i] = 0.0{{SFX}};
+    bank->output[i] = 0.0{{SFX}};
+}
+
+void {{FUNCTION_PREFIX}}_BankSetMode({{BANK_NAME}} *bank, uint32_t channel, PID_ModeType mode) {
+    if (bank == NULL || channel >= bank->count) return;
+    const uint32_t i = channel;
+    const {{DATA_TYPE}} new_mask = (mode == PID_MODE_AUTOMATIC) ? 1.0{{SFX}} : 0.0{{SFX}};
+    if (bank->auto_mask[i] == 0.0{{SFX}} && new_mask != 0.0{{SFX}}) {
+        bank->integral[i] = pid_bank_clamp(bank->prev_output[i], -bank->integral_limit[i], bank->integral_limit[i]);
+    }
+    bank->auto_mask[i] = new_mask;
+}
+
+void {{FUNCTION_PREFIX}}_BankSetIntegralHold({{BANK_NAME}} *bank, uint32_t channel, int8_t direction) {
+    if (bank == NULL || channel >= bank->count) return;
+    bank->hold[channel] = (direction > 0) ? 1.0{{SFX}} : ((direction < 0) ? -1.0{{SFX}} : 0.0{{SFX}});
+}
+
+/*
+ * 每路通道的计算与 {{FUNCTION_PREFIX}}_Compute 相同, 只是把分支改写为:
+ *  - 掩码加权: P/D作用对象、矩形/梯形积分、速度式输出、手动模式下保持状态, 掩码为0/1时结果与对应分支逐位相同;
+ *  - 比较+选择: 死区、积分分离、下游饱和时的积分保持;
+ *  - 斜率限制改为把输出限制在 prev_output ± max_change 内, 未启用时max_change为INFINITY;
+ *  - 未启用的滤波器系数为1, 滤波公式退化为直接采用新值。
+ * 循环体内没有函数调用和数据相关的跳转, 各数组互不重叠, 编译器可直接向量化。
+ */
+void {{FUNCTION_PREFIX}}_ComputeBatch({{BANK_NAME}} *bank, const {{DATA_TYPE}} *setpoints, const {{DATA_TYPE}} *measures, {{DATA_TYPE}} *outputs, uint32_t n) {
+    if (bank == NULL || setpoints == NULL || measures == NULL) return;
+    if (n > bank->count) n = bank->count;
+
+    const {{DATA_TYPE}} *PID_BANK_RESTRICT sp_in = setpoints;
+    const {{DATA_TYPE}} *PID_BANK_RESTRICT pv_in = measures;
+    {{DATA_TYPE}} *PID_BANK_RESTRICT integral = bank->integral;
+    {{DATA_TYPE}} *PID_BANK_RESTRICT prev_error = bank->prev_error;
+    {{DATA_TYPE}} *PID_BANK_RESTRICT prev_measure = bank->prev_measure;
+    {{DATA_TYPE}} *PID_BANK_RESTRICT prev_output = bank->prev_output;
+    {{DATA_TYPE}} *PID_BANK_RESTRICT filtered_d = bank->filtered_d;
+    {{DATA_TYPE}} *PID_BANK_RESTRICT filtered_measure = bank->filtered_measure;
+    {{DATA_TYPE}} *PID_BANK_RESTRICT filtered_setpoint = bank->filtered_setpoint;
+    {{DATA_TYPE}} *PID_BANK_RESTRICT output = bank->output;
+
+    for (uint32_t i = 0; i < n; ++i) {
+        /* 先把状态读入局部变量, 末尾按掩码混合后无条件写回 */
+        const {{DATA_TYPE}} fm = filtered_measure[i];
+        const {{DATA_TYPE}} fs = filtered_setpoint[i];
+        const {{DATA_TYPE}} integ = integral[i];
+        const {{DATA_TYPE}} pe = prev_error[i];
+        const {{DATA_TYPE}} pmeas = prev_measure[i];
+        const {{DATA_TYPE}} po = prev_output[i];
+        const {{DATA_TYPE}} fd = filtered_d[i];
+        const {{DATA_TYPE}} held = output[i];
+
+        const {{DATA_TYPE}} measure = fm * (1.0{{SFX}} - bank->in_alpha[i]) + pv_in[i] * bank->in_alpha[i];
+        const {{DATA_TYPE}} setpoint = fs * (1.0{{SFX}} - bank->sp_alpha[i]) + sp_in[i] * bank->sp_alpha[i];
+
+        {{DATA_TYPE}} error = setpoint - measure;
+        error = (fabs{{SFX}}(error) < bank->deadband[i]) ? 0.0{{SFX}} : error;
+
+        const {{DATA_TYPE}} pm = bank->p_err_mask[i];
+        const {{DATA_TYPE}} p_term = bank->Kp[i] * (pm * error - (1.0{{SFX}} - pm) * measure);
+
+        const {{DATA_TYPE}} i_inc = pid_bank_blend(bank->trap_mask[i], bank->Ki[i] * 0.5{{SFX}} * (error + pe), bank->Ki[i] * error);
+        const {{DATA_TYPE}} i_next = pid_bank_clamp(integ + i_inc, -bank->integral_limit[i], bank->integral_limit[i]);
+        const int integrate = (fabs{{SFX}}(error) < bank->i_sep[i]) & (i_inc * bank->hold[i] <= 0.0{{SFX}});
+        const {{DATA_TYPE}} i_term = integrate ? i_next : integ;
+
+        const {{DATA_TYPE}} dm = bank->d_err_mask[i];
+        {{DATA_TYPE}} d_input = dm * (error - pe) - (1.0{{SFX}} - dm) * (measure - pmeas);
+        d_input *= bank->inv_ts[i];
+        d_input = fd * (1.0{{SFX}} - bank->d_alpha[i]) + d_input * bank->d_alpha[i];
+        const {{DATA_TYPE}} d_term = bank->Kd[i] * d_input;
+
+        const {{DATA_TYPE}} ff_term = bank->Kff_w[i] * setpoint;
+
+        {{DATA_TYPE}} computed = p_term + i_term + d_term + ff_term;
+        computed = pid_bank_clamp(computed, po - bank->max_change[i], po + bank->max_change[i]);
+        computed = pid_bank_clamp(computed, -bank->output_limit[i], bank->output_limit[i]);
+
+        const {{DATA_TYPE}} out = computed - bank->vel_mask[i] * po;
+
+        /* 手动模式的通道保持全部状态与输出不变 */
+        const {{DATA_TYPE}} on = bank->auto_mask[i];
+        filtered_measure[i] = pid_bank_blend(on, measure, fm);
+        filtered_setpoint[i] = pid_bank_blend(on, setpoint, fs);
+        integral[i] = pid_bank_blend(on, i_term, integ);
+        filtered_d[i] = pid_bank_blend(on, d_input, fd);
+        prev_error[i] = pid_bank_blend(on, error, pe);
+        prev_measure[i] = pid_bank_blend(on, measure, pmeas);
+        output[i] = pid_bank_blend(on, out, held);
+        prev_output[i] = pid_bank_blend(on, computed, po);
+    }
+
+    if (outputs != NULL) {
+        for (uint32_t i = 0; i < n; ++i) outputs[i] = output[i];
+    }
+}
@@ -0,0 +1,130 @@
+/**
+ * @file    {{BANK_HEADER_NAME}}
+ * @author  YJ Studio Team (Generated by Advanced PID Code Generator)
+ * @version 2.3.0
+ * @date    {{TIMESTAMP}}
+ * @brief   Structure-of-Arrays PID Controller Bank Header File.
+ *
+ * @details 同一中断里运行多路PID时, 逐个调用 {{FUNCTION_PREFIX}}_Compute 要为每路追指针、
+ * 重复判断各项功能开关。控制器组把全部通道的增益和状态按字段存成并行数组,
+ * {{FUNCTION_PREFIX}}_ComputeBatch 对所有通道执行同一段无分支的计算:
+ * 功能开关在装载时折算为逐通道的系数/掩码(禁用的滤波器系数为1, 禁用的斜率限制为INFINITY, 其余功能对应0/1掩码),
+ * 运行时的条件只剩比较+选择, 编译器可以把整个循环向量化为SSE/AVX/NEON/Helium指令,
+ * 每条向量指令同时计算多路控制器。
+ *
+ * 每路通道的参数通过已配置好的 {{STRUCT_NAME}} 装载({{FUNCTION_PREFIX}}_BankLoad),
+ * 因此沿用单实例库的全部Set函数; 计算结果与 {{FUNCTION_PREFIX}}_Compute 一致
+ * (矩形/梯形积分按各通道的 integration 设置; 无分支改写带来的差异仅为舍入误差)。
+ */
+
+#ifndef __PID_BANK_H_TEMPLATE__
+#define __PID_BANK_H_TEMPLATE__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "{{HEADER_NAME}}"
+
+#ifndef {{FUNCTION_PREFIX}}_BANK_CAPACITY
+    #define {{FUNCTION_PREFIX}}_BANK_CAPACITY {{BANK_CAPACITY}}   /**< 控制器组最大通道数, 取SIMD宽度的整数倍最佳 */
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define PID_BANK_ALIGNED __attribute__((aligned(32)))       /**< 每个字段数组按AVX宽度对齐 */
+#else
+    #define PID_BANK_ALIGNED
+#endif
+
+/**
+ * @brief PID控制器组(结构体数组转置为数组结构体)
+ * @details 每个数组下标对应一路通道; 字段含义与 {{STRUCT_NAME}} 中的同名字段相同。
+ */
+typedef struct {
+    /* 增益 */
+    {{DATA_TYPE}} Kp[{{FUNCTION_PREFIX}}_BANK_CAPACITY] PID_BANK_ALIGNED;
+    {{DATA_TYPE}} Ki[{{FUNCTION_PREFIX}}_BANK_CAPACITY] PID_BANK_ALIGNED;
+    {{DATA_TYPE}} Kd[{{FUNCTION_PREFIX}}_BANK_CAPACITY] PID_BANK_ALIGNED;           /**< 连续域微分增益, 与微分输入的变化率相乘 */
+    {{DATA_TYPE}} Kff_w[{{FUNCTION_PREFIX}}_BANK_CAPACITY] PID_BANK_ALIGNED;        /**< Kff * ff_weight */
+
+    /* 限制与阈值 */
+    {{DATA_TYPE}} output_limit[{{FUNCTION_PREFIX}}_BANK_CAPACITY] PID_BANK_ALIGNED;
+    {{DATA_TYPE}} integral_limit[{{FUNCTION_PREFIX}}_BANK_CAPACITY] PID_BANK_ALIGNED;
+    {{DATA_TYPE}} max_change[{{FUNCTION_PREFIX}}_BANK_CAPACITY] PID_BANK_ALIGNED;   /**< output_ramp * sample_time, 未启用斜率限制时为INFINITY */
+    {{DATA_TYPE}} deadband[{{FUNCTION_PREFIX}}_BANK_CAPACITY] PID_BANK_ALIGNED;
+    {{DATA_TYPE}} i_sep[{{FUNCTION_PREFIX}}_BANK_CAPACITY] PID_BANK_ALIGNED;        /**< 积分分离阈值 */
+    {{DATA_TYPE}} inv_ts[{{FUNCTION_PREFIX}}_BANK_CAPACITY] PID_BANK_ALIGNED;       /**< 1 / sample_time */
+
+    /* 滤波系数(未启用的滤波器为1, 即直接采用新值) */
+    {{DATA_TYPE}} d_alpha[{{FUNCTION_PREFIX}}_BANK_CAPACITY] PID_BANK_ALIGNED;
+    {{DATA_TYPE}} in_alpha[{{FUNCTION_PREFIX}}_BANK_CAPACITY] PID_BANK_ALIGNED;
+    {{DATA_TYPE}} sp_alpha[{{FUNCTION_PREFIX}}_BANK_CAPACITY] PID_BANK_ALIGNED;
+
+    /* 功能掩码(0或1) */
+    {{DATA_TYPE}} auto_mask[{{FUNCTION_PREFIX}}_BANK_CAPACITY] PID_BANK_ALIGNED;    /**< 1: 自动模式; 0: 手动模式, 输出保持且状态不更新 */
+    {{DATA_TYPE}} p_err_mask[{{FUNCTION_PREFIX}}_BANK_CAPACITY] PID_BANK_ALIGNED;   /**< 1: P作用于误差; 0: P作用于测量值(I-PD) */
+    {{DATA_TYPE}} d_err_mask[{{FUNCTION_PREFIX}}_BANK_CAPACITY] PID_BANK_ALIGNED;   /**< 1: D作用于误差(标准); 0: D作用于测量值 */
+    {{DATA_TYPE}} vel_mask[{{FUNCTION_PREFIX}}_BANK_CAPACITY] PID_BANK_ALIGNED;     /**< 1: 速度式输出; 0: 位置式输出 */
+    {{DATA_TYPE}} trap_mask[{{FUNCTION_PREFIX}}_BANK_CAPACITY] PID_BANK_ALIGNED;    /**< 1: 梯形积分; 0: 矩形积分 */
+    {{DATA_TYPE}} hold[{{FUNCTION_PREFIX}}_BANK_CAPACITY] PID_BANK_ALIGNED;         /**< 外部饱和反馈(+1/-1/0), 含义同 {{STRUCT_NAME}}.integral_hold */
+
+    /* 状态 */
+    {{DATA_TYPE}} integral[{{FUNCTION_PREFIX}}_BANK_CAPACITY] PID_BANK_ALIGNED;
+    {{DATA_TYPE}} prev_error[{{FUNCTION_PREFIX}}_BANK_CAPACITY] PID_BANK_ALIGNED;
+    {{DATA_TYPE}} prev_measure[{{FUNCTION_PREFIX}}_BANK_CAPACITY] PID_BANK_ALIGNED;
+    {{DATA_TYPE}} prev_output[{{FUNCTION_PREFIX}}_BANK_CAPACITY] PID_BANK_ALIGNED;
+    {{DATA_TYPE}} filtered_d[{{FUNCTION_PREFIX}}_BANK_CAPACITY] PID_BANK_ALIGNED;
+    {{DATA_TYPE}} filtered_measure[{{FUNCTION_PREFIX}}_BANK_CAPACITY] PID_BANK_ALIGNED;
+    {{DATA_TYPE}} filtered_setpoint[{{FUNCTION_PREFIX}}_BANK_CAPACITY] PID_BANK_ALIGNED;
+    {{DATA_TYPE}} output[{{FUNCTION_PREFIX}}_BANK_CAPACITY] PID_BANK_ALIGNED;
+
+    uint32_t count;                 /**< 已装载的通道数(最大通道下标+1) */
+} {{BANK_NAME}};
+
+/* --- Public Function Declarations --- */
+
+/**
+ * @brief Clears the bank (no channels loaded).
+ */
+void {{FUNCTION_PREFIX}}_BankInit({{BANK_NAME}} *bank);
+
+/**
+ * @brief Loads configuration and state of a configured single controller into a bank channel.
+ * @param[in] channel 通道下标 (0 .. {{FUNCTION_PREFIX}}_BANK_CAPACITY-1)
+ * @param[in] pid     已通过 {{FUNCTION_PREFIX}}_Init/Set* 配置好的控制器
+ * @return true on success, false if the channel is out of range or the controller is invalid.
+ * @note 修改某路参数时, 先对对应的 {{STRUCT_NAME}} 调用Set函数再重新装载即可。
+ */
+bool {{FUNCTION_PREFIX}}_BankLoad({{BANK_NAME}} *bank, uint32_t channel, const {{STRUCT_NAME}} *pid);
+
+/**
+ * @brief Copies the running state of a bank channel back into a single controller.
+ * @note 用于在控制器组和逐实例调用之间切换, 或读取状态用于调试。
+ */
+void {{FUNCTION_PREFIX}}_BankStore(const {{BANK_NAME}} *bank, uint32_t channel, {{STRUCT_NAME}} *pid);
+
+/**
+ * @brief Clears the running state of one channel, keeping its configuration.
+ */
+void {{FUNCTION_PREFIX}}_BankReset({{BANK_NAME}} *bank, uint32_t channel);
+
+/**
+ * @brief Switches a channel between manual and automatic mode (bumpless, same as {{FUNCTION_PREFIX}}_SetMode).
+ */
+void {{FUNCTION_PREFIX}}_BankSetMode({{BANK_NAME}} *bank, uint32_t channel, PID_ModeType mode);
+
+/**
+ * @brief Blocks integration of a channel towards a saturated downstream stage (same as {{FUNCTION_PREFIX}}_SetIntegralHold).
+ * @param[in] direction +1: 积分不再增大; -1: 不再减小; 0: 解除
+ */
+void {{FUNCTION_PREFIX}}_BankSetIntegralHold({{BANK_NAME}} *bank, uint32_t channel, int8_t direction);
+
+/**
+ * @brief Computes all channels in one branch-free pass.
+ * @param[in]  setpoints 各通道设定值, 下标与通道对应
+ * @param[in]  measures  各通道测量值
+ * @param[out] outputs   各通道输出, 可为NULL(输出仍保存在 bank->output)
+ * @param[in]  n         计算前n路通道, 超过 bank->count 的部分被忽略
+ * @note Call at the common sample rate of all channels.
+ */
+void {{FUNCTION_PREFIX}}_ComputeBatch({{BANK_NAME}} *bank, const {{DATA_TYPE}} *setpoints, const {{DATA_TYPE}} *measures, {{DATA_TYPE}} *outputs, uint32_t n);
+
+#endif /* __PID_BANK_H_TEMPLATE__ */
@@ -0,0 +1,58 @@
+/**
+ * @file    {{CASCADE_SOURCE_NAME}}
+ * @author  YJ Studio Team (Generated by Advanced PID Code Generator)
+ * @version 2.3.0
+ * @date    {{TIMESTAMP}}
+ * @brief   Cascaded Multi-Loop PID Controller Implementation File.
+ */
+
+#include "{{CASCADE_HEADER_NAME}}"
+#include <stddef.h>
+#include <string.h>
+
+/* 输出饱和方向: +1/-1 为正/负向饱和, 0 为未饱和 */
+static inline int8_t pid_cascade_saturation(const {{STRUCT_NAME}} *pid) {
+    if (pid->prev_output >= pid->output_limit) return 1;
+    if (pid->prev_output <= -pid->output_limit) return -1;
+    return 0;
+}
+
+bool {{FUNCTION_PREFIX}}_CascadeInit({{CASCADE_NAME}} *cascade, uint8_t count, const uint16_t *dividers) {
+    if (cascade == NULL || dividers == NULL || count == 0 || count > {{FUNCTION_PREFIX}}_CASCADE_MAX_STAGES) return false;
+    if (dividers[count - 1] != 1) return false;
+    for (uint8_t i = 0; i + 1 < count; ++i) {
+        if (dividers[i] == 0 || dividers[i] % dividers[i + 1] != 0) return false;
+    }
+    memset(cascade, 0, sizeof(*cascade));
+    cascade->count = count;
+    for (uint8_t i = 0; i < count; ++i) {
+        cascade->divider[i] = dividers[i];
+    }
+    return true;
+}
+
+{{DATA_TYPE}} {{FUNCTION_PREFIX}}_CascadeCompute({{CASCADE_NAME}} *cascade, {{DATA_TYPE}} setpoint, const {{DATA_TYPE}} *measures) {
+    if (cascade == NULL || measures == NULL || cascade->count == 0) return 0.0{{SFX}};
+    const uint8_t last = (uint8_t)(cascade->count - 1);
+
+    cascade->setpoint[0] = setpoint;
+    for (uint8_t i = 0; i < cascade->count; ++i) {
+        if (cascade->countdown[i] == 0) {
+            cascade->countdown[i] = cascade->divider[i];
+            {{STRUCT_NAME}} *pid = &cascade->stage[i];
+            {{FUNCTION_PREFIX}}_Compute(pid, cascade->setpoint[i], measures[i]);
+            /* 传给内环的是位置式输出, 速度式外环同样适用 */
+            if (i < last) cascade->setpoint[i + 1] = pid->prev_output;
+            /* 本级饱和, 或本级积分因更内侧饱和而被保持时, 外侧一级的积分随之保持 */
+            if (i > 0) {
+                const int8_t sat = pid_cascade_saturation(pid);
+                cascade->stage[i - 1].integral_hold = (sat != 0) ? sat : pid->integral_hold;
+            }
+        }
+        cascade->countdown[i]--;
+    }
+    return cascade->stage[last].output;
+}
+
+/* --- 各串级链的初始化函数 --- */
+{{CASCADE_INITS}}
@@ -0,0 +1,63 @@
+/**
+ * @file    {{CASCADE_HEADER_NAME}}
+ * @author  YJ Studio Team (Generated by Advanced PID Code Generator)
+ * @version 2.3.0
+ * @date    {{TIMESTAMP}}
+ * @brief   Cascaded Multi-Loop PID Controller Header File.
+ *
+ * @details 串级控制(如 位置 -> 速度 -> 电流)由一次 {{FUNCTION_PREFIX}}_CascadeCompute 调用完成:
+ * - 各级控制器连续存放在同一个 {{CASCADE_NAME}} 中, 外环输出直接作为内环设定值, 不需要胶水代码;
+ * - 该函数按最内环的频率调用(如电流环中断), 第i级每 divider[i] 次调用计算一次,
+ *   外环两次计算之间内环沿用上一次的设定值;
+ * - 抗饱和沿串级向外传递: 内环输出饱和(或内环自身的积分被保持)时, 对外环调用
+ *   {{FUNCTION_PREFIX}}_SetIntegralHold, 外环积分不再朝饱和方向累积。
+ *
+ * 面板中为外环实例指定"串级内环"后, 生成器按各实例的采样时间算出分频系数(必须为整数倍),
+ * 并为每条串级链生成 {{FUNCTION_PREFIX}}_CascadeInit_<最外环实例名>。
+ */
+
+#ifndef __PID_CASCADE_H_TEMPLATE__
+#define __PID_CASCADE_H_TEMPLATE__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "{{HEADER_NAME}}"
+
+#ifndef {{FUNCTION_PREFIX}}_CASCADE_MAX_STAGES
+    #define {{FUNCTION_PREFIX}}_CASCADE_MAX_STAGES 4    /**< 串级最大级数 */
+#endif
+
+/**
+ * @brief 串级控制器
+ */
+typedef struct {
+    {{STRUCT_NAME}} stage[{{FUNCTION_PREFIX}}_CASCADE_MAX_STAGES];   /**< 各级控制器, [0]为最外环, [count-1]为最内环 */
+    {{DATA_TYPE}} setpoint[{{FUNCTION_PREFIX}}_CASCADE_MAX_STAGES];   /**< 各级当前设定值, [i+1]为第i级的输出 */
+    uint16_t divider[{{FUNCTION_PREFIX}}_CASCADE_MAX_STAGES];         /**< 第i级每divider[i]次调用计算一次, 最内环为1 */
+    uint16_t countdown[{{FUNCTION_PREFIX}}_CASCADE_MAX_STAGES];       /**< 距下次计算还需的调用次数 */
+    uint8_t count;                  /**< 级数 */
+} {{CASCADE_NAME}};
+
+/* --- Public Function Declarations --- */
+
+/**
+ * @brief Clears the cascade and sets the stage count and rate dividers.
+ * @param[in] count    级数 (1 .. {{FUNCTION_PREFIX}}_CASCADE_MAX_STAGES)
+ * @param[in] dividers 各级分频系数, 外环在前; 最内环必须为1, 每级必须是内侧一级的整数倍
+ * @return true on success, false if the arguments are invalid.
+ * @note 之后用 {{FUNCTION_PREFIX}}_Init/Set* 配置 &cascade->stage[i], 或直接调用生成的 {{FUNCTION_PREFIX}}_CascadeInit_<实例名>。
+ */
+bool {{FUNCTION_PREFIX}}_CascadeInit({{CASCADE_NAME}} *cascade, uint8_t count, const uint16_t *dividers);
+
+/**
+ * @brief Runs one tick of the cascade at the innermost loop rate.
+ * @param[in] setpoint 最外环设定值
+ * @param[in] measures 各级测量值, 外环在前; 本次不计算的级忽略其测量值
+ * @return 最内环输出
+ */
+{{DATA_TYPE}} {{FUNCTION_PREFIX}}_CascadeCompute({{CASCADE_NAME}} *cascade, {{DATA_TYPE}} setpoint, const {{DATA_TYPE}} *measures);
+
+/* --- 各串级链的初始化函数(按实例参数生成) --- */
+{{CASCADE_DECLARATIONS}}
+
+#endif /* __PID_CASCADE_H_TEMPLATE__ */
@@ -0,0 +1,123 @@
+/**
+ * @file    {{FIXED_SOURCE_NAME}}
+ * @author  YJ Studio Team (Generated by Advanced PID Code Generator)
+ * @version 2.3.0
+ * @date    {{TIMESTAMP}}
+ * @brief   Fixed-Point ({{FIXED_FORMAT}}) PID Controller Library Implementation File.
+ */
+
+#include "{{FIXED_HEADER_NAME}}"
+#include <stddef.h>
+
+#define Q_MAX   ({{Q_MAX}})
+#define Q_MIN   ({{Q_MIN}})
+#define QW_MAX  ({{QW_MAX}})
+#define QW_MIN  ({{QW_MIN}})
+
+/* 饱和到信号类型范围 */
+static inline {{Q_TYPE}} q_sat({{QW_TYPE}} v) {
+    if (v > Q_MAX) return ({{Q_TYPE}})Q_MAX;
+    if (v < Q_MIN) return ({{Q_TYPE}})Q_MIN;
+    return ({{Q_TYPE}})v;
+}
+
+static inline {{QW_TYPE}} qw_clamp({{QW_TYPE}} v, {{QW_TYPE}} limit) {
+    if (v > limit) return limit;
+    if (v < -limit) return -limit;
+    return v;
+}
+
+static inline {{QW_TYPE}} qw_abs({{QW_TYPE}} v) {
+    return (v < 0) ? -v : v;
+}
+
+/* 带四舍五入的算术右移, s >= 1 */
+static inline {{QW_TYPE}} q_rshift({{QW_TYPE}} v, int s) {
+    return (v + (({{QW_TYPE}})1 << (s - 1))) >> s;
+}
+
+/* 饱和左移 */
+static inline {{QW_TYPE}} q_lshift_sat({{QW_TYPE}} v, int s) {
+    if (s == 0) return v;
+    if (v > (QW_MAX >> s)) return QW_MAX;
+    if (v < (QW_MIN >> s)) return QW_MIN;
+    return v * (({{QW_TYPE}})1 << s);
+}
+
+/* 增益乘信号, 结果为Q{{Q_BITS}}(宽类型, 未饱和); 指数不超过{{Q_BITS}}-1, 右移量至少为1 */
+static inline {{QW_TYPE}} q_mul_gain({{FIXED_PREFIX}}_Gain g, {{QW_TYPE}} x) {
+    return q_rshift(({{QW_TYPE}})g.mant * x, {{Q_BITS}} - g.exp);
+}
+
+void {{FIXED_PREFIX}}_Init({{FIXED_NAME}} *pid, const {{FIXED_CONFIG_NAME}} *config) {
+    if (pid == NULL) return;
+    pid->config = config;
+    pid->mode = PID_MODE_AUTOMATIC;
+    {{FIXED_PREFIX}}_Reset(pid);
+}
+
+void {{FIXED_PREFIX}}_Reset({{FIXED_NAME}} *pid) {
+    if (pid == NULL) return;
+    pid->integral = 0;
+    pid->prev_error = 0;
+    pid->prev_measure = 0;
+    pid->filtered_d = 0;
+    pid->prev_output = 0;
+    pid->output = 0;
+}
+
+void {{FIXED_PREFIX}}_SetMode({{FIXED_NAME}} *pid, PID_ModeType mode) {
+    if (pid == NULL || pid->config == NULL) return;
+    if (pid->mode != mode && mode == PID_MODE_AUTOMATIC) {
+        const {{QW_TYPE}} limit = pid->config->integral_limit;
+        pid->integral = qw_clamp(pid->prev_output, limit) * (({{QW_TYPE}})1 << {{Q_BITS}});
+    }
+    pid->mode = mode;
+}
+
+void {{FIXED_PREFIX}}_SetOutput({{FIXED_NAME}} *pid, {{Q_TYPE}} output_val) {
+    if (pid != NULL && pid->config != NULL && pid->mode == PID_MODE_MANUAL) {
+        pid->output = ({{Q_TYPE}})qw_clamp(output_val, pid->config->output_limit);
+        pid->prev_output = pid->output;
+    }
+}
+
+{{Q_TYPE}} {{FIXED_PREFIX}}_Compute({{FIXED_NAME}} *pid, {{Q_TYPE}} setpoint, {{Q_TYPE}} measure) {
+    if (pid == NULL || pid->config == NULL) return 0;
+    if (pid->mode == PID_MODE_MANUAL) return pid->output;
+    const {{FIXED_CONFIG_NAME}} *cfg = pid->config;
+
+    {{QW_TYPE}} error = q_sat(({{QW_TYPE}})setpoint - measure);
+    if (qw_abs(error) < cfg->deadband) error = 0;
+
+    const {{QW_TYPE}} p_term = q_mul_gain(cfg->Kp, (cfg->type == PID_TYPE_I_PD) ? -({{QW_TYPE}})measure : error);
+
+    if (qw_abs(error) < cfg->integral_separation) {
+        const {{QW_TYPE}} prod = ({{QW_TYPE}})cfg->Ki.mant * error;
+        {{QW_TYPE}} inc = (cfg->Ki.exp >= 0) ? q_lshift_sat(prod, cfg->Ki.exp) : q_rshift(prod, -cfg->Ki.exp);
+        inc = qw_clamp(inc, ({{QW_TYPE}})1 << (2 * {{Q_BITS}}));
+        pid->integral = qw_clamp(pid->integral + inc, ({{QW_TYPE}})cfg->integral_limit << {{Q_BITS}});
+    }
+    const {{QW_TYPE}} i_term = q_rshift(pid->integral, {{Q_BITS}});
+
+    const {{QW_TYPE}} diff = q_sat((cfg->type == PID_TYPE_STANDARD) ? (error - pid->prev_error)
+                                                                   : -(({{QW_TYPE}})measure - pid->prev_measure));
+    if (cfg->d_filter_alpha != 0) {
+        pid->filtered_d = q_sat(pid->filtered_d + q_rshift(({{QW_TYPE}})cfg->d_filter_alpha * (diff - pid->filtered_d), {{Q_BITS}}));
+    } else {
+        pid->filtered_d = ({{Q_TYPE}})diff;
+    }
+    const {{QW_TYPE}} d_term = q_mul_gain(cfg->Kd, pid->filtered_d);
+
+    const {{QW_TYPE}} computed = qw_clamp(p_term + i_term + d_term, cfg->output_limit);
+
+    pid->prev_error = ({{Q_TYPE}})error;
+    pid->prev_measure = measure;
+    pid->output = (cfg->work_mode == PID_MODE_VELOCITY) ? q_sat(computed - pid->prev_output) : ({{Q_TYPE}})computed;
+    pid->prev_output = ({{Q_TYPE}})computed;
+
+    return pid->output;
+}
+
+/* --- 各实例的定点配置 --- */
+{{FIXED_INSTANCE_CONFIGS}}
@@ -0,0 +1,101 @@
+/**
+ * @file    {{FIXED_HEADER_NAME}}
+ * @author  YJ Studio Team (Generated by Advanced PID Code Generator)
+ * @version 2.3.0
+ * @date    {{TIMESTAMP}}
+ * @brief   Fixed-Point ({{FIXED_FORMAT}}) PID Controller Library Header File.
+ *
+ * @details 面向无FPU内核(如Cortex-M0)的定点PID, 计算过程只有整数乘法、移位和饱和比较。
+ * - 信号: 设定值/测量值/输出为 {{Q_TYPE}}, 数值 = q / 2^{{Q_BITS}} * {{FIXED_PREFIX}}_FULL_SCALE
+ * - 增益: 尾数+指数, 数值 = mant * 2^(exp-{{Q_BITS}}); Ki、Kd 已由生成器按采样时间换算为 Ki·Ts 和 Kd/Ts,
+ *   运行时不再做除法, 也不随采样时间重新换算
+ * - 积分累加器: {{QW_TYPE}}, 比输出多 {{Q_BITS}} 位小数, 很小的 Ki·Ts 也能逐步累积
+ * - 所有中间结果饱和到类型范围, 不会回绕
+ *
+ * 相比浮点版本, 定点版本不包含前馈、输出斜率限制、测量值滤波和设定值滤波。
+ *
+ * 生成时的量化误差报告(与同一控制律的双精度实现做闭环阶跃对比):
+{{FIXED_ERROR_REPORT}}
+ */
+
+#ifndef __PID_FIXED_H_TEMPLATE__
+#define __PID_FIXED_H_TEMPLATE__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "{{HEADER_NAME}}"
+
+#define {{FIXED_PREFIX}}_FRAC_BITS  {{Q_BITS}}
+#define {{FIXED_PREFIX}}_FULL_SCALE {{FIXED_FULL_SCALE}}   /**< q = 2^{{Q_BITS}} 对应的物理量, 仅用于换算说明 */
+
+/** @brief 定点增益: 数值 = mant * 2^(exp - {{Q_BITS}}) */
+typedef struct {
+    {{Q_TYPE}} mant;                /**< 尾数 */
+    int8_t exp;                     /**< 指数, 范围 [-{{Q_BITS}}, {{Q_BITS}}-1] */
+} {{FIXED_PREFIX}}_Gain;
+
+/**
+ * @brief 定点PID配置(只读, 可放在Flash中)
+ * @details 通常由生成器按实例参数给出(见文件末尾的各实例配置), 不在运行时换算。
+ */
+typedef struct {
+    {{FIXED_PREFIX}}_Gain Kp;        /**< 比例增益 */
+    {{FIXED_PREFIX}}_Gain Ki;        /**< 离散积分增益 Ki·Ts */
+    {{FIXED_PREFIX}}_Gain Kd;        /**< 离散微分增益 Kd/Ts */
+    {{Q_TYPE}} output_limit;        /**< 输出绝对值限幅 */
+    {{Q_TYPE}} integral_limit;      /**< 积分项绝对值限幅 */
+    {{Q_TYPE}} deadband;            /**< 误差死区 (|error| < deadband 时误差视为0) */
+    {{QW_TYPE}} integral_separation; /**< 积分分离阈值 (|error| < 此值时积分), 大于 2^{{Q_BITS}} 表示不分离 */
+    {{Q_TYPE}} d_filter_alpha;      /**< 微分低通滤波系数 Q{{Q_BITS}}, 0表示不滤波 */
+    PID_Type type;                  /**< PID计算类型, 详见 @ref PID_Type */
+    PID_WorkMode work_mode;         /**< 位置式/速度式, 详见 @ref PID_WorkMode */
+} {{FIXED_CONFIG_NAME}};
+
+/**
+ * @brief 定点PID控制器句柄
+ */
+typedef struct {
+    const {{FIXED_CONFIG_NAME}} *config; /**< 配置 */
+    {{QW_TYPE}} integral;           /**< 积分累加器, Q{{Q_BITS}}再多{{Q_BITS}}位小数 */
+    {{Q_TYPE}} prev_error;          /**< 上一周期误差 */
+    {{Q_TYPE}} prev_measure;        /**< 上一周期测量值 */
+    {{Q_TYPE}} filtered_d;          /**< 滤波后的微分输入 */
+    {{Q_TYPE}} prev_output;         /**< 上一周期(位置式)输出 */
+    {{Q_TYPE}} output;              /**< 当前输出 */
+    PID_ModeType mode;              /**< 手动/自动 */
+} {{FIXED_NAME}};
+
+/* --- Public Function Declarations --- */
+
+/**
+ * @brief Binds a configuration and clears the state (automatic mode).
+ */
+void {{FIXED_PREFIX}}_Init({{FIXED_NAME}} *pid, const {{FIXED_CONFIG_NAME}} *config);
+
+/**
+ * @brief Clears the running state, keeping configuration and mode.
+ */
+void {{FIXED_PREFIX}}_Reset({{FIXED_NAME}} *pid);
+
+/**
+ * @brief Switches between manual and automatic mode (bumpless).
+ */
+void {{FIXED_PREFIX}}_SetMode({{FIXED_NAME}} *pid, PID_ModeType mode);
+
+/**
+ * @brief Sets the held output in manual mode.
+ */
+void {{FIXED_PREFIX}}_SetOutput({{FIXED_NAME}} *pid, {{Q_TYPE}} output_val);
+
+/**
+ * @brief Computes the controller output.
+ * @param[in] setpoint 设定值 (Q{{Q_BITS}})
+ * @param[in] measure  测量值 (Q{{Q_BITS}})
+ * @return 控制器输出 (Q{{Q_BITS}}); 速度式为本周期输出增量
+ */
+{{Q_TYPE}} {{FIXED_PREFIX}}_Compute({{FIXED_NAME}} *pid, {{Q_TYPE}} setpoint, {{Q_TYPE}} measure);
+
+/* --- 各实例的定点配置(由生成器按采样时间和满量程预先换算) --- */
+{{FIXED_INSTANCE_DECLARATIONS}}
+
+#endif /* __PID_FIXED_H_TEMPLATE__ */
@@ -0,0 +1,67 @@
+/**
+ * @file    {{SCHEDULE_SOURCE_NAME}}
+ * @author  YJ Studio Team (Generated by Advanced PID Code Generator)
+ * @version 2.3.0
+ * @date    {{TIMESTAMP}}
+ * @brief   PID Gain-Scheduling Lookup Tables Implementation File.
+ */
+
+#include "{{SCHEDULE_HEADER_NAME}}"
+#include <stddef.h>
+
+static inline {{DATA_TYPE}} schedule_lerp({{DATA_TYPE}} a, {{DATA_TYPE}} b, {{DATA_TYPE}} t) {
+    return a + t * (b - a);
+}
+
+void {{FUNCTION_PREFIX}}_ScheduleLookup(const {{SCHEDULE_NAME}} *schedule, {{DATA_TYPE}} x, {{SCHEDULE_GAINS_NAME}} *out) {
+    if (schedule == NULL || out == NULL || schedule->count == 0) return;
+    const uint16_t last = (uint16_t)(schedule->count - 1);
+    /* 写成 !(x > x0) 使NaN也取首个断点 */
+    if (!(x > schedule->x[0]) || last == 0) {
+        *out = schedule->gains[0];
+        return;
+    }
+    if (x >= schedule->x[last]) {
+        *out = schedule->gains[last];
+        return;
+    }
+
+    uint16_t i;
+    {{DATA_TYPE}} t;
+    if (schedule->uniform) {
+        const {{DATA_TYPE}} pos = (x - schedule->x[0]) * schedule->inv_step;
+        i = (uint16_t)pos;
+        if (i >= last) i = (uint16_t)(last - 1);
+        t = pos - ({{DATA_TYPE}})i;
+    } else {
+        uint16_t lo = 0, hi = last;
+        while (hi - lo > 1) {
+            const uint16_t mid = (uint16_t)((lo + hi) >> 1);
+            if (x < schedule->x[mid]) hi = mid; else lo = mid;
+        }
+        i = lo;
+        t = (x - schedule->x[i]) * schedule->inv_dx[i];
+    }
+
+    const {{SCHEDULE_GAINS_NAME}} *a = &schedule->gains[i];
+    const {{SCHEDULE_GAINS_NAME}} *b = &schedule->gains[i + 1];
+    out->Kp = schedule_lerp(a->Kp, b->Kp, t);
+    out->Ki = schedule_lerp(a->Ki, b->Ki, t);
+    out->Kd = schedule_lerp(a->Kd, b->Kd, t);
+    out->Ki_continuous = schedule_lerp(a->Ki_continuous, b->Ki_continuous, t);
+    out->Kd_continuous = schedule_lerp(a->Kd_continuous, b->Kd_continuous, t);
+}
+
+void {{FUNCTION_PREFIX}}_ScheduleApply(const {{SCHEDULE_NAME}} *schedule, {{STRUCT_NAME}} *pid, {{DATA_TYPE}} x) {
+    if (schedule == NULL || pid == NULL || schedule->count == 0) return;
+    {{SCHEDULE_GAINS_NAME}} g;
+    {{FUNCTION_PREFIX}}_ScheduleLookup(schedule, x, &g);
+    pid->Kp = g.Kp;
+    pid->Ki = g.Ki;
+    pid->Kd = g.Kd;
+    pid->Ki_continuous = g.Ki_continuous;
+    pid->Kd_continuous = g.Kd_continuous;
+}
+
+/* --- 各实例的断点表 --- */
+{{SCHEDULE_TABLES}}
@@ -0,0 +1,66 @@
+/**
+ * @file    {{SCHEDULE_HEADER_NAME}}
+ * @author  YJ Studio Team (Generated by Advanced PID Code Generator)
+ * @version 2.3.0
+ * @date    {{TIMESTAMP}}
+ * @brief   PID Gain-Scheduling Lookup Tables Header File.
+ *
+ * @details 按调度变量(如转速、负载)在断点表中线性插值Kp/Ki/Kd:
+ * - 断点表由面板中各实例的"增益调度"表生成, 为只读常量(可放Flash);
+ * - 每个断点预先存放 {{FUNCTION_PREFIX}}_SetTunings 会写入的全部5个增益字段(离散Ki = Ki_continuous·Ts 等),
+ *   各段的 1/(x[i+1]-x[i]) 也写成常量表达式, 中断中调度不做除法;
+ * - 断点等间距时用 (x - x0)·(1/步长) 直接定位区间, 否则二分查找;
+ * - 调度变量超出表的范围时取端点增益。
+ *
+ * 表中离散增益按生成时实例的采样时间换算, 运行中修改采样时间后需重新生成。
+ */
+
+#ifndef __PID_SCHEDULE_H_TEMPLATE__
+#define __PID_SCHEDULE_H_TEMPLATE__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "{{HEADER_NAME}}"
+
+/**
+ * @brief 一个断点上的增益, 字段含义与 {{STRUCT_NAME}} 中的同名字段一致
+ */
+typedef struct {
+    {{DATA_TYPE}} Kp;               /**< 比例增益 */
+    {{DATA_TYPE}} Ki;               /**< 离散积分增益 (Ki_continuous * sample_time) */
+    {{DATA_TYPE}} Kd;               /**< 离散微分增益 (Kd_continuous / sample_time) */
+    {{DATA_TYPE}} Ki_continuous;    /**< 连续域积分增益 */
+    {{DATA_TYPE}} Kd_continuous;    /**< 连续域微分增益 */
+} {{SCHEDULE_GAINS_NAME}};
+
+/**
+ * @brief 增益调度断点表
+ */
+typedef struct {
+    const {{DATA_TYPE}} *x;         /**< 断点(严格递增), count个 */
+    const {{DATA_TYPE}} *inv_dx;    /**< 各段的 1/(x[i+1]-x[i]), count-1个 */
+    const {{SCHEDULE_GAINS_NAME}} *gains; /**< 各断点的增益, count个 */
+    {{DATA_TYPE}} inv_step;         /**< 等间距时为 1/步长 */
+    uint16_t count;                 /**< 断点数 (>=2) */
+    uint8_t uniform;                /**< 1: 断点等间距, 直接索引; 0: 二分查找 */
+} {{SCHEDULE_NAME}};
+
+/* --- Public Function Declarations --- */
+
+/**
+ * @brief Interpolates the gains at the given scheduling variable.
+ * @param[in]  x   调度变量, 超出范围时取端点增益
+ * @param[out] out 插值后的增益
+ */
+void {{FUNCTION_PREFIX}}_ScheduleLookup(const {{SCHEDULE_NAME}} *schedule, {{DATA_TYPE}} x, {{SCHEDULE_GAINS_NAME}} *out);
+
+/**
+ * @brief Interpolates the gains and writes them into the controller (no divisions; ISR-safe).
+ * @note 效果等同于按插值结果调用 {{FUNCTION_PREFIX}}_SetTunings, 但不做除法和采样时间换算。
+ */
+void {{FUNCTION_PREFIX}}_ScheduleApply(const {{SCHEDULE_NAME}} *schedule, {{STRUCT_NAME}} *pid, {{DATA_TYPE}} x);
+
+/* --- 各实例的断点表(按实例参数生成) --- */
+{{SCHEDULE_DECLARATIONS}}
+
+#endif /* __PID_SCHEDULE_H_TEMPLATE__ */
@@ -0,0 +1,18 @@
+/**
+ * @file    {{SPEC_SOURCE_NAME}}
+ * @author  YJ Studio Team (Generated by Advanced PID Code Generator)
+ * @version 2.3.0
+ * @date    {{TIMESTAMP}}
+ * @brief   Configuration-Specialized PID Compute Functions Implementation File.
+ */
+
+#include "{{SPEC_HEADER_NAME}}"
+#include <math.h>
+
+static inline {{DATA_TYPE}} pid_spec_clamp({{DATA_TYPE}} value, {{DATA_TYPE}} min_val, {{DATA_TYPE}} max_val) {
+    if (value < min_val) return min_val;
+    if (value > max_val) return max_val;
+    return value;
+}
+
+{{SPEC_FUNCTIONS}}
@@ -0,0 +1,29 @@
+/**
+ * @file    {{SPEC_HEADER_NAME}}
+ * @author  YJ Studio Team (Generated by Advanced PID Code Generator)
+ * @version 2.3.0
+ * @date    {{TIMESTAMP}}
+ * @brief   Configuration-Specialized PID Compute Functions Header File.
+ *
+ * @details {{FUNCTION_PREFIX}}_Compute 每次调用都要重新判断模式、滤波器、死区、PID类型、斜率限制和工作方式,
+ * 而这些设置在运行中几乎不变; 在没有分支预测的小内核上, 这些判断的开销比计算本身还大。
+ * 这里为每个实例生成一个专用的计算函数:
+ * - PID类型和位置式/速度式在生成时确定, 不再判断;
+ * - 实例配置中未启用的功能(滤波器、死区、斜率限制、前馈, 以及Ki/Kd为0时的积分/微分项)整段不生成;
+ *   积分分离随积分更新保留, 与 {{FUNCTION_PREFIX}}_Compute 一样按句柄中的阈值判断;
+ * - 启用的功能仍从 {{STRUCT_NAME}} 读取系数, 因此 Set 函数修改数值后立即生效,
+ *   计算结果与 {{FUNCTION_PREFIX}}_Compute 逐位相同(矩形/梯形积分按句柄的 integration 设置)。
+ *
+ * 运行时只保留手动/自动模式的判断。修改了某项功能的启用状态(如把死区从0改为非0)、PID类型或工作方式后,
+ * 应改回调用 {{FUNCTION_PREFIX}}_Compute, 或在面板中更新实例配置并重新生成本文件。
+ */
+
+#ifndef __PID_SPEC_H_TEMPLATE__
+#define __PID_SPEC_H_TEMPLATE__
+
+#include "{{HEADER_NAME}}"
+
+/* --- 各实例的专用计算函数 --- */
+{{SPEC_DECLARATIONS}}
+
+#endif /* __PID_SPEC_H_TEMPLATE__ */
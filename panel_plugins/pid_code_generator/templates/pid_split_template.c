@@ -0,0 +1,157 @@
+/**
+ * @file    {{SPLIT_SOURCE_NAME}}
+ * @author  YJ Studio Team (Generated by Advanced PID Code Generator)
+ * @version 2.3.0
+ * @date    {{TIMESTAMP}}
+ * @brief   Hot/Cold Split PID Controller Implementation File.
+ */
+
+#include "{{SPLIT_HEADER_NAME}}"
+#include <math.h>
+#include <stddef.h>
+
+#if !{{FUNCTION_PREFIX}}_SPLIT_DEBUG_TERMS && defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+/* 配置指针 + 8个状态量 + 模式/饱和反馈两个字节(补齐到指针对齐), float时为48字节(64位)或40字节(32位) */
+_Static_assert(sizeof({{SPLIT_STATE_NAME}}) <= 2 * sizeof(void *) + 8 * sizeof({{DATA_TYPE}}), "hot state should stay compact");
+#endif
+
+static inline {{DATA_TYPE}} pid_split_clamp({{DATA_TYPE}} value, {{DATA_TYPE}} min_val, {{DATA_TYPE}} max_val) {
+    if (value < min_val) return min_val;
+    if (value > max_val) return max_val;
+    return value;
+}
+
+void {{FUNCTION_PREFIX}}_SplitInit({{SPLIT_STATE_NAME}} *state, const {{SPLIT_CONFIG_NAME}} *config) {
+    if (state == NULL) return;
+    state->config = config;
+    state->mode = (uint8_t)PID_MODE_AUTOMATIC;
+    state->integral_hold = 0;
+    {{FUNCTION_PREFIX}}_SplitReset(state);
+}
+
+void {{FUNCTION_PREFIX}}_SplitConfigFrom({{SPLIT_CONFIG_NAME}} *config, const {{STRUCT_NAME}} *pid) {
+    if (config == NULL || pid == NULL) return;
+    config->Kp = pid->Kp;
+    config->Ki = pid->Ki;
+    config->Kd_continuous = pid->Kd_continuous;
+    config->inv_sample_time = pid->inv_sample_time;
+    config->Kff = pid->Kff;
+    config->ff_weight = pid->ff_weight;
+    config->output_limit = pid->output_limit;
+    config->integral_limit = pid->integral_limit;
+    config->max_change = pid->output_ramp * pid->sample_time;
+    config->deadband = pid->deadband;
+    config->integral_separation_threshold = pid->integral_separation_threshold;
+    config->d_filter_coef = pid->d_filter_coef;
+    config->input_filter_coef = pid->input_filter_coef;
+    config->setpoint_filter_coef = pid->setpoint_filter_coef;
+    config->type = pid->type;
+    config->work_mode = pid->work_mode;
+    config->integration = pid->integration;
+}
+
+void {{FUNCTION_PREFIX}}_SplitReset({{SPLIT_STATE_NAME}} *state) {
+    if (state == NULL) return;
+    state->integral = 0.0{{SFX}};
+    state->prev_error = 0.0{{SFX}};
+    state->prev_measure = 0.0{{SFX}};
+    state->prev_output = 0.0{{SFX}};
+    state->filtered_d = 0.0{{SFX}};
+    state->filtered_measure = 0.0{{SFX}};
+    state->filtered_setpoint = 0.0{{SFX}};
+    state->output = 0.0{{SFX}};
+#if {{FUNCTION_PREFIX}}_SPLIT_DEBUG_TERMS
+    state->last_p_term = 0.0{{SFX}};
+    state->last_i_term = 0.0{{SFX}};
+    state->last_d_term = 0.0{{SFX}};
+    state->last_ff_term = 0.0{{SFX}};
+#endif
+}
+
+void {{FUNCTION_PREFIX}}_SplitSetMode({{SPLIT_STATE_NAME}} *state, PID_ModeType mode) {
+    if (state == NULL || state->config == NULL) return;
+    if (state->mode != (uint8_t)mode && mode == PID_MODE_AUTOMATIC) {
+        const {{DATA_TYPE}} limit = state->config->integral_limit;
+        state->integral = pid_split_clamp(state->prev_output, -limit, limit);
+    }
+    state->mode = (uint8_t)mode;
+}
+
+void {{FUNCTION_PREFIX}}_SplitSetOutput({{SPLIT_STATE_NAME}} *state, {{DATA_TYPE}} output_val) {
+    if (state != NULL && state->config != NULL && state->mode == (uint8_t)PID_MODE_MANUAL) {
+        state->output = pid_split_clamp(output_val, -state->config->output_limit, state->config->output_limit);
+        state->prev_output = state->output;
+    }
+}
+
+{{DATA_TYPE}} {{FUNCTION_PREFIX}}_SplitCompute({{SPLIT_STATE_NAME}} *state, {{DATA_TYPE}} setpoint, {{DATA_TYPE}} measure) {
+    if (state == NULL || state->config == NULL) return 0.0{{SFX}};
+    if (state->mode == (uint8_t)PID_MODE_MANUAL) return state->output;
+    const {{SPLIT_CONFIG_NAME}} *cfg = state->config;
+
+    if (cfg->input_filter_coef > 0.0{{SFX}}) {
+        measure = state->filtered_measure * (1.0{{SFX}} - cfg->input_filter_coef) + measure * cfg->input_filter_coef;
+    }
+    state->filtered_measure = measure;
+
+    if (cfg->setpoint_filter_coef > 0.0{{SFX}}) {
+        setpoint = state->filtered_setpoint * (1.0{{SFX}} - cfg->setpoint_filter_coef) + setpoint * cfg->setpoint_filter_coef;
+    }
+    state->filtered_setpoint = setpoint;
+
+    {{DATA_TYPE}} error = setpoint - measure;
+    if (cfg->deadband > 0.0{{SFX}} && fabs{{SFX}}(error) < cfg->deadband) error = 0.0{{SFX}};
+
+    const {{DATA_TYPE}} p_term = (cfg->type == PID_TYPE_I_PD) ? -cfg->Kp * measure : cfg->Kp * error;
+
+    if (fabs{{SFX}}(error) < cfg->integral_separation_threshold) {
+        const {{DATA_TYPE}} i_inc = (cfg->integration == PID_INTEGRATION_TRAPEZOIDAL) ? cfg->Ki * 0.5{{SFX}} * (error + state->prev_error)
+                                                                                 : cfg->Ki * error;
+        if (i_inc * state->integral_hold <= 0.0{{SFX}}) {
+            state->integral = pid_split_clamp(state->integral + i_inc, -cfg->integral_limit, cfg->integral_limit);
+        }
+    }
+    const {{DATA_TYPE}} i_term = state->integral;
+
+    {{DATA_TYPE}} d_input = (cfg->type == PID_TYPE_STANDARD) ? (error - state->prev_error) : -(measure - state->prev_measure);
+    d_input *= cfg->inv_sample_time;
+    if (cfg->d_filter_coef > 0.0{{SFX}}) {
+        d_input = state->filtered_d * (1.0{{SFX}} - cfg->d_filter_coef) + d_input * cfg->d_filter_coef;
+    }
+    state->filtered_d = d_input;
+    const {{DATA_TYPE}} d_term = cfg->Kd_continuous * d_input;
+
+    const {{DATA_TYPE}} ff_term = cfg->Kff * setpoint * cfg->ff_weight;
+
+    {{DATA_TYPE}} computed_output = p_term + i_term + d_term + ff_term;
+    if (cfg->max_change > 0.0{{SFX}}) {
+        computed_output = state->prev_output + pid_split_clamp(computed_output - state->prev_output, -cfg->max_change, cfg->max_change);
+    }
+    computed_output = pid_split_clamp(computed_output, -cfg->output_limit, cfg->output_limit);
+
+#if {{FUNCTION_PREFIX}}_SPLIT_DEBUG_TERMS
+    state->last_p_term = p_term;
+    state->last_i_term = i_term;
+    state->last_d_term = d_term;
+    state->last_ff_term = ff_term;
+#endif
+
+    state->prev_error = error;
+    state->prev_measure = measure;
+    state->output = (cfg->work_mode == PID_MODE_VELOCITY) ? (computed_output - state->prev_output) : computed_output;
+    state->prev_output = computed_output;
+    return state->output;
+}
+
+#if {{FUNCTION_PREFIX}}_SPLIT_DEBUG_TERMS
+void {{FUNCTION_PREFIX}}_SplitGetComponents(const {{SPLIT_STATE_NAME}} *state, {{DATA_TYPE}} *p_term, {{DATA_TYPE}} *i_term, {{DATA_TYPE}} *d_term, {{DATA_TYPE}} *ff_term) {
+    if (state == NULL) return;
+    if (p_term != NULL) *p_term = state->last_p_term;
+    if (i_term != NULL) *i_term = state->last_i_term;
+    if (d_term != NULL) *d_term = state->last_d_term;
+    if (ff_term != NULL) *ff_term = state->last_ff_term;
+}
+#endif
+
+/* --- 各实例的只读配置 --- */
+{{SPLIT_INSTANCE_CONFIGS}}
@@ -0,0 +1,119 @@
+/**
+ * @file    {{SPLIT_HEADER_NAME}}
+ * @author  YJ Studio Team (Generated by Advanced PID Code Generator)
+ * @version 2.3.0
+ * @date    {{TIMESTAMP}}
+ * @brief   Hot/Cold Split PID Controller Header File.
+ *
+ * @details {{STRUCT_NAME}} 把每周期读写的状态和很少改动的配置、占位字段、调试项放在一起, 单个控制器跨多条缓存行。
+ * 冷热分离布局把两者拆开:
+ * - {{SPLIT_CONFIG_NAME}}: 增益、限幅、滤波系数等只读配置, 可声明为const放在Flash中;
+ *   采样时间相关的量(1/Ts、Ki·Ts、斜率限制每周期最大变化量)已预先换算;
+ * - {{SPLIT_STATE_NAME}}: 只含计算时读写的状态和配置指针, 不开调试项且使用float时不超过64字节, 占一条缓存行;
+ * - 调试项(P/I/D/FF分量)由编译选项 {{FUNCTION_PREFIX}}_SPLIT_DEBUG_TERMS 决定是否保存, 默认关闭。
+ *
+ * 计算结果与用相同参数配置的 {{FUNCTION_PREFIX}}_Compute 逐位相同(积分按矩形或梯形公式, 由配置决定)。
+ * 多个实例可以共用一份配置, 各自只占一块状态。
+ */
+
+#ifndef __PID_SPLIT_H_TEMPLATE__
+#define __PID_SPLIT_H_TEMPLATE__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "{{HEADER_NAME}}"
+
+#ifndef {{FUNCTION_PREFIX}}_SPLIT_DEBUG_TERMS
+    #define {{FUNCTION_PREFIX}}_SPLIT_DEBUG_TERMS 0     /**< 1: 每周期保存P/I/D/FF分量, 供 {{FUNCTION_PREFIX}}_SplitGetComponents 读取 */
+#endif
+
+/**
+ * @brief 冷数据: 只读配置(可放在Flash中)
+ */
+typedef struct {
+    {{DATA_TYPE}} Kp;               /**< 比例增益 */
+    {{DATA_TYPE}} Ki;               /**< 离散积分增益 Ki_continuous * sample_time */
+    {{DATA_TYPE}} Kd_continuous;    /**< 连续域微分增益 */
+    {{DATA_TYPE}} inv_sample_time;  /**< 1 / sample_time */
+    {{DATA_TYPE}} Kff;              /**< 前馈增益 */
+    {{DATA_TYPE}} ff_weight;        /**< 前馈权重 */
+    {{DATA_TYPE}} output_limit;     /**< 输出绝对值限幅 */
+    {{DATA_TYPE}} integral_limit;   /**< 积分绝对值限幅 */
+    {{DATA_TYPE}} max_change;       /**< 每周期输出最大变化量 output_ramp * sample_time, 0表示不限制 */
+    {{DATA_TYPE}} deadband;         /**< 误差死区 */
+    {{DATA_TYPE}} integral_separation_threshold; /**< 积分分离阈值 */
+    {{DATA_TYPE}} d_filter_coef;    /**< 微分滤波系数, 0表示不滤波 */
+    {{DATA_TYPE}} input_filter_coef;/**< 测量值滤波系数, 0表示不滤波 */
+    {{DATA_TYPE}} setpoint_filter_coef; /**< 设定值滤波系数, 0表示不滤波 */
+    PID_Type type;                  /**< PID计算类型 */
+    PID_WorkMode work_mode;         /**< 位置式/速度式 */
+    PID_IntegrationMethod integration; /**< 积分方式 */
+} {{SPLIT_CONFIG_NAME}};
+
+/**
+ * @brief 热数据: 每周期读写的状态
+ */
+typedef struct {
+    const {{SPLIT_CONFIG_NAME}} *config; /**< 配置 */
+    {{DATA_TYPE}} integral;         /**< 积分累加器 */
+    {{DATA_TYPE}} prev_error;       /**< 上一周期误差 */
+    {{DATA_TYPE}} prev_measure;     /**< 上一周期测量值 */
+    {{DATA_TYPE}} prev_output;      /**< 上一周期(位置式)输出 */
+    {{DATA_TYPE}} filtered_d;       /**< 滤波后的微分输入变化率 */
+    {{DATA_TYPE}} filtered_measure; /**< 滤波后的测量值 */
+    {{DATA_TYPE}} filtered_setpoint;/**< 滤波后的设定值 */
+    {{DATA_TYPE}} output;           /**< 当前输出 */
+    uint8_t mode;                   /**< PID_ModeType, 按字节存放 */
+    int8_t integral_hold;           /**< 外部饱和反馈, 含义同 {{STRUCT_NAME}}.integral_hold */
+#if {{FUNCTION_PREFIX}}_SPLIT_DEBUG_TERMS
+    {{DATA_TYPE}} last_p_term;      /**< 上次计算的比例项 */
+    {{DATA_TYPE}} last_i_term;      /**< 上次计算的积分项 */
+    {{DATA_TYPE}} last_d_term;      /**< 上次计算的微分项 */
+    {{DATA_TYPE}} last_ff_term;     /**< 上次计算的前馈项 */
+#endif
+} {{SPLIT_STATE_NAME}};
+
+/* --- Public Function Declarations --- */
+
+/**
+ * @brief Binds a configuration and clears the state (automatic mode).
+ */
+void {{FUNCTION_PREFIX}}_SplitInit({{SPLIT_STATE_NAME}} *state, const {{SPLIT_CONFIG_NAME}} *config);
+
+/**
+ * @brief Fills a configuration block from a configured single controller.
+ * @note 用于运行时调参: 先对 {{STRUCT_NAME}} 调用Set函数, 再换算为配置(RAM中)并重新绑定。
+ */
+void {{FUNCTION_PREFIX}}_SplitConfigFrom({{SPLIT_CONFIG_NAME}} *config, const {{STRUCT_NAME}} *pid);
+
+/**
+ * @brief Clears the running state, keeping configuration and mode.
+ */
+void {{FUNCTION_PREFIX}}_SplitReset({{SPLIT_STATE_NAME}} *state);
+
+/**
+ * @brief Switches between manual and automatic mode (bumpless).
+ */
+void {{FUNCTION_PREFIX}}_SplitSetMode({{SPLIT_STATE_NAME}} *state, PID_ModeType mode);
+
+/**
+ * @brief Sets the held output in manual mode.
+ */
+void {{FUNCTION_PREFIX}}_SplitSetOutput({{SPLIT_STATE_NAME}} *state, {{DATA_TYPE}} output_val);
+
+/**
+ * @brief Computes the controller output (same control law as {{FUNCTION_PREFIX}}_Compute).
+ */
+{{DATA_TYPE}} {{FUNCTION_PREFIX}}_SplitCompute({{SPLIT_STATE_NAME}} *state, {{DATA_TYPE}} setpoint, {{DATA_TYPE}} measure);
+
+#if {{FUNCTION_PREFIX}}_SPLIT_DEBUG_TERMS
+/**
+ * @brief Retrieves the last computed P, I, D, and FF terms. Each pointer can be NULL.
+ */
+void {{FUNCTION_PREFIX}}_SplitGetComponents(const {{SPLIT_STATE_NAME}} *state, {{DATA_TYPE}} *p_term, {{DATA_TYPE}} *i_term, {{DATA_TYPE}} *d_term, {{DATA_TYPE}} *ff_term);
+#endif
+
+/* --- 各实例的只读配置(由面板参数生成, 位于Flash) --- */
+{{SPLIT_INSTANCE_DECLARATIONS}}
+
+#endif /* __PID_SPLIT_H_TEMPLATE__ */
@@ -0,0 +1,534 @@
+/**
+ * @file    {{SWEEP_SOURCE_NAME}}
+ * @author  YJ Studio Team (Generated by Advanced PID Code Generator)
+ * @version 2.3.0
+ * @date    {{TIMESTAMP}}
+ * @brief   Closed-Loop Gain Sweep Simulator (host tool).
+ *
+ * @details 在主机上对一组(Kp, Ki, Kd)候选做闭环阶跃仿真, 按IAE/ITAE/超调量排序, 用于离线整定。
+ * - 控制器: 使用实例 {{SWEEP_BASE_NAME}} 的面板配置(采样时间、限幅、滤波、死区、PID类型、工作方式), 只替换增益;
+ *   由控制器组 {{FUNCTION_PREFIX}}_ComputeBatch 计算, 组内每个通道是一个候选, 控制器和被控对象的循环都按通道向量化。
+ * - 被控对象: 一阶惯性(FOPDT)或二阶(按零阶保持精确离散化), 可叠加执行器饱和(--u-limit)与纯滞后(--dead-time)。
+ * - 多线程: 候选按控制器组大小分块, 各线程领取整块计算, 结果与线程数无关。
+ * - 指标: IAE = ∑|e|·Ts, ITAE = ∑t·|e|·Ts, 超调量为相对设定值的百分比; 发散(非有限值)的候选排在最后。
+ *
+ * 手动编译(与生成的 {{HEADER_NAME}}/{{BANK_HEADER_NAME}} 放在同一目录):
+ *   cc -O3 -march=native -pthread {{SWEEP_SOURCE_NAME}} {{BANK_SOURCE_NAME}} <pid源文件> -lm -o pid_sweep
+ *
+ * 用法:
+ *   pid_sweep --kp MIN:MAX:N --ki MIN:MAX:N --kd MIN:MAX:N [--plant fopdt|second-order]
+ *             [--gain K] [--tau S] [--wn RAD_S] [--zeta Z] [--dead-time S] [--u-limit U]
+ *             [--setpoint R] [--duration S] [--objective iae|itae|overshoot] [--max-overshoot PCT]
+ *             [--threads N] [--top N] [--json]
+ */
+
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "{{BANK_HEADER_NAME}}"
+
+#define SWEEP_LANES         {{FUNCTION_PREFIX}}_BANK_CAPACITY
+#define SWEEP_SAMPLE_TIME   {{SWEEP_SAMPLE_TIME}}
+#define SWEEP_VELOCITY      {{SWEEP_VELOCITY}}     /* 1: 控制器为速度式, 输出增量累加后作用于对象 */
+#define SWEEP_MAX_DELAY     4096                    /* 纯滞后最大步数 */
+
+typedef enum { PLANT_FOPDT, PLANT_SECOND_ORDER } plant_kind_t;
+typedef enum { OBJECTIVE_IAE, OBJECTIVE_ITAE, OBJECTIVE_OVERSHOOT } objective_t;
+
+typedef struct {
+    double min;
+    double max;
+    uint32_t n;
+} sweep_axis_t;
+
+typedef struct {
+    plant_kind_t kind;
+    double gain;        // 静态增益K
+    double tau;         // 一阶时间常数(秒)
+    double wn;          // 二阶自然频率(rad/s)
+    double zeta;        // 二阶阻尼比
+    double dead_time;   // 纯滞后(秒), 按采样时间取整
+    double u_limit;     // 执行器饱和, 0表示不限制
+} plant_config_t;
+
+typedef struct {
+    sweep_axis_t axis[3];       // Kp, Ki, Kd(连续域)
+    plant_config_t plant;
+    double setpoint;
+    double duration;
+    objective_t objective;
+    double max_overshoot;       // 超调量上限(%), 超过的候选排在满足的之后
+    uint32_t threads;
+    uint32_t top;
+    int json;
+} sweep_options_t;
+
+typedef struct {
+    double kp, ki, kd;
+    double iae, itae, overshoot, final_error;
+    double score;
+    uint32_t index;
+    int feasible;
+} sweep_result_t;
+
+/* 被控对象离散模型: x[k+1] = phi·x[k] + gamma·u, y = x0 */
+typedef struct {
+    {{DATA_TYPE}} phi[2][2];
+    {{DATA_TYPE}} gamma[2];
+    uint32_t delay_steps;
+    {{DATA_TYPE}} u_limit;
+} plant_model_t;
+
+typedef struct {
+    const sweep_options_t* opt;
+    const plant_model_t* model;
+    sweep_result_t* results;
+    uint32_t count;
+    uint32_t steps;
+    uint32_t next_block;        // 下一个待领取的块, 各线程原子递增
+} sweep_job_t;
+
+/* 每个线程一份: 控制器组与按通道排列的对象状态 */
+typedef struct {
+    {{BANK_NAME}} bank;
+    {{DATA_TYPE}} setpoint[SWEEP_LANES] PID_BANK_ALIGNED;
+    {{DATA_TYPE}} y[SWEEP_LANES] PID_BANK_ALIGNED;
+    {{DATA_TYPE}} v[SWEEP_LANES] PID_BANK_ALIGNED;
+    {{DATA_TYPE}} u[SWEEP_LANES] PID_BANK_ALIGNED;
+    {{DATA_TYPE}} u_applied[SWEEP_LANES] PID_BANK_ALIGNED;
+    {{DATA_TYPE}} iae[SWEEP_LANES] PID_BANK_ALIGNED;
+    {{DATA_TYPE}} itae[SWEEP_LANES] PID_BANK_ALIGNED;
+    {{DATA_TYPE}} peak[SWEEP_LANES] PID_BANK_ALIGNED;
+    {{DATA_TYPE}} delay[(SWEEP_MAX_DELAY + 1) * SWEEP_LANES] PID_BANK_ALIGNED;
+} sweep_lanes_t;
+
+/* 工作线程参数: 通道状态由主线程在启动线程前分配 */
+typedef struct {
+    sweep_job_t* job;
+    sweep_lanes_t* lanes;
+} sweep_worker_t;
+
+/* 面板中实例 {{SWEEP_BASE_NAME}} 的配置, 增益由参数给出 */
+static void sweep_base_init({{STRUCT_NAME}} *pid, {{DATA_TYPE}} kp, {{DATA_TYPE}} ki, {{DATA_TYPE}} kd) {
+{{SWEEP_BASE_INIT}}
+}
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static double axis_value(const sweep_axis_t* axis, uint32_t k) {
+    return axis->n > 1 ? axis->min + (axis->max - axis->min) * (double)k / (double)(axis->n - 1) : axis->min;
+}
+
+/* 3x3矩阵指数(缩放-平方 + Taylor), 用于二阶对象的零阶保持离散化 */
+static void expm3(double m[3][3], double out[3][3]) {
+    double norm = 0.0;
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) norm = fmax(norm, fabs(m[i][j]));
+    }
+    int squarings = 0;
+    while (norm > 0.25 && squarings < 60) {
+        norm *= 0.5;
+        ++squarings;
+    }
+    double scale = ldexp(1.0, -squarings);
+    double term[3][3], next[3][3];
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            out[i][j] = (i == j) ? 1.0 : 0.0;
+            term[i][j] = out[i][j];
+        }
+    }
+    for (int k = 1; k <= 16; ++k) {
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                double s = 0.0;
+                for (int l = 0; l < 3; ++l) s += term[i][l] * m[l][j] * scale;
+                next[i][j] = s / k;
+            }
+        }
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                term[i][j] = next[i][j];
+                out[i][j] += term[i][j];
+            }
+        }
+    }
+    for (int s = 0; s < squarings; ++s) {
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                double acc = 0.0;
+                for (int l = 0; l < 3; ++l) acc += out[i][l] * out[l][j];
+                next[i][j] = acc;
+            }
+        }
+        memcpy(out, next, sizeof(next));
+    }
+}
+
+static int plant_discretize(const plant_config_t* cfg, double ts, plant_model_t* model) {
+    memset(model, 0, sizeof(*model));
+    if (cfg->kind == PLANT_FOPDT) {
+        if (cfg->tau <= 0.0) return -1;
+        double a = exp(-ts / cfg->tau);
+        model->phi[0][0] = ({{DATA_TYPE}})a;
+        model->gamma[0] = ({{DATA_TYPE}})(cfg->gain * (1.0 - a));
+    } else {
+        if (cfg->wn <= 0.0 || cfg->zeta < 0.0) return -1;
+        double m[3][3] = {
+            {0.0, ts, 0.0},
+            {-cfg->wn * cfg->wn * ts, -2.0 * cfg->zeta * cfg->wn * ts, cfg->gain * cfg->wn * cfg->wn * ts},
+            {0.0, 0.0, 0.0},
+        };
+        double e[3][3];
+        expm3(m, e);
+        for (int i = 0; i < 2; ++i) {
+            model->phi[i][0] = ({{DATA_TYPE}})e[i][0];
+            model->phi[i][1] = ({{DATA_TYPE}})e[i][1];
+            model->gamma[i] = ({{DATA_TYPE}})e[i][2];
+        }
+    }
+    double steps = floor(cfg->dead_time / ts + 0.5);
+    if (cfg->dead_time < 0.0 || steps > SWEEP_MAX_DELAY) return -1;
+    model->delay_steps = (uint32_t)steps;
+    model->u_limit = (cfg->u_limit > 0.0) ? ({{DATA_TYPE}})cfg->u_limit : ({{DATA_TYPE}})INFINITY;
+    return 0;
+}
+
+/* 计算一块(至多SWEEP_LANES个)候选, first为块内第一个候选的全局编号 */
+static void simulate_block(const sweep_job_t* job, sweep_lanes_t* s, uint32_t first) {
+    const sweep_options_t* opt = job->opt;
+    const plant_model_t* model = job->model;
+    const uint32_t n = (job->count - first < SWEEP_LANES) ? job->count - first : SWEEP_LANES;
+    const uint32_t nki = opt->axis[1].n, nkd = opt->axis[2].n;
+
+    {{FUNCTION_PREFIX}}_BankInit(&s->bank);
+    for (uint32_t lane = 0; lane < n; ++lane) {
+        uint32_t index = first + lane;
+        sweep_result_t* r = &job->results[index];
+        r->index = index;
+        r->kp = axis_value(&opt->axis[0], index / (nki * nkd));
+        r->ki = axis_value(&opt->axis[1], index / nkd % nki);
+        r->kd = axis_value(&opt->axis[2], index % nkd);
+        {{STRUCT_NAME}} pid;
+        sweep_base_init(&pid, ({{DATA_TYPE}})r->kp, ({{DATA_TYPE}})r->ki, ({{DATA_TYPE}})r->kd);
+        {{FUNCTION_PREFIX}}_BankLoad(&s->bank, lane, &pid);
+    }
+
+    const {{DATA_TYPE}} r_abs = ({{DATA_TYPE}})fabs(opt->setpoint);
+    const {{DATA_TYPE}} r_sign = (opt->setpoint < 0.0) ? -1.0{{SFX}} : 1.0{{SFX}};
+    const {{DATA_TYPE}} ts = ({{DATA_TYPE}})SWEEP_SAMPLE_TIME;
+    const {{DATA_TYPE}} p00 = model->phi[0][0], p01 = model->phi[0][1], p10 = model->phi[1][0], p11 = model->phi[1][1];
+    const {{DATA_TYPE}} g0 = model->gamma[0], g1 = model->gamma[1];
+    const {{DATA_TYPE}} u_limit = model->u_limit;
+    const uint32_t ring = model->delay_steps + 1;
+
+    for (uint32_t i = 0; i < SWEEP_LANES; ++i) {
+        s->setpoint[i] = ({{DATA_TYPE}})opt->setpoint;
+        s->y[i] = s->v[i] = s->u[i] = s->u_applied[i] = 0.0{{SFX}};
+        s->iae[i] = s->itae[i] = 0.0{{SFX}};
+        s->peak[i] = 0.0{{SFX}};
+    }
+    memset(s->delay, 0, (size_t)ring * SWEEP_LANES * sizeof(s->delay[0]));
+
+    uint32_t head = 0;
+    for (uint32_t step = 0; step < job->steps; ++step) {
+        const {{DATA_TYPE}} t_ts = ({{DATA_TYPE}})step * ts * ts;
+        {{DATA_TYPE}}* w = s->delay + (size_t)head * SWEEP_LANES;
+        const {{DATA_TYPE}}* rd = s->delay + (size_t)((head + 1) % ring) * SWEEP_LANES;
+        head = (head + 1) % ring;
+
+        {{FUNCTION_PREFIX}}_ComputeBatch(&s->bank, s->setpoint, s->y, s->u, SWEEP_LANES);
+
+        for (uint32_t i = 0; i < SWEEP_LANES; ++i) {
+            /* 指标按本周期的测量值统计 */
+            const {{DATA_TYPE}} ae = fabs{{SFX}}(s->setpoint[i] - s->y[i]);
+            s->iae[i] += ae * ts;
+            s->itae[i] += ae * t_ts;
+            const {{DATA_TYPE}} ys = s->y[i] * r_sign;
+            s->peak[i] = (ys > s->peak[i]) ? ys : s->peak[i];
+
+#if SWEEP_VELOCITY
+            s->u_applied[i] += s->u[i];
+#else
+            s->u_applied[i] = s->u[i];
+#endif
+            {{DATA_TYPE}} ua = s->u_applied[i];
+            ua = (ua > u_limit) ? u_limit : ((ua < -u_limit) ? -u_limit : ua);
+            w[i] = ua;
+        }
+        for (uint32_t i = 0; i < SWEEP_LANES; ++i) {
+            const {{DATA_TYPE}} ud = rd[i];
+            const {{DATA_TYPE}} y = s->y[i], v = s->v[i];
+            s->y[i] = p00 * y + p01 * v + g0 * ud;
+            s->v[i] = p10 * y + p11 * v + g1 * ud;
+        }
+    }
+
+    for (uint32_t lane = 0; lane < n; ++lane) {
+        sweep_result_t* r = &job->results[first + lane];
+        r->iae = s->iae[lane];
+        r->itae = s->itae[lane];
+        r->overshoot = (s->peak[lane] > r_abs && r_abs > 0.0{{SFX}}) ? 100.0 * (s->peak[lane] - r_abs) / r_abs : 0.0;
+        r->final_error = fabs(opt->setpoint - s->y[lane]);
+        double score = (opt->objective == OBJECTIVE_IAE) ? r->iae
+                     : (opt->objective == OBJECTIVE_ITAE) ? r->itae : r->overshoot;
+        int finite = isfinite(r->iae) && isfinite(r->itae) && isfinite(r->final_error);
+        r->score = finite ? score : INFINITY;
+        r->feasible = finite && r->overshoot <= opt->max_overshoot;
+    }
+}
+
+static void* sweep_worker(void* arg) {
+    sweep_worker_t* worker = (sweep_worker_t*)arg;
+    sweep_job_t* job = worker->job;
+    const uint32_t blocks = (job->count + SWEEP_LANES - 1) / SWEEP_LANES;
+    for (;;) {
+        uint32_t block = __atomic_fetch_add(&job->next_block, 1, __ATOMIC_RELAXED);
+        if (block >= blocks) break;
+        simulate_block(job, worker->lanes, block * SWEEP_LANES);
+    }
+    return NULL;
+}
+
+/* 满足超调约束的在前, 其次按目标值升序, 相同时按候选编号 */
+static int compare_results(const void* a, const void* b) {
+    const sweep_result_t* x = (const sweep_result_t*)a;
+    const sweep_result_t* y = (const sweep_result_t*)b;
+    if (x->feasible != y->feasible) return y->feasible - x->feasible;
+    if (x->score < y->score) return -1;
+    if (x->score > y->score) return 1;
+    return (x->index > y->index) - (x->index < y->index);
+}
+
+static const char* objective_name(objective_t objective) {
+    return objective == OBJECTIVE_IAE ? "iae" : (objective == OBJECTIVE_ITAE ? "itae" : "overshoot");
+}
+
+static void print_text(const sweep_options_t* opt, const sweep_result_t* results, uint32_t count,
+                       uint32_t steps, double elapsed_s) {
+    printf("实例:         {{SWEEP_BASE_NAME}} (Ts = %g s%s)\n", (double)SWEEP_SAMPLE_TIME, SWEEP_VELOCITY ? ", 速度式" : "");
+    printf("对象:         %s K=%g", opt->plant.kind == PLANT_FOPDT ? "FOPDT" : "二阶", opt->plant.gain);
+    if (opt->plant.kind == PLANT_FOPDT) {
+        printf(" tau=%g s", opt->plant.tau);
+    } else {
+        printf(" wn=%g rad/s zeta=%g", opt->plant.wn, opt->plant.zeta);
+    }
+    printf(" 滞后=%g s 饱和=%g\n", opt->plant.dead_time, opt->plant.u_limit);
+    printf("候选:         %u 组 x %u 步, %u 线程, 每组 %u 通道, 耗时 %.3f s (%.1f 万步/秒)\n", count, steps,
+           opt->threads, SWEEP_LANES, elapsed_s, (double)count * steps / elapsed_s / 1e4);
+    printf("排序:         %s, 超调上限 %g%%\n\n", objective_name(opt->objective), opt->max_overshoot);
+    printf("%4s %12s %12s %12s %12s %12s %10s %12s\n", "名次", "Kp", "Ki", "Kd", "IAE", "ITAE", "超调%", "终值误差");
+    for (uint32_t i = 0; i < count && i < opt->top; ++i) {
+        const sweep_result_t* r = &results[i];
+        printf("%4u %12.6g %12.6g %12.6g %12.6g %12.6g %10.3f %12.6g%s\n", i + 1, r->kp, r->ki, r->kd, r->iae,
+               r->itae, r->overshoot, r->final_error, r->feasible ? "" : " (超调超限)");
+    }
+}
+
+static void print_json(const sweep_options_t* opt, const sweep_result_t* results, uint32_t count,
+                       uint32_t steps, double elapsed_s) {
+    printf("{\"instance\": \"{{SWEEP_BASE_NAME}}\", \"sample_time\": %.9g, \"candidates\": %u, \"steps\": %u, "
+           "\"threads\": %u, \"lanes\": %u, \"elapsed_s\": %.6f, \"objective\": \"%s\", \"results\": [",
+           (double)SWEEP_SAMPLE_TIME, count, steps, opt->threads, SWEEP_LANES, elapsed_s,
+           objective_name(opt->objective));
+    for (uint32_t i = 0; i < count && i < opt->top; ++i) {
+        const sweep_result_t* r = &results[i];
+        printf("%s\n  {\"kp\": %.9g, \"ki\": %.9g, \"kd\": %.9g, \"iae\": %.9g, \"itae\": %.9g, "
+               "\"overshoot\": %.9g, \"final_error\": %.9g, \"feasible\": %s}",
+               i ? "," : "", r->kp, r->ki, r->kd, isfinite(r->iae) ? r->iae : -1.0,
+               isfinite(r->itae) ? r->itae : -1.0, isfinite(r->overshoot) ? r->overshoot : -1.0,
+               isfinite(r->final_error) ? r->final_error : -1.0, r->feasible ? "true" : "false");
+    }
+    printf("\n]}\n");
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr,
+            "用法: %s --kp MIN:MAX:N --ki MIN:MAX:N --kd MIN:MAX:N [选项]\n"
+            "  --plant fopdt|second-order  被控对象(默认fopdt)\n"
+            "  --gain K           对象静态增益(默认1)\n"
+            "  --tau S            一阶时间常数秒(默认0.5)\n"
+            "  --wn RAD_S         二阶自然频率(默认10)\n"
+            "  --zeta Z           二阶阻尼比(默认0.7)\n"
+            "  --dead-time S      纯滞后秒(默认0, 最多%u个采样周期)\n"
+            "  --u-limit U        执行器饱和, 0表示不限制(默认0)\n"
+            "  --setpoint R       阶跃设定值(默认1, 不能为0)\n"
+            "  --duration S       仿真时长秒(默认5)\n"
+            "  --objective iae|itae|overshoot  排序指标(默认itae)\n"
+            "  --max-overshoot PCT  超调量上限, 超过的排在后面(默认不限制)\n"
+            "  --threads N        线程数(默认在线CPU数)\n"
+            "  --top N            输出前N组(默认10)\n"
+            "  --json             以JSON输出\n",
+            prog, SWEEP_MAX_DELAY);
+}
+
+static int parse_axis(const char* text, sweep_axis_t* axis) {
+    char* end;
+    axis->min = strtod(text, &end);
+    if (*end != ':') return -1;
+    axis->max = strtod(end + 1, &end);
+    if (*end != ':') return -1;
+    unsigned long n = strtoul(end + 1, &end, 10);
+    if (*end != '\0' || n == 0 || n > 100000) return -1;
+    axis->n = (uint32_t)n;
+    /* SetTunings 不接受负增益 */
+    return (axis->min < 0.0 || axis->max < axis->min) ? -1 : 0;
+}
+
+static int parse_args(int argc, char** argv, sweep_options_t* opt) {
+    int axes = 0;
+    memset(opt, 0, sizeof(*opt));
+    opt->plant.kind = PLANT_FOPDT;
+    opt->plant.gain = 1.0;
+    opt->plant.tau = 0.5;
+    opt->plant.wn = 10.0;
+    opt->plant.zeta = 0.7;
+    opt->setpoint = 1.0;
+    opt->duration = 5.0;
+    opt->objective = OBJECTIVE_ITAE;
+    opt->max_overshoot = INFINITY;
+    opt->top = 10;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (strcmp(arg, "--json") == 0) {
+            opt->json = 1;
+            continue;
+        }
+        if (!value) return -1;
+        ++i;
+        if (strcmp(arg, "--kp") == 0 || strcmp(arg, "--ki") == 0 || strcmp(arg, "--kd") == 0) {
+            int k = (arg[3] == 'p') ? 0 : ((arg[3] == 'i') ? 1 : 2);
+            if (parse_axis(value, &opt->axis[k]) < 0) return -1;
+            axes |= 1 << k;
+        } else if (strcmp(arg, "--plant") == 0) {
+            if (strcmp(value, "fopdt") == 0) {
+                opt->plant.kind = PLANT_FOPDT;
+            } else if (strcmp(value, "second-order") == 0) {
+                opt->plant.kind = PLANT_SECOND_ORDER;
+            } else {
+                return -1;
+            }
+        } else if (strcmp(arg, "--gain") == 0) {
+            opt->plant.gain = atof(value);
+        } else if (strcmp(arg, "--tau") == 0) {
+            opt->plant.tau = atof(value);
+        } else if (strcmp(arg, "--wn") == 0) {
+            opt->plant.wn = atof(value);
+        } else if (strcmp(arg, "--zeta") == 0) {
+            opt->plant.zeta = atof(value);
+        } else if (strcmp(arg, "--dead-time") == 0) {
+            opt->plant.dead_time = atof(value);
+        } else if (strcmp(arg, "--u-limit") == 0) {
+            opt->plant.u_limit = atof(value);
+        } else if (strcmp(arg, "--setpoint") == 0) {
+            opt->setpoint = atof(value);
+        } else if (strcmp(arg, "--duration") == 0) {
+            opt->duration = atof(value);
+        } else if (strcmp(arg, "--objective") == 0) {
+            if (strcmp(value, "iae") == 0) {
+                opt->objective = OBJECTIVE_IAE;
+            } else if (strcmp(value, "itae") == 0) {
+                opt->objective = OBJECTIVE_ITAE;
+            } else if (strcmp(value, "overshoot") == 0) {
+                opt->objective = OBJECTIVE_OVERSHOOT;
+            } else {
+                return -1;
+            }
+        } else if (strcmp(arg, "--max-overshoot") == 0) {
+            opt->max_overshoot = atof(value);
+        } else if (strcmp(arg, "--threads") == 0) {
+            opt->threads = (uint32_t)strtoul(value, NULL, 10);
+        } else if (strcmp(arg, "--top") == 0) {
+            opt->top = (uint32_t)strtoul(value, NULL, 10);
+        } else {
+            return -1;
+        }
+    }
+    if (axes != 7 || opt->setpoint == 0.0 || !(opt->duration > 0.0)) return -1;
+    uint64_t count = (uint64_t)opt->axis[0].n * opt->axis[1].n * opt->axis[2].n;
+    if (count > 50000000ull) return -1;
+    if (opt->threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        opt->threads = (cpus > 0) ? (uint32_t)cpus : 1;
+    }
+    if (opt->threads > 256) opt->threads = 256;
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    sweep_options_t opt;
+    plant_model_t model;
+
+    if (parse_args(argc, argv, &opt) < 0) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (plant_discretize(&opt.plant, SWEEP_SAMPLE_TIME, &model) < 0) {
+        fprintf(stderr, "对象参数无效(时间常数/自然频率须为正, 阻尼比非负, 滞后不超过%u个采样周期)\n", SWEEP_MAX_DELAY);
+        return 2;
+    }
+
+    sweep_job_t job;
+    memset(&job, 0, sizeof(job));
+    job.opt = &opt;
+    job.model = &model;
+    job.count = opt.axis[0].n * opt.axis[1].n * opt.axis[2].n;
+    job.steps = (uint32_t)ceil(opt.duration / SWEEP_SAMPLE_TIME);
+    job.results = (sweep_result_t*)calloc(job.count, sizeof(sweep_result_t));
+    if (!job.results) {
+        fprintf(stderr, "内存不足\n");
+        return 1;
+    }
+    uint32_t blocks = (job.count + SWEEP_LANES - 1) / SWEEP_LANES;
+    if (opt.threads > blocks) opt.threads = blocks;
+
+    // 启动线程前分配好各线程的通道状态; 只分配到一部分时减少线程数, 块由其余线程领取
+    sweep_worker_t workers[256];
+    uint32_t allocated = 0;
+    for (; allocated < opt.threads; ++allocated) {
+        workers[allocated].job = &job;
+        if (posix_memalign((void**)&workers[allocated].lanes, 64, sizeof(sweep_lanes_t)) != 0) break;
+    }
+    if (allocated == 0) {
+        fprintf(stderr, "内存不足\n");
+        free(job.results);
+        return 1;
+    }
+    opt.threads = allocated;
+
+    uint64_t t0 = monotonic_ns();
+    pthread_t threads[256];
+    uint32_t started = 0;
+    for (; started < opt.threads; ++started) {
+        if (pthread_create(&threads[started], NULL, sweep_worker, &workers[started]) != 0) break;
+    }
+    if (started == 0) sweep_worker(&workers[0]);
+    for (uint32_t i = 0; i < started; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+    double elapsed_s = (double)(monotonic_ns() - t0) / 1e9;
+    if (elapsed_s <= 0.0) elapsed_s = 1e-9;
+    for (uint32_t i = 0; i < opt.threads; ++i) free(workers[i].lanes);
+    opt.threads = started ? started : 1;
+
+    qsort(job.results, job.count, sizeof(sweep_result_t), compare_results);
+    if (opt.json) {
+        print_json(&opt, job.results, job.count, job.steps, elapsed_s);
+    } else {
+        print_text(&opt, job.results, job.count, job.steps, elapsed_s);
+    }
+    free(job.results);
+    return 0;
+}
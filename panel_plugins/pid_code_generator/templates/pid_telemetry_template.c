@@ -0,0 +1,285 @@
+/**
+ * @file    {{TELEMETRY_SOURCE_NAME}}
+ * @author  YJ Studio Team (Generated by Advanced PID Code Generator)
+ * @version 2.3.0
+ * @date    {{TIMESTAMP}}
+ * @brief   High-Rate PID Telemetry Streaming Implementation File.
+ */
+
+#include "{{TELEMETRY_HEADER_NAME}}"
+#include <stddef.h>
+#include <string.h>
+
+#define TELEMETRY_RING_MASK ((uint32_t)({{FUNCTION_PREFIX}}_TELEMETRY_RING_RECORDS - 1))
+
+#if {{FUNCTION_PREFIX}}_TELEMETRY_USE_YJ_PROTOCOL && ({{FUNCTION_PREFIX}}_TELEMETRY_MAX_PAYLOAD > YJ_MAX_DATA_PAYLOAD_SIZE)
+    #error "{{FUNCTION_PREFIX}}_TELEMETRY_MAX_PAYLOAD exceeds YJ_MAX_DATA_PAYLOAD_SIZE"
+#endif
+
+#if {{FUNCTION_PREFIX}}_TELEMETRY_MAX_PAYLOAD < {{FUNCTION_PREFIX}}_TELEMETRY_HEADER_SIZE + 4
+    #error "{{FUNCTION_PREFIX}}_TELEMETRY_MAX_PAYLOAD cannot hold the header plus one record"
+#endif
+
+/* 一个待发送批次, 打包后在发送成功时才从缓冲中移除 */
+typedef struct {
+    uint32_t records;       /* 本帧记录数 */
+    uint32_t dropped;       /* 打包时的丢弃总数 */
+    uint8_t flags;          /* 帧头flags */
+} telemetry_batch_t;
+
+static {{DATA_TYPE}} telemetry_field(const {{STRUCT_NAME}} *pid, uint8_t field) {
+    switch (field) {
+        case PID_TELEMETRY_SETPOINT: return pid->filtered_setpoint;
+        case PID_TELEMETRY_MEASURE:  return pid->filtered_measure;
+        case PID_TELEMETRY_OUTPUT:   return pid->output;
+        case PID_TELEMETRY_P_TERM:   return pid->last_p_term;
+        case PID_TELEMETRY_I_TERM:   return pid->last_i_term;
+        case PID_TELEMETRY_D_TERM:   return pid->last_d_term;
+        default:                     return pid->last_ff_term;
+    }
+}
+
+static uint8_t telemetry_field_count(uint8_t field_mask) {
+    uint8_t n = 0;
+    for (; field_mask != 0; field_mask &= (uint8_t)(field_mask - 1)) ++n;
+    return n;
+}
+
+static inline bool telemetry_idle(const {{TELEMETRY_NAME}} *tm) {
+    return tm->state == PID_TELEMETRY_STOPPED || tm->state == PID_TELEMETRY_DONE;
+}
+
+void {{FUNCTION_PREFIX}}_TelemetryInit({{TELEMETRY_NAME}} *tm, uint8_t id) {
+    if (tm == NULL) return;
+    memset(tm, 0, sizeof(*tm));
+    tm->id = id;
+    tm->field_mask = PID_TELEMETRY_FIELDS_ALL;
+    tm->decimation = 1;
+    tm->trigger_edge = PID_TELEMETRY_EDGE_RISING;
+    tm->pre_trigger = {{FUNCTION_PREFIX}}_TELEMETRY_RING_RECORDS / 2;
+    tm->post_trigger = {{FUNCTION_PREFIX}}_TELEMETRY_RING_RECORDS / 2;
+    tm->state = PID_TELEMETRY_STOPPED;
+}
+
+bool {{FUNCTION_PREFIX}}_TelemetryAddChannel({{TELEMETRY_NAME}} *tm, {{STRUCT_NAME}} *pid) {
+    if (tm == NULL || pid == NULL || !telemetry_idle(tm)) return false;
+    if (tm->channel_count >= {{FUNCTION_PREFIX}}_TELEMETRY_MAX_CHANNELS) return false;
+    const uint16_t record_bytes = (uint16_t)((tm->channel_count + 1) * telemetry_field_count(tm->field_mask) * 4);
+    if ({{FUNCTION_PREFIX}}_TELEMETRY_HEADER_SIZE + record_bytes > {{FUNCTION_PREFIX}}_TELEMETRY_MAX_PAYLOAD) return false;
+    tm->channels[tm->channel_count++] = pid;
+    tm->record_floats = (uint8_t)(tm->channel_count * telemetry_field_count(tm->field_mask));
+    return true;
+}
+
+bool {{FUNCTION_PREFIX}}_TelemetryConfigure({{TELEMETRY_NAME}} *tm, uint8_t field_mask, uint16_t decimation) {
+    if (tm == NULL || !telemetry_idle(tm)) return false;
+    field_mask &= PID_TELEMETRY_FIELDS_ALL;
+    if (field_mask == 0) field_mask = PID_TELEMETRY_FIELDS_ALL;
+    const uint8_t floats = (uint8_t)(tm->channel_count * telemetry_field_count(field_mask));
+    if ({{FUNCTION_PREFIX}}_TELEMETRY_HEADER_SIZE + floats * 4 > {{FUNCTION_PREFIX}}_TELEMETRY_MAX_PAYLOAD) return false;
+    tm->field_mask = field_mask;
+    tm->record_floats = floats;
+    tm->decimation = (decimation == 0) ? 1 : decimation;
+    return true;
+}
+
+bool {{FUNCTION_PREFIX}}_TelemetrySetTrigger({{TELEMETRY_NAME}} *tm, uint8_t channel, PID_TelemetryField field,
+                                             PID_TelemetryEdge edge, {{DATA_TYPE}} level,
+                                             uint16_t pre_trigger, uint16_t post_trigger) {
+    if (tm == NULL || !telemetry_idle(tm) || channel >= tm->channel_count) return false;
+    tm->trigger_channel = channel;
+    tm->trigger_field = (uint8_t)field;
+    tm->trigger_edge = (uint8_t)edge;
+    tm->trigger_level = level;
+    tm->pre_trigger = (pre_trigger < {{FUNCTION_PREFIX}}_TELEMETRY_RING_RECORDS) ? pre_trigger
+                                                                                  : {{FUNCTION_PREFIX}}_TELEMETRY_RING_RECORDS - 1;
+    tm->post_trigger = (post_trigger == 0) ? 1 : post_trigger;
+    return true;
+}
+
+/* 清空缓冲后最后写状态, 中断看到新状态时缓冲已就绪 */
+static bool telemetry_begin({{TELEMETRY_NAME}} *tm, PID_TelemetryState state) {
+    if (tm == NULL || tm->channel_count == 0 || !telemetry_idle(tm)) return false;
+    tm->head = 0;
+    tm->tail = 0;
+    tm->dropped = 0;
+    tm->dropped_reported = 0;
+    tm->tick = 0;
+    tm->decimation_count = (uint16_t)(tm->decimation - 1); /* 第一个控制周期即采样 */
+    tm->trigger_primed = 0;
+    tm->post_remaining = tm->post_trigger;
+    {{FUNCTION_PREFIX}}_TELEMETRY_BARRIER();
+    tm->state = (uint8_t)state;
+    return true;
+}
+
+bool {{FUNCTION_PREFIX}}_TelemetryStart({{TELEMETRY_NAME}} *tm) {
+    return telemetry_begin(tm, PID_TELEMETRY_STREAMING);
+}
+
+bool {{FUNCTION_PREFIX}}_TelemetryArm({{TELEMETRY_NAME}} *tm) {
+    return telemetry_begin(tm, PID_TELEMETRY_ARMED);
+}
+
+void {{FUNCTION_PREFIX}}_TelemetryStop({{TELEMETRY_NAME}} *tm) {
+    if (tm == NULL) return;
+    tm->state = PID_TELEMETRY_STOPPED;
+}
+
+PID_TelemetryState {{FUNCTION_PREFIX}}_TelemetryGetState(const {{TELEMETRY_NAME}} *tm) {
+    return (tm == NULL) ? PID_TELEMETRY_STOPPED : (PID_TelemetryState)tm->state;
+}
+
+void {{FUNCTION_PREFIX}}_TelemetrySample({{TELEMETRY_NAME}} *tm) {
+    if (tm == NULL) return;
+    const uint8_t state = tm->state;
+    const uint32_t tick = tm->tick++;
+    if (state != PID_TELEMETRY_STREAMING && state != PID_TELEMETRY_ARMED && state != PID_TELEMETRY_TRIGGERED) return;
+    if (++tm->decimation_count < tm->decimation) return;
+    tm->decimation_count = 0;
+
+    const uint32_t head = tm->head;
+    if (head - tm->tail >= {{FUNCTION_PREFIX}}_TELEMETRY_RING_RECORDS) {
+        if (state == PID_TELEMETRY_ARMED) {
+            tm->tail = head - TELEMETRY_RING_MASK; /* 预触发阶段覆盖最旧的记录 */
+        } else {
+            tm->dropped++;
+            if (state == PID_TELEMETRY_TRIGGERED && --tm->post_remaining == 0) tm->state = PID_TELEMETRY_DONE;
+            return;
+        }
+    }
+
+    float *dst = tm->ring[head & TELEMETRY_RING_MASK];
+    for (uint8_t ch = 0; ch < tm->channel_count; ++ch) {
+        const {{STRUCT_NAME}} *pid = tm->channels[ch];
+        const {{DATA_TYPE}} values[{{FUNCTION_PREFIX}}_TELEMETRY_FIELD_COUNT] = {
+            pid->filtered_setpoint, pid->filtered_measure, pid->output,
+            pid->last_p_term, pid->last_i_term, pid->last_d_term, pid->last_ff_term
+        };
+        for (uint8_t f = 0; f < {{FUNCTION_PREFIX}}_TELEMETRY_FIELD_COUNT; ++f) {
+            if (tm->field_mask & (1u << f)) *dst++ = (float)values[f];
+        }
+    }
+    tm->ring_tick[head & TELEMETRY_RING_MASK] = tick;
+    {{FUNCTION_PREFIX}}_TELEMETRY_BARRIER();
+    tm->head = head + 1;
+
+    if (state == PID_TELEMETRY_TRIGGERED) {
+        if (--tm->post_remaining == 0) tm->state = PID_TELEMETRY_DONE;
+        return;
+    }
+    if (state != PID_TELEMETRY_ARMED) return;
+
+    /* 预触发记录攒够后才检查边沿, 保证触发记录之前有 pre_trigger 条历史 */
+    const {{DATA_TYPE}} value = telemetry_field(tm->channels[tm->trigger_channel], tm->trigger_field);
+    const {{DATA_TYPE}} prev = tm->trigger_prev;
+    const {{DATA_TYPE}} level = tm->trigger_level;
+    bool fired = false;
+    if (tm->trigger_primed && tm->head - tm->tail > tm->pre_trigger) {
+        const bool rising = prev < level && value >= level;
+        const bool falling = prev > level && value <= level;
+        fired = (tm->trigger_edge == PID_TELEMETRY_EDGE_RISING) ? rising
+              : (tm->trigger_edge == PID_TELEMETRY_EDGE_FALLING) ? falling : (rising || falling);
+    }
+    tm->trigger_prev = value;
+    tm->trigger_primed = 1;
+    if (fired) {
+        tm->tail = head - tm->pre_trigger;
+        tm->post_remaining = (uint16_t)(tm->post_trigger - 1);
+        {{FUNCTION_PREFIX}}_TELEMETRY_BARRIER();
+        tm->state = (tm->post_remaining == 0) ? PID_TELEMETRY_DONE : PID_TELEMETRY_TRIGGERED;
+    }
+}
+
+static uint8_t *telemetry_put_u16(uint8_t *p, uint16_t value) {
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+    return p + 2;
+}
+
+static uint8_t *telemetry_put_u32(uint8_t *p, uint32_t value) {
+    p = telemetry_put_u16(p, (uint16_t)value);
+    return telemetry_put_u16(p, (uint16_t)(value >> 16));
+}
+
+/* 打包但不移出缓冲; 返回0表示无可发送内容 */
+static uint16_t telemetry_peek(const {{TELEMETRY_NAME}} *tm, uint8_t *buffer, uint16_t max_len, telemetry_batch_t *batch) {
+    /* 先读状态再读写指针: 状态为DONE时写指针已是最终值 */
+    const uint8_t state = tm->state;
+    if (state != PID_TELEMETRY_STREAMING && state != PID_TELEMETRY_TRIGGERED && state != PID_TELEMETRY_DONE) return 0;
+    const uint32_t head = tm->head;
+    {{FUNCTION_PREFIX}}_TELEMETRY_BARRIER();
+    const uint32_t tail = tm->tail;
+    const uint16_t record_bytes = (uint16_t)(tm->record_floats * 4);
+    if (max_len < {{FUNCTION_PREFIX}}_TELEMETRY_HEADER_SIZE + record_bytes) return 0;
+    if (head == tail && state != PID_TELEMETRY_DONE) return 0;
+
+    /* 帧内只放控制周期计数连续的记录, 丢弃造成的间隔从下一帧开始 */
+    const uint32_t limit = (uint32_t)(max_len - {{FUNCTION_PREFIX}}_TELEMETRY_HEADER_SIZE) / record_bytes;
+    const uint32_t first_tick = (tail != head) ? tm->ring_tick[tail & TELEMETRY_RING_MASK] : tm->tick;
+    uint32_t n = 0;
+    while (tail + n != head && n < limit
+           && tm->ring_tick[(tail + n) & TELEMETRY_RING_MASK] == first_tick + n * tm->decimation) {
+        ++n;
+    }
+
+    batch->records = n;
+    batch->dropped = tm->dropped;
+    batch->flags = 0;
+    if (state != PID_TELEMETRY_STREAMING) batch->flags |= PID_TELEMETRY_FLAG_CAPTURE;
+    if (state == PID_TELEMETRY_DONE && tail + n == head) batch->flags |= PID_TELEMETRY_FLAG_LAST;
+    const uint32_t lost = batch->dropped - tm->dropped_reported;
+
+    uint8_t *p = buffer;
+    *p++ = tm->id;
+    *p++ = batch->flags;
+    *p++ = tm->channel_count;
+    *p++ = tm->field_mask;
+    p = telemetry_put_u32(p, first_tick);
+    p = telemetry_put_u16(p, tm->decimation);
+    p = telemetry_put_u16(p, (lost > 0xFFFFu) ? 0xFFFFu : (uint16_t)lost);
+    for (uint32_t r = 0; r < n; ++r) {
+        const float *src = tm->ring[(tail + r) & TELEMETRY_RING_MASK];
+        for (uint8_t i = 0; i < tm->record_floats; ++i) {
+            union { float f; uint32_t u; } v;
+            v.f = src[i];
+            p = telemetry_put_u32(p, v.u);
+        }
+    }
+    return (uint16_t)(p - buffer);
+}
+
+static void telemetry_commit({{TELEMETRY_NAME}} *tm, const telemetry_batch_t *batch) {
+    tm->dropped_reported = batch->dropped;
+    {{FUNCTION_PREFIX}}_TELEMETRY_BARRIER();
+    tm->tail += batch->records;
+    if (batch->flags & PID_TELEMETRY_FLAG_LAST) tm->state = PID_TELEMETRY_STOPPED;
+}
+
+uint16_t {{FUNCTION_PREFIX}}_TelemetryPack({{TELEMETRY_NAME}} *tm, uint8_t *buffer, uint16_t max_len) {
+    if (tm == NULL || buffer == NULL) return 0;
+    telemetry_batch_t batch;
+    const uint16_t len = telemetry_peek(tm, buffer, max_len, &batch);
+    if (len > 0) telemetry_commit(tm, &batch);
+    return len;
+}
+
+#if {{FUNCTION_PREFIX}}_TELEMETRY_USE_YJ_PROTOCOL
+int32_t {{FUNCTION_PREFIX}}_TelemetrySend({{TELEMETRY_NAME}} *tm, yj_protocol_handler_t *handler, uint8_t dest_addr) {
+    if (tm == NULL || handler == NULL) return -1;
+    uint8_t payload[{{FUNCTION_PREFIX}}_TELEMETRY_MAX_PAYLOAD];
+    int32_t frames = 0;
+    /* 每帧至少一条记录, 最多发送一个缓冲长度的帧数, 采样快于链路时也能返回 */
+    while (frames < {{FUNCTION_PREFIX}}_TELEMETRY_RING_RECORDS) {
+        telemetry_batch_t batch;
+        const uint16_t len = telemetry_peek(tm, payload, sizeof(payload), &batch);
+        if (len == 0) break;
+        const int32_t ret = yj_protocol_send_frame(handler, dest_addr, {{FUNCTION_PREFIX}}_TELEMETRY_FUNC_ID, payload, len);
+        if (ret != 0) return ret;
+        telemetry_commit(tm, &batch);
+        ++frames;
+        if (batch.flags & PID_TELEMETRY_FLAG_LAST) break;
+    }
+    return frames;
+}
+#endif
@@ -0,0 +1,223 @@
+/**
+ * @file    {{TELEMETRY_HEADER_NAME}}
+ * @author  YJ Studio Team (Generated by Advanced PID Code Generator)
+ * @version 2.3.0
+ * @date    {{TIMESTAMP}}
+ * @brief   High-Rate PID Telemetry Streaming Header File.
+ *
+ * @details 在控制中断里按控制周期采集若干个 {{STRUCT_NAME}} 的设定值、测量值、输出和P/I/D/FF分量,
+ * 主循环中打包成批经YJ协议发送(功能码 {{FUNCTION_PREFIX}}_TELEMETRY_FUNC_ID):
+ * - 单生产者/单消费者环形缓冲, 中断写入、主循环读取, 不关中断也不加锁;
+ * - 每 decimation 个控制周期采一条记录, 只保存 field_mask 选中的字段(float32);
+ * - 连续模式: 边采边发, 缓冲满时丢弃新记录并在下一帧报告丢失数;
+ * - 触发模式: 预触发期间循环覆盖, 满足边沿条件后保留 pre_trigger 条历史和 post_trigger 条后续记录, 采完自动停止;
+ * - 一帧 = 12字节帧头 + 若干条等长记录(小端), 帧内记录在时间上连续, 上位机解析面板用"重复记录"模式即可逐条绘图。
+ */
+
+#ifndef __PID_TELEMETRY_H_TEMPLATE__
+#define __PID_TELEMETRY_H_TEMPLATE__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "{{HEADER_NAME}}"
+
+#ifndef {{FUNCTION_PREFIX}}_TELEMETRY_USE_YJ_PROTOCOL
+    #define {{FUNCTION_PREFIX}}_TELEMETRY_USE_YJ_PROTOCOL 1   /**< 为0时不依赖yj_protocol, 只提供 {{FUNCTION_PREFIX}}_TelemetryPack */
+#endif
+
+#if {{FUNCTION_PREFIX}}_TELEMETRY_USE_YJ_PROTOCOL
+#include "yj_protocol.h"
+#endif
+
+#ifndef {{FUNCTION_PREFIX}}_TELEMETRY_FUNC_ID
+    #define {{FUNCTION_PREFIX}}_TELEMETRY_FUNC_ID {{TELEMETRY_FUNC_ID}}         /**< 遥测帧功能码 */
+#endif
+
+#ifndef {{FUNCTION_PREFIX}}_TELEMETRY_MAX_CHANNELS
+    #define {{FUNCTION_PREFIX}}_TELEMETRY_MAX_CHANNELS 4     /**< 一路遥测最多采集的控制器数 */
+#endif
+
+#ifndef {{FUNCTION_PREFIX}}_TELEMETRY_RING_RECORDS
+    #define {{FUNCTION_PREFIX}}_TELEMETRY_RING_RECORDS 64    /**< 环形缓冲记录数, 须为2的幂 */
+#endif
+
+#ifndef {{FUNCTION_PREFIX}}_TELEMETRY_MAX_PAYLOAD
+    #if {{FUNCTION_PREFIX}}_TELEMETRY_USE_YJ_PROTOCOL && (YJ_MAX_DATA_PAYLOAD_SIZE < 256)
+        #define {{FUNCTION_PREFIX}}_TELEMETRY_MAX_PAYLOAD YJ_MAX_DATA_PAYLOAD_SIZE  /**< 单帧数据负载上限, 协议负载上限较小时取协议上限 */
+    #else
+        #define {{FUNCTION_PREFIX}}_TELEMETRY_MAX_PAYLOAD 256    /**< 单帧数据负载上限, 不超过 YJ_MAX_DATA_PAYLOAD_SIZE */
+    #endif
+#endif
+
+/* 中断写记录与发布写指针之间的编译器屏障; 多核或带写缓冲的总线上可定义为硬件屏障(如 __DMB()) */
+#ifndef {{FUNCTION_PREFIX}}_TELEMETRY_BARRIER
+    #if defined(__GNUC__)
+        #define {{FUNCTION_PREFIX}}_TELEMETRY_BARRIER() __asm__ __volatile__("" ::: "memory")
+    #else
+        #define {{FUNCTION_PREFIX}}_TELEMETRY_BARRIER()
+    #endif
+#endif
+
+#if ({{FUNCTION_PREFIX}}_TELEMETRY_RING_RECORDS & ({{FUNCTION_PREFIX}}_TELEMETRY_RING_RECORDS - 1)) != 0
+    #error "{{FUNCTION_PREFIX}}_TELEMETRY_RING_RECORDS must be a power of two"
+#endif
+
+#define {{FUNCTION_PREFIX}}_TELEMETRY_FIELD_COUNT 7       /**< 每个控制器可采集的字段数 */
+#define {{FUNCTION_PREFIX}}_TELEMETRY_HEADER_SIZE 12      /**< 遥测帧头字节数 */
+
+/**
+ * @brief 可采集的字段, 记录中按此顺序排列(field_mask 的位号)
+ */
+typedef enum {
+    PID_TELEMETRY_SETPOINT  = 0,    /**< 设定值(经设定值滤波) */
+    PID_TELEMETRY_MEASURE   = 1,    /**< 测量值(经输入滤波) */
+    PID_TELEMETRY_OUTPUT    = 2,    /**< 控制器输出(速度式为增量) */
+    PID_TELEMETRY_P_TERM    = 3,    /**< 比例项 */
+    PID_TELEMETRY_I_TERM    = 4,    /**< 积分项 */
+    PID_TELEMETRY_D_TERM    = 5,    /**< 微分项 */
+    PID_TELEMETRY_FF_TERM   = 6     /**< 前馈项 */
+} PID_TelemetryField;
+
+#define PID_TELEMETRY_FIELDS_ALL    0x7Fu   /**< 全部7个字段 */
+#define PID_TELEMETRY_FIELDS_BASIC  0x07u   /**< 设定值、测量值、输出 */
+
+/**
+ * @brief 触发边沿
+ */
+typedef enum {
+    PID_TELEMETRY_EDGE_RISING   = 0,    /**< 由低于触发电平变为不低于 */
+    PID_TELEMETRY_EDGE_FALLING  = 1,    /**< 由高于触发电平变为不高于 */
+    PID_TELEMETRY_EDGE_EITHER   = 2     /**< 任一方向穿越 */
+} PID_TelemetryEdge;
+
+/**
+ * @brief 遥测状态
+ */
+typedef enum {
+    PID_TELEMETRY_STOPPED   = 0,    /**< 未采集 */
+    PID_TELEMETRY_STREAMING = 1,    /**< 连续模式, 边采边发 */
+    PID_TELEMETRY_ARMED     = 2,    /**< 触发模式, 等待触发(循环覆盖预触发数据) */
+    PID_TELEMETRY_TRIGGERED = 3,    /**< 已触发, 正在采集触发后的记录 */
+    PID_TELEMETRY_DONE      = 4     /**< 触发采集完成, 缓冲中的记录发完后结束 */
+} PID_TelemetryState;
+
+/* 帧头 flags */
+#define PID_TELEMETRY_FLAG_CAPTURE  0x01u   /**< 本帧属于一次触发采集 */
+#define PID_TELEMETRY_FLAG_LAST     0x02u   /**< 触发采集的最后一帧 */
+
+/**
+ * @brief 一路遥测
+ * @note 中断中只调用 {{FUNCTION_PREFIX}}_TelemetrySample; 其余函数在主循环中调用, 配置函数须在停止状态下调用。
+ */
+typedef struct {
+    {{STRUCT_NAME}} *channels[{{FUNCTION_PREFIX}}_TELEMETRY_MAX_CHANNELS]; /**< 被采集的控制器 */
+    uint8_t channel_count;          /**< 控制器数 */
+    uint8_t id;                     /**< 帧头中的遥测编号, 用于区分多路遥测 */
+    uint8_t field_mask;             /**< 采集的字段, 位号见 @ref PID_TelemetryField */
+    uint8_t record_floats;          /**< 每条记录的float数 = 控制器数 × 选中字段数 */
+    uint16_t decimation;            /**< 每N个控制周期采一条记录 (>=1) */
+    uint16_t decimation_count;      /**< 抽取计数 */
+
+    /* 触发配置 */
+    uint8_t trigger_channel;        /**< 触发源控制器下标 */
+    uint8_t trigger_field;          /**< 触发源字段, 详见 @ref PID_TelemetryField */
+    uint8_t trigger_edge;           /**< 触发边沿, 详见 @ref PID_TelemetryEdge */
+    uint8_t trigger_primed;         /**< 已有上一条记录的触发源值 */
+    {{DATA_TYPE}} trigger_level;    /**< 触发电平 */
+    {{DATA_TYPE}} trigger_prev;     /**< 上一条记录的触发源值 */
+    uint16_t pre_trigger;           /**< 触发前保留的记录数 */
+    uint16_t post_trigger;          /**< 触发后采集的记录数(含触发记录) */
+    uint16_t post_remaining;        /**< 尚需采集的触发后记录数 */
+
+    /* 环形缓冲: head 只由中断写; tail 在 ARMED 时由中断写, 其余状态由主循环写 */
+    volatile uint8_t state;         /**< 当前状态, 详见 @ref PID_TelemetryState */
+    volatile uint32_t head;         /**< 写入的记录总数 */
+    volatile uint32_t tail;         /**< 已发送(或被覆盖)的记录总数 */
+    volatile uint32_t dropped;      /**< 缓冲满丢弃的记录总数 */
+    uint32_t dropped_reported;      /**< 已在帧头中报告的丢弃数 */
+    uint32_t tick;                  /**< 控制周期计数 */
+    uint32_t ring_tick[{{FUNCTION_PREFIX}}_TELEMETRY_RING_RECORDS]; /**< 各记录的控制周期计数 */
+    float ring[{{FUNCTION_PREFIX}}_TELEMETRY_RING_RECORDS][{{FUNCTION_PREFIX}}_TELEMETRY_MAX_CHANNELS * {{FUNCTION_PREFIX}}_TELEMETRY_FIELD_COUNT];
+} {{TELEMETRY_NAME}};
+
+/* --- Public Function Declarations --- */
+
+/**
+ * @brief Initializes an empty, stopped telemetry stream.
+ * @note 默认: 全部字段、不抽取、上升沿触发(电平0, 预触发/触发后各为缓冲的一半)。
+ */
+void {{FUNCTION_PREFIX}}_TelemetryInit({{TELEMETRY_NAME}} *tm, uint8_t id);
+
+/**
+ * @brief Adds a controller to the stream.
+ * @return false if the stream is running or already has {{FUNCTION_PREFIX}}_TELEMETRY_MAX_CHANNELS controllers.
+ */
+bool {{FUNCTION_PREFIX}}_TelemetryAddChannel({{TELEMETRY_NAME}} *tm, {{STRUCT_NAME}} *pid);
+
+/**
+ * @brief Selects the sampled fields and the decimation factor.
+ * @param[in] field_mask 位号见 @ref PID_TelemetryField, 0表示全部字段
+ * @param[in] decimation 每N个控制周期采一条记录, 0按1处理
+ * @return false if the stream is running or a record would not fit into one frame.
+ */
+bool {{FUNCTION_PREFIX}}_TelemetryConfigure({{TELEMETRY_NAME}} *tm, uint8_t field_mask, uint16_t decimation);
+
+/**
+ * @brief Sets the trigger used by {{FUNCTION_PREFIX}}_TelemetryArm.
+ * @param[in] channel     触发源控制器下标
+ * @param[in] field       触发源字段(不要求在 field_mask 中)
+ * @param[in] pre_trigger 触发前保留的记录数, 不超过缓冲记录数-1
+ * @param[in] post_trigger 触发后采集的记录数(含触发记录, >=1)
+ * @return false if the stream is running or the channel does not exist.
+ */
+bool {{FUNCTION_PREFIX}}_TelemetrySetTrigger({{TELEMETRY_NAME}} *tm, uint8_t channel, PID_TelemetryField field,
+                                             PID_TelemetryEdge edge, {{DATA_TYPE}} level,
+                                             uint16_t pre_trigger, uint16_t post_trigger);
+
+/**
+ * @brief Starts continuous streaming.
+ */
+bool {{FUNCTION_PREFIX}}_TelemetryStart({{TELEMETRY_NAME}} *tm);
+
+/**
+ * @brief Arms a single-shot trigger capture; the stream stops by itself once the capture has been sent.
+ */
+bool {{FUNCTION_PREFIX}}_TelemetryArm({{TELEMETRY_NAME}} *tm);
+
+/**
+ * @brief Stops sampling; records still in the ring are discarded on the next Start/Arm.
+ */
+void {{FUNCTION_PREFIX}}_TelemetryStop({{TELEMETRY_NAME}} *tm);
+
+/**
+ * @brief Samples all channels; call once per control period after their {{FUNCTION_PREFIX}}_Compute.
+ * @note 只做计数、比较和最多 通道数×7 次拷贝, 不调用其他函数。
+ */
+void {{FUNCTION_PREFIX}}_TelemetrySample({{TELEMETRY_NAME}} *tm);
+
+/**
+ * @brief Returns the state, see @ref PID_TelemetryState.
+ */
+PID_TelemetryState {{FUNCTION_PREFIX}}_TelemetryGetState(const {{TELEMETRY_NAME}} *tm);
+
+/**
+ * @brief Packs the next batch and removes it from the ring.
+ * @details 帧头(小端): 字节0 id, 1 flags, 2 控制器数, 3 field_mask(均为uint8);
+ *          4 首条记录的控制周期计数(uint32), 8 decimation(uint16), 10 自上一帧以来丢弃的记录数(uint16, 饱和);
+ *          其后为若干条记录, 每条依次为各控制器选中字段的float32。
+ *          帧内相邻记录的控制周期计数恰好相差 decimation。
+ * @param[out] buffer  至少 max_len 字节
+ * @return 写入的字节数, 0表示没有可发送的记录
+ */
+uint16_t {{FUNCTION_PREFIX}}_TelemetryPack({{TELEMETRY_NAME}} *tm, uint8_t *buffer, uint16_t max_len);
+
+#if {{FUNCTION_PREFIX}}_TELEMETRY_USE_YJ_PROTOCOL
+/**
+ * @brief Sends everything currently in the ring, one batch per frame.
+ * @note 在主循环中调用, 不要在控制中断里发送。发送失败的批次留在缓冲中, 下次重发。
+ * @return number of frames sent, negative on send failure.
+ */
+int32_t {{FUNCTION_PREFIX}}_TelemetrySend({{TELEMETRY_NAME}} *tm, yj_protocol_handler_t *handler, uint8_t dest_addr);
+#endif
+
+#endif /* __PID_TELEMETRY_H_TEMPLATE__ */
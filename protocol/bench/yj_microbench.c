@@ -0,0 +1,437 @@
+/**
+ * @file yj_microbench.c
+ * @brief 协议核心基础函数微基准
+ *
+ * 测量以下函数的每次调用周期数和每字节周期数, 结果以JSON输出, 便于在提交之间对比:
+ *   - 校验计算: yj_calc_crc16 / yj_calc_original_checksums
+ *     (收发路径内部的calculate_crc16_internal/calculate_original_checksums_internal为static,
+ *      这两个公开函数直接调用它们, 测量的就是同一实现)
+ *   - yj_protocol_process_byte: 按接收状态分别测量(每次调用前把状态机置于该状态),
+ *     以及连续喂入完整帧时的每字节开销
+ *   - yj_protocol_send_frame(字节发送函数为空操作)
+ *   - yj_pack_* / yj_unpack_* / varint辅助函数
+ *
+ * 可重复性: 绑定到指定CPU, 每项先预热, 自动选择迭代次数使单轮耗时不低于--min-time-ms,
+ * 再重复--repeats轮取中位数(同时给出最小值)。
+ * x86上用rdtsc计数(TSC周期, 与标称频率成正比); 其他平台只有纳秒数, cycles字段为0。
+ * 状态测量中包含重置状态的少量赋值开销, 单独以process_byte/state_reset_overhead给出。
+ *
+ * 手动编译(在仓库根目录):
+ *   cc -O2 -Iprotocol protocol/bench/yj_microbench.c protocol/yj_protocol.c -o yj_microbench
+ *
+ * 用法:
+ *   yj_microbench [--cpu N] [--repeats N] [--min-time-ms N] [--filter 子串]
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // 用于sched_setaffinity
+#endif
+
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "yj_protocol.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+    #define YJ_BENCH_HAVE_TSC 1
+static inline uint64_t read_cycles(void) {
+    return __rdtsc();
+}
+#else
+static inline uint64_t read_cycles(void) {
+    return 0;
+}
+#endif
+
+#define DEFAULT_REPEATS      11
+#define DEFAULT_MIN_TIME_MS  20
+#define MAX_REPEATS          101
+
+/* 防止编译器删除被测调用 */
+static volatile uint32_t g_sink;
+
+typedef void (*bench_fn_t)(void* ctx, uint32_t iterations);
+
+typedef struct {
+    uint32_t repeats;
+    uint32_t min_time_ms;
+    const char* filter;
+    int first_result;
+} bench_config_t;
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief 运行一项基准并输出一条JSON结果
+ * @param bytes_per_op 每次操作处理的字节数, 0表示不计算每字节开销
+ */
+static void run_bench(bench_config_t* cfg, const char* name, bench_fn_t fn, void* ctx, uint32_t bytes_per_op) {
+    double cycles[MAX_REPEATS];
+    double nanos[MAX_REPEATS];
+
+    if (cfg->filter && !strstr(name, cfg->filter)) return;
+
+    // 预热并确定迭代次数
+    uint32_t iterations = 64;
+    for (;;) {
+        uint64_t t0 = monotonic_ns();
+        fn(ctx, iterations);
+        uint64_t elapsed = monotonic_ns() - t0;
+        if (elapsed >= (uint64_t)cfg->min_time_ms * 1000000ull || iterations >= (1u << 30)) break;
+        iterations *= 2;
+    }
+
+    for (uint32_t r = 0; r < cfg->repeats; ++r) {
+        uint64_t t0 = monotonic_ns();
+        uint64_t c0 = read_cycles();
+        fn(ctx, iterations);
+        uint64_t c1 = read_cycles();
+        uint64_t t1 = monotonic_ns();
+        cycles[r] = (double)(c1 - c0) / iterations;
+        nanos[r] = (double)(t1 - t0) / iterations;
+    }
+    qsort(cycles, cfg->repeats, sizeof(double), compare_double);
+    qsort(nanos, cfg->repeats, sizeof(double), compare_double);
+    double median_cycles = cycles[cfg->repeats / 2];
+    double median_ns = nanos[cfg->repeats / 2];
+
+    printf("%s    {\"name\": \"%s\", \"bytes_per_op\": %u, \"iterations\": %u, "
+           "\"cycles_per_op\": %.2f, \"cycles_per_op_min\": %.2f, \"cycles_per_byte\": %.3f, "
+           "\"ns_per_op\": %.3f, \"ns_per_op_min\": %.3f}",
+           cfg->first_result ? "" : ",\n", name, bytes_per_op, iterations,
+           median_cycles, cycles[0], bytes_per_op ? median_cycles / bytes_per_op : 0.0,
+           median_ns, nanos[0]);
+    cfg->first_result = 0;
+    fflush(stdout);
+}
+
+/* ---- 校验计算 ---- */
+
+typedef struct {
+    uint8_t data[YJ_MAX_FRAME_SIZE];
+    uint16_t len;
+} buffer_ctx_t;
+
+static void bench_crc16(void* ctx, uint32_t iterations) {
+    buffer_ctx_t* b = (buffer_ctx_t*)ctx;
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < iterations; ++i) {
+        acc += yj_calc_crc16(b->data, b->len);
+    }
+    g_sink = acc;
+}
+
+static void bench_original_checksums(void* ctx, uint32_t iterations) {
+    buffer_ctx_t* b = (buffer_ctx_t*)ctx;
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < iterations; ++i) {
+        uint8_t sc, ac;
+        yj_calc_original_checksums(b->data, b->len, &sc, &ac);
+        acc += sc + ac;
+    }
+    g_sink = acc;
+}
+
+/* ---- process_byte ---- */
+
+static uint32_t g_frames_received = 0;
+
+static void on_frame(yj_frame_t* frame) {
+    (void)frame;
+    g_frames_received++;
+}
+
+static int32_t discard_byte(uint8_t byte) {
+    (void)byte;
+    return 0;
+}
+
+typedef struct {
+    yj_protocol_handler_t handler;
+    yj_rx_state_t state;
+    uint8_t byte;
+} state_ctx_t;
+
+/* 内部辅助函数: 把状态机置于指定状态, 并补齐该状态需要的字段 */
+static inline void preset_state(yj_protocol_handler_t* h, yj_rx_state_t state) {
+    h->rx_state = state;
+    if (state == YJ_RX_STATE_WAIT_LEN_HIGH) {
+        h->current_rx_frame.data_len = 16; // 长度高字节为0时进入WAIT_DATA
+    } else if (state == YJ_RX_STATE_WAIT_DATA) {
+        h->current_rx_frame.data_len = YJ_MAX_DATA_PAYLOAD_SIZE;
+        h->rx_data_bytes_received = 0;
+    }
+}
+
+static void bench_process_state(void* ctx, uint32_t iterations) {
+    state_ctx_t* s = (state_ctx_t*)ctx;
+    for (uint32_t i = 0; i < iterations; ++i) {
+        preset_state(&s->handler, s->state);
+        yj_protocol_process_byte(&s->handler, s->byte);
+    }
+    g_sink = s->handler.rx_state;
+}
+
+static void bench_state_reset_overhead(void* ctx, uint32_t iterations) {
+    state_ctx_t* s = (state_ctx_t*)ctx;
+    for (uint32_t i = 0; i < iterations; ++i) {
+        preset_state(&s->handler, s->state);
+        __asm__ __volatile__("" ::: "memory"); // 阻止循环被合并
+    }
+    g_sink = s->handler.rx_state;
+}
+
+typedef struct {
+    yj_protocol_handler_t handler;
+    buffer_ctx_t frame;
+} stream_ctx_t;
+
+static void bench_process_frame_stream(void* ctx, uint32_t iterations) {
+    stream_ctx_t* s = (stream_ctx_t*)ctx;
+    for (uint32_t i = 0; i < iterations; ++i) {
+        for (uint16_t j = 0; j < s->frame.len; ++j) {
+            yj_protocol_process_byte(&s->handler, s->frame.data[j]);
+        }
+    }
+    g_sink = g_frames_received;
+}
+
+/* ---- send_frame ---- */
+
+static uint8_t  g_capture_buf[YJ_MAX_FRAME_SIZE];
+static uint16_t g_capture_len = 0;
+
+static int32_t capture_byte(uint8_t byte) {
+    if (g_capture_len < sizeof(g_capture_buf)) g_capture_buf[g_capture_len++] = byte;
+    return 0;
+}
+
+typedef struct {
+    yj_protocol_handler_t handler;
+    uint8_t payload[YJ_MAX_DATA_PAYLOAD_SIZE];
+    uint16_t len;
+} send_ctx_t;
+
+static void bench_send_frame(void* ctx, uint32_t iterations) {
+    send_ctx_t* s = (send_ctx_t*)ctx;
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < iterations; ++i) {
+        acc += (uint32_t)yj_protocol_send_frame(&s->handler, YJ_DEFAULT_HOST_ADDRESS, 0x31, s->payload, s->len);
+    }
+    g_sink = acc;
+}
+
+/* ---- 打包/解包 ---- */
+
+static uint8_t g_pack_buf[64];
+
+static void bench_pack_u16(void* ctx, uint32_t iterations) {
+    (void)ctx;
+    for (uint32_t i = 0; i < iterations; ++i) yj_pack_u16_le(&g_pack_buf[i & 31], (uint16_t)i);
+    g_sink = g_pack_buf[0];
+}
+
+static void bench_unpack_u16(void* ctx, uint32_t iterations) {
+    (void)ctx;
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < iterations; ++i) acc += yj_unpack_u16_le(&g_pack_buf[i & 31]);
+    g_sink = acc;
+}
+
+static void bench_pack_i16(void* ctx, uint32_t iterations) {
+    (void)ctx;
+    for (uint32_t i = 0; i < iterations; ++i) yj_pack_i16_le(&g_pack_buf[i & 31], (int16_t)i);
+    g_sink = g_pack_buf[0];
+}
+
+static void bench_pack_u32(void* ctx, uint32_t iterations) {
+    (void)ctx;
+    for (uint32_t i = 0; i < iterations; ++i) yj_pack_u32_le(&g_pack_buf[i & 31], i * 2654435761u);
+    g_sink = g_pack_buf[0];
+}
+
+static void bench_unpack_u32(void* ctx, uint32_t iterations) {
+    (void)ctx;
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < iterations; ++i) acc += yj_unpack_u32_le(&g_pack_buf[i & 31]);
+    g_sink = acc;
+}
+
+static void bench_pack_i32(void* ctx, uint32_t iterations) {
+    (void)ctx;
+    for (uint32_t i = 0; i < iterations; ++i) yj_pack_i32_le(&g_pack_buf[i & 31], -(int32_t)i);
+    g_sink = g_pack_buf[0];
+}
+
+static void bench_pack_float(void* ctx, uint32_t iterations) {
+    (void)ctx;
+    for (uint32_t i = 0; i < iterations; ++i) yj_pack_float_le(&g_pack_buf[i & 31], (float)i * 0.5f);
+    g_sink = g_pack_buf[0];
+}
+
+static void bench_unpack_float(void* ctx, uint32_t iterations) {
+    (void)ctx;
+    float acc = 0.0f;
+    for (uint32_t i = 0; i < iterations; ++i) acc += yj_unpack_float_le(&g_pack_buf[i & 31]);
+    g_sink = (uint32_t)acc;
+}
+
+static void bench_pack_varint_u32(void* ctx, uint32_t iterations) {
+    (void)ctx;
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < iterations; ++i) acc += yj_pack_varint_u32(&g_pack_buf[i & 31], i * 2654435761u);
+    g_sink = acc;
+}
+
+static void bench_unpack_varint_u32(void* ctx, uint32_t iterations) {
+    (void)ctx;
+    uint32_t acc = 0;
+    uint32_t value;
+    yj_pack_varint_u32(g_pack_buf, 0x12345678u);
+    for (uint32_t i = 0; i < iterations; ++i) {
+        acc += yj_unpack_varint_u32(g_pack_buf, YJ_VARINT32_MAX_BYTES, &value) + value;
+    }
+    g_sink = acc;
+}
+
+static void pin_to_cpu(int cpu) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+        fprintf(stderr, "警告: 无法绑定到CPU %d\n", cpu);
+    }
+#else
+    (void)cpu;
+#endif
+}
+
+int main(int argc, char** argv) {
+    static const uint16_t checksum_lengths[] = {8, 64, YJ_MAX_FRAME_SIZE - YJ_FRAME_CHECKSUM_FIELD_SIZE};
+    static const uint16_t frame_payloads[] = {0, 16, 64, YJ_MAX_DATA_PAYLOAD_SIZE};
+    static const char* state_names[] = {
+        "wait_head", "wait_saddr", "wait_daddr", "wait_func_id", "wait_len_low",
+        "wait_len_high", "wait_data", "wait_checksum_byte1", "wait_checksum_byte2"
+    };
+    bench_config_t cfg = {DEFAULT_REPEATS, DEFAULT_MIN_TIME_MS, NULL, 1};
+    int cpu = 0;
+    char name[96];
+
+    for (int i = 1; i < argc; ++i) {
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (strcmp(argv[i], "--cpu") == 0 && value) {
+            cpu = atoi(value);
+        } else if (strcmp(argv[i], "--repeats") == 0 && value) {
+            cfg.repeats = (uint32_t)strtoul(value, NULL, 10);
+        } else if (strcmp(argv[i], "--min-time-ms") == 0 && value) {
+            cfg.min_time_ms = (uint32_t)strtoul(value, NULL, 10);
+        } else if (strcmp(argv[i], "--filter") == 0 && value) {
+            cfg.filter = value;
+        } else {
+            fprintf(stderr, "用法: %s [--cpu N] [--repeats N] [--min-time-ms N] [--filter 子串]\n", argv[0]);
+            return 2;
+        }
+        ++i;
+    }
+    if (cfg.repeats == 0 || cfg.repeats > MAX_REPEATS) cfg.repeats = DEFAULT_REPEATS;
+    pin_to_cpu(cpu);
+
+    printf("{\n  \"benchmark\": \"yj_microbench\",\n  \"cpu\": %d,\n  \"repeats\": %u,\n"
+           "  \"cycle_counter\": \"%s\",\n  \"max_payload\": %u,\n  \"results\": [\n",
+           cpu, cfg.repeats,
+#ifdef YJ_BENCH_HAVE_TSC
+           "rdtsc",
+#else
+           "none",
+#endif
+           YJ_MAX_DATA_PAYLOAD_SIZE);
+
+    // 校验计算
+    static buffer_ctx_t buf;
+    for (uint16_t i = 0; i < sizeof(buf.data); ++i) buf.data[i] = (uint8_t)(i * 31u + 7u);
+    for (size_t i = 0; i < sizeof(checksum_lengths) / sizeof(checksum_lengths[0]); ++i) {
+        buf.len = checksum_lengths[i];
+        snprintf(name, sizeof(name), "crc16/%u", buf.len);
+        run_bench(&cfg, name, bench_crc16, &buf, buf.len);
+        snprintf(name, sizeof(name), "original_checksums/%u", buf.len);
+        run_bench(&cfg, name, bench_original_checksums, &buf, buf.len);
+    }
+
+    // 逐状态process_byte
+    const yj_checksum_mode_t modes[] = {YJ_CHECKSUM_MODE_ORIGINAL, YJ_CHECKSUM_MODE_CRC16};
+    const char* mode_names[] = {"original", "crc16"};
+    static state_ctx_t state_ctx;
+    for (size_t m = 0; m < 2; ++m) {
+        yj_protocol_init(&state_ctx.handler, discard_byte, on_frame, modes[m]);
+        for (int s = YJ_RX_STATE_WAIT_HEAD; s <= YJ_RX_STATE_WAIT_CHECKSUM_BYTE2; ++s) {
+            state_ctx.state = (yj_rx_state_t)s;
+            state_ctx.byte = 0x00; // WAIT_HEAD下为噪声字节; WAIT_CHECKSUM_BYTE2下校验失败, 不触发回调
+            snprintf(name, sizeof(name), "process_byte/%s/%s", mode_names[m], state_names[s]);
+            run_bench(&cfg, name, bench_process_state, &state_ctx, 1);
+        }
+        state_ctx.state = YJ_RX_STATE_WAIT_HEAD;
+        state_ctx.byte = YJ_FRAME_HEAD_BYTE;
+        snprintf(name, sizeof(name), "process_byte/%s/wait_head_sync", mode_names[m]);
+        run_bench(&cfg, name, bench_process_state, &state_ctx, 1);
+    }
+    state_ctx.state = YJ_RX_STATE_WAIT_DATA;
+    run_bench(&cfg, "process_byte/state_reset_overhead", bench_state_reset_overhead, &state_ctx, 0);
+
+    // 连续喂入完整帧
+    static stream_ctx_t stream_ctx;
+    static send_ctx_t send_ctx;
+    for (uint16_t i = 0; i < YJ_MAX_DATA_PAYLOAD_SIZE; ++i) send_ctx.payload[i] = (uint8_t)(i * 13u + 5u);
+    for (size_t m = 0; m < 2; ++m) {
+        for (size_t p = 0; p < sizeof(frame_payloads) / sizeof(frame_payloads[0]); ++p) {
+            yj_protocol_init(&send_ctx.handler, capture_byte, on_frame, modes[m]);
+            g_capture_len = 0;
+            yj_protocol_send_frame(&send_ctx.handler, YJ_DEFAULT_HOST_ADDRESS, 0x31, send_ctx.payload,
+                                   frame_payloads[p]);
+            memcpy(stream_ctx.frame.data, g_capture_buf, g_capture_len);
+            stream_ctx.frame.len = g_capture_len;
+            yj_protocol_init(&stream_ctx.handler, discard_byte, on_frame, modes[m]);
+            snprintf(name, sizeof(name), "process_frame/%s/%u", mode_names[m], frame_payloads[p]);
+            run_bench(&cfg, name, bench_process_frame_stream, &stream_ctx, stream_ctx.frame.len);
+        }
+    }
+
+    // send_frame
+    for (size_t m = 0; m < 2; ++m) {
+        yj_protocol_init(&send_ctx.handler, discard_byte, on_frame, modes[m]);
+        for (size_t p = 0; p < sizeof(frame_payloads) / sizeof(frame_payloads[0]); ++p) {
+            send_ctx.len = frame_payloads[p];
+            snprintf(name, sizeof(name), "send_frame/%s/%u", mode_names[m], send_ctx.len);
+            run_bench(&cfg, name, bench_send_frame, &send_ctx, (uint32_t)(send_ctx.len + YJ_FRAME_MIN_OVERHEAD));
+        }
+    }
+
+    // 打包/解包
+    run_bench(&cfg, "pack/u16_le", bench_pack_u16, NULL, 2);
+    run_bench(&cfg, "unpack/u16_le", bench_unpack_u16, NULL, 2);
+    run_bench(&cfg, "pack/i16_le", bench_pack_i16, NULL, 2);
+    run_bench(&cfg, "pack/u32_le", bench_pack_u32, NULL, 4);
+    run_bench(&cfg, "unpack/u32_le", bench_unpack_u32, NULL, 4);
+    run_bench(&cfg, "pack/i32_le", bench_pack_i32, NULL, 4);
+    run_bench(&cfg, "pack/float_le", bench_pack_float, NULL, 4);
+    run_bench(&cfg, "unpack/float_le", bench_unpack_float, NULL, 4);
+    run_bench(&cfg, "pack/varint_u32", bench_pack_varint_u32, NULL, 0);
+    run_bench(&cfg, "unpack/varint_u32", bench_unpack_varint_u32, NULL, YJ_VARINT32_MAX_BYTES);
+
+    printf("\n  ]\n}\n");
+    return 0;
+}
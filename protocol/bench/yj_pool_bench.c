@@ -0,0 +1,320 @@
+/**
+ * @file yj_pool_bench.c
+ * @brief 多串口分片解析线程池(yj_worker_pool)吞吐基准与自检
+ *
+ * 一个IO线程模拟N路串口, 轮流向各端口输入环写入预先组好的帧流(每帧负载带端口号和序号),
+ * 一个消费者线程取帧并校验: 端口号与负载一致、同一端口的序号逐一递增(线程池有背压, 不应丢帧)。
+ * 对不同工作线程数各跑一遍, 输出帧/秒、各线程解析字节数、窃取次数和输出帧环满的暂停次数。
+ *
+ * --burst 时端口0的写入量是其他端口的8倍, 用于观察工作窃取把同一线程上的其他端口接走。
+ *
+ * 手动编译(在仓库根目录):
+ *   cc -O2 -pthread -Iprotocol -Iprotocol/host protocol/bench/yj_pool_bench.c \
+ *      protocol/host/yj_worker_pool.c protocol/yj_protocol.c -o yj_pool_bench
+ *
+ * 用法:
+ *   yj_pool_bench [--ports N] [--workers 1,2,4] [--frames N] [--payload N] [--frame-ring N]
+ *                 [--burst] [--pin]
+ *
+ * --frame-ring 调小每端口输出帧环(2的幂), 用于验证消费者跟不上时的背压路径。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include "yj_protocol.h"
+#include "yj_worker_pool.h"
+
+#define CHUNK_FRAMES   1024   // 每端口预生成的帧数, 序号按此取模循环
+#define WRITE_SLICE    4096   // IO线程每次向一个端口写入的最大字节数
+#define BURST_FACTOR   8
+#define MAX_PORTS      256
+
+typedef struct {
+    uint8_t* stream;          // 预生成的帧流
+    uint32_t stream_len;
+    uint32_t pos;             // 当前在stream中的位置
+    uint64_t bytes_left;      // 还需写入的字节数
+    uint64_t target_frames;
+} port_feed_t;
+
+typedef struct {
+    uint32_t expected_seq[MAX_PORTS];
+    uint64_t received[MAX_PORTS];
+    uint64_t total;
+    uint64_t errors;
+} check_state_t;
+
+static uint32_t g_port_count = 32;
+static uint32_t g_frames_per_port = 100000;
+static uint16_t g_payload = 32;
+static int g_burst = 0;
+static int g_pin = 0;
+static uint32_t g_frame_ring = YJ_POOL_DEFAULT_FRAME_RING;
+static volatile int g_io_abort = 0; // 消费者超时后让IO线程退出
+
+/* 组帧时的暂存区(仅主线程在生成帧流时使用) */
+static uint8_t* g_build_buf;
+static uint32_t g_build_len;
+
+static int32_t build_byte(uint8_t byte) {
+    g_build_buf[g_build_len++] = byte;
+    return 0;
+}
+
+static void build_frame_cb(yj_frame_t* frame) {
+    (void)frame;
+}
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* 内部辅助函数: 为端口生成CHUNK_FRAMES帧的循环帧流 */
+static int build_stream(port_feed_t* feed, uint32_t port) {
+    yj_protocol_handler_t builder;
+    uint8_t payload[YJ_MAX_DATA_PAYLOAD_SIZE];
+    uint32_t frame_size = g_payload + 8u;
+
+    feed->stream_len = frame_size * CHUNK_FRAMES;
+    feed->stream = (uint8_t*)malloc(feed->stream_len);
+    if (!feed->stream) return -1;
+    g_build_buf = feed->stream;
+    g_build_len = 0;
+    yj_protocol_init(&builder, build_byte, build_frame_cb, YJ_CHECKSUM_MODE_ORIGINAL);
+    for (uint32_t seq = 0; seq < CHUNK_FRAMES; ++seq) {
+        payload[0] = (uint8_t)port;
+        payload[1] = (uint8_t)seq;
+        payload[2] = (uint8_t)(seq >> 8);
+        payload[3] = (uint8_t)(seq >> 16);
+        for (uint16_t i = 4; i < g_payload; ++i) payload[i] = (uint8_t)(i ^ seq);
+        yj_protocol_send_frame(&builder, 0x02, (uint8_t)(0x10 + (port & 0x3F)), payload, g_payload);
+    }
+    return g_build_len == feed->stream_len ? 0 : -1;
+}
+
+static void on_pool_frame(void* user, const yj_pool_frame_t* frame) {
+    check_state_t* st = (check_state_t*)user;
+    uint32_t port = frame->port;
+    st->total++;
+    if (frame->data_len != g_payload || frame->data[0] != (uint8_t)port) {
+        st->errors++;
+        return;
+    }
+    uint32_t seq = frame->data[1] | ((uint32_t)frame->data[2] << 8) | ((uint32_t)frame->data[3] << 16);
+    if (seq != st->expected_seq[port]) st->errors++;
+    st->expected_seq[port] = (seq + 1) % CHUNK_FRAMES;
+    st->received[port]++;
+}
+
+typedef struct {
+    yj_pool_t* pool;
+    port_feed_t* feeds;
+} io_args_t;
+
+/* IO线程: 模拟所有端口的读线程, 每个端口只有这一个生产者 */
+static void* io_main(void* arg) {
+    io_args_t* io = (io_args_t*)arg;
+    uint64_t remaining = 0;
+    for (uint32_t p = 0; p < g_port_count; ++p) remaining += io->feeds[p].bytes_left;
+
+    while (remaining > 0 && !g_io_abort) {
+        uint64_t wrote_round = 0;
+        for (uint32_t p = 0; p < g_port_count; ++p) {
+            port_feed_t* feed = &io->feeds[p];
+            uint32_t slices = (g_burst && p == 0) ? BURST_FACTOR : 1;
+            for (uint32_t s = 0; s < slices && feed->bytes_left > 0; ++s) {
+                uint8_t* dst;
+                uint32_t n = yj_pool_port_write_span(io->pool, p, &dst);
+                uint32_t src_left = feed->stream_len - feed->pos;
+                if (n > WRITE_SLICE) n = WRITE_SLICE;
+                if (n > src_left) n = src_left;
+                if (n > feed->bytes_left) n = (uint32_t)feed->bytes_left;
+                if (n == 0) break;
+                memcpy(dst, feed->stream + feed->pos, n);
+                yj_pool_port_commit(io->pool, p, n);
+                feed->pos = (feed->pos + n) % feed->stream_len;
+                feed->bytes_left -= n;
+                remaining -= n;
+                wrote_round += n;
+            }
+        }
+        if (wrote_round == 0) sched_yield(); // 所有输入环都满了
+    }
+    return NULL;
+}
+
+/* 内部辅助函数: 用给定工作线程数跑一轮, 返回0表示校验通过 */
+static int run_once(uint32_t workers) {
+    yj_pool_config_t cfg;
+    yj_pool_t* pool = NULL;
+    port_feed_t feeds[MAX_PORTS];
+    check_state_t* st = (check_state_t*)calloc(1, sizeof(check_state_t));
+    uint64_t target_total = 0;
+    int rc = 0;
+
+    if (!st) return -1;
+    yj_pool_default_config(&cfg);
+    cfg.worker_count = workers;
+    cfg.port_count = g_port_count;
+    cfg.pin_workers = (uint8_t)g_pin;
+    cfg.frame_ring_size = g_frame_ring;
+    if (yj_pool_create(&pool, &cfg) != 0) {
+        fprintf(stderr, "yj_pool_create失败\n");
+        free(st);
+        return -1;
+    }
+
+    memset(feeds, 0, sizeof(feeds));
+    for (uint32_t p = 0; p < g_port_count; ++p) {
+        if (build_stream(&feeds[p], p) != 0) {
+            fprintf(stderr, "生成帧流失败\n");
+            rc = -1;
+            goto out;
+        }
+        feeds[p].target_frames = (uint64_t)g_frames_per_port * ((g_burst && p == 0) ? BURST_FACTOR : 1);
+        feeds[p].bytes_left = feeds[p].target_frames * (g_payload + 8u);
+        target_total += feeds[p].target_frames;
+    }
+
+    if (yj_pool_start(pool) != 0) {
+        fprintf(stderr, "yj_pool_start失败\n");
+        rc = -1;
+        goto out;
+    }
+
+    io_args_t io = {pool, feeds};
+    pthread_t io_thread;
+    double t0 = now_sec();
+    pthread_create(&io_thread, NULL, io_main, &io);
+
+    // 消费者: 取到全部帧即结束
+    double last_progress = now_sec();
+    uint64_t last_total = 0;
+    while (st->total < target_total) {
+        if (yj_pool_consumer_poll(pool, 0, on_pool_frame, st, 0) == 0) {
+            yj_pool_consumer_wait(pool, 0, 50);
+        }
+        if (st->total != last_total) {
+            last_total = st->total;
+            last_progress = now_sec();
+        } else if (now_sec() - last_progress > 5.0) {
+            fprintf(stderr, "超时: 已收到%llu/%llu帧\n",
+                    (unsigned long long)st->total, (unsigned long long)target_total);
+            rc = -1;
+            g_io_abort = 1;
+            break;
+        }
+    }
+    double elapsed = now_sec() - t0;
+    pthread_join(io_thread, NULL);
+
+    uint32_t actual_workers = yj_pool_worker_count(pool);
+    uint64_t steals = 0, min_bytes = UINT64_MAX, max_bytes = 0;
+    for (uint32_t w = 0; w < actual_workers; ++w) {
+        yj_pool_worker_stats_t ws;
+        yj_pool_get_worker_stats(pool, w, &ws);
+        steals += ws.steals;
+        if (ws.bytes < min_bytes) min_bytes = ws.bytes;
+        if (ws.bytes > max_bytes) max_bytes = ws.bytes;
+    }
+    uint64_t decoded = 0, dropped = 0, stalls = 0;
+    for (uint32_t p = 0; p < g_port_count; ++p) {
+        yj_pool_port_stats_t ps;
+        yj_pool_get_port_stats(pool, p, &ps);
+        decoded += ps.frames;
+        dropped += ps.frames_dropped;
+        stalls += ps.stalls;
+        if (ps.frames != feeds[p].target_frames || st->received[p] != feeds[p].target_frames) {
+            fprintf(stderr, "端口%u: 解出%llu帧, 收到%llu帧, 期望%llu帧\n", p,
+                    (unsigned long long)ps.frames, (unsigned long long)st->received[p],
+                    (unsigned long long)feeds[p].target_frames);
+            rc = -1;
+        }
+    }
+    if (dropped > 0) {
+        fprintf(stderr, "丢帧: %llu\n", (unsigned long long)dropped);
+        rc = -1;
+    }
+    if (st->errors > 0) {
+        fprintf(stderr, "校验失败: %llu帧端口号/序号不符\n", (unsigned long long)st->errors);
+        rc = -1;
+    }
+
+    printf("workers=%-3u frames=%-9llu stalls=%-6llu %8.2f Mframes/s %8.1f MB/s  steals=%-7llu "
+           "bytes/worker min=%.1fMB max=%.1fMB\n",
+           actual_workers, (unsigned long long)decoded, (unsigned long long)stalls,
+           (double)decoded / elapsed / 1e6,
+           (double)decoded * (g_payload + 8u) / elapsed / 1e6, (unsigned long long)steals,
+           (double)min_bytes / 1e6, (double)max_bytes / 1e6);
+
+out:
+    yj_pool_destroy(pool);
+    for (uint32_t p = 0; p < g_port_count; ++p) free(feeds[p].stream);
+    free(st);
+    return rc;
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr, "用法: %s [--ports N] [--workers 1,2,4] [--frames N] [--payload N] [--frame-ring N]\n"
+            "       [--burst] [--pin]\n",
+            prog);
+}
+
+int main(int argc, char** argv) {
+    uint32_t worker_list[16];
+    uint32_t worker_list_len = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--ports") == 0 && i + 1 < argc) {
+            g_port_count = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            char* p = argv[++i];
+            while (*p && worker_list_len < 16) {
+                worker_list[worker_list_len++] = (uint32_t)strtoul(p, &p, 10);
+                if (*p == ',') ++p;
+            }
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            g_frames_per_port = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--payload") == 0 && i + 1 < argc) {
+            g_payload = (uint16_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--frame-ring") == 0 && i + 1 < argc) {
+            g_frame_ring = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--burst") == 0) {
+            g_burst = 1;
+        } else if (strcmp(argv[i], "--pin") == 0) {
+            g_pin = 1;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (g_port_count == 0 || g_port_count > MAX_PORTS || g_payload < 4 ||
+        g_payload > YJ_MAX_DATA_PAYLOAD_SIZE) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (worker_list_len == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        uint32_t max_workers = cpus > 0 ? (uint32_t)cpus : 1;
+        for (uint32_t w = 1; w < max_workers && worker_list_len < 15; w *= 2) {
+            worker_list[worker_list_len++] = w;
+        }
+        worker_list[worker_list_len++] = max_workers;
+    }
+
+    printf("ports=%u frames/port=%u payload=%u%s\n", g_port_count, g_frames_per_port, g_payload,
+           g_burst ? " burst(port0 x8)" : "");
+    int failed = 0;
+    for (uint32_t i = 0; i < worker_list_len; ++i) {
+        if (run_once(worker_list[i]) != 0) failed = 1;
+    }
+    return failed ? 1 : 0;
+}
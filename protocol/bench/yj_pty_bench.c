@@ -0,0 +1,320 @@
+/**
+ * @file yj_pty_bench.c
+ * @brief 伪终端回环吞吐/延迟基准
+ *
+ * 在一对伪终端上跑完整的收发链路:
+ *   yj_protocol_send_frame -> 主端write -> tty -> 从端read -> yj_protocol_rx_buffer_add_byte
+ *   -> yj_protocol_tick -> 帧接收回调(收发状态经yj_protocol_init_ex的user参数传递, 不使用全局变量)
+ * 每次只发一帧并等待回调(乒乓方式), 测量往返延迟; 对负载长度、校验模式、波特率做全组合扫描,
+ * 输出吞吐和p50/p99/p99.9往返延迟。
+ *
+ * 伪终端不受波特率限制(设置只保存在termios中), 加--line-rate时按所设波特率(10位/字节)
+ * 对发送节流, 模拟真实串口的线路时间。
+ *
+ * 手动编译(在仓库根目录):
+ *   cc -O2 -Iprotocol protocol/bench/yj_pty_bench.c protocol/yj_protocol.c -o yj_pty_bench
+ *
+ * 用法:
+ *   yj_pty_bench [--iterations N] [--line-rate] [--json]
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // 用于posix_openpt/ptsname/cfmakeraw
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "yj_protocol.h"
+
+#define DEFAULT_ITERATIONS 2000
+#define RX_TIMEOUT_MS      1000
+
+static const uint16_t k_payload_sizes[] = {0, 1, 8, 16, 32, 64, 128, 256};
+
+typedef struct {
+    speed_t  speed;
+    uint32_t baud;
+} baud_setting_t;
+
+static const baud_setting_t k_bauds[] = {
+    {B115200, 115200},
+    {B921600, 921600},
+#ifdef B3000000
+    {B3000000, 3000000},
+#endif
+};
+
+/* 单个测试用例的收发状态, 经yj_protocol_init_ex的user参数传给两个回调 */
+typedef struct {
+    uint8_t  tx_buf[YJ_MAX_FRAME_SIZE]; // 发送暂存区: send_byte只放入暂存区, 一帧组装完后一次write到主端
+    uint16_t tx_len;
+    int      frame_received;            // 接收回调置1, 每次发送前清零
+    uint16_t expected_len;
+    int      payload_mismatch;
+} bench_case_t;
+
+static int32_t stage_byte(void* user, uint8_t byte) {
+    bench_case_t* ctx = (bench_case_t*)user;
+    if (ctx->tx_len >= sizeof(ctx->tx_buf)) return -1;
+    ctx->tx_buf[ctx->tx_len++] = byte;
+    return 0;
+}
+
+static void on_frame(void* user, yj_frame_t* frame) {
+    bench_case_t* ctx = (bench_case_t*)user;
+    if (frame->data_len != ctx->expected_len) {
+        ctx->payload_mismatch = 1;
+    }
+    for (uint16_t i = 0; i < frame->data_len; ++i) {
+        if (frame->data[i] != (uint8_t)(i * 7u + 1u)) {
+            ctx->payload_mismatch = 1;
+            break;
+        }
+    }
+    ctx->frame_received = 1;
+}
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static uint64_t percentile(const uint64_t* sorted, uint32_t count, double p) {
+    if (count == 0) return 0;
+    return sorted[(uint32_t)(p * (double)(count - 1) + 0.5)];
+}
+
+/* 内部辅助函数: 创建原始模式伪终端对, 设置波特率 */
+static int open_pty_pair(int* master_fd, int* slave_fd, speed_t speed) {
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0) return -1;
+    if (grantpt(master) < 0 || unlockpt(master) < 0) {
+        close(master);
+        return -1;
+    }
+    const char* name = ptsname(master);
+    int slave = name ? open(name, O_RDWR | O_NOCTTY) : -1;
+    if (slave < 0) {
+        close(master);
+        return -1;
+    }
+    struct termios tio;
+    if (tcgetattr(slave, &tio) == 0) {
+        cfmakeraw(&tio);
+        cfsetispeed(&tio, speed);
+        cfsetospeed(&tio, speed);
+        tcsetattr(slave, TCSANOW, &tio);
+    }
+    *master_fd = master;
+    *slave_fd = slave;
+    return 0;
+}
+
+static int write_all(int fd, const uint8_t* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, data, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+/* 内部辅助函数: 从从端读取字节送入协议处理器, 直到收到一帧或超时 */
+static int receive_frame(yj_protocol_handler_t* handler, const bench_case_t* ctx, int slave_fd) {
+    uint8_t buf[512];
+    while (!ctx->frame_received) {
+        struct pollfd pfd = {slave_fd, POLLIN, 0};
+        int ready = poll(&pfd, 1, RX_TIMEOUT_MS);
+        if (ready < 0 && errno == EINTR) continue;
+        if (ready <= 0) return -1;
+        ssize_t n = read(slave_fd, buf, sizeof(buf));
+        if (n < 0) {
+            if (errno == EINTR || errno == EAGAIN) continue;
+            return -1;
+        }
+        for (ssize_t i = 0; i < n; ++i) {
+            // 模拟中断写入环形缓冲区, 缓冲区满时先在"主循环"中处理
+            if (yj_protocol_rx_buffer_add_byte(handler, buf[i]) < 0) {
+                yj_protocol_tick(handler);
+                yj_protocol_rx_buffer_add_byte(handler, buf[i]);
+            }
+        }
+        yj_protocol_tick(handler);
+    }
+    return 0;
+}
+
+typedef struct {
+    yj_checksum_mode_t mode;
+    uint32_t baud;
+    uint16_t payload;
+    uint32_t frames;
+    uint64_t elapsed_ns;
+    uint64_t p50_ns;
+    uint64_t p99_ns;
+    uint64_t p999_ns;
+    uint64_t max_ns;
+} bench_result_t;
+
+static int run_case(yj_checksum_mode_t mode, const baud_setting_t* baud, uint16_t payload,
+                    uint32_t iterations, int line_rate, uint64_t* samples, bench_result_t* result) {
+    yj_protocol_handler_t tx_handler;
+    yj_protocol_handler_t rx_handler;
+    uint8_t data[YJ_MAX_DATA_PAYLOAD_SIZE];
+    bench_case_t ctx;
+    int master_fd, slave_fd;
+
+    if (open_pty_pair(&master_fd, &slave_fd, baud->speed) < 0) {
+        fprintf(stderr, "创建伪终端失败: %s\n", strerror(errno));
+        return -1;
+    }
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.expected_len = payload;
+    yj_protocol_init_ex(&tx_handler, stage_byte, on_frame, &ctx, mode);
+    yj_protocol_init_ex(&rx_handler, stage_byte, on_frame, &ctx, mode);
+    for (uint16_t i = 0; i < payload; ++i) {
+        data[i] = (uint8_t)(i * 7u + 1u);
+    }
+
+    uint64_t wire_ns = line_rate ? (uint64_t)(YJ_FRAME_MIN_OVERHEAD + payload) * 10u * 1000000000ull / baud->baud : 0;
+    uint64_t start_ns = monotonic_ns();
+    uint32_t done = 0;
+    for (; done < iterations; ++done) {
+        ctx.tx_len = 0;
+        ctx.frame_received = 0;
+        uint64_t t0 = monotonic_ns();
+        if (yj_protocol_send_frame(&tx_handler, YJ_DEFAULT_HOST_ADDRESS, 0x31, data, payload) != 0 ||
+            write_all(master_fd, ctx.tx_buf, ctx.tx_len) < 0) {
+            fprintf(stderr, "发送失败\n");
+            break;
+        }
+        if (wire_ns) {
+            while (monotonic_ns() - t0 < wire_ns) {
+                // 忙等模拟线路时间(10位/字节), 精度高于nanosleep
+            }
+        }
+        if (receive_frame(&rx_handler, &ctx, slave_fd) < 0) {
+            fprintf(stderr, "接收超时: payload=%u\n", payload);
+            break;
+        }
+        samples[done] = monotonic_ns() - t0;
+    }
+    uint64_t elapsed = monotonic_ns() - start_ns;
+    close(slave_fd);
+    close(master_fd);
+    if (done < iterations || ctx.payload_mismatch) {
+        if (ctx.payload_mismatch) fprintf(stderr, "收到的数据与发送的不一致: payload=%u\n", payload);
+        return -1;
+    }
+
+    qsort(samples, done, sizeof(uint64_t), compare_u64);
+    result->mode = mode;
+    result->baud = baud->baud;
+    result->payload = payload;
+    result->frames = done;
+    result->elapsed_ns = elapsed;
+    result->p50_ns = percentile(samples, done, 0.50);
+    result->p99_ns = percentile(samples, done, 0.99);
+    result->p999_ns = percentile(samples, done, 0.999);
+    result->max_ns = samples[done - 1];
+    return 0;
+}
+
+static void print_result(const bench_result_t* r, int json, int first) {
+    double seconds = (double)r->elapsed_ns / 1e9;
+    double fps = (double)r->frames / seconds;
+    double payload_mbps = (double)r->frames * r->payload / seconds / 1e6;
+    const char* mode = r->mode == YJ_CHECKSUM_MODE_CRC16 ? "crc16" : "original";
+    if (json) {
+        printf("%s    {\"mode\": \"%s\", \"baud\": %u, \"payload\": %u, \"frames\": %u, "
+               "\"frames_per_sec\": %.1f, \"payload_mb_per_sec\": %.3f, "
+               "\"rtt_p50_ns\": %llu, \"rtt_p99_ns\": %llu, \"rtt_p999_ns\": %llu, \"rtt_max_ns\": %llu}",
+               first ? "" : ",\n", mode, r->baud, r->payload, r->frames, fps, payload_mbps,
+               (unsigned long long)r->p50_ns, (unsigned long long)r->p99_ns,
+               (unsigned long long)r->p999_ns, (unsigned long long)r->max_ns);
+    } else {
+        printf("%-8s %8u %7u %10.0f %9.3f %10.1f %10.1f %10.1f %10.1f\n",
+               mode, r->baud, r->payload, fps, payload_mbps,
+               r->p50_ns / 1e3, r->p99_ns / 1e3, r->p999_ns / 1e3, r->max_ns / 1e3);
+    }
+}
+
+int main(int argc, char** argv) {
+    uint32_t iterations = DEFAULT_ITERATIONS;
+    int line_rate = 0;
+    int json = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--line-rate") == 0) {
+            line_rate = 1;
+        } else if (strcmp(argv[i], "--json") == 0) {
+            json = 1;
+        } else {
+            fprintf(stderr, "用法: %s [--iterations N] [--line-rate] [--json]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (iterations == 0) iterations = DEFAULT_ITERATIONS;
+
+    uint64_t* samples = (uint64_t*)malloc(iterations * sizeof(uint64_t));
+    if (!samples) {
+        fprintf(stderr, "内存不足\n");
+        return 1;
+    }
+
+    if (json) {
+        printf("{\n  \"benchmark\": \"yj_pty_bench\",\n  \"iterations\": %u,\n  \"line_rate\": %s,\n"
+               "  \"results\": [\n", iterations, line_rate ? "true" : "false");
+    } else {
+        printf("%-8s %8s %7s %10s %9s %10s %10s %10s %10s\n",
+               "mode", "baud", "payload", "frames/s", "MB/s", "p50(us)", "p99(us)", "p999(us)", "max(us)");
+    }
+
+    const yj_checksum_mode_t modes[] = {YJ_CHECKSUM_MODE_ORIGINAL, YJ_CHECKSUM_MODE_CRC16};
+    int failed = 0;
+    int first = 1;
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); ++m) {
+        for (size_t b = 0; b < sizeof(k_bauds) / sizeof(k_bauds[0]); ++b) {
+            for (size_t p = 0; p < sizeof(k_payload_sizes) / sizeof(k_payload_sizes[0]); ++p) {
+                bench_result_t result;
+                if (k_payload_sizes[p] > YJ_MAX_DATA_PAYLOAD_SIZE) {
+                    continue; // 超过编译期负载上限的长度无法组帧, run_case的数据缓冲区也按该上限分配
+                }
+                if (run_case(modes[m], &k_bauds[b], k_payload_sizes[p], iterations, line_rate,
+                             samples, &result) < 0) {
+                    failed = 1;
+                    continue;
+                }
+                print_result(&result, json, first);
+                first = 0;
+                fflush(stdout);
+            }
+        }
+    }
+    if (json) {
+        printf("\n  ]\n}\n");
+    }
+    free(samples);
+    return failed ? 1 : 0;
+}
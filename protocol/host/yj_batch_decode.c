@@ -0,0 +1,115 @@
+#include "yj_batch_decode.h"
+#include <string.h> // 用于memcpy
+
+#define YJ_BATCH_SPAN_BLOCK 256 // 每轮扫描的帧数
+
+/**
+ * @brief 获取字段类型的字节数
+ */
+uint8_t yj_field_type_size(yj_field_type_t type) {
+    switch (type) {
+        case YJ_FIELD_U8:
+        case YJ_FIELD_I8:  return 1;
+        case YJ_FIELD_U16:
+        case YJ_FIELD_I16: return 2;
+        case YJ_FIELD_U32:
+        case YJ_FIELD_I32:
+        case YJ_FIELD_F32: return 4;
+        case YJ_FIELD_F64: return 8;
+        default:           return 0;
+    }
+}
+
+/* 内部辅助函数: 读取一个小端字段并转换为double */
+static double read_field(const uint8_t* p, yj_field_type_t type) {
+    switch (type) {
+        case YJ_FIELD_U8:  return (double)p[0];
+        case YJ_FIELD_I8:  return (double)(int8_t)p[0];
+        case YJ_FIELD_U16: return (double)yj_unpack_u16_le(p);
+        case YJ_FIELD_I16: return (double)yj_unpack_i16_le(p);
+        case YJ_FIELD_U32: return (double)yj_unpack_u32_le(p);
+        case YJ_FIELD_I32: return (double)yj_unpack_i32_le(p);
+        case YJ_FIELD_F32: return (double)yj_unpack_float_le(p);
+        case YJ_FIELD_F64: {
+            union {
+                double d;
+                uint64_t u;
+            } converter;
+            converter.u = ((uint64_t)yj_unpack_u32_le(p + 4) << 32) | yj_unpack_u32_le(p);
+            return converter.d;
+        }
+        default:           return 0.0;
+    }
+}
+
+/**
+ * @brief 批量解码为列数组
+ */
+uint32_t yj_batch_decode_columns(const uint8_t* data, uint32_t len,
+                                 yj_checksum_mode_t mode, uint8_t head_byte, uint16_t max_payload,
+                                 const yj_column_layout_t* layout,
+                                 double* const* columns, uint32_t capacity,
+                                 yj_batch_decode_stats_t* stats) {
+    yj_batch_decode_stats_t local_stats;
+    yj_frame_span_t spans[YJ_BATCH_SPAN_BLOCK];
+    uint32_t rows = 0;
+    uint32_t pos = 0;
+    uint32_t min_payload = 0;
+
+    memset(&local_stats, 0, sizeof(local_stats));
+    if (!data || !layout || (layout->field_count > 0 && (!layout->fields || !columns))) {
+        if (stats) *stats = local_stats;
+        return 0;
+    }
+
+    // 布局所需的最小负载长度, 不足的帧整帧跳过; 按32位计算, 偏移接近0xFFFF的字段不会回绕,
+    // 超出16位负载长度的布局不会匹配任何帧
+    for (uint16_t f = 0; f < layout->field_count; ++f) {
+        uint32_t end = (uint32_t)layout->fields[f].offset + yj_field_type_size(layout->fields[f].type);
+        if (end > min_payload) min_payload = end;
+    }
+
+    while (pos < len && rows < capacity) {
+        uint32_t consumed = 0;
+        uint32_t count = yj_protocol_scan_buffer(&data[pos], len - pos, mode, head_byte, max_payload,
+                                                 spans, YJ_BATCH_SPAN_BLOCK, &consumed);
+        uint32_t i;
+        for (i = 0; i < count && rows < capacity; ++i) {
+            const yj_frame_span_t* span = &spans[i];
+            local_stats.frames_seen++;
+            if (!span->checksum_ok) {
+                local_stats.checksum_errors++;
+                continue;
+            }
+            uint32_t payload_len = span->length - YJ_FRAME_MIN_OVERHEAD;
+            if ((layout->func_id >= 0 && span->func_id != (uint8_t)layout->func_id) ||
+                payload_len < min_payload) {
+                local_stats.skipped_frames++;
+                continue;
+            }
+
+            const uint8_t* payload = &data[pos + span->offset + YJ_FRAME_OFFSET_DATA_START];
+            for (uint16_t f = 0; f < layout->field_count; ++f) {
+                columns[f][rows] = read_field(&payload[layout->fields[f].offset], layout->fields[f].type);
+            }
+            rows++;
+        }
+
+        if (i < count) {
+            // 列数组已满: 停在下一帧起点, 剩余帧留给下次调用
+            pos += spans[i].offset;
+            break;
+        }
+        if (consumed == 0) {
+            break; // 只剩不完整的帧
+        }
+        pos += consumed;
+        if (count < YJ_BATCH_SPAN_BLOCK) {
+            break; // 本轮未写满spans, 说明已扫描到数据末尾
+        }
+    }
+
+    local_stats.consumed = pos;
+    if (stats) *stats = local_stats;
+    return rows;
+}
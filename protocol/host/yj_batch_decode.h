@@ -0,0 +1,74 @@
+#ifndef YJ_BATCH_DECODE_H
+#define YJ_BATCH_DECODE_H
+
+#include <stdint.h>
+#include "yj_protocol.h"
+
+/**
+ * @file yj_batch_decode.h
+ * @brief 批量帧解码: 按字段布局把大量帧的数据负载直接解码为按通道连续存放的数组
+ *
+ * 上位机绘图等场景每秒需要处理数千帧, 逐帧构造对象开销过大。
+ * 本接口扫描整块接收数据(或拼接后的多帧), 对功能ID匹配且校验通过的帧,
+ * 把各字段转换为double写入调用方预分配的列数组(每个通道一列), 不做任何内存分配。
+ */
+
+/* 字段类型(数据负载内均为小端字节序, 与yj_pack_*_le一致) */
+typedef enum {
+    YJ_FIELD_U8 = 0,
+    YJ_FIELD_I8,
+    YJ_FIELD_U16,
+    YJ_FIELD_I16,
+    YJ_FIELD_U32,
+    YJ_FIELD_I32,
+    YJ_FIELD_F32,
+    YJ_FIELD_F64
+} yj_field_type_t;
+
+/* 单个字段描述 */
+typedef struct {
+    uint16_t        offset; // 字段在数据负载中的偏移
+    yj_field_type_t type;   // 字段类型
+} yj_field_desc_t;
+
+/* 帧布局描述 */
+typedef struct {
+    const yj_field_desc_t* fields;  // 字段数组, 第i个字段写入第i列
+    uint16_t field_count;           // 字段个数
+    int16_t  func_id;               // 只解码该功能ID的帧, -1表示不过滤
+} yj_column_layout_t;
+
+/* 解码统计 */
+typedef struct {
+    uint32_t consumed;          // 可丢弃的字节数(末尾不完整的帧不计入)
+    uint32_t frames_seen;       // 扫描到的完整帧数
+    uint32_t checksum_errors;   // 校验失败帧数
+    uint32_t skipped_frames;    // 功能ID不匹配或负载长度不足而跳过的帧数
+} yj_batch_decode_stats_t;
+
+/**
+ * @brief 获取字段类型的字节数
+ * @return 字节数, 未知类型返回0
+ */
+uint8_t yj_field_type_size(yj_field_type_t type);
+
+/**
+ * @brief 批量解码为列数组
+ * @param data 接收数据(可包含噪声和多个帧)
+ * @param len 数据长度
+ * @param mode 校验模式
+ * @param head_byte 帧头字节
+ * @param max_payload 允许的最大数据长度
+ * @param layout 字段布局
+ * @param columns 列数组指针数组, 长度为layout->field_count, 每列至少capacity个元素
+ * @param capacity 每列容量(行数上限), 写满后提前返回, consumed指向下一帧起点
+ * @param stats 输出:统计信息, 可为NULL
+ * @return 写入的行数
+ */
+uint32_t yj_batch_decode_columns(const uint8_t* data, uint32_t len,
+                                 yj_checksum_mode_t mode, uint8_t head_byte, uint16_t max_payload,
+                                 const yj_column_layout_t* layout,
+                                 double* const* columns, uint32_t capacity,
+                                 yj_batch_decode_stats_t* stats);
+
+#endif // YJ_BATCH_DECODE_H
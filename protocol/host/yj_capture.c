@@ -0,0 +1,430 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // 用于O_DIRECT
+#endif
+
+#include "yj_capture.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define YJ_CAPTURE_DEFAULT_BUFFER_SIZE (1u << 20)
+#define YJ_CAPTURE_MIN_BUFFER_SIZE     (128u * 1024u) // 至少容纳一条最大记录(16 + 65535字节)
+
+/* 头部字段偏移 */
+#define HDR_OFFSET_VERSION            8
+#define HDR_OFFSET_HEADER_SIZE        10
+#define HDR_OFFSET_FLAGS              12
+#define HDR_OFFSET_CREATED_NS         16
+#define HDR_OFFSET_INDEX_INTERVAL     24
+#define HDR_OFFSET_RECORD_COUNT       32
+#define HDR_OFFSET_LAST_INDEX_OFFSET  40
+#define HDR_OFFSET_DATA_END           48
+
+/* 内部辅助函数: 小端读写 */
+static void put_u16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; ++i) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static void put_u64(uint8_t* p, uint64_t v) {
+    for (int i = 0; i < 8; ++i) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint16_t get_u16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t* p) {
+    uint32_t v = 0;
+    for (int i = 3; i >= 0; --i) v = (v << 8) | p[i];
+    return v;
+}
+
+static uint64_t get_u64(const uint8_t* p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; --i) v = (v << 8) | p[i];
+    return v;
+}
+
+static uint32_t record_size(uint16_t len) {
+    uint32_t size = YJ_CAPTURE_RECORD_HEADER_SIZE + (uint32_t)len;
+    return (size + YJ_CAPTURE_ALIGN - 1) & ~(uint32_t)(YJ_CAPTURE_ALIGN - 1);
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* 内部辅助函数: 完整写出len字节(处理EINTR和短写) */
+static int32_t write_all(int fd, const uint8_t* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, data, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+/* 内部辅助函数: 写出缓冲区, only_aligned为真时只写完整的对齐块 */
+static int32_t flush_buffer(yj_capture_writer_t* writer, int only_aligned) {
+    size_t to_write = writer->buf_used;
+    if (only_aligned) {
+        to_write &= ~(size_t)(YJ_CAPTURE_DIRECT_ALIGN - 1);
+    }
+    if (to_write == 0) {
+        return 0;
+    }
+    if (write_all(writer->fd, writer->buf, to_write) < 0) {
+        return -1;
+    }
+    writer->buf_used -= to_write;
+    if (writer->buf_used > 0) {
+        memmove(writer->buf, &writer->buf[to_write], writer->buf_used);
+    }
+    writer->file_offset += to_write;
+    return 0;
+}
+
+/* 内部辅助函数: 把一条记录放入缓冲区 */
+static int32_t append_record(yj_capture_writer_t* writer, uint64_t ts_ns, uint8_t direction,
+                             uint8_t status, uint8_t func_id, const uint8_t* data, uint16_t len) {
+    uint32_t size = record_size(len);
+    if (writer->buf_used + size > writer->buf_size &&
+        yj_capture_writer_flush(writer) < 0) {
+        return -1;
+    }
+
+    uint8_t* p = &writer->buf[writer->buf_used];
+    put_u64(p, ts_ns);
+    put_u16(p + 8, len);
+    p[10] = direction;
+    p[11] = status;
+    p[12] = func_id;
+    memset(p + 13, 0, size - 13); // 保留字段与对齐填充
+    if (len > 0) {
+        memcpy(p + YJ_CAPTURE_RECORD_HEADER_SIZE, data, len);
+    }
+    writer->buf_used += size;
+    return 0;
+}
+
+/* 内部辅助函数: 为当前索引区间写入索引块 */
+static int32_t append_index_block(yj_capture_writer_t* writer) {
+    uint8_t block[YJ_CAPTURE_INDEX_BLOCK_SIZE];
+    uint64_t offset = writer->file_offset + writer->buf_used;
+
+    put_u64(block, writer->last_index_offset);
+    put_u64(block + 8, writer->block_first_offset);
+    put_u64(block + 16, writer->block_first_ts_ns);
+    put_u32(block + 24, writer->block_records);
+    put_u32(block + 28, 0);
+    if (append_record(writer, writer->last_ts_ns, YJ_CAPTURE_DIR_INDEX, 0, 0,
+                      block, YJ_CAPTURE_INDEX_BLOCK_SIZE) < 0) {
+        return -1;
+    }
+    writer->last_index_offset = offset;
+    writer->block_records = 0;
+    return 0;
+}
+
+/**
+ * @brief 创建录制文件并写入文件头
+ */
+int32_t yj_capture_writer_open(yj_capture_writer_t* writer, const char* path, size_t buffer_size,
+                               uint32_t index_interval, uint32_t options) {
+    if (!writer || !path) {
+        errno = EINVAL;
+        return -1;
+    }
+    memset(writer, 0, sizeof(*writer));
+    writer->fd = -1;
+
+    if (buffer_size == 0) buffer_size = YJ_CAPTURE_DEFAULT_BUFFER_SIZE;
+    if (buffer_size < YJ_CAPTURE_MIN_BUFFER_SIZE) buffer_size = YJ_CAPTURE_MIN_BUFFER_SIZE;
+    buffer_size = (buffer_size + YJ_CAPTURE_DIRECT_ALIGN - 1) & ~(size_t)(YJ_CAPTURE_DIRECT_ALIGN - 1);
+
+    int flags = O_WRONLY | O_CREAT | O_TRUNC;
+#ifdef O_CLOEXEC
+    flags |= O_CLOEXEC;
+#endif
+#ifdef O_DIRECT
+    if (options & YJ_CAPTURE_WRITER_DIRECT) {
+        writer->fd = open(path, flags | O_DIRECT, 0644);
+        if (writer->fd < 0 && errno != EINVAL) {
+            return -1;
+        }
+        // 文件系统不支持O_DIRECT(如tmpfs)时退回缓冲写
+    }
+#endif
+    if (writer->fd < 0) {
+        options &= ~(uint32_t)YJ_CAPTURE_WRITER_DIRECT;
+        writer->fd = open(path, flags, 0644);
+        if (writer->fd < 0) {
+            return -1;
+        }
+    }
+
+    void* buf = NULL;
+    if (posix_memalign(&buf, YJ_CAPTURE_DIRECT_ALIGN, buffer_size) != 0) {
+        close(writer->fd);
+        writer->fd = -1;
+        errno = ENOMEM;
+        return -1;
+    }
+    writer->buf = (uint8_t*)buf;
+    writer->buf_size = buffer_size;
+    writer->options = options;
+    writer->index_interval = index_interval ? index_interval : YJ_CAPTURE_DEFAULT_INDEX_INTERVAL;
+
+    // 文件头放在缓冲区开头, 与第一批记录一起写出
+    uint8_t* hdr = writer->buf;
+    memset(hdr, 0, YJ_CAPTURE_FILE_HEADER_SIZE);
+    memcpy(hdr, YJ_CAPTURE_MAGIC, sizeof(YJ_CAPTURE_MAGIC));
+    put_u16(hdr + HDR_OFFSET_VERSION, YJ_CAPTURE_VERSION);
+    put_u16(hdr + HDR_OFFSET_HEADER_SIZE, YJ_CAPTURE_FILE_HEADER_SIZE);
+    put_u32(hdr + HDR_OFFSET_FLAGS, 0);
+    put_u64(hdr + HDR_OFFSET_CREATED_NS, now_ns());
+    put_u32(hdr + HDR_OFFSET_INDEX_INTERVAL, writer->index_interval);
+    writer->buf_used = YJ_CAPTURE_FILE_HEADER_SIZE;
+    return 0;
+}
+
+/**
+ * @brief 追加一条记录
+ */
+int32_t yj_capture_writer_append(yj_capture_writer_t* writer, uint64_t ts_ns, uint8_t direction,
+                                 uint8_t status, uint8_t func_id, const uint8_t* data, uint16_t len) {
+    if (!writer || writer->fd < 0 || (len > 0 && !data) || direction == YJ_CAPTURE_DIR_INDEX) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (writer->block_records == 0) {
+        writer->block_first_offset = writer->file_offset + writer->buf_used;
+        writer->block_first_ts_ns = ts_ns;
+    }
+    if (append_record(writer, ts_ns, direction, status, func_id, data, len) < 0) {
+        return -1;
+    }
+    writer->last_ts_ns = ts_ns;
+    writer->record_count++;
+    writer->block_records++;
+    if (writer->block_records >= writer->index_interval) {
+        return append_index_block(writer);
+    }
+    return 0;
+}
+
+/**
+ * @brief 将缓冲区数据写入磁盘
+ */
+int32_t yj_capture_writer_flush(yj_capture_writer_t* writer) {
+    if (!writer || writer->fd < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    return flush_buffer(writer, (writer->options & YJ_CAPTURE_WRITER_DIRECT) != 0);
+}
+
+/**
+ * @brief 写入最后的索引块, 回写文件头并关闭文件
+ */
+int32_t yj_capture_writer_close(yj_capture_writer_t* writer) {
+    int32_t result = 0;
+    if (!writer || writer->fd < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (writer->block_records > 0 && append_index_block(writer) < 0) {
+        result = -1;
+    }
+
+#ifdef O_DIRECT
+    if (writer->options & YJ_CAPTURE_WRITER_DIRECT) {
+        // 末尾不足一块的数据无法以O_DIRECT写出, 关闭O_DIRECT后写入
+        int fl = fcntl(writer->fd, F_GETFL);
+        if (fl < 0 || fcntl(writer->fd, F_SETFL, fl & ~O_DIRECT) < 0) {
+            result = -1;
+        }
+    }
+#endif
+    uint64_t data_end = writer->file_offset + writer->buf_used;
+    if (result == 0 && flush_buffer(writer, 0) < 0) {
+        result = -1;
+    }
+
+    if (result == 0) {
+        uint8_t tail[24];
+        put_u64(tail, writer->record_count);
+        put_u64(tail + 8, writer->last_index_offset);
+        put_u64(tail + 16, data_end);
+        if (pwrite(writer->fd, tail, sizeof(tail), HDR_OFFSET_RECORD_COUNT) != (ssize_t)sizeof(tail)) {
+            result = -1;
+        }
+    }
+
+    if (close(writer->fd) < 0) {
+        result = -1;
+    }
+    writer->fd = -1;
+    free(writer->buf);
+    writer->buf = NULL;
+    return result;
+}
+
+/**
+ * @brief 以只读方式映射录制文件
+ */
+int32_t yj_capture_reader_open(yj_capture_reader_t* reader, const char* path) {
+    struct stat st;
+    if (!reader || !path) {
+        errno = EINVAL;
+        return -1;
+    }
+    memset(reader, 0, sizeof(*reader));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        return -1;
+    }
+    if ((uint64_t)st.st_size < YJ_CAPTURE_FILE_HEADER_SIZE) {
+        close(fd);
+        return -2;
+    }
+    void* base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // 映射建立后即可关闭fd
+    if (base == MAP_FAILED) {
+        return -1;
+    }
+    const uint8_t* hdr = (const uint8_t*)base;
+    if (memcmp(hdr, YJ_CAPTURE_MAGIC, sizeof(YJ_CAPTURE_MAGIC)) != 0 ||
+        get_u16(hdr + HDR_OFFSET_VERSION) != YJ_CAPTURE_VERSION ||
+        get_u16(hdr + HDR_OFFSET_HEADER_SIZE) != YJ_CAPTURE_FILE_HEADER_SIZE) {
+        munmap(base, (size_t)st.st_size);
+        return -2;
+    }
+#ifdef MADV_SEQUENTIAL
+    madvise(base, (size_t)st.st_size, MADV_SEQUENTIAL);
+#endif
+
+    reader->base = hdr;
+    reader->size = (uint64_t)st.st_size;
+    reader->created_ns = get_u64(hdr + HDR_OFFSET_CREATED_NS);
+    reader->index_interval = get_u32(hdr + HDR_OFFSET_INDEX_INTERVAL);
+    reader->record_count = get_u64(hdr + HDR_OFFSET_RECORD_COUNT);
+    reader->last_index_offset = get_u64(hdr + HDR_OFFSET_LAST_INDEX_OFFSET);
+    reader->data_end = get_u64(hdr + HDR_OFFSET_DATA_END);
+    if (reader->data_end == 0 || reader->data_end > reader->size) {
+        // 未正常关闭: 以文件实际长度为准, 不使用索引链表
+        reader->data_end = reader->size;
+        reader->record_count = 0;
+        reader->last_index_offset = 0;
+    }
+    return 0;
+}
+
+/**
+ * @brief 解除映射
+ */
+void yj_capture_reader_close(yj_capture_reader_t* reader) {
+    if (reader && reader->base) {
+        munmap((void*)reader->base, (size_t)reader->size);
+        reader->base = NULL;
+    }
+}
+
+/**
+ * @brief 读取offset处的记录(包括索引块)
+ */
+int32_t yj_capture_reader_read(const yj_capture_reader_t* reader, uint64_t offset,
+                               yj_capture_record_t* record, uint64_t* next_offset) {
+    if (!reader || !reader->base || !record) return -1;
+    if (offset < YJ_CAPTURE_FILE_HEADER_SIZE || (offset & (YJ_CAPTURE_ALIGN - 1)) != 0) return -1;
+    if (offset + YJ_CAPTURE_RECORD_HEADER_SIZE > reader->data_end) return 0;
+
+    const uint8_t* p = reader->base + offset;
+    uint16_t len = get_u16(p + 8);
+    if (offset + YJ_CAPTURE_RECORD_HEADER_SIZE + len > reader->data_end) return 0; // 末尾记录不完整
+
+    record->offset = offset;
+    record->ts_ns = get_u64(p);
+    record->len = len;
+    record->direction = p[10];
+    record->status = p[11];
+    record->func_id = p[12];
+    record->data = p + YJ_CAPTURE_RECORD_HEADER_SIZE;
+    if (record->direction == YJ_CAPTURE_DIR_INDEX && len != YJ_CAPTURE_INDEX_BLOCK_SIZE) return -1;
+    if (next_offset) *next_offset = offset + record_size(len);
+    return 1;
+}
+
+/**
+ * @brief 从offset开始读取下一条数据记录(跳过索引块)
+ */
+int32_t yj_capture_reader_next(const yj_capture_reader_t* reader, uint64_t* offset,
+                               yj_capture_record_t* record) {
+    for (;;) {
+        uint64_t next;
+        int32_t ret = yj_capture_reader_read(reader, *offset, record, &next);
+        if (ret <= 0) return ret;
+        *offset = next;
+        if (record->direction != YJ_CAPTURE_DIR_INDEX) return 1;
+    }
+}
+
+/**
+ * @brief 解析offset处的索引块
+ */
+int32_t yj_capture_reader_index_block(const yj_capture_reader_t* reader, uint64_t offset,
+                                      yj_capture_index_block_t* block) {
+    yj_capture_record_t record;
+    if (yj_capture_reader_read(reader, offset, &record, NULL) != 1 ||
+        record.direction != YJ_CAPTURE_DIR_INDEX || !block) {
+        return -1;
+    }
+    block->offset = offset;
+    block->last_ts_ns = record.ts_ns;
+    block->prev_index_offset = get_u64(record.data);
+    block->first_record_offset = get_u64(record.data + 8);
+    block->first_ts_ns = get_u64(record.data + 16);
+    block->record_count = get_u32(record.data + 24);
+    return 0;
+}
+
+/**
+ * @brief 按时间定位
+ */
+uint64_t yj_capture_reader_seek_time(const yj_capture_reader_t* reader, uint64_t ts_ns) {
+    uint64_t cursor = reader ? reader->last_index_offset : 0;
+    yj_capture_index_block_t block;
+
+    // 记录时间戳单调不减, 找到最后一个first_ts_ns < ts_ns的索引区间即可;
+    // first_ts_ns == ts_ns时前一区间末尾可能还有同一时间戳的记录, 需继续向前
+    while (cursor != 0 && yj_capture_reader_index_block(reader, cursor, &block) == 0) {
+        if (block.first_ts_ns < ts_ns) {
+            return block.first_record_offset;
+        }
+        if (block.prev_index_offset >= cursor) break; // 防止损坏的链表成环
+        cursor = block.prev_index_offset;
+    }
+    return YJ_CAPTURE_FILE_HEADER_SIZE;
+}
@@ -0,0 +1,188 @@
+#ifndef YJ_CAPTURE_H
+#define YJ_CAPTURE_H
+
+#include <stdint.h>
+#include <stddef.h> // 用于size_t
+
+/**
+ * @file yj_capture.h
+ * @brief 上位机二进制录制文件(.yjcap)的写入与内存映射读取
+ *
+ * 长时间录制时逐帧追加写入磁盘, 内存占用只有一个写缓冲区, 不再需要导出步骤。
+ *
+ * 文件布局(所有整数均为小端):
+ * +------------------+----------+----------+-----+-----------+----------+-----+-----------+
+ * | 文件头(64字节)   | 记录     | 记录     | ... | 索引块    | 记录     | ... | 索引块    |
+ * +------------------+----------+----------+-----+-----------+----------+-----+-----------+
+ *
+ * 文件头:
+ *   0  char[8] magic "YJCAP01\0"      8  u16 version      10 u16 header_size  12 u32 flags
+ *   16 u64 created_ns                 24 u32 index_interval                   28 u32 reserved
+ *   32 u64 record_count               40 u64 last_index_offset                48 u64 data_end
+ *   56 u64 reserved
+ *   record_count/last_index_offset/data_end在关闭时回写; 为0表示文件未正常关闭,
+ *   读取端从头顺序扫描恢复(记录自带长度, 可自描述)。
+ *
+ * 记录 = 16字节记录头 + 数据 + 填充到8字节对齐:
+ *   0 u64 ts_ns   8 u16 len   10 u8 direction   11 u8 status   12 u8 func_id   13 u8 reserved[3]
+ *
+ * 索引块是direction为YJ_CAPTURE_DIR_INDEX的特殊记录, 每index_interval条记录写入一个,
+ * 记录头ts_ns为块内最后一条记录的时间戳, 数据为32字节:
+ *   0 u64 prev_index_offset   8 u64 first_record_offset   16 u64 first_ts_ns   24 u32 record_count
+ * 索引块通过prev_index_offset串成链表, 可按时间快速定位而无需扫描整个文件。
+ */
+
+#define YJ_CAPTURE_MAGIC              "YJCAP01"  // 含结尾'\0'共8字节
+#define YJ_CAPTURE_VERSION            1
+#define YJ_CAPTURE_FILE_HEADER_SIZE   64
+#define YJ_CAPTURE_RECORD_HEADER_SIZE 16
+#define YJ_CAPTURE_INDEX_BLOCK_SIZE   32
+#define YJ_CAPTURE_ALIGN              8          // 记录对齐字节数
+#define YJ_CAPTURE_DEFAULT_INDEX_INTERVAL 4096   // 默认每4096条记录一个索引块
+#define YJ_CAPTURE_DIRECT_ALIGN       4096       // O_DIRECT模式的块对齐
+
+/* 记录方向 */
+#define YJ_CAPTURE_DIR_RX     0x00
+#define YJ_CAPTURE_DIR_TX     0x01
+#define YJ_CAPTURE_DIR_INDEX  0xFF  // 索引块
+
+/* 记录状态 */
+#define YJ_CAPTURE_STATUS_RAW            0x00 // 未解析的原始数据块, func_id无意义
+#define YJ_CAPTURE_STATUS_OK             0x01 // 校验通过的完整帧
+#define YJ_CAPTURE_STATUS_CHECKSUM_ERROR 0x02 // 校验失败的帧
+#define YJ_CAPTURE_STATUS_PARSE_ERROR    0x03 // 其他解析错误
+
+/* 写入选项 */
+#define YJ_CAPTURE_WRITER_DIRECT  0x01 // 使用O_DIRECT绕过页缓存(平台不支持时自动退回缓冲写)
+
+/* 记录(读取端视图, data指向映射区) */
+typedef struct {
+    uint64_t       offset;    // 记录在文件中的偏移
+    uint64_t       ts_ns;     // 时间戳(Unix纪元纳秒)
+    const uint8_t* data;      // 数据
+    uint16_t       len;       // 数据长度
+    uint8_t        direction; // YJ_CAPTURE_DIR_*
+    uint8_t        status;    // YJ_CAPTURE_STATUS_*
+    uint8_t        func_id;   // 功能ID
+} yj_capture_record_t;
+
+/* 索引块 */
+typedef struct {
+    uint64_t offset;              // 索引块自身的偏移
+    uint64_t last_ts_ns;          // 块内最后一条记录的时间戳
+    uint64_t prev_index_offset;   // 上一个索引块的偏移, 0表示没有
+    uint64_t first_record_offset; // 块内第一条记录的偏移
+    uint64_t first_ts_ns;         // 块内第一条记录的时间戳
+    uint32_t record_count;        // 块内记录数
+} yj_capture_index_block_t;
+
+/* 写入器 */
+typedef struct {
+    int      fd;                  // 文件描述符
+    uint32_t options;             // YJ_CAPTURE_WRITER_*
+    uint8_t* buf;                 // 写缓冲区(O_DIRECT模式下按块对齐)
+    size_t   buf_size;            // 缓冲区大小
+    size_t   buf_used;            // 缓冲区已用字节数
+    uint64_t file_offset;         // 缓冲区起始对应的文件偏移
+    uint32_t index_interval;      // 索引块间隔(记录数)
+    uint64_t record_count;        // 已写入的数据记录数
+    uint64_t last_index_offset;   // 最近一个索引块的偏移
+    uint64_t block_first_offset;  // 当前索引区间第一条记录的偏移
+    uint64_t block_first_ts_ns;   // 当前索引区间第一条记录的时间戳
+    uint64_t last_ts_ns;          // 最近一条记录的时间戳
+    uint32_t block_records;       // 当前索引区间的记录数
+} yj_capture_writer_t;
+
+/* 读取器(整个文件只读映射) */
+typedef struct {
+    const uint8_t* base;          // 映射起始地址
+    uint64_t size;                // 映射长度
+    uint64_t data_end;            // 有效数据末尾
+    uint64_t record_count;        // 文件头中的记录数(未正常关闭时为0)
+    uint64_t last_index_offset;   // 文件头中的最后索引块偏移(未正常关闭时为0)
+    uint64_t created_ns;          // 创建时间
+    uint32_t index_interval;      // 索引块间隔
+} yj_capture_reader_t;
+
+/**
+ * @brief 创建录制文件并写入文件头
+ * @param writer 写入器
+ * @param path 文件路径(已存在时截断)
+ * @param buffer_size 写缓冲区大小, 0使用默认值(1MB); O_DIRECT模式下向上取整到4096的倍数
+ * @param index_interval 索引块间隔, 0使用默认值
+ * @param options YJ_CAPTURE_WRITER_*
+ * @return 0成功, -1失败(errno保留系统错误)
+ */
+int32_t yj_capture_writer_open(yj_capture_writer_t* writer, const char* path, size_t buffer_size,
+                               uint32_t index_interval, uint32_t options);
+
+/**
+ * @brief 追加一条记录
+ * @param ts_ns 时间戳(Unix纪元纳秒)
+ * @param direction YJ_CAPTURE_DIR_RX/TX
+ * @param status YJ_CAPTURE_STATUS_*
+ * @param func_id 功能ID
+ * @param data 数据
+ * @param len 数据长度
+ * @return 0成功, -1写盘失败
+ */
+int32_t yj_capture_writer_append(yj_capture_writer_t* writer, uint64_t ts_ns, uint8_t direction,
+                                 uint8_t status, uint8_t func_id, const uint8_t* data, uint16_t len);
+
+/**
+ * @brief 将缓冲区数据写入磁盘(O_DIRECT模式下只写出完整的对齐块)
+ * @return 0成功, -1失败
+ */
+int32_t yj_capture_writer_flush(yj_capture_writer_t* writer);
+
+/**
+ * @brief 写入最后的索引块, 回写文件头并关闭文件
+ * @return 0成功, -1失败(文件仍会被关闭)
+ */
+int32_t yj_capture_writer_close(yj_capture_writer_t* writer);
+
+/**
+ * @brief 以只读方式映射录制文件
+ * @return 0成功, -1打开/映射失败, -2文件格式错误
+ */
+int32_t yj_capture_reader_open(yj_capture_reader_t* reader, const char* path);
+
+/**
+ * @brief 解除映射
+ */
+void yj_capture_reader_close(yj_capture_reader_t* reader);
+
+/**
+ * @brief 读取offset处的记录(包括索引块)
+ * @param offset 记录偏移, 第一条记录位于YJ_CAPTURE_FILE_HEADER_SIZE
+ * @param record 输出:记录
+ * @param next_offset 输出:下一条记录的偏移
+ * @return 1成功, 0已到末尾(或末尾记录不完整), -1记录损坏
+ */
+int32_t yj_capture_reader_read(const yj_capture_reader_t* reader, uint64_t offset,
+                               yj_capture_record_t* record, uint64_t* next_offset);
+
+/**
+ * @brief 从offset开始读取下一条数据记录(跳过索引块)
+ * @param offset 输入:起始偏移; 输出:下一条记录的偏移
+ * @return 1成功, 0已到末尾, -1记录损坏
+ */
+int32_t yj_capture_reader_next(const yj_capture_reader_t* reader, uint64_t* offset,
+                               yj_capture_record_t* record);
+
+/**
+ * @brief 解析offset处的索引块
+ * @return 0成功, -1该位置不是索引块
+ */
+int32_t yj_capture_reader_index_block(const yj_capture_reader_t* reader, uint64_t offset,
+                                      yj_capture_index_block_t* block);
+
+/**
+ * @brief 按时间定位: 返回一个不晚于第一条ts_ns >= t的记录的起始偏移
+ *
+ * 文件正常关闭时沿索引块链表向前查找, 否则返回第一条记录的偏移。
+ * 调用方从返回的偏移开始用yj_capture_reader_next顺序读取并跳过ts_ns < t的记录。
+ */
+uint64_t yj_capture_reader_seek_time(const yj_capture_reader_t* reader, uint64_t ts_ns);
+
+#endif // YJ_CAPTURE_H
@@ -0,0 +1,337 @@
+#include "yj_capture_index.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define TIME_ENTRY_SIZE  16
+#define FUNC_ENTRY_SIZE  16
+
+/* 头部字段偏移 */
+#define IDX_OFFSET_VERSION            8
+#define IDX_OFFSET_HEADER_SIZE        10
+#define IDX_OFFSET_TIME_STRIDE        12
+#define IDX_OFFSET_CAPTURE_CREATED_NS 16
+#define IDX_OFFSET_CAPTURE_DATA_END   24
+#define IDX_OFFSET_RECORD_COUNT       32
+#define IDX_OFFSET_TIME_ENTRY_COUNT   40
+#define IDX_OFFSET_POSTING_COUNT      48
+
+/* 内部辅助函数: 小端读写 */
+static void put_u16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; ++i) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static void put_u64(uint8_t* p, uint64_t v) {
+    for (int i = 0; i < 8; ++i) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint16_t get_u16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t* p) {
+    uint32_t v = 0;
+    for (int i = 3; i >= 0; --i) v = (v << 8) | p[i];
+    return v;
+}
+
+static uint64_t get_u64(const uint8_t* p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; --i) v = (v << 8) | p[i];
+    return v;
+}
+
+static int host_is_little_endian(void) {
+    const uint16_t probe = 1;
+    return *(const uint8_t*)&probe == 1;
+}
+
+static uint64_t index_file_size(uint64_t time_entry_count, uint64_t posting_count) {
+    return YJ_CAPTURE_INDEX_HEADER_SIZE + time_entry_count * TIME_ENTRY_SIZE +
+           (uint64_t)YJ_CAPTURE_INDEX_FUNC_COUNT * FUNC_ENTRY_SIZE + posting_count * 8u;
+}
+
+/* 内部辅助函数: 录制文件中offset处记录的时间戳 */
+static uint64_t record_ts(const yj_capture_reader_t* capture, uint64_t offset) {
+    return get_u64(capture->base + offset);
+}
+
+/**
+ * @brief 扫描录制文件生成索引文件
+ *
+ * 两遍扫描: 第一遍统计记录数和各功能ID帧数, 确定文件大小和各倒排列表的起始位置;
+ * 第二遍直接写入映射后的索引文件, 不需要额外的内存。
+ */
+int32_t yj_capture_index_build(const char* capture_path, const char* index_path, uint32_t time_stride) {
+    yj_capture_reader_t capture;
+    yj_capture_record_t record;
+    uint64_t func_counts[YJ_CAPTURE_INDEX_FUNC_COUNT];
+    uint64_t func_cursor[YJ_CAPTURE_INDEX_FUNC_COUNT];
+    uint64_t record_count = 0;
+    uint64_t posting_count = 0;
+    uint64_t offset;
+    int32_t ret;
+
+    if (!capture_path || !index_path) {
+        errno = EINVAL;
+        return YJ_CAPTURE_INDEX_ERR_IO;
+    }
+    if (time_stride == 0) time_stride = YJ_CAPTURE_INDEX_DEFAULT_STRIDE;
+
+    ret = yj_capture_reader_open(&capture, capture_path);
+    if (ret < 0) {
+        return ret == -2 ? YJ_CAPTURE_INDEX_ERR_FORMAT : YJ_CAPTURE_INDEX_ERR_IO;
+    }
+
+    // 第一遍: 计数
+    memset(func_counts, 0, sizeof(func_counts));
+    offset = YJ_CAPTURE_FILE_HEADER_SIZE;
+    while ((ret = yj_capture_reader_next(&capture, &offset, &record)) == 1) {
+        record_count++;
+        if (record.status != YJ_CAPTURE_STATUS_RAW) {
+            func_counts[record.func_id]++;
+            posting_count++;
+        }
+    }
+    // ret == -1(记录损坏)时只索引损坏位置之前的部分, 与顺序读取的结果一致
+
+    uint64_t time_entry_count = (record_count + time_stride - 1) / time_stride;
+    uint64_t size = index_file_size(time_entry_count, posting_count);
+
+    int flags = O_RDWR | O_CREAT | O_TRUNC;
+#ifdef O_CLOEXEC
+    flags |= O_CLOEXEC;
+#endif
+    int fd = open(index_path, flags, 0644);
+    if (fd < 0) {
+        yj_capture_reader_close(&capture);
+        return YJ_CAPTURE_INDEX_ERR_IO;
+    }
+    if (ftruncate(fd, (off_t)size) < 0) {
+        close(fd);
+        yj_capture_reader_close(&capture);
+        return YJ_CAPTURE_INDEX_ERR_IO;
+    }
+    uint8_t* base = (uint8_t*)mmap(NULL, (size_t)size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == (uint8_t*)MAP_FAILED) {
+        close(fd);
+        yj_capture_reader_close(&capture);
+        return YJ_CAPTURE_INDEX_ERR_IO;
+    }
+
+    // 文件头(ftruncate后内容全为0, 保留字段无需清零)
+    memcpy(base, YJ_CAPTURE_INDEX_MAGIC, sizeof(YJ_CAPTURE_INDEX_MAGIC));
+    put_u16(base + IDX_OFFSET_VERSION, YJ_CAPTURE_INDEX_VERSION);
+    put_u16(base + IDX_OFFSET_HEADER_SIZE, YJ_CAPTURE_INDEX_HEADER_SIZE);
+    put_u32(base + IDX_OFFSET_TIME_STRIDE, time_stride);
+    put_u64(base + IDX_OFFSET_CAPTURE_CREATED_NS, capture.created_ns);
+    put_u64(base + IDX_OFFSET_CAPTURE_DATA_END, capture.data_end);
+    put_u64(base + IDX_OFFSET_RECORD_COUNT, record_count);
+    put_u64(base + IDX_OFFSET_TIME_ENTRY_COUNT, time_entry_count);
+    put_u64(base + IDX_OFFSET_POSTING_COUNT, posting_count);
+
+    uint8_t* time_entries = base + YJ_CAPTURE_INDEX_HEADER_SIZE;
+    uint8_t* func_table = time_entries + time_entry_count * TIME_ENTRY_SIZE;
+    uint8_t* postings = func_table + YJ_CAPTURE_INDEX_FUNC_COUNT * FUNC_ENTRY_SIZE;
+
+    uint64_t first = 0;
+    for (int i = 0; i < YJ_CAPTURE_INDEX_FUNC_COUNT; ++i) {
+        put_u64(func_table + i * FUNC_ENTRY_SIZE, first);
+        put_u64(func_table + i * FUNC_ENTRY_SIZE + 8, func_counts[i]);
+        func_cursor[i] = first;
+        first += func_counts[i];
+    }
+
+    // 第二遍: 填写时间索引和倒排区
+    uint64_t n = 0;
+    offset = YJ_CAPTURE_FILE_HEADER_SIZE;
+    while (n < record_count) {
+        if (yj_capture_reader_next(&capture, &offset, &record) != 1) break;
+        if (n % time_stride == 0) {
+            uint8_t* entry = time_entries + (n / time_stride) * TIME_ENTRY_SIZE;
+            put_u64(entry, record.ts_ns);
+            put_u64(entry + 8, record.offset);
+        }
+        if (record.status != YJ_CAPTURE_STATUS_RAW) {
+            put_u64(postings + func_cursor[record.func_id]++ * 8u, record.offset);
+        }
+        n++;
+    }
+
+    ret = 0;
+    if (msync(base, (size_t)size, MS_SYNC) < 0) ret = YJ_CAPTURE_INDEX_ERR_IO;
+    munmap(base, (size_t)size);
+    if (close(fd) < 0) ret = YJ_CAPTURE_INDEX_ERR_IO;
+    yj_capture_reader_close(&capture);
+    return ret;
+}
+
+/**
+ * @brief 只读映射索引文件并校验其与录制文件匹配
+ */
+int32_t yj_capture_index_open(yj_capture_index_t* index, const char* index_path,
+                              const yj_capture_reader_t* capture) {
+    struct stat st;
+    if (!index || !index_path || !capture || !capture->base) {
+        errno = EINVAL;
+        return YJ_CAPTURE_INDEX_ERR_IO;
+    }
+    memset(index, 0, sizeof(*index));
+    if (!host_is_little_endian()) {
+        return YJ_CAPTURE_INDEX_ERR_FORMAT; // 倒排区按小端直接访问
+    }
+
+    int fd = open(index_path, O_RDONLY);
+    if (fd < 0) {
+        return YJ_CAPTURE_INDEX_ERR_IO;
+    }
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        return YJ_CAPTURE_INDEX_ERR_IO;
+    }
+    uint64_t size = (uint64_t)st.st_size;
+    if (size < index_file_size(0, 0)) {
+        close(fd);
+        return YJ_CAPTURE_INDEX_ERR_FORMAT;
+    }
+    void* map = mmap(NULL, (size_t)size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return YJ_CAPTURE_INDEX_ERR_IO;
+    }
+    const uint8_t* base = (const uint8_t*)map;
+
+    uint64_t time_entry_count = get_u64(base + IDX_OFFSET_TIME_ENTRY_COUNT);
+    uint64_t posting_count = get_u64(base + IDX_OFFSET_POSTING_COUNT);
+    if (memcmp(base, YJ_CAPTURE_INDEX_MAGIC, sizeof(YJ_CAPTURE_INDEX_MAGIC)) != 0 ||
+        get_u16(base + IDX_OFFSET_VERSION) != YJ_CAPTURE_INDEX_VERSION ||
+        get_u16(base + IDX_OFFSET_HEADER_SIZE) != YJ_CAPTURE_INDEX_HEADER_SIZE ||
+        get_u32(base + IDX_OFFSET_TIME_STRIDE) == 0 ||
+        time_entry_count > size / TIME_ENTRY_SIZE || posting_count > size / 8u ||
+        index_file_size(time_entry_count, posting_count) != size) {
+        munmap(map, (size_t)size);
+        return YJ_CAPTURE_INDEX_ERR_FORMAT;
+    }
+    if (get_u64(base + IDX_OFFSET_CAPTURE_CREATED_NS) != capture->created_ns ||
+        get_u64(base + IDX_OFFSET_CAPTURE_DATA_END) != capture->data_end) {
+        munmap(map, (size_t)size);
+        return YJ_CAPTURE_INDEX_ERR_STALE;
+    }
+
+    index->base = base;
+    index->size = size;
+    index->capture = capture;
+    index->time_stride = get_u32(base + IDX_OFFSET_TIME_STRIDE);
+    index->record_count = get_u64(base + IDX_OFFSET_RECORD_COUNT);
+    index->time_entry_count = time_entry_count;
+    index->posting_count = posting_count;
+    index->time_entries = base + YJ_CAPTURE_INDEX_HEADER_SIZE;
+    index->func_table = index->time_entries + time_entry_count * TIME_ENTRY_SIZE;
+    index->postings = (const uint64_t*)(const void*)(index->func_table +
+                                                     YJ_CAPTURE_INDEX_FUNC_COUNT * FUNC_ENTRY_SIZE);
+
+    // 校验功能ID表和倒排区偏移, 之后的查询可直接访问录制文件映射区
+    for (int i = 0; i < YJ_CAPTURE_INDEX_FUNC_COUNT; ++i) {
+        uint64_t first = get_u64(index->func_table + i * FUNC_ENTRY_SIZE);
+        uint64_t count = get_u64(index->func_table + i * FUNC_ENTRY_SIZE + 8);
+        if (first > posting_count || count > posting_count - first) {
+            yj_capture_index_close(index);
+            return YJ_CAPTURE_INDEX_ERR_FORMAT;
+        }
+    }
+    for (uint64_t i = 0; i < posting_count; ++i) {
+        uint64_t offset = index->postings[i];
+        if (offset < YJ_CAPTURE_FILE_HEADER_SIZE ||
+            offset + YJ_CAPTURE_RECORD_HEADER_SIZE > capture->data_end) {
+            yj_capture_index_close(index);
+            return YJ_CAPTURE_INDEX_ERR_FORMAT;
+        }
+    }
+#ifdef MADV_RANDOM
+    madvise(map, (size_t)size, MADV_RANDOM);
+#endif
+    return 0;
+}
+
+/**
+ * @brief 解除映射
+ */
+void yj_capture_index_close(yj_capture_index_t* index) {
+    if (index && index->base) {
+        munmap((void*)index->base, (size_t)index->size);
+        index->base = NULL;
+    }
+}
+
+/**
+ * @brief 按时间定位
+ */
+uint64_t yj_capture_index_seek_time(const yj_capture_index_t* index, uint64_t ts_ns) {
+    if (!index || !index->base) return YJ_CAPTURE_FILE_HEADER_SIZE;
+
+    // 找最后一个ts < t的索引项: 其后的记录才可能满足ts >= t(时间戳相等的记录可能跨越索引项)
+    uint64_t lo = 0, hi = index->time_entry_count;
+    while (lo < hi) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        if (get_u64(index->time_entries + mid * TIME_ENTRY_SIZE) < ts_ns) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == 0) return YJ_CAPTURE_FILE_HEADER_SIZE;
+    return get_u64(index->time_entries + (lo - 1) * TIME_ENTRY_SIZE + 8);
+}
+
+/**
+ * @brief 获取某功能ID的倒排列表
+ */
+const uint64_t* yj_capture_index_postings(const yj_capture_index_t* index, uint8_t func_id, uint64_t* count) {
+    if (count) *count = 0;
+    if (!index || !index->base) return NULL;
+    const uint8_t* entry = index->func_table + (size_t)func_id * FUNC_ENTRY_SIZE;
+    uint64_t n = get_u64(entry + 8);
+    if (n == 0) return NULL;
+    if (count) *count = n;
+    return index->postings + get_u64(entry);
+}
+
+/* 内部辅助函数: 倒排列表中第一个时间戳 >= ts_ns 的下标 */
+static uint64_t lower_bound_ts(const yj_capture_index_t* index, const uint64_t* list,
+                               uint64_t count, uint64_t ts_ns) {
+    uint64_t lo = 0, hi = count;
+    while (lo < hi) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        if (record_ts(index->capture, list[mid]) < ts_ns) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/**
+ * @brief 查询某功能ID在[t0_ns, t1_ns)内的帧
+ */
+uint64_t yj_capture_index_query(const yj_capture_index_t* index, uint8_t func_id,
+                                uint64_t t0_ns, uint64_t t1_ns, uint64_t* first) {
+    uint64_t count = 0;
+    if (first) *first = 0;
+    const uint64_t* list = yj_capture_index_postings(index, func_id, &count);
+    if (!list || t1_ns <= t0_ns) return 0;
+
+    uint64_t begin = lower_bound_ts(index, list, count, t0_ns);
+    uint64_t end = begin + lower_bound_ts(index, list + begin, count - begin, t1_ns);
+    if (first) *first = begin;
+    return end - begin;
+}
@@ -0,0 +1,96 @@
+#ifndef YJ_CAPTURE_INDEX_H
+#define YJ_CAPTURE_INDEX_H
+
+#include <stdint.h>
+#include "yj_capture.h"
+
+/**
+ * @file yj_capture_index.h
+ * @brief 录制文件(.yjcap)的二级索引(.yjidx): 稀疏时间索引 + 按功能ID的倒排列表
+ *
+ * 索引文件与录制文件并列存放(通常为"<录制文件名>.yjidx"), 由yj_capture_index_build一次生成,
+ * 查询时只读映射, "某功能ID在[t0, t1)内的所有帧"只需两次二分查找。
+ *
+ * 文件布局(所有整数均为小端):
+ *   文件头(64字节):
+ *     0  char[8] magic "YJIDX01\0"      8  u16 version        10 u16 header_size   12 u32 time_stride
+ *     16 u64 capture_created_ns          24 u64 capture_data_end                    32 u64 record_count
+ *     40 u64 time_entry_count            48 u64 posting_count                       56 u64 reserved
+ *   稀疏时间索引: time_entry_count个{u64 ts_ns, u64 offset}, 每time_stride条数据记录一项
+ *   功能ID表: 256个{u64 first, u64 count}, first为该功能ID在倒排区中的起始下标
+ *   倒排区: posting_count个u64记录偏移, 按功能ID分组, 组内按文件顺序(即时间顺序)排列
+ * 只有状态不是YJ_CAPTURE_STATUS_RAW的记录(即完整帧)进入倒排列表。
+ * capture_created_ns/capture_data_end用于检测索引与录制文件是否匹配。
+ */
+
+#define YJ_CAPTURE_INDEX_MAGIC          "YJIDX01"  // 含结尾'\0'共8字节
+#define YJ_CAPTURE_INDEX_VERSION        1
+#define YJ_CAPTURE_INDEX_HEADER_SIZE    64
+#define YJ_CAPTURE_INDEX_DEFAULT_STRIDE 256        // 默认每256条记录一个时间索引项
+#define YJ_CAPTURE_INDEX_FUNC_COUNT     256
+
+/* 错误码 */
+#define YJ_CAPTURE_INDEX_ERR_IO        (-1) // 打开/映射/写入失败(errno保留系统错误)
+#define YJ_CAPTURE_INDEX_ERR_FORMAT    (-2) // 文件格式错误或主机字节序不是小端
+#define YJ_CAPTURE_INDEX_ERR_STALE     (-3) // 索引与录制文件不匹配(需要重新生成)
+
+/* 已打开的索引 */
+typedef struct {
+    const uint8_t* base;                   // 索引文件映射起始地址
+    uint64_t size;                         // 映射长度
+    const yj_capture_reader_t* capture;    // 对应的录制文件
+    uint32_t time_stride;                  // 时间索引步长
+    uint64_t record_count;                 // 数据记录总数
+    uint64_t time_entry_count;             // 时间索引项数
+    uint64_t posting_count;                // 倒排区项数
+    const uint8_t* time_entries;           // 稀疏时间索引
+    const uint8_t* func_table;             // 功能ID表
+    const uint64_t* postings;              // 倒排区(8字节对齐, 小端主机上可直接访问)
+} yj_capture_index_t;
+
+/**
+ * @brief 扫描录制文件生成索引文件
+ * @param capture_path 录制文件路径
+ * @param index_path 索引文件路径(已存在时覆盖)
+ * @param time_stride 时间索引步长, 0使用默认值
+ * @return 0成功, 负数为YJ_CAPTURE_INDEX_ERR_*
+ */
+int32_t yj_capture_index_build(const char* capture_path, const char* index_path, uint32_t time_stride);
+
+/**
+ * @brief 只读映射索引文件并校验其与录制文件匹配
+ * @param index 索引
+ * @param index_path 索引文件路径
+ * @param capture 已打开的录制文件, 生命周期须长于索引
+ * @return 0成功, 负数为YJ_CAPTURE_INDEX_ERR_*
+ */
+int32_t yj_capture_index_open(yj_capture_index_t* index, const char* index_path,
+                              const yj_capture_reader_t* capture);
+
+/**
+ * @brief 解除映射
+ */
+void yj_capture_index_close(yj_capture_index_t* index);
+
+/**
+ * @brief 按时间定位: 返回一个不晚于第一条ts_ns >= t的数据记录的偏移
+ * @note 精度为time_stride条记录, 调用方从该偏移顺序读取并跳过ts_ns < t的记录
+ */
+uint64_t yj_capture_index_seek_time(const yj_capture_index_t* index, uint64_t ts_ns);
+
+/**
+ * @brief 获取某功能ID的倒排列表
+ * @param count 输出:列表长度
+ * @return 记录偏移数组(按时间顺序), 没有该功能ID的帧时返回NULL
+ */
+const uint64_t* yj_capture_index_postings(const yj_capture_index_t* index, uint8_t func_id, uint64_t* count);
+
+/**
+ * @brief 查询某功能ID在[t0_ns, t1_ns)内的帧
+ * @param first 输出:第一条命中帧在倒排列表中的下标
+ * @return 命中帧数; 命中帧的偏移为yj_capture_index_postings(...)[first .. first + 返回值)
+ */
+uint64_t yj_capture_index_query(const yj_capture_index_t* index, uint8_t func_id,
+                                uint64_t t0_ns, uint64_t t1_ns, uint64_t* first);
+
+#endif // YJ_CAPTURE_INDEX_H
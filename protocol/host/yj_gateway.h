@@ -0,0 +1,41 @@
+#ifndef YJ_GATEWAY_H
+#define YJ_GATEWAY_H
+
+#include <stdint.h>
+
+/**
+ * @file yj_gateway.h
+ * @brief 多串口网关(yj_gateway)与本地客户端之间的Unix套接字消息格式
+ *
+ * 网关在一个进程内用epoll同时服务多个串口/伪终端, 每个端口一个协议处理器,
+ * 解出的帧经AF_UNIX/SOCK_SEQPACKET套接字转发给所有已连接的客户端。
+ *
+ * 每个套接字消息由若干条记录紧密拼接而成(网关每轮事件循环合并发送一次),
+ * 每条记录 = 16字节记录头 + 数据(不做填充), 所有整数均为小端:
+ *   0 u16 record_len(含记录头)   2 u8 type   3 u8 port
+ *   4 u64 ts_ns(CLOCK_REALTIME, 同一次read内解出的帧共用)
+ *   12 u8 s_addr   13 u8 d_addr   14 u8 func_id   15 u8 flags
+ *
+ * 记录类型:
+ *   FRAME       网关 -> 客户端, 端口上校验通过的帧, 数据为帧数据负载
+ *   PORT_OPEN   网关 -> 客户端, 端口已打开, 数据为设备路径(客户端连接时也会收到所有端口的当前状态)
+ *   PORT_CLOSED 网关 -> 客户端, 端口已关闭(设备断开), 网关会周期性尝试重新打开
+ *   TX          客户端 -> 网关, 在port上发送一帧: d_addr/func_id取自记录头, 数据为帧数据负载
+ *   DROPPED     网关 -> 客户端, 之前因客户端接收过慢丢弃的记录数(数据为u64)
+ */
+
+#define YJ_GATEWAY_RECORD_HEADER_SIZE 16
+#define YJ_GATEWAY_MAX_MESSAGE_SIZE   65536  // 单个套接字消息的最大字节数
+#define YJ_GATEWAY_DEFAULT_SOCKET     "/tmp/yj_gateway.sock"
+
+/* 记录类型 */
+#define YJ_GATEWAY_REC_FRAME        0x01
+#define YJ_GATEWAY_REC_PORT_OPEN    0x02
+#define YJ_GATEWAY_REC_PORT_CLOSED  0x03
+#define YJ_GATEWAY_REC_TX           0x04
+#define YJ_GATEWAY_REC_DROPPED      0x05
+
+/* 记录标志 */
+#define YJ_GATEWAY_FLAG_CRC16       0x01  // 端口使用CRC-16校验模式
+
+#endif // YJ_GATEWAY_H
@@ -0,0 +1,1114 @@
+/**
+ * @file yj_native_module.c
+ * @brief YJ协议上位机原生加速模块(CPython扩展 _yj_native)
+ *
+ * 将protocol/yj_protocol.c中的C解析器暴露给Python, 一次调用处理整块接收数据,
+ * 替代FrameParser中逐字节peek/discard的Python循环; 同时导出varint批量编解码函数,
+ * 供单元测试与core/varint_codec.py逐字节比对;
+ * 并提供基于yj_ring.h的SPSC接收环形缓冲区类型ByteRing、
+ * 以及基于yj_capture.c的二进制录制文件写入器CaptureWriter和
+ * 基于yj_capture_index.c的索引生成/查询函数build_capture_index、query_capture_index(仅POSIX平台)。
+ *
+ * 手动编译(在仓库根目录):
+ *   cc -O2 -shared -fPIC $(python3-config --includes) -Iprotocol \
+ *      protocol/host/yj_native_module.c protocol/host/yj_batch_decode.c \
+ *      protocol/host/yj_capture.c protocol/host/yj_capture_index.c protocol/yj_protocol.c \
+ *      -o core/_yj_native$(python3-config --extension-suffix)
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+    #include <io.h>
+    #define yj_fd_read(fd, buf, n) _read((fd), (buf), (unsigned int)(n))
+#else
+    #include <unistd.h>
+    #define yj_fd_read(fd, buf, n) read((fd), (buf), (n))
+#endif
+#include "yj_protocol.h"
+#include "yj_ring.h"
+#include "yj_batch_decode.h"
+#ifndef _WIN32
+    #include "yj_capture.h"
+    #include "yj_capture_index.h"
+    #define YJ_NATIVE_HAVE_CAPTURE 1
+#endif
+
+/* ---- scan_frames ---- */
+
+PyDoc_STRVAR(scan_frames_doc,
+"scan_frames(data, checksum_mode=0, head=0xAB, max_payload=YJ_MAX_DATA_PAYLOAD_SIZE, max_frames=0)\n"
+"--\n\n"
+"扫描整块数据(bytes/bytearray/memoryview等支持缓冲区协议的对象), 返回 (frames, consumed)。\n"
+"frames 为 (offset, length, func_id, s_addr, d_addr, checksum_ok) 元组列表,\n"
+"consumed 为可从接收缓冲区丢弃的字节数(末尾不完整的帧不计入)。\n"
+"max_frames 为 0 表示不限制帧数。");
+
+static PyObject* yj_native_scan_frames(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"data", "checksum_mode", "head", "max_payload", "max_frames", NULL};
+    Py_buffer view;
+    int checksum_mode = YJ_CHECKSUM_MODE_ORIGINAL;
+    unsigned char head = YJ_FRAME_HEAD_BYTE;
+    unsigned short max_payload = YJ_MAX_DATA_PAYLOAD_SIZE;
+    Py_ssize_t max_frames = 0;
+    (void)self;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "y*|ibHn:scan_frames", kwlist,
+                                     &view, &checksum_mode, &head, &max_payload, &max_frames)) {
+        return NULL;
+    }
+    if (view.len > (Py_ssize_t)UINT32_MAX) {
+        PyBuffer_Release(&view);
+        PyErr_SetString(PyExc_OverflowError, "data too large for a single scan");
+        return NULL;
+    }
+
+    // 每帧至少YJ_FRAME_MIN_OVERHEAD字节, 据此确定结果数组上限
+    uint32_t capacity = (uint32_t)(view.len / YJ_FRAME_MIN_OVERHEAD) + 1;
+    if (max_frames > 0 && (size_t)max_frames < capacity) {
+        capacity = (uint32_t)max_frames;
+    }
+    yj_frame_span_t* spans = (yj_frame_span_t*)PyMem_RawMalloc(capacity * sizeof(yj_frame_span_t));
+    if (!spans) {
+        PyBuffer_Release(&view);
+        return PyErr_NoMemory();
+    }
+
+    uint32_t consumed = 0;
+    uint32_t count;
+    Py_BEGIN_ALLOW_THREADS
+    count = yj_protocol_scan_buffer((const uint8_t*)view.buf, (uint32_t)view.len,
+                                    (yj_checksum_mode_t)checksum_mode, head, max_payload,
+                                    spans, capacity, &consumed);
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&view);
+
+    PyObject* frames = PyList_New(count);
+    if (!frames) {
+        PyMem_RawFree(spans);
+        return NULL;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        const yj_frame_span_t* span = &spans[i];
+        PyObject* item = Py_BuildValue("(kHBBBO)", (unsigned long)span->offset, span->length,
+                                       span->func_id, span->s_addr, span->d_addr,
+                                       span->checksum_ok ? Py_True : Py_False);
+        if (!item) {
+            Py_DECREF(frames);
+            PyMem_RawFree(spans);
+            return NULL;
+        }
+        PyList_SET_ITEM(frames, i, item);
+    }
+    PyMem_RawFree(spans);
+
+    return Py_BuildValue("(Nk)", frames, (unsigned long)consumed);
+}
+
+/* ---- decode_columns ---- */
+
+#define YJ_NATIVE_MAX_FIELDS 64 // 单个布局允许的最大字段数
+
+PyDoc_STRVAR(decode_columns_doc,
+"decode_columns(data, layout, columns, func_id=-1, checksum_mode=0, head=0xAB, max_payload=YJ_MAX_DATA_PAYLOAD_SIZE)\n"
+"--\n\n"
+"将整块数据中功能ID匹配且校验通过的帧按布局解码到预分配的列数组中。\n"
+"layout 为 (offset, field_type) 元组序列, field_type 取 FIELD_* 常量;\n"
+"columns 为与 layout 等长的可写连续 float64 缓冲区序列(numpy数组或array('d')),\n"
+"行数上限取各列长度的最小值。解码期间释放GIL。\n"
+"返回 (rows, consumed, checksum_errors, skipped_frames)。");
+
+static PyObject* yj_native_decode_columns(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"data", "layout", "columns", "func_id", "checksum_mode", "head", "max_payload", NULL};
+    Py_buffer view;
+    PyObject* layout_obj;
+    PyObject* columns_obj;
+    int func_id = -1;
+    int checksum_mode = YJ_CHECKSUM_MODE_ORIGINAL;
+    unsigned char head = YJ_FRAME_HEAD_BYTE;
+    unsigned short max_payload = YJ_MAX_DATA_PAYLOAD_SIZE;
+    yj_field_desc_t fields[YJ_NATIVE_MAX_FIELDS];
+    Py_buffer column_views[YJ_NATIVE_MAX_FIELDS];
+    double* column_ptrs[YJ_NATIVE_MAX_FIELDS];
+    Py_ssize_t field_count = 0;
+    Py_ssize_t acquired = 0;
+    Py_ssize_t capacity = PY_SSIZE_T_MAX;
+    PyObject* result = NULL;
+    (void)self;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "y*OO|iibH:decode_columns", kwlist,
+                                     &view, &layout_obj, &columns_obj,
+                                     &func_id, &checksum_mode, &head, &max_payload)) {
+        return NULL;
+    }
+
+    PyObject* layout_seq = PySequence_Fast(layout_obj, "layout must be a sequence");
+    PyObject* columns_seq = layout_seq ? PySequence_Fast(columns_obj, "columns must be a sequence") : NULL;
+    if (!columns_seq) {
+        goto done;
+    }
+    field_count = PySequence_Fast_GET_SIZE(layout_seq);
+    if (field_count != PySequence_Fast_GET_SIZE(columns_seq)) {
+        PyErr_SetString(PyExc_ValueError, "layout and columns must have the same length");
+        goto done;
+    }
+    if (field_count > YJ_NATIVE_MAX_FIELDS) {
+        PyErr_SetString(PyExc_ValueError, "too many fields in layout");
+        goto done;
+    }
+    if (func_id < -1 || func_id > 0xFF) {
+        PyErr_SetString(PyExc_ValueError, "func_id must be -1 or 0..255");
+        goto done;
+    }
+    if (view.len > (Py_ssize_t)UINT32_MAX) {
+        PyErr_SetString(PyExc_OverflowError, "data too large for a single decode");
+        goto done;
+    }
+
+    for (Py_ssize_t i = 0; i < field_count; ++i) {
+        unsigned int offset;
+        int type;
+        if (!PyArg_ParseTuple(PySequence_Fast_GET_ITEM(layout_seq, i), "Ii;layout items must be (offset, field_type)",
+                              &offset, &type)) {
+            goto done;
+        }
+        if (yj_field_type_size((yj_field_type_t)type) == 0 || type < 0) {
+            PyErr_Format(PyExc_ValueError, "unknown field type %d", type);
+            goto done;
+        }
+        if (offset + yj_field_type_size((yj_field_type_t)type) > 0xFFFF) {
+            PyErr_SetString(PyExc_ValueError, "field offset out of range");
+            goto done;
+        }
+        fields[i].offset = (uint16_t)offset;
+        fields[i].type = (yj_field_type_t)type;
+
+        if (PyObject_GetBuffer(PySequence_Fast_GET_ITEM(columns_seq, i), &column_views[i],
+                               PyBUF_WRITABLE | PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) < 0) {
+            goto done;
+        }
+        acquired++;
+        if (column_views[i].itemsize != (Py_ssize_t)sizeof(double) ||
+            !column_views[i].format || strcmp(column_views[i].format, "d") != 0) {
+            PyErr_SetString(PyExc_TypeError, "columns must be float64 buffers");
+            goto done;
+        }
+        column_ptrs[i] = (double*)column_views[i].buf;
+        Py_ssize_t rows = column_views[i].len / (Py_ssize_t)sizeof(double);
+        if (rows < capacity) capacity = rows;
+    }
+    if (field_count == 0) {
+        capacity = view.len / YJ_FRAME_MIN_OVERHEAD + 1; // 无字段时仅统计帧数
+    }
+    if (capacity > (Py_ssize_t)UINT32_MAX) {
+        capacity = UINT32_MAX;
+    }
+
+    {
+        yj_column_layout_t layout = {fields, (uint16_t)field_count, (int16_t)func_id};
+        yj_batch_decode_stats_t stats;
+        uint32_t rows;
+        Py_BEGIN_ALLOW_THREADS
+        rows = yj_batch_decode_columns((const uint8_t*)view.buf, (uint32_t)view.len,
+                                       (yj_checksum_mode_t)checksum_mode, head, max_payload,
+                                       &layout, column_ptrs, (uint32_t)capacity, &stats);
+        Py_END_ALLOW_THREADS
+        result = Py_BuildValue("(kkkk)", (unsigned long)rows, (unsigned long)stats.consumed,
+                               (unsigned long)stats.checksum_errors, (unsigned long)stats.skipped_frames);
+    }
+
+done:
+    for (Py_ssize_t i = 0; i < acquired; ++i) {
+        PyBuffer_Release(&column_views[i]);
+    }
+    Py_XDECREF(columns_seq);
+    Py_XDECREF(layout_seq);
+    PyBuffer_Release(&view);
+    return result;
+}
+
+/* ---- varint ---- */
+
+#define YJ_NATIVE_VARINT_U32    0   // 无符号计数值(yj_pack_varint_u32_array)
+#define YJ_NATIVE_VARINT_ZIGZAG 1   // 每个元素独立ZigZag(yj_pack_varint_i32_array)
+#define YJ_NATIVE_VARINT_DELTA  2   // 差分序列(yj_pack_varint_delta_array)
+
+PyDoc_STRVAR(pack_varint_array_doc,
+"pack_varint_array(values, kind=VARINT_U32)\n"
+"--\n\n"
+"用 yj_protocol.c 中的批量函数编码整数序列, 返回 bytes。\n"
+"kind 取 VARINT_U32 / VARINT_ZIGZAG / VARINT_DELTA; 元素数与编码结果均不得超过65535。");
+
+static PyObject* yj_native_pack_varint_array(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"values", "kind", NULL};
+    PyObject* values_obj;
+    int kind = YJ_NATIVE_VARINT_U32;
+    (void)self;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|i:pack_varint_array", kwlist, &values_obj, &kind)) {
+        return NULL;
+    }
+    if (kind < YJ_NATIVE_VARINT_U32 || kind > YJ_NATIVE_VARINT_DELTA) {
+        PyErr_Format(PyExc_ValueError, "unknown varint kind %d", kind);
+        return NULL;
+    }
+    PyObject* seq = PySequence_Fast(values_obj, "values must be a sequence");
+    if (!seq) {
+        return NULL;
+    }
+    Py_ssize_t count = PySequence_Fast_GET_SIZE(seq);
+    if (count > 0xFFFF) {
+        Py_DECREF(seq);
+        PyErr_SetString(PyExc_OverflowError, "too many values");
+        return NULL;
+    }
+
+    // 无符号与有符号数组按相同的32位存储, 只在调用时区分类型
+    uint32_t* values = (uint32_t*)PyMem_Malloc((size_t)(count ? count : 1) * sizeof(uint32_t));
+    size_t capacity = (size_t)count * YJ_VARINT32_MAX_BYTES;
+    uint16_t buffer_size = (uint16_t)(capacity > 0xFFFF ? 0xFFFF : capacity);
+    uint8_t* buffer = (uint8_t*)PyMem_Malloc(buffer_size ? buffer_size : 1);
+    PyObject* result = NULL;
+    if (!values || !buffer) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    for (Py_ssize_t i = 0; i < count; ++i) {
+        PyObject* item = PySequence_Fast_GET_ITEM(seq, i);
+        if (kind == YJ_NATIVE_VARINT_U32) {
+            unsigned long long v = PyLong_AsUnsignedLongLong(item);
+            if (v == (unsigned long long)-1 && PyErr_Occurred()) goto done;
+            if (v > UINT32_MAX) {
+                PyErr_SetString(PyExc_OverflowError, "value out of uint32 range");
+                goto done;
+            }
+            values[i] = (uint32_t)v;
+        } else {
+            long long v = PyLong_AsLongLong(item);
+            if (v == -1 && PyErr_Occurred()) goto done;
+            if (v < INT32_MIN || v > INT32_MAX) {
+                PyErr_SetString(PyExc_OverflowError, "value out of int32 range");
+                goto done;
+            }
+            values[i] = (uint32_t)(int32_t)v;
+        }
+    }
+
+    uint16_t written;
+    if (kind == YJ_NATIVE_VARINT_U32) {
+        written = yj_pack_varint_u32_array(buffer, buffer_size, values, (uint16_t)count);
+    } else if (kind == YJ_NATIVE_VARINT_ZIGZAG) {
+        written = yj_pack_varint_i32_array(buffer, buffer_size, (const int32_t*)values, (uint16_t)count);
+    } else {
+        written = yj_pack_varint_delta_array(buffer, buffer_size, (const int32_t*)values, (uint16_t)count);
+    }
+    if (written == 0 && count > 0) {
+        PyErr_SetString(PyExc_OverflowError, "encoded data exceeds 65535 bytes");
+        goto done;
+    }
+    result = PyBytes_FromStringAndSize((const char*)buffer, written);
+
+done:
+    PyMem_Free(buffer);
+    PyMem_Free(values);
+    Py_DECREF(seq);
+    return result;
+}
+
+PyDoc_STRVAR(unpack_varint_array_doc,
+"unpack_varint_array(data, count, kind=VARINT_U32)\n"
+"--\n\n"
+"用 yj_protocol.c 中的批量函数从 data 开头解码 count 个元素, 返回 (values, consumed)。\n"
+"数据不完整或编码超长时抛出 ValueError; data 长度不得超过65535字节。");
+
+static PyObject* yj_native_unpack_varint_array(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"data", "count", "kind", NULL};
+    Py_buffer view;
+    Py_ssize_t count;
+    int kind = YJ_NATIVE_VARINT_U32;
+    (void)self;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "y*n|i:unpack_varint_array", kwlist, &view, &count, &kind)) {
+        return NULL;
+    }
+    PyObject* result = NULL;
+    uint32_t* values = NULL;
+    if (kind < YJ_NATIVE_VARINT_U32 || kind > YJ_NATIVE_VARINT_DELTA) {
+        PyErr_Format(PyExc_ValueError, "unknown varint kind %d", kind);
+        goto done;
+    }
+    if (count < 0 || count > 0xFFFF || view.len > 0xFFFF) {
+        PyErr_SetString(PyExc_OverflowError, "count and data length must not exceed 65535");
+        goto done;
+    }
+    values = (uint32_t*)PyMem_Malloc((size_t)(count ? count : 1) * sizeof(uint32_t));
+    if (!values) {
+        PyErr_NoMemory();
+        goto done;
+    }
+
+    const uint8_t* data = (const uint8_t*)view.buf;
+    uint16_t consumed;
+    if (kind == YJ_NATIVE_VARINT_U32) {
+        consumed = yj_unpack_varint_u32_array(data, (uint16_t)view.len, values, (uint16_t)count);
+    } else if (kind == YJ_NATIVE_VARINT_ZIGZAG) {
+        consumed = yj_unpack_varint_i32_array(data, (uint16_t)view.len, (int32_t*)values, (uint16_t)count);
+    } else {
+        consumed = yj_unpack_varint_delta_array(data, (uint16_t)view.len, (int32_t*)values, (uint16_t)count);
+    }
+    if (consumed == 0 && count > 0) {
+        PyErr_SetString(PyExc_ValueError, "varint data truncated or overlong");
+        goto done;
+    }
+
+    PyObject* list = PyList_New(count);
+    if (!list) {
+        goto done;
+    }
+    for (Py_ssize_t i = 0; i < count; ++i) {
+        PyObject* item = (kind == YJ_NATIVE_VARINT_U32)
+            ? PyLong_FromUnsignedLong(values[i])
+            : PyLong_FromLong((int32_t)values[i]);
+        if (!item) {
+            Py_DECREF(list);
+            goto done;
+        }
+        PyList_SET_ITEM(list, i, item);
+    }
+    result = Py_BuildValue("(NH)", list, consumed);
+
+done:
+    PyMem_Free(values);
+    PyBuffer_Release(&view);
+    return result;
+}
+
+/* ---- ByteRing ---- */
+
+#define YJ_NATIVE_RING_MIN_SIZE 64u
+#define YJ_NATIVE_RING_MAX_SIZE (1u << 30)
+
+typedef struct {
+    PyObject_HEAD
+    yj_ring_t ring;
+    uint8_t* storage;           // 镜像存储区, 2 * ring.size字节
+    Py_ssize_t exports;         // 导出的缓冲区个数
+    uint64_t bytes_written;     // 累计写入字节数
+    uint64_t overflow_bytes;    // 因空间不足被丢弃的字节数
+} ByteRingObject;
+
+PyDoc_STRVAR(byte_ring_doc,
+"ByteRing(capacity)\n"
+"--\n\n"
+"单生产者/单消费者无锁字节环形缓冲区(yj_ring.h, 镜像存储)。\n"
+"capacity 向上取整为2的幂。生产者线程调用 write/write_from_fd, 消费者线程调用\n"
+"peek/read/discard/clear, 双方无需加锁; 同一端不得被多个线程同时调用。\n"
+"空间不足时不覆盖未读数据, 多出的字节计入 overflow_bytes。");
+
+static int byte_ring_init(ByteRingObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"capacity", NULL};
+    Py_ssize_t capacity;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "n:ByteRing", kwlist, &capacity)) {
+        return -1;
+    }
+    if (capacity <= 0 || (size_t)capacity > YJ_NATIVE_RING_MAX_SIZE) {
+        PyErr_SetString(PyExc_ValueError, "capacity must be in 1..2**30");
+        return -1;
+    }
+    if (self->exports > 0) {
+        PyErr_SetString(PyExc_BufferError, "ByteRing has exported buffers");
+        return -1;
+    }
+    uint32_t size = YJ_NATIVE_RING_MIN_SIZE;
+    while (size < (uint32_t)capacity) {
+        size <<= 1;
+    }
+    uint8_t* storage = (uint8_t*)PyMem_RawMalloc((size_t)size * 2);
+    if (!storage) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    PyMem_RawFree(self->storage);
+    self->storage = storage;
+    self->bytes_written = 0;
+    self->overflow_bytes = 0;
+    yj_ring_init(&self->ring, storage, size, YJ_RING_FLAG_MIRROR);
+    return 0;
+}
+
+static void byte_ring_dealloc(ByteRingObject* self) {
+    PyMem_RawFree(self->storage);
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static int byte_ring_check(ByteRingObject* self) {
+    if (!self->storage) {
+        PyErr_SetString(PyExc_ValueError, "ByteRing is not initialized");
+        return -1;
+    }
+    return 0;
+}
+
+PyDoc_STRVAR(byte_ring_write_doc,
+"write(data) -> int\n\n"
+"写入数据(生产者), 返回实际写入字节数。");
+
+static PyObject* byte_ring_write(ByteRingObject* self, PyObject* arg) {
+    Py_buffer view;
+    if (byte_ring_check(self) < 0 || PyObject_GetBuffer(arg, &view, PyBUF_SIMPLE) < 0) {
+        return NULL;
+    }
+    uint32_t len = (view.len > (Py_ssize_t)UINT32_MAX) ? UINT32_MAX : (uint32_t)view.len;
+    uint32_t written = yj_ring_write(&self->ring, (const uint8_t*)view.buf, len);
+    self->bytes_written += written;
+    self->overflow_bytes += (uint64_t)view.len - written;
+    PyBuffer_Release(&view);
+    return PyLong_FromUnsignedLong(written);
+}
+
+PyDoc_STRVAR(byte_ring_write_from_fd_doc,
+"write_from_fd(fd, max_bytes=0) -> int\n\n"
+"从文件描述符直接读入环形缓冲区(生产者), 读取期间释放GIL, 不创建bytes对象。\n"
+"max_bytes 为 0 表示读满剩余空间。返回读取的字节数; 非阻塞fd暂无数据(EAGAIN/EINTR)\n"
+"或缓冲区已满时返回0, 其他错误抛出 OSError。");
+
+static PyObject* byte_ring_write_from_fd(ByteRingObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"fd", "max_bytes", NULL};
+    int fd;
+    Py_ssize_t max_bytes = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "i|n:write_from_fd", kwlist, &fd, &max_bytes)) {
+        return NULL;
+    }
+    if (byte_ring_check(self) < 0) {
+        return NULL;
+    }
+
+    uint8_t* dst;
+    uint32_t span = yj_ring_write_span(&self->ring, &dst);
+    if (max_bytes > 0 && (size_t)max_bytes < span) {
+        span = (uint32_t)max_bytes;
+    }
+    if (span == 0) {
+        return PyLong_FromLong(0);
+    }
+
+    Py_ssize_t n;
+    int saved_errno = 0;
+    Py_BEGIN_ALLOW_THREADS
+    n = (Py_ssize_t)yj_fd_read(fd, dst, span);
+    if (n > 0) {
+        yj_ring_commit(&self->ring, (uint32_t)n);
+    } else if (n < 0) {
+        saved_errno = errno;
+    }
+    Py_END_ALLOW_THREADS
+
+    if (n < 0) {
+        if (saved_errno == EAGAIN || saved_errno == EWOULDBLOCK || saved_errno == EINTR) {
+            return PyLong_FromLong(0);
+        }
+        errno = saved_errno;
+        return PyErr_SetFromErrno(PyExc_OSError);
+    }
+    self->bytes_written += (uint64_t)n;
+    return PyLong_FromSsize_t(n);
+}
+
+PyDoc_STRVAR(byte_ring_peek_doc,
+"peek(length=-1) -> memoryview\n\n"
+"返回可读数据的只读memoryview(消费者), 不拷贝也不移动读位置。\n"
+"视图在 discard 之前保持有效; length 为负表示全部可读数据。");
+
+static PyObject* byte_ring_peek(ByteRingObject* self, PyObject* args) {
+    Py_ssize_t length = -1;
+    if (!PyArg_ParseTuple(args, "|n:peek", &length) || byte_ring_check(self) < 0) {
+        return NULL;
+    }
+    const uint8_t* src;
+    uint32_t count = yj_ring_read_span(&self->ring, &src);
+    if (length >= 0 && (size_t)length < count) {
+        count = (uint32_t)length;
+    }
+    Py_ssize_t start = src - self->storage;
+
+    PyObject* whole = PyMemoryView_FromObject((PyObject*)self);
+    if (!whole) {
+        return NULL;
+    }
+    PyObject* bounds_start = PyLong_FromSsize_t(start);
+    PyObject* bounds_stop = PyLong_FromSsize_t(start + count);
+    PyObject* slice = (bounds_start && bounds_stop) ? PySlice_New(bounds_start, bounds_stop, NULL) : NULL;
+    PyObject* result = slice ? PyObject_GetItem(whole, slice) : NULL;
+    Py_XDECREF(slice);
+    Py_XDECREF(bounds_start);
+    Py_XDECREF(bounds_stop);
+    Py_DECREF(whole);
+    return result;
+}
+
+PyDoc_STRVAR(byte_ring_read_doc,
+"read(length=-1) -> bytes\n\n"
+"拷贝并移除数据(消费者)。");
+
+static PyObject* byte_ring_read(ByteRingObject* self, PyObject* args) {
+    Py_ssize_t length = -1;
+    if (!PyArg_ParseTuple(args, "|n:read", &length) || byte_ring_check(self) < 0) {
+        return NULL;
+    }
+    const uint8_t* src;
+    uint32_t count = yj_ring_read_span(&self->ring, &src);
+    if (length >= 0 && (size_t)length < count) {
+        count = (uint32_t)length;
+    }
+    PyObject* result = PyBytes_FromStringAndSize((const char*)src, count);
+    if (result) {
+        yj_ring_discard(&self->ring, count);
+    }
+    return result;
+}
+
+PyDoc_STRVAR(byte_ring_discard_doc,
+"discard(length) -> int\n\n"
+"丢弃最多 length 个字节(消费者), 返回实际丢弃字节数。");
+
+static PyObject* byte_ring_discard(ByteRingObject* self, PyObject* arg) {
+    Py_ssize_t length = PyLong_AsSsize_t(arg);
+    if ((length == -1 && PyErr_Occurred()) || byte_ring_check(self) < 0) {
+        return NULL;
+    }
+    if (length <= 0) {
+        return PyLong_FromLong(0);
+    }
+    uint32_t n = yj_ring_discard(&self->ring, (size_t)length > UINT32_MAX ? UINT32_MAX : (uint32_t)length);
+    return PyLong_FromUnsignedLong(n);
+}
+
+PyDoc_STRVAR(byte_ring_clear_doc,
+"clear()\n\n"
+"清空缓冲区(消费者)。");
+
+static PyObject* byte_ring_clear(ByteRingObject* self, PyObject* Py_UNUSED(ignored)) {
+    if (byte_ring_check(self) < 0) {
+        return NULL;
+    }
+    yj_ring_clear(&self->ring);
+    Py_RETURN_NONE;
+}
+
+static Py_ssize_t byte_ring_len(ByteRingObject* self) {
+    return self->storage ? (Py_ssize_t)yj_ring_count(&self->ring) : 0;
+}
+
+static PyObject* byte_ring_get_capacity(ByteRingObject* self, void* closure) {
+    (void)closure;
+    return PyLong_FromUnsignedLong(self->storage ? self->ring.size : 0);
+}
+
+static PyObject* byte_ring_get_space(ByteRingObject* self, void* closure) {
+    (void)closure;
+    return PyLong_FromUnsignedLong(self->storage ? yj_ring_space(&self->ring) : 0);
+}
+
+static PyObject* byte_ring_get_bytes_written(ByteRingObject* self, void* closure) {
+    (void)closure;
+    return PyLong_FromUnsignedLongLong(self->bytes_written);
+}
+
+static PyObject* byte_ring_get_overflow_bytes(ByteRingObject* self, void* closure) {
+    (void)closure;
+    return PyLong_FromUnsignedLongLong(self->overflow_bytes);
+}
+
+/* 缓冲区协议: 只读导出整个镜像存储区, 供peek切片 */
+static int byte_ring_getbuffer(ByteRingObject* self, Py_buffer* view, int flags) {
+    if (byte_ring_check(self) < 0) {
+        view->obj = NULL;
+        return -1;
+    }
+    if (PyBuffer_FillInfo(view, (PyObject*)self, self->storage, (Py_ssize_t)self->ring.size * 2, 1, flags) < 0) {
+        return -1;
+    }
+    self->exports++;
+    return 0;
+}
+
+static void byte_ring_releasebuffer(ByteRingObject* self, Py_buffer* view) {
+    (void)view;
+    self->exports--;
+}
+
+static PyMethodDef byte_ring_methods[] = {
+    {"write", (PyCFunction)byte_ring_write, METH_O, byte_ring_write_doc},
+    {"write_from_fd", (PyCFunction)(void (*)(void))byte_ring_write_from_fd,
+     METH_VARARGS | METH_KEYWORDS, byte_ring_write_from_fd_doc},
+    {"peek", (PyCFunction)byte_ring_peek, METH_VARARGS, byte_ring_peek_doc},
+    {"read", (PyCFunction)byte_ring_read, METH_VARARGS, byte_ring_read_doc},
+    {"discard", (PyCFunction)byte_ring_discard, METH_O, byte_ring_discard_doc},
+    {"clear", (PyCFunction)byte_ring_clear, METH_NOARGS, byte_ring_clear_doc},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyGetSetDef byte_ring_getset[] = {
+    {"capacity", (getter)byte_ring_get_capacity, NULL, "容量(字节)", NULL},
+    {"space", (getter)byte_ring_get_space, NULL, "剩余可写字节数", NULL},
+    {"bytes_written", (getter)byte_ring_get_bytes_written, NULL, "累计写入字节数", NULL},
+    {"overflow_bytes", (getter)byte_ring_get_overflow_bytes, NULL, "因空间不足被丢弃的字节数", NULL},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
+static PySequenceMethods byte_ring_as_sequence = {
+    .sq_length = (lenfunc)byte_ring_len,
+};
+
+static PyBufferProcs byte_ring_as_buffer = {
+    .bf_getbuffer = (getbufferproc)byte_ring_getbuffer,
+    .bf_releasebuffer = (releasebufferproc)byte_ring_releasebuffer,
+};
+
+static PyTypeObject ByteRingType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "_yj_native.ByteRing",
+    .tp_basicsize = sizeof(ByteRingObject),
+    .tp_dealloc = (destructor)byte_ring_dealloc,
+    .tp_as_sequence = &byte_ring_as_sequence,
+    .tp_as_buffer = &byte_ring_as_buffer,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = byte_ring_doc,
+    .tp_methods = byte_ring_methods,
+    .tp_getset = byte_ring_getset,
+    .tp_init = (initproc)byte_ring_init,
+    .tp_new = PyType_GenericNew,
+};
+
+/* ---- CaptureWriter ---- */
+
+#ifdef YJ_NATIVE_HAVE_CAPTURE
+
+typedef struct {
+    PyObject_HEAD
+    yj_capture_writer_t writer;
+    int is_open;
+} CaptureWriterObject;
+
+PyDoc_STRVAR(capture_writer_doc,
+"CaptureWriter(path, buffer_size=0, index_interval=0, direct=False)\n"
+"--\n\n"
+"二进制录制文件(.yjcap)写入器, 格式见 protocol/host/yj_capture.h。\n"
+"记录先写入内存缓冲区, 缓冲区满时批量写盘(写盘期间释放GIL);\n"
+"direct=True 时使用 O_DIRECT 绕过页缓存, 文件系统不支持时自动退回缓冲写。");
+
+static int capture_writer_init(CaptureWriterObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"path", "buffer_size", "index_interval", "direct", NULL};
+    PyObject* path_bytes = NULL;
+    Py_ssize_t buffer_size = 0;
+    unsigned int index_interval = 0;
+    int direct = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&|nIp:CaptureWriter", kwlist,
+                                     PyUnicode_FSConverter, &path_bytes,
+                                     &buffer_size, &index_interval, &direct)) {
+        return -1;
+    }
+    if (self->is_open) {
+        yj_capture_writer_close(&self->writer);
+        self->is_open = 0;
+    }
+    int32_t ret;
+    Py_BEGIN_ALLOW_THREADS
+    ret = yj_capture_writer_open(&self->writer, PyBytes_AS_STRING(path_bytes),
+                                 buffer_size > 0 ? (size_t)buffer_size : 0, index_interval,
+                                 direct ? YJ_CAPTURE_WRITER_DIRECT : 0);
+    Py_END_ALLOW_THREADS
+    if (ret < 0) {
+        PyErr_SetFromErrnoWithFilenameObject(PyExc_OSError, path_bytes);
+        Py_DECREF(path_bytes);
+        return -1;
+    }
+    Py_DECREF(path_bytes);
+    self->is_open = 1;
+    return 0;
+}
+
+static void capture_writer_dealloc(CaptureWriterObject* self) {
+    if (self->is_open) {
+        yj_capture_writer_close(&self->writer);
+    }
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static int capture_writer_check(CaptureWriterObject* self) {
+    if (!self->is_open) {
+        PyErr_SetString(PyExc_ValueError, "I/O operation on closed capture");
+        return -1;
+    }
+    return 0;
+}
+
+PyDoc_STRVAR(capture_writer_append_doc,
+"append(ts_ns, direction, status, func_id, data)\n\n"
+"追加一条记录。ts_ns 为Unix纪元纳秒(time.time_ns()), direction/status 取\n"
+"DIR_*/STATUS_* 常量, data 最长65535字节。");
+
+static PyObject* capture_writer_append(CaptureWriterObject* self, PyObject* args) {
+    unsigned long long ts_ns;
+    unsigned char direction, status, func_id;
+    Py_buffer view;
+    if (!PyArg_ParseTuple(args, "Kbbby*:append", &ts_ns, &direction, &status, &func_id, &view)) {
+        return NULL;
+    }
+    if (capture_writer_check(self) < 0) {
+        PyBuffer_Release(&view);
+        return NULL;
+    }
+    if (view.len > 0xFFFF || direction == YJ_CAPTURE_DIR_INDEX) {
+        PyBuffer_Release(&view);
+        PyErr_SetString(PyExc_ValueError, view.len > 0xFFFF ? "record longer than 65535 bytes"
+                                                           : "invalid direction");
+        return NULL;
+    }
+
+    int32_t ret;
+    // 只有缓冲区写满时才会发生写盘, 此时释放GIL
+    if (self->writer.buf_used + YJ_CAPTURE_RECORD_HEADER_SIZE + (size_t)view.len + YJ_CAPTURE_ALIGN
+            > self->writer.buf_size) {
+        Py_BEGIN_ALLOW_THREADS
+        ret = yj_capture_writer_append(&self->writer, ts_ns, direction, status, func_id,
+                                       (const uint8_t*)view.buf, (uint16_t)view.len);
+        Py_END_ALLOW_THREADS
+    } else {
+        ret = yj_capture_writer_append(&self->writer, ts_ns, direction, status, func_id,
+                                       (const uint8_t*)view.buf, (uint16_t)view.len);
+    }
+    PyBuffer_Release(&view);
+    if (ret < 0) {
+        return PyErr_SetFromErrno(PyExc_OSError);
+    }
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(capture_writer_flush_doc,
+"flush()\n\n"
+"将缓冲区写入磁盘(O_DIRECT模式下只写出完整的对齐块)。");
+
+static PyObject* capture_writer_flush(CaptureWriterObject* self, PyObject* Py_UNUSED(ignored)) {
+    if (capture_writer_check(self) < 0) {
+        return NULL;
+    }
+    int32_t ret;
+    Py_BEGIN_ALLOW_THREADS
+    ret = yj_capture_writer_flush(&self->writer);
+    Py_END_ALLOW_THREADS
+    if (ret < 0) {
+        return PyErr_SetFromErrno(PyExc_OSError);
+    }
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(capture_writer_close_doc,
+"close()\n\n"
+"写入最后的索引块, 回写文件头并关闭文件。重复调用无效果。");
+
+static PyObject* capture_writer_close(CaptureWriterObject* self, PyObject* Py_UNUSED(ignored)) {
+    if (!self->is_open) {
+        Py_RETURN_NONE;
+    }
+    int32_t ret;
+    Py_BEGIN_ALLOW_THREADS
+    ret = yj_capture_writer_close(&self->writer);
+    Py_END_ALLOW_THREADS
+    self->is_open = 0;
+    if (ret < 0) {
+        return PyErr_SetFromErrno(PyExc_OSError);
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject* capture_writer_enter(CaptureWriterObject* self, PyObject* Py_UNUSED(ignored)) {
+    if (capture_writer_check(self) < 0) {
+        return NULL;
+    }
+    Py_INCREF(self);
+    return (PyObject*)self;
+}
+
+static PyObject* capture_writer_exit(CaptureWriterObject* self, PyObject* args) {
+    (void)args;
+    return capture_writer_close(self, NULL);
+}
+
+static PyObject* capture_writer_get_record_count(CaptureWriterObject* self, void* closure) {
+    (void)closure;
+    return PyLong_FromUnsignedLongLong(self->writer.record_count);
+}
+
+static PyObject* capture_writer_get_bytes_written(CaptureWriterObject* self, void* closure) {
+    (void)closure;
+    return PyLong_FromUnsignedLongLong(self->writer.file_offset + self->writer.buf_used);
+}
+
+static PyObject* capture_writer_get_closed(CaptureWriterObject* self, void* closure) {
+    (void)closure;
+    return PyBool_FromLong(!self->is_open);
+}
+
+static PyMethodDef capture_writer_methods[] = {
+    {"append", (PyCFunction)capture_writer_append, METH_VARARGS, capture_writer_append_doc},
+    {"flush", (PyCFunction)capture_writer_flush, METH_NOARGS, capture_writer_flush_doc},
+    {"close", (PyCFunction)capture_writer_close, METH_NOARGS, capture_writer_close_doc},
+    {"__enter__", (PyCFunction)capture_writer_enter, METH_NOARGS, NULL},
+    {"__exit__", (PyCFunction)capture_writer_exit, METH_VARARGS, NULL},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyGetSetDef capture_writer_getset[] = {
+    {"record_count", (getter)capture_writer_get_record_count, NULL, "已写入的记录数", NULL},
+    {"bytes_written", (getter)capture_writer_get_bytes_written, NULL, "文件逻辑长度(含未写盘的缓冲区)", NULL},
+    {"closed", (getter)capture_writer_get_closed, NULL, "是否已关闭", NULL},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
+static PyTypeObject CaptureWriterType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "_yj_native.CaptureWriter",
+    .tp_basicsize = sizeof(CaptureWriterObject),
+    .tp_dealloc = (destructor)capture_writer_dealloc,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = capture_writer_doc,
+    .tp_methods = capture_writer_methods,
+    .tp_getset = capture_writer_getset,
+    .tp_init = (initproc)capture_writer_init,
+    .tp_new = PyType_GenericNew,
+};
+
+/* ---- build_capture_index ---- */
+
+PyDoc_STRVAR(build_capture_index_doc,
+"build_capture_index(capture_path, index_path, time_stride=0)\n"
+"--\n\n"
+"扫描录制文件生成索引文件(.yjidx), 格式见 protocol/host/yj_capture_index.h。\n"
+"扫描期间释放GIL; time_stride为0时使用默认值。");
+
+static PyObject* yj_native_build_capture_index(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"capture_path", "index_path", "time_stride", NULL};
+    PyObject* capture_path = NULL;
+    PyObject* index_path = NULL;
+    unsigned int time_stride = 0;
+    (void)self;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&|I:build_capture_index", kwlist,
+                                     PyUnicode_FSConverter, &capture_path,
+                                     PyUnicode_FSConverter, &index_path, &time_stride)) {
+        Py_XDECREF(capture_path);
+        return NULL;
+    }
+    int32_t ret;
+    Py_BEGIN_ALLOW_THREADS
+    ret = yj_capture_index_build(PyBytes_AS_STRING(capture_path), PyBytes_AS_STRING(index_path), time_stride);
+    Py_END_ALLOW_THREADS
+    if (ret == YJ_CAPTURE_INDEX_ERR_FORMAT) {
+        PyErr_SetString(PyExc_ValueError, "不是有效的YJ录制文件");
+    } else if (ret < 0) {
+        PyErr_SetFromErrno(PyExc_OSError);
+    }
+    Py_DECREF(capture_path);
+    Py_DECREF(index_path);
+    if (ret < 0) {
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+/* ---- seek_capture_time ---- */
+
+PyDoc_STRVAR(seek_capture_time_doc,
+"seek_capture_time(capture_path, ts_ns)\n"
+"--\n\n"
+"用 yj_capture_reader_seek_time 沿录制文件的索引块定位, 返回不晚于第一条\n"
+"ts_ns >= 给定时间的记录的偏移, 供测试与脚本核对C定位结果。");
+
+static PyObject* yj_native_seek_capture_time(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"capture_path", "ts_ns", NULL};
+    PyObject* capture_path = NULL;
+    unsigned long long ts_ns;
+    yj_capture_reader_t reader;
+    (void)self;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&K:seek_capture_time", kwlist,
+                                     PyUnicode_FSConverter, &capture_path, &ts_ns)) {
+        return NULL;
+    }
+
+    int32_t ret = yj_capture_reader_open(&reader, PyBytes_AS_STRING(capture_path));
+    Py_DECREF(capture_path);
+    if (ret == -2) {
+        PyErr_SetString(PyExc_ValueError, "不是有效的YJ录制文件");
+        return NULL;
+    } else if (ret < 0) {
+        return PyErr_SetFromErrno(PyExc_OSError);
+    }
+    uint64_t offset = yj_capture_reader_seek_time(&reader, ts_ns);
+    yj_capture_reader_close(&reader);
+    return PyLong_FromUnsignedLongLong(offset);
+}
+
+/* ---- query_capture_index ---- */
+
+PyDoc_STRVAR(query_capture_index_doc,
+"query_capture_index(capture_path, index_path, func_id, t0_ns, t1_ns)\n"
+"--\n\n"
+"用 yj_capture_index_open/_seek_time/_postings/_query 查询索引文件, 返回\n"
+"(seek_offset, postings, hits): seek_offset 为 t0_ns 对应的时间索引定位偏移,\n"
+"postings 为该功能ID全部帧的记录偏移, hits 为 [t0_ns, t1_ns) 内命中帧的记录偏移。\n"
+"每次调用重新映射文件, 供测试与脚本核对C查询结果。");
+
+static PyObject* offsets_to_list(const uint64_t* offsets, uint64_t count) {
+    PyObject* list = PyList_New((Py_ssize_t)count);
+    if (!list) {
+        return NULL;
+    }
+    for (uint64_t i = 0; i < count; ++i) {
+        PyObject* item = PyLong_FromUnsignedLongLong(offsets[i]);
+        if (!item) {
+            Py_DECREF(list);
+            return NULL;
+        }
+        PyList_SET_ITEM(list, (Py_ssize_t)i, item);
+    }
+    return list;
+}
+
+static PyObject* yj_native_query_capture_index(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static char* kwlist[] = {"capture_path", "index_path", "func_id", "t0_ns", "t1_ns", NULL};
+    PyObject* capture_path = NULL;
+    PyObject* index_path = NULL;
+    unsigned char func_id;
+    unsigned long long t0_ns;
+    unsigned long long t1_ns;
+    yj_capture_reader_t reader;
+    yj_capture_index_t index;
+    (void)self;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&bKK:query_capture_index", kwlist,
+                                     PyUnicode_FSConverter, &capture_path,
+                                     PyUnicode_FSConverter, &index_path, &func_id, &t0_ns, &t1_ns)) {
+        Py_XDECREF(capture_path);
+        return NULL;
+    }
+
+    int32_t ret = yj_capture_reader_open(&reader, PyBytes_AS_STRING(capture_path));
+    if (ret == 0) {
+        ret = yj_capture_index_open(&index, PyBytes_AS_STRING(index_path), &reader);
+        if (ret < 0) {
+            yj_capture_reader_close(&reader);
+        }
+    }
+    Py_DECREF(capture_path);
+    Py_DECREF(index_path);
+    if (ret == YJ_CAPTURE_INDEX_ERR_STALE) {
+        PyErr_SetString(PyExc_ValueError, "索引文件与录制文件不匹配");
+        return NULL;
+    } else if (ret == YJ_CAPTURE_INDEX_ERR_FORMAT) {
+        PyErr_SetString(PyExc_ValueError, "不是有效的YJ录制文件或索引文件");
+        return NULL;
+    } else if (ret < 0) {
+        return PyErr_SetFromErrno(PyExc_OSError);
+    }
+
+    uint64_t seek_offset = yj_capture_index_seek_time(&index, t0_ns);
+    uint64_t posting_count = 0;
+    const uint64_t* postings = yj_capture_index_postings(&index, func_id, &posting_count);
+    uint64_t first = 0;
+    uint64_t hit_count = yj_capture_index_query(&index, func_id, t0_ns, t1_ns, &first);
+
+    PyObject* postings_list = offsets_to_list(postings, postings ? posting_count : 0);
+    PyObject* hits_list = postings_list ? offsets_to_list(postings ? postings + first : NULL, hit_count) : NULL;
+    yj_capture_index_close(&index);
+    yj_capture_reader_close(&reader);
+    if (!hits_list) {
+        Py_XDECREF(postings_list);
+        return NULL;
+    }
+    return Py_BuildValue("(KNN)", (unsigned long long)seek_offset, postings_list, hits_list);
+}
+
+#endif // YJ_NATIVE_HAVE_CAPTURE
+
+/* ---- 模块定义 ---- */
+
+static PyMethodDef yj_native_methods[] = {
+    {"scan_frames", (PyCFunction)(void (*)(void))yj_native_scan_frames,
+     METH_VARARGS | METH_KEYWORDS, scan_frames_doc},
+    {"decode_columns", (PyCFunction)(void (*)(void))yj_native_decode_columns,
+     METH_VARARGS | METH_KEYWORDS, decode_columns_doc},
+    {"pack_varint_array", (PyCFunction)(void (*)(void))yj_native_pack_varint_array,
+     METH_VARARGS | METH_KEYWORDS, pack_varint_array_doc},
+    {"unpack_varint_array", (PyCFunction)(void (*)(void))yj_native_unpack_varint_array,
+     METH_VARARGS | METH_KEYWORDS, unpack_varint_array_doc},
+#ifdef YJ_NATIVE_HAVE_CAPTURE
+    {"build_capture_index", (PyCFunction)(void (*)(void))yj_native_build_capture_index,
+     METH_VARARGS | METH_KEYWORDS, build_capture_index_doc},
+    {"seek_capture_time", (PyCFunction)(void (*)(void))yj_native_seek_capture_time,
+     METH_VARARGS | METH_KEYWORDS, seek_capture_time_doc},
+    {"query_capture_index", (PyCFunction)(void (*)(void))yj_native_query_capture_index,
+     METH_VARARGS | METH_KEYWORDS, query_capture_index_doc},
+#endif
+    {NULL, NULL, 0, NULL}
+};
+
+static struct PyModuleDef yj_native_module = {
+    PyModuleDef_HEAD_INIT,
+    "_yj_native",
+    "YJ协议C核心的Python绑定",
+    -1,
+    yj_native_methods,
+    NULL, NULL, NULL, NULL
+};
+
+PyMODINIT_FUNC PyInit__yj_native(void) {
+    if (PyType_Ready(&ByteRingType) < 0) {
+        return NULL;
+    }
+#ifdef YJ_NATIVE_HAVE_CAPTURE
+    if (PyType_Ready(&CaptureWriterType) < 0) {
+        return NULL;
+    }
+#endif
+    PyObject* module = PyModule_Create(&yj_native_module);
+    if (!module) {
+        return NULL;
+    }
+    Py_INCREF(&ByteRingType);
+    if (PyModule_AddObject(module, "ByteRing", (PyObject*)&ByteRingType) < 0) {
+        Py_DECREF(&ByteRingType);
+        Py_DECREF(module);
+        return NULL;
+    }
+#ifdef YJ_NATIVE_HAVE_CAPTURE
+    Py_INCREF(&CaptureWriterType);
+    if (PyModule_AddObject(module, "CaptureWriter", (PyObject*)&CaptureWriterType) < 0) {
+        Py_DECREF(&CaptureWriterType);
+        Py_DECREF(module);
+        return NULL;
+    }
+#endif
+    if (PyModule_AddIntConstant(module, "CHECKSUM_MODE_ORIGINAL", YJ_CHECKSUM_MODE_ORIGINAL) < 0 ||
+        PyModule_AddIntConstant(module, "CHECKSUM_MODE_CRC16", YJ_CHECKSUM_MODE_CRC16) < 0 ||
+        PyModule_AddIntConstant(module, "FRAME_HEAD_BYTE", YJ_FRAME_HEAD_BYTE) < 0 ||
+        PyModule_AddIntConstant(module, "MAX_DATA_PAYLOAD_SIZE", YJ_MAX_DATA_PAYLOAD_SIZE) < 0 ||
+        PyModule_AddIntConstant(module, "FRAME_MIN_OVERHEAD", YJ_FRAME_MIN_OVERHEAD) < 0 ||
+        PyModule_AddIntConstant(module, "FIELD_U8", YJ_FIELD_U8) < 0 ||
+        PyModule_AddIntConstant(module, "FIELD_I8", YJ_FIELD_I8) < 0 ||
+        PyModule_AddIntConstant(module, "FIELD_U16", YJ_FIELD_U16) < 0 ||
+        PyModule_AddIntConstant(module, "FIELD_I16", YJ_FIELD_I16) < 0 ||
+        PyModule_AddIntConstant(module, "FIELD_U32", YJ_FIELD_U32) < 0 ||
+        PyModule_AddIntConstant(module, "FIELD_I32", YJ_FIELD_I32) < 0 ||
+        PyModule_AddIntConstant(module, "FIELD_F32", YJ_FIELD_F32) < 0 ||
+        PyModule_AddIntConstant(module, "FIELD_F64", YJ_FIELD_F64) < 0 ||
+        PyModule_AddIntConstant(module, "VARINT_U32", YJ_NATIVE_VARINT_U32) < 0 ||
+        PyModule_AddIntConstant(module, "VARINT_ZIGZAG", YJ_NATIVE_VARINT_ZIGZAG) < 0 ||
+        PyModule_AddIntConstant(module, "VARINT_DELTA", YJ_NATIVE_VARINT_DELTA) < 0) {
+        Py_DECREF(module);
+        return NULL;
+    }
+    return module;
+}
@@ -0,0 +1,486 @@
+/**
+ * @file yj_stream_analyze.c
+ * @brief 原始字节流多线程离线分析实现
+ */
+
+#include "yj_stream_analyze.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define YJ_FIND_BYTE_AVX2 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define YJ_FIND_BYTE_NEON 1
+#endif
+
+#define SCAN_BATCH    1024        // 工作线程每次扫描的帧位置数
+#define RESYNC_BATCH  16          // 主线程补解析时每次扫描的帧位置数(通常第一帧就同步)
+#define SCAN_MAX_LEN  (1u << 30)  // 单次yj_protocol_scan_buffer的最大长度
+
+/* 同步窗口中暂存的帧位置 */
+typedef struct {
+    uint64_t offset;
+    uint16_t length;
+    uint8_t  func_id;
+    uint8_t  checksum_ok;
+} window_span_t;
+
+/* 块 */
+typedef struct {
+    uint64_t start;                             // 块起点(候选帧头)
+    uint64_t end;                               // 块终点, 起点在[start, end)内的帧属于本块
+    yj_analyze_result_t* seg;                   // 同步窗口之后的帧统计
+    window_span_t window[YJ_ANALYZE_SYNC_SPANS];
+    uint32_t window_count;
+    uint64_t resume;                            // 本块最后一帧的结束位置
+    int      has_resume;
+    int32_t  status;
+} chunk_t;
+
+typedef struct {
+    const uint8_t* data;
+    uint64_t len;
+    const yj_analyze_config_t* cfg;
+    chunk_t* chunks;
+    uint32_t chunk_count;
+    uint32_t next;                              // 下一个待处理的块
+} analyze_job_t;
+
+/* ---- 向量化字节查找 ---- */
+
+#ifdef YJ_FIND_BYTE_AVX2
+__attribute__((target("avx2")))
+static const uint8_t* find_byte_avx2(const uint8_t* data, uint64_t len, uint8_t byte) {
+    const __m256i needle = _mm256_set1_epi8((char)byte);
+    uint64_t i = 0;
+    for (; i + 64 <= len; i += 64) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(data + i));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(data + i + 32));
+        uint32_t ma = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, needle));
+        uint32_t mb = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(b, needle));
+        if (ma | mb) {
+            uint64_t mask = (uint64_t)ma | ((uint64_t)mb << 32);
+            return data + i + (uint64_t)__builtin_ctzll(mask);
+        }
+    }
+    for (; i < len; ++i) {
+        if (data[i] == byte) return data + i;
+    }
+    return NULL;
+}
+#endif
+
+#ifdef YJ_FIND_BYTE_NEON
+static const uint8_t* find_byte_neon(const uint8_t* data, uint64_t len, uint8_t byte) {
+    const uint8x16_t needle = vdupq_n_u8(byte);
+    uint64_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        uint8x16_t eq = vceqq_u8(vld1q_u8(data + i), needle);
+        // 每字节比较结果压缩为4位, 得到64位掩码
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+        if (mask) return data + i + ((uint64_t)__builtin_ctzll(mask) >> 2);
+    }
+    for (; i < len; ++i) {
+        if (data[i] == byte) return data + i;
+    }
+    return NULL;
+}
+#endif
+
+/**
+ * @brief 查找字节首次出现的位置
+ */
+const uint8_t* yj_find_byte(const uint8_t* data, uint64_t len, uint8_t byte) {
+    if (!data || len == 0) return NULL;
+#if defined(YJ_FIND_BYTE_AVX2)
+    if (__builtin_cpu_supports("avx2")) return find_byte_avx2(data, len, byte);
+#elif defined(YJ_FIND_BYTE_NEON)
+    return find_byte_neon(data, len, byte);
+#endif
+    return (const uint8_t*)memchr(data, byte, (size_t)len);
+}
+
+/* ---- 统计累加与合并 ---- */
+
+/* 字节偏移换算为线路时间(每字节10位), 分两段计算避免64位溢出 */
+static uint64_t line_ns(const yj_analyze_config_t* cfg, uint64_t offset) {
+    const uint64_t bit_ns = 10ull * 1000000000ull;
+    return offset / cfg->baud * bit_ns + (offset % cfg->baud) * bit_ns / cfg->baud;
+}
+
+static int32_t gap_add(yj_analyze_func_t* f, const yj_analyze_config_t* cfg,
+                       uint64_t start_ns, uint64_t length_ns, uint64_t offset) {
+    f->gap_count++;
+    if (length_ns > f->max_gap_ns) f->max_gap_ns = length_ns;
+    if (f->gaps_kept >= cfg->max_gaps) return 0;
+    if (!f->gaps) {
+        f->gaps = (yj_analyze_gap_t*)malloc(sizeof(yj_analyze_gap_t) * cfg->max_gaps);
+        if (!f->gaps) return YJ_ANALYZE_ERR_NOMEM;
+    }
+    yj_analyze_gap_t* gap = &f->gaps[f->gaps_kept++];
+    gap->start_ns = start_ns;
+    gap->length_ns = length_ns;
+    gap->offset = offset;
+    return 0;
+}
+
+/* 内部辅助函数: 保证bins覆盖到分片下标bin(bin >= bin_first) */
+static int32_t bins_reserve(yj_analyze_func_t* f, uint64_t bin) {
+    uint64_t needed = bin - f->bin_first + 1;
+    if (needed <= f->bin_count) return 0;
+    if (needed > UINT32_MAX) return YJ_ANALYZE_ERR_PARAM;
+    if (needed > f->bin_capacity) {
+        uint64_t capacity = f->bin_capacity ? f->bin_capacity : 64;
+        while (capacity < needed) capacity *= 2;
+        if (capacity > UINT32_MAX) capacity = UINT32_MAX;
+        uint32_t* bins = (uint32_t*)realloc(f->bins, (size_t)capacity * sizeof(uint32_t));
+        if (!bins) return YJ_ANALYZE_ERR_NOMEM;
+        f->bins = bins;
+        f->bin_capacity = (uint32_t)capacity;
+    }
+    memset(f->bins + f->bin_count, 0, (size_t)(needed - f->bin_count) * sizeof(uint32_t));
+    f->bin_count = (uint32_t)needed;
+    return 0;
+}
+
+/* 内部辅助函数: 按流中顺序累加一帧 */
+static int32_t seg_add(yj_analyze_result_t* seg, const yj_analyze_config_t* cfg,
+                       uint64_t offset, uint16_t length, uint8_t func_id, uint8_t checksum_ok) {
+    yj_analyze_func_t* f = &seg->funcs[func_id];
+    seg->frame_bytes += length;
+    if (!checksum_ok) {
+        seg->errors++;
+        f->errors++;
+        return 0;
+    }
+
+    uint64_t ts = line_ns(cfg, offset);
+    uint64_t bin = ts / cfg->bin_ns;
+    seg->frames++;
+    if (f->frames == 0) {
+        f->first_ns = ts;
+        f->first_offset = offset;
+        f->bin_first = bin;
+    } else if (ts - f->last_ns > cfg->gap_ns) {
+        if (gap_add(f, cfg, f->last_ns, ts - f->last_ns, offset) < 0) return YJ_ANALYZE_ERR_NOMEM;
+    }
+    f->frames++;
+    f->bytes += length;
+    f->last_ns = ts;
+    int32_t ret = bins_reserve(f, bin);
+    if (ret < 0) return ret;
+    f->bins[bin - f->bin_first]++;
+    return 0;
+}
+
+/* 内部辅助函数: 把src(流中位于dst之后的一段)合并进dst, src的缺口明细和分片被取走或释放 */
+static int32_t seg_merge(yj_analyze_result_t* dst, yj_analyze_result_t* src,
+                         const yj_analyze_config_t* cfg) {
+    dst->frame_bytes += src->frame_bytes;
+    dst->frames += src->frames;
+    dst->errors += src->errors;
+
+    for (uint32_t id = 0; id < YJ_ANALYZE_FUNC_COUNT; ++id) {
+        yj_analyze_func_t* d = &dst->funcs[id];
+        yj_analyze_func_t* s = &src->funcs[id];
+        d->errors += s->errors;
+        if (s->frames == 0) continue;
+
+        if (d->frames == 0) {
+            d->first_ns = s->first_ns;
+            d->first_offset = s->first_offset;
+        } else if (s->first_ns - d->last_ns > cfg->gap_ns) {
+            // 缺口跨越两段的边界
+            if (gap_add(d, cfg, d->last_ns, s->first_ns - d->last_ns, s->first_offset) < 0) {
+                return YJ_ANALYZE_ERR_NOMEM;
+            }
+        }
+        for (uint32_t i = 0; i < s->gaps_kept && d->gaps_kept < cfg->max_gaps; ++i) {
+            if (!d->gaps) {
+                d->gaps = (yj_analyze_gap_t*)malloc(sizeof(yj_analyze_gap_t) * cfg->max_gaps);
+                if (!d->gaps) return YJ_ANALYZE_ERR_NOMEM;
+            }
+            d->gaps[d->gaps_kept++] = s->gaps[i];
+        }
+        d->gap_count += s->gap_count;
+        if (s->max_gap_ns > d->max_gap_ns) d->max_gap_ns = s->max_gap_ns;
+
+        if (d->bin_count == 0) {
+            // 直接取走src的分片数组
+            free(d->bins);
+            d->bins = s->bins;
+            d->bin_first = s->bin_first;
+            d->bin_count = s->bin_count;
+            d->bin_capacity = s->bin_capacity;
+            s->bins = NULL;
+            s->bin_count = s->bin_capacity = 0;
+        } else {
+            int32_t ret = bins_reserve(d, s->bin_first + s->bin_count - 1);
+            if (ret < 0) return ret;
+            uint64_t base = s->bin_first - d->bin_first;
+            for (uint32_t i = 0; i < s->bin_count; ++i) d->bins[base + i] += s->bins[i];
+        }
+
+        d->frames += s->frames;
+        d->bytes += s->bytes;
+        d->last_ns = s->last_ns;
+    }
+    return 0;
+}
+
+/**
+ * @brief 释放分析结果中的缺口明细和速率分片
+ */
+void yj_analyze_result_free(yj_analyze_result_t* result) {
+    if (!result) return;
+    for (uint32_t id = 0; id < YJ_ANALYZE_FUNC_COUNT; ++id) {
+        free(result->funcs[id].gaps);
+        free(result->funcs[id].bins);
+        result->funcs[id].gaps = NULL;
+        result->funcs[id].bins = NULL;
+        result->funcs[id].gaps_kept = 0;
+        result->funcs[id].bin_count = result->funcs[id].bin_capacity = 0;
+    }
+}
+
+static void seg_destroy(yj_analyze_result_t* seg) {
+    if (!seg) return;
+    yj_analyze_result_free(seg);
+    free(seg);
+}
+
+/* ---- 扫描 ---- */
+
+/**
+ * 内部辅助函数: 从pos开始顺序扫描, 起点在[pos, end)内的帧依次放入window(至多window_cap个)后累加到seg。
+ * 起点在end之前的帧可以延伸到end之后。
+ */
+static int32_t scan_range(const uint8_t* data, uint64_t len, const yj_analyze_config_t* cfg,
+                          uint64_t pos, uint64_t end, yj_analyze_result_t* seg,
+                          window_span_t* window, uint32_t window_cap, uint32_t* window_count,
+                          uint64_t* resume, int* has_resume) {
+    yj_frame_span_t spans[SCAN_BATCH];
+    uint64_t max_frame = (uint64_t)YJ_FRAME_MIN_OVERHEAD + cfg->max_payload;
+    uint64_t scan_end = end + max_frame < len ? end + max_frame : len;
+
+    while (pos < scan_end) {
+        uint64_t avail = scan_end - pos;
+        if (avail > SCAN_MAX_LEN) avail = SCAN_MAX_LEN;
+        uint32_t consumed = 0;
+        uint32_t n = yj_protocol_scan_buffer(data + pos, (uint32_t)avail, cfg->mode, cfg->head_byte,
+                                             cfg->max_payload, spans, SCAN_BATCH, &consumed);
+        for (uint32_t i = 0; i < n; ++i) {
+            uint64_t off = pos + spans[i].offset;
+            if (off >= end) return 0;
+            if (window && *window_count < window_cap) {
+                window_span_t* w = &window[(*window_count)++];
+                w->offset = off;
+                w->length = spans[i].length;
+                w->func_id = spans[i].func_id;
+                w->checksum_ok = spans[i].checksum_ok;
+            } else if (seg_add(seg, cfg, off, spans[i].length, spans[i].func_id,
+                               spans[i].checksum_ok) < 0) {
+                return YJ_ANALYZE_ERR_NOMEM;
+            }
+            *resume = off + spans[i].length;
+            *has_resume = 1;
+        }
+        if (n < SCAN_BATCH && pos + avail == scan_end) break; // 已扫到末尾(末尾可能是不完整的帧)
+        if (consumed == 0) break;
+        pos += consumed;
+    }
+    return 0;
+}
+
+static void* analyze_worker(void* arg) {
+    analyze_job_t* job = (analyze_job_t*)arg;
+    uint32_t index;
+
+    while ((index = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED)) < job->chunk_count) {
+        chunk_t* chunk = &job->chunks[index];
+        chunk->seg = (yj_analyze_result_t*)calloc(1, sizeof(yj_analyze_result_t));
+        if (!chunk->seg) {
+            chunk->status = YJ_ANALYZE_ERR_NOMEM;
+            continue;
+        }
+        chunk->status = scan_range(job->data, job->len, job->cfg, chunk->start, chunk->end, chunk->seg,
+                                   chunk->window, YJ_ANALYZE_SYNC_SPANS, &chunk->window_count,
+                                   &chunk->resume, &chunk->has_resume);
+    }
+    return NULL;
+}
+
+static int window_find(const chunk_t* chunk, uint64_t offset, uint32_t* index) {
+    uint32_t lo = 0, hi = chunk->window_count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (chunk->window[mid].offset < offset) lo = mid + 1;
+        else hi = mid;
+    }
+    *index = lo;
+    return lo < chunk->window_count && chunk->window[lo].offset == offset;
+}
+
+/**
+ * 内部辅助函数: 主线程从真实续接位置*resume顺序解析, 直到与块的扫描结果同步, 然后把整块并入result。
+ * 返回后*resume为本块最后一帧的结束位置(本块没有帧时不变)。
+ */
+static int32_t merge_chunk(const uint8_t* data, uint64_t len, const yj_analyze_config_t* cfg,
+                           chunk_t* chunk, yj_analyze_result_t* result, uint64_t* resume) {
+    yj_frame_span_t spans[RESYNC_BATCH];
+    yj_analyze_result_t* prefix = (yj_analyze_result_t*)calloc(1, sizeof(yj_analyze_result_t));
+    uint64_t max_frame = (uint64_t)YJ_FRAME_MIN_OVERHEAD + cfg->max_payload;
+    uint64_t scan_end = chunk->end + max_frame < len ? chunk->end + max_frame : len;
+    uint64_t pos = *resume;
+    uint32_t prefix_frames = 0;
+    int32_t ret = 0;
+
+    if (!prefix) return YJ_ANALYZE_ERR_NOMEM;
+
+    while (pos < scan_end) {
+        uint64_t base = pos;
+        uint64_t avail = scan_end - base;
+        if (avail > SCAN_MAX_LEN) avail = SCAN_MAX_LEN;
+        uint32_t consumed = 0;
+        uint32_t n = yj_protocol_scan_buffer(data + base, (uint32_t)avail, cfg->mode, cfg->head_byte,
+                                             cfg->max_payload, spans, RESYNC_BATCH, &consumed);
+        for (uint32_t i = 0; i < n; ++i) {
+            uint64_t off = base + spans[i].offset;
+            uint32_t index;
+            if (off >= chunk->end) goto no_sync; // 块内没有与顺序解析一致的帧
+
+            if (window_find(chunk, off, &index)) {
+                // 已同步: 采用块的扫描结果
+                if (prefix_frames > 0 || index > 0) result->resynced_chunks++;
+                for (uint32_t w = index; w < chunk->window_count && ret == 0; ++w) {
+                    const window_span_t* span = &chunk->window[w];
+                    ret = seg_add(prefix, cfg, span->offset, span->length, span->func_id, span->checksum_ok);
+                }
+                if (ret == 0) ret = seg_merge(result, prefix, cfg);
+                if (ret == 0) ret = seg_merge(result, chunk->seg, cfg);
+                *resume = chunk->resume;
+                seg_destroy(prefix);
+                return ret;
+            }
+
+            ret = seg_add(prefix, cfg, off, spans[i].length, spans[i].func_id, spans[i].checksum_ok);
+            if (ret < 0) goto out;
+            prefix_frames++;
+            *resume = off + spans[i].length;
+            pos = *resume;
+
+            if (index >= chunk->window_count) {
+                // 已越过同步窗口仍未同步: 剩余部分整块重新解析
+                int has_resume = 1;
+                result->reparsed_chunks++;
+                ret = scan_range(data, len, cfg, pos, chunk->end, prefix, NULL, 0, NULL, resume, &has_resume);
+                if (ret == 0) ret = seg_merge(result, prefix, cfg);
+                goto out;
+            }
+        }
+        if (n < RESYNC_BATCH && base + avail == scan_end) break;
+        if (consumed == 0) break;
+        pos = base + consumed;
+    }
+
+no_sync:
+    if (prefix_frames > 0) result->resynced_chunks++;
+    ret = seg_merge(result, prefix, cfg);
+out:
+    seg_destroy(prefix);
+    return ret;
+}
+
+/**
+ * @brief 填充默认配置
+ */
+void yj_analyze_default_config(yj_analyze_config_t* config) {
+    if (!config) return;
+    memset(config, 0, sizeof(*config));
+    config->mode = YJ_CHECKSUM_MODE_ORIGINAL;
+    config->head_byte = YJ_FRAME_HEAD_BYTE;
+    config->max_payload = YJ_MAX_DATA_PAYLOAD_SIZE;
+    config->chunk_size = YJ_ANALYZE_DEFAULT_CHUNK_SIZE;
+    config->baud = YJ_ANALYZE_DEFAULT_BAUD;
+    config->bin_ns = YJ_ANALYZE_DEFAULT_BIN_NS;
+    config->gap_ns = YJ_ANALYZE_DEFAULT_GAP_NS;
+    config->max_gaps = YJ_ANALYZE_DEFAULT_MAX_GAPS;
+}
+
+/**
+ * @brief 分析整段字节流
+ */
+int32_t yj_analyze_stream(const uint8_t* data, uint64_t len, const yj_analyze_config_t* config,
+                          yj_analyze_result_t* result) {
+    if (!config || !result || (!data && len > 0) || config->chunk_size == 0 || config->baud == 0 ||
+        config->bin_ns == 0) {
+        return YJ_ANALYZE_ERR_PARAM;
+    }
+    memset(result, 0, sizeof(*result));
+    result->total_bytes = len;
+    result->duration_ns = line_ns(config, len);
+
+    // 1. 切块: 名义边界之后的第一个候选帧头作为下一块起点
+    uint32_t chunk_count = 0, chunk_capacity = 0;
+    chunk_t* chunks = NULL;
+    uint64_t pos = 0;
+    while (pos < len) {
+        if (chunk_count == chunk_capacity) {
+            uint32_t capacity = chunk_capacity ? chunk_capacity * 2 : 16;
+            chunk_t* grown = (chunk_t*)realloc(chunks, capacity * sizeof(chunk_t));
+            if (!grown) {
+                free(chunks);
+                return YJ_ANALYZE_ERR_NOMEM;
+            }
+            chunks = grown;
+            chunk_capacity = capacity;
+        }
+        chunk_t* chunk = &chunks[chunk_count++];
+        memset(chunk, 0, sizeof(*chunk));
+        chunk->start = pos;
+        uint64_t nominal = pos + config->chunk_size;
+        const uint8_t* head = nominal < len ? yj_find_byte(data + nominal, len - nominal, config->head_byte)
+                                            : NULL;
+        chunk->end = head ? (uint64_t)(head - data) : len;
+        pos = chunk->end;
+    }
+    result->chunks = chunk_count;
+
+    // 2. 各线程并行扫描块
+    uint32_t threads = config->threads;
+    if (threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (uint32_t)cpus : 1;
+    }
+    if (threads > chunk_count) threads = chunk_count > 0 ? chunk_count : 1;
+    result->threads = threads;
+
+    analyze_job_t job = {data, len, config, chunks, chunk_count, 0};
+    pthread_t* tids = (pthread_t*)calloc(threads, sizeof(pthread_t));
+    uint32_t started = 0;
+    int32_t ret = 0;
+    if (!tids) ret = YJ_ANALYZE_ERR_NOMEM;
+    for (uint32_t t = 1; t < threads && ret == 0; ++t) {
+        if (pthread_create(&tids[t], NULL, analyze_worker, &job) != 0) break; // 少几个线程也能完成
+        started++;
+    }
+    if (ret == 0) analyze_worker(&job); // 主线程也参与扫描
+    for (uint32_t t = 1; t <= started; ++t) pthread_join(tids[t], NULL);
+    free(tids);
+
+    // 3. 按顺序合并, 处理块边界的同步
+    uint64_t resume = 0;
+    for (uint32_t i = 0; i < chunk_count; ++i) {
+        if (ret == 0) ret = chunks[i].status;
+        if (ret == 0) ret = merge_chunk(data, len, config, &chunks[i], result, &resume);
+        seg_destroy(chunks[i].seg);
+    }
+    free(chunks);
+    if (ret < 0) yj_analyze_result_free(result);
+    return ret;
+}
@@ -0,0 +1,114 @@
+#ifndef YJ_STREAM_ANALYZE_H
+#define YJ_STREAM_ANALYZE_H
+
+#include <stdint.h>
+#include "yj_protocol.h"
+
+/**
+ * @file yj_stream_analyze.h
+ * @brief 原始字节流录制(串口直接转储, 可达数GB)的多线程离线分析
+ *
+ * 整个流按chunk_size切块, 块边界用向量化字节查找(yj_find_byte)对齐到候选帧头;
+ * 各线程对自己的块调用yj_protocol_scan_buffer找帧并校验, 从块起点之后开始的帧可以延伸到下一块。
+ * 块起点的候选帧头不一定与顺序解析同步(0xAB也会出现在数据负载中), 因此每块先记下前
+ * YJ_ANALYZE_SYNC_SPANS个帧位置暂不计入; 合并时主线程从上一块真实结束处接着顺序解析,
+ * 一旦落到该块记下的某个帧位置即已同步(扫描无状态, 同一位置之后的结果必然一致),
+ * 从那里起采用该块的结果, 否则整块由主线程重新解析。最终结果与单线程从头顺序扫描完全相同。
+ *
+ * 原始转储不带时间戳, 帧时间按字节偏移和线路波特率(每字节10位)换算为"线路时间",
+ * 用于各功能ID的速率直方图(按bin_ns分片计帧数)和缺口检测(相邻帧间隔超过gap_ns)。
+ */
+
+#define YJ_ANALYZE_FUNC_COUNT          256
+#define YJ_ANALYZE_SYNC_SPANS          256                 // 每块暂存用于同步判断的帧位置数
+#define YJ_ANALYZE_DEFAULT_CHUNK_SIZE  (16u * 1024u * 1024u)
+#define YJ_ANALYZE_DEFAULT_BAUD        921600u
+#define YJ_ANALYZE_DEFAULT_BIN_NS      1000000000ull       // 速率直方图按1秒分片
+#define YJ_ANALYZE_DEFAULT_GAP_NS      100000000ull        // 间隔超过100ms记为缺口
+#define YJ_ANALYZE_DEFAULT_MAX_GAPS    16
+
+/* 错误码 */
+#define YJ_ANALYZE_ERR_PARAM   (-1) // 参数错误
+#define YJ_ANALYZE_ERR_NOMEM   (-2) // 内存不足
+#define YJ_ANALYZE_ERR_THREAD  (-3) // 创建线程失败
+
+/* 分析配置 */
+typedef struct {
+    yj_checksum_mode_t mode;   // 校验模式
+    uint8_t  head_byte;        // 帧头字节
+    uint16_t max_payload;      // 允许的最大数据长度
+    uint32_t threads;          // 线程数, 0表示在线CPU数
+    uint32_t chunk_size;       // 切块大小(字节)
+    uint32_t baud;             // 线路波特率, 用于把字节偏移换算为时间
+    uint64_t bin_ns;           // 速率直方图分片长度
+    uint64_t gap_ns;           // 缺口阈值
+    uint32_t max_gaps;         // 每个功能ID保留的缺口明细条数(按时间顺序取最早的)
+} yj_analyze_config_t;
+
+/* 缺口明细 */
+typedef struct {
+    uint64_t start_ns;         // 缺口前最后一帧的线路时间
+    uint64_t length_ns;        // 缺口长度
+    uint64_t offset;           // 缺口后第一帧在流中的偏移
+} yj_analyze_gap_t;
+
+/* 单个功能ID的统计 */
+typedef struct {
+    uint64_t frames;           // 校验通过的帧数
+    uint64_t errors;           // 校验失败的帧数(按帧头中的功能ID归类)
+    uint64_t bytes;            // 校验通过的帧字节数
+    uint64_t first_ns;         // 第一帧线路时间
+    uint64_t last_ns;          // 最后一帧线路时间
+    uint64_t first_offset;     // 第一帧偏移
+    uint64_t gap_count;        // 缺口总数
+    uint64_t max_gap_ns;       // 最大缺口
+    uint32_t gaps_kept;        // gaps中的条数
+    yj_analyze_gap_t* gaps;    // 缺口明细
+    uint64_t bin_first;        // bins[0]对应的分片下标(线路时间 / bin_ns)
+    uint32_t bin_count;        // 分片数
+    uint32_t bin_capacity;
+    uint32_t* bins;            // 每个分片内校验通过的帧数
+} yj_analyze_func_t;
+
+/* 分析结果 */
+typedef struct {
+    uint64_t total_bytes;      // 流总字节数
+    uint64_t frame_bytes;      // 落在帧内的字节数(含校验失败的帧), 其余为噪声或末尾不完整帧
+    uint64_t frames;           // 校验通过的帧数
+    uint64_t errors;           // 校验失败的帧数
+    uint32_t threads;          // 实际线程数
+    uint32_t chunks;           // 块数
+    uint32_t resynced_chunks;  // 块起点未与顺序解析同步、由主线程补解析了开头若干帧的块数
+    uint32_t reparsed_chunks;  // 同步窗口内未能同步而整块重新解析的块数
+    uint64_t duration_ns;      // 流的线路时长
+    yj_analyze_func_t funcs[YJ_ANALYZE_FUNC_COUNT];
+} yj_analyze_result_t;
+
+/**
+ * @brief 查找字节首次出现的位置(x86上运行时选择AVX2实现, AArch64使用NEON, 其他平台退回memchr)
+ * @return 指向该字节的指针, 未找到返回NULL
+ */
+const uint8_t* yj_find_byte(const uint8_t* data, uint64_t len, uint8_t byte);
+
+/**
+ * @brief 填充默认配置
+ */
+void yj_analyze_default_config(yj_analyze_config_t* config);
+
+/**
+ * @brief 分析整段字节流
+ * @param data 字节流(通常为只读映射的转储文件)
+ * @param len 字节数
+ * @param config 配置
+ * @param result 输出:分析结果, 用完后调用yj_analyze_result_free释放
+ * @return 0成功, 负数为YJ_ANALYZE_ERR_*
+ */
+int32_t yj_analyze_stream(const uint8_t* data, uint64_t len, const yj_analyze_config_t* config,
+                          yj_analyze_result_t* result);
+
+/**
+ * @brief 释放分析结果中的缺口明细和速率分片
+ */
+void yj_analyze_result_free(yj_analyze_result_t* result);
+
+#endif // YJ_STREAM_ANALYZE_H
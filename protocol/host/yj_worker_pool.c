@@ -0,0 +1,608 @@
+/**
+ * @file yj_worker_pool.c
+ * @brief 多串口分片解析线程池实现
+ *
+ * 同步要点:
+ * - port->scheduled保证同一端口同一时刻至多在一个运行队列中或被一个工作线程处理,
+ *   因此输入环的消费者、协议处理器和输出帧环的生产者始终只有一个线程;
+ *   端口出入运行队列时经过队列互斥锁, 线程间交接具备获取/释放语义。
+ * - 生产者"写入数据 -> 尝试置位scheduled"与工作线程"清除scheduled -> 复查输入环"
+ *   两侧之间都有全序栅栏, 不会出现数据已写入但端口没有被调度的情况。
+ * - 休眠/唤醒使用work_seq计数和sleepers计数, 同样两侧加全序栅栏, 避免丢失唤醒。
+ * - 输出帧环满时端口置blocked并保持scheduled=1(生产者不会再调度它), 由消费者腾出空间后
+ *   清除blocked并重新入队; 工作线程置blocked后复查一次空间, 与消费者之间同样不会丢失唤醒。
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // 用于pthread_setaffinity_np
+#endif
+
+#include "yj_worker_pool.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* 单写者统计计数: 只有当前持有者修改, 其他线程以relaxed方式读取 */
+#define STAT_ADD(field, v)  __atomic_store_n(&(field), (field) + (v), __ATOMIC_RELAXED)
+#define STAT_LOAD(field)    __atomic_load_n(&(field), __ATOMIC_RELAXED)
+
+typedef struct {
+    yj_pool_t* pool;
+    uint32_t index;
+    uint32_t home;                 // 归属工作线程
+    uint32_t consumer;             // 归属消费者
+    yj_ring_t rx;                  // 输入环
+    yj_ring_t frames;              // 输出帧环(镜像布局, 消费者原地读取)
+    yj_protocol_handler_t handler;
+    uint32_t scheduled;            // 1: 在运行队列中、正在被处理或因输出帧环满而暂停
+    uint32_t blocked;              // 1: 因输出帧环满而暂停, 等待消费者重新入队
+    uint32_t produced;             // 本轮解出的帧数(仅持有者使用)
+    yj_pool_port_stats_t stats;
+} pool_port_t;
+
+typedef struct {
+    pthread_mutex_t lock;
+    uint32_t* items;               // 端口号FIFO
+    uint32_t cap;
+    uint32_t head;
+    uint32_t count;
+} run_queue_t;
+
+typedef struct {
+    yj_pool_t* pool;
+    uint32_t index;
+    pthread_t thread;
+    run_queue_t queue;
+    yj_pool_worker_stats_t stats;
+} pool_worker_t;
+
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint32_t waiting;              // 消费者正在yj_pool_consumer_wait中等待
+    uint32_t* ports;               // 归属该消费者的端口
+    uint32_t port_count;
+    uint32_t next;                 // 下次轮询起始位置
+} pool_consumer_t;
+
+struct yj_pool {
+    yj_pool_config_t cfg;
+    pool_port_t* ports;
+    pool_worker_t* workers;
+    pool_consumer_t* consumers;
+    uint32_t* consumer_port_storage;
+    uint8_t* ring_storage;
+    pthread_mutex_t sleep_lock;
+    pthread_cond_t sleep_cond;
+    uint32_t sleepers;
+    uint32_t work_seq;
+    uint32_t stop;
+    uint32_t started_workers;
+    int started;
+};
+
+static int is_pow2(uint32_t v) {
+    return v != 0 && (v & (v - 1)) == 0;
+}
+
+/* 池内处理器只用于接收 */
+static int32_t pool_send_byte(void* user, uint8_t byte) {
+    (void)user;
+    (void)byte;
+    return -1;
+}
+
+/* 内部辅助函数: 把解出的帧追加到端口输出帧环, 空间不足时丢弃 */
+static void pool_on_frame(void* user, yj_frame_t* frame) {
+    pool_port_t* port = (pool_port_t*)user;
+    uint32_t size = YJ_POOL_FRAME_HEADER_SIZE + frame->data_len;
+    uint8_t* dst;
+
+    STAT_ADD(port->stats.frames, 1);
+    if (yj_ring_write_span(&port->frames, &dst) < size) {
+        STAT_ADD(port->stats.frames_dropped, 1);
+        return;
+    }
+    dst[0] = frame->s_addr;
+    dst[1] = frame->d_addr;
+    dst[2] = frame->func_id;
+    dst[3] = 0;
+    dst[4] = (uint8_t)frame->data_len;
+    dst[5] = (uint8_t)(frame->data_len >> 8);
+    dst[6] = 0;
+    dst[7] = 0;
+    memcpy(dst + YJ_POOL_FRAME_HEADER_SIZE, frame->data, frame->data_len);
+    yj_ring_commit(&port->frames, size);
+    port->produced++;
+}
+
+static void queue_push(run_queue_t* queue, uint32_t port) {
+    pthread_mutex_lock(&queue->lock);
+    queue->items[(queue->head + queue->count) % queue->cap] = port;
+    __atomic_store_n(&queue->count, queue->count + 1, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+static int queue_pop(run_queue_t* queue, uint32_t* port) {
+    // 先无锁看一眼, 窃取时跳过空队列
+    if (__atomic_load_n(&queue->count, __ATOMIC_RELAXED) == 0) return 0;
+    pthread_mutex_lock(&queue->lock);
+    if (queue->count == 0) {
+        pthread_mutex_unlock(&queue->lock);
+        return 0;
+    }
+    *port = queue->items[queue->head];
+    queue->head = (queue->head + 1) % queue->cap;
+    __atomic_store_n(&queue->count, queue->count - 1, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&queue->lock);
+    return 1;
+}
+
+static void wake_worker(yj_pool_t* pool) {
+    __atomic_add_fetch(&pool->work_seq, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&pool->sleepers, __ATOMIC_SEQ_CST) > 0) {
+        pthread_mutex_lock(&pool->sleep_lock);
+        pthread_cond_signal(&pool->sleep_cond);
+        pthread_mutex_unlock(&pool->sleep_lock);
+    }
+}
+
+/* 内部辅助函数: 端口有新数据时放入归属工作线程的队列(已调度则什么都不做) */
+static void schedule_port(yj_pool_t* pool, pool_port_t* port) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&port->scheduled, __ATOMIC_RELAXED)) return;
+    uint32_t expected = 0;
+    if (__atomic_compare_exchange_n(&port->scheduled, &expected, 1, 0,
+                                    __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+        queue_push(&pool->workers[port->home].queue, port->index);
+        wake_worker(pool);
+    }
+}
+
+static void notify_consumer(yj_pool_t* pool, pool_port_t* port) {
+    pool_consumer_t* consumer = &pool->consumers[port->consumer];
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&consumer->waiting, __ATOMIC_RELAXED)) {
+        pthread_mutex_lock(&consumer->lock);
+        pthread_cond_signal(&consumer->cond);
+        pthread_mutex_unlock(&consumer->lock);
+    }
+}
+
+/* 内部辅助函数: 本轮最多可解析的字节数, 保证解出的帧都放得进输出帧环 */
+static uint32_t drain_limit(const yj_pool_t* pool, const pool_port_t* port) {
+    // 每帧的记录与原帧等长, 另需为处理器中上一轮残留的半帧预留一帧
+    uint32_t space = yj_ring_space(&port->frames);
+    uint32_t limit = space > YJ_MAX_FRAME_SIZE ? space - YJ_MAX_FRAME_SIZE : 0;
+    return limit < pool->cfg.drain_budget ? limit : pool->cfg.drain_budget;
+}
+
+/* 内部辅助函数: 批量解析一个端口最多drain_budget字节 */
+static void drain_port(pool_worker_t* worker, pool_port_t* port) {
+    yj_pool_t* pool = worker->pool;
+    uint32_t budget = drain_limit(pool, port);
+    uint32_t parsed = 0;
+
+    port->produced = 0;
+    while (parsed < budget) {
+        const uint8_t* ptr;
+        uint32_t n = yj_ring_read_span(&port->rx, &ptr);
+        if (n == 0) break;
+        if (n > budget - parsed) n = budget - parsed;
+        yj_protocol_process_buffer(&port->handler, ptr, n);
+        yj_ring_discard(&port->rx, n);
+        parsed += n;
+    }
+    STAT_ADD(worker->stats.turns, 1);
+    STAT_ADD(worker->stats.bytes, parsed);
+    if (port->produced > 0) {
+        notify_consumer(pool, port);
+    }
+
+    if (yj_ring_count(&port->rx) > 0 && drain_limit(pool, port) == 0) {
+        // 输出帧环满: 暂停该端口, 交给消费者在取走帧后重新入队
+        STAT_ADD(port->stats.stalls, 1);
+        __atomic_store_n(&port->blocked, 1, __ATOMIC_SEQ_CST);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        uint32_t expected = 1;
+        if (drain_limit(pool, port) > 0 &&
+            __atomic_compare_exchange_n(&port->blocked, &expected, 0, 0,
+                                        __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+            queue_push(&worker->queue, port->index); // 消费者已在复查前腾出空间
+            wake_worker(pool);
+        }
+        return;
+    }
+    if (yj_ring_count(&port->rx) > 0) {
+        // 预算用完仍有数据: 放回自己队列尾部, 让同队列的其他端口先处理, 空闲线程也可以把它窃走
+        queue_push(&worker->queue, port->index);
+        wake_worker(pool);
+        return;
+    }
+    __atomic_store_n(&port->scheduled, 0, __ATOMIC_SEQ_CST);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (yj_ring_count(&port->rx) > 0) {
+        schedule_port(pool, port); // 清除标志前后生产者又写入了数据
+    }
+}
+
+static void pin_to_cpu(uint32_t index) {
+#ifdef __linux__
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus <= 0) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET((int)(index % (uint32_t)cpus), &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)index;
+#endif
+}
+
+static void* worker_main(void* arg) {
+    pool_worker_t* worker = (pool_worker_t*)arg;
+    yj_pool_t* pool = worker->pool;
+    uint32_t n = pool->started_workers;
+
+    if (pool->cfg.pin_workers) pin_to_cpu(worker->index);
+
+    while (!__atomic_load_n(&pool->stop, __ATOMIC_ACQUIRE)) {
+        uint32_t seen = __atomic_load_n(&pool->work_seq, __ATOMIC_SEQ_CST);
+        uint32_t port_index;
+
+        if (queue_pop(&worker->queue, &port_index)) {
+            drain_port(worker, &pool->ports[port_index]);
+            continue;
+        }
+        int stolen = 0;
+        for (uint32_t k = 1; k < n && !stolen; ++k) {
+            if (queue_pop(&pool->workers[(worker->index + k) % n].queue, &port_index)) {
+                STAT_ADD(worker->stats.steals, 1);
+                drain_port(worker, &pool->ports[port_index]);
+                stolen = 1;
+            }
+        }
+        if (stolen) continue;
+
+        pthread_mutex_lock(&pool->sleep_lock);
+        __atomic_add_fetch(&pool->sleepers, 1, __ATOMIC_SEQ_CST);
+        while (__atomic_load_n(&pool->work_seq, __ATOMIC_SEQ_CST) == seen &&
+               !__atomic_load_n(&pool->stop, __ATOMIC_ACQUIRE)) {
+            pthread_cond_wait(&pool->sleep_cond, &pool->sleep_lock);
+        }
+        __atomic_sub_fetch(&pool->sleepers, 1, __ATOMIC_SEQ_CST);
+        pthread_mutex_unlock(&pool->sleep_lock);
+        STAT_ADD(worker->stats.sleeps, 1);
+    }
+    return NULL;
+}
+
+/**
+ * @brief 填充默认配置
+ */
+void yj_pool_default_config(yj_pool_config_t* config) {
+    if (!config) return;
+    memset(config, 0, sizeof(*config));
+    config->consumer_count = 1;
+    config->rx_ring_size = YJ_POOL_DEFAULT_RX_RING;
+    config->frame_ring_size = YJ_POOL_DEFAULT_FRAME_RING;
+    config->drain_budget = YJ_POOL_DEFAULT_DRAIN_BUDGET;
+    config->mode = YJ_CHECKSUM_MODE_ORIGINAL;
+}
+
+/**
+ * @brief 创建线程池
+ */
+int32_t yj_pool_create(yj_pool_t** out, const yj_pool_config_t* config) {
+    if (!out || !config || config->port_count == 0 || config->consumer_count == 0 ||
+        config->consumer_count > config->port_count || !is_pow2(config->rx_ring_size) ||
+        !is_pow2(config->frame_ring_size) || config->drain_budget == 0 ||
+        config->frame_ring_size < 2u * (YJ_POOL_FRAME_HEADER_SIZE + YJ_MAX_DATA_PAYLOAD_SIZE)) {
+        return YJ_POOL_ERR_PARAM;
+    }
+    *out = NULL;
+
+    yj_pool_t* pool = (yj_pool_t*)calloc(1, sizeof(yj_pool_t));
+    if (!pool) return YJ_POOL_ERR_NOMEM;
+    pool->cfg = *config;
+
+    uint32_t workers = config->worker_count;
+    if (workers == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        workers = cpus > 0 ? (uint32_t)cpus : 1;
+    }
+    if (workers > YJ_POOL_MAX_WORKERS) workers = YJ_POOL_MAX_WORKERS;
+    if (workers > config->port_count) workers = config->port_count; // 多于端口数的线程无事可做
+    pool->cfg.worker_count = workers;
+
+    uint32_t ports = config->port_count;
+    size_t per_port = (size_t)config->rx_ring_size + 2u * (size_t)config->frame_ring_size;
+    pool->ports = (pool_port_t*)calloc(ports, sizeof(pool_port_t));
+    pool->workers = (pool_worker_t*)calloc(workers, sizeof(pool_worker_t));
+    pool->consumers = (pool_consumer_t*)calloc(config->consumer_count, sizeof(pool_consumer_t));
+    pool->consumer_port_storage = (uint32_t*)calloc(ports, sizeof(uint32_t));
+    pool->ring_storage = (uint8_t*)malloc(per_port * ports);
+    if (!pool->ports || !pool->workers || !pool->consumers || !pool->consumer_port_storage ||
+        !pool->ring_storage) {
+        yj_pool_destroy(pool);
+        return YJ_POOL_ERR_NOMEM;
+    }
+
+    pthread_mutex_init(&pool->sleep_lock, NULL);
+    pthread_cond_init(&pool->sleep_cond, NULL);
+    for (uint32_t w = 0; w < workers; ++w) {
+        pool_worker_t* worker = &pool->workers[w];
+        worker->pool = pool;
+        worker->index = w;
+        pthread_mutex_init(&worker->queue.lock, NULL);
+        worker->queue.cap = ports; // 每个端口至多在一个队列中出现一次
+        worker->queue.items = (uint32_t*)calloc(ports, sizeof(uint32_t));
+        if (!worker->queue.items) {
+            yj_pool_destroy(pool);
+            return YJ_POOL_ERR_NOMEM;
+        }
+    }
+    for (uint32_t c = 0; c < config->consumer_count; ++c) {
+        pthread_mutex_init(&pool->consumers[c].lock, NULL);
+        pthread_cond_init(&pool->consumers[c].cond, NULL);
+    }
+    for (uint32_t p = 0; p < ports; ++p) {
+        pool_port_t* port = &pool->ports[p];
+        uint8_t* storage = pool->ring_storage + per_port * p;
+        port->pool = pool;
+        port->index = p;
+        port->home = p % workers;
+        port->consumer = p % config->consumer_count;
+        yj_ring_init(&port->rx, storage, config->rx_ring_size, 0);
+        yj_ring_init(&port->frames, storage + config->rx_ring_size, config->frame_ring_size,
+                     YJ_RING_FLAG_MIRROR);
+        yj_protocol_init_ex(&port->handler, pool_send_byte, pool_on_frame, port, config->mode);
+    }
+    *out = pool;
+    return 0;
+}
+
+/**
+ * @brief 设置端口归属的消费者
+ */
+int32_t yj_pool_set_consumer(yj_pool_t* pool, uint32_t port, uint32_t consumer) {
+    if (!pool || port >= pool->cfg.port_count || consumer >= pool->cfg.consumer_count) {
+        return YJ_POOL_ERR_PARAM;
+    }
+    if (pool->started) return YJ_POOL_ERR_STATE;
+    pool->ports[port].consumer = consumer;
+    return 0;
+}
+
+/**
+ * @brief 启动工作线程
+ */
+int32_t yj_pool_start(yj_pool_t* pool) {
+    if (!pool) return YJ_POOL_ERR_PARAM;
+    if (pool->started) return YJ_POOL_ERR_STATE;
+
+    // 按归属整理各消费者的端口列表
+    uint32_t offset = 0;
+    for (uint32_t c = 0; c < pool->cfg.consumer_count; ++c) {
+        pool_consumer_t* consumer = &pool->consumers[c];
+        consumer->ports = pool->consumer_port_storage + offset;
+        consumer->port_count = 0;
+        for (uint32_t p = 0; p < pool->cfg.port_count; ++p) {
+            if (pool->ports[p].consumer == c) consumer->ports[consumer->port_count++] = p;
+        }
+        offset += consumer->port_count;
+    }
+
+    pool->started = 1;
+    pool->started_workers = pool->cfg.worker_count;
+    for (uint32_t w = 0; w < pool->cfg.worker_count; ++w) {
+        if (pthread_create(&pool->workers[w].thread, NULL, worker_main, &pool->workers[w]) != 0) {
+            // 已启动的线程在destroy时回收
+            pool->started_workers = w;
+            return YJ_POOL_ERR_THREAD;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief 停止工作线程并释放资源
+ */
+void yj_pool_destroy(yj_pool_t* pool) {
+    if (!pool) return;
+    if (pool->started) {
+        pthread_mutex_lock(&pool->sleep_lock);
+        __atomic_store_n(&pool->stop, 1, __ATOMIC_RELEASE);
+        pthread_cond_broadcast(&pool->sleep_cond);
+        pthread_mutex_unlock(&pool->sleep_lock);
+        for (uint32_t w = 0; w < pool->started_workers; ++w) {
+            pthread_join(pool->workers[w].thread, NULL);
+        }
+        for (uint32_t c = 0; c < pool->cfg.consumer_count; ++c) {
+            pthread_mutex_lock(&pool->consumers[c].lock);
+            pthread_cond_broadcast(&pool->consumers[c].cond);
+            pthread_mutex_unlock(&pool->consumers[c].lock);
+        }
+    }
+    if (pool->workers) {
+        for (uint32_t w = 0; w < pool->cfg.worker_count; ++w) {
+            free(pool->workers[w].queue.items);
+        }
+    }
+    free(pool->workers);
+    free(pool->consumers);
+    free(pool->consumer_port_storage);
+    free(pool->ports);
+    free(pool->ring_storage);
+    free(pool);
+}
+
+/**
+ * @brief 写入端口收到的原始字节并调度解析
+ */
+uint32_t yj_pool_port_write(yj_pool_t* pool, uint32_t port, const uint8_t* data, uint32_t len) {
+    if (!pool || port >= pool->cfg.port_count || !data) return 0;
+    pool_port_t* p = &pool->ports[port];
+    uint32_t written = yj_ring_write(&p->rx, data, len);
+    STAT_ADD(p->stats.rx_bytes, written);
+    if (written < len) STAT_ADD(p->stats.rx_overflow, len - written);
+    if (written > 0) schedule_port(pool, p);
+    return written;
+}
+
+/**
+ * @brief 获取端口输入环的连续可写区域
+ */
+uint32_t yj_pool_port_write_span(yj_pool_t* pool, uint32_t port, uint8_t** ptr) {
+    if (!pool || port >= pool->cfg.port_count || !ptr) return 0;
+    return yj_ring_write_span(&pool->ports[port].rx, ptr);
+}
+
+/**
+ * @brief 提交写入write_span区域的字节并调度解析
+ */
+void yj_pool_port_commit(yj_pool_t* pool, uint32_t port, uint32_t n) {
+    if (!pool || port >= pool->cfg.port_count || n == 0) return;
+    pool_port_t* p = &pool->ports[port];
+    yj_ring_commit(&p->rx, n);
+    STAT_ADD(p->stats.rx_bytes, n);
+    schedule_port(pool, p);
+}
+
+/* 内部辅助函数: 消费者腾出空间后, 把因输出帧环满而暂停的端口重新入队 */
+static void unblock_port(yj_pool_t* pool, pool_port_t* port) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (!__atomic_load_n(&port->blocked, __ATOMIC_RELAXED)) return;
+    uint32_t expected = 1;
+    if (__atomic_compare_exchange_n(&port->blocked, &expected, 0, 0,
+                                    __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+        queue_push(&pool->workers[port->home].queue, port->index);
+        wake_worker(pool);
+    }
+}
+
+static int consumer_has_frames(const yj_pool_t* pool, const pool_consumer_t* consumer) {
+    for (uint32_t i = 0; i < consumer->port_count; ++i) {
+        if (yj_ring_count(&pool->ports[consumer->ports[i]].frames) > 0) return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief 取出消费者所属端口的帧并逐帧回调
+ */
+uint32_t yj_pool_consumer_poll(yj_pool_t* pool, uint32_t consumer_index,
+                               yj_pool_frame_cb_t cb, void* user, uint32_t max_frames) {
+    if (!pool || consumer_index >= pool->cfg.consumer_count || !cb) return 0;
+    pool_consumer_t* consumer = &pool->consumers[consumer_index];
+    uint32_t delivered = 0;
+
+    for (uint32_t i = 0; i < consumer->port_count; ++i) {
+        uint32_t slot = (consumer->next + i) % consumer->port_count;
+        pool_port_t* port = &pool->ports[consumer->ports[slot]];
+        const uint8_t* ptr;
+        uint32_t avail = yj_ring_read_span(&port->frames, &ptr); // 镜像布局, 全部可读数据连续
+        uint32_t consumed = 0;
+        yj_pool_frame_t frame;
+        frame.port = port->index;
+
+        while (consumed + YJ_POOL_FRAME_HEADER_SIZE <= avail &&
+               (max_frames == 0 || delivered < max_frames)) {
+            const uint8_t* rec = ptr + consumed;
+            frame.s_addr = rec[0];
+            frame.d_addr = rec[1];
+            frame.func_id = rec[2];
+            frame.data_len = (uint16_t)(rec[4] | (rec[5] << 8));
+            frame.data = rec + YJ_POOL_FRAME_HEADER_SIZE;
+            cb(user, &frame);
+            consumed += YJ_POOL_FRAME_HEADER_SIZE + frame.data_len;
+            delivered++;
+        }
+        if (consumed > 0) {
+            yj_ring_discard(&port->frames, consumed);
+            unblock_port(pool, port);
+        }
+        if (max_frames != 0 && delivered >= max_frames) {
+            consumer->next = (slot + 1) % consumer->port_count;
+            return delivered;
+        }
+    }
+    if (consumer->port_count > 0) {
+        consumer->next = (consumer->next + 1) % consumer->port_count;
+    }
+    return delivered;
+}
+
+/**
+ * @brief 等待消费者有帧可取
+ */
+int32_t yj_pool_consumer_wait(yj_pool_t* pool, uint32_t consumer_index, uint32_t timeout_ms) {
+    if (!pool || consumer_index >= pool->cfg.consumer_count) return 0;
+    pool_consumer_t* consumer = &pool->consumers[consumer_index];
+    if (consumer_has_frames(pool, consumer)) return 1;
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000u;
+    deadline.tv_nsec += (long)(timeout_ms % 1000u) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    int ready;
+    pthread_mutex_lock(&consumer->lock);
+    __atomic_store_n(&consumer->waiting, 1, __ATOMIC_SEQ_CST);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    while (!(ready = consumer_has_frames(pool, consumer)) &&
+           !__atomic_load_n(&pool->stop, __ATOMIC_ACQUIRE)) {
+        if (pthread_cond_timedwait(&consumer->cond, &consumer->lock, &deadline) == ETIMEDOUT) {
+            ready = consumer_has_frames(pool, consumer);
+            break;
+        }
+    }
+    __atomic_store_n(&consumer->waiting, 0, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&consumer->lock);
+    return ready;
+}
+
+/**
+ * @brief 实际工作线程数
+ */
+uint32_t yj_pool_worker_count(const yj_pool_t* pool) {
+    return pool ? pool->cfg.worker_count : 0;
+}
+
+/**
+ * @brief 读取端口统计
+ */
+void yj_pool_get_port_stats(const yj_pool_t* pool, uint32_t port, yj_pool_port_stats_t* stats) {
+    if (!stats) return;
+    memset(stats, 0, sizeof(*stats));
+    if (!pool || port >= pool->cfg.port_count) return;
+    const yj_pool_port_stats_t* src = &pool->ports[port].stats;
+    stats->rx_bytes = STAT_LOAD(src->rx_bytes);
+    stats->rx_overflow = STAT_LOAD(src->rx_overflow);
+    stats->frames = STAT_LOAD(src->frames);
+    stats->frames_dropped = STAT_LOAD(src->frames_dropped);
+    stats->stalls = STAT_LOAD(src->stalls);
+}
+
+/**
+ * @brief 读取工作线程统计
+ */
+void yj_pool_get_worker_stats(const yj_pool_t* pool, uint32_t worker, yj_pool_worker_stats_t* stats) {
+    if (!stats) return;
+    memset(stats, 0, sizeof(*stats));
+    if (!pool || worker >= pool->cfg.worker_count) return;
+    const yj_pool_worker_stats_t* src = &pool->workers[worker].stats;
+    stats->turns = STAT_LOAD(src->turns);
+    stats->steals = STAT_LOAD(src->steals);
+    stats->bytes = STAT_LOAD(src->bytes);
+    stats->sleeps = STAT_LOAD(src->sleeps);
+}
@@ -0,0 +1,156 @@
+#ifndef YJ_WORKER_POOL_H
+#define YJ_WORKER_POOL_H
+
+#include <stdint.h>
+#include "yj_protocol.h"
+#include "yj_ring.h"
+
+/**
+ * @file yj_worker_pool.h
+ * @brief 多串口分片解析线程池(POSIX线程, 上位机/网关使用)
+ *
+ * 单个解析线程在几十路高波特率串口下会先跑满, 而各端口的协议处理器互不相关, 天然可以并行。
+ * 线程池为每个端口维护:
+ *   - 输入环(yj_ring_t, SPSC): 生产者为该端口的读线程/IO线程, 消费者为当前持有该端口的工作线程;
+ *   - 一个yj_protocol_handler_t(通过yj_protocol_init_ex绑定端口上下文);
+ *   - 输出帧环(yj_ring_t, SPSC): 生产者为当前持有该端口的工作线程, 消费者为该端口所属的消费者。
+ *
+ * 调度: 端口有新数据时被放入其归属工作线程的运行队列(同一端口同一时刻至多在一个队列中或被一个线程处理);
+ * 工作线程每次对一个端口批量解析最多drain_budget字节, 未处理完则放回自己的队列尾部。
+ * 自己的队列为空时从其他工作线程的队列窃取端口, 某端口突发时, 同一线程上排队的其他端口会被空闲线程接走。
+ * 端口在线程间迁移时通过获取/释放语义交接输入环和输出环, 每个端口解出的帧严格保持顺序。
+ *
+ * 输出: 每个端口归属一个消费者(yj_pool_set_consumer), 消费者通过yj_pool_consumer_poll
+ * 批量取出其所有端口的帧。每轮解析的字节数不超过输出帧环剩余空间(每帧的记录与原帧等长),
+ * 输出帧环满时端口暂停解析(计入stalls)并让出工作线程, 消费者取走帧后端口重新入队;
+ * 背压因此逐级传到输入环, 最终在生产者处体现为rx_overflow或更短的write_span, 解析环节本身不丢帧。
+ */
+
+#define YJ_POOL_MAX_WORKERS         64
+#define YJ_POOL_DEFAULT_RX_RING     (64u * 1024u)  // 每端口输入环默认容量
+#define YJ_POOL_DEFAULT_FRAME_RING  (64u * 1024u)  // 每端口输出帧环默认容量
+#define YJ_POOL_DEFAULT_DRAIN_BUDGET (16u * 1024u) // 每次调度最多解析的字节数
+#define YJ_POOL_FRAME_HEADER_SIZE   8              // 输出帧环中每帧的记录头
+
+/* 错误码 */
+#define YJ_POOL_ERR_PARAM   (-1) // 参数错误
+#define YJ_POOL_ERR_NOMEM   (-2) // 内存不足
+#define YJ_POOL_ERR_THREAD  (-3) // 创建线程失败
+#define YJ_POOL_ERR_STATE   (-4) // 线程池状态不允许该操作(如启动后修改配置)
+
+typedef struct yj_pool yj_pool_t;
+
+/* 线程池配置 */
+typedef struct {
+    uint32_t worker_count;     // 工作线程数, 0表示在线CPU数
+    uint32_t port_count;       // 端口数
+    uint32_t consumer_count;   // 消费者数(至少1), 端口默认归属 port % consumer_count
+    uint32_t rx_ring_size;     // 每端口输入环容量(2的幂)
+    uint32_t frame_ring_size;  // 每端口输出帧环容量(2的幂, 至少容纳两帧)
+    uint32_t drain_budget;     // 每次调度最多解析的字节数
+    yj_checksum_mode_t mode;   // 校验模式
+    uint8_t  pin_workers;      // 1: 把第i个工作线程绑定到第i个CPU(仅Linux)
+} yj_pool_config_t;
+
+/* 消费者看到的帧(data指向输出帧环, 只在回调期间有效) */
+typedef struct {
+    uint32_t port;
+    uint8_t  s_addr;
+    uint8_t  d_addr;
+    uint8_t  func_id;
+    uint16_t data_len;
+    const uint8_t* data;
+} yj_pool_frame_t;
+
+typedef void (*yj_pool_frame_cb_t)(void* user, const yj_pool_frame_t* frame);
+
+/* 端口统计 */
+typedef struct {
+    uint64_t rx_bytes;        // 写入输入环的字节数
+    uint64_t rx_overflow;     // 输入环满被丢弃的字节数
+    uint64_t frames;          // 解出的帧数
+    uint64_t frames_dropped;  // 输出帧环空间不足被丢弃的帧数(有背压, 正常为0)
+    uint64_t stalls;          // 输出帧环满而暂停解析的次数
+} yj_pool_port_stats_t;
+
+/* 工作线程统计 */
+typedef struct {
+    uint64_t turns;           // 处理端口的次数
+    uint64_t steals;          // 从其他线程窃取端口的次数
+    uint64_t bytes;           // 解析的字节数
+    uint64_t sleeps;          // 无事可做而休眠的次数
+} yj_pool_worker_stats_t;
+
+/**
+ * @brief 填充默认配置(port_count仍需调用方设置)
+ */
+void yj_pool_default_config(yj_pool_config_t* config);
+
+/**
+ * @brief 创建线程池(尚未启动工作线程)
+ * @param pool 输出:线程池
+ * @param config 配置
+ * @return 0成功, 负数为YJ_POOL_ERR_*
+ */
+int32_t yj_pool_create(yj_pool_t** pool, const yj_pool_config_t* config);
+
+/**
+ * @brief 设置端口归属的消费者, 须在yj_pool_start之前调用
+ * @return 0成功, 负数为YJ_POOL_ERR_*
+ */
+int32_t yj_pool_set_consumer(yj_pool_t* pool, uint32_t port, uint32_t consumer);
+
+/**
+ * @brief 启动工作线程
+ * @return 0成功, 负数为YJ_POOL_ERR_*
+ */
+int32_t yj_pool_start(yj_pool_t* pool);
+
+/**
+ * @brief 停止并回收工作线程, 释放所有资源(未解析的数据被丢弃)
+ */
+void yj_pool_destroy(yj_pool_t* pool);
+
+/* ---- 生产者接口(每个端口同一时刻只能有一个生产者) ---- */
+
+/**
+ * @brief 写入端口收到的原始字节并调度解析, 输入环空间不足时丢弃多余部分
+ * @return 实际写入字节数
+ */
+uint32_t yj_pool_port_write(yj_pool_t* pool, uint32_t port, const uint8_t* data, uint32_t len);
+
+/**
+ * @brief 获取端口输入环的连续可写区域(可直接作为read()的目标缓冲区)
+ * @return 连续可写字节数
+ */
+uint32_t yj_pool_port_write_span(yj_pool_t* pool, uint32_t port, uint8_t** ptr);
+
+/**
+ * @brief 提交写入write_span区域的n个字节并调度解析
+ */
+void yj_pool_port_commit(yj_pool_t* pool, uint32_t port, uint32_t n);
+
+/* ---- 消费者接口(每个消费者同一时刻只能由一个线程调用) ---- */
+
+/**
+ * @brief 取出消费者所属端口的帧并逐帧回调, 端口之间轮流取以免单个端口饿死其他端口
+ * @param max_frames 本次最多回调的帧数, 0表示不限
+ * @return 回调的帧数
+ */
+uint32_t yj_pool_consumer_poll(yj_pool_t* pool, uint32_t consumer,
+                               yj_pool_frame_cb_t cb, void* user, uint32_t max_frames);
+
+/**
+ * @brief 等待消费者有帧可取
+ * @param timeout_ms 超时毫秒数
+ * @return 1有帧可取, 0超时或线程池已停止
+ */
+int32_t yj_pool_consumer_wait(yj_pool_t* pool, uint32_t consumer, uint32_t timeout_ms);
+
+/* ---- 统计 ---- */
+
+uint32_t yj_pool_worker_count(const yj_pool_t* pool);
+void yj_pool_get_port_stats(const yj_pool_t* pool, uint32_t port, yj_pool_port_stats_t* stats);
+void yj_pool_get_worker_stats(const yj_pool_t* pool, uint32_t worker, yj_pool_worker_stats_t* stats);
+
+#endif // YJ_WORKER_POOL_H
@@ -0,0 +1,304 @@
+/**
+ * @file yj_analyze.c
+ * @brief 原始字节流录制的多线程离线分析工具
+ *
+ * 对串口直接转储的原始字节流(可达数GB, 如一整夜的录制)按块并行找帧、校验,
+ * 输出各功能ID的帧数、校验错误率、速率分布(按--bin-ms分片统计帧率)和缺口(相邻帧间隔超过--gap-ms)。
+ * 时间为按--baud换算的线路时间(每字节10位), 从流起点算起。
+ * 分析结果与单线程从头顺序扫描完全相同, 见yj_stream_analyze.h。
+ *
+ * 手动编译(在仓库根目录):
+ *   cc -O2 -pthread -Iprotocol -Iprotocol/host protocol/tools/yj_analyze.c \
+ *      protocol/host/yj_stream_analyze.c protocol/yj_protocol.c -o yj_analyze
+ *
+ * 用法:
+ *   yj_analyze [--crc] [--baud N] [--threads N] [--chunk-mb N] [--bin-ms N] [--gap-ms N]
+ *              [--max-gaps N] [--max-payload N] [--histogram] [--json] dump.bin
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "yj_protocol.h"
+#include "yj_stream_analyze.h"
+
+#define HISTOGRAM_BUCKETS 10
+
+typedef struct {
+    yj_analyze_config_t cfg;
+    int json;
+    int histogram;
+    const char* path;
+} analyze_options_t;
+
+/* 单个功能ID的速率分布 */
+typedef struct {
+    double mean;          // 首末帧之间的平均帧率
+    double min;
+    double p50;
+    double p99;
+    double max;
+    uint32_t buckets[HISTOGRAM_BUCKETS]; // [min, max]等分为若干区间, 各区间内的分片数
+} rate_summary_t;
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int compare_u32(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+/* 内部辅助函数: 由分片帧数计算速率分布 */
+static int rate_summarize(const yj_analyze_func_t* f, uint64_t bin_ns, rate_summary_t* out) {
+    memset(out, 0, sizeof(*out));
+    if (f->frames == 0 || f->bin_count == 0) return 0;
+
+    double bin_s = (double)bin_ns / 1e9;
+    double span_s = (double)(f->last_ns - f->first_ns) / 1e9;
+    out->mean = span_s > 0.0 ? (double)(f->frames - 1) / span_s : 0.0;
+
+    uint32_t* sorted = (uint32_t*)malloc(f->bin_count * sizeof(uint32_t));
+    if (!sorted) return -1;
+    memcpy(sorted, f->bins, f->bin_count * sizeof(uint32_t));
+    qsort(sorted, f->bin_count, sizeof(uint32_t), compare_u32);
+    out->min = sorted[0] / bin_s;
+    out->p50 = sorted[(uint32_t)(0.50 * (f->bin_count - 1) + 0.5)] / bin_s;
+    out->p99 = sorted[(uint32_t)(0.99 * (f->bin_count - 1) + 0.5)] / bin_s;
+    out->max = sorted[f->bin_count - 1] / bin_s;
+    free(sorted);
+
+    uint32_t lo = (uint32_t)(out->min * bin_s + 0.5), hi = (uint32_t)(out->max * bin_s + 0.5);
+    for (uint32_t i = 0; i < f->bin_count; ++i) {
+        uint32_t b = hi > lo ? (uint32_t)((uint64_t)(f->bins[i] - lo) * HISTOGRAM_BUCKETS / (hi - lo + 1)) : 0;
+        out->buckets[b]++;
+    }
+    return 0;
+}
+
+static void print_text(const analyze_options_t* opt, const yj_analyze_result_t* r, double elapsed_s) {
+    double noise = r->total_bytes ? 100.0 * (double)(r->total_bytes - r->frame_bytes) / (double)r->total_bytes : 0.0;
+    uint64_t all_frames = r->frames + r->errors;
+
+    printf("文件:         %s\n", opt->path);
+    printf("字节数:       %llu (线路时长 %.1f s @ %u baud)\n", (unsigned long long)r->total_bytes,
+           (double)r->duration_ns / 1e9, opt->cfg.baud);
+    printf("帧数:         %llu, 校验失败 %llu (%.4f%%), 帧外字节 %.3f%%\n", (unsigned long long)r->frames,
+           (unsigned long long)r->errors, all_frames ? 100.0 * (double)r->errors / (double)all_frames : 0.0,
+           noise);
+    printf("分析耗时:     %.3f s (%.2f GB/s, %u 线程, %u 块, 边界补解析 %u 块, 整块重解析 %u 块)\n",
+           elapsed_s, (double)r->total_bytes / elapsed_s / 1e9, r->threads, r->chunks, r->resynced_chunks,
+           r->reparsed_chunks);
+
+    // 表头按显示宽度手工对齐(中文字符占两列)
+    printf("\n%s\n", "功能ID         帧数   校验失败   错误率%   平均帧/s    p50帧/s   最小帧/s   最大帧/s   缺口数 最大缺口ms");
+    for (uint32_t id = 0; id < YJ_ANALYZE_FUNC_COUNT; ++id) {
+        const yj_analyze_func_t* f = &r->funcs[id];
+        rate_summary_t rate;
+        if (f->frames == 0 && f->errors == 0) continue;
+        if (rate_summarize(f, opt->cfg.bin_ns, &rate) < 0) return;
+        printf("0x%02X %12llu %10llu %9.4f %10.1f %10.1f %10.1f %10.1f %8llu %10.1f\n", id,
+               (unsigned long long)f->frames, (unsigned long long)f->errors,
+               100.0 * (double)f->errors / (double)(f->frames + f->errors), rate.mean, rate.p50, rate.min,
+               rate.max, (unsigned long long)f->gap_count, (double)f->max_gap_ns / 1e6);
+    }
+
+    for (uint32_t id = 0; id < YJ_ANALYZE_FUNC_COUNT; ++id) {
+        const yj_analyze_func_t* f = &r->funcs[id];
+        if (f->gaps_kept == 0) continue;
+        printf("\n功能ID 0x%02X 缺口(共 %llu 个, 列出最早 %u 个):\n", id, (unsigned long long)f->gap_count,
+               f->gaps_kept);
+        for (uint32_t i = 0; i < f->gaps_kept; ++i) {
+            printf("  %12.3f s  长 %10.1f ms  缺口后首帧偏移 %llu\n", (double)f->gaps[i].start_ns / 1e9,
+                   (double)f->gaps[i].length_ns / 1e6, (unsigned long long)f->gaps[i].offset);
+        }
+    }
+
+    if (!opt->histogram) return;
+    for (uint32_t id = 0; id < YJ_ANALYZE_FUNC_COUNT; ++id) {
+        const yj_analyze_func_t* f = &r->funcs[id];
+        rate_summary_t rate;
+        if (f->frames == 0) continue;
+        if (rate_summarize(f, opt->cfg.bin_ns, &rate) < 0) return;
+        printf("\n功能ID 0x%02X 帧率分布(每 %.0f ms 一个分片, 共 %u 个分片):\n", id,
+               (double)opt->cfg.bin_ns / 1e6, f->bin_count);
+        // 区间按分片帧数等分, 与rate_summarize一致
+        double width = (rate.max - rate.min + 1e9 / (double)opt->cfg.bin_ns) / HISTOGRAM_BUCKETS;
+        for (uint32_t b = 0; b < HISTOGRAM_BUCKETS; ++b) {
+            if (rate.buckets[b] == 0) continue;
+            printf("  %10.1f - %10.1f 帧/s: %u\n", rate.min + width * b, rate.min + width * (b + 1),
+                   rate.buckets[b]);
+        }
+    }
+}
+
+static void print_json(const analyze_options_t* opt, const yj_analyze_result_t* r, double elapsed_s) {
+    printf("{\"file\": \"");
+    for (const char* c = opt->path; *c; ++c) {
+        if (*c == '"' || *c == '\\') putchar('\\');
+        putchar(*c);
+    }
+    printf("\", \"bytes\": %llu, \"frame_bytes\": %llu, \"frames\": %llu, \"errors\": %llu, "
+           "\"duration_s\": %.9f, \"baud\": %u, \"bin_ms\": %.3f, \"gap_ms\": %.3f, "
+           "\"threads\": %u, \"chunks\": %u, \"resynced_chunks\": %u, \"reparsed_chunks\": %u, "
+           "\"elapsed_s\": %.6f, \"func_ids\": [",
+           (unsigned long long)r->total_bytes, (unsigned long long)r->frame_bytes,
+           (unsigned long long)r->frames, (unsigned long long)r->errors, (double)r->duration_ns / 1e9,
+           opt->cfg.baud, (double)opt->cfg.bin_ns / 1e6, (double)opt->cfg.gap_ns / 1e6, r->threads, r->chunks,
+           r->resynced_chunks, r->reparsed_chunks, elapsed_s);
+
+    int first = 1;
+    for (uint32_t id = 0; id < YJ_ANALYZE_FUNC_COUNT; ++id) {
+        const yj_analyze_func_t* f = &r->funcs[id];
+        rate_summary_t rate;
+        if (f->frames == 0 && f->errors == 0) continue;
+        if (rate_summarize(f, opt->cfg.bin_ns, &rate) < 0) break;
+        printf("%s\n  {\"func_id\": %u, \"frames\": %llu, \"errors\": %llu, \"bytes\": %llu, "
+               "\"first_s\": %.9f, \"last_s\": %.9f, \"rate\": {\"mean\": %.3f, \"min\": %.3f, \"p50\": %.3f, "
+               "\"p99\": %.3f, \"max\": %.3f, \"histogram\": [",
+               first ? "" : ",", id, (unsigned long long)f->frames, (unsigned long long)f->errors,
+               (unsigned long long)f->bytes, (double)f->first_ns / 1e9, (double)f->last_ns / 1e9, rate.mean,
+               rate.min, rate.p50, rate.p99, rate.max);
+        for (uint32_t b = 0; b < HISTOGRAM_BUCKETS; ++b) printf("%s%u", b ? ", " : "", rate.buckets[b]);
+        printf("]}, \"gap_count\": %llu, \"max_gap_s\": %.9f, \"gaps\": [", (unsigned long long)f->gap_count,
+               (double)f->max_gap_ns / 1e9);
+        for (uint32_t i = 0; i < f->gaps_kept; ++i) {
+            printf("%s{\"start_s\": %.9f, \"length_s\": %.9f, \"offset\": %llu}", i ? ", " : "",
+                   (double)f->gaps[i].start_ns / 1e9, (double)f->gaps[i].length_ns / 1e9,
+                   (unsigned long long)f->gaps[i].offset);
+        }
+        printf("]}");
+        first = 0;
+    }
+    printf("\n]}\n");
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr,
+            "用法: %s [选项] dump.bin\n"
+            "  --crc              使用CRC-16校验模式(默认原始求和/累加)\n"
+            "  --baud N           线路波特率, 用于换算时间(默认%u)\n"
+            "  --threads N        线程数(默认在线CPU数)\n"
+            "  --chunk-mb N       切块大小MB(默认%u)\n"
+            "  --bin-ms N         帧率分片长度毫秒(默认1000)\n"
+            "  --gap-ms N         相邻帧间隔超过该值记为缺口(默认100)\n"
+            "  --max-gaps N       每个功能ID列出的缺口数(默认%u)\n"
+            "  --max-payload N    允许的最大数据长度(默认%u)\n"
+            "  --histogram        打印各功能ID的帧率分布\n"
+            "  --json             以JSON输出\n",
+            prog, YJ_ANALYZE_DEFAULT_BAUD, YJ_ANALYZE_DEFAULT_CHUNK_SIZE >> 20, YJ_ANALYZE_DEFAULT_MAX_GAPS,
+            YJ_MAX_DATA_PAYLOAD_SIZE);
+}
+
+static int parse_args(int argc, char** argv, analyze_options_t* opt) {
+    memset(opt, 0, sizeof(*opt));
+    yj_analyze_default_config(&opt->cfg);
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (strcmp(arg, "--crc") == 0) {
+            opt->cfg.mode = YJ_CHECKSUM_MODE_CRC16;
+        } else if (strcmp(arg, "--json") == 0) {
+            opt->json = 1;
+        } else if (strcmp(arg, "--histogram") == 0) {
+            opt->histogram = 1;
+        } else if (strcmp(arg, "--baud") == 0 && value) {
+            opt->cfg.baud = (uint32_t)strtoul(value, NULL, 10);
+            ++i;
+        } else if (strcmp(arg, "--threads") == 0 && value) {
+            opt->cfg.threads = (uint32_t)strtoul(value, NULL, 10);
+            ++i;
+        } else if (strcmp(arg, "--chunk-mb") == 0 && value) {
+            double mb = atof(value);
+            if (mb <= 0.0 || mb > 2048.0) return -1;
+            opt->cfg.chunk_size = (uint32_t)(mb * 1024.0 * 1024.0);
+            ++i;
+        } else if (strcmp(arg, "--bin-ms") == 0 && value) {
+            opt->cfg.bin_ns = (uint64_t)(atof(value) * 1e6);
+            ++i;
+        } else if (strcmp(arg, "--gap-ms") == 0 && value) {
+            opt->cfg.gap_ns = (uint64_t)(atof(value) * 1e6);
+            ++i;
+        } else if (strcmp(arg, "--max-gaps") == 0 && value) {
+            opt->cfg.max_gaps = (uint32_t)strtoul(value, NULL, 10);
+            ++i;
+        } else if (strcmp(arg, "--max-payload") == 0 && value) {
+            unsigned long max_payload = strtoul(value, NULL, 10);
+            if (max_payload > 0xFFFFu - YJ_FRAME_MIN_OVERHEAD) return -1;
+            opt->cfg.max_payload = (uint16_t)max_payload;
+            ++i;
+        } else if (arg[0] != '-' && !opt->path) {
+            opt->path = arg;
+        } else {
+            return -1;
+        }
+    }
+    if (!opt->path || opt->cfg.baud == 0 || opt->cfg.bin_ns == 0 || opt->cfg.chunk_size == 0) return -1;
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    analyze_options_t opt;
+    yj_analyze_result_t* result;
+
+    if (parse_args(argc, argv, &opt) < 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    int fd = open(opt.path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) < 0) {
+        fprintf(stderr, "无法打开 %s: %s\n", opt.path, strerror(errno));
+        if (fd >= 0) close(fd);
+        return 1;
+    }
+    const uint8_t* data = NULL;
+    uint64_t len = (uint64_t)st.st_size;
+    if (len > 0) {
+        void* map = mmap(NULL, (size_t)len, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map == MAP_FAILED) {
+            fprintf(stderr, "映射 %s 失败: %s\n", opt.path, strerror(errno));
+            close(fd);
+            return 1;
+        }
+        madvise(map, (size_t)len, MADV_WILLNEED);
+        data = (const uint8_t*)map;
+    }
+    close(fd);
+
+    result = (yj_analyze_result_t*)calloc(1, sizeof(yj_analyze_result_t));
+    if (!result) {
+        fprintf(stderr, "内存不足\n");
+        return 1;
+    }
+    uint64_t t0 = monotonic_ns();
+    int32_t ret = yj_analyze_stream(data, len, &opt.cfg, result);
+    double elapsed_s = (double)(monotonic_ns() - t0) / 1e9;
+    if (elapsed_s <= 0.0) elapsed_s = 1e-9;
+
+    if (ret < 0) {
+        fprintf(stderr, "分析失败: %s\n", ret == YJ_ANALYZE_ERR_NOMEM ? "内存不足" : "参数错误");
+    } else if (opt.json) {
+        print_json(&opt, result, elapsed_s);
+    } else {
+        print_text(&opt, result, elapsed_s);
+    }
+
+    yj_analyze_result_free(result);
+    free(result);
+    if (data) munmap((void*)data, (size_t)len);
+    return ret < 0 ? 1 : 0;
+}
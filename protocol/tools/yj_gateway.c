@@ -0,0 +1,728 @@
+/**
+ * @file yj_gateway.c
+ * @brief 多串口无界面网关守护进程
+ *
+ * 一个进程用epoll同时服务N个串口或伪终端: 每个端口一个yj_protocol_handler_t,
+ * 按块read后交给yj_protocol_process_buffer解析, 解出的帧以紧凑二进制记录
+ * (格式见yj_gateway.h)经本地Unix套接字转发给所有客户端; 客户端也可以发送TX记录经指定端口下发帧。
+ * 测试架上16-32块板卡只需要一个网关进程, 而不是每块板一个上位机Python进程。
+ *
+ * 设备断开(read返回EIO/0或EPOLLHUP)后端口进入关闭状态, 网关每秒尝试重新打开;
+ * 客户端接收过慢时丢弃发给它的记录而不是阻塞事件循环, 丢弃数以DROPPED记录告知。
+ * 下发的帧写入端口的发送队列, 串口发送缓冲区满时等EPOLLOUT再续写, 队列放不下的帧计为发送失败。
+ * SIGUSR1打印各端口统计, SIGINT/SIGTERM退出并删除套接字文件; 套接字路径上已有文件时,
+ * 只清理无人监听的遗留套接字, 不是套接字或仍有网关在监听则拒绝启动。
+ *
+ * 手动编译(在仓库根目录):
+ *   cc -O2 -Iprotocol -Iprotocol/host protocol/tools/yj_gateway.c protocol/yj_protocol.c -o yj_gateway
+ *
+ * 用法:
+ *   yj_gateway [--crc] [--baud N] [--socket PATH] [--stats-interval S] /dev/ttyUSB0 /dev/ttyUSB1 ...
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // 用于accept4/SOCK_CLOEXEC
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/timerfd.h>
+#include <sys/un.h>
+
+#include "yj_protocol.h"
+#include "yj_gateway.h"
+
+#define GW_MAX_PORTS        64
+#define GW_MAX_CLIENTS      32
+#define GW_READ_CHUNK       4096  // 每次read的块大小; 每个事件只读一块, 保证端口间公平
+#define GW_TX_QUEUE_SIZE    8192  // 每个端口的发送队列, 可容纳多个最大帧
+
+/* epoll事件标签: 高8位为类型, 低位为索引 */
+#define GW_TAG_LISTEN  (1ull << 56)
+#define GW_TAG_SIGNAL  (2ull << 56)
+#define GW_TAG_TIMER   (3ull << 56)
+#define GW_TAG_PORT    (4ull << 56)
+#define GW_TAG_CLIENT  (5ull << 56)
+#define GW_TAG_MASK    (0xFFull << 56)
+
+typedef struct {
+    const char* path;
+    int      fd;                 // -1表示端口关闭
+    uint8_t  index;
+    yj_protocol_handler_t handler;
+    uint8_t  tx_buf[YJ_MAX_FRAME_SIZE]; // send_byte_func逐字节写入, 组帧完成后移入发送队列
+    uint16_t tx_len;
+    uint8_t  tx_queue[GW_TX_QUEUE_SIZE]; // 尚未写入串口的字节, 从头部开始续写
+    uint32_t tx_queued;
+    uint64_t rx_bytes;
+    uint64_t rx_frames;
+    uint64_t tx_frames;
+    uint64_t tx_errors;
+    uint64_t reopen_count;
+} gw_port_t;
+
+typedef struct {
+    int      fd;                 // -1表示空闲
+    uint64_t dropped;            // 尚未告知客户端的丢弃记录数
+} gw_client_t;
+
+typedef struct {
+    yj_checksum_mode_t mode;
+    speed_t  baud;
+    uint32_t baud_value;
+    const char* socket_path;
+    uint32_t stats_interval_s;
+} gw_options_t;
+
+typedef struct {
+    gw_options_t opt;
+    int epoll_fd;
+    int listen_fd;
+    int signal_fd;
+    int timer_fd;
+    gw_port_t ports[GW_MAX_PORTS];
+    uint32_t port_count;
+    gw_client_t clients[GW_MAX_CLIENTS];
+    uint8_t  out[YJ_GATEWAY_MAX_MESSAGE_SIZE]; // 本轮待发送的记录
+    uint32_t out_len;
+    uint32_t out_records;
+    uint64_t read_ts_ns;         // 当前read块的时间戳
+    uint64_t next_stats_ns;      // 下次打印统计的单调时钟时刻, 0表示不定时打印
+} gw_state_t;
+
+static gw_state_t g_gw;
+
+static uint64_t realtime_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void put_u16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u64(uint8_t* p, uint64_t v) {
+    for (int i = 0; i < 8; ++i) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint16_t get_u16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/* 内部辅助函数: 按数值查找termios波特率常量 */
+static int baud_to_speed(uint32_t baud, speed_t* speed) {
+    switch (baud) {
+        case 9600:    *speed = B9600;    return 0;
+        case 19200:   *speed = B19200;   return 0;
+        case 38400:   *speed = B38400;   return 0;
+        case 57600:   *speed = B57600;   return 0;
+        case 115200:  *speed = B115200;  return 0;
+        case 230400:  *speed = B230400;  return 0;
+#ifdef B460800
+        case 460800:  *speed = B460800;  return 0;
+#endif
+#ifdef B921600
+        case 921600:  *speed = B921600;  return 0;
+#endif
+#ifdef B1000000
+        case 1000000: *speed = B1000000; return 0;
+#endif
+#ifdef B2000000
+        case 2000000: *speed = B2000000; return 0;
+#endif
+#ifdef B3000000
+        case 3000000: *speed = B3000000; return 0;
+#endif
+#ifdef B4000000
+        case 4000000: *speed = B4000000; return 0;
+#endif
+        default: return -1;
+    }
+}
+
+static void send_to_clients(const uint8_t* data, uint32_t len, uint32_t records);
+
+/* 内部辅助函数: 把本轮累积的记录发给所有客户端 */
+static void flush_out(void) {
+    if (g_gw.out_len == 0) return;
+    send_to_clients(g_gw.out, g_gw.out_len, g_gw.out_records);
+    g_gw.out_len = 0;
+    g_gw.out_records = 0;
+}
+
+/* 内部辅助函数: 追加一条记录到发送缓冲区, 放不下时先发出已有内容 */
+static void append_record(uint8_t type, uint8_t port, uint64_t ts_ns, uint8_t s_addr, uint8_t d_addr,
+                          uint8_t func_id, uint8_t flags, const uint8_t* data, uint16_t len) {
+    uint32_t size = YJ_GATEWAY_RECORD_HEADER_SIZE + len;
+    if (g_gw.out_len + size > sizeof(g_gw.out)) {
+        flush_out();
+    }
+    uint8_t* p = g_gw.out + g_gw.out_len;
+    put_u16(p, (uint16_t)size);
+    p[2] = type;
+    p[3] = port;
+    put_u64(p + 4, ts_ns);
+    p[12] = s_addr;
+    p[13] = d_addr;
+    p[14] = func_id;
+    p[15] = flags;
+    if (len > 0) memcpy(p + YJ_GATEWAY_RECORD_HEADER_SIZE, data, len);
+    g_gw.out_len += size;
+    g_gw.out_records++;
+}
+
+static uint8_t port_flags(void) {
+    return g_gw.opt.mode == YJ_CHECKSUM_MODE_CRC16 ? YJ_GATEWAY_FLAG_CRC16 : 0;
+}
+
+static void append_port_status(const gw_port_t* port) {
+    if (port->fd >= 0) {
+        append_record(YJ_GATEWAY_REC_PORT_OPEN, port->index, realtime_ns(), 0, 0, 0, port_flags(),
+                      (const uint8_t*)port->path, (uint16_t)strlen(port->path));
+    } else {
+        append_record(YJ_GATEWAY_REC_PORT_CLOSED, port->index, realtime_ns(), 0, 0, 0, port_flags(), NULL, 0);
+    }
+}
+
+/* 所有端口共用同一对回调, 通过user区分端口 */
+static void on_frame(void* user, yj_frame_t* frame) {
+    gw_port_t* port = (gw_port_t*)user;
+    port->rx_frames++;
+    append_record(YJ_GATEWAY_REC_FRAME, port->index, g_gw.read_ts_ns, frame->s_addr, frame->d_addr,
+                  frame->func_id, port_flags(), frame->data, frame->data_len);
+}
+
+static int32_t port_send_byte(void* user, uint8_t byte) {
+    gw_port_t* port = (gw_port_t*)user;
+    if (port->tx_len >= sizeof(port->tx_buf)) return -1;
+    port->tx_buf[port->tx_len++] = byte;
+    return 0;
+}
+
+/* 内部辅助函数: 打开并配置串口(伪终端同样是tty), 加入epoll */
+static int port_open(gw_port_t* port) {
+    int fd = open(port->path, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    if (isatty(fd)) {
+        struct termios tio;
+        if (tcgetattr(fd, &tio) == 0) {
+            cfmakeraw(&tio);
+            tio.c_cflag |= CLOCAL | CREAD;
+            tio.c_cc[VMIN] = 0;
+            tio.c_cc[VTIME] = 0;
+            cfsetispeed(&tio, g_gw.opt.baud);
+            cfsetospeed(&tio, g_gw.opt.baud);
+            tcsetattr(fd, TCSANOW, &tio);
+        }
+        tcflush(fd, TCIFLUSH);
+    }
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.u64 = GW_TAG_PORT | port->index;
+    if (epoll_ctl(g_gw.epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        close(fd);
+        return -1;
+    }
+    port->fd = fd;
+    port->tx_queued = 0;
+    // 重新打开时丢弃断开前的半帧
+    yj_protocol_init_ex(&port->handler, port_send_byte, on_frame, port, g_gw.opt.mode);
+    append_port_status(port);
+    return 0;
+}
+
+static void port_close(gw_port_t* port, const char* reason) {
+    if (port->fd < 0) return;
+    epoll_ctl(g_gw.epoll_fd, EPOLL_CTL_DEL, port->fd, NULL);
+    close(port->fd);
+    port->fd = -1;
+    port->tx_queued = 0; // 未写出的帧随端口关闭丢弃
+    fprintf(stderr, "端口 %u (%s) 关闭: %s\n", port->index, port->path, reason);
+    append_port_status(port);
+}
+
+static void port_read(gw_port_t* port) {
+    uint8_t buf[GW_READ_CHUNK];
+    ssize_t n = read(port->fd, buf, sizeof(buf));
+    if (n > 0) {
+        port->rx_bytes += (uint64_t)n;
+        g_gw.read_ts_ns = realtime_ns();
+        yj_protocol_process_buffer(&port->handler, buf, (uint32_t)n);
+    } else if (n == 0) {
+        port_close(port, "设备已断开");
+    } else if (errno != EAGAIN && errno != EINTR) {
+        port_close(port, strerror(errno));
+    }
+}
+
+/* 内部辅助函数: 按发送队列是否为空切换端口的EPOLLOUT关注 */
+static void port_watch_output(gw_port_t* port, int enable) {
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = enable ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+    ev.data.u64 = GW_TAG_PORT | port->index;
+    epoll_ctl(g_gw.epoll_fd, EPOLL_CTL_MOD, port->fd, &ev);
+}
+
+/* 内部辅助函数: 非阻塞写出发送队列, 返回0(队列可能未写完)或-1(端口出错, 已关闭) */
+static int port_flush_tx(gw_port_t* port) {
+    uint32_t done = 0;
+    while (done < port->tx_queued) {
+        ssize_t n = write(port->fd, port->tx_queue + done, port->tx_queued - done);
+        if (n > 0) {
+            done += (uint32_t)n;
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && errno == EAGAIN) break;
+        port_close(port, n < 0 ? strerror(errno) : "写入失败");
+        return -1;
+    }
+    if (done > 0) {
+        memmove(port->tx_queue, port->tx_queue + done, port->tx_queued - done);
+        port->tx_queued -= done;
+    }
+    return 0;
+}
+
+static void port_send(gw_port_t* port, uint8_t d_addr, uint8_t func_id, const uint8_t* data, uint16_t len) {
+    if (port->fd < 0) {
+        port->tx_errors++;
+        return;
+    }
+    port->tx_len = 0;
+    int32_t ret = yj_protocol_send_frame(&port->handler, d_addr, func_id, data, len);
+    // 整帧放不下时丢弃该帧, 不把半帧写入串口
+    if (ret != 0 || port->tx_queued + port->tx_len > sizeof(port->tx_queue)) {
+        port->tx_errors++;
+        return;
+    }
+    const int was_idle = port->tx_queued == 0;
+    memcpy(port->tx_queue + port->tx_queued, port->tx_buf, port->tx_len);
+    port->tx_queued += port->tx_len;
+    port->tx_frames++;
+    if (was_idle && port_flush_tx(port) == 0 && port->tx_queued > 0) {
+        port_watch_output(port, 1);
+    }
+}
+
+/* 端口可写: 续写发送队列, 写完后不再关注EPOLLOUT */
+static void port_write_ready(gw_port_t* port) {
+    if (port_flush_tx(port) == 0 && port->tx_queued == 0) {
+        port_watch_output(port, 0);
+    }
+}
+
+static void client_close(gw_client_t* client) {
+    if (client->fd < 0) return;
+    epoll_ctl(g_gw.epoll_fd, EPOLL_CTL_DEL, client->fd, NULL);
+    close(client->fd);
+    client->fd = -1;
+    client->dropped = 0;
+}
+
+/* 内部辅助函数: 非阻塞发送一条消息, 返回1成功, 0对端缓冲区满, -1连接出错 */
+static int client_send(gw_client_t* client, const uint8_t* data, uint32_t len) {
+    ssize_t n = send(client->fd, data, len, MSG_DONTWAIT | MSG_NOSIGNAL);
+    if (n == (ssize_t)len) return 1;
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS)) return 0;
+    return -1;
+}
+
+static void send_to_clients(const uint8_t* data, uint32_t len, uint32_t records) {
+    for (uint32_t i = 0; i < GW_MAX_CLIENTS; ++i) {
+        gw_client_t* client = &g_gw.clients[i];
+        if (client->fd < 0) continue;
+
+        if (client->dropped > 0) {
+            uint8_t note[YJ_GATEWAY_RECORD_HEADER_SIZE + 8];
+            memset(note, 0, sizeof(note));
+            put_u16(note, (uint16_t)sizeof(note));
+            note[2] = YJ_GATEWAY_REC_DROPPED;
+            put_u64(note + 4, realtime_ns());
+            put_u64(note + YJ_GATEWAY_RECORD_HEADER_SIZE, client->dropped);
+            int ret = client_send(client, note, sizeof(note));
+            if (ret < 0) {
+                client_close(client);
+                continue;
+            }
+            if (ret == 0) {
+                client->dropped += records;
+                continue;
+            }
+            client->dropped = 0;
+        }
+
+        int ret = client_send(client, data, len);
+        if (ret < 0) {
+            client_close(client);
+        } else if (ret == 0) {
+            client->dropped += records;
+        }
+    }
+}
+
+static void client_accept(void) {
+    int fd = accept4(g_gw.listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) return;
+
+    uint32_t slot = GW_MAX_CLIENTS;
+    for (uint32_t i = 0; i < GW_MAX_CLIENTS; ++i) {
+        if (g_gw.clients[i].fd < 0) {
+            slot = i;
+            break;
+        }
+    }
+    if (slot == GW_MAX_CLIENTS) {
+        fprintf(stderr, "客户端数已达上限 %u, 拒绝新连接\n", GW_MAX_CLIENTS);
+        close(fd);
+        return;
+    }
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.u64 = GW_TAG_CLIENT | slot;
+    if (epoll_ctl(g_gw.epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        close(fd);
+        return;
+    }
+    gw_client_t* client = &g_gw.clients[slot];
+    client->fd = fd;
+    client->dropped = 0;
+
+    // 先发出已累积的记录, 再单独给新客户端发送所有端口的当前状态
+    flush_out();
+    for (uint32_t i = 0; i < g_gw.port_count; ++i) {
+        append_port_status(&g_gw.ports[i]);
+    }
+    if (client_send(client, g_gw.out, g_gw.out_len) < 0) {
+        client_close(client);
+    }
+    g_gw.out_len = 0;
+    g_gw.out_records = 0;
+}
+
+/* 内部辅助函数: 处理客户端消息中的TX记录 */
+static void client_read(gw_client_t* client) {
+    uint8_t msg[YJ_GATEWAY_MAX_MESSAGE_SIZE];
+    ssize_t n = recv(client->fd, msg, sizeof(msg), MSG_DONTWAIT);
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EINTR)) {
+        client_close(client);
+        return;
+    }
+    uint32_t pos = 0;
+    while (n > 0 && pos + YJ_GATEWAY_RECORD_HEADER_SIZE <= (uint32_t)n) {
+        const uint8_t* rec = msg + pos;
+        uint16_t size = get_u16(rec);
+        if (size < YJ_GATEWAY_RECORD_HEADER_SIZE || pos + size > (uint32_t)n) break; // 格式错误, 丢弃剩余部分
+        if (rec[2] == YJ_GATEWAY_REC_TX && rec[3] < g_gw.port_count) {
+            port_send(&g_gw.ports[rec[3]], rec[13], rec[14], rec + YJ_GATEWAY_RECORD_HEADER_SIZE,
+                      (uint16_t)(size - YJ_GATEWAY_RECORD_HEADER_SIZE));
+        }
+        pos += size;
+    }
+}
+
+static void print_stats(void) {
+    uint32_t clients = 0;
+    for (uint32_t i = 0; i < GW_MAX_CLIENTS; ++i) {
+        if (g_gw.clients[i].fd >= 0) clients++;
+    }
+    fprintf(stderr, "--- 网关统计: %u 个端口, %u 个客户端 ---\n", g_gw.port_count, clients);
+    for (uint32_t i = 0; i < g_gw.port_count; ++i) {
+        const gw_port_t* port = &g_gw.ports[i];
+        fprintf(stderr, "[%2u] %-20s %-6s rx %llu B / %llu 帧, tx %llu 帧 (失败 %llu, 排队 %u B), 重连 %llu\n",
+                port->index, port->path, port->fd >= 0 ? "open" : "closed",
+                (unsigned long long)port->rx_bytes, (unsigned long long)port->rx_frames,
+                (unsigned long long)port->tx_frames, (unsigned long long)port->tx_errors,
+                port->tx_queued, (unsigned long long)port->reopen_count);
+    }
+}
+
+/* 每秒一次: 重新打开已关闭的端口, 到达统计时刻时打印统计 */
+static void on_timer(void) {
+    uint64_t expirations;
+    if (read(g_gw.timer_fd, &expirations, sizeof(expirations)) != sizeof(expirations)) return;
+
+    for (uint32_t i = 0; i < g_gw.port_count; ++i) {
+        gw_port_t* port = &g_gw.ports[i];
+        if (port->fd < 0 && port_open(port) == 0) {
+            port->reopen_count++;
+            fprintf(stderr, "端口 %u (%s) 已重新打开\n", port->index, port->path);
+        }
+    }
+    // 按单调时钟的截止时刻判断, 定时器事件被推迟或合并时也不会漏打
+    const uint64_t now = monotonic_ns();
+    if (g_gw.next_stats_ns != 0 && now >= g_gw.next_stats_ns) {
+        print_stats();
+        const uint64_t interval = (uint64_t)g_gw.opt.stats_interval_s * 1000000000ull;
+        g_gw.next_stats_ns += interval;
+        if (g_gw.next_stats_ns <= now) g_gw.next_stats_ns = now + interval; // 落后多个间隔时只补打一次
+    }
+}
+
+/* 内部辅助函数: 套接字路径已存在时, 仅删除无人监听的遗留套接字; 返回0可以bind, -1拒绝 */
+static int remove_stale_socket(const char* path, const struct sockaddr_un* addr) {
+    struct stat st;
+    if (lstat(path, &st) < 0) {
+        return errno == ENOENT ? 0 : -1;
+    }
+    if (!S_ISSOCK(st.st_mode)) {
+        fprintf(stderr, "%s 已存在且不是套接字, 拒绝覆盖\n", path);
+        errno = EEXIST;
+        return -1;
+    }
+    int probe = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (probe < 0) return -1;
+    int in_use = connect(probe, (const struct sockaddr*)addr, sizeof(*addr)) == 0;
+    int connect_errno = errno;
+    close(probe);
+    if (in_use) {
+        fprintf(stderr, "%s 上已有网关在监听\n", path);
+        errno = EADDRINUSE;
+        return -1;
+    }
+    if (connect_errno != ECONNREFUSED) {
+        errno = connect_errno;
+        return -1;
+    }
+    return unlink(path); // 上次异常退出遗留的套接字文件
+}
+
+static int setup_listen_socket(const char* path) {
+    struct sockaddr_un addr;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "套接字路径过长: %s\n", path);
+        return -1;
+    }
+    int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path);
+    if (remove_stale_socket(path, &addr) < 0) {
+        close(fd);
+        return -1;
+    }
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(fd, GW_MAX_CLIENTS) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static int add_to_epoll(int fd, uint64_t tag) {
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.u64 = tag;
+    return epoll_ctl(g_gw.epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+}
+
+static int setup(void) {
+    g_gw.epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (g_gw.epoll_fd < 0) return -1;
+
+    g_gw.listen_fd = setup_listen_socket(g_gw.opt.socket_path);
+    if (g_gw.listen_fd < 0 || add_to_epoll(g_gw.listen_fd, GW_TAG_LISTEN) < 0) {
+        fprintf(stderr, "无法监听 %s: %s\n", g_gw.opt.socket_path, strerror(errno));
+        return -1;
+    }
+
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    sigaddset(&mask, SIGUSR1);
+    sigprocmask(SIG_BLOCK, &mask, NULL);
+    signal(SIGPIPE, SIG_IGN);
+    g_gw.signal_fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (g_gw.signal_fd < 0 || add_to_epoll(g_gw.signal_fd, GW_TAG_SIGNAL) < 0) return -1;
+
+    g_gw.timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    struct itimerspec its;
+    memset(&its, 0, sizeof(its));
+    its.it_interval.tv_sec = 1;
+    its.it_value.tv_sec = 1;
+    if (g_gw.timer_fd < 0 || timerfd_settime(g_gw.timer_fd, 0, &its, NULL) < 0 ||
+        add_to_epoll(g_gw.timer_fd, GW_TAG_TIMER) < 0) {
+        return -1;
+    }
+    if (g_gw.opt.stats_interval_s > 0) {
+        g_gw.next_stats_ns = monotonic_ns() + (uint64_t)g_gw.opt.stats_interval_s * 1000000000ull;
+    }
+
+    for (uint32_t i = 0; i < g_gw.port_count; ++i) {
+        gw_port_t* port = &g_gw.ports[i];
+        if (port_open(port) < 0) {
+            fprintf(stderr, "端口 %u (%s) 打开失败: %s, 稍后重试\n", i, port->path, strerror(errno));
+        }
+    }
+    g_gw.out_len = 0; // 启动时还没有客户端
+    g_gw.out_records = 0;
+    return 0;
+}
+
+static void run(void) {
+    struct epoll_event events[GW_MAX_PORTS + GW_MAX_CLIENTS + 3];
+    int running = 1;
+
+    while (running) {
+        int n = epoll_wait(g_gw.epoll_fd, events, (int)(sizeof(events) / sizeof(events[0])), -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            fprintf(stderr, "epoll_wait失败: %s\n", strerror(errno));
+            break;
+        }
+        for (int i = 0; i < n; ++i) {
+            uint64_t tag = events[i].data.u64 & GW_TAG_MASK;
+            uint32_t index = (uint32_t)(events[i].data.u64 & ~GW_TAG_MASK);
+
+            if (tag == GW_TAG_PORT) {
+                gw_port_t* port = &g_gw.ports[index];
+                if (port->fd < 0) continue; // 本轮已被关闭
+                if (events[i].events & EPOLLOUT) {
+                    port_write_ready(port);
+                    if (port->fd < 0) continue;
+                }
+                if (events[i].events & EPOLLIN) {
+                    port_read(port);
+                } else if (events[i].events & (EPOLLHUP | EPOLLERR)) {
+                    port_close(port, "挂断");
+                }
+            } else if (tag == GW_TAG_CLIENT) {
+                gw_client_t* client = &g_gw.clients[index];
+                if (client->fd < 0) continue;
+                if (events[i].events & EPOLLIN) {
+                    client_read(client);
+                } else if (events[i].events & (EPOLLHUP | EPOLLERR)) {
+                    client_close(client);
+                }
+            } else if (tag == GW_TAG_LISTEN) {
+                client_accept();
+            } else if (tag == GW_TAG_TIMER) {
+                on_timer();
+            } else if (tag == GW_TAG_SIGNAL) {
+                struct signalfd_siginfo info;
+                while (read(g_gw.signal_fd, &info, sizeof(info)) == sizeof(info)) {
+                    if (info.ssi_signo == SIGUSR1) {
+                        print_stats();
+                    } else {
+                        running = 0;
+                    }
+                }
+            }
+        }
+        // 每轮事件合并发送一次, 多个端口同时有数据时减少系统调用次数
+        flush_out();
+    }
+}
+
+static void cleanup(void) {
+    for (uint32_t i = 0; i < g_gw.port_count; ++i) {
+        if (g_gw.ports[i].fd >= 0) close(g_gw.ports[i].fd);
+    }
+    for (uint32_t i = 0; i < GW_MAX_CLIENTS; ++i) {
+        if (g_gw.clients[i].fd >= 0) close(g_gw.clients[i].fd);
+    }
+    if (g_gw.listen_fd >= 0) {
+        close(g_gw.listen_fd);
+        unlink(g_gw.opt.socket_path);
+    }
+    if (g_gw.signal_fd >= 0) close(g_gw.signal_fd);
+    if (g_gw.timer_fd >= 0) close(g_gw.timer_fd);
+    if (g_gw.epoll_fd >= 0) close(g_gw.epoll_fd);
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr,
+            "用法: %s [选项] 设备1 [设备2 ...]\n"
+            "  --crc                使用CRC-16校验模式(默认原始求和/累加)\n"
+            "  --baud N             串口波特率(默认115200; 对伪终端无影响)\n"
+            "  --socket PATH        Unix套接字路径(默认%s)\n"
+            "  --stats-interval S   每S秒在stderr打印统计(默认0不打印, 也可发送SIGUSR1)\n"
+            "最多 %d 个设备, 端口号按命令行顺序从0开始编号\n",
+            prog, YJ_GATEWAY_DEFAULT_SOCKET, GW_MAX_PORTS);
+}
+
+static int parse_args(int argc, char** argv) {
+    gw_options_t* opt = &g_gw.opt;
+    opt->mode = YJ_CHECKSUM_MODE_ORIGINAL;
+    opt->baud_value = 115200;
+    opt->socket_path = YJ_GATEWAY_DEFAULT_SOCKET;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (strcmp(arg, "--crc") == 0) {
+            opt->mode = YJ_CHECKSUM_MODE_CRC16;
+        } else if (strcmp(arg, "--baud") == 0 && value) {
+            opt->baud_value = (uint32_t)strtoul(value, NULL, 10);
+            ++i;
+        } else if (strcmp(arg, "--socket") == 0 && value) {
+            opt->socket_path = value;
+            ++i;
+        } else if (strcmp(arg, "--stats-interval") == 0 && value) {
+            opt->stats_interval_s = (uint32_t)strtoul(value, NULL, 10);
+            ++i;
+        } else if (arg[0] != '-' && g_gw.port_count < GW_MAX_PORTS) {
+            gw_port_t* port = &g_gw.ports[g_gw.port_count];
+            port->path = arg;
+            port->fd = -1;
+            port->index = (uint8_t)g_gw.port_count;
+            g_gw.port_count++;
+        } else {
+            return -1;
+        }
+    }
+    if (g_gw.port_count == 0) return -1;
+    if (baud_to_speed(opt->baud_value, &opt->baud) < 0) {
+        fprintf(stderr, "不支持的波特率: %u\n", opt->baud_value);
+        return -1;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    memset(&g_gw, 0, sizeof(g_gw));
+    g_gw.epoll_fd = g_gw.listen_fd = g_gw.signal_fd = g_gw.timer_fd = -1;
+    for (uint32_t i = 0; i < GW_MAX_CLIENTS; ++i) g_gw.clients[i].fd = -1;
+
+    if (parse_args(argc, argv) < 0) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (setup() < 0) {
+        cleanup();
+        return 1;
+    }
+    fprintf(stderr, "yj_gateway: %u 个端口, 套接字 %s\n", g_gw.port_count, g_gw.opt.socket_path);
+    run();
+    print_stats();
+    cleanup();
+    return 0;
+}
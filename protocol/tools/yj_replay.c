@@ -0,0 +1,330 @@
+/**
+ * @file yj_replay.c
+ * @brief 录制文件(.yjcap)回放工具
+ *
+ * 把DataRecorder录制的现场数据(含帧间噪声和校验失败的帧)按原始顺序重新送入C协议核心,
+ * 用于对比解析器改动前后的吞吐, 以及复现现场的吞吐问题。两种输出方式:
+ *   - 默认: 直接送入yj_protocol_process_buffer, 统计帧率和每帧解析延迟;
+ *   - --pty: 创建伪终端, 把数据写到主端, 上位机或其他程序打开从端即可接收。
+ * 回放速度: --speed 1按原始时间间隔, --speed 10为10倍速, --speed 0(默认)不等待、尽快回放。
+ *
+ * 手动编译(在仓库根目录):
+ *   cc -O2 -Iprotocol -Iprotocol/host protocol/tools/yj_replay.c \
+ *      protocol/host/yj_capture.c protocol/yj_protocol.c -o yj_replay
+ *
+ * 用法:
+ *   yj_replay [--crc] [--speed N] [--direction rx|tx|all] [--loops N] [--pty] [--pty-wait MS] capture.yjcap
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // 用于posix_openpt/ptsname
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "yj_protocol.h"
+#include "yj_capture.h"
+
+#define DIRECTION_ALL 0xFF
+
+typedef struct {
+    yj_checksum_mode_t mode;
+    double   speed;           // 0表示尽快回放
+    uint8_t  direction;       // YJ_CAPTURE_DIR_RX/TX或DIRECTION_ALL
+    uint32_t loops;
+    int      use_pty;
+    uint32_t pty_wait_ms;     // 创建伪终端后等待对端打开(以及结束后等待对端读完)的时间
+    const char* path;
+} replay_options_t;
+
+typedef struct {
+    uint64_t records;         // 回放的记录数
+    uint64_t bytes;           // 回放的字节数
+    uint64_t capture_frames;  // 录制时判定为校验通过的帧数
+    uint64_t parsed_frames;   // 回放时协议核心交付的帧数
+    uint64_t elapsed_ns;      // 回放总耗时
+    uint64_t* latency_ns;     // 每帧解析延迟样本
+    uint64_t latency_count;
+    uint64_t latency_capacity;
+} replay_stats_t;
+
+/* user指向本次process_buffer调用的帧计数 */
+static void on_frame(void* user, yj_frame_t* frame) {
+    (void)frame;
+    (*(uint64_t*)user)++;
+}
+
+static int32_t discard_byte(void* user, uint8_t byte) {
+    (void)user;
+    (void)byte;
+    return 0;
+}
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void sleep_until_ns(uint64_t deadline_ns) {
+    struct timespec ts;
+    ts.tv_sec = (time_t)(deadline_ns / 1000000000ull);
+    ts.tv_nsec = (long)(deadline_ns % 1000000000ull);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+}
+
+static int add_latency_sample(replay_stats_t* stats, uint64_t ns) {
+    if (stats->latency_count == stats->latency_capacity) {
+        uint64_t capacity = stats->latency_capacity ? stats->latency_capacity * 2 : 65536;
+        uint64_t* samples = (uint64_t*)realloc(stats->latency_ns, capacity * sizeof(uint64_t));
+        if (!samples) return -1;
+        stats->latency_ns = samples;
+        stats->latency_capacity = capacity;
+    }
+    stats->latency_ns[stats->latency_count++] = ns;
+    return 0;
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static uint64_t percentile(const uint64_t* sorted, uint64_t count, double p) {
+    if (count == 0) return 0;
+    uint64_t idx = (uint64_t)(p * (double)(count - 1) + 0.5);
+    return sorted[idx];
+}
+
+/* 内部辅助函数: 完整写出len字节(伪终端缓冲区满时阻塞) */
+static int write_all(int fd, const uint8_t* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, data, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+/* 内部辅助函数: 创建原始模式的伪终端, 返回主端fd */
+static int open_pty(char* slave_name, size_t name_size) {
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0) return -1;
+    if (grantpt(master) < 0 || unlockpt(master) < 0) {
+        close(master);
+        return -1;
+    }
+    const char* name = ptsname(master);
+    if (!name) {
+        close(master);
+        return -1;
+    }
+    snprintf(slave_name, name_size, "%s", name);
+
+    // 从端设为原始模式, 避免行规程改写0x0D/0x11等字节
+    int slave = open(slave_name, O_RDWR | O_NOCTTY);
+    if (slave >= 0) {
+        struct termios tio;
+        if (tcgetattr(slave, &tio) == 0) {
+            cfmakeraw(&tio);
+            tcsetattr(slave, TCSANOW, &tio);
+        }
+        close(slave);
+    }
+    return master;
+}
+
+static int replay_once(const replay_options_t* opt, const yj_capture_reader_t* reader,
+                       yj_protocol_handler_t* handler, uint64_t* frames_in_call, int pty_fd,
+                       replay_stats_t* stats) {
+    yj_capture_record_t record;
+    uint64_t offset = YJ_CAPTURE_FILE_HEADER_SIZE;
+    uint64_t first_ts = 0;
+    uint64_t start_ns = monotonic_ns();
+    int first = 1;
+    int32_t ret;
+
+    while ((ret = yj_capture_reader_next(reader, &offset, &record)) == 1) {
+        if (opt->direction != DIRECTION_ALL && record.direction != opt->direction) continue;
+
+        if (first) {
+            first_ts = record.ts_ns;
+            first = 0;
+        }
+        if (opt->speed > 0.0 && record.ts_ns > first_ts) {
+            sleep_until_ns(start_ns + (uint64_t)((double)(record.ts_ns - first_ts) / opt->speed));
+        }
+
+        stats->records++;
+        stats->bytes += record.len;
+        if (record.status == YJ_CAPTURE_STATUS_OK) stats->capture_frames++;
+
+        if (pty_fd >= 0) {
+            if (write_all(pty_fd, record.data, record.len) < 0) {
+                fprintf(stderr, "写入伪终端失败: %s\n", strerror(errno));
+                return -1;
+            }
+            continue;
+        }
+
+        *frames_in_call = 0;
+        uint64_t t0 = monotonic_ns();
+        yj_protocol_process_buffer(handler, record.data, record.len);
+        uint64_t dt = monotonic_ns() - t0;
+        if (*frames_in_call > 0) {
+            stats->parsed_frames += *frames_in_call;
+            // 一条记录通常就是一帧; 含多帧时按帧平均
+            if (add_latency_sample(stats, dt / *frames_in_call) < 0) {
+                fprintf(stderr, "内存不足\n");
+                return -1;
+            }
+        }
+    }
+    if (ret < 0) {
+        fprintf(stderr, "警告: 偏移 %llu 处记录损坏, 回放到此为止\n", (unsigned long long)offset);
+    }
+    stats->elapsed_ns += monotonic_ns() - start_ns;
+    return 0;
+}
+
+static void print_report(const replay_options_t* opt, replay_stats_t* stats) {
+    double seconds = (double)stats->elapsed_ns / 1e9;
+    if (seconds <= 0.0) seconds = 1e-9;
+
+    printf("回放文件:     %s\n", opt->path);
+    printf("记录数:       %llu\n", (unsigned long long)stats->records);
+    printf("字节数:       %llu\n", (unsigned long long)stats->bytes);
+    printf("耗时:         %.3f s\n", seconds);
+    printf("吞吐:         %.2f MB/s\n", (double)stats->bytes / seconds / 1e6);
+    if (opt->use_pty) {
+        printf("写出帧数:     %llu (%.0f 帧/s)\n", (unsigned long long)stats->capture_frames,
+               (double)stats->capture_frames / seconds);
+        return;
+    }
+    printf("解析帧数:     %llu (录制时校验通过 %llu)\n", (unsigned long long)stats->parsed_frames,
+           (unsigned long long)stats->capture_frames);
+    printf("帧率:         %.0f 帧/s\n", (double)stats->parsed_frames / seconds);
+    if (stats->latency_count > 0) {
+        qsort(stats->latency_ns, stats->latency_count, sizeof(uint64_t), compare_u64);
+        printf("每帧解析延迟: p50 %llu ns, p99 %llu ns, p99.9 %llu ns, max %llu ns\n",
+               (unsigned long long)percentile(stats->latency_ns, stats->latency_count, 0.50),
+               (unsigned long long)percentile(stats->latency_ns, stats->latency_count, 0.99),
+               (unsigned long long)percentile(stats->latency_ns, stats->latency_count, 0.999),
+               (unsigned long long)stats->latency_ns[stats->latency_count - 1]);
+    }
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr,
+            "用法: %s [选项] capture.yjcap\n"
+            "  --crc              使用CRC-16校验模式(默认原始求和/累加)\n"
+            "  --speed N          回放速度倍数, 1为原始速度, 0为尽快回放(默认)\n"
+            "  --direction D      回放方向: rx(默认)/tx/all\n"
+            "  --loops N          重复回放次数(默认1)\n"
+            "  --pty              写到新建的伪终端, 而不是直接解析\n"
+            "  --pty-wait MS      创建伪终端后等待对端打开、结束后等待对端读完的毫秒数(默认3000)\n",
+            prog);
+}
+
+static int parse_args(int argc, char** argv, replay_options_t* opt) {
+    memset(opt, 0, sizeof(*opt));
+    opt->mode = YJ_CHECKSUM_MODE_ORIGINAL;
+    opt->direction = YJ_CAPTURE_DIR_RX;
+    opt->loops = 1;
+    opt->pty_wait_ms = 3000;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (strcmp(arg, "--crc") == 0) {
+            opt->mode = YJ_CHECKSUM_MODE_CRC16;
+        } else if (strcmp(arg, "--pty") == 0) {
+            opt->use_pty = 1;
+        } else if (strcmp(arg, "--speed") == 0 && value) {
+            opt->speed = atof(value);
+            ++i;
+        } else if (strcmp(arg, "--loops") == 0 && value) {
+            opt->loops = (uint32_t)strtoul(value, NULL, 10);
+            ++i;
+        } else if (strcmp(arg, "--pty-wait") == 0 && value) {
+            opt->pty_wait_ms = (uint32_t)strtoul(value, NULL, 10);
+            ++i;
+        } else if (strcmp(arg, "--direction") == 0 && value) {
+            if (strcmp(value, "rx") == 0) opt->direction = YJ_CAPTURE_DIR_RX;
+            else if (strcmp(value, "tx") == 0) opt->direction = YJ_CAPTURE_DIR_TX;
+            else if (strcmp(value, "all") == 0) opt->direction = DIRECTION_ALL;
+            else return -1;
+            ++i;
+        } else if (arg[0] != '-' && !opt->path) {
+            opt->path = arg;
+        } else {
+            return -1;
+        }
+    }
+    if (!opt->path || opt->speed < 0.0 || opt->loops == 0) return -1;
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    replay_options_t opt;
+    replay_stats_t stats;
+    yj_capture_reader_t reader;
+    yj_protocol_handler_t handler;
+    uint64_t frames_in_call = 0;
+    int pty_fd = -1;
+    int result = 0;
+
+    if (parse_args(argc, argv, &opt) < 0) {
+        usage(argv[0]);
+        return 2;
+    }
+    int32_t ret = yj_capture_reader_open(&reader, opt.path);
+    if (ret < 0) {
+        fprintf(stderr, "无法打开录制文件 %s: %s\n", opt.path,
+                ret == -2 ? "文件格式错误" : strerror(errno));
+        return 1;
+    }
+    memset(&stats, 0, sizeof(stats));
+    yj_protocol_init_ex(&handler, discard_byte, on_frame, &frames_in_call, opt.mode);
+
+    if (opt.use_pty) {
+        char slave_name[128];
+        pty_fd = open_pty(slave_name, sizeof(slave_name));
+        if (pty_fd < 0) {
+            fprintf(stderr, "创建伪终端失败: %s\n", strerror(errno));
+            yj_capture_reader_close(&reader);
+            return 1;
+        }
+        fprintf(stderr, "伪终端从端: %s (等待 %u ms)\n", slave_name, opt.pty_wait_ms);
+        usleep((useconds_t)opt.pty_wait_ms * 1000u);
+    }
+
+    for (uint32_t loop = 0; loop < opt.loops && result == 0; ++loop) {
+        result = replay_once(&opt, &reader, &handler, &frames_in_call, pty_fd, &stats);
+    }
+    if (result == 0) {
+        print_report(&opt, &stats);
+    }
+
+    if (pty_fd >= 0) {
+        // 主端关闭后从端未读完的数据会被丢弃, 同样等待一段时间再关闭
+        usleep((useconds_t)opt.pty_wait_ms * 1000u);
+        close(pty_fd);
+    }
+    free(stats.latency_ns);
+    yj_capture_reader_close(&reader);
+    return result == 0 ? 0 : 1;
+}
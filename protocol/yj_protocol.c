@@ -19,11 +19,9 @@ static void calculate_original_checksums_internal(const uint8_t* frame_part_data
 // 初始值: 0xFFFF
 // 无输入反射, 无输出反射, 无最终XOR
 static uint16_t crc16_ccitt_false_update(uint16_t crc, uint8_t data) {
-    data ^= (uint8_t)(crc >> 8); // 使用CRC的高字节处理
-    data ^= data >> 4;
-    data ^= data >> 2;
-    data ^= data >> 1;
-    crc = (crc << 8) ^ ((uint16_t)data << 15) ^ ((uint16_t)data << 4) ^ ((uint16_t)data);
+    uint8_t x = (uint8_t)(crc >> 8) ^ data; // 使用CRC的高字节处理
+    x ^= x >> 4;
+    crc = (uint16_t)((crc << 8) ^ ((uint16_t)x << 12) ^ ((uint16_t)x << 5) ^ (uint16_t)x);
     return crc;
 }
 
@@ -63,6 +61,30 @@ void yj_protocol_init(yj_protocol_handler_t* handler,
         (mode == YJ_CHECKSUM_MODE_CRC16) ? "CRC-16" : "原始求和/累加");
 }
 
+/**
+ * @brief 初始化协议处理器(回调携带用户上下文)
+ */
+void yj_protocol_init_ex(yj_protocol_handler_t* handler,
+                         yj_send_byte_ex_func_t send_byte_impl,
+                         yj_frame_received_ex_cb_t frame_received_cb,
+                         void* user,
+                         yj_checksum_mode_t mode) {
+    if (!handler || !send_byte_impl || !frame_received_cb) {
+        YJ_DEBUG_LOG("错误: yj_protocol_init_ex中的空指针\n");
+        return;
+    }
+    memset(handler, 0, sizeof(yj_protocol_handler_t));
+
+    handler->send_byte_ex_func = send_byte_impl;
+    handler->frame_received_ex_callback = frame_received_cb;
+    handler->user = user;
+    handler->rx_state = YJ_RX_STATE_WAIT_HEAD;
+    handler->active_checksum_mode = mode;
+
+    YJ_DEBUG_LOG("YJ协议初始化完成(带上下文). 模式: %s\n",
+        (mode == YJ_CHECKSUM_MODE_CRC16) ? "CRC-16" : "原始求和/累加");
+}
+
 /**
  * @brief 发送数据帧
  */
@@ -71,7 +93,7 @@ int32_t yj_protocol_send_frame(yj_protocol_handler_t* handler,
                                uint8_t func_id,
                                const uint8_t* data,
                                uint16_t data_len) {
-    if (!handler || !handler->send_byte_func) {
+    if (!handler || (!handler->send_byte_func && !handler->send_byte_ex_func)) {
         YJ_DEBUG_LOG("错误: 处理器或send_byte_func未初始化\n");
         return -1;
     }
@@ -116,12 +138,24 @@ int32_t yj_protocol_send_frame(yj_protocol_handler_t* handler,
 
     // 5. 发送帧
     YJ_DEBUG_LOG("(共 %u 字节)\n", current_idx);
-    for (uint16_t i = 0; i < current_idx; ++i) {
-        if (handler->send_byte_func(frame_buffer[i]) != 0) {
-            YJ_DEBUG_LOG("错误: 发送字节 %u 失败\n", i);
-            return -3;
+    if (handler->send_byte_ex_func) {
+        for (uint16_t i = 0; i < current_idx; ++i) {
+            if (handler->send_byte_ex_func(handler->user, frame_buffer[i]) != 0) {
+                YJ_DEBUG_LOG("错误: 发送字节 %u 失败\n", i);
+                return -3;
+            }
+        }
+    } else {
+        for (uint16_t i = 0; i < current_idx; ++i) {
+            if (handler->send_byte_func(frame_buffer[i]) != 0) {
+                YJ_DEBUG_LOG("错误: 发送字节 %u 失败\n", i);
+                return -3;
+            }
         }
     }
+#if YJ_ENABLE_STATS
+    handler->stats_tx_frames++;
+#endif
     return 0; // 成功
 }
 
@@ -203,6 +237,9 @@ void yj_protocol_process_byte(yj_protocol_handler_t* handler, uint8_t byte_recei
             if (handler->current_rx_frame.data_len > YJ_MAX_DATA_PAYLOAD_SIZE) {
                 YJ_DEBUG_LOG("接收错误: 数据长度 %u 超过最大值 %u. 重置状态.\n",
                              handler->current_rx_frame.data_len, YJ_MAX_DATA_PAYLOAD_SIZE);
+#if YJ_ENABLE_STATS
+                handler->stats_rx_errors++;
+#endif
                 handler->rx_state = YJ_RX_STATE_WAIT_HEAD;
             } else if (handler->current_rx_frame.data_len == 0) {
                 handler->rx_state = YJ_RX_STATE_WAIT_CHECKSUM_BYTE1; // 无数据,直接跳转到校验和
@@ -261,10 +298,20 @@ void yj_protocol_process_byte(yj_protocol_handler_t* handler, uint8_t byte_recei
             if (is_checksum_valid) {
                 YJ_DEBUG_LOG("接收帧校验成功(模式:%d). 功能ID:0x%02X, 长度:%u\n",
                              handler->active_checksum_mode, handler->current_rx_frame.func_id, handler->current_rx_frame.data_len);
-                if (handler->frame_received_callback) {
+#if YJ_ENABLE_STATS
+                handler->stats_rx_frames++;
+#endif
+                if (handler->frame_received_ex_callback) {
+                    handler->frame_received_ex_callback(handler->user, &(handler->current_rx_frame));
+                } else if (handler->frame_received_callback) {
                     handler->frame_received_callback(&(handler->current_rx_frame));
                 }
             }
+#if YJ_ENABLE_STATS
+            else {
+                handler->stats_rx_errors++;
+            }
+#endif
             handler->rx_state = YJ_RX_STATE_WAIT_HEAD; // 重置状态等待下一帧
             break;
 
@@ -274,6 +321,16 @@ void yj_protocol_process_byte(yj_protocol_handler_t* handler, uint8_t byte_recei
     }
 }
 
+/**
+ * @brief 处理一整块接收数据
+ */
+void yj_protocol_process_buffer(yj_protocol_handler_t* handler, const uint8_t* data, uint32_t len) {
+    if (!handler || !data) return;
+    for (uint32_t i = 0; i < len; ++i) {
+        yj_protocol_process_byte(handler, data[i]);
+    }
+}
+
 /**
  * @brief 向接收环形缓冲区添加字节
  */
@@ -305,6 +362,98 @@ void yj_protocol_tick(yj_protocol_handler_t* handler) {
     }
 }
 
+/**
+ * @brief 扫描整块接收数据, 一次性找出其中所有完整帧
+ */
+uint32_t yj_protocol_scan_buffer(const uint8_t* data, uint32_t len,
+                                 yj_checksum_mode_t mode, uint8_t head_byte, uint16_t max_payload,
+                                 yj_frame_span_t* spans, uint32_t max_spans, uint32_t* consumed) {
+    uint32_t pos = 0;
+    uint32_t frame_count = 0;
+
+    if (!data || !spans) {
+        if (consumed) *consumed = 0;
+        return 0;
+    }
+    // span->length为16位, 整帧长度不能超过0xFFFF
+    if (max_payload > UINT16_MAX - YJ_FRAME_MIN_OVERHEAD) {
+        max_payload = UINT16_MAX - YJ_FRAME_MIN_OVERHEAD;
+    }
+
+    while (pos < len && frame_count < max_spans) {
+        // 1. 查找帧头(memchr通常由C库向量化实现)
+        const uint8_t* head = (const uint8_t*)memchr(&data[pos], head_byte, len - pos);
+        if (!head) {
+            pos = len; // 剩余数据中没有帧头, 全部丢弃
+            break;
+        }
+        pos = (uint32_t)(head - data);
+
+        // 2. 帧头部分不完整, 等待更多数据
+        uint32_t remaining = len - pos;
+        if (remaining < YJ_FRAME_HEADER_SIZE) {
+            break;
+        }
+
+        // 3. 数据长度检查
+        uint16_t data_len = (uint16_t)(head[YJ_FRAME_OFFSET_LEN_LOW] |
+                                       ((uint16_t)head[YJ_FRAME_OFFSET_LEN_HIGH] << 8));
+        if (data_len > max_payload) {
+            YJ_DEBUG_LOG("扫描: 偏移 %lu 处数据长度 %u 超限, 重新同步\n", (unsigned long)pos, data_len);
+            pos++; // 伪帧头, 从下一字节重新查找
+            continue;
+        }
+
+        uint32_t frame_len = (uint32_t)YJ_FRAME_MIN_OVERHEAD + data_len;
+        if (remaining < frame_len) {
+            break; // 帧不完整, 等待更多数据
+        }
+
+        // 4. 校验
+        uint16_t checked_len = (uint16_t)(YJ_FRAME_HEADER_SIZE + data_len);
+        const uint8_t* checksum_field = &head[checked_len];
+        uint8_t checksum_ok;
+        if (mode == YJ_CHECKSUM_MODE_CRC16) {
+            uint16_t received_crc = ((uint16_t)checksum_field[0] << 8) | checksum_field[1];
+            checksum_ok = (calculate_crc16_internal(head, checked_len) == received_crc);
+        } else {
+            uint8_t sc, ac;
+            calculate_original_checksums_internal(head, checked_len, &sc, &ac);
+            checksum_ok = (sc == checksum_field[0] && ac == checksum_field[1]);
+        }
+
+        yj_frame_span_t* span = &spans[frame_count++];
+        span->offset = pos;
+        span->length = (uint16_t)frame_len;
+        span->s_addr = head[YJ_FRAME_OFFSET_SADDR];
+        span->d_addr = head[YJ_FRAME_OFFSET_DADDR];
+        span->func_id = head[YJ_FRAME_OFFSET_FUNC_ID];
+        span->checksum_ok = checksum_ok;
+
+        pos += frame_len;
+    }
+
+    if (consumed) *consumed = pos;
+    return frame_count;
+}
+
+/* 校验计算函数 */
+
+/**
+ * @brief 计算原始求和/累加校验
+ */
+void yj_calc_original_checksums(const uint8_t* data, uint16_t length,
+                                uint8_t* sum_check_out, uint8_t* add_check_out) {
+    calculate_original_checksums_internal(data, length, sum_check_out, add_check_out);
+}
+
+/**
+ * @brief 计算CRC-16/CCITT-FALSE
+ */
+uint16_t yj_calc_crc16(const uint8_t* data, uint16_t length) {
+    return calculate_crc16_internal(data, length);
+}
+
 /* 数据打包/解包辅助函数(小端字节序) */
 
 /**
@@ -399,4 +548,224 @@ float yj_unpack_float_le(const uint8_t* buffer) {
     } converter;
     converter.u = yj_unpack_u32_le(buffer);
     return converter.f;
-}
\ No newline at end of file
+}
+
+/* 变长整数编码辅助函数(LEB128 varint / ZigZag) */
+
+/**
+ * @brief ZigZag编码
+ */
+uint32_t yj_zigzag_encode_i32(int32_t value) {
+    // 算术右移得到全0或全1的符号掩码
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+/**
+ * @brief ZigZag解码
+ */
+int32_t yj_zigzag_decode_u32(uint32_t value) {
+    return (int32_t)((value >> 1) ^ (0U - (value & 1U)));
+}
+
+/**
+ * @brief 打包32位无符号varint
+ */
+uint8_t yj_pack_varint_u32(uint8_t* buffer, uint32_t value) {
+    uint8_t n = 0;
+    while (value >= 0x80U) {
+        buffer[n++] = (uint8_t)(value | 0x80U);
+        value >>= 7;
+    }
+    buffer[n++] = (uint8_t)value;
+    return n;
+}
+
+/**
+ * @brief 解包32位无符号varint
+ */
+uint8_t yj_unpack_varint_u32(const uint8_t* buffer, uint16_t len, uint32_t* value) {
+    // 快速路径: 绝大多数计数值只占1字节
+    if (len > 0 && buffer[0] < 0x80U) {
+        *value = buffer[0];
+        return 1;
+    }
+
+    uint32_t result = 0;
+    uint8_t max_bytes = (len < YJ_VARINT32_MAX_BYTES) ? (uint8_t)len : YJ_VARINT32_MAX_BYTES;
+    for (uint8_t i = 0; i < max_bytes; ++i) {
+        uint8_t byte = buffer[i];
+        result |= (uint32_t)(byte & 0x7FU) << (7 * i);
+        if ((byte & 0x80U) == 0) {
+            // 第5字节只允许携带高4位
+            if (i == YJ_VARINT32_MAX_BYTES - 1 && byte > 0x0FU) {
+                return 0;
+            }
+            *value = result;
+            return (uint8_t)(i + 1);
+        }
+    }
+    return 0; // 数据不完整或超过5字节
+}
+
+/**
+ * @brief 打包32位有符号varint(ZigZag)
+ */
+uint8_t yj_pack_varint_i32(uint8_t* buffer, int32_t value) {
+    return yj_pack_varint_u32(buffer, yj_zigzag_encode_i32(value));
+}
+
+/**
+ * @brief 解包32位有符号varint(ZigZag)
+ */
+uint8_t yj_unpack_varint_i32(const uint8_t* buffer, uint16_t len, int32_t* value) {
+    uint32_t raw;
+    uint8_t n = yj_unpack_varint_u32(buffer, len, &raw);
+    if (n) {
+        *value = yj_zigzag_decode_u32(raw);
+    }
+    return n;
+}
+
+/* 内部辅助函数: 写入一个varint并检查剩余空间 */
+static uint8_t pack_varint_checked(uint8_t* buffer, uint16_t remaining, uint32_t value) {
+    uint8_t tmp[YJ_VARINT32_MAX_BYTES];
+    if (remaining >= YJ_VARINT32_MAX_BYTES) {
+        return yj_pack_varint_u32(buffer, value);
+    }
+    uint8_t n = yj_pack_varint_u32(tmp, value);
+    if (n > remaining) {
+        return 0;
+    }
+    memcpy(buffer, tmp, n);
+    return n;
+}
+
+/**
+ * @brief 批量打包无符号计数值数组
+ */
+uint16_t yj_pack_varint_u32_array(uint8_t* buffer, uint16_t buffer_size,
+                                  const uint32_t* values, uint16_t count) {
+    uint16_t pos = 0;
+    for (uint16_t i = 0; i < count; ++i) {
+        uint8_t n = pack_varint_checked(&buffer[pos], (uint16_t)(buffer_size - pos), values[i]);
+        if (n == 0) {
+            YJ_DEBUG_LOG("错误: varint数组打包缓冲区不足(元素 %u)\n", i);
+            return 0;
+        }
+        pos += n;
+    }
+    return pos;
+}
+
+/**
+ * @brief 批量解包无符号计数值数组
+ */
+uint16_t yj_unpack_varint_u32_array(const uint8_t* buffer, uint16_t len,
+                                    uint32_t* values, uint16_t count) {
+    uint16_t pos = 0;
+    for (uint16_t i = 0; i < count; ++i) {
+        uint8_t n = yj_unpack_varint_u32(&buffer[pos], (uint16_t)(len - pos), &values[i]);
+        if (n == 0) {
+            return 0;
+        }
+        pos += n;
+    }
+    return pos;
+}
+
+/**
+ * @brief 批量打包有符号数组(ZigZag)
+ */
+uint16_t yj_pack_varint_i32_array(uint8_t* buffer, uint16_t buffer_size,
+                                  const int32_t* values, uint16_t count) {
+    uint16_t pos = 0;
+    for (uint16_t i = 0; i < count; ++i) {
+        uint8_t n = pack_varint_checked(&buffer[pos], (uint16_t)(buffer_size - pos),
+                                        yj_zigzag_encode_i32(values[i]));
+        if (n == 0) {
+            YJ_DEBUG_LOG("错误: varint数组打包缓冲区不足(元素 %u)\n", i);
+            return 0;
+        }
+        pos += n;
+    }
+    return pos;
+}
+
+/**
+ * @brief 批量解包有符号数组(ZigZag)
+ */
+uint16_t yj_unpack_varint_i32_array(const uint8_t* buffer, uint16_t len,
+                                    int32_t* values, uint16_t count) {
+    uint16_t pos = 0;
+    for (uint16_t i = 0; i < count; ++i) {
+        uint8_t n = yj_unpack_varint_i32(&buffer[pos], (uint16_t)(len - pos), &values[i]);
+        if (n == 0) {
+            return 0;
+        }
+        pos += n;
+    }
+    return pos;
+}
+
+/**
+ * @brief 批量打包差分序列
+ */
+uint16_t yj_pack_varint_delta_array(uint8_t* buffer, uint16_t buffer_size,
+                                    const int32_t* values, uint16_t count) {
+    uint16_t pos = 0;
+    uint32_t prev = 0;
+    for (uint16_t i = 0; i < count; ++i) {
+        // 在无符号域求差, 避免有符号溢出; 解码端以同样方式回绕
+        int32_t delta = (int32_t)((uint32_t)values[i] - prev);
+        uint8_t n = pack_varint_checked(&buffer[pos], (uint16_t)(buffer_size - pos),
+                                        yj_zigzag_encode_i32(delta));
+        if (n == 0) {
+            YJ_DEBUG_LOG("错误: 差分数组打包缓冲区不足(元素 %u)\n", i);
+            return 0;
+        }
+        pos += n;
+        prev = (uint32_t)values[i];
+    }
+    return pos;
+}
+
+/**
+ * @brief 批量解包差分序列
+ */
+uint16_t yj_unpack_varint_delta_array(const uint8_t* buffer, uint16_t len,
+                                      int32_t* values, uint16_t count) {
+    uint16_t pos = 0;
+    uint32_t prev = 0;
+    for (uint16_t i = 0; i < count; ++i) {
+        int32_t delta;
+        uint8_t n = yj_unpack_varint_i32(&buffer[pos], (uint16_t)(len - pos), &delta);
+        if (n == 0) {
+            return 0;
+        }
+        pos += n;
+        prev += (uint32_t)delta;
+        values[i] = (int32_t)prev;
+    }
+    return pos;
+}
+
+/**
+ * @brief 获取协议统计信息
+ */
+void yj_get_stats(yj_protocol_handler_t* handler,
+                 uint32_t* tx_count, uint32_t* rx_count,
+                 uint32_t* error_count) {
+    uint32_t tx = 0, rx = 0, err = 0;
+#if YJ_ENABLE_STATS
+    if (handler) {
+        tx = handler->stats_tx_frames;
+        rx = handler->stats_rx_frames;
+        err = handler->stats_rx_errors;
+    }
+#else
+    (void)handler;
+#endif
+    if (tx_count) *tx_count = tx;
+    if (rx_count) *rx_count = rx;
+    if (error_count) *error_count = err;
+}
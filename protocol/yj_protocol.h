@@ -62,6 +62,19 @@ typedef struct {
     uint8_t received_checksum_bytes[YJ_FRAME_CHECKSUM_FIELD_SIZE]; // 接收到的校验和字节
 } yj_frame_t;
 
+/* 带用户上下文的帧接收回调类型 */
+typedef void (*yj_frame_received_ex_cb_t)(void* user, yj_frame_t* received_frame);
+
+/* 帧位置描述(整块缓冲区扫描结果) */
+typedef struct {
+    uint32_t offset;      // 帧头在缓冲区中的偏移
+    uint16_t length;      // 完整帧长度(含帧头与校验字段)
+    uint8_t  s_addr;      // 源地址
+    uint8_t  d_addr;      // 目标地址
+    uint8_t  func_id;     // 功能ID
+    uint8_t  checksum_ok; // 1校验通过, 0校验失败
+} yj_frame_span_t;
+
 /* 协议处理实例结构体 */
 typedef struct {
     /* 接收状态机 */
@@ -84,6 +97,18 @@ typedef struct {
     /* 物理层和回调函数 */
     yj_send_byte_func_t send_byte_func; // 字节发送函数指针
     void (*frame_received_callback)(yj_frame_t* received_frame); // 帧接收回调函数
+
+    /* 带用户上下文的回调(由yj_protocol_init_ex设置, 非NULL时优先于上面的回调) */
+    yj_send_byte_ex_func_t    send_byte_ex_func;          // 字节发送函数指针
+    yj_frame_received_ex_cb_t frame_received_ex_callback; // 帧接收回调函数
+    void*                     user;                       // 传给上述回调的用户上下文
+
+#if YJ_ENABLE_STATS
+    /* 统计计数 */
+    uint32_t      stats_tx_frames;      // 发送成功帧数
+    uint32_t      stats_rx_frames;      // 校验通过并交付的帧数
+    uint32_t      stats_rx_errors;      // 校验失败或长度超限次数
+#endif
 } yj_protocol_handler_t;
 
 /* API函数声明 */
@@ -100,6 +125,30 @@ void yj_protocol_init(yj_protocol_handler_t* handler,
                       void (*frame_received_cb)(yj_frame_t* received_frame),
                       yj_checksum_mode_t mode);
 
+/**
+ * @brief 初始化协议处理器(回调携带用户上下文)
+ * @param handler 协议处理器实例指针
+ * @param send_byte_impl 字节发送函数指针, 第一个参数为user
+ * @param frame_received_cb 帧接收回调函数, 第一个参数为user
+ * @param user 用户上下文(如端口结构体指针), 原样传给两个回调, 可为NULL
+ * @param mode 校验模式(YJ_CHECKSUM_MODE_ORIGINAL或YJ_CHECKSUM_MODE_CRC16)
+ * @note 多个处理器实例可共用同一对回调函数, 通过user区分端口, 无需为每个端口生成全局跳板函数
+ */
+void yj_protocol_init_ex(yj_protocol_handler_t* handler,
+                         yj_send_byte_ex_func_t send_byte_impl,
+                         yj_frame_received_ex_cb_t frame_received_cb,
+                         void* user,
+                         yj_checksum_mode_t mode);
+
+/**
+ * @brief 获取初始化时传入的用户上下文
+ * @param handler 协议处理器实例指针
+ * @return 用户上下文, 未设置时为NULL
+ */
+static inline void* yj_protocol_get_user(const yj_protocol_handler_t* handler) {
+    return handler ? handler->user : NULL;
+}
+
 /**
  * @brief 发送数据帧
  * @param handler 协议处理器实例指针
@@ -122,6 +171,17 @@ int32_t yj_protocol_send_frame(yj_protocol_handler_t* handler,
  */
 void yj_protocol_process_byte(yj_protocol_handler_t* handler, uint8_t byte_received);
 
+/**
+ * @brief 处理一整块接收数据
+ * @details 逐字节驱动接收状态机, 效果等同于对每个字节调用yj_protocol_process_byte,
+ *          但不经过接收环形缓冲区, 适合DMA/上位机等一次拿到整块数据的场景。
+ *          帧可以跨越多次调用, 完整帧在本函数内通过回调交付。
+ * @param handler 协议处理器实例指针
+ * @param data 数据指针
+ * @param len 数据长度
+ */
+void yj_protocol_process_buffer(yj_protocol_handler_t* handler, const uint8_t* data, uint32_t len);
+
 /**
  * @brief 向接收环形缓冲区添加字节
  * @param handler 协议处理器实例指针
@@ -136,6 +196,46 @@ int32_t yj_protocol_rx_buffer_add_byte(yj_protocol_handler_t* handler, uint8_t b
  */
 void yj_protocol_tick(yj_protocol_handler_t* handler);
 
+/**
+ * @brief 扫描整块接收数据, 一次性找出其中所有完整帧
+ * @details 无状态的批量解析接口, 供上位机等一次拿到大块数据的场景使用:
+ *          跳过帧头之前的无效字节, 数据长度超过max_payload的伪帧头只丢弃1字节后重新同步,
+ *          校验失败的帧同样整帧跳过(与yj_protocol_process_byte的行为一致)并以checksum_ok=0报告。
+ *          末尾不完整的帧不计入consumed, 调用方应保留这部分数据等待后续字节。
+ * @param data 接收数据
+ * @param len 数据长度
+ * @param mode 校验模式
+ * @param head_byte 帧头字节(通常为YJ_FRAME_HEAD_BYTE)
+ * @param max_payload 允许的最大数据长度(通常为YJ_MAX_DATA_PAYLOAD_SIZE), 超过0xFFF7时按0xFFF7处理
+ * @param spans 输出:帧位置数组
+ * @param max_spans spans容量, 写满后提前返回
+ * @param consumed 输出:已处理(可丢弃)的字节数, 可为NULL
+ * @return 写入spans的帧数
+ */
+uint32_t yj_protocol_scan_buffer(const uint8_t* data, uint32_t len,
+                                 yj_checksum_mode_t mode, uint8_t head_byte, uint16_t max_payload,
+                                 yj_frame_span_t* spans, uint32_t max_spans, uint32_t* consumed);
+
+/* 校验计算函数(与收发路径使用同一实现) */
+
+/**
+ * @brief 计算原始求和/累加校验
+ * @param data 数据指针(帧头到数据末尾)
+ * @param length 数据长度
+ * @param sum_check_out 输出:和校验
+ * @param add_check_out 输出:累加校验
+ */
+void yj_calc_original_checksums(const uint8_t* data, uint16_t length,
+                                uint8_t* sum_check_out, uint8_t* add_check_out);
+
+/**
+ * @brief 计算CRC-16/CCITT-FALSE
+ * @param data 数据指针(帧头到数据末尾)
+ * @param length 数据长度
+ * @return CRC值
+ */
+uint16_t yj_calc_crc16(const uint8_t* data, uint16_t length);
+
 /* 数据打包/解包辅助函数(小端字节序) */
 void yj_pack_u16_le(uint8_t* buffer, uint16_t value);
 uint16_t yj_unpack_u16_le(const uint8_t* buffer);
@@ -148,6 +248,105 @@ int32_t yj_unpack_i32_le(const uint8_t* buffer);
 void yj_pack_float_le(uint8_t* buffer, float value);
 float yj_unpack_float_le(const uint8_t* buffer);
 
+/* 变长整数编码辅助函数(LEB128 varint / ZigZag)
+ *
+ * 每字节低7位为数据, 最高位为延续标志, 低位组在前。
+ * 小于128的计数值只占1字节; 有符号值先经ZigZag映射
+ * (0,-1,1,-2,... -> 0,1,2,3,...), 使小幅正负误差同样只占1字节。
+ */
+#define YJ_VARINT32_MAX_BYTES        5    // 32位varint最大字节数
+
+/**
+ * @brief ZigZag编码: 有符号数映射为无符号数
+ */
+uint32_t yj_zigzag_encode_i32(int32_t value);
+
+/**
+ * @brief ZigZag解码: 无符号数还原为有符号数
+ */
+int32_t yj_zigzag_decode_u32(uint32_t value);
+
+/**
+ * @brief 打包32位无符号varint
+ * @param buffer 输出缓冲区(至少YJ_VARINT32_MAX_BYTES字节可用)
+ * @param value 待编码值
+ * @return 写入的字节数(1-5)
+ */
+uint8_t yj_pack_varint_u32(uint8_t* buffer, uint32_t value);
+
+/**
+ * @brief 解包32位无符号varint
+ * @param buffer 输入缓冲区
+ * @param len 缓冲区剩余长度
+ * @param value 输出:解码值
+ * @return 消耗的字节数, 0表示数据不完整或编码超长
+ */
+uint8_t yj_unpack_varint_u32(const uint8_t* buffer, uint16_t len, uint32_t* value);
+
+/**
+ * @brief 打包32位有符号varint(ZigZag)
+ * @return 写入的字节数(1-5)
+ */
+uint8_t yj_pack_varint_i32(uint8_t* buffer, int32_t value);
+
+/**
+ * @brief 解包32位有符号varint(ZigZag)
+ * @return 消耗的字节数, 0表示失败
+ */
+uint8_t yj_unpack_varint_i32(const uint8_t* buffer, uint16_t len, int32_t* value);
+
+/**
+ * @brief 批量打包无符号计数值数组
+ * @param buffer 输出缓冲区
+ * @param buffer_size 输出缓冲区大小
+ * @param values 输入数组
+ * @param count 元素个数
+ * @return 写入的总字节数, 0表示缓冲区不足(count为0时也返回0)
+ */
+uint16_t yj_pack_varint_u32_array(uint8_t* buffer, uint16_t buffer_size,
+                                  const uint32_t* values, uint16_t count);
+
+/**
+ * @brief 批量解包无符号计数值数组
+ * @param buffer 输入缓冲区
+ * @param len 输入长度
+ * @param values 输出数组
+ * @param count 期望元素个数
+ * @return 消耗的总字节数, 0表示数据不完整或编码错误
+ */
+uint16_t yj_unpack_varint_u32_array(const uint8_t* buffer, uint16_t len,
+                                    uint32_t* values, uint16_t count);
+
+/**
+ * @brief 批量打包有符号数组(每个元素独立ZigZag编码)
+ * @return 写入的总字节数, 0表示缓冲区不足
+ */
+uint16_t yj_pack_varint_i32_array(uint8_t* buffer, uint16_t buffer_size,
+                                  const int32_t* values, uint16_t count);
+
+/**
+ * @brief 批量解包有符号数组(每个元素独立ZigZag编码)
+ * @return 消耗的总字节数, 0表示失败
+ */
+uint16_t yj_unpack_varint_i32_array(const uint8_t* buffer, uint16_t len,
+                                    int32_t* values, uint16_t count);
+
+/**
+ * @brief 批量打包差分序列
+ * @details 首元素按ZigZag varint编码, 其后每个元素编码为与前一元素之差,
+ *          适合缓慢变化的采样值和单调递增的计数器。差值按32位回绕计算。
+ * @return 写入的总字节数, 0表示缓冲区不足
+ */
+uint16_t yj_pack_varint_delta_array(uint8_t* buffer, uint16_t buffer_size,
+                                    const int32_t* values, uint16_t count);
+
+/**
+ * @brief 批量解包差分序列
+ * @return 消耗的总字节数, 0表示失败
+ */
+uint16_t yj_unpack_varint_delta_array(const uint8_t* buffer, uint16_t len,
+                                      int32_t* values, uint16_t count);
+
 // 发送队列结构
 typedef struct {
     uint8_t data[YJ_MAX_DATA_PAYLOAD_SIZE];
@@ -227,6 +426,7 @@ void yj_send_large_data(yj_protocol_handler_t* handler,
  * @param tx_count 输出:发送帧计数
  * @param rx_count 输出:接收帧计数
  * @param error_count 输出:错误计数
+ * @note 需要YJ_ENABLE_STATS为1, 否则各计数均输出0; 输出指针可为NULL
  */
 void yj_get_stats(yj_protocol_handler_t* handler,
                  uint32_t* tx_count, uint32_t* rx_count,
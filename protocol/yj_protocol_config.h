@@ -11,20 +11,35 @@ typedef enum {
 
 /* 选择当前设备使用的校验模式 */
 // 可以在编译前修改，或者改为运行时变量(需要修改yj_protocol_handler_t和初始化函数)
+// 构建系统可通过 -DYJ_ACTIVE_CHECKSUM_MODE=... 覆盖
+#ifndef YJ_ACTIVE_CHECKSUM_MODE
 #define YJ_ACTIVE_CHECKSUM_MODE  YJ_CHECKSUM_MODE_ORIGINAL // 或 YJ_CHECKSUM_MODE_CRC16
+#endif
 
 /* 基本配置 */
 #define YJ_DEFAULT_DEVICE_ADDRESS    0x01   // 默认设备地址
 #define YJ_DEFAULT_HOST_ADDRESS      0x02   // 默认主机地址
 #define YJ_FRAME_HEAD_BYTE           0xAB   // 帧头字节
 
-/* 缓冲区大小配置 */
+/* 缓冲区大小配置(可由编译选项覆盖) */
+#ifndef YJ_MAX_DATA_PAYLOAD_SIZE
 #define YJ_MAX_DATA_PAYLOAD_SIZE     256    // 最大数据负载大小
+#endif
+#ifndef YJ_RX_BUFFER_SIZE
 #define YJ_RX_BUFFER_SIZE            ((6 + YJ_MAX_DATA_PAYLOAD_SIZE + 2) * 2) // 接收缓冲区大小
+#endif
+
+/* 统计计数配置 */
+// 1: 协议处理器维护发送/接收/错误帧计数, 可通过yj_get_stats读取
+// 0: 不占用额外RAM, yj_get_stats始终返回0
+#ifndef YJ_ENABLE_STATS
+#define YJ_ENABLE_STATS              0
+#endif
 
 /* 物理层抽象(函数指针类型定义) */
 typedef int32_t (*yj_send_byte_func_t)(uint8_t byte);  // 发送单字节函数类型
 typedef int32_t (*yj_recv_byte_func_t)(uint8_t* byte, uint32_t timeout_ms); // 接收单字节函数类型
+typedef int32_t (*yj_send_byte_ex_func_t)(void* user, uint8_t byte); // 带用户上下文的发送单字节函数类型
 
 /* 调试输出配置 */
 // #define YJ_ENABLE_DEBUG_PRINTF
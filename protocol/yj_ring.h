@@ -0,0 +1,191 @@
+#ifndef YJ_RING_H
+#define YJ_RING_H
+
+#include <stdint.h>
+#include <string.h> // 用于memcpy
+
+/**
+ * @file yj_ring.h
+ * @brief 单生产者/单消费者(SPSC)无锁字节环形缓冲区
+ *
+ * 与yj_protocol_handler_t中的rx_circ_buffer相同的使用模型: 一个生产者(串口中断或读线程)
+ * 只移动head, 一个消费者(主循环或解析线程)只移动tail, 双方无需加锁。
+ * 与rx_circ_buffer不同之处:
+ * - head/tail为自由递增的32位计数, 数据量为head - tail, 不需要单独的count字段
+ *   (count由双方共同修改, 正是原实现需要临界区保护的原因);
+ * - 容量必须为2的幂, 取模运算用掩码代替;
+ * - 可选镜像存储(YJ_RING_FLAG_MIRROR): 存储区为2倍容量, 每个字节同时写入i和i+size,
+ *   任意不超过容量的可读区间在存储区中都是连续的, 消费者可直接在原地解析而无需拷贝。
+ *
+ * 生产者: yj_ring_write() 或 yj_ring_write_span() + yj_ring_commit()
+ * 消费者: yj_ring_read_span() / yj_ring_peek() + yj_ring_discard()
+ */
+
+#define YJ_RING_FLAG_MIRROR 0x01u // 存储区为2倍容量的镜像布局
+
+/* 内存序: GCC/Clang下使用原子内建函数, 其他编译器退化为volatile访问(单核MCU足够) */
+#if defined(__GNUC__) || defined(__clang__)
+    #define YJ_RING_LOAD_ACQUIRE(p)      __atomic_load_n((p), __ATOMIC_ACQUIRE)
+    #define YJ_RING_STORE_RELEASE(p, v)  __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#else
+    #define YJ_RING_LOAD_ACQUIRE(p)      (*(volatile const uint32_t*)(p))
+    #define YJ_RING_STORE_RELEASE(p, v)  (*(volatile uint32_t*)(p) = (v))
+#endif
+
+/* 环形缓冲区结构体 */
+typedef struct {
+    uint8_t* buf;   // 存储区(镜像模式下为2 * size字节)
+    uint32_t size;  // 容量(2的幂)
+    uint32_t mask;  // size - 1
+    uint32_t head;  // 写计数, 仅生产者修改
+    uint32_t tail;  // 读计数, 仅消费者修改
+    uint8_t  flags; // YJ_RING_FLAG_*
+} yj_ring_t;
+
+/**
+ * @brief 初始化环形缓冲区
+ * @param ring 环形缓冲区
+ * @param storage 存储区, 镜像模式下长度必须为2 * size
+ * @param size 容量, 必须为2的幂
+ * @param flags YJ_RING_FLAG_*
+ * @return 0成功, -1参数错误
+ */
+static inline int32_t yj_ring_init(yj_ring_t* ring, uint8_t* storage, uint32_t size, uint8_t flags) {
+    if (!ring || !storage || size == 0 || (size & (size - 1)) != 0) return -1;
+    ring->buf = storage;
+    ring->size = size;
+    ring->mask = size - 1;
+    ring->head = 0;
+    ring->tail = 0;
+    ring->flags = flags;
+    return 0;
+}
+
+/**
+ * @brief 可读字节数(生产者和消费者均可调用)
+ */
+static inline uint32_t yj_ring_count(const yj_ring_t* ring) {
+    return YJ_RING_LOAD_ACQUIRE(&ring->head) - YJ_RING_LOAD_ACQUIRE(&ring->tail);
+}
+
+/**
+ * @brief 剩余可写字节数(生产者和消费者均可调用)
+ */
+static inline uint32_t yj_ring_space(const yj_ring_t* ring) {
+    return ring->size - yj_ring_count(ring);
+}
+
+/* ---- 生产者接口 ---- */
+
+/**
+ * @brief 获取可直接写入的连续区域(例如作为read()的目标缓冲区)
+ * @param ptr 输出:写入起始地址
+ * @return 连续可写字节数, 镜像模式下等于剩余空间
+ */
+static inline uint32_t yj_ring_write_span(yj_ring_t* ring, uint8_t** ptr) {
+    uint32_t head = ring->head;
+    uint32_t space = ring->size - (head - YJ_RING_LOAD_ACQUIRE(&ring->tail));
+    uint32_t offset = head & ring->mask;
+    *ptr = &ring->buf[offset];
+    if (ring->flags & YJ_RING_FLAG_MIRROR) {
+        return space;
+    }
+    return (space < ring->size - offset) ? space : ring->size - offset;
+}
+
+/**
+ * @brief 提交已写入write_span区域的n个字节
+ * @note 镜像模式下在此补写镜像副本, 之后才对消费者可见
+ */
+static inline void yj_ring_commit(yj_ring_t* ring, uint32_t n) {
+    uint32_t head = ring->head;
+    if (n == 0) return;
+    if (ring->flags & YJ_RING_FLAG_MIRROR) {
+        uint32_t offset = head & ring->mask;
+        uint32_t first = ring->size - offset; // 落在前半区的字节数
+        if (first >= n) {
+            memcpy(&ring->buf[offset + ring->size], &ring->buf[offset], n);
+        } else {
+            memcpy(&ring->buf[offset + ring->size], &ring->buf[offset], first);
+            memcpy(&ring->buf[0], &ring->buf[ring->size], n - first);
+        }
+    }
+    YJ_RING_STORE_RELEASE(&ring->head, head + n);
+}
+
+/**
+ * @brief 写入数据, 空间不足时只写入能容纳的部分(不覆盖未读数据)
+ * @return 实际写入字节数
+ */
+static inline uint32_t yj_ring_write(yj_ring_t* ring, const uint8_t* data, uint32_t len) {
+    uint32_t written = 0;
+    while (written < len) {
+        uint8_t* dst;
+        uint32_t span = yj_ring_write_span(ring, &dst);
+        if (span == 0) break;
+        if (span > len - written) span = len - written;
+        memcpy(dst, &data[written], span);
+        yj_ring_commit(ring, span);
+        written += span;
+    }
+    return written;
+}
+
+/* ---- 消费者接口 ---- */
+
+/**
+ * @brief 获取可直接读取的连续区域
+ * @param ptr 输出:读取起始地址
+ * @return 连续可读字节数, 镜像模式下等于全部可读字节数
+ */
+static inline uint32_t yj_ring_read_span(const yj_ring_t* ring, const uint8_t** ptr) {
+    uint32_t tail = ring->tail;
+    uint32_t count = YJ_RING_LOAD_ACQUIRE(&ring->head) - tail;
+    uint32_t offset = tail & ring->mask;
+    *ptr = &ring->buf[offset];
+    if (ring->flags & YJ_RING_FLAG_MIRROR) {
+        return count;
+    }
+    return (count < ring->size - offset) ? count : ring->size - offset;
+}
+
+/**
+ * @brief 拷贝最多len字节到dst, 不移动读位置
+ * @return 实际拷贝字节数
+ */
+static inline uint32_t yj_ring_peek(const yj_ring_t* ring, uint8_t* dst, uint32_t len) {
+    uint32_t tail = ring->tail;
+    uint32_t count = YJ_RING_LOAD_ACQUIRE(&ring->head) - tail;
+    uint32_t offset = tail & ring->mask;
+    uint32_t first;
+    if (len > count) len = count;
+    first = ring->size - offset;
+    if ((ring->flags & YJ_RING_FLAG_MIRROR) || first >= len) {
+        memcpy(dst, &ring->buf[offset], len);
+    } else {
+        memcpy(dst, &ring->buf[offset], first);
+        memcpy(&dst[first], &ring->buf[0], len - first);
+    }
+    return len;
+}
+
+/**
+ * @brief 丢弃最多n个已读字节
+ * @return 实际丢弃字节数
+ */
+static inline uint32_t yj_ring_discard(yj_ring_t* ring, uint32_t n) {
+    uint32_t tail = ring->tail;
+    uint32_t count = YJ_RING_LOAD_ACQUIRE(&ring->head) - tail;
+    if (n > count) n = count;
+    YJ_RING_STORE_RELEASE(&ring->tail, tail + n);
+    return n;
+}
+
+/**
+ * @brief 清空缓冲区(消费者调用)
+ */
+static inline void yj_ring_clear(yj_ring_t* ring) {
+    YJ_RING_STORE_RELEASE(&ring->tail, YJ_RING_LOAD_ACQUIRE(&ring->head));
+}
+
+#endif // YJ_RING_H
@@ -0,0 +1,95 @@
+"""原生ByteRing测试模块"""
+
+import unittest
+import sys
+import os
+import threading
+
+# 添加项目根目录到Python路径
+sys.path.insert(0, os.path.abspath(os.path.join(os.path.dirname(__file__), '..')))
+
+from core import native_protocol
+
+
+@unittest.skipUnless(native_protocol.is_available(), "原生扩展未编译")
+class TestByteRing(unittest.TestCase):
+    """ByteRing（yj_ring.h）的测试"""
+
+    def test_capacity_rounded_to_power_of_two(self):
+        """测试容量向上取整为2的幂"""
+        ring = native_protocol.create_byte_ring(100)
+        self.assertEqual(ring.capacity, 128)
+        self.assertEqual(len(ring), 0)
+        with self.assertRaises(ValueError):
+            native_protocol.create_byte_ring(0)
+
+    def test_write_does_not_overwrite(self):
+        """测试空间不足时丢弃新数据"""
+        ring = native_protocol.create_byte_ring(64)
+        self.assertEqual(ring.write(b"a" * 60), 60)
+        self.assertEqual(ring.write(b"b" * 10), 4)
+        self.assertEqual(ring.overflow_bytes, 6)
+        self.assertEqual(ring.space, 0)
+        self.assertEqual(bytes(ring.peek(3)), b"aaa")
+
+    def test_peek_contiguous_across_wrap(self):
+        """测试跨越缓冲区末尾的数据通过镜像存储仍可连续查看"""
+        ring = native_protocol.create_byte_ring(64)
+        ring.write(bytes(50))
+        self.assertEqual(ring.discard(50), 50)
+        data = bytes(range(40))
+        ring.write(data)
+        view = ring.peek()
+        self.assertTrue(view.readonly)
+        self.assertEqual(bytes(view), data)
+        self.assertEqual(ring.read(10), data[:10])
+        self.assertEqual(bytes(ring.peek()), data[10:])
+
+    def test_discard_and_clear(self):
+        """测试丢弃与清空"""
+        ring = native_protocol.create_byte_ring(64)
+        ring.write(b"hello")
+        self.assertEqual(ring.discard(100), 5)
+        ring.write(b"world")
+        ring.clear()
+        self.assertEqual(len(ring), 0)
+        self.assertEqual(ring.bytes_written, 10)
+
+    def test_write_from_fd(self):
+        """测试从文件描述符直接读入"""
+        ring = native_protocol.create_byte_ring(64)
+        read_fd, write_fd = os.pipe()
+        try:
+            os.set_blocking(read_fd, False)
+            self.assertEqual(ring.write_from_fd(read_fd), 0)
+            os.write(write_fd, b"0123456789")
+            self.assertEqual(ring.write_from_fd(read_fd, 4), 4)
+            self.assertEqual(ring.write_from_fd(read_fd), 6)
+            self.assertEqual(ring.read(), b"0123456789")
+        finally:
+            os.close(read_fd)
+            os.close(write_fd)
+
+    def test_producer_consumer_threads(self):
+        """测试读线程写入、解析线程消费时数据完整有序"""
+        ring = native_protocol.create_byte_ring(256)
+        payload = bytes(i & 0xFF for i in range(20000))
+        received = bytearray()
+
+        def producer():
+            pos = 0
+            while pos < len(payload):
+                pos += ring.write(payload[pos:pos + 97])
+
+        thread = threading.Thread(target=producer)
+        thread.start()
+        while len(received) < len(payload):
+            view = ring.peek()
+            received += view
+            ring.discard(len(view))
+        thread.join()
+        self.assertEqual(bytes(received), payload)
+
+
+if __name__ == '__main__':
+    unittest.main()
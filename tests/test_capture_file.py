@@ -0,0 +1,284 @@
+"""二进制录制文件(.yjcap)测试模块"""
+
+import unittest
+import sys
+import os
+import tempfile
+import time
+from datetime import datetime
+
+# 添加项目根目录到Python路径
+sys.path.insert(0, os.path.abspath(os.path.join(os.path.dirname(__file__), '..')))
+
+from core import capture_file, native_protocol
+from core.capture_file import CaptureIndex, CaptureReader, PyCaptureWriter, open_capture_writer
+from core.data_recorder import DataRecorder
+
+
+def build_frame(func_id: int, payload: bytes) -> bytes:
+    """构建原始校验模式的完整帧"""
+    body = bytes([0xAB, 0x01, 0x02, func_id, len(payload) & 0xFF, len(payload) >> 8]) + payload
+    sc = ac = 0
+    for byte in body:
+        sc = (sc + byte) & 0xFF
+        ac = (ac + sc) & 0xFF
+    return body + bytes([sc, ac])
+
+
+class TestCaptureFile(unittest.TestCase):
+    """录制文件读写测试"""
+
+    def setUp(self):
+        self.tmpdir = tempfile.TemporaryDirectory()
+        self.path = os.path.join(self.tmpdir.name, "test.yjcap")
+
+    def tearDown(self):
+        self.tmpdir.cleanup()
+
+    def _write_samples(self, writer, count):
+        for i in range(count):
+            writer.append(1000 + i * 10, i % 2, capture_file.STATUS_OK, 0x30 + (i % 3), bytes([i & 0xFF]) * (i % 20))
+
+    def test_round_trip(self):
+        """测试写入后读取记录一致"""
+        with PyCaptureWriter(self.path, index_interval=16) as writer:
+            self._write_samples(writer, 100)
+        with CaptureReader(self.path) as reader:
+            self.assertTrue(reader.finalized)
+            self.assertEqual(reader.record_count, 100)
+            records = list(reader)
+            self.assertEqual(len(records), 100)
+            self.assertEqual(records[7].ts_ns, 1070)
+            self.assertEqual(records[7].direction, 1)
+            self.assertEqual(records[7].func_id, 0x31)
+            self.assertEqual(bytes(records[7].data), b"\x07" * 7)
+            self.assertTrue(all(r.offset % capture_file.RECORD_ALIGN == 0 for r in records))
+            del records
+
+    def test_seek_time_uses_index_blocks(self):
+        """测试按时间定位并读取区间"""
+        with PyCaptureWriter(self.path, index_interval=8) as writer:
+            self._write_samples(writer, 100)
+        with CaptureReader(self.path) as reader:
+            offset = reader.seek_time(1500)
+            self.assertGreater(offset, capture_file.FILE_HEADER_SIZE)
+            self.assertLessEqual(next(reader.records(offset)).ts_ns, 1500)
+            selected = [r.ts_ns for r in reader.records_between(1500, 1550)]
+            self.assertEqual(selected, [1500, 1510, 1520, 1530, 1540])
+
+    def _write_equal_ts_across_blocks(self):
+        """每4条记录一个索引块, 时间戳40的记录跨越第一、二个索引块的边界"""
+        timestamps = [10, 20, 30, 40, 40, 40, 50, 60, 70, 80, 90, 100]
+        with PyCaptureWriter(self.path, index_interval=4) as writer:
+            for i, ts in enumerate(timestamps):
+                writer.append(ts, 0, capture_file.STATUS_OK, 0x30, bytes([i]))
+
+    def test_seek_time_equal_ts_across_blocks(self):
+        """测试同一时间戳的记录跨越索引块边界时, 定位不会跳过前一索引块末尾的记录"""
+        self._write_equal_ts_across_blocks()
+        with CaptureReader(self.path) as reader:
+            self.assertEqual(reader.seek_time(40), capture_file.FILE_HEADER_SIZE)
+            self.assertEqual([bytes(r.data)[0] for r in reader.records_between(40, 41)], [3, 4, 5])
+            self.assertGreater(reader.seek_time(41), capture_file.FILE_HEADER_SIZE)
+            self.assertEqual([r.ts_ns for r in reader.records_between(41, 70)], [50, 60])
+
+    @unittest.skipUnless(native_protocol.is_available() and
+                         hasattr(native_protocol.native_module(), "seek_capture_time"), "原生扩展未编译")
+    def test_native_seek_time_matches_python(self):
+        """测试C按时间定位(yj_capture_reader_seek_time)与CaptureReader.seek_time一致"""
+        self._write_equal_ts_across_blocks()
+        native = native_protocol.native_module()
+        with CaptureReader(self.path) as reader:
+            for ts in (0, 10, 35, 40, 41, 50, 80, 81, 100, 1000):
+                self.assertEqual(native.seek_capture_time(self.path, ts), reader.seek_time(ts), ts)
+
+    def test_unclosed_file_is_recovered(self):
+        """测试未正常关闭的文件可顺序读取到最后一条完整记录"""
+        writer = PyCaptureWriter(self.path)
+        self._write_samples(writer, 10)
+        writer.flush()
+        with open(self.path, "ab") as f:
+            f.write(b"\x01\x02\x03")  # 写入中途崩溃留下的残缺记录
+        with CaptureReader(self.path) as reader:
+            self.assertFalse(reader.finalized)
+            self.assertEqual(len(list(reader)), 10)
+            self.assertEqual(reader.seek_time(1050), capture_file.FILE_HEADER_SIZE)
+        writer.close()
+
+    def test_rejects_invalid_file(self):
+        """测试拒绝非录制文件"""
+        with open(self.path, "wb") as f:
+            f.write(b"\x00" * 128)
+        with self.assertRaises(ValueError):
+            CaptureReader(self.path)
+
+    @unittest.skipUnless(native_protocol.is_available() and
+                         hasattr(native_protocol.native_module(), "CaptureWriter"), "原生扩展未编译")
+    def test_native_writer_matches_python(self):
+        """测试C写入器与纯Python写入器生成的文件除创建时间外完全一致"""
+        py_path = os.path.join(self.tmpdir.name, "py.yjcap")
+        with PyCaptureWriter(py_path, index_interval=5) as writer:
+            self._write_samples(writer, 23)
+        with open_capture_writer(self.path, buffer_size=1, index_interval=5, direct=True) as writer:
+            self._write_samples(writer, 23)
+            self.assertEqual(writer.record_count, 23)
+        with open(py_path, "rb") as a, open(self.path, "rb") as b:
+            py_data, native_data = a.read(), b.read()
+        self.assertEqual(py_data[:16], native_data[:16])
+        self.assertEqual(py_data[24:], native_data[24:])
+
+
+class TestCaptureIndex(unittest.TestCase):
+    """录制文件索引(.yjidx)测试"""
+
+    def setUp(self):
+        self.tmpdir = tempfile.TemporaryDirectory()
+        self.path = os.path.join(self.tmpdir.name, "test.yjcap")
+        with PyCaptureWriter(self.path, index_interval=64) as writer:
+            for i in range(1000):
+                # 每5条记录时间戳相同，每7条中有一条原始数据
+                status = capture_file.STATUS_RAW if i % 7 == 0 else capture_file.STATUS_OK
+                writer.append(1000 + (i // 5) * 10, i % 2, status, 0x30 + (i % 3), bytes([i & 0xFF]) * (i % 9))
+
+    def tearDown(self):
+        self.tmpdir.cleanup()
+
+    def _expected(self, reader, func_id, t0, t1):
+        return [r.offset for r in reader.records_between(t0, t1)
+                if r.func_id == func_id and r.status != capture_file.STATUS_RAW]
+
+    def test_query_matches_linear_scan(self):
+        """测试按功能ID和时间区间查询与顺序扫描结果一致"""
+        capture_file._build_index_python(self.path, capture_file.index_path_for(self.path), 16)
+        with CaptureReader(self.path) as reader, CaptureIndex(reader) as index:
+            self.assertEqual(index.record_count, 1000)
+            for func_id in (0x30, 0x31, 0x32, 0x40):
+                for t0, t1 in ((0, 10 ** 6), (1000, 1010), (1500, 2250), (1495, 1505), (2990, 3000), (2000, 2000)):
+                    self.assertEqual(list(index.query_offsets(func_id, t0, t1)),
+                                     self._expected(reader, func_id, t0, t1), (func_id, t0, t1))
+            records = list(index.query(0x31, 1500, 1520))
+            self.assertTrue(all(r.func_id == 0x31 and 1500 <= r.ts_ns < 1520 for r in records))
+            self.assertEqual(len(index.postings(0x40)), 0)
+            del records
+
+    def test_seek_time(self):
+        """测试稀疏时间索引定位不晚于第一条满足条件的记录"""
+        capture_file._build_index_python(self.path, capture_file.index_path_for(self.path), 16)
+        with CaptureReader(self.path) as reader, CaptureIndex(reader) as index:
+            for t in (0, 1000, 1005, 1160, 1165, 2995, 10 ** 6):
+                first = next((r for r in reader if r.ts_ns >= t), None)
+                offset = index.seek_time(t)
+                if first is not None:
+                    self.assertLessEqual(offset, first.offset)
+                self.assertEqual([r.offset for r in index.records_between(t, t + 50)],
+                                 [r.offset for r in reader.records_between(t, t + 50)])
+
+    def test_stale_index_rejected(self):
+        """测试录制文件改写后旧索引被拒绝"""
+        index_path = capture_file.build_index(self.path)
+        with open(self.path, "r+b") as f:
+            f.seek(16)
+            f.write(b"\x00" * 8)  # 修改创建时间
+        with CaptureReader(self.path) as reader:
+            with self.assertRaises(capture_file.StaleIndexError):
+                CaptureIndex(reader, index_path)
+            with CaptureIndex(reader, index_path, rebuild=True) as index:
+                self.assertEqual(index.record_count, 1000)
+
+    @unittest.skipUnless(native_protocol.is_available() and
+                         hasattr(native_protocol.native_module(), "build_capture_index"), "原生扩展未编译")
+    def test_native_index_matches_python(self):
+        """测试C索引生成与纯Python实现生成的文件完全一致"""
+        py_path = os.path.join(self.tmpdir.name, "py.yjidx")
+        native_path = os.path.join(self.tmpdir.name, "native.yjidx")
+        capture_file._build_index_python(self.path, py_path, 16)
+        native_protocol.native_module().build_capture_index(self.path, native_path, 16)
+        with open(py_path, "rb") as a, open(native_path, "rb") as b:
+            self.assertEqual(a.read(), b.read())
+
+    @unittest.skipUnless(native_protocol.is_available() and
+                         hasattr(native_protocol.native_module(), "query_capture_index"), "原生扩展未编译")
+    def test_native_query_matches_python(self):
+        """测试C查询接口(定位、倒排列表、区间查询)与CaptureIndex结果一致"""
+        native = native_protocol.native_module()
+        index_path = capture_file.index_path_for(self.path)
+        capture_file._build_index_python(self.path, index_path, 16)
+        with CaptureReader(self.path) as reader, CaptureIndex(reader) as index:
+            for func_id in (0x30, 0x31, 0x32, 0x40):
+                for t0, t1 in ((0, 10 ** 6), (1000, 1010), (1500, 2250), (1495, 1505), (2990, 3000),
+                               (2000, 2000), (2100, 2000), (3000, 10 ** 6), (0, 1000)):
+                    seek_offset, postings, hits = native.query_capture_index(self.path, index_path, func_id, t0, t1)
+                    self.assertEqual(seek_offset, index.seek_time(t0), t0)
+                    self.assertEqual(postings, list(index.postings(func_id)), func_id)
+                    self.assertEqual(hits, list(index.query_offsets(func_id, t0, t1)), (func_id, t0, t1))
+        with open(self.path, "r+b") as f:
+            f.seek(16)
+            f.write(b"\x00" * 8)  # 修改创建时间
+        with self.assertRaises(ValueError):
+            native.query_capture_index(self.path, index_path, 0x30, 0, 1)
+
+
+class TestDataRecorderCapture(unittest.TestCase):
+    """DataRecorder流式录制测试"""
+
+    def test_capture_splits_frames(self):
+        """测试收到的数据按帧切分写入，跨次到达的帧被拼接"""
+        with tempfile.TemporaryDirectory() as tmpdir:
+            path = os.path.join(tmpdir, "rec.yjcap")
+            recorder = DataRecorder()
+            self.assertTrue(recorder.start_capture(path))
+            frame1 = build_frame(0x31, b"\x01\x02")
+            bad = bytearray(build_frame(0x32, b"\x03"))
+            bad[-1] ^= 0xFF
+            data = b"\x55" + frame1 + bytes(bad)
+            recorder.record_raw_frame(datetime.now(), data[:5], "RX")
+            recorder.record_raw_frame(datetime.now(), data[5:], "RX")
+            recorder.record_raw_frame(datetime.now(), build_frame(0x40, b""), "TX (Basic)")
+            self.assertEqual(recorder.recorded_raw_data, [])
+            summary = recorder.stop_capture()
+            self.assertEqual(summary['records'], 4)
+            self.assertEqual(summary['index'], capture_file.index_path_for(path))
+            with CaptureReader(path) as reader:
+                records = [(r.direction, r.status, r.func_id, bytes(r.data)) for r in reader]
+                with CaptureIndex(reader) as index:
+                    self.assertEqual([bytes(r.data) for r in index.query(0x31, 0, 2 ** 63)], [frame1])
+            self.assertEqual(records, [
+                (capture_file.DIR_RX, capture_file.STATUS_RAW, 0, b"\x55"),
+                (capture_file.DIR_RX, capture_file.STATUS_OK, 0x31, frame1),
+                (capture_file.DIR_RX, capture_file.STATUS_CHECKSUM_ERROR, 0x32, bytes(bad)),
+                (capture_file.DIR_TX, capture_file.STATUS_OK, 0x40, build_frame(0x40, b"")),
+            ])
+
+    def test_capture_and_raw_recording_together(self):
+        """测试流式录制期间原始数据录制照常记录"""
+        with tempfile.TemporaryDirectory() as tmpdir:
+            path = os.path.join(tmpdir, "rec.yjcap")
+            recorder = DataRecorder()
+            recorder.start_raw_recording()
+            self.assertTrue(recorder.start_capture(path))
+            frame = build_frame(0x31, b"\x01\x02")
+            recorder.record_raw_frame(datetime.now(), frame, "RX")
+            self.assertEqual(recorder.stop_capture()['records'], 1)
+            self.assertEqual([entry['data'] for entry in recorder.recorded_raw_data], [frame.hex()])
+
+    def test_stop_capture_flushes_pending_in_ns(self):
+        """测试停止录制时未成帧的剩余数据以纳秒时间戳写出"""
+        with tempfile.TemporaryDirectory() as tmpdir:
+            path = os.path.join(tmpdir, "rec.yjcap")
+            recorder = DataRecorder()
+            self.assertTrue(recorder.start_capture(path))
+            partial = build_frame(0x31, b"\x01\x02")[:4]
+            recorder.record_raw_frame(datetime.now(), partial, "RX")
+            before_ns = time.time_ns()
+            recorder.stop_capture()
+            after_ns = time.time_ns()
+            with CaptureReader(path) as reader:
+                records = [(r.ts_ns, r.status, bytes(r.data)) for r in reader]
+            self.assertEqual(len(records), 1)
+            ts_ns, status, data = records[0]
+            self.assertEqual((status, data), (capture_file.STATUS_RAW, partial))
+            self.assertTrue(before_ns <= ts_ns <= after_ns)
+
+
+if __name__ == '__main__':
+    unittest.main()
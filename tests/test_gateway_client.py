@@ -0,0 +1,198 @@
+"""多串口网关客户端(gateway_client)测试模块"""
+
+import unittest
+import sys
+import os
+import select
+import shutil
+import socket
+import subprocess
+import tempfile
+import time
+import tty
+
+# 添加项目根目录到Python路径
+sys.path.insert(0, os.path.abspath(os.path.join(os.path.dirname(__file__), '..')))
+
+from core import gateway_client
+from core.gateway_client import GatewayClient, GatewayRecord
+
+GATEWAY_BIN = os.environ.get("YJ_GATEWAY_BIN") or shutil.which("yj_gateway")
+
+
+def build_frame(d_addr: int, func_id: int, data: bytes, s_addr: int = 0x01) -> bytes:
+    """按原始求和/累加校验模式组帧"""
+    frame = bytes([0xAB, s_addr, d_addr, func_id, len(data) & 0xFF, len(data) >> 8]) + data
+    sc = ac = 0
+    for byte in frame:
+        sc = (sc + byte) & 0xFF
+        ac = (ac + sc) & 0xFF
+    return frame + bytes([sc, ac])
+
+
+class TestGatewayRecords(unittest.TestCase):
+    """记录编解码的测试"""
+
+    def test_roundtrip_multiple_records(self):
+        """测试多条记录拼接后逐条解析"""
+        message = (gateway_client.encode_record(gateway_client.REC_FRAME, 3, b"\x01\x02", ts_ns=123,
+                                                s_addr=1, d_addr=2, func_id=0x10)
+                   + gateway_client.encode_record(gateway_client.REC_PORT_CLOSED, 5))
+        records = list(gateway_client.iter_records(message))
+        self.assertEqual(records[0], GatewayRecord(gateway_client.REC_FRAME, 3, 123, 1, 2, 0x10, 0, b"\x01\x02"))
+        self.assertEqual(records[1].type, gateway_client.REC_PORT_CLOSED)
+        self.assertEqual(records[1].port, 5)
+
+    def test_truncated_record_stops_parsing(self):
+        """测试截断的记录不会越界解析"""
+        message = gateway_client.encode_tx(0, 2, 0x20, b"abcd")
+        self.assertEqual(len(list(gateway_client.iter_records(message[:-1]))), 0)
+        self.assertEqual(len(list(gateway_client.iter_records(message + b"\x00" * 3))), 1)
+
+
+@unittest.skipUnless(GATEWAY_BIN and sys.platform.startswith("linux"), "未找到yj_gateway可执行文件")
+class TestGatewayDaemon(unittest.TestCase):
+    """通过伪终端驱动真实网关进程的测试"""
+
+    PORTS = 3
+
+    def setUp(self):
+        self.tmp_dir = tempfile.mkdtemp()
+        self.socket_path = os.path.join(self.tmp_dir, "gw.sock")
+        self.masters = []
+        slaves = []
+        for _ in range(self.PORTS):
+            master, slave = os.openpty()
+            tty.setraw(master)
+            self.masters.append(master)
+            slaves.append(os.ttyname(slave))
+            self.addCleanup(os.close, slave)  # 保持从端打开, 避免网关打开前出现挂断
+        self.proc = subprocess.Popen([GATEWAY_BIN, "--socket", self.socket_path] + slaves,
+                                     stderr=subprocess.DEVNULL)
+        deadline = time.time() + 5
+        while not os.path.exists(self.socket_path) and time.time() < deadline:
+            time.sleep(0.01)
+        self.client = GatewayClient(self.socket_path, timeout=5)
+
+    def tearDown(self):
+        self.client.close()
+        self.proc.terminate()
+        self.proc.wait(timeout=5)
+        for master in self.masters:
+            os.close(master)
+        shutil.rmtree(self.tmp_dir, ignore_errors=True)
+
+    def _collect_frames(self, count):
+        frames = []
+        while len(frames) < count:
+            frames.extend(r for r in self.client.recv() if r.type == gateway_client.REC_FRAME)
+        return frames
+
+    def test_initial_port_status(self):
+        """测试连接后收到所有端口的打开状态"""
+        while len(self.client.ports) < self.PORTS:
+            self.client.recv()
+        self.assertTrue(all(path for path in self.client.ports.values()))
+
+    def test_frames_from_all_ports(self):
+        """测试各端口的帧(含帧间噪声和拆分写入)都被转发并标明端口号"""
+        for port, master in enumerate(self.masters):
+            data = build_frame(0x02, 0x10 + port, bytes([port] * 8))
+            os.write(master, b"\x00\x55" + data[:5])
+            os.write(master, data[5:] + build_frame(0x02, 0x30, b"x"))
+        frames = self._collect_frames(2 * self.PORTS)
+        by_port = {}
+        for frame in frames:
+            by_port.setdefault(frame.port, []).append(frame)
+        for port in range(self.PORTS):
+            self.assertEqual([f.func_id for f in by_port[port]], [0x10 + port, 0x30])
+            self.assertEqual(by_port[port][0].data, bytes([port] * 8))
+
+    def test_tx_record_writes_frame(self):
+        """测试TX记录经指定端口发出完整帧"""
+        self.client.send_frame(1, 0x05, 0x42, b"hello")
+        expected = build_frame(0x05, 0x42, b"hello")
+        received = b""
+        deadline = time.time() + 5
+        while len(received) < len(expected) and time.time() < deadline:
+            received += os.read(self.masters[1], 256)
+        self.assertEqual(received, expected)
+
+    def test_tx_burst_beyond_tty_buffer(self):
+        """测试连续下发超过串口缓冲区的数据时帧按序完整发出, 网关仍能转发上行帧"""
+        payloads = [bytes([i]) * 200 for i in range(120)]  # 约25KB, 超过伪终端约20KB的缓冲区
+        for payload in payloads:
+            self.client.send_frame(2, 0x05, 0x42, payload)
+        os.write(self.masters[0], build_frame(0x02, 0x11, b"up"))
+        self.assertEqual(self._collect_frames(1)[0].func_id, 0x11)
+        expected = b"".join(build_frame(0x05, 0x42, payload) for payload in payloads)
+        received = b""
+        deadline = time.time() + 5
+        while len(received) < len(expected) and time.time() < deadline:
+            if select.select([self.masters[2]], [], [], 0.1)[0]:
+                received += os.read(self.masters[2], 4096)
+        self.assertEqual(received, expected)
+
+
+@unittest.skipUnless(GATEWAY_BIN and sys.platform.startswith("linux"), "未找到yj_gateway可执行文件")
+class TestGatewaySocketPath(unittest.TestCase):
+    """套接字路径上已有文件时的处理"""
+
+    def setUp(self):
+        self.tmp_dir = tempfile.mkdtemp()
+        self.addCleanup(shutil.rmtree, self.tmp_dir, ignore_errors=True)
+        self.socket_path = os.path.join(self.tmp_dir, "gw.sock")
+        master, slave = os.openpty()
+        self.addCleanup(os.close, master)
+        self.addCleanup(os.close, slave)
+        self.tty_path = os.ttyname(slave)
+
+    def _start(self):
+        proc = subprocess.Popen([GATEWAY_BIN, "--socket", self.socket_path, self.tty_path],
+                                stderr=subprocess.DEVNULL)
+        self.addCleanup(proc.wait, 5)
+        self.addCleanup(proc.kill)
+        return proc
+
+    def _connect(self):
+        """重试连接直到网关开始监听"""
+        deadline = time.time() + 5
+        while True:
+            try:
+                client = GatewayClient(self.socket_path, timeout=5)
+                break
+            except OSError:
+                if time.time() > deadline:
+                    raise
+                time.sleep(0.01)
+        self.addCleanup(client.close)
+        while not client.ports:
+            client.recv()
+        return client
+
+    def test_refuses_regular_file(self):
+        """测试路径上是普通文件时拒绝启动且不删除该文件"""
+        with open(self.socket_path, "w") as f:
+            f.write("keep")
+        self.assertNotEqual(self._start().wait(timeout=5), 0)
+        with open(self.socket_path) as f:
+            self.assertEqual(f.read(), "keep")
+
+    def test_replaces_stale_socket(self):
+        """测试无人监听的遗留套接字被清理后正常启动"""
+        stale = socket.socket(socket.AF_UNIX, socket.SOCK_SEQPACKET)
+        stale.bind(self.socket_path)
+        stale.close()
+        self._start()
+        self._connect()
+
+    def test_refuses_running_gateway(self):
+        """测试已有网关在监听时第二个实例拒绝启动, 原网关仍可连接"""
+        self._start()
+        self._connect()
+        self.assertNotEqual(self._start().wait(timeout=5), 0)
+        self._connect()
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,181 @@
+"""native_protocol测试模块"""
+
+import unittest
+import struct
+import sys
+import os
+from array import array
+
+# 添加项目根目录到Python路径
+sys.path.insert(0, os.path.abspath(os.path.join(os.path.dirname(__file__), '..')))
+
+from core import native_protocol
+from core.native_protocol import (FrameSpan, ColumnDecodeResult, allocate_columns,
+                                  decode_columns, make_layout, scan_frames)
+from utils.constants import ChecksumMode
+
+
+def build_frame(func_id: int, payload: bytes, crc: bool = False) -> bytes:
+    """按C实现构建完整帧"""
+    body = bytes([0xAB, 0x01, 0x02, func_id, len(payload) & 0xFF, len(payload) >> 8]) + payload
+    if crc:
+        value = 0xFFFF
+        for byte in body:
+            value ^= byte << 8
+            for _ in range(8):
+                value = ((value << 1) ^ 0x1021) & 0xFFFF if value & 0x8000 else (value << 1) & 0xFFFF
+        return body + bytes([value >> 8, value & 0xFF])
+    sc = ac = 0
+    for byte in body:
+        sc = (sc + byte) & 0xFF
+        ac = (ac + sc) & 0xFF
+    return body + bytes([sc, ac])
+
+
+class TestScanFrames(unittest.TestCase):
+    """整块帧扫描测试（原生扩展不可用时测试纯Python回退实现）"""
+
+    def test_multiple_frames_with_noise(self):
+        """测试噪声字节与多帧"""
+        f1 = build_frame(0xC0, b"\x11\x22")
+        f2 = build_frame(0xC1, b"")
+        data = b"\x00\x55" + f1 + b"\x99" + f2
+        frames, consumed = scan_frames(data)
+        self.assertEqual(frames, [
+            FrameSpan(2, len(f1), 0xC0, 0x01, 0x02, True),
+            FrameSpan(3 + len(f1), len(f2), 0xC1, 0x01, 0x02, True),
+        ])
+        self.assertEqual(consumed, len(data))
+
+    def test_partial_frame_not_consumed(self):
+        """测试末尾不完整帧保留在缓冲区"""
+        f1 = build_frame(0x10, b"abc")
+        frames, consumed = scan_frames(f1 + f1[:5])
+        self.assertEqual(len(frames), 1)
+        self.assertEqual(consumed, len(f1))
+
+    def test_checksum_error_reported(self):
+        """测试校验失败的帧被报告并整帧跳过"""
+        bad = bytearray(build_frame(0x20, b"\x01\x02"))
+        bad[-1] ^= 0xFF
+        good = build_frame(0x21, b"\x03")
+        frames, consumed = scan_frames(bytes(bad) + good)
+        self.assertEqual([f.checksum_ok for f in frames], [False, True])
+        self.assertEqual(consumed, len(bad) + len(good))
+
+    def test_oversized_length_resyncs(self):
+        """测试数据长度超限的伪帧头只丢弃1字节"""
+        good = build_frame(0x30, b"\x05")
+        data = b"\xAB\x00\x00\x00\xFF\xFF" + good
+        frames, _ = scan_frames(data, max_payload=256)
+        self.assertEqual([f.offset for f in frames], [6])
+
+    def test_frame_length_limited_to_16_bits(self):
+        """测试整帧超过0xFFFF字节的数据长度按超限处理"""
+        good = build_frame(0x32, b"\x06")
+        huge = build_frame(0x33, bytes(0xFFF8))
+        frames, consumed = scan_frames(huge + good, max_payload=0xFFFF)
+        self.assertEqual([f.func_id for f in frames], [0x32])
+        self.assertEqual(consumed, len(huge) + len(good))
+
+    def test_crc16_mode(self):
+        """测试CRC16模式"""
+        frame = build_frame(0x31, b"\x10\x20\x30", crc=True)
+        frames, _ = scan_frames(memoryview(frame), ChecksumMode.CRC16_CCITT_FALSE)
+        self.assertTrue(frames[0].checksum_ok)
+        frames, _ = scan_frames(frame, ChecksumMode.ORIGINAL_SUM_ADD)
+        self.assertFalse(frames[0].checksum_ok)
+
+    def test_max_frames(self):
+        """测试帧数上限"""
+        frame = build_frame(0x40, b"\x00")
+        frames, consumed = scan_frames(frame * 3, max_frames=2)
+        self.assertEqual(len(frames), 2)
+        self.assertEqual(consumed, 2 * len(frame))
+
+    @unittest.skipUnless(native_protocol.is_available(), "原生扩展未编译")
+    def test_native_matches_python(self):
+        """测试原生实现与纯Python实现结果一致"""
+        data = (b"\x01" + build_frame(0x50, b"xyz") + b"\xAB\x01" +
+                build_frame(0x51, bytes(range(40)), crc=True) + build_frame(0x52, b"\x00")[:7])
+        for mode in ChecksumMode:
+            self.assertEqual(
+                scan_frames(data, mode),
+                native_protocol._scan_frames_python(data, mode, 0xAB, 256, 0)
+            )
+
+
+class TestDecodeColumns(unittest.TestCase):
+    """批量列解码测试"""
+
+    def setUp(self):
+        self.layout = make_layout([(0, "int16_t"), (2, "float (4B)"), (6, "uint8_t")])
+
+    def _samples(self, count):
+        return [build_frame(0xC0, struct.pack('<hfB', -i, i * 0.5, i & 0xFF)) for i in range(count)]
+
+    def test_decode_matching_frames(self):
+        """测试按布局解码并按功能ID过滤"""
+        frames = self._samples(3)
+        data = frames[0] + b"\x00" + build_frame(0xC1, bytes(7)) + frames[1] + frames[2]
+        columns = [array('d', [0.0] * 8) for _ in range(3)]
+        result = decode_columns(data, self.layout, columns, func_id=0xC0)
+        self.assertEqual(result, ColumnDecodeResult(3, len(data), 0, 1))
+        self.assertEqual(list(columns[0][:3]), [0.0, -1.0, -2.0])
+        self.assertEqual(list(columns[1][:3]), [0.0, 0.5, 1.0])
+        self.assertEqual(list(columns[2][:3]), [0.0, 1.0, 2.0])
+
+    def test_short_payload_and_checksum_error(self):
+        """测试负载长度不足的帧被跳过、校验失败的帧被计数"""
+        bad = bytearray(self._samples(1)[0])
+        bad[-2] ^= 0x01
+        data = bytes(bad) + build_frame(0xC0, b"\x01\x02") + self._samples(2)[1]
+        columns = [array('d', [0.0] * 4) for _ in range(3)]
+        result = decode_columns(data, self.layout, columns)
+        self.assertEqual(result, ColumnDecodeResult(1, len(data), 1, 1))
+        self.assertEqual(columns[0][0], -1.0)
+
+    def test_capacity_stops_at_next_frame(self):
+        """测试列数组写满后停在下一帧起点"""
+        frames = self._samples(5)
+        columns = [array('d', [0.0] * 2) for _ in range(3)]
+        result = decode_columns(b"".join(frames), self.layout, columns)
+        self.assertEqual(result.rows, 2)
+        self.assertEqual(result.consumed, len(frames[0]) * 2)
+
+    def test_field_offset_near_limit(self):
+        """测试偏移接近0xFFFF的字段只会使帧被跳过"""
+        frame = build_frame(0x10, struct.pack("<H", 7))
+        columns = [array('d', [0.0] * 4) for _ in range(2)]
+        layout = make_layout([(0, "uint16_t"), (0xFFF7, "double (8B)")])
+        result = decode_columns(frame, layout, columns, max_payload=0xFFFF)
+        self.assertEqual((result.rows, result.skipped_frames), (0, 1))
+
+    def test_allocate_columns(self):
+        """测试列数组分配"""
+        columns = allocate_columns(3, 16)
+        self.assertEqual(len(columns), 3)
+        self.assertTrue(all(len(column) == 16 for column in columns))
+        result = decode_columns(b"".join(self._samples(4)), self.layout, columns)
+        self.assertEqual(result.rows, 4)
+
+    @unittest.skipUnless(native_protocol.is_available(), "原生扩展未编译")
+    def test_native_matches_python(self):
+        """测试原生实现与纯Python实现结果一致"""
+        layout = make_layout([(0, "uint16_t"), (2, "int32_t"), (6, "double (8B)"), (14, "int8_t")])
+        frames = [build_frame(0x10 + (i % 2), struct.pack('<HidbB', i, -i * 1000, i / 3, -(i % 128), 0), crc=True)
+                  for i in range(300)]
+        data = b"\xAB\x00" + b"\x55".join(frames) + frames[0][:9]
+        native_cols = [array('d', [0.0] * 200) for _ in range(4)]
+        python_cols = [array('d', [0.0] * 200) for _ in range(4)]
+        for func_id in (None, 0x11):
+            native_result = decode_columns(data, layout, native_cols, func_id, ChecksumMode.CRC16_CCITT_FALSE)
+            python_result = native_protocol._decode_columns_python(
+                data, layout, python_cols, -1 if func_id is None else func_id,
+                ChecksumMode.CRC16_CCITT_FALSE, 0xAB, 256)
+            self.assertEqual(native_result, python_result)
+            self.assertEqual(native_cols, python_cols)
+
+
+if __name__ == '__main__':
+    unittest.main()
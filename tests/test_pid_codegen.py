@@ -0,0 +1,1208 @@
+"""PID代码生成核心(pid_codegen)测试模块"""
+
+import unittest
+import sys
+import os
+import json
+import math
+import shutil
+import struct
+import subprocess
+import tempfile
+from collections import deque
+from pathlib import Path
+
+# 添加项目根目录到Python路径
+sys.path.insert(0, os.path.abspath(os.path.join(os.path.dirname(__file__), '..')))
+
+from panel_plugins.pid_code_generator.pid_codegen import PIDDataModel, PIDCodeGenerator, main
+from panel_plugins.pid_code_generator import pid_fixed
+from panel_plugins.pid_code_generator import pid_sweep
+from panel_plugins.pid_code_generator import pid_autotune
+from panel_plugins.pid_code_generator import pid_telemetry
+
+PROTOCOL_DIR = Path(__file__).resolve().parents[1] / "protocol"
+
+# 检查程序共用: CHECK 不成立时打印编号并以该编号退出
+CHECK_PRELUDE = r"""
+#include <stdio.h>
+
+#define CHECK(id, cond) do { if (!(cond)) { printf("check %d failed\n", id); return id; } } while (0)
+"""
+
+# 协议帧检查程序共用: 发送的字节暂存到 tx(link_down 置1时模拟发送失败),
+# 再经协议接收状态机解析, 以 "FRAME <功能码> <负载>" 输出
+FRAME_PRELUDE = CHECK_PRELUDE + r"""#include "yj_protocol.h"
+
+static uint8_t tx[262144];
+static uint32_t tx_len;
+static int link_down;
+
+static int32_t capture_byte(uint8_t byte) {
+    if (link_down || tx_len >= sizeof(tx)) return -1;
+    tx[tx_len++] = byte;
+    return 0;
+}
+
+static void print_frame(yj_frame_t *frame) {
+    printf("FRAME %02X ", frame->func_id);
+    for (uint16_t i = 0; i < frame->data_len; ++i) printf("%02X", frame->data[i]);
+    printf("\n");
+}
+"""
+
+# 同一组配置分别用逐实例 PID_Compute 和控制器组 PID_ComputeBatch 闭环运行, 比较每步输出
+BANK_CHECK_SOURCE = r"""
+#include <stdio.h>
+#include <math.h>
+#include "pid_bank.h"
+
+#define CHANNELS 13
+#define STEPS 400
+
+static void configure(PID_HandleTypeDef *pid, int ch) {
+    PID_Init(pid, 0.5f + 0.1f * ch, 0.2f + 0.05f * ch, 0.002f * (ch % 4), 0.01f * (1 + ch % 3));
+    PID_SetOutputLimits(pid, 50.0f + ch);
+    PID_SetIntegralLimits(pid, 20.0f);
+    PID_SetType(pid, (PID_Type)(ch % 3));
+    PID_SetWorkMode(pid, (ch % 5 == 4) ? PID_MODE_VELOCITY : PID_MODE_POSITION);
+    if (ch % 2) PID_SetDFilter(pid, 0.3f);
+    if (ch % 3 == 1) PID_SetInputFilter(pid, 0.5f);
+    if (ch % 4 == 2) PID_SetSetpointFilter(pid, 0.2f);
+    if (ch % 4 == 3) PID_SetDeadband(pid, 0.05f);
+    if (ch % 5 == 1) PID_SetIntegralSeparationThreshold(pid, 2.0f);
+    if (ch % 6 == 5) PID_SetOutputRamp(pid, 200.0f);
+    if (ch % 7 == 3) PID_SetFeedForwardParams(pid, 0.4f, 0.5f);
+    if (ch % 4 == 1) PID_SetIntegrationMethod(pid, PID_INTEGRATION_TRAPEZOIDAL);
+    if (ch % 3 == 2) PID_SetIntegralHold(pid, (ch % 2) ? -1 : 1);
+}
+
+int main(void) {
+    static PID_HandleTypeDef scalar[CHANNELS], loaded[CHANNELS];
+    static PID_BankTypeDef bank;
+    float plant_s[CHANNELS] = {0}, plant_b[CHANNELS] = {0};
+    float sp[CHANNELS], out_b[CHANNELS];
+    double max_err = 0.0;
+
+    PID_BankInit(&bank);
+    for (int ch = 0; ch < CHANNELS; ++ch) {
+        configure(&scalar[ch], ch);
+        configure(&loaded[ch], ch);
+        if (!PID_BankLoad(&bank, (uint32_t)ch, &loaded[ch])) return 2;
+    }
+    if (PID_BankLoad(&bank, PID_BANK_CAPACITY, &loaded[0])) return 3;
+
+    for (int step = 0; step < STEPS; ++step) {
+        if (step == 100) { PID_SetMode(&scalar[6], PID_MODE_MANUAL); PID_BankSetMode(&bank, 6, PID_MODE_MANUAL); }
+        if (step == 200) { PID_SetMode(&scalar[6], PID_MODE_AUTOMATIC); PID_BankSetMode(&bank, 6, PID_MODE_AUTOMATIC); }
+        if (step == 250) { PID_SetIntegralHold(&scalar[2], 0); PID_BankSetIntegralHold(&bank, 2, 0); }
+        if (step == 300) { PID_SetIntegralHold(&scalar[7], 1); PID_BankSetIntegralHold(&bank, 7, 1); }
+        for (int ch = 0; ch < CHANNELS; ++ch) sp[ch] = (step < 150) ? 10.0f + ch : -5.0f;
+        PID_ComputeBatch(&bank, sp, plant_b, out_b, CHANNELS);
+        for (int ch = 0; ch < CHANNELS; ++ch) {
+            float out_s = PID_Compute(&scalar[ch], sp[ch], plant_s[ch]);
+            double err = fabs((double)out_s - (double)out_b[ch]);
+            if (err > max_err) max_err = err;
+            plant_s[ch] += 0.05f * (out_s - plant_s[ch]);
+            plant_b[ch] += 0.05f * (out_b[ch] - plant_b[ch]);
+        }
+    }
+    PID_BankStore(&bank, 3, &loaded[3]);
+    printf("max_err=%.9f integral=%.6f/%.6f\n", max_err, (double)loaded[3].integral, (double)scalar[3].integral);
+    return (max_err < 1e-3 && fabs((double)(loaded[3].integral - scalar[3].integral)) < 1e-4) ? 0 : 1;
+}
+"""
+
+
+class TestPIDCodegen(unittest.TestCase):
+    """模板实例化与命令行入口的测试"""
+
+    def setUp(self):
+        self.tmp_dir = Path(tempfile.mkdtemp())
+
+    def tearDown(self):
+        shutil.rmtree(self.tmp_dir, ignore_errors=True)
+
+    def _write_library(self, generator: PIDCodeGenerator) -> None:
+        """把生成的头文件、源文件和附加文件写入临时目录"""
+        (self.tmp_dir / "pid.h").write_text(generator.generate_header_code(), encoding='utf-8')
+        (self.tmp_dir / "pid.c").write_text(generator.generate_source_code(), encoding='utf-8')
+        for name, code in generator.generate_extra_files().items():
+            (self.tmp_dir / name).write_text(code, encoding='utf-8')
+
+    def _build_and_run(self, name: str, source: str, extra_sources=(), flags=("-O2",),
+                       generator: PIDCodeGenerator = None) -> subprocess.CompletedProcess:
+        """
+        编译检查程序 <name>.c 并运行, 断言返回码为0
+
+        Args:
+            extra_sources: 除 pid.c 外参与链接的源文件, 相对路径按临时目录解析
+            generator: 给出时先把生成的库写入临时目录, 否则使用命令行已生成的文件
+        """
+        if generator is not None:
+            self._write_library(generator)
+        (self.tmp_dir / f"{name}.c").write_text(source, encoding='utf-8')
+        exe = self.tmp_dir / name
+        subprocess.run(["cc", *flags, "-Wall", "-Werror", "-I", str(PROTOCOL_DIR), str(self.tmp_dir / f"{name}.c"),
+                        str(self.tmp_dir / "pid.c"), *(str(self.tmp_dir / src) for src in extra_sources),
+                        "-lm", "-o", str(exe)], check=True)
+        result = subprocess.run([str(exe)], capture_output=True, text=True)
+        self.assertEqual(result.returncode, 0, result.stdout)
+        return result
+
+    def test_placeholders_fully_replaced(self):
+        """测试生成代码中不残留模板占位符"""
+        model = PIDDataModel()
+        model.update_code_config({PIDDataModel.C_USE_FLOAT: False,
+                                  PIDDataModel.C_FUNC_PREFIX: "Motor"})
+        model.add_instance("speed")
+        generator = PIDCodeGenerator(model)
+        for code in (generator.generate_header_code(),
+                     generator.generate_source_code(),
+                     generator.generate_main_code(),
+                     generator.generate_bank_header_code(),
+                     generator.generate_bank_source_code()):
+            self.assertNotIn("{{", code)
+            self.assertNotIn("// Error", code)
+        self.assertIn("Motor_Init(&speed", generator.generate_main_code())
+        self.assertIn("double", generator.generate_header_code())
+
+    def test_cli_writes_library(self):
+        """测试命令行生成头文件/源文件/示例main"""
+        rc = main(["--out-dir", str(self.tmp_dir), "--header", "motor_pid.h", "--main"])
+        self.assertEqual(rc, 0)
+        for name in ("motor_pid.h", "motor_pid.c", "motor_pid_main.c"):
+            self.assertTrue((self.tmp_dir / name).is_file(), name)
+        self.assertIn('#include "motor_pid.h"', (self.tmp_dir / "motor_pid.c").read_text(encoding='utf-8'))
+
+    @unittest.skipUnless(shutil.which("cc"), "未找到C编译器")
+    def test_generated_code_compiles(self):
+        """测试生成的库与示例可以编译运行"""
+        self.assertEqual(main(["--out-dir", str(self.tmp_dir), "--main"]), 0)
+        exe = self.tmp_dir / "pid_example"
+        subprocess.run(["cc", "-Wall", "-Werror", str(self.tmp_dir / "pid.c"),
+                        str(self.tmp_dir / "pid_main.c"), "-lm", "-o", str(exe)], check=True)
+        result = subprocess.run([str(exe)], capture_output=True, text=True, check=True)
+        self.assertIn("pid_example", result.stdout)
+
+    @unittest.skipUnless(shutil.which("cc"), "未找到C编译器")
+    def test_bank_matches_scalar(self):
+        """测试控制器组批量计算与逐实例计算结果一致(覆盖各PID类型、滤波、死区、斜率限制、梯形积分、积分保持和手动切换)"""
+        self.assertEqual(main(["--out-dir", str(self.tmp_dir), "--bank"]), 0)
+        self._build_and_run("bank_check", BANK_CHECK_SOURCE, ["pid_bank.c"], flags=("-O3",))
+
+    @unittest.skipUnless(shutil.which("gcc"), "未找到GCC")
+    def test_bank_kernel_vectorizes(self):
+        """测试批量计算主循环被GCC自动向量化"""
+        self.assertEqual(main(["--out-dir", str(self.tmp_dir), "--bank"]), 0)
+        source = self.tmp_dir / "pid_bank.c"
+        lines = source.read_text(encoding='utf-8').splitlines()
+        start = next(i for i, line in enumerate(lines) if "_ComputeBatch(" in line)
+        loop_line = next(i for i in range(start, len(lines)) if lines[i].lstrip().startswith("for (")) + 1
+        report = subprocess.run(["gcc", "-O3", "-fopt-info-vec-optimized", "-c", str(source),
+                                 "-o", str(self.tmp_dir / "pid_bank.o")],
+                                capture_output=True, text=True, check=True).stderr
+        self.assertIn(f"pid_bank.c:{loop_line}:", report)
+
+    @unittest.skipUnless(shutil.which("cc"), "未找到C编译器")
+    def test_specialized_matches_generic(self):
+        """测试实例专用计算函数与通用 PID_Compute 逐位一致(含积分保持、超过积分分离阈值的大误差和梯形积分), 且未启用的功能不出现在生成代码中"""
+        model = PIDDataModel()
+        model.update_code_config({PIDDataModel.C_GEN_SPECIALIZED: True})
+        variants = {
+            "plain": {},
+            "pi_vel": {"kd": 0.0, "work_mode": "velocity"},
+            "full": {"input_filter_coef": 0.5, "setpoint_filter_coef": 0.2, "deadband": 0.05,
+                     "integral_separation_threshold": 2.0, "d_filter_coef": 0.3, "output_ramp": 200.0,
+                     "kff": 0.4, "ff_weight": 0.5},
+            "ipd": {"pid_type": "i_pd", "ki": 0.0, "deadband": 0.1, "d_filter_coef": 0.6},
+            "pi_d_vel": {"pid_type": "pi_d", "work_mode": "velocity", "output_ramp": 50.0, "kd": 0.05},
+        }
+        for name, params in variants.items():
+            model.add_instance(name)
+            model.pid_instances[-1]["params"].update(params)
+        generator = PIDCodeGenerator(model)
+        extra = generator.generate_extra_files()
+        spec_source = extra["pid_spec.c"]
+        plain_body = spec_source.split("PID_Compute_plain(")[1].split("\n}")[0]
+        for field in ("input_filter_coef", "setpoint_filter_coef", "deadband", "d_filter_coef", "output_ramp", "Kff", "type", "work_mode"):
+            self.assertNotIn(field, plain_body)
+        self.assertNotIn("pid->Kd", spec_source.split("PID_Compute_pi_vel(")[1].split("\n}")[0])
+
+        # 每个实例用生成的初始化代码配置两份句柄, 分别由通用函数和专用函数闭环运行
+        init_lines, loops = [], []
+        for instance in model.pid_instances:
+            name = instance["name"]
+            init = [line for line in generator._get_instance_init_code(instance) if "printf" not in line]
+            for handle in (f"{name}_g", f"{name}_s"):
+                init_lines.extend(line.replace(f"&{name},", f"&{handle},") for line in init)
+            loops.append(f"    RUN({name});")
+        source = SPEC_CHECK_SOURCE.replace("/*HANDLES*/", " ".join(
+            f"static PID_HandleTypeDef {inst['name']}_g, {inst['name']}_s;" for inst in model.pid_instances))
+        source = source.replace("/*INIT*/", "\n".join(init_lines)).replace("/*RUN*/", "\n".join(loops))
+        self._build_and_run("spec_check", source, ["pid_spec.c"], flags=("-O2", "-ffp-contract=off"),
+                            generator=generator)
+
+    @unittest.skipUnless(shutil.which("cc"), "未找到C编译器")
+    def test_compute_with_time(self):
+        """测试变周期计算: Init换算增益, 周期等于采样时间时与Compute逐位一致, 增益不漂移, 异常周期限幅, 梯形积分, 修改采样时间后周期范围随之缩放"""
+        self.assertEqual(main(["--out-dir", str(self.tmp_dir)]), 0)
+        self._build_and_run("time_check", TIME_CHECK_SOURCE)
+
+    @unittest.skipUnless(shutil.which("cc"), "未找到C编译器")
+    def test_split_matches_scalar(self):
+        """测试冷热分离布局: 生成的只读配置和由句柄换算的配置都与 PID_Compute 逐位一致, 调试项为编译选项"""
+        model = PIDDataModel()
+        model.update_code_config({PIDDataModel.C_GEN_SPLIT: True})
+        variants = {
+            "plain": {},
+            "full": {"input_filter_coef": 0.5, "setpoint_filter_coef": 0.2, "deadband": 0.05,
+                     "integral_separation_threshold": 2.0, "d_filter_coef": 0.3, "output_ramp": 200.0,
+                     "kff": 0.4, "ff_weight": 0.5, "sample_time": 0.003},
+            "ipd_vel": {"pid_type": "i_pd", "work_mode": "velocity", "d_filter_coef": 1.5, "max_output": -30.0},
+            "pi_d": {"pid_type": "pi_d", "integral_separation_threshold": 5000.0, "ff_weight": 2.0},
+        }
+        for name, params in variants.items():
+            model.add_instance(name)
+            model.pid_instances[-1]["params"].update(params)
+        generator = PIDCodeGenerator(model)
+        extra = generator.generate_extra_files()
+        self.assertNotIn("{{", extra["pid_split.h"] + extra["pid_split.c"])
+
+        init_lines, loops = [], []
+        for instance in model.pid_instances:
+            name = instance["name"]
+            init_lines.extend(line for line in generator._get_instance_init_code(instance) if "printf" not in line)
+            loops.append(f"    RUN({name});")
+        source = SPLIT_CHECK_SOURCE.replace("/*HANDLES*/", " ".join(
+            f"static PID_HandleTypeDef {inst['name']};" for inst in model.pid_instances))
+        source = source.replace("/*INIT*/", "\n".join(init_lines)).replace("/*RUN*/", "\n".join(loops))
+        self._build_and_run("split_check", source, ["pid_split.c"],
+                            flags=("-O2", "-ffp-contract=off", "-DPID_SPLIT_DEBUG_TERMS=1"), generator=generator)
+
+        # 默认不保存调试项, 状态块不含 last_* 字段
+        subprocess.run(["cc", "-std=c11", "-O2", "-Wall", "-Werror", "-c", str(self.tmp_dir / "pid_split.c"),
+                        "-o", str(self.tmp_dir / "pid_split.o")], check=True)
+        size_check = self.tmp_dir / "size_check.c"
+        size_check.write_text('#include "pid_split.h"\n'
+                              'int size_ok[(sizeof(PID_SplitStateTypeDef) <= 64) ? 1 : -1];\n', encoding='utf-8')
+        subprocess.run(["cc", "-Wall", "-c", str(size_check), "-o", str(self.tmp_dir / "size_check.o")], check=True)
+
+    def _cascade_model(self) -> PIDDataModel:
+        """位置(10ms) -> 速度(2ms) -> 电流(0.5ms) 三级串级"""
+        model = PIDDataModel()
+        loops = {
+            "pos": {"kp": 5.0, "ki": 0.5, "kd": 0.0, "sample_time": 0.01, "max_output": 100.0,
+                    "cascade_inner": "vel"},
+            "vel": {"kp": 0.5, "ki": 5.0, "kd": 0.0, "sample_time": 0.002, "max_output": 20.0,
+                    "integral_limit": 20.0, "cascade_inner": "cur"},
+            "cur": {"kp": 2.0, "ki": 200.0, "kd": 0.0, "sample_time": 0.0005, "max_output": 24.0,
+                    "integral_limit": 24.0},
+        }
+        for name, params in loops.items():
+            model.add_instance(name)
+            model.pid_instances[-1]["params"].update(params)
+        return model
+
+    def test_cascade_chain_validation(self):
+        """测试串级链整理: 分频系数由采样时间得出, 非整数倍和环状引用报错, 重命名/删除同步更新引用"""
+        model = self._cascade_model()
+        chains, errors = PIDCodeGenerator(model).cascade_chains()
+        self.assertEqual(errors, [])
+        self.assertEqual([[inst["name"] for inst in chain] for chain, _ in chains], [["pos", "vel", "cur"]])
+        self.assertEqual(chains[0][1], [20, 4, 1])
+
+        model.rename_instance(1, "speed")
+        self.assertEqual(model.pid_instances[0]["params"]["cascade_inner"], "speed")
+        model.pid_instances[1]["params"]["sample_time"] = 0.0012
+        _, errors = PIDCodeGenerator(model).cascade_chains()
+        self.assertTrue(any("整数倍" in e for e in errors))
+
+        model.pid_instances[2]["params"]["cascade_inner"] = "pos"
+        chains, errors = PIDCodeGenerator(model).cascade_chains()
+        self.assertEqual(chains, [])
+        self.assertTrue(any("首尾相连" in e for e in errors))
+
+        model.remove_instance(2)
+        self.assertEqual(model.pid_instances[1]["params"]["cascade_inner"], "")
+
+    @unittest.skipUnless(shutil.which("cc"), "未找到C编译器")
+    def test_cascade_compute(self):
+        """测试串级计算与手写的分频调用逐位一致, 且内环饱和时外环积分被保持"""
+        generator = PIDCodeGenerator(self._cascade_model())
+        extra = generator.generate_extra_files()
+        self.assertIn("bool PID_CascadeInit_pos(PID_CascadeTypeDef *cascade);", extra["pid_cascade.h"])
+        glue_init = []
+        for inst in generator.data_model.pid_instances:
+            glue_init.extend(line for line in generator._get_instance_init_code(inst) if "printf" not in line)
+        self._build_and_run("cascade_check", CASCADE_CHECK_SOURCE.replace("/*GLUE_INIT*/", "\n".join(glue_init)),
+                            ["pid_cascade.c"], generator=generator)
+
+    @unittest.skipUnless(shutil.which("cc"), "未找到C编译器")
+    def test_autotune_relay_experiment(self):
+        """测试继电器自整定: Ku/Pu接近FOPDT对象的理论临界值, 增益经SetTunings写入, 进度帧可被协议解析并解码"""
+        self.assertEqual(main(["--out-dir", str(self.tmp_dir), "--autotune"]), 0)
+        result = self._build_and_run("autotune_check", AUTOTUNE_CHECK_SOURCE,
+                                     ["pid_autotune.c", PROTOCOL_DIR / "yj_protocol.c"])
+
+        ku, pu, kp, ki, kd = (float(v) for v in result.stdout.split("RESULT ")[1].split()[:5])
+        # 对象 2·e^(-0.3s)/(0.5s+1), 零阶保持再加半个采样周期滞后: 相位穿越频率满足 0.305ω + atan(0.5ω) = π
+        lo, hi = 0.1, 100.0
+        for _ in range(100):
+            mid = 0.5 * (lo + hi)
+            lo, hi = (mid, hi) if 0.305 * mid + math.atan(0.5 * mid) < math.pi else (lo, mid)
+        ku_theory = math.sqrt(1.0 + (0.5 * lo) ** 2) / 2.0
+        self.assertAlmostEqual(pu, 2.0 * math.pi / lo, delta=0.1 * 2.0 * math.pi / lo)
+        self.assertAlmostEqual(ku, ku_theory, delta=0.2 * ku_theory)
+        self.assertAlmostEqual(kp, 0.6 * ku, places=4)
+        self.assertAlmostEqual(ki, 1.2 * ku / pu, places=3)
+        self.assertAlmostEqual(kd, 0.075 * ku * pu, places=4)
+
+        frames = {}
+        for line in result.stdout.splitlines():
+            if line.startswith("FRAME "):
+                _, func_id, payload = line.split()
+                self.assertEqual(int(func_id, 16), pid_autotune.AUTOTUNE_FUNC_ID)
+                progress = pid_autotune.decode_progress(bytes.fromhex(payload))
+                frames.setdefault(progress["id"], []).append(progress)
+        tuned = frames[3]
+        self.assertEqual(tuned[0]["state_name"], "实验中")
+        self.assertEqual([f["cycles"] for f in tuned], sorted(f["cycles"] for f in tuned))
+        self.assertEqual(tuned[-1]["state"], pid_autotune.STATE_DONE)
+        self.assertEqual(tuned[-1]["cycles"], tuned[-1]["target_cycles"])
+        self.assertAlmostEqual(tuned[-1]["kp"], kp, places=4)
+        self.assertAlmostEqual(tuned[-1]["pu"], pu, places=4)
+        self.assertEqual(frames[4][-1]["state_name"], "偏差超限")
+        self.assertEqual(frames[5][-1]["state_name"], "已取消")
+
+        model = PIDDataModel()
+        model.add_instance("axis")
+        self.assertFalse(pid_autotune.apply_progress(model, "axis", frames[4][-1]))
+        self.assertTrue(pid_autotune.apply_progress(model, "axis", tuned[-1]))
+        self.assertAlmostEqual(model.pid_instances[0]["params"][PIDDataModel.P_KI], ki, places=3)
+
+    @unittest.skipUnless(shutil.which("cc"), "未找到C编译器")
+    def test_schedule_interpolation(self):
+        """测试增益调度: 等间距直接索引与二分查找的插值结果正确, 端点和断点处与SetTunings逐位一致, 错误表不生成"""
+        model = PIDDataModel()
+        schedules = {
+            "uni": (0.01, [[30, 4.0, 8.0, 0.0], [0, 1.0, 2.0, 0.1], [10, 2.0, 4.0, 0.2], [20, 3.0, 5.0, 0.05]]),
+            "nonuni": (0.002, [[-5, 0.5, 1.0, 0.01], [0, 0.8, 3.0, 0.02], [2.5, 1.7, 3.3, 0.0], [40, 2.2, 10.0, 0.3]]),
+            "bad": (0.01, [[1, 1.0, 1.0, 0.0], [1, 2.0, 2.0, 0.0]]),
+        }
+        for name, (ts, rows) in schedules.items():
+            model.add_instance(name)
+            model.pid_instances[-1]["params"].update({"sample_time": ts, "gain_schedule": rows})
+        model.add_instance("plain")
+        generator = PIDCodeGenerator(model)
+        _, uniform, _ = generator.schedule_table(model.pid_instances[0])
+        self.assertTrue(uniform)
+        self.assertFalse(generator.schedule_table(model.pid_instances[1])[1])
+        self.assertIn("调度变量有重复的断点", generator.schedule_table(model.pid_instances[2])[2])
+
+        extra = generator.generate_extra_files()
+        header, source = extra["pid_schedule.h"], extra["pid_schedule.c"]
+        self.assertNotIn("{{", header + source)
+        self.assertIn("增益调度设置错误, 未生成: bad", header)
+        self.assertNotIn("plain_schedule", header)
+        self.assertIn(".uniform = 1", source)
+        self.assertIn(".uniform = 0", source)
+
+        probes = {"uni": [-3.0, 0.0, 4.0, 10.0, 15.5, 29.9, 30.0, 1e6],
+                  "nonuni": [-1e3, -5.0, -2.5, 0.0, 1.0, 2.5, 21.0, 40.0, 55.0]}
+        cases = []
+        for name, xs in probes.items():
+            values = ", ".join(f"{x!r}f" for x in xs)
+            cases.append(f"    {{ static const float xs[] = {{ {values} }}; "
+                         f"if (check(\"{name}\", &{name}_schedule, {schedules[name][0]!r}f, xs, {len(xs)})) return 1; }}")
+        result = self._build_and_run("schedule_check", SCHEDULE_CHECK_SOURCE.replace("/*CASES*/", "\n".join(cases)),
+                                     ["pid_schedule.c"], generator=generator)
+
+        looked = {}
+        for line in result.stdout.splitlines():
+            if line.startswith("LOOK "):
+                _, name, index, *values = line.split()
+                looked[(name, int(index))] = [float(v) for v in values]
+        for name, xs in probes.items():
+            ts, rows = schedules[name]
+            rows = sorted(rows)
+            for index, x in enumerate(xs + [math.nan]):
+                if not x > rows[0][0]:
+                    kp, ki, kd = rows[0][1:]
+                elif x >= rows[-1][0]:
+                    kp, ki, kd = rows[-1][1:]
+                else:
+                    i = max(k for k in range(len(rows) - 1) if rows[k][0] <= x)
+                    t = (x - rows[i][0]) / (rows[i + 1][0] - rows[i][0])
+                    kp, ki, kd = (a + t * (b - a) for a, b in zip(rows[i][1:], rows[i + 1][1:]))
+                expected = [kp, ki * ts, kd / ts, ki, kd]
+                for got, want in zip(looked[(name, index)], expected):
+                    self.assertAlmostEqual(got, want, delta=1e-5 * max(1.0, abs(want)), msg=f"{name} x={x}")
+
+    @unittest.skipUnless(shutil.which("cc"), "未找到C编译器")
+    def test_telemetry_batches(self):
+        """测试遥测: 抽取后的记录经批量帧逐位还原, 缓冲满时报告丢失并在间隔处断帧, 发送失败重发, 触发采集含预触发历史"""
+        self.assertEqual(main(["--out-dir", str(self.tmp_dir), "--telemetry"]), 0)
+        result = self._build_and_run("telemetry_check", TELEMETRY_CHECK_SOURCE,
+                                     ["pid_telemetry.c", PROTOCOL_DIR / "yj_protocol.c"])
+
+        def f32(value: float) -> float:
+            return struct.unpack("<f", struct.pack("<f", value))[0]
+
+        truth, batches = {}, {}
+        for line in result.stdout.splitlines():
+            if line.startswith("LOG "):
+                _, stream, tick, channel, *values = line.split()
+                truth[(int(stream), int(tick), int(channel))] = [f32(float(v)) for v in values]
+            elif line.startswith("FRAME "):
+                _, func_id, payload = line.split()
+                self.assertEqual(int(func_id, 16), pid_telemetry.TELEMETRY_FUNC_ID)
+                batch = pid_telemetry.decode_batch(bytes.fromhex(payload))
+                batches.setdefault(batch["id"], []).append(batch)
+
+        def samples(stream: int) -> dict:
+            """按控制周期计数收集一路遥测的记录"""
+            out = {}
+            for batch in batches[stream]:
+                for index, record in enumerate(batch["records"]):
+                    out[batch["first_tick"] + index * batch["decimation"]] = record
+            return out
+
+        # 连续模式: 两个控制器全部字段, 每3个周期一条, 中途一次发送失败后重发
+        stream = samples(1)
+        self.assertEqual(sorted(stream), list(range(0, 300, 3)))
+        self.assertTrue(all(b["fields"] == list(pid_telemetry.FIELD_NAMES) and b["dropped"] == 0 for b in batches[1]))
+        # 每条记录56字节, 256字节负载最多4条; 发送失败后积压的记录分帧补发
+        self.assertEqual(max(len(b["records"]) for b in batches[1]), 4)
+        for tick, record in stream.items():
+            for channel, values in enumerate(record):
+                self.assertEqual([values[name] for name in pid_telemetry.FIELD_NAMES], truth[(1, tick, channel)])
+        t, channel, values = list(pid_telemetry.iter_samples(batches[1][1], 0.001))[1]
+        self.assertAlmostEqual(t, 0.012)
+        self.assertEqual(channel, 1)
+
+        # 缓冲满: 周期64~100的记录丢弃(周期100先采样后发送), 在下一帧报告, 帧不跨越间隔
+        stream = samples(2)
+        self.assertEqual(sorted(stream), list(range(64)) + list(range(101, 150)))
+        self.assertEqual(sum(b["dropped"] for b in batches[2]), 37)
+        self.assertTrue(any(b["first_tick"] == 101 for b in batches[2]))
+        self.assertEqual(batches[2][0]["fields"], ["setpoint", "measure", "output"])
+        for tick, record in stream.items():
+            self.assertEqual(list(record[0].values()), truth[(2, tick, 0)][:3])
+
+        # 触发采集: 设定值在周期150上升穿越, 保留之前10条和之后共20条
+        capture = batches[3]
+        stream = samples(3)
+        self.assertEqual(sorted(stream), list(range(140, 170)))
+        self.assertTrue(all(b["capture"] for b in capture))
+        self.assertEqual([b["last"] for b in capture], [False] * (len(capture) - 1) + [True])
+        self.assertEqual(stream[149][0]["setpoint"], 0.0)
+        self.assertEqual(stream[150][0]["setpoint"], 10.0)
+
+        with self.assertRaises(ValueError):
+            pid_telemetry.decode_batch(bytes.fromhex(payload)[:-1])
+
+    @unittest.skipUnless(shutil.which("cc"), "未找到C编译器")
+    def test_telemetry_payload_limit(self):
+        """测试遥测负载上限: 协议负载上限较小时默认随之缩小, 容纳不下帧头加一条记录时编译报错"""
+        self.assertEqual(main(["--out-dir", str(self.tmp_dir), "--telemetry"]), 0)
+
+        def compile_telemetry(*defines: str) -> subprocess.CompletedProcess:
+            return subprocess.run(["cc", "-c", "-Wall", "-Werror", "-I", str(PROTOCOL_DIR), *defines,
+                                   str(self.tmp_dir / "pid_telemetry.c"), "-o", str(self.tmp_dir / "pid_telemetry.o")],
+                                  capture_output=True, text=True)
+
+        result = compile_telemetry("-DYJ_MAX_DATA_PAYLOAD_SIZE=64")
+        self.assertEqual(result.returncode, 0, result.stderr)
+        result = compile_telemetry("-DPID_TELEMETRY_MAX_PAYLOAD=15")
+        self.assertNotEqual(result.returncode, 0)
+        self.assertIn("cannot hold the header plus one record", result.stderr)
+
+
+# 增益调度查表: 打印各探测点的插值结果(最后一个为NaN), 并检查端点、断点处 ScheduleApply 与 SetTunings 逐位一致
+SCHEDULE_CHECK_SOURCE = r"""
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "pid_schedule.h"
+
+static int same_gains(const PID_HandleTypeDef *a, const PID_HandleTypeDef *b) {
+    return a->Kp == b->Kp && a->Ki == b->Ki && a->Kd == b->Kd
+        && a->Ki_continuous == b->Ki_continuous && a->Kd_continuous == b->Kd_continuous;
+}
+
+static int check(const char *name, const PID_ScheduleTypeDef *s, float ts, const float *xs, int n) {
+    PID_ScheduleGainsTypeDef g;
+    PID_HandleTypeDef pid, ref;
+    for (int k = 0; k <= n; ++k) {
+        PID_ScheduleLookup(s, (k < n) ? xs[k] : NAN, &g);
+        printf("LOOK %s %d %.9g %.9g %.9g %.9g %.9g\n", name, k, (double)g.Kp, (double)g.Ki, (double)g.Kd,
+               (double)g.Ki_continuous, (double)g.Kd_continuous);
+    }
+    /* 越界取端点; 二分查找路径上每个断点 t 恰为0 */
+    for (int i = 0; i < s->count; ++i) {
+        if (s->uniform && i != 0 && i != s->count - 1) continue;
+        const PID_ScheduleGainsTypeDef *b = &s->gains[i];
+        PID_Init(&ref, 0.0f, 0.0f, 0.0f, ts);
+        PID_SetTunings(&ref, b->Kp, b->Ki_continuous, b->Kd_continuous);
+        PID_Init(&pid, 0.0f, 0.0f, 0.0f, ts);
+        PID_ScheduleApply(s, &pid, s->x[i]);
+        if (!same_gains(&pid, &ref)) { printf("breakpoint %s %d\n", name, i); return 1; }
+        PID_ScheduleApply(s, &pid, (i == 0) ? s->x[0] - 100.0f : s->x[i] + 100.0f);
+        if ((i == 0 || i == s->count - 1) && !same_gains(&pid, &ref)) { printf("clamp %s %d\n", name, i); return 1; }
+    }
+    return 0;
+}
+
+int main(void) {
+/*CASES*/
+    return 0;
+}
+"""
+
+
+# 遥测: 按控制周期打印各控制器字段(真值)和收到的批量帧, 失败时返回对应的非零编号
+TELEMETRY_CHECK_SOURCE = FRAME_PRELUDE + r"""
+#include "pid_telemetry.h"
+
+static PID_HandleTypeDef pid[2];
+static float plant[2];
+
+static void step(int stream, uint32_t tick, float setpoint) {
+    for (int ch = 0; ch < 2; ++ch) {
+        const float u = PID_Compute(&pid[ch], setpoint * (1.0f + 0.5f * ch), plant[ch]);
+        plant[ch] += 0.05f * (u - plant[ch]);
+        printf("LOG %d %u %d %.9g %.9g %.9g %.9g %.9g %.9g %.9g\n", stream, tick, ch,
+               (double)pid[ch].filtered_setpoint, (double)pid[ch].filtered_measure, (double)pid[ch].output,
+               (double)pid[ch].last_p_term, (double)pid[ch].last_i_term, (double)pid[ch].last_d_term,
+               (double)pid[ch].last_ff_term);
+    }
+}
+
+int main(void) {
+    yj_protocol_handler_t tx_handler, rx_handler;
+    yj_protocol_init(&tx_handler, capture_byte, print_frame, YJ_CHECKSUM_MODE_ORIGINAL);
+    yj_protocol_init(&rx_handler, capture_byte, print_frame, YJ_CHECKSUM_MODE_ORIGINAL);
+    for (int ch = 0; ch < 2; ++ch) {
+        PID_Init(&pid[ch], 0.8f, 2.0f, 0.01f, 0.001f);
+        PID_SetFeedForwardParams(&pid[ch], 0.3f, 1.0f);
+    }
+
+    static PID_TelemetryTypeDef tm;
+    PID_TelemetryInit(&tm, 1);
+    CHECK(1, !PID_TelemetryStart(&tm));
+    CHECK(2, PID_TelemetryAddChannel(&tm, &pid[0]) && PID_TelemetryAddChannel(&tm, &pid[1]));
+    CHECK(3, PID_TelemetryConfigure(&tm, PID_TELEMETRY_FIELDS_ALL, 3));
+    CHECK(4, PID_TelemetryStart(&tm));
+    CHECK(5, !PID_TelemetryConfigure(&tm, PID_TELEMETRY_FIELDS_BASIC, 1));
+    for (uint32_t k = 0; k < 300; ++k) {
+        step(1, k, (k < 100) ? 1.0f : 3.0f);
+        PID_TelemetrySample(&tm);
+        if (k % 10 == 9) {
+            link_down = (k == 99);
+            const int32_t sent = PID_TelemetrySend(&tm, &tx_handler, YJ_DEFAULT_HOST_ADDRESS);
+            CHECK(6, link_down ? sent < 0 : sent >= 0);
+            link_down = 0;
+        }
+    }
+    CHECK(7, tm.head == 100 && tm.tail == tm.head);
+    CHECK(8, PID_TelemetrySend(&tm, &tx_handler, YJ_DEFAULT_HOST_ADDRESS) == 0);
+    PID_TelemetryStop(&tm);
+
+    /* 主循环停发100个周期, 缓冲满后丢弃 */
+    static PID_TelemetryTypeDef lossy;
+    PID_TelemetryInit(&lossy, 2);
+    CHECK(9, PID_TelemetryAddChannel(&lossy, &pid[0]));
+    CHECK(10, PID_TelemetryConfigure(&lossy, PID_TELEMETRY_FIELDS_BASIC, 1));
+    CHECK(11, PID_TelemetryStart(&lossy));
+    for (uint32_t k = 0; k < 150; ++k) {
+        step(2, k, 2.0f);
+        PID_TelemetrySample(&lossy);
+        if (k >= 100) PID_TelemetrySend(&lossy, &tx_handler, YJ_DEFAULT_HOST_ADDRESS);
+    }
+    CHECK(12, lossy.dropped == 37);
+
+    /* 触发采集: 通道0设定值上升沿, 电平5 */
+    static PID_TelemetryTypeDef scope;
+    PID_TelemetryInit(&scope, 3);
+    CHECK(13, PID_TelemetryAddChannel(&scope, &pid[0]) && PID_TelemetryAddChannel(&scope, &pid[1]));
+    CHECK(14, PID_TelemetryConfigure(&scope, PID_TELEMETRY_FIELDS_BASIC | (1u << PID_TELEMETRY_I_TERM), 1));
+    CHECK(15, !PID_TelemetrySetTrigger(&scope, 2, PID_TELEMETRY_SETPOINT, PID_TELEMETRY_EDGE_RISING, 5.0f, 10, 20));
+    CHECK(16, PID_TelemetrySetTrigger(&scope, 0, PID_TELEMETRY_SETPOINT, PID_TELEMETRY_EDGE_RISING, 5.0f, 10, 20));
+    CHECK(17, PID_TelemetryArm(&scope));
+    for (uint32_t k = 0; k < 400; ++k) {
+        step(3, k, (k < 150) ? 0.0f : 10.0f);
+        PID_TelemetrySample(&scope);
+        const int32_t sent = PID_TelemetrySend(&scope, &tx_handler, YJ_DEFAULT_HOST_ADDRESS);
+        CHECK(18, k >= 150 || sent == 0);
+    }
+    CHECK(19, PID_TelemetryGetState(&scope) == PID_TELEMETRY_STOPPED);
+
+    yj_protocol_process_buffer(&rx_handler, tx, tx_len);
+    return 0;
+}
+"""
+
+
+# 串级计算与"三个独立控制器+按分频手工调用"的胶水代码对比, 失败时返回对应的非零编号
+CASCADE_CHECK_SOURCE = CHECK_PRELUDE + r"""
+#include <math.h>
+#include "pid_cascade.h"
+
+typedef struct { float i, v, x; } Plant;
+
+/* 电流一阶响应, 速度为电流的积分, 位置为速度的积分 */
+static void plant_step(Plant *p, float u) {
+    p->i += 0.5f * (u - p->i);
+    p->v += 0.0005f * 10.0f * p->i;
+    p->x += 0.0005f * p->v;
+}
+
+static PID_HandleTypeDef pos, vel, cur;
+
+static int run(float current_limit, float *cascade_vel_integral, float *glue_vel_integral) {
+    PID_CascadeTypeDef cascade;
+    CHECK(10, PID_CascadeInit_pos(&cascade));
+    CHECK(11, cascade.divider[0] == 20 && cascade.divider[1] == 4 && cascade.divider[2] == 1);
+/*GLUE_INIT*/
+    PID_SetOutputLimits(&cascade.stage[2], current_limit);
+    PID_SetOutputLimits(&cur, current_limit);
+
+    Plant pc = {0}, pg = {0};
+    float sp_vel = 0.0f, sp_cur = 0.0f;
+    for (int tick = 0; tick < 8000; ++tick) {
+        const float target = (tick < 4000) ? 1.0f : -0.5f;
+        const float measures[3] = { pc.x, pc.v, pc.i };
+        const float out_c = PID_CascadeCompute(&cascade, target, measures);
+
+        if (tick % 20 == 0) sp_vel = PID_Compute(&pos, target, pg.x);
+        if (tick % 4 == 0) sp_cur = PID_Compute(&vel, sp_vel, pg.v);
+        const float out_g = PID_Compute(&cur, sp_cur, pg.i);
+
+        if (current_limit > 50.0f) CHECK(12, out_c == out_g);
+        plant_step(&pc, out_c);
+        plant_step(&pg, out_g);
+    }
+    *cascade_vel_integral = cascade.stage[1].integral;
+    *glue_vel_integral = vel.integral;
+    return 0;
+}
+
+int main(void) {
+    float ic, ig;
+    int rc = run(100.0f, &ic, &ig);     /* 不饱和: 与胶水代码逐位一致 */
+    if (rc) return rc;
+    rc = run(0.3f, &ic, &ig);           /* 电流环饱和: 速度环积分被保持 */
+    if (rc) return rc;
+    printf("vel integral: cascade=%f glue=%f\n", (double)ic, (double)ig);
+    CHECK(13, fabsf(ig) >= 19.0f && fabsf(ic) < 0.25f * fabsf(ig));
+    return 0;
+}
+"""
+
+
+# 继电器自整定: FOPDT对象上完成实验、无扰接管并收敛, 偏差超限与取消各跑一次, 进度帧经 FRAME_PRELUDE 输出
+AUTOTUNE_CHECK_SOURCE = FRAME_PRELUDE + r"""
+#include <math.h>
+#include "pid_autotune.h"
+
+#define TS 0.01f
+#define DELAY 30
+
+/* 对象 2·e^(-0.3s)/(0.5s+1), 零阶保持精确离散, 从 u=0.5, y=1 的稳态开始 */
+typedef struct { float y; float u[DELAY]; int head; } Plant;
+
+static void plant_init(Plant *p) {
+    p->y = 1.0f;
+    p->head = 0;
+    for (int i = 0; i < DELAY; ++i) p->u[i] = 0.5f;
+}
+
+static float plant_step(Plant *p, float u) {
+    const float a = expf(-TS / 0.5f);
+    const float delayed = p->u[p->head];
+    p->u[p->head] = u;
+    p->head = (p->head + 1) % DELAY;
+    p->y = a * p->y + (1.0f - a) * 2.0f * delayed;
+    return p->y;
+}
+
+static int run(PID_AutotuneTypeDef *at, yj_protocol_handler_t *handler, Plant *p, int steps) {
+    float y = p->y;
+    for (int k = 0; k < steps; ++k) {
+        y = plant_step(p, PID_AutotuneCompute(at, y));
+        PID_AutotuneSendProgress(at, handler, YJ_DEFAULT_HOST_ADDRESS);
+    }
+    return 0;
+}
+
+int main(void) {
+    yj_protocol_handler_t tx_handler, rx_handler;
+    yj_protocol_init(&tx_handler, capture_byte, print_frame, YJ_CHECKSUM_MODE_ORIGINAL);
+    yj_protocol_init(&rx_handler, capture_byte, print_frame, YJ_CHECKSUM_MODE_ORIGINAL);
+
+    PID_HandleTypeDef pid;
+    PID_Init(&pid, 0.5f, 0.5f, 0.0f, TS);
+    PID_SetOutputLimits(&pid, 20.0f);
+    PID_AutotuneTypeDef at;
+    Plant plant;
+
+    PID_AutotuneInit(&at, &pid, 5.0f, 0.02f);
+    at.id = 3;
+    CHECK(1, PID_AutotuneStart(&at, 1.0f, 0.5f));
+    plant_init(&plant);
+    for (int k = 0; k < 3000 && PID_AutotuneIsRunning(&at); ++k) run(&at, &tx_handler, &plant, 1);
+    CHECK(2, at.state == PID_AUTOTUNE_DONE);
+    CHECK(3, pid.Kp == at.Kp && pid.Ki_continuous == at.Ki && pid.Kd_continuous == at.Kd);
+    CHECK(4, pid.Ki == at.Ki * TS && pid.mode == PID_MODE_AUTOMATIC);
+    CHECK(5, at.steps < at.max_steps);
+    printf("RESULT %.6f %.6f %.6f %.6f %.6f\n", (double)at.Ku, (double)at.Pu, (double)at.Kp, (double)at.Ki, (double)at.Kd);
+
+    /* 接管后继续调用同一函数即为闭环PID, 收敛到实验设定值 */
+    run(&at, &tx_handler, &plant, 1000);
+    CHECK(6, fabsf(plant.y - 1.0f) < 0.01f);
+
+    PID_AutotuneInit(&at, &pid, 5.0f, 0.02f);
+    at.id = 4;
+    at.error_limit = 0.05f;
+    CHECK(7, PID_AutotuneStart(&at, 1.0f, 0.5f));
+    run(&at, &tx_handler, &plant, 200);
+    CHECK(8, at.state == PID_AUTOTUNE_LIMIT);
+
+    PID_AutotuneInit(&at, &pid, 5.0f, 0.02f);
+    at.id = 5;
+    CHECK(9, PID_AutotuneStart(&at, 1.0f, 0.5f));
+    run(&at, &tx_handler, &plant, 30);
+    PID_AutotuneCancel(&at);
+    CHECK(10, PID_AutotuneIsRunning(&at));
+    run(&at, &tx_handler, &plant, 1);
+    CHECK(11, at.state == PID_AUTOTUNE_CANCELLED);
+
+    PID_AutotuneInit(&at, NULL, 5.0f, 0.02f);
+    CHECK(12, !PID_AutotuneStart(&at, 1.0f, 0.5f));
+
+    yj_protocol_process_buffer(&rx_handler, tx, tx_len);
+    return 0;
+}
+"""
+
+
+# 变周期计算 PID_ComputeWithTime 的检查, 失败时返回对应的非零编号
+TIME_CHECK_SOURCE = CHECK_PRELUDE + r"""
+#include <math.h>
+#include "pid.h"
+
+int main(void) {
+    PID_HandleTypeDef a, b;
+
+    /* Init先确定采样时间再换算离散增益 */
+    PID_Init(&a, 2.0f, 5.0f, 0.1f, 0.01f);
+    CHECK(1, a.Ki == 5.0f * 0.01f && a.Kd == 0.1f * (1.0f / 0.01f));
+
+    /* 实测周期恒等于采样时间时, 与固定周期计算逐位一致(含微分滤波和斜率限制) */
+    PID_Init(&b, 2.0f, 5.0f, 0.1f, 0.01f);
+    PID_SetDFilter(&a, 0.4f); PID_SetDFilter(&b, 0.4f);
+    PID_SetOutputRamp(&a, 300.0f); PID_SetOutputRamp(&b, 300.0f);
+    float pv_a = 0.0f, pv_b = 0.0f;
+    for (uint32_t k = 1; k <= 500; ++k) {
+        float sp = (k < 250) ? 20.0f : -10.0f;
+        float out_a = PID_Compute(&a, sp, pv_a);
+        float out_b = (k == 1) ? (PID_ComputeWithTime(&b, sp, pv_b, 1000), PID_Compute(&b, sp, pv_b))
+                               : PID_ComputeWithTime(&b, sp, pv_b, 1000 + 10 * (k - 1));
+        CHECK(2, out_a == out_b);
+        pv_a += 0.1f * (out_a - pv_a);
+        pv_b += 0.1f * (out_b - pv_b);
+    }
+
+    /* 抖动的周期不改写离散增益, 积分按实测周期累积 */
+    PID_Init(&a, 0.0f, 3.0f, 0.0f, 0.01f);
+    const float ki = a.Ki, kd = a.Kd;
+    uint32_t t = 5000;
+    double elapsed = 0.0;
+    PID_ComputeWithTime(&a, 1.0f, 0.0f, t);
+    for (int k = 0; k < 1000; ++k) {
+        uint32_t dt_ms = 8u + (uint32_t)(k * 7 % 5);    /* 8~12ms */
+        t += dt_ms;
+        elapsed += dt_ms / 1000.0;
+        PID_ComputeWithTime(&a, 1.0f, 0.0f, t);
+    }
+    CHECK(3, a.Ki == ki && a.Kd == kd);
+    CHECK(4, fabs(a.integral - 3.0 * elapsed) < 1e-4 * elapsed);
+
+    /* 长时间未调用: 周期按上限4*Ts计算, 积分不会跳变 */
+    PID_Init(&a, 0.0f, 1.0f, 0.0f, 0.01f);
+    PID_ComputeWithTime(&a, 1.0f, 0.0f, 100);
+    PID_ComputeWithTime(&a, 1.0f, 0.0f, 2100);
+    CHECK(5, fabsf(a.integral - 0.04f) < 1e-6f);
+    PID_SetTimeLimits(&a, 0.005f, 2.5f);
+    PID_ComputeWithTime(&a, 1.0f, 0.0f, 4100);
+    CHECK(6, fabsf(a.integral - 2.04f) < 1e-5f);
+
+    /* 梯形积分: 误差线性增长时积分精确等于 Ki*t^2/2 (矩形积分多出半步) */
+    PID_Init(&a, 0.0f, 1.0f, 0.0f, 0.01f);
+    PID_Init(&b, 0.0f, 1.0f, 0.0f, 0.01f);
+    PID_SetIntegrationMethod(&b, PID_INTEGRATION_TRAPEZOIDAL);
+    for (uint32_t k = 0; k <= 100; ++k) {
+        uint32_t ms = 1 + 10 * k;
+        float e = 0.01f * (float)k;
+        PID_ComputeWithTime(&a, e, 0.0f, ms);
+        PID_ComputeWithTime(&b, e, 0.0f, ms);
+    }
+    CHECK(7, fabsf(b.integral - 0.5f) < 1e-5f);
+    CHECK(8, fabsf(a.integral - 0.505f) < 1e-5f);
+
+    /* SetSampleTime后周期范围随之缩放: 1ms周期不会按旧下限 0.25*10ms 计算 */
+    PID_Init(&a, 0.0f, 1.0f, 0.0f, 0.01f);
+    PID_SetSampleTime(&a, 0.001f);
+    for (uint32_t ms = 1; ms <= 1001; ++ms) {
+        PID_ComputeWithTime(&a, 1.0f, 0.0f, ms);
+    }
+    CHECK(9, fabsf(a.integral - 1.0f) < 1e-4f);
+
+    /* SetTimeLimits显式指定的范围不受SetSampleTime影响 */
+    PID_Init(&a, 0.0f, 1.0f, 0.0f, 0.01f);
+    PID_SetTimeLimits(&a, 0.005f, 0.02f);
+    PID_SetSampleTime(&a, 0.001f);
+    CHECK(10, a.dt_min == 0.005f && a.dt_max == 0.02f);
+    return 0;
+}
+"""
+
+
+# 同一实例的两份句柄分别用 PID_Compute 和 PID_Compute_<实例名> 闭环运行(含手动/自动切换、积分保持、
+# 误差超过默认积分分离阈值1000的阶段, 最后改为梯形积分), 逐步比较输出
+SPEC_CHECK_SOURCE = r"""
+#include <stdio.h>
+#include "pid_spec.h"
+
+/*HANDLES*/
+
+#define RUN(name) do { \
+    float pv_g = 0.0f, pv_s = 0.0f; \
+    for (int step = 0; step < 600; ++step) { \
+        if (step == 150) { PID_SetMode(&name##_g, PID_MODE_MANUAL); PID_SetMode(&name##_s, PID_MODE_MANUAL); } \
+        if (step == 250) { PID_SetMode(&name##_g, PID_MODE_AUTOMATIC); PID_SetMode(&name##_s, PID_MODE_AUTOMATIC); } \
+        if (step == 50) { PID_SetIntegralHold(&name##_g, 1); PID_SetIntegralHold(&name##_s, 1); } \
+        if (step == 120) { PID_SetIntegralHold(&name##_g, 0); PID_SetIntegralHold(&name##_s, 0); } \
+        if (step == 400) { \
+            PID_SetIntegrationMethod(&name##_g, PID_INTEGRATION_TRAPEZOIDAL); \
+            PID_SetIntegrationMethod(&name##_s, PID_INTEGRATION_TRAPEZOIDAL); \
+        } \
+        float sp = (step < 300) ? 40.0f : (step < 350) ? 2000.0f : -15.0f + 0.1f * (float)(step % 7); \
+        float out_g = PID_Compute(&name##_g, sp, pv_g); \
+        float out_s = PID_Compute_##name(&name##_s, sp, pv_s); \
+        if (out_g != out_s) { printf(#name " step %d: %.9g != %.9g\n", step, (double)out_g, (double)out_s); return 1; } \
+        pv_g += 0.05f * (out_g - pv_g); \
+        pv_s += 0.05f * (out_s - pv_s); \
+    } \
+} while (0)
+
+int main(void) {
+/*INIT*/
+/*RUN*/
+    return 0;
+}
+"""
+
+
+# 同一实例用 PID_Compute、生成的只读配置、由句柄换算的配置三路闭环运行(含手动/自动切换), 逐步比较输出和分量
+SPLIT_CHECK_SOURCE = r"""
+#include <stdio.h>
+#include "pid_split.h"
+
+/*HANDLES*/
+
+#define RUN(name) do { \
+    PID_SplitConfigTypeDef ram_config; \
+    PID_SplitStateTypeDef flash_state, ram_state; \
+    PID_SplitConfigFrom(&ram_config, &name); \
+    PID_SplitInit(&flash_state, &name##_split_config); \
+    PID_SplitInit(&ram_state, &ram_config); \
+    float pv_g = 0.0f, pv_f = 0.0f, pv_r = 0.0f; \
+    for (int step = 0; step < 600; ++step) { \
+        if (step == 150) { PID_SetMode(&name, PID_MODE_MANUAL); PID_SplitSetMode(&flash_state, PID_MODE_MANUAL); \
+                           PID_SplitSetMode(&ram_state, PID_MODE_MANUAL); } \
+        if (step == 200) { PID_SetOutput(&name, 7.5f); PID_SplitSetOutput(&flash_state, 7.5f); \
+                           PID_SplitSetOutput(&ram_state, 7.5f); } \
+        if (step == 250) { PID_SetMode(&name, PID_MODE_AUTOMATIC); PID_SplitSetMode(&flash_state, PID_MODE_AUTOMATIC); \
+                           PID_SplitSetMode(&ram_state, PID_MODE_AUTOMATIC); } \
+        float sp = (step < 300) ? 40.0f : -15.0f + 0.1f * (float)(step % 7); \
+        float out_g = PID_Compute(&name, sp, pv_g); \
+        float out_f = PID_SplitCompute(&flash_state, sp, pv_f); \
+        float out_r = PID_SplitCompute(&ram_state, sp, pv_r); \
+        if (out_g != out_f || out_g != out_r) { \
+            printf(#name " step %d: %.9g / %.9g / %.9g\n", step, (double)out_g, (double)out_f, (double)out_r); \
+            return 1; \
+        } \
+        float g[4], f[4]; \
+        PID_GetComponents(&name, &g[0], &g[1], &g[2], &g[3]); \
+        PID_SplitGetComponents(&flash_state, &f[0], &f[1], &f[2], &f[3]); \
+        for (int k = 0; k < 4; ++k) { \
+            if (g[k] != f[k]) { printf(#name " step %d term %d: %.9g != %.9g\n", step, k, (double)g[k], (double)f[k]); return 1; } \
+        } \
+        pv_g += 0.05f * (out_g - pv_g); \
+        pv_f += 0.05f * (out_f - pv_f); \
+        pv_r += 0.05f * (out_r - pv_r); \
+    } \
+} while (0)
+
+int main(void) {
+/*INIT*/
+/*RUN*/
+    return 0;
+}
+"""
+
+
+# 用64位LCG产生随机的设定值/测量值, 逐步打印定点控制器输出, 与Python模型逐位比较
+FIXED_CHECK_SOURCE = r"""
+#include <stdio.h>
+#include "pid_{fmt}.h"
+
+static uint64_t lcg = 12345u;
+
+static int64_t next_q(int shift) {{
+    lcg = lcg * 6364136223846793005ull + 1442695040888963407ull;
+    return ((int64_t)(lcg >> {rshift}) - ((int64_t)1 << {bits})) >> shift;
+}}
+
+int main(void) {{
+    const PID_{FMT}_ConfigTypeDef *configs[] = {{ {configs} }};
+    for (unsigned c = 0; c < sizeof(configs) / sizeof(configs[0]); ++c) {{
+        PID_{FMT}_HandleTypeDef pid;
+        PID_{FMT}_Init(&pid, configs[c]);
+        for (int step = 0; step < {steps}; ++step) {{
+            int shift = (step / 100) % 4 * 2;
+            {qtype} sp = ({qtype})next_q(shift);
+            {qtype} pv = ({qtype})next_q(shift + 1);
+            printf("%lld\n", (long long)PID_{FMT}_Compute(&pid, sp, pv));
+        }}
+    }}
+    return 0;
+}}
+"""
+
+
+def sweep_reference(result, spec, sample_time: float, steps: int):
+    """
+    双精度参考仿真: 默认配置(标准型、位置式、输出限幅100、积分限幅50、无滤波)的PID闭环, 与增益扫描程序的统计口径一致
+
+    二阶对象按欠阻尼闭式解离散化, 与扫描程序的矩阵指数互为独立实现。
+    """
+    ts = sample_time
+    if spec.plant == "fopdt":
+        a = math.exp(-ts / spec.tau)
+        phi, gamma = ((a, 0.0), (0.0, 0.0)), (spec.gain * (1.0 - a), 0.0)
+    else:
+        wn, z = spec.wn, spec.zeta
+        wd = wn * math.sqrt(1.0 - z * z)
+        ex, c, sn, k = math.exp(-z * wn * ts), math.cos(wd * ts), math.sin(wd * ts), z / math.sqrt(1.0 - z * z)
+        phi = ((ex * (c + k * sn), ex * sn / wd), (-ex * wn * wn / wd * sn, ex * (c - k * sn)))
+        # gamma = A^-1 (phi - I) B, B = (0, K·wn²)
+        b = spec.gain * wn * wn
+        m01, m11 = phi[0][1], phi[1][1] - 1.0
+        gamma = ((-2.0 * z / wn) * m01 * b - (1.0 / (wn * wn)) * m11 * b, m01 * b)
+    delay = deque([0.0] * int(math.floor(spec.dead_time / ts + 0.5)))
+    u_limit = spec.u_limit if spec.u_limit > 0 else math.inf
+    kp, ki, kd = result["kp"], result["ki"], result["kd"]
+    y = v = integral = prev_e = 0.0
+    iae = itae = peak = 0.0
+    for step in range(steps):
+        e = spec.setpoint - y
+        iae += abs(e) * ts
+        itae += abs(e) * step * ts * ts
+        peak = max(peak, y)
+        integral = min(max(integral + ki * ts * e, -50.0), 50.0)
+        out = min(max(kp * e + integral + kd * (e - prev_e) / ts, -100.0), 100.0)
+        prev_e = e
+        delay.append(min(max(out, -u_limit), u_limit))
+        ud = delay.popleft()
+        y, v = phi[0][0] * y + phi[0][1] * v + gamma[0] * ud, phi[1][0] * y + phi[1][1] * v + gamma[1] * ud
+    overshoot = 100.0 * (peak - spec.setpoint) / spec.setpoint if peak > spec.setpoint else 0.0
+    return iae, itae, overshoot
+
+
+@unittest.skipUnless(pid_sweep.find_compiler(), "未找到C编译器")
+class TestPIDSweep(unittest.TestCase):
+    """闭环增益扫描程序的测试"""
+
+    @classmethod
+    def setUpClass(cls):
+        cls.tmp_dir = Path(tempfile.mkdtemp())
+        cls.model = PIDDataModel()
+        cls.model.add_instance("axis")
+        cls.model.add_instance("axis_vel")
+        cls.model.pid_instances[-1]["params"].update({"work_mode": "velocity", "output_ramp": 500.0})
+        cls.exe = pid_sweep.build_sweep_tool(cls.model, cls.tmp_dir / "axis", "axis")
+        cls.sample_time = struct.unpack("f", struct.pack("f", 0.01))[0]
+
+    @classmethod
+    def tearDownClass(cls):
+        shutil.rmtree(cls.tmp_dir, ignore_errors=True)
+
+    def _check_against_reference(self, spec):
+        output = pid_sweep.run_sweep(self.exe, spec)
+        self.assertEqual(output["candidates"], spec.candidates)
+        self.assertEqual(len(output["results"]), spec.candidates)
+        for result in output["results"]:
+            iae, itae, overshoot = sweep_reference(result, spec, self.sample_time, output["steps"])
+            self.assertAlmostEqual(result["iae"], iae, delta=1e-3 * iae + 1e-6, msg=result)
+            self.assertAlmostEqual(result["itae"], itae, delta=1e-3 * itae + 1e-6, msg=result)
+            self.assertAlmostEqual(result["overshoot"], overshoot, delta=0.05, msg=result)
+        return output
+
+    def test_matches_reference(self):
+        """测试FOPDT(含滞后和饱和)与二阶对象的IAE/ITAE/超调量与双精度参考仿真一致"""
+        self._check_against_reference(pid_sweep.SweepSpec(
+            kp=(0.5, 4.0, 4), ki=(0.0, 6.0, 3), kd=(0.0, 0.05, 2), plant="fopdt", gain=2.0, tau=0.4,
+            dead_time=0.03, u_limit=3.0, duration=3.0, top=1000))
+        self._check_against_reference(pid_sweep.SweepSpec(
+            kp=(0.2, 2.0, 3), ki=(0.5, 4.0, 3), kd=(0.0, 0.1, 3), plant="second-order", gain=1.5, wn=12.0,
+            zeta=0.3, dead_time=0.01, duration=3.0, top=1000))
+
+    def test_ranking_and_threads(self):
+        """测试排序(满足超调上限的在前, 其次按指标升序)且结果与线程数无关"""
+        spec = pid_sweep.SweepSpec(kp=(0.0, 10.0, 30), ki=(0.0, 20.0, 30), kd=(0.0, 0.2, 4),
+                                   dead_time=0.05, u_limit=50.0, max_overshoot=5.0, top=5000, threads=1)
+        single = pid_sweep.run_sweep(self.exe, spec)
+        spec.threads = 3
+        multi = pid_sweep.run_sweep(self.exe, spec)
+        self.assertEqual(single["results"], multi["results"])
+        results = single["results"]
+        feasible = [r["feasible"] for r in results]
+        self.assertEqual(feasible, sorted(feasible, reverse=True))
+        self.assertTrue(feasible[0])
+        ranked = [r["itae"] for r in results if r["feasible"]]
+        self.assertEqual(ranked, sorted(ranked))
+        self.assertTrue(all(r["overshoot"] <= 5.0 for r in results if r["feasible"]))
+        best = results[0]
+        self.assertLess(best["final_error"], 0.01)
+        # 最优一组明显好于只用比例作用的候选
+        p_only = [r for r in results if r["ki"] == 0.0 and r["kd"] == 0.0 and r["kp"] > 0]
+        self.assertLess(best["itae"], min(r["itae"] for r in p_only))
+
+        self.assertTrue(pid_sweep.apply_result(self.model, "axis", best))
+        params = self.model.pid_instances[0]["params"]
+        self.assertEqual((params["kp"], params["ki"], params["kd"]), (best["kp"], best["ki"], best["kd"]))
+        self.assertFalse(pid_sweep.apply_result(self.model, "missing", best))
+
+    @unittest.skipUnless(sys.platform.startswith("linux"), "依赖LD_PRELOAD")
+    def test_partial_allocation_failure(self):
+        """测试部分线程的通道状态分配失败时由其余线程完成全部候选, 一个都分配不到才报内存不足"""
+        shim = self.tmp_dir / "memalign_shim.c"
+        shim.write_text(
+            "#include <errno.h>\n#include <stdlib.h>\n"
+            "int posix_memalign(void** p, size_t a, size_t n) {\n"
+            "    static int calls;\n"
+            "    int limit = atoi(getenv(\"SHIM_ALLOC_LIMIT\"));\n"
+            "    if (__atomic_fetch_add(&calls, 1, __ATOMIC_RELAXED) >= limit) return ENOMEM;\n"
+            "    *p = aligned_alloc(a, (n + a - 1) / a * a);\n"
+            "    return *p ? 0 : ENOMEM;\n}\n")
+        lib = self.tmp_dir / "memalign_shim.so"
+        subprocess.run([pid_sweep.find_compiler(), "-shared", "-fPIC", str(shim), "-o", str(lib)], check=True)
+        spec = pid_sweep.SweepSpec(kp=(0.5, 4.0, 8), ki=(0.0, 6.0, 8), kd=(0.0, 0.05, 2), top=1000, threads=4)
+        expected = pid_sweep.run_sweep(self.exe, spec)["results"]
+
+        env = dict(os.environ, LD_PRELOAD=str(lib), SHIM_ALLOC_LIMIT="1")
+        result = subprocess.run([str(self.exe), *spec.to_args()], capture_output=True, text=True, env=env)
+        self.assertEqual(result.returncode, 0, result.stderr)
+        self.assertEqual(json.loads(result.stdout)["results"], expected)
+
+        env["SHIM_ALLOC_LIMIT"] = "0"
+        result = subprocess.run([str(self.exe), *spec.to_args()], capture_output=True, text=True, env=env)
+        self.assertEqual(result.returncode, 1)
+        self.assertIn("内存不足", result.stderr)
+
+    def test_velocity_instance(self):
+        """测试速度式实例: 输出增量累加后作用于对象, 最优候选能跟踪设定值"""
+        exe = pid_sweep.build_sweep_tool(self.model, self.tmp_dir / "axis_vel", "axis_vel")
+        output = pid_sweep.run_sweep(exe, pid_sweep.SweepSpec(kp=(0.5, 5.0, 10), ki=(1.0, 10.0, 10),
+                                                              kd=(0.0, 0.05, 3), setpoint=-2.0))
+        self.assertEqual(output["instance"], "axis_vel")
+        self.assertLess(output["results"][0]["final_error"], 0.01)
+        with self.assertRaises(ValueError):
+            pid_sweep.run_sweep(exe, pid_sweep.SweepSpec(kp=(1.0, 0.5, 3)))
+
+
+class TestPIDFixedPoint(unittest.TestCase):
+    """定点(Q15/Q31)后端的测试"""
+
+    STEPS = 800
+
+    def setUp(self):
+        self.tmp_dir = Path(tempfile.mkdtemp())
+        self.model = PIDDataModel()
+        variants = {
+            "loop_a": {"d_filter_coef": 0.3, "deadband": 0.5, "kp": 2.5, "ki": 40.0, "kd": 0.01},
+            "loop_b": {"pid_type": "pi_d", "work_mode": "velocity", "integral_separation_threshold": 30.0,
+                       "kp": 0.7, "ki": 3.0, "kd": 0.002, "sample_time": 0.0005},
+            "loop_c": {"pid_type": "i_pd", "kp": 12.0, "ki": 0.05, "kd": 0.2, "integral_limit": 150.0},
+        }
+        for name, params in variants.items():
+            self.model.add_instance(name)
+            self.model.pid_instances[-1]["params"].update(params)
+
+    def tearDown(self):
+        shutil.rmtree(self.tmp_dir, ignore_errors=True)
+
+    def _reference_outputs(self, fmt_name: str):
+        """按C程序相同的输入序列运行Python定点模型"""
+        fmt = pid_fixed.FixedFormat(fmt_name)
+        mask = (1 << 64) - 1
+        lcg = 12345
+        outputs = []
+        for instance in self.model.pid_instances:
+            pid = pid_fixed.FixedPID(fmt, pid_fixed.make_config(fmt, instance["params"], 200.0))
+            for step in range(self.STEPS):
+                shift = (step // 100) % 4 * 2
+                values = []
+                for extra in (0, 1):
+                    lcg = (lcg * 6364136223846793005 + 1442695040888963407) & mask
+                    values.append(((lcg >> (63 - fmt.bits)) - (1 << fmt.bits)) >> (shift + extra))
+                outputs.append(pid.compute(*values))
+        return outputs
+
+    @unittest.skipUnless(shutil.which("cc"), "未找到C编译器")
+    def test_generated_code_matches_model(self):
+        """测试生成的Q15/Q31代码与Python定点模型逐位一致(含饱和、滤波、死区、积分分离、速度式)"""
+        for fmt_name in ("q15", "q31"):
+            with self.subTest(fmt=fmt_name):
+                fmt = pid_fixed.FixedFormat(fmt_name)
+                self.model.update_code_config({PIDDataModel.C_FIXED_FORMAT: fmt_name})
+                generator = PIDCodeGenerator(self.model)
+                out_dir = self.tmp_dir / fmt_name
+                out_dir.mkdir()
+                (out_dir / "pid.h").write_text(generator.generate_header_code(), encoding='utf-8')
+                for name, code in generator.generate_extra_files().items():
+                    (out_dir / name).write_text(code, encoding='utf-8')
+                source = FIXED_CHECK_SOURCE.format(
+                    fmt=fmt_name, FMT=fmt_name.upper(), bits=fmt.bits, rshift=63 - fmt.bits,
+                    qtype=fmt.narrow_type, steps=self.STEPS,
+                    configs=", ".join(f"&{inst['name']}_{fmt_name}_config" for inst in self.model.pid_instances))
+                (out_dir / "check.c").write_text(source, encoding='utf-8')
+                exe = out_dir / "check"
+                subprocess.run(["cc", "-O2", "-Wall", "-Wextra", "-Werror", str(out_dir / "check.c"),
+                                str(out_dir / f"pid_{fmt_name}.c"), "-o", str(exe)], check=True)
+                result = subprocess.run([str(exe)], capture_output=True, text=True, check=True)
+                self.assertEqual([int(line) for line in result.stdout.split()], self._reference_outputs(fmt_name))
+
+    def test_error_report(self):
+        """测试误差报告: 增益量化误差很小, 闭环输出误差在几个LSB以内"""
+        params = self.model.pid_instances[0]["params"]
+        for fmt_name in ("q15", "q31"):
+            fmt = pid_fixed.FixedFormat(fmt_name)
+            config = pid_fixed.make_config(fmt, params, 200.0)
+            for gain, exact in zip((config.kp, config.ki, config.kd), pid_fixed.discrete_gains(params)):
+                self.assertLess(abs(gain.value - exact), abs(exact) * 2.0 ** (1 - fmt.bits))
+            sim = pid_fixed.simulate_step_response(params, fmt, config, 200.0, 1000)
+            self.assertLess(sim["max_error"], 0.01 * params["max_output"])
+
+        self.model.update_code_config({PIDDataModel.C_FIXED_FORMAT: "q15"})
+        header = PIDCodeGenerator(self.model).generate_extra_files()["pid_q15.h"]
+        self.assertIn("Q15 定点误差报告", header)
+        self.assertIn("实例 loop_b", header)
+        self.assertIn("extern const PID_Q15_ConfigTypeDef loop_c_q15_config;", header)
+
+
+if __name__ == '__main__':
+    unittest.main()
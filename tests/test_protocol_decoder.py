@@ -9,6 +9,7 @@ import struct
 # 添加项目根目录到Python路径
 sys.path.insert(0, os.path.abspath(os.path.join(os.path.dirname(__file__), '..')))
 
+from core import native_protocol
 from core.protocol_decoder import ProtocolDecoder, ParsedFrame, FrameValidationResult
 from core.protocol_errors import ProtocolError, ProtocolException, ChecksumMismatchError, FrameParseError
 from core.placeholders import QByteArray
@@ -273,6 +274,36 @@ class TestProtocolDecoder(unittest.TestCase):
             stats = self.decoder.get_decode_statistics()
             self.assertGreater(stats['total_frames'], 0)
 
+    def test_decode_span(self):
+        """测试原生扫描结果经decode_span解码时发射信号并更新统计"""
+        decoded = []
+        checksum_errors = []
+        decode_errors = []
+        self.decoder.frame_decoded.connect(decoded.append)
+        self.decoder.checksum_error.connect(lambda msg, data: checksum_errors.append(msg))
+        self.decoder.decode_error.connect(lambda msg, data: decode_errors.append(msg))
+
+        # 帧头AB, 源地址01, 目的地址02, 功能ID C0, 小端长度2, 数据, 2字节校验
+        chunk = b"\x00\xAB\x01\x02\xC0\x02\x00\x11\x22\x00\x00"
+        good = native_protocol.FrameSpan(1, 10, 0xC0, 0x01, 0x02, True)
+        bad = good._replace(checksum_ok=False)
+
+        frame = self.decoder.decode_span(chunk, good)
+        self.assertEqual(frame.func_id_hex, "C0")
+        self.assertEqual(bytes(frame.data_payload.data()), b"\x11\x22")
+        self.assertEqual((frame.source_addr, frame.dest_addr), (0x01, 0x02))
+        self.assertIsNone(self.decoder.decode_span(chunk, good, "C1"))
+        self.assertIsNone(self.decoder.decode_span(chunk, bad))
+
+        self.assertEqual(decoded, [frame])
+        self.assertEqual(len(checksum_errors), 1)
+        self.assertEqual(len(decode_errors), 1)
+        stats = self.decoder.get_decode_statistics()
+        self.assertEqual(stats['total_frames'], 3)
+        self.assertEqual(stats['successful_frames'], 1)
+        self.assertEqual(stats['failed_frames'], 2)
+        self.assertEqual(stats['checksum_errors'], 1)
+
 
 if __name__ == '__main__':
     unittest.main()
\ No newline at end of file
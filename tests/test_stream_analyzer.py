@@ -0,0 +1,144 @@
+"""原始字节流离线分析工具(yj_analyze)测试模块"""
+
+import unittest
+import sys
+import os
+import json
+import random
+import shutil
+import subprocess
+import tempfile
+
+# 添加项目根目录到Python路径
+sys.path.insert(0, os.path.abspath(os.path.join(os.path.dirname(__file__), '..')))
+
+ANALYZE_BIN = os.environ.get("YJ_ANALYZE_BIN") or shutil.which("yj_analyze")
+BAUD = 115200
+
+
+def build_frame(func_id: int, data: bytes, s_addr: int = 0x01, d_addr: int = 0x02, corrupt: bool = False) -> bytes:
+    """按原始求和/累加校验模式组帧, corrupt为True时破坏校验字节"""
+    frame = bytes([0xAB, s_addr, d_addr, func_id, len(data) & 0xFF, len(data) >> 8]) + data
+    sc = ac = 0
+    for byte in frame:
+        sc = (sc + byte) & 0xFF
+        ac = (ac + sc) & 0xFF
+    if corrupt:
+        sc ^= 0x5A
+    return frame + bytes([sc, ac])
+
+
+def reference_scan(data: bytes, max_payload: int = 256):
+    """与yj_protocol_scan_buffer相同规则的顺序扫描, 返回[(偏移, 长度, 功能ID, 校验通过)]"""
+    frames = []
+    pos = 0
+    while True:
+        pos = data.find(b"\xAB", pos)
+        if pos < 0 or len(data) - pos < 6:
+            break
+        data_len = data[pos + 4] | (data[pos + 5] << 8)
+        if data_len > max_payload:
+            pos += 1
+            continue
+        frame_len = 8 + data_len
+        if len(data) - pos < frame_len:
+            break
+        sc = ac = 0
+        for byte in data[pos:pos + 6 + data_len]:
+            sc = (sc + byte) & 0xFF
+            ac = (ac + sc) & 0xFF
+        ok = data[pos + 6 + data_len] == sc and data[pos + 7 + data_len] == ac
+        frames.append((pos, frame_len, data[pos + 3], ok))
+        pos += frame_len
+    return frames
+
+
+def line_ns(offset: int) -> int:
+    return offset // BAUD * 10_000_000_000 + (offset % BAUD) * 10_000_000_000 // BAUD
+
+
+def build_noisy_stream(seed: int, frame_count: int) -> bytes:
+    """含噪声、负载中夹带伪帧头、超长伪帧头和校验错误帧的字节流"""
+    rng = random.Random(seed)
+    fake_head = bytes([0xAB, 0x01, 0x02, 0x10, 0x04, 0x00])  # 出现在负载中的看似合法的帧头
+    parts = []
+    for i in range(frame_count):
+        choice = rng.random()
+        if choice < 0.05:
+            parts.append(bytes(rng.randrange(256) for _ in range(rng.randrange(1, 24))))
+        elif choice < 0.08:
+            parts.append(bytes([0xAB, 0x00, 0x00, 0x00, 0xFF, 0x7F]))  # 数据长度超限的伪帧头
+        payload = bytes(rng.randrange(256) for _ in range(rng.randrange(0, 40)))
+        if rng.random() < 0.3:
+            cut = rng.randrange(len(payload) + 1)
+            payload = payload[:cut] + fake_head + payload[cut:]
+        parts.append(build_frame(0x10 + (i % 5), payload, corrupt=rng.random() < 0.02))
+    return b"".join(parts)
+
+
+@unittest.skipUnless(ANALYZE_BIN, "未找到yj_analyze可执行文件")
+class TestStreamAnalyzer(unittest.TestCase):
+    """通过真实的yj_analyze进程分析生成的字节流"""
+
+    def setUp(self):
+        self.tmp_dir = tempfile.mkdtemp()
+
+    def tearDown(self):
+        shutil.rmtree(self.tmp_dir, ignore_errors=True)
+
+    def _analyze(self, data: bytes, *args):
+        path = os.path.join(self.tmp_dir, "dump.bin")
+        with open(path, "wb") as f:
+            f.write(data)
+        output = subprocess.run([ANALYZE_BIN, "--json", "--baud", str(BAUD), *args, path],
+                                check=True, capture_output=True, text=True).stdout
+        report = json.loads(output)
+        report["by_id"] = {entry["func_id"]: entry for entry in report["func_ids"]}
+        return report
+
+    def test_matches_reference_scan(self):
+        """测试单线程结果与按相同规则的顺序扫描一致"""
+        data = build_noisy_stream(1, 3000)
+        report = self._analyze(data, "--threads", "1")
+        expected = reference_scan(data)
+        self.assertEqual(report["frames"], sum(1 for f in expected if f[3]))
+        self.assertEqual(report["errors"], sum(1 for f in expected if not f[3]))
+        self.assertEqual(report["frame_bytes"], sum(f[1] for f in expected))
+        for func_id in range(0x10, 0x15):
+            self.assertEqual(report["by_id"][func_id]["frames"],
+                             sum(1 for f in expected if f[2] == func_id and f[3]))
+
+    def test_parallel_chunks_match_single_thread(self):
+        """测试切成大量小块多线程分析时, 块边界落在负载中的伪帧头上也与单线程结果完全一致"""
+        data = build_noisy_stream(2, 6000)
+        sequential = self._analyze(data, "--threads", "1")
+        parallel = self._analyze(data, "--threads", "4", "--chunk-mb", "0.001", "--gap-ms", "1")
+        parallel_single = self._analyze(data, "--threads", "1", "--gap-ms", "1")
+        self.assertGreater(parallel["chunks"], 100)
+        self.assertGreater(parallel["resynced_chunks"], 0)
+        for key in ("frames", "errors", "frame_bytes"):
+            self.assertEqual(parallel[key], sequential[key])
+        self.assertEqual(parallel["func_ids"], parallel_single["func_ids"])
+
+    def test_gap_report(self):
+        """测试某功能ID中断一段时间后报告缺口, 位置指向恢复后的第一帧"""
+        frame_a = build_frame(0x20, b"\x01\x02")
+        frame_b = build_frame(0x21, b"\x03")
+        before = (frame_a + frame_b) * 50
+        silence = frame_b * 400  # 只有0x21在发送, 0x20中断
+        after = (frame_a + frame_b) * 50
+        data = before + silence + after
+        report = self._analyze(data, "--gap-ms", "50", "--chunk-mb", "0.0005", "--threads", "3")
+
+        gaps_a = report["by_id"][0x20]
+        self.assertEqual(gaps_a["gap_count"], 1)
+        self.assertEqual(gaps_a["gaps"][0]["offset"], len(before) + len(silence))
+        last_before = len(before) - len(frame_a) - len(frame_b)
+        expected_ns = line_ns(len(before) + len(silence)) - line_ns(last_before)
+        self.assertAlmostEqual(gaps_a["gaps"][0]["length_s"], expected_ns / 1e9, places=6)
+        self.assertEqual(report["by_id"][0x21]["gap_count"], 0)
+        self.assertEqual(gaps_a["frames"], 100)
+
+
+if __name__ == '__main__':
+    unittest.main()
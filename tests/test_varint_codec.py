@@ -0,0 +1,159 @@
+"""varint_codec测试模块"""
+
+import unittest
+import random
+import sys
+import os
+
+# 添加项目根目录到Python路径
+sys.path.insert(0, os.path.abspath(os.path.join(os.path.dirname(__file__), '..')))
+
+from core.varint_codec import (
+    zigzag_encode, zigzag_decode, encode_varint, decode_varint,
+    encode_varint_array, decode_varint_array, encode_zigzag_array, decode_zigzag_array,
+    encode_delta_array, decode_delta_array, VarintDecodeError
+)
+from core import native_protocol
+
+_native = native_protocol.native_module()
+
+# 覆盖1-5字节编码长度的边界值
+U32_BOUNDARIES = [0, 1, 127, 128, 16383, 16384, 2 ** 21 - 1, 2 ** 21, 2 ** 28 - 1, 2 ** 28, 0xFFFFFFFF]
+I32_BOUNDARIES = [0, -1, 1, -64, 63, -65, 64, -8192, 8191, 2 ** 31 - 1, -2 ** 31]
+
+
+class TestVarintCodec(unittest.TestCase):
+    """变长整数编解码测试"""
+
+    def test_zigzag_mapping(self):
+        """测试ZigZag映射与C实现一致"""
+        self.assertEqual([zigzag_encode(v) for v in (0, -1, 1, -2, 2)], [0, 1, 2, 3, 4])
+        self.assertEqual(zigzag_encode(-2 ** 31), 0xFFFFFFFF)
+        for v in (0, -1, 1, 63, -64, 2 ** 31 - 1, -2 ** 31):
+            self.assertEqual(zigzag_decode(zigzag_encode(v)), v)
+
+    def test_known_encodings(self):
+        """测试已知编码向量"""
+        self.assertEqual(encode_varint(0), b"\x00")
+        self.assertEqual(encode_varint(127), b"\x7f")
+        self.assertEqual(encode_varint(128), b"\x80\x01")
+        self.assertEqual(encode_varint(300), b"\xac\x02")
+        self.assertEqual(encode_varint(0xFFFFFFFF), b"\xff\xff\xff\xff\x0f")
+
+    def test_single_round_trip(self):
+        """测试单值编解码往返"""
+        for v in (0, 1, 127, 128, 16383, 16384, 0xFFFFFFFF):
+            encoded = encode_varint(v)
+            self.assertEqual(decode_varint(encoded), (v, len(encoded)))
+
+    def test_truncated_and_overlong(self):
+        """测试不完整和超长编码"""
+        with self.assertRaises(VarintDecodeError):
+            decode_varint(b"\x80")
+        with self.assertRaises(VarintDecodeError):
+            decode_varint(b"\xff\xff\xff\xff\x1f")
+        with self.assertRaises(VarintDecodeError):
+            decode_varint_array(b"\x01\x02", count=3)
+
+    def test_array_round_trip(self):
+        """测试计数值数组批量解码"""
+        values = [0, 5, 200, 70000, 3]
+        data = encode_varint_array(values)
+        self.assertEqual(decode_varint_array(data), (values, len(data)))
+        self.assertEqual(decode_varint_array(b"\xaa" + data, count=5, offset=1), (values, len(data)))
+
+    def test_signed_array_round_trip(self):
+        """测试有符号小误差数组"""
+        values = [0, -1, 3, -64, 63, -100000]
+        data = encode_zigzag_array(values)
+        self.assertEqual(len(data), 8)
+        self.assertEqual(decode_zigzag_array(data)[0], values)
+
+    def test_delta_array_round_trip(self):
+        """测试差分序列（含32位回绕）"""
+        values = [1000, 1001, 1003, 1002, -2 ** 31, 2 ** 31 - 1]
+        data = encode_delta_array(values)
+        self.assertEqual(data[:2], encode_delta_array([1000]))
+        self.assertEqual(decode_delta_array(data, count=len(values))[0], values)
+
+
+@unittest.skipUnless(_native is not None, "原生扩展未编译")
+class TestNativeVarintCodec(unittest.TestCase):
+    """protocol/yj_protocol.c 的varint函数与纯Python实现逐字节比对"""
+
+    # kind -> (Python编码函数, Python解码函数)
+    KINDS = {}
+
+    @classmethod
+    def setUpClass(cls):
+        cls.KINDS = {
+            _native.VARINT_U32: (encode_varint_array, decode_varint_array),
+            _native.VARINT_ZIGZAG: (encode_zigzag_array, decode_zigzag_array),
+            _native.VARINT_DELTA: (encode_delta_array, decode_delta_array),
+        }
+
+    def assert_same_decode(self, data: bytes, count: int, kind: int):
+        """两种实现对同一输入要么得到相同结果, 要么都拒绝"""
+        decode = self.KINDS[kind][1]
+        try:
+            expected = decode(data, count=count)
+        except VarintDecodeError:
+            with self.assertRaises(ValueError, msg=data.hex()):
+                _native.unpack_varint_array(data, count, kind)
+        else:
+            self.assertEqual(_native.unpack_varint_array(data, count, kind), expected, data.hex())
+
+    def test_encodings_match(self):
+        """测试三种编码的输出字节与Python实现一致"""
+        rng = random.Random(26)
+        unsigned = U32_BOUNDARIES + [rng.getrandbits(rng.choice((7, 14, 21, 28, 32))) for _ in range(500)]
+        signed = I32_BOUNDARIES + [rng.randint(-2 ** 31, 2 ** 31 - 1) >> rng.randrange(32) for _ in range(500)]
+        self.assertEqual(_native.pack_varint_array(unsigned, _native.VARINT_U32), encode_varint_array(unsigned))
+        self.assertEqual(_native.pack_varint_array(signed, _native.VARINT_ZIGZAG), encode_zigzag_array(signed))
+        self.assertEqual(_native.pack_varint_array(signed, _native.VARINT_DELTA), encode_delta_array(signed))
+        for value in U32_BOUNDARIES:
+            self.assertEqual(_native.pack_varint_array([value]), encode_varint(value))
+
+    def test_round_trip(self):
+        """测试一方编码、另一方解码的往返结果"""
+        values = {
+            _native.VARINT_U32: U32_BOUNDARIES,
+            _native.VARINT_ZIGZAG: I32_BOUNDARIES,
+            _native.VARINT_DELTA: I32_BOUNDARIES + [1000, 1001, 999],
+        }
+        for kind, items in values.items():
+            encode, decode = self.KINDS[kind]
+            native_data = _native.pack_varint_array(items, kind)
+            self.assertEqual(decode(native_data, count=len(items)), (items, len(native_data)))
+            self.assertEqual(_native.unpack_varint_array(encode(items), len(items), kind), (items, len(native_data)))
+
+    def test_truncated_inputs(self):
+        """测试每个多字节编码的所有截断前缀都被两种实现拒绝"""
+        for value in U32_BOUNDARIES:
+            encoded = encode_varint(value)
+            for cut in range(len(encoded)):
+                with self.assertRaises(ValueError):
+                    _native.unpack_varint_array(encoded[:cut], 1)
+                self.assert_same_decode(encoded[:cut], 1, _native.VARINT_U32)
+        self.assert_same_decode(encode_varint_array([1, 300]), 3, _native.VARINT_U32)
+
+    def test_overlong_inputs(self):
+        """测试超长编码(第5字节超过4位或超过5字节)的处理一致"""
+        for data in (b"\xff\xff\xff\xff\x1f", b"\x80\x80\x80\x80\x80\x00", b"\x80\x80\x80\x80\x10",
+                     b"\x80\x80\x80\x80\x00", b"\xff\xff\xff\xff\x0f"):
+            for kind in self.KINDS:
+                self.assert_same_decode(data, 1, kind)
+        with self.assertRaises(ValueError):
+            _native.unpack_varint_array(b"\xff\xff\xff\xff\x1f", 1)
+
+    def test_random_inputs(self):
+        """测试随机字节串的解码结果与Python实现一致"""
+        rng = random.Random(260)
+        for _ in range(2000):
+            data = bytes(rng.choice((0x00, 0x0F, 0x10, 0x7F, 0x80, 0xFF, rng.randrange(256)))
+                         for _ in range(rng.randrange(8)))
+            self.assert_same_decode(data, rng.randrange(1, 3), rng.choice(list(self.KINDS)))
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -4,7 +4,7 @@ from PySide6.QtCore import Slot, QByteArray, Qt
 import struct
 from PySide6.QtWidgets import (
     QWidget, QVBoxLayout, QHBoxLayout,
-    QGridLayout, QLabel, QComboBox, QLineEdit, QPushButton, QMessageBox, QGroupBox, QScrollArea,
+    QGridLayout, QLabel, QComboBox, QLineEdit, QPushButton, QMessageBox, QGroupBox, QScrollArea, QSpinBox,
     QInputDialog,  # For Plugin Management Dialog
 )
 # Core imports from your project structure
@@ -30,6 +30,8 @@ if TYPE_CHECKING:
 class AdaptedParsePanelWidget(PanelInterface):
     PANEL_TYPE_NAME = "core_parse_panel"
     PANEL_DISPLAY_NAME = "数据解析面板"
+    MAPPING_SEQUENTIAL = "顺序填充 (Sequential)"
+    MAPPING_REPEATED = "重复记录 (Repeated)"
 
     def __init__(self, panel_id: int, main_window_ref: 'SerialDebugger', initial_config: Optional[Dict] = None,
                  parent: Optional[QWidget] = None):
@@ -72,8 +74,17 @@ class AdaptedParsePanelWidget(PanelInterface):
         parse_config_layout.addWidget(self.parse_id_edit, 0, 1)
         parse_config_layout.addWidget(QLabel("数据分配模式:"), 1, 0)
         self.data_mapping_combo = QComboBox()
-        self.data_mapping_combo.addItems(["顺序填充 (Sequential)"])
+        self.data_mapping_combo.addItems([self.MAPPING_SEQUENTIAL, self.MAPPING_REPEATED])
+        self.data_mapping_combo.setToolTip("重复记录: 显示项描述一条记录, 跳过帧头后负载中的每条记录依次显示和绘图")
         parse_config_layout.addWidget(self.data_mapping_combo, 1, 1)
+        parse_config_layout.addWidget(QLabel("帧头字节数:"), 2, 0)
+        self.record_header_spin = QSpinBox()
+        self.record_header_spin.setRange(0, 255)
+        self.record_header_spin.setToolTip("重复记录模式下负载开头跳过的字节数")
+        self.record_header_spin.setEnabled(False)
+        parse_config_layout.addWidget(self.record_header_spin, 2, 1)
+        self.data_mapping_combo.currentTextChanged.connect(
+            lambda text: self.record_header_spin.setEnabled(text == self.MAPPING_REPEATED))
         recv_display_main_layout.addLayout(parse_config_layout)
         self.recv_display_group.setLayout(recv_display_main_layout)
         layout.addWidget(self.recv_display_group)
@@ -206,9 +217,39 @@ class AdaptedParsePanelWidget(PanelInterface):
             return self.parse_id_edit.text()
         return ""
 
+    def _record_byte_length(self) -> int:
+        """一条记录(全部显示项)的字节数; 含变长类型时返回0"""
+        total = 0
+        for container_widget in self.receive_data_containers:
+            byte_len = get_data_type_byte_length(container_widget.get_config()["type"])
+            if byte_len <= 0:
+                return 0
+            total += byte_len
+        return total
+
     def dispatch_data(self, data_payload_ba: QByteArray) -> None:
         """
         处理接收到的数据负载
+        顺序填充模式下整个负载对应一次显示; 重复记录模式下跳过帧头, 负载中的每条记录依次分发(用于批量上报的高速数据)
+        :param data_payload_ba: 数据负载(QByteArray)
+        """
+        if self.data_mapping_combo.currentText() == self.MAPPING_REPEATED:
+            record_size = self._record_byte_length()
+            header_size = self.record_header_spin.value()
+            if record_size > 0:
+                record_count = max(data_payload_ba.size() - header_size, 0) // record_size
+                if record_count == 0 and self.error_logger:
+                    self.error_logger.log_warning(f"Parse Panel {self.panel_id}: 负载 {data_payload_ba.size()} 字节, 不足一条 {record_size} 字节的记录")
+                for index in range(record_count):
+                    self._dispatch_record(data_payload_ba.mid(header_size + index * record_size, record_size))
+                return
+            if self.error_logger:
+                self.error_logger.log_warning(f"Parse Panel {self.panel_id}: 重复记录模式要求显示项均为定长类型, 按顺序填充处理")
+        self._dispatch_record(data_payload_ba)
+
+    def _dispatch_record(self, data_payload_ba: QByteArray) -> None:
+        """
+        按顺序把一段负载填入各显示项并转发到绘图面板
         :param data_payload_ba: 数据负载(QByteArray)
         """
         if self.error_logger:
@@ -371,13 +412,15 @@ class AdaptedParsePanelWidget(PanelInterface):
     def get_config(self) -> Dict[str, Any]:
         return {"parse_func_id": self.parse_id_edit.text() if hasattr(self, 'parse_id_edit') else "",
                 "data_mapping_mode": self.data_mapping_combo.currentText() if hasattr(self,
-                                                                                      'data_mapping_combo') else "顺序填充 (Sequential)",
+                                                                                      'data_mapping_combo') else self.MAPPING_SEQUENTIAL,
+                "record_header_bytes": self.record_header_spin.value() if hasattr(self, 'record_header_spin') else 0,
                 "receive_containers": [c.get_config() for c in self.receive_data_containers]}
 
     def apply_config(self, config: Dict[str, Any]):
         if hasattr(self, 'parse_id_edit'): self.parse_id_edit.setText(config.get("parse_func_id", f"C{self.panel_id}"))
         if hasattr(self, 'data_mapping_combo'): self.data_mapping_combo.setCurrentText(
-            config.get("data_mapping_mode", "顺序填充 (Sequential)"))
+            config.get("data_mapping_mode", self.MAPPING_SEQUENTIAL))
+        if hasattr(self, 'record_header_spin'): self.record_header_spin.setValue(int(config.get("record_header_bytes", 0)))
         while self.receive_data_containers: self.remove_receive_data_container(silent=True)
         for container_cfg in config.get("receive_containers", []): self.add_receive_data_container(config=container_cfg,
                                                                                                    silent=True)
@@ -106,6 +106,29 @@ class PerformanceConfig:
     @property
     def parse_timeout_warning_ms(self) -> float:
         return self._accessor.get('performance.parse_timeout_warning_ms', 5.0)
+    
+    @property
+    def use_native_parser(self) -> bool:
+        return self._accessor.get('performance.use_native_parser', True)
+    
+    @property
+    def use_native_ring_buffer(self) -> bool:
+        return self._accessor.get('performance.use_native_ring_buffer', True)
+    
+    @property
+    def direct_fd_receive(self) -> bool:
+        return self._accessor.get('performance.direct_fd_receive', False)
+
+
+class FrameFormatConfig:
+    """帧格式配置访问器"""
+    
+    def __init__(self, accessor: ConfigAccessor):
+        self._accessor = accessor
+    
+    @property
+    def max_data_payload_size(self) -> int:
+        return self._accessor.get('frame_format.max_data_payload_size', 1024)
 
 
 class AckMechanismConfig:
@@ -152,6 +175,7 @@ class ConfigManager:
     def __init__(self, config_manager: Optional[ProtocolConfigManager] = None):
         self._accessor = ConfigAccessor(config_manager)
         self.performance = PerformanceConfig(self._accessor)
+        self.frame_format = FrameFormatConfig(self._accessor)
         self.ack_mechanism = AckMechanismConfig(self._accessor)
         self.debugging = DebuggingConfig(self._accessor)
     
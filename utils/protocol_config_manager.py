@@ -63,6 +63,9 @@ class PerformanceConfig:
     frame_timeout_warning_ms: float = 10.0
     buffer_usage_warning_percent: float = 90.0
     stats_update_interval_ms: int = 5000
+    use_native_parser: bool = True  # 原生扩展可用时整块扫描接收缓冲区
+    use_native_ring_buffer: bool = True  # 原生扩展可用时使用无锁SPSC接收缓冲区
+    direct_fd_receive: bool = False  # pyserial读线程直接从串口fd读入接收缓冲区(不再显示/记录原始数据)
 
 @dataclass
 class ErrorHandlingConfig: